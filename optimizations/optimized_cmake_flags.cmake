@@ -159,6 +159,7 @@ macro(apply_hot_path_optimizations TARGET)
     if(CMAKE_BUILD_TYPE STREQUAL "Release")
         # Apply aggressive optimizations to performance-critical files
         optimize_file(${TARGET} "src/memory/memory_pool.cpp")
+        optimize_file(${TARGET} "src/memory/size_class_allocator.cpp")
         optimize_file(${TARGET} "src/packet/core/packet.cpp") 
         optimize_file(${TARGET} "src/threading/thread_pool.cpp")
         optimize_file(${TARGET} "src/concurrent/mpsc_ring_buffer.h")
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Monitor {
+namespace Concurrent {
+
+/**
+ * @brief Lock-free work-stealing deque (Chase-Lev)
+ *
+ * One owner thread pushes and pops at the bottom, last in first out, so
+ * the work it just forked is still warm in its cache. Any number of
+ * thieves steal from the top, oldest first, with one compare-and-swap on
+ * the top index; owner and thieves only contend for the last element.
+ *
+ * Elements live in a power-of-two ring that the owner doubles when it
+ * fills up. Thieves may still be reading a replaced ring, so those are
+ * kept until the deque is destroyed. Elements are read and written as
+ * relaxed atomics, which limits T to small trivially copyable values
+ * such as pointers; anything larger is stored by pointer. Memory ordering
+ * follows Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+ * Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+template<typename T>
+class ChaseLevDeque
+{
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    static_assert(std::atomic<T>::is_always_lock_free, "T must fit a lock-free atomic");
+
+    /**
+     * @param capacity Initial ring size, rounded up to a power of two
+     */
+    explicit ChaseLevDeque(size_t capacity = 256);
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    /**
+     * @brief Add an element at the bottom (owner only); grows when full
+     */
+    void push(T item);
+
+    /**
+     * @brief Take the newest element from the bottom (owner only)
+     * @return False if the deque was empty or a thief took the last element
+     */
+    bool pop(T& item);
+
+    /**
+     * @brief Take the oldest element from the top (any thread)
+     * @return False if the deque was empty or another thread won the race
+     */
+    bool steal(T& item);
+
+    /**
+     * @brief Number of elements; exact only when called by the owner while no thief runs
+     */
+    size_t size() const noexcept {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * @brief Current ring size
+     */
+    size_t capacity() const noexcept {
+        return m_ring.load(std::memory_order_relaxed)->capacity();
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    class Ring
+    {
+    public:
+        explicit Ring(size_t capacity)
+            : m_mask(static_cast<int64_t>(capacity) - 1)
+            , m_slots(new std::atomic<T>[capacity])
+        {
+        }
+
+        size_t capacity() const noexcept { return static_cast<size_t>(m_mask + 1); }
+
+        T get(int64_t index) const noexcept {
+            return m_slots[index & m_mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T item) noexcept {
+            m_slots[index & m_mask].store(item, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Twice as large a ring holding the elements in [top, bottom)
+         */
+        std::unique_ptr<Ring> grow(int64_t top, int64_t bottom) const {
+            auto ring = std::make_unique<Ring>(capacity() * 2);
+            for (int64_t i = top; i < bottom; ++i) {
+                ring->put(i, get(i));
+            }
+            return ring;
+        }
+
+    private:
+        int64_t m_mask;
+        std::unique_ptr<std::atomic<T>[]> m_slots;
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_top{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<int64_t> m_bottom{0};
+    std::atomic<Ring*> m_ring{nullptr};
+    std::vector<std::unique_ptr<Ring>> m_rings;     ///< Current ring last; owner only
+};
+
+// Implementation
+
+template<typename T>
+ChaseLevDeque<T>::ChaseLevDeque(size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity) {
+        size *= 2;
+    }
+    m_rings.push_back(std::make_unique<Ring>(size));
+    m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+}
+
+template<typename T>
+void ChaseLevDeque<T>::push(T item)
+{
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_top.load(std::memory_order_acquire);
+    Ring* ring = m_ring.load(std::memory_order_relaxed);
+
+    if (bottom - top > static_cast<int64_t>(ring->capacity()) - 1) {
+        m_rings.push_back(ring->grow(top, bottom));
+        ring = m_rings.back().get();
+        m_ring.store(ring, std::memory_order_release);
+    }
+
+    ring->put(bottom, item);
+    // Publishes the element, and whatever it points to, to thieves
+    m_bottom.store(bottom + 1, std::memory_order_release);
+}
+
+template<typename T>
+bool ChaseLevDeque<T>::pop(T& item)
+{
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    Ring* ring = m_ring.load(std::memory_order_relaxed);
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    // Orders the claim on the bottom before reading the top, against steal()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return false;
+    }
+
+    item = ring->get(bottom);
+    if (top == bottom) {
+        // Last element: settle the race with thieves on the top index
+        const bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                       std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+template<typename T>
+bool ChaseLevDeque<T>::steal(T& item)
+{
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom) {
+        return false;
+    }
+
+    Ring* ring = m_ring.load(std::memory_order_acquire);
+    const T candidate = ring->get(top);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+        return false;
+    }
+    item = candidate;
+    return true;
+}
+
+} // namespace Concurrent
+} // namespace Monitor
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <QtCore/QtGlobal>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#ifdef Q_OS_LINUX
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+namespace Monitor {
+namespace Concurrent {
+
+/**
+ * @brief Hint to the CPU that the caller is spinning
+ */
+inline void cpuRelax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Lets consumers sleep until a producer signals new work
+ *
+ * A consumer that found nothing calls prepareWait(), checks for work once
+ * more, and then either cancelWait()s or wait()s with the returned key.
+ * Producers call notifyOne() after publishing work; it costs a fence and a
+ * load while no consumer is parked, and wakes exactly one otherwise. Work
+ * published after prepareWait() always ends the wait, so no wakeup is
+ * lost. On Linux waiting parks on a futex, elsewhere on a condition
+ * variable.
+ */
+class EventCount
+{
+public:
+    using Key = uint32_t;
+
+    EventCount() = default;
+
+    EventCount(const EventCount&) = delete;
+    EventCount& operator=(const EventCount&) = delete;
+
+    /**
+     * @brief Announce an upcoming wait; check for work again afterwards
+     */
+    Key prepareWait() noexcept {
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return m_epoch.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Withdraw a prepareWait() because work turned up
+     */
+    void cancelWait() noexcept {
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sleep until a notification issued after prepareWait()
+     */
+    void wait(Key key) noexcept;
+
+    /**
+     * @brief Wake one waiting consumer, if any
+     */
+    void notifyOne() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_seq_cst) != 0) {
+            notify(1);
+        }
+    }
+
+    /**
+     * @brief Wake every waiting consumer
+     */
+    void notifyAll() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_seq_cst) != 0) {
+            notify(INT_MAX);
+        }
+    }
+
+    /**
+     * @brief Consumers between prepareWait() and the end of their wait
+     */
+    uint32_t waiters() const noexcept {
+        return m_waiters.load(std::memory_order_relaxed);
+    }
+
+private:
+    void notify(int count) noexcept;
+
+    std::atomic<Key> m_epoch{0};            ///< Advanced by every notification
+    std::atomic<uint32_t> m_waiters{0};
+
+#ifndef Q_OS_LINUX
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+#endif
+};
+
+/**
+ * @brief Spin, then yield, then park: the idle policy of a polling consumer
+ *
+ * Call idle() each time a poll finds nothing and reset() when it finds
+ * work. The first spinIterations calls pause the CPU, the next
+ * yieldIterations give up the time slice, and after that idle() returns
+ * true to tell the caller to park on its EventCount.
+ */
+class SpinWait
+{
+public:
+    SpinWait(uint32_t spinIterations, uint32_t yieldIterations) noexcept
+        : m_spinIterations(spinIterations)
+        , m_yieldLimit(spinIterations + yieldIterations)
+    {
+    }
+
+    /**
+     * @brief Back off once
+     * @return True once spinning and yielding are used up
+     */
+    bool idle() noexcept {
+        if (m_count < m_spinIterations) {
+            ++m_count;
+            for (uint32_t i = 0; i < PAUSES_PER_SPIN; ++i) {
+                cpuRelax();
+            }
+            return false;
+        }
+        if (m_count < m_yieldLimit) {
+            ++m_count;
+            std::this_thread::yield();
+            return false;
+        }
+        return true;
+    }
+
+    void reset() noexcept { m_count = 0; }
+
+private:
+    static constexpr uint32_t PAUSES_PER_SPIN = 16;
+
+    uint32_t m_spinIterations;
+    uint32_t m_yieldLimit;
+    uint32_t m_count = 0;
+};
+
+// Implementation
+
+#ifdef Q_OS_LINUX
+
+inline void EventCount::wait(Key key) noexcept
+{
+    while (m_epoch.load(std::memory_order_acquire) == key) {
+        // Returns at once if the epoch moved since the load; spurious returns loop
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+inline void EventCount::notify(int count) noexcept
+{
+    m_epoch.fetch_add(1, std::memory_order_seq_cst);
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+#else
+
+inline void EventCount::wait(Key key) noexcept
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this, key]() { return m_epoch.load(std::memory_order_acquire) != key; });
+    }
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+inline void EventCount::notify(int count) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+    if (count == 1) {
+        m_condition.notify_one();
+    } else {
+        m_condition.notify_all();
+    }
+}
+
+#endif
+
+} // namespace Concurrent
+} // namespace Monitor
@@ -60,6 +60,14 @@ public:
     bool tryPush(const T& item);
     bool tryPush(T&& item);
     
+    /**
+     * @brief Batch push claiming all slots with one compare-and-swap
+     * @param items Items to move into the buffer
+     * @param count Number of items
+     * @return Number of leading items pushed; fewer than @p count when the buffer fills up
+     */
+    size_t tryPushBatch(T* items, size_t count);
+    
     /**
      * @brief Blocking push with timeout (multiple producers)
      * @param item Item to push
@@ -78,6 +86,9 @@ public:
     
     /**
      * @brief Batch pop operation for better throughput
+     * 
+     * Claims all available items, up to @p maxItems, with one compare-and-swap.
+     * 
      * @param items Array to store popped items
      * @param maxItems Maximum number of items to pop
      * @return Number of items actually popped
@@ -423,16 +434,80 @@ bool MPSCRingBuffer<T>::tryPop(T& item)
 template<typename T>
 size_t MPSCRingBuffer<T>::tryPopBatch(T* items, size_t maxItems)
 {
-    size_t popped = 0;
+    size_t tail = m_tail.load(std::memory_order_relaxed);
     
-    for (size_t i = 0; i < maxItems; ++i) {
-        if (!tryPop(items[i])) {
-            break;
+    for (;;) {
+        // Count the published items from tail; only a consumer's CAS can take them
+        size_t available = 0;
+        while (available < maxItems &&
+               m_buffer[(tail + available) & m_mask].sequence.load(std::memory_order_acquire) == tail + available + 1) {
+            ++available;
         }
-        ++popped;
+        
+        if (available == 0) {
+            size_t sequence = m_buffer[tail & m_mask].sequence.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(tail + 1) < 0) {
+                // Buffer is empty
+                m_popFailures.fetch_add(1, std::memory_order_relaxed);
+                return 0;
+            }
+            // Another consumer took this slot; update tail and try again
+            tail = m_tail.load(std::memory_order_relaxed);
+            continue;
+        }
+        
+        if (m_tail.compare_exchange_weak(tail, tail + available, std::memory_order_relaxed)) {
+            for (size_t i = 0; i < available; ++i) {
+                Slot& slot = m_buffer[(tail + i) & m_mask];
+                slot.tryLoad(items[i], tail + i + 1);
+                slot.sequence.store(tail + i + m_capacity, std::memory_order_release);
+            }
+            m_totalPops.fetch_add(available, std::memory_order_relaxed);
+            return available;
+        }
+        // CAS failed; tail was updated by compare_exchange_weak
     }
+}
+
+template<typename T>
+size_t MPSCRingBuffer<T>::tryPushBatch(T* items, size_t count)
+{
+    if (count == 0) {
+        return 0;
+    }
+    
+    size_t head = m_head.load(std::memory_order_relaxed);
     
-    return popped;
+    for (;;) {
+        // Count the free slots from head; only a producer's CAS can take them
+        size_t free = 0;
+        while (free < count &&
+               m_buffer[(head + free) & m_mask].sequence.load(std::memory_order_acquire) == head + free) {
+            ++free;
+        }
+        
+        if (free == 0) {
+            size_t sequence = m_buffer[head & m_mask].sequence.load(std::memory_order_acquire);
+            if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(head) < 0) {
+                // Buffer is full
+                m_pushFailures.fetch_add(1, std::memory_order_relaxed);
+                return 0;
+            }
+            // Another producer took this slot; update head and try again
+            head = m_head.load(std::memory_order_relaxed);
+            continue;
+        }
+        
+        if (m_head.compare_exchange_weak(head, head + free, std::memory_order_relaxed)) {
+            for (size_t i = 0; i < free; ++i) {
+                m_buffer[(head + i) & m_mask].store(std::move(items[i]), head + i + 1);
+            }
+            m_totalPushes.fetch_add(free, std::memory_order_relaxed);
+            return free;
+        }
+        // CAS failed, retry with new head value
+        m_casFailures.fetch_add(1, std::memory_order_relaxed);
+    }
 }
 
 template<typename T>
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Monitor {
+namespace Concurrent {
+
+/**
+ * @brief Epoch-based reclamation shared by every RcuPointer
+ *
+ * Each reading thread owns a cache-line-sized record in which it announces
+ * the global epoch while it is inside a read section. Writers stamp a
+ * replaced object with the epoch it was retired in and free it once every
+ * announced epoch is newer, at which point no reader can still hold it.
+ *
+ * Read sections cost one store into the thread's own record on entry and
+ * one on exit, and may nest. Records are recycled when their thread exits.
+ */
+class EpochDomain
+{
+    struct Record;
+
+public:
+    /**
+     * @brief Keeps objects loaded from any RcuPointer alive while in scope
+     */
+    class ReadGuard
+    {
+    public:
+        ReadGuard() noexcept : m_record(localRecord()) { enter(m_record); }
+        ~ReadGuard() { exit(m_record); }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        Record* m_record;
+    };
+
+    /**
+     * @brief Advance the global epoch
+     * @return Epoch an object retired now is stamped with
+     */
+    static uint64_t advance() noexcept {
+        return s_epoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Oldest epoch announced by a reader, or QUIESCENT if none is reading
+     */
+    static uint64_t oldestActiveEpoch() noexcept {
+        uint64_t oldest = QUIESCENT;
+        for (Record* record = s_records.load(std::memory_order_acquire); record; record = record->next) {
+            const uint64_t epoch = record->epoch.load(std::memory_order_seq_cst);
+            if (epoch < oldest) {
+                oldest = epoch;
+            }
+        }
+        return oldest;
+    }
+
+    static constexpr uint64_t QUIESCENT = std::numeric_limits<uint64_t>::max();
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * @brief Per-thread reader state; never freed, reused after its thread exits
+     */
+    struct alignas(CACHE_LINE_SIZE) Record {
+        std::atomic<uint64_t> epoch{QUIESCENT};
+        std::atomic<bool> inUse{false};
+        uint32_t depth = 0;             ///< Nesting of read sections, owner thread only
+        Record* next = nullptr;
+    };
+
+    /**
+     * @brief Claims a record for the calling thread and releases it at thread exit
+     */
+    struct RecordOwner {
+        Record* record;
+
+        RecordOwner() : record(acquireRecord()) {}
+        ~RecordOwner() {
+            record->epoch.store(QUIESCENT, std::memory_order_release);
+            record->inUse.store(false, std::memory_order_release);
+        }
+    };
+
+    static Record* localRecord() noexcept {
+        thread_local RecordOwner owner;
+        return owner.record;
+    }
+
+    static Record* acquireRecord() {
+        for (Record* record = s_records.load(std::memory_order_acquire); record; record = record->next) {
+            bool expected = false;
+            if (!record->inUse.load(std::memory_order_relaxed) &&
+                record->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return record;
+            }
+        }
+
+        Record* record = new Record();
+        record->inUse.store(true, std::memory_order_relaxed);
+        Record* head = s_records.load(std::memory_order_relaxed);
+        do {
+            record->next = head;
+        } while (!s_records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+        return record;
+    }
+
+    static void enter(Record* record) noexcept {
+        if (record->depth++ == 0) {
+            // Announce before loading any pointer; a stale epoch only delays reclamation
+            record->epoch.store(s_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        }
+    }
+
+    static void exit(Record* record) noexcept {
+        if (--record->depth == 0) {
+            record->epoch.store(QUIESCENT, std::memory_order_release);
+        }
+    }
+
+    inline static std::atomic<uint64_t> s_epoch{1};
+    inline static std::atomic<Record*> s_records{nullptr};
+};
+
+/**
+ * @brief Pointer to an immutable object that readers load without locking
+ *
+ * Writers build a complete replacement and publish() it; the object it
+ * replaces is retired and freed by a later publish() or reclaim() once no
+ * reader can still see it. Readers call load() inside an
+ * EpochDomain::ReadGuard and may use the object until the guard ends.
+ *
+ * Writers must be serialised by the caller. Destroying the pointer frees
+ * every version, so no reader may be active then.
+ */
+template<typename T>
+class RcuPointer
+{
+public:
+    explicit RcuPointer(std::unique_ptr<T> initial = std::make_unique<T>())
+        : m_current(initial.release())
+    {
+    }
+
+    ~RcuPointer();
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    /**
+     * @brief Current object; valid until the caller's ReadGuard ends
+     */
+    const T* load() const noexcept {
+        return m_current.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Current object for the writer building its replacement
+     */
+    const T* writerView() const noexcept {
+        return m_current.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Replace the current object and retire the old one (writers only)
+     */
+    void publish(std::unique_ptr<T> next);
+
+    /**
+     * @brief Free retired objects no reader can hold (writers only)
+     * @return Objects still waiting for readers
+     */
+    size_t reclaim();
+
+    /**
+     * @brief Retired objects not yet freed (writers only)
+     */
+    size_t retiredCount() const noexcept { return m_retired.size(); }
+
+private:
+    std::atomic<T*> m_current;
+    std::vector<std::pair<uint64_t, T*>> m_retired;    ///< Retire epoch and object
+};
+
+// Implementation
+
+template<typename T>
+RcuPointer<T>::~RcuPointer()
+{
+    for (auto& retired : m_retired) {
+        delete retired.second;
+    }
+    delete m_current.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+void RcuPointer<T>::publish(std::unique_ptr<T> next)
+{
+    T* previous = m_current.exchange(next.release(), std::memory_order_seq_cst);
+    m_retired.emplace_back(EpochDomain::advance(), previous);
+    reclaim();
+}
+
+template<typename T>
+size_t RcuPointer<T>::reclaim()
+{
+    if (m_retired.empty()) {
+        return 0;
+    }
+
+    const uint64_t oldest = EpochDomain::oldestActiveEpoch();
+    auto kept = m_retired.begin();
+    for (auto& retired : m_retired) {
+        if (retired.first < oldest) {
+            delete retired.second;
+        } else {
+            *kept++ = retired;
+        }
+    }
+    m_retired.erase(kept, m_retired.end());
+    return m_retired.size();
+}
+
+} // namespace Concurrent
+} // namespace Monitor
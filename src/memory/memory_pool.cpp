@@ -1,4 +1,5 @@
 #include "memory_pool.h"
+#include "numa_memory.h"
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QDebug>
 #include <algorithm>
@@ -50,6 +51,11 @@ void MemoryPool::initializePool()
     m_poolStart = m_pool.get();
     m_poolEnd = m_poolStart + totalSize;
     
+    // Placed before the memset, so the pages are first touched on the node
+    if (m_numaNode >= 0) {
+        Memory::placeOnNumaNode(m_poolStart, totalSize, m_numaNode);
+    }
+    
     std::memset(m_poolStart, 0, totalSize);
     
     m_freeList = nullptr;
@@ -127,6 +133,16 @@ void MemoryPool::reset()
     m_usedBlocks.storeRelaxed(0);
 }
 
+bool MemoryPool::placeOnNumaNode(int node)
+{
+    QMutexLocker locker(&m_mutex);
+    m_numaNode = node;
+    if (!m_poolStart) {
+        return false;
+    }
+    return Memory::placeOnNumaNode(m_poolStart, m_poolEnd - m_poolStart, node);
+}
+
 bool MemoryPool::isValidPointer(void* ptr) const
 {
     if (!ptr || !m_poolStart || !m_poolEnd) {
@@ -144,6 +160,7 @@ bool MemoryPool::isValidPointer(void* ptr) const
 
 MemoryPoolManager::MemoryPoolManager(QObject* parent)
     : QObject(parent)
+    , m_packetAllocator(std::make_unique<SizeClassAllocator>())
 {
     qCInfo(memoryPool) << "Memory pool manager created";
 }
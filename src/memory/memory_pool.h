@@ -3,6 +3,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QMutex>
 #include <QtCore/QAtomicInteger>
+#include "size_class_allocator.h"
 #include <cstddef>
 #include <vector>
 #include <memory>
@@ -31,6 +32,11 @@ public:
     void reset();
     
     bool isValidPointer(void* ptr) const;
+    
+    /**
+     * @brief Keep the pool's pages on NUMA node @p node, see Memory::placeOnNumaNode()
+     */
+    bool placeOnNumaNode(int node);
 
 signals:
     void memoryPressure(double utilization);
@@ -55,6 +61,8 @@ private:
     char* m_poolStart;
     char* m_poolEnd;
     
+    int m_numaNode = -1;    ///< Reapplied when reset() reallocates the pool
+    
 public:
     static constexpr double PRESSURE_THRESHOLD = 0.8;
 };
@@ -77,6 +85,9 @@ public:
     QStringList getPoolNames() const;
     double getTotalUtilization() const;
     size_t getTotalMemoryUsed() const;
+    
+    // Index-addressed, lock-free allocator used for packet buffers
+    SizeClassAllocator* packetAllocator() const { return m_packetAllocator.get(); }
 
 signals:
     void poolCreated(const QString& name);
@@ -89,6 +100,8 @@ private slots:
 private:
     std::unordered_map<std::string, std::unique_ptr<MemoryPool>> m_pools;
     mutable QMutex m_poolsMutex;
+    
+    std::unique_ptr<SizeClassAllocator> m_packetAllocator;
 };
 
 } // namespace Memory
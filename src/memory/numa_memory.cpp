@@ -0,0 +1,56 @@
+#include "numa_memory.h"
+#include <QtCore/QtGlobal>
+#include <cstdint>
+
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Monitor {
+namespace Memory {
+
+namespace {
+
+// From <linux/mempolicy.h>, spelled out to avoid depending on libnuma
+constexpr int MPOL_PREFERRED_POLICY = 1;
+constexpr unsigned MPOL_MF_MOVE_FLAG = 1u << 1;
+constexpr int MAX_NODES = 1024;
+constexpr size_t BITS_PER_WORD = sizeof(unsigned long) * 8;
+
+} // namespace
+
+bool placeOnNumaNode(void* address, size_t length, int node) noexcept
+{
+#if defined(Q_OS_LINUX) && defined(SYS_mbind)
+    if (!address || node < 0 || node >= MAX_NODES) {
+        return false;
+    }
+
+    const long pageSize = ::sysconf(_SC_PAGESIZE);
+    if (pageSize <= 0) {
+        return false;
+    }
+    const uintptr_t page = static_cast<uintptr_t>(pageSize);
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(address) + page - 1) & ~(page - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(address) + length) & ~(page - 1);
+    if (end <= begin) {
+        return false;
+    }
+
+    unsigned long mask[MAX_NODES / BITS_PER_WORD] = {};
+    mask[static_cast<size_t>(node) / BITS_PER_WORD] = 1ul << (static_cast<size_t>(node) % BITS_PER_WORD);
+
+    // The kernel reads maxnode - 1 bits
+    return ::syscall(SYS_mbind, reinterpret_cast<void*>(begin), end - begin, MPOL_PREFERRED_POLICY,
+                     mask, static_cast<unsigned long>(MAX_NODES + 1), MPOL_MF_MOVE_FLAG) == 0;
+#else
+    Q_UNUSED(address);
+    Q_UNUSED(length);
+    Q_UNUSED(node);
+    return false;
+#endif
+}
+
+} // namespace Memory
+} // namespace Monitor
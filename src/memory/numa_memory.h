@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace Monitor {
+namespace Memory {
+
+/**
+ * @brief Ask the kernel to keep the pages of [address, address + length)
+ *        on NUMA node @p node
+ *
+ * Uses mbind() with a preferred policy, so allocation falls back to other
+ * nodes rather than failing when the node is full. Pages already touched
+ * are migrated. Only pages lying wholly inside the range are affected.
+ *
+ * @return False where NUMA placement is unavailable (non-Linux, or a
+ *         kernel without NUMA support) or the kernel refused
+ */
+bool placeOnNumaNode(void* address, size_t length, int node) noexcept;
+
+} // namespace Memory
+} // namespace Monitor
@@ -0,0 +1,358 @@
+#include "size_class_allocator.h"
+#include "numa_memory.h"
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QDebug>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+Q_LOGGING_CATEGORY(sizeClassAllocator, "Monitor.Memory.SizeClass")
+
+namespace Monitor {
+namespace Memory {
+
+namespace {
+
+std::atomic<uint64_t> s_nextInstanceId{1};
+
+// Live allocators, consulted only on slow paths (thread exit, cache slot
+// eviction) so a thread never flushes into an allocator that is gone.
+// Intentionally leaked to stay valid during static destruction.
+std::mutex& registryMutex()
+{
+    static std::mutex* mutex = new std::mutex;
+    return *mutex;
+}
+
+std::unordered_map<uint64_t, SizeClassAllocator*>& registry()
+{
+    static auto* allocators = new std::unordered_map<uint64_t, SizeClassAllocator*>;
+    return *allocators;
+}
+
+bool isAliveLocked(uint64_t id)
+{
+    return registry().count(id) != 0;
+}
+
+} // namespace
+
+struct SizeClassAllocator::ThreadCache {
+    static constexpr size_t SLOT_COUNT = 4;
+    std::array<CacheSlot, SLOT_COUNT> entries;
+
+    ~ThreadCache()
+    {
+        std::lock_guard<std::mutex> lock(registryMutex());
+        for (auto& slot : entries) {
+            if (slot.owner && isAliveLocked(slot.ownerId)) {
+                slot.owner->flushSlot(slot);
+            }
+        }
+    }
+};
+
+SizeClassAllocator::SizeClassAllocator()
+    : SizeClassAllocator(Config{})
+{
+}
+
+SizeClassAllocator::SizeClassAllocator(const Config& config)
+    : m_instanceId(s_nextInstanceId.fetch_add(1, std::memory_order_relaxed))
+{
+    for (size_t i = 0; i < SizeClass::COUNT; ++i) {
+        initializeArena(static_cast<SizeClass::Index>(i), config.blockCounts[i]);
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry()[m_instanceId] = this;
+}
+
+SizeClassAllocator::~SizeClassAllocator()
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().erase(m_instanceId);
+}
+
+void SizeClassAllocator::initializeArena(SizeClass::Index index, size_t blockCount)
+{
+    ClassArena& arena = m_arenas[index];
+    arena.blockSize = SizeClass::blockSize(index);
+    arena.blockCount = static_cast<uint32_t>(std::min<size_t>(blockCount, NIL - 1));
+    arena.magazineSize = static_cast<uint32_t>(std::min<size_t>(MAX_MAGAZINE_SIZE, arena.blockCount / 64));
+
+    if (arena.blockCount == 0) {
+        return;
+    }
+
+    // Left uninitialised on purpose: pages are committed on first touch
+    const size_t totalSize = arena.blockSize * arena.blockCount;
+    arena.storage.reset(new char[totalSize + 64]);
+    const auto raw = reinterpret_cast<uintptr_t>(arena.storage.get());
+    arena.base = reinterpret_cast<char*>((raw + 63) & ~uintptr_t(63));
+
+    arena.next.reset(new std::atomic<uint32_t>[arena.blockCount]);
+    for (uint32_t i = 0; i < arena.blockCount; ++i) {
+        arena.next[i].store(i + 1 < arena.blockCount ? i + 2 : 0, std::memory_order_relaxed);
+    }
+    arena.head.store(1, std::memory_order_release);
+
+    qCDebug(sizeClassAllocator) << "Size class" << SizeClass::name(index)
+                                << ": blockSize =" << arena.blockSize
+                                << "blockCount =" << arena.blockCount
+                                << "magazine =" << arena.magazineSize;
+}
+
+bool SizeClassAllocator::placeOnNumaNode(int node) noexcept
+{
+    bool placed = true;
+    for (size_t i = 0; i < SizeClass::COUNT; ++i) {
+        const ClassArena& arena = m_arenas[i];
+        if (arena.blockCount == 0) {
+            continue;
+        }
+        placed &= Memory::placeOnNumaNode(arena.base, arena.blockSize * arena.blockCount, node);
+        placed &= Memory::placeOnNumaNode(arena.next.get(), sizeof(std::atomic<uint32_t>) * arena.blockCount, node);
+    }
+    return placed;
+}
+
+void* SizeClassAllocator::allocate(SizeClass::Index index) noexcept
+{
+    if (index >= SizeClass::COUNT) {
+        return nullptr;
+    }
+
+    ClassArena& arena = m_arenas[index];
+
+    if (arena.magazineSize == 0) {
+        const uint32_t block = popGlobal(arena);
+        if (block == NIL) {
+            arena.failedAllocations.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        arena.usedBlocks.fetch_add(1, std::memory_order_relaxed);
+        return arena.base + static_cast<size_t>(block) * arena.blockSize;
+    }
+
+    Magazine& magazine = threadSlot().magazines[index];
+    if (magazine.count == 0 && refillMagazine(arena, magazine) == 0) {
+        arena.failedAllocations.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    return magazine.blocks[--magazine.count];
+}
+
+void SizeClassAllocator::deallocate(SizeClass::Index index, void* ptr) noexcept
+{
+    if (!ptr) {
+        return;
+    }
+
+    if (!owns(index, ptr)) {
+        qCWarning(sizeClassAllocator) << "Attempting to deallocate invalid pointer for size class" << index;
+        return;
+    }
+
+    ClassArena& arena = m_arenas[index];
+
+    if (arena.magazineSize == 0) {
+        const uint32_t block = indexOf(arena, ptr);
+        pushGlobal(arena, block, block);
+        arena.usedBlocks.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Magazine& magazine = threadSlot().magazines[index];
+    if (magazine.count == arena.magazineSize) {
+        drainMagazine(arena, magazine, std::max<uint32_t>(1, arena.magazineSize / 2));
+    }
+
+    magazine.blocks[magazine.count++] = ptr;
+}
+
+bool SizeClassAllocator::owns(SizeClass::Index index, const void* ptr) const noexcept
+{
+    if (index >= SizeClass::COUNT || !ptr) {
+        return false;
+    }
+
+    const ClassArena& arena = m_arenas[index];
+    const char* charPtr = static_cast<const char*>(ptr);
+    if (!arena.base || charPtr < arena.base ||
+        charPtr >= arena.base + arena.blockSize * arena.blockCount) {
+        return false;
+    }
+
+    return static_cast<size_t>(charPtr - arena.base) % arena.blockSize == 0;
+}
+
+size_t SizeClassAllocator::getBlockCount(SizeClass::Index index) const noexcept
+{
+    return index < SizeClass::COUNT ? m_arenas[index].blockCount : 0;
+}
+
+size_t SizeClassAllocator::getUsedBlocks(SizeClass::Index index) const noexcept
+{
+    return index < SizeClass::COUNT ? m_arenas[index].usedBlocks.load(std::memory_order_relaxed) : 0;
+}
+
+SizeClassAllocator::ClassStatistics SizeClassAllocator::getClassStatistics(SizeClass::Index index) const noexcept
+{
+    ClassStatistics stats;
+    if (index >= SizeClass::COUNT) {
+        return stats;
+    }
+
+    const ClassArena& arena = m_arenas[index];
+    stats.blockSize = arena.blockSize;
+    stats.blockCount = arena.blockCount;
+    stats.usedBlocks = arena.usedBlocks.load(std::memory_order_relaxed);
+    stats.globalRefills = arena.globalRefills.load(std::memory_order_relaxed);
+    stats.failedAllocations = arena.failedAllocations.load(std::memory_order_relaxed);
+    return stats;
+}
+
+double SizeClassAllocator::getUtilization() const noexcept
+{
+    size_t used = 0;
+    size_t total = 0;
+    for (const auto& arena : m_arenas) {
+        used += arena.usedBlocks.load(std::memory_order_relaxed);
+        total += arena.blockCount;
+    }
+    return total > 0 ? static_cast<double>(used) / static_cast<double>(total) : 0.0;
+}
+
+size_t SizeClassAllocator::getTotalMemoryUsed() const noexcept
+{
+    size_t total = 0;
+    for (const auto& arena : m_arenas) {
+        total += arena.usedBlocks.load(std::memory_order_relaxed) * arena.blockSize;
+    }
+    return total;
+}
+
+void SizeClassAllocator::flushThreadCache() noexcept
+{
+    flushSlot(threadSlot());
+}
+
+uint32_t SizeClassAllocator::popGlobal(ClassArena& arena) noexcept
+{
+    uint64_t head = arena.head.load(std::memory_order_acquire);
+    for (;;) {
+        const uint32_t slot = static_cast<uint32_t>(head);
+        if (slot == 0) {
+            return NIL;
+        }
+
+        const uint32_t block = slot - 1;
+        const uint32_t nextSlot = arena.next[block].load(std::memory_order_relaxed);
+        const uint64_t newHead = (((head >> 32) + 1) << 32) | nextSlot;
+
+        if (arena.head.compare_exchange_weak(head, newHead,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+            return block;
+        }
+    }
+}
+
+void SizeClassAllocator::pushGlobal(ClassArena& arena, uint32_t first, uint32_t last) noexcept
+{
+    uint64_t head = arena.head.load(std::memory_order_relaxed);
+    uint64_t newHead;
+    do {
+        arena.next[last].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        newHead = (((head >> 32) + 1) << 32) | (first + 1);
+    } while (!arena.head.compare_exchange_weak(head, newHead,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+}
+
+uint32_t SizeClassAllocator::refillMagazine(ClassArena& arena, Magazine& magazine) noexcept
+{
+    const uint32_t target = std::max<uint32_t>(1, arena.magazineSize / 2);
+    uint32_t filled = 0;
+
+    while (filled < target) {
+        const uint32_t block = popGlobal(arena);
+        if (block == NIL) {
+            break;
+        }
+        magazine.blocks[magazine.count++] = arena.base + static_cast<size_t>(block) * arena.blockSize;
+        ++filled;
+    }
+
+    if (filled > 0) {
+        arena.usedBlocks.fetch_add(filled, std::memory_order_relaxed);
+        arena.globalRefills.fetch_add(1, std::memory_order_relaxed);
+    }
+    return filled;
+}
+
+void SizeClassAllocator::drainMagazine(ClassArena& arena, Magazine& magazine, uint32_t count) noexcept
+{
+    count = std::min(count, magazine.count);
+    if (count == 0) {
+        return;
+    }
+
+    // Link the drained blocks into a private chain, then publish it with a single CAS
+    const uint32_t first = indexOf(arena, magazine.blocks[magazine.count - 1]);
+    uint32_t last = first;
+    for (uint32_t i = 1; i < count; ++i) {
+        const uint32_t block = indexOf(arena, magazine.blocks[magazine.count - 1 - i]);
+        arena.next[last].store(block + 1, std::memory_order_relaxed);
+        last = block;
+    }
+
+    pushGlobal(arena, first, last);
+    magazine.count -= count;
+    arena.usedBlocks.fetch_sub(count, std::memory_order_relaxed);
+}
+
+void SizeClassAllocator::flushSlot(CacheSlot& slot) noexcept
+{
+    for (size_t i = 0; i < SizeClass::COUNT; ++i) {
+        drainMagazine(m_arenas[i], slot.magazines[i], slot.magazines[i].count);
+    }
+}
+
+SizeClassAllocator::CacheSlot& SizeClassAllocator::threadSlot() noexcept
+{
+    static thread_local ThreadCache cache;
+
+    for (auto& slot : cache.entries) {
+        if (slot.ownerId == m_instanceId) {
+            return slot;
+        }
+    }
+
+    // Slow path: claim a free or stale slot, evicting the last one if needed
+    std::lock_guard<std::mutex> lock(registryMutex());
+
+    CacheSlot* target = &cache.entries.back();
+    for (auto& slot : cache.entries) {
+        if (!slot.owner || !isAliveLocked(slot.ownerId)) {
+            target = &slot;
+            break;
+        }
+    }
+
+    if (target->owner && isAliveLocked(target->ownerId)) {
+        target->owner->flushSlot(*target);
+    }
+
+    target->ownerId = m_instanceId;
+    target->owner = this;
+    for (auto& magazine : target->magazines) {
+        magazine.count = 0;
+    }
+    return *target;
+}
+
+} // namespace Memory
+} // namespace Monitor
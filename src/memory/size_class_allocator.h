@@ -0,0 +1,172 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Monitor {
+namespace Memory {
+
+/**
+ * @brief Compile-time size classes used for packet buffers
+ *
+ * Each class is addressed by a small integer index instead of a pool name.
+ * The names mirror the named pools created by Core::Application so that
+ * statistics and diagnostics stay comparable.
+ */
+namespace SizeClass {
+
+using Index = uint8_t;
+
+inline constexpr size_t COUNT = 6;
+inline constexpr Index INVALID = 0xFF;
+
+inline constexpr std::array<size_t, COUNT> BLOCK_SIZES = {
+    64, 512, 1024, 2048, 4096, 8192
+};
+
+inline constexpr std::array<const char*, COUNT> NAMES = {
+    "SmallObjects", "MediumObjects", "WidgetData",
+    "TestFramework", "PacketBuffer", "LargeObjects"
+};
+
+/**
+ * @brief Smallest size class able to hold @p size bytes, or INVALID
+ */
+constexpr Index forSize(size_t size) {
+    for (size_t i = 0; i < COUNT; ++i) {
+        if (size <= BLOCK_SIZES[i]) {
+            return static_cast<Index>(i);
+        }
+    }
+    return INVALID;
+}
+
+constexpr size_t blockSize(Index index) {
+    return index < COUNT ? BLOCK_SIZES[index] : 0;
+}
+
+constexpr const char* name(Index index) {
+    return index < COUNT ? NAMES[index] : "";
+}
+
+inline constexpr size_t MAX_BLOCK_SIZE = BLOCK_SIZES[COUNT - 1];
+
+static_assert(forSize(1) == 0, "1 byte must map to the smallest class");
+static_assert(forSize(64) == 0 && forSize(65) == 1, "Class boundaries are inclusive");
+static_assert(forSize(MAX_BLOCK_SIZE + 1) == INVALID, "Oversized requests have no class");
+
+} // namespace SizeClass
+
+/**
+ * @brief Lock-free size-class allocator with per-thread magazines
+ *
+ * Every size class owns one contiguous arena. Free blocks are kept on a
+ * tagged, index-linked Treiber stack (one CAS per push/pop, ABA-safe), and
+ * each thread caches a small magazine of blocks per class so that the common
+ * allocate/deallocate pair touches no shared cache line at all. Magazines are
+ * refilled from and drained to the global list in batches.
+ *
+ * Blocks are handed out uninitialised; callers that need zeroed memory must
+ * clear it themselves.
+ */
+class SizeClassAllocator {
+public:
+    struct Config {
+        std::array<size_t, SizeClass::COUNT> blockCounts = {10000, 5000, 2000, 1000, 1000, 500};
+    };
+
+    struct ClassStatistics {
+        size_t blockSize = 0;
+        size_t blockCount = 0;
+        size_t usedBlocks = 0;          ///< Blocks outside the global list (includes thread magazines)
+        uint64_t globalRefills = 0;     ///< Magazine refills from the global list
+        uint64_t failedAllocations = 0;
+    };
+
+    SizeClassAllocator();
+    explicit SizeClassAllocator(const Config& config);
+    ~SizeClassAllocator();
+
+    SizeClassAllocator(const SizeClassAllocator&) = delete;
+    SizeClassAllocator& operator=(const SizeClassAllocator&) = delete;
+
+    void* allocate(SizeClass::Index index) noexcept;
+    void deallocate(SizeClass::Index index, void* ptr) noexcept;
+
+    bool owns(SizeClass::Index index, const void* ptr) const noexcept;
+
+    size_t getBlockCount(SizeClass::Index index) const noexcept;
+    size_t getUsedBlocks(SizeClass::Index index) const noexcept;
+    ClassStatistics getClassStatistics(SizeClass::Index index) const noexcept;
+
+    double getUtilization() const noexcept;
+    size_t getTotalMemoryUsed() const noexcept;
+
+    /**
+     * @brief Return the calling thread's cached blocks to the global lists
+     */
+    void flushThreadCache() noexcept;
+
+    /**
+     * @brief Keep the arenas' pages on NUMA node @p node, moving those already touched
+     * @return False if any arena could not be placed, see Memory::placeOnNumaNode()
+     */
+    bool placeOnNumaNode(int node) noexcept;
+
+    static constexpr size_t MAX_MAGAZINE_SIZE = 32;
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
+
+    struct alignas(64) ClassArena {
+        std::unique_ptr<char[]> storage;
+        char* base = nullptr;
+        size_t blockSize = 0;
+        uint32_t blockCount = 0;
+        uint32_t magazineSize = 0;
+        std::unique_ptr<std::atomic<uint32_t>[]> next;
+
+        alignas(64) std::atomic<uint64_t> head{0};       ///< (tag << 32) | (index + 1)
+        alignas(64) std::atomic<size_t> usedBlocks{0};
+        std::atomic<uint64_t> globalRefills{0};
+        std::atomic<uint64_t> failedAllocations{0};
+    };
+
+    struct Magazine {
+        uint32_t count = 0;
+        void* blocks[MAX_MAGAZINE_SIZE];
+    };
+
+    struct CacheSlot {
+        uint64_t ownerId = 0;
+        SizeClassAllocator* owner = nullptr;
+        std::array<Magazine, SizeClass::COUNT> magazines;
+    };
+
+    struct ThreadCache;
+    friend struct ThreadCache;
+
+    void initializeArena(SizeClass::Index index, size_t blockCount);
+
+    uint32_t popGlobal(ClassArena& arena) noexcept;
+    void pushGlobal(ClassArena& arena, uint32_t first, uint32_t last) noexcept;
+
+    uint32_t refillMagazine(ClassArena& arena, Magazine& magazine) noexcept;
+    void drainMagazine(ClassArena& arena, Magazine& magazine, uint32_t count) noexcept;
+    void flushSlot(CacheSlot& slot) noexcept;
+
+    CacheSlot& threadSlot() noexcept;
+
+    uint32_t indexOf(const ClassArena& arena, const void* ptr) const noexcept {
+        return static_cast<uint32_t>((static_cast<const char*>(ptr) - arena.base) / arena.blockSize);
+    }
+
+    const uint64_t m_instanceId;
+    std::array<ClassArena, SizeClass::COUNT> m_arenas;
+};
+
+} // namespace Memory
+} // namespace Monitor
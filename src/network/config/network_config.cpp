@@ -32,8 +32,15 @@ QJsonObject NetworkConfig::toJson() const {
     performance["socketTimeout"] = socketTimeout;
     performance["maxPacketSize"] = maxPacketSize;
     performance["enableTimestamping"] = enableTimestamping;
+    performance["enableBatchReceive"] = enableBatchReceive;
+    performance["receiveBatchSize"] = receiveBatchSize;
+    performance["receiveThreadCore"] = receiveThreadCore;
+    performance["receiveThreadCpus"] = receiveThreadCpus;
     json["performance"] = performance;
     
+    // Wire format
+    json["headerByteOrder"] = QString(Parser::Layout::byteOrderName(headerByteOrder));
+    
     // Quality of Service
     QJsonObject qos;
     qos["typeOfService"] = typeOfService;
@@ -99,6 +106,19 @@ bool NetworkConfig::fromJson(const QJsonObject& json) {
             socketTimeout = performance["socketTimeout"].toInt();
             maxPacketSize = performance["maxPacketSize"].toInt();
             enableTimestamping = performance["enableTimestamping"].toBool();
+            enableBatchReceive = performance["enableBatchReceive"].toBool(false);
+            receiveBatchSize = performance["receiveBatchSize"].toInt(32);
+            receiveThreadCore = performance["receiveThreadCore"].toInt(-1);
+            receiveThreadCpus = performance["receiveThreadCpus"].toString();
+        }
+        
+        // Wire format
+        if (json.contains("headerByteOrder")) {
+            const QString orderName = json["headerByteOrder"].toString();
+            if (!Parser::Layout::parseByteOrder(orderName.toStdString(), headerByteOrder)) {
+                qWarning() << "Unknown header byte order" << orderName << "- keeping"
+                           << Parser::Layout::byteOrderName(headerByteOrder);
+            }
         }
         
         // Quality of Service
@@ -125,5 +145,14 @@ bool NetworkConfig::fromJson(const QJsonObject& json) {
     }
 }
 
+void NetworkConfig::applyTopology(const Threading::PipelineTopology& topology, size_t receiveThreadIndex,
+                                  const Threading::CpuTopology& machine) {
+    const Threading::CpuSet cpus = topology.cpuSetFor(
+        Threading::PipelineTopology::Stage::Receive, receiveThreadIndex, machine);
+    if (!cpus.empty()) {
+        receiveThreadCpus = Threading::CpuTopology::formatCpuList(cpus);
+    }
+}
+
 } // namespace Network
 } // namespace Monitor
\ No newline at end of file
@@ -5,6 +5,10 @@
 #include <QJsonObject>
 #include <string>
 #include <memory>
+#include <atomic>
+
+#include "../../parser/layout/byte_order.h"
+#include "../../threading/pipeline_topology.h"
 
 namespace Monitor {
 namespace Network {
@@ -44,6 +48,13 @@ struct NetworkConfig {
     int socketTimeout;                 ///< Socket timeout (milliseconds)
     int maxPacketSize;                 ///< Maximum expected packet size
     bool enableTimestamping;           ///< Enable high-precision timestamping
+    bool enableBatchReceive;           ///< Receive on a dedicated recvmmsg() thread (UDP, Linux only)
+    int receiveBatchSize;              ///< Datagrams per recvmmsg() call
+    int receiveThreadCore;             ///< Core for the receive thread (-1 = not pinned)
+    QString receiveThreadCpus;         ///< CPU list for the receive thread, e.g. "2-3"; overrides receiveThreadCore
+    
+    // Wire format
+    Parser::Layout::ByteOrder headerByteOrder; ///< Byte order the sender writes packet headers in
     
     // Quality of Service
     int typeOfService;                 ///< IP Type of Service field
@@ -73,6 +84,10 @@ struct NetworkConfig {
         , socketTimeout(1000)         // 1 second
         , maxPacketSize(65536)        // 64KB
         , enableTimestamping(true)
+        , enableBatchReceive(false)
+        , receiveBatchSize(32)
+        , receiveThreadCore(-1)
+        , headerByteOrder(Parser::Layout::ByteOrder::Native)
         , typeOfService(0)
         , priority(0)
         , enableKeepAlive(true)
@@ -150,9 +165,22 @@ struct NetworkConfig {
             return false;
         }
         
+        if (receiveBatchSize < 1 || receiveBatchSize > 1024) {
+            return false;
+        }
+        
         return true;
     }
     
+    /**
+     * @brief Take the receive thread's CPUs from @p topology's receive stage
+     * @param receiveThreadIndex Index of this source's receive thread in the stage
+     *
+     * Leaves receiveThreadCpus untouched if the receive stage floats.
+     */
+    void applyTopology(const Threading::PipelineTopology& topology, size_t receiveThreadIndex,
+                       const Threading::CpuTopology& machine = Threading::CpuTopology::system());
+    
     /**
      * @brief Get protocol as string
      */
@@ -195,15 +223,17 @@ struct NetworkStatistics {
     std::atomic<uint64_t> socketErrors{0};
     std::atomic<uint64_t> reconnections{0};
     std::atomic<uint32_t> connectionDrops{0};
+    std::atomic<uint64_t> resyncEvents{0};     ///< Stream resynchronisations after corrupt headers
+    std::atomic<uint64_t> bytesDiscarded{0};   ///< Bytes skipped while resynchronising
     
     // Performance statistics
     std::atomic<double> averageLatency{0.0};
     std::atomic<double> packetRate{0.0};
     std::atomic<double> byteRate{0.0};
     
-    // Timing
+    // Timing; batched receive threads store lastPacketTime
     std::chrono::steady_clock::time_point startTime;
-    std::chrono::steady_clock::time_point lastPacketTime;
+    std::atomic<std::chrono::steady_clock::time_point> lastPacketTime{std::chrono::steady_clock::time_point()};
     
     NetworkStatistics() 
         : startTime(std::chrono::steady_clock::now()) {}
@@ -248,6 +278,8 @@ struct NetworkStatistics {
         socketErrors = 0;
         reconnections = 0;
         connectionDrops = 0;
+        resyncEvents = 0;
+        bytesDiscarded = 0;
         averageLatency = 0.0;
         packetRate = 0.0;
         byteRate = 0.0;
@@ -0,0 +1,352 @@
+#include "batch_udp_receiver.h"
+#include "../../packet/core/packet_header.h"
+#include <algorithm>
+#include <chrono>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <poll.h>
+#include <sys/socket.h>
+#endif
+
+namespace Monitor {
+namespace Network {
+
+#ifdef Q_OS_LINUX
+
+/**
+ * @brief Per-slot recvmmsg() state, reused across batches
+ *
+ * Each slot keeps its pooled buffer until a datagram has been committed
+ * into a packet, so rejected datagrams do not cost an allocation. The
+ * second iovec of a slot points at its part of the overflow area, which
+ * takes whatever of a datagram does not fit the pooled buffer.
+ */
+struct BatchUdpReceiver::BatchState {
+    std::vector<Packet::PacketBuffer::ManagedBufferPtr> buffers;
+    std::vector<mmsghdr> messages;
+    std::vector<iovec> iovecs;          ///< Two per slot: pooled buffer, overflow
+    size_t controlSize;
+    std::vector<char> control;
+    size_t overflowSize;
+    std::vector<uint8_t> overflow;
+
+    BatchState(size_t slotCount, size_t overflowBytes)
+        : buffers(slotCount)
+        , messages(slotCount)
+        , iovecs(slotCount * 2)
+        , controlSize(CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(uint32_t)))
+        , control(slotCount * controlSize)
+        , overflowSize(overflowBytes)
+        , overflow(slotCount * overflowBytes)
+    {
+    }
+};
+
+#else
+
+struct BatchUdpReceiver::BatchState {
+    BatchState(size_t /* slotCount */, size_t /* overflowBytes */) {}
+};
+
+#endif
+
+BatchUdpReceiver::BatchUdpReceiver(const Configuration& config, Packet::PacketFactory* factory,
+                                   BatchCallback callback)
+    : m_config(config)
+    , m_factory(factory)
+    , m_callback(std::move(callback))
+    , m_logger(Logging::Logger::instance())
+    , m_maxDatagramSize(std::clamp(config.maxDatagramSize, Packet::PACKET_HEADER_SIZE,
+                                   Packet::PacketBuffer::maxBufferSize()))
+    , m_slotCapacity(Memory::SizeClass::blockSize(Memory::SizeClass::forSize(
+          std::clamp(config.slotSize, Packet::PACKET_HEADER_SIZE, m_maxDatagramSize))))
+    , m_fd(-1)
+{
+    m_config.batchSize = std::clamp(m_config.batchSize, 1, 1024);
+    if (m_config.cpus.empty() && m_config.cpuCore >= 0) {
+        m_config.cpus = {m_config.cpuCore};
+    }
+}
+
+BatchUdpReceiver::~BatchUdpReceiver() {
+    stop();
+}
+
+bool BatchUdpReceiver::isSupported() {
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool BatchUdpReceiver::start(qintptr socketDescriptor) {
+    if (m_running.load()) {
+        return true;
+    }
+
+    if (!isSupported()) {
+        m_logger->error("BatchUdpReceiver", "Batched UDP receive requires Linux recvmmsg()");
+        return false;
+    }
+
+    if (!m_factory || !m_callback || socketDescriptor < 0) {
+        m_logger->error("BatchUdpReceiver", "Receiver needs a packet factory, callback and bound socket");
+        return false;
+    }
+
+    m_fd = static_cast<int>(socketDescriptor);
+    if (!configureSocket()) {
+        return false;
+    }
+
+    // A thread that stopped on a socket error has exited but not been joined
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    m_stats.reset();
+    m_stopRequested.store(false);
+    m_running.store(true);
+    m_thread = std::thread(&BatchUdpReceiver::receiveLoop, this);
+
+    m_logger->info("BatchUdpReceiver",
+        QString("Receive thread started: batch size %1, %2-byte slots, CPUs %3")
+        .arg(m_config.batchSize)
+        .arg(m_slotCapacity)
+        .arg(m_config.cpus.empty() ? QString("any") : Threading::CpuTopology::formatCpuList(m_config.cpus)));
+    return true;
+}
+
+void BatchUdpReceiver::stop() {
+    // The thread may have exited on its own after a socket error, so join
+    // whenever there is one rather than trusting m_running
+    m_stopRequested.store(true);
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    m_thread.join();
+    m_running.store(false);
+    m_fd = -1;
+
+    m_logger->info("BatchUdpReceiver",
+        QString("Receive thread stopped: %1 datagrams in %2 calls (%3 per call), %4 kernel drops")
+        .arg(m_stats.datagramsReceived.load())
+        .arg(m_stats.receiveCalls.load())
+        .arg(m_stats.getAverageBatchSize(), 0, 'f', 1)
+        .arg(m_stats.kernelDrops.load()));
+}
+
+bool BatchUdpReceiver::configureSocket() {
+#ifdef Q_OS_LINUX
+    const int enable = 1;
+
+    if (m_config.kernelTimestamps &&
+        ::setsockopt(m_fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) != 0) {
+        m_logger->warning("BatchUdpReceiver",
+            QString("SO_TIMESTAMPNS unavailable (%1), using user-space receive time")
+            .arg(QString::fromLocal8Bit(std::strerror(errno))));
+    }
+
+    if (::setsockopt(m_fd, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) != 0) {
+        m_logger->warning("BatchUdpReceiver",
+            QString("SO_RXQ_OVFL unavailable (%1), kernel drops will not be reported")
+            .arg(QString::fromLocal8Bit(std::strerror(errno))));
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void BatchUdpReceiver::pinThread() {
+    if (m_config.cpus.empty()) {
+        return;
+    }
+
+    if (!Threading::pinCurrentThread(m_config.cpus)) {
+        m_logger->warning("BatchUdpReceiver",
+            QString("Failed to pin receive thread to CPUs %1")
+            .arg(Threading::CpuTopology::formatCpuList(m_config.cpus)));
+    }
+}
+
+void BatchUdpReceiver::receiveLoop() {
+#ifdef Q_OS_LINUX
+    pinThread();
+
+    BatchState state(static_cast<size_t>(m_config.batchSize),
+                     m_maxDatagramSize > m_slotCapacity ? m_maxDatagramSize - m_slotCapacity : 0);
+    std::vector<Packet::PacketPtr> packets;
+    packets.reserve(state.buffers.size());
+
+    pollfd pfd{};
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+
+    while (!m_stopRequested.load(std::memory_order_relaxed)) {
+        if (m_paused.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(m_config.pollTimeoutMs));
+            continue;
+        }
+
+        const int ready = ::poll(&pfd, 1, m_config.pollTimeoutMs);
+        if (ready < 0 && errno != EINTR) {
+            m_logger->error("BatchUdpReceiver",
+                QString("poll() failed: %1").arg(QString::fromLocal8Bit(std::strerror(errno))));
+            break;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+
+        // Drain the socket queue before sleeping in poll() again
+        for (;;) {
+            const int received = receiveBatch(state, packets);
+            const int error = received < 0 ? errno : 0;
+
+            if (!packets.empty()) {
+                m_callback(packets);
+                packets.clear();
+            }
+
+            if (received < 0) {
+                if (error != EAGAIN && error != EWOULDBLOCK && error != EINTR) {
+                    m_logger->error("BatchUdpReceiver",
+                        QString("recvmmsg() failed: %1").arg(QString::fromLocal8Bit(std::strerror(error))));
+                    m_stopRequested.store(true);
+                }
+                break;
+            }
+
+            if (received == 0) {
+                // Pool exhausted: give consumers a moment to release buffers
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                break;
+            }
+
+            if (static_cast<size_t>(received) < state.buffers.size()) {
+                break;
+            }
+        }
+    }
+#endif
+    m_running.store(false);
+}
+
+int BatchUdpReceiver::receiveBatch(BatchState& state, std::vector<Packet::PacketPtr>& packets) {
+#ifdef Q_OS_LINUX
+    // Top up the slots consumed by the previous batch
+    unsigned int filled = 0;
+    for (; filled < state.buffers.size(); ++filled) {
+        auto& buffer = state.buffers[filled];
+        if (!buffer) {
+            buffer = m_factory->acquireBuffer(m_slotCapacity);
+            if (!buffer) {
+                break;
+            }
+        }
+
+        iovec* iov = &state.iovecs[filled * 2];
+        iov[0].iov_base = buffer->bytes();
+        iov[0].iov_len = buffer->capacity();
+        iov[1].iov_base = state.overflow.data() + filled * state.overflowSize;
+        iov[1].iov_len = state.overflowSize;
+
+        msghdr& header = state.messages[filled].msg_hdr;
+        std::memset(&header, 0, sizeof(header));
+        header.msg_iov = iov;
+        header.msg_iovlen = state.overflowSize > 0 ? 2 : 1;
+        header.msg_control = state.control.data() + filled * state.controlSize;
+        header.msg_controllen = state.controlSize;
+    }
+
+    if (filled == 0) {
+        m_stats.bufferExhaustion++;
+        return 0;
+    }
+
+    const int received = ::recvmmsg(m_fd, state.messages.data(), filled, MSG_DONTWAIT, nullptr);
+    if (received <= 0) {
+        return received < 0 ? -1 : 0;
+    }
+
+    m_stats.receiveCalls++;
+    const uint64_t fallbackTimestamp = Packet::PacketHeader::getCurrentTimestampNs();
+
+    for (int i = 0; i < received; ++i) {
+        msghdr& header = state.messages[i].msg_hdr;
+        const size_t length = state.messages[i].msg_len;
+
+        // SCM_TIMESTAMPNS is CLOCK_REALTIME, the same epoch as PacketHeader timestamps
+        uint64_t timestamp = fallbackTimestamp;
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&header); cmsg; cmsg = CMSG_NXTHDR(&header, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET) {
+                continue;
+            }
+            if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                timestamp = static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL +
+                            static_cast<uint64_t>(ts.tv_nsec);
+            } else if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+                uint32_t drops;
+                std::memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+                m_stats.kernelDrops.store(drops, std::memory_order_relaxed);
+            }
+        }
+
+        m_stats.datagramsReceived++;
+        m_stats.bytesReceived += length;
+
+        if (header.msg_flags & MSG_TRUNC) {
+            m_stats.truncatedDatagrams++;
+            continue;
+        }
+
+        if (length < Packet::PACKET_HEADER_SIZE) {
+            m_stats.invalidDatagrams++;
+            continue;
+        }
+
+        // Slow path: the datagram ran into the overflow area, so copy it
+        // whole into a buffer of its own size and keep the slot's buffer
+        Packet::PacketBuffer::ManagedBufferPtr buffer;
+        if (length > state.buffers[i]->capacity()) {
+            buffer = m_factory->acquireBuffer(length);
+            if (!buffer) {
+                m_stats.bufferExhaustion++;
+                continue;
+            }
+            const size_t head = state.buffers[i]->capacity();
+            std::memcpy(buffer->bytes(), state.buffers[i]->bytes(), head);
+            std::memcpy(buffer->bytes() + head, state.overflow.data() + i * state.overflowSize, length - head);
+            m_stats.overflowCopies++;
+        } else {
+            buffer = std::move(state.buffers[i]);
+        }
+
+        auto result = m_factory->commitBuffer(std::move(buffer), length, m_config.headerByteOrder);
+        if (!result.success) {
+            m_stats.invalidDatagrams++;
+            continue;
+        }
+
+        result.packet->setReceiveTimestamp(timestamp);
+        packets.push_back(std::move(result.packet));
+    }
+
+    return received;
+#else
+    Q_UNUSED(state);
+    Q_UNUSED(packets);
+    return -1;
+#endif
+}
+
+} // namespace Network
+} // namespace Monitor
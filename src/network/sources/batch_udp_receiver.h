@@ -0,0 +1,145 @@
+#pragma once
+
+#include "../../packet/core/packet.h"
+#include "../../packet/core/packet_factory.h"
+#include "../../logging/logger.h"
+#include "../../threading/cpu_topology.h"
+
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace Monitor {
+namespace Network {
+
+/**
+ * @brief Batched UDP receive loop running on a dedicated thread
+ *
+ * Drains a bound UDP socket with recvmmsg(), pulling up to batchSize
+ * datagrams per system call straight into pooled packet buffers. Kernel
+ * receive timestamps (SO_TIMESTAMPNS) are attached to each packet and the
+ * kernel's socket overflow counter (SO_RXQ_OVFL) is tracked so that drops
+ * before the application ever sees a datagram are visible.
+ *
+ * Each slot holds a pooled buffer of slotSize rounded up to its size class,
+ * so a batch of typical datagrams does not pin the scarce large blocks.
+ * A datagram longer than its slot spills into a per-slot overflow area and
+ * is copied into a buffer of the right size on a slow path.
+ *
+ * Completed batches are handed to the callback on the receive thread; they
+ * never pass through the Qt event loop. Only available on Linux, see
+ * isSupported().
+ */
+class BatchUdpReceiver {
+public:
+    /**
+     * @brief Callback invoked on the receive thread for every non-empty batch
+     */
+    using BatchCallback = std::function<void(std::vector<Packet::PacketPtr>& packets)>;
+
+    /**
+     * @brief Receiver configuration
+     */
+    struct Configuration {
+        int batchSize = 32;             ///< Datagrams per recvmmsg() call
+        int cpuCore = -1;               ///< Core to pin the receive thread to (-1 = no pinning)
+        Threading::CpuSet cpus;         ///< CPUs for the receive thread; overrides cpuCore when set
+        size_t maxDatagramSize = 8192;  ///< Longest datagram accepted (clamped to the pool)
+        size_t slotSize = 1536;         ///< Pooled buffer per slot, rounded up to its size class
+        bool kernelTimestamps = true;   ///< Request SO_TIMESTAMPNS receive timestamps
+        int pollTimeoutMs = 100;        ///< Upper bound on stop/pause latency
+        Parser::Layout::ByteOrder headerByteOrder = Parser::Layout::ByteOrder::Native; ///< Sender's header byte order
+    };
+
+    /**
+     * @brief Receive loop statistics
+     */
+    struct Statistics {
+        std::atomic<uint64_t> receiveCalls{0};        ///< recvmmsg() calls that returned data
+        std::atomic<uint64_t> datagramsReceived{0};
+        std::atomic<uint64_t> bytesReceived{0};
+        std::atomic<uint64_t> truncatedDatagrams{0};  ///< Larger than maxDatagramSize
+        std::atomic<uint64_t> overflowCopies{0};      ///< Larger than a slot, copied out of the overflow area
+        std::atomic<uint64_t> invalidDatagrams{0};    ///< Too small or rejected by the factory
+        std::atomic<uint64_t> bufferExhaustion{0};    ///< Loop iterations with no pooled buffer
+        std::atomic<uint64_t> kernelDrops{0};         ///< Socket queue overflows reported by the kernel
+
+        double getAverageBatchSize() const {
+            uint64_t calls = receiveCalls.load();
+            if (calls == 0) return 0.0;
+            return static_cast<double>(datagramsReceived.load()) / calls;
+        }
+
+        void reset() {
+            receiveCalls = 0;
+            datagramsReceived = 0;
+            bytesReceived = 0;
+            truncatedDatagrams = 0;
+            overflowCopies = 0;
+            invalidDatagrams = 0;
+            bufferExhaustion = 0;
+            kernelDrops = 0;
+        }
+    };
+
+    BatchUdpReceiver(const Configuration& config, Packet::PacketFactory* factory,
+                     BatchCallback callback);
+    ~BatchUdpReceiver();
+
+    BatchUdpReceiver(const BatchUdpReceiver&) = delete;
+    BatchUdpReceiver& operator=(const BatchUdpReceiver&) = delete;
+
+    /**
+     * @brief Whether batched receive is available on this platform
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Start receiving from an already bound socket
+     * @param socketDescriptor Native descriptor, e.g. QUdpSocket::socketDescriptor()
+     */
+    bool start(qintptr socketDescriptor);
+
+    /**
+     * @brief Stop the receive thread and wait for it to exit
+     */
+    void stop();
+
+    /**
+     * @brief Leave datagrams queued in the kernel while paused
+     */
+    void setPaused(bool paused) { m_paused.store(paused); }
+
+    bool isRunning() const { return m_running.load(); }
+
+    const Statistics& getStatistics() const { return m_stats; }
+
+private:
+    struct BatchState;
+
+    bool configureSocket();
+    void pinThread();
+    void receiveLoop();
+    int receiveBatch(BatchState& state, std::vector<Packet::PacketPtr>& packets);
+
+    Configuration m_config;
+    Packet::PacketFactory* m_factory;
+    BatchCallback m_callback;
+    Logging::Logger* m_logger;
+
+    size_t m_maxDatagramSize;   ///< maxDatagramSize clamped to the largest pooled buffer
+    size_t m_slotCapacity;      ///< Block size of the slot buffers' class
+    int m_fd;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stopRequested{false};
+    std::atomic<bool> m_paused{false};
+
+    Statistics m_stats;
+};
+
+} // namespace Network
+} // namespace Monitor
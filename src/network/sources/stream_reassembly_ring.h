@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+namespace Monitor {
+namespace Network {
+
+/**
+ * @brief Fixed-capacity byte ring for reassembling packets from a stream
+ *
+ * Bytes are appended at the write cursor and consumed from the read cursor;
+ * consuming only advances the cursor, so no data is ever moved within the
+ * ring. Cursors are free-running 64-bit counters masked into a power-of-two
+ * storage block, which keeps size() and wrap-around handling branch-light.
+ *
+ * Single-threaded: owned by the stream source that feeds it.
+ */
+class StreamReassemblyRing {
+public:
+    /**
+     * @brief Contiguous writable region at the write cursor
+     */
+    struct Region {
+        uint8_t* data;
+        size_t size;
+    };
+
+    /**
+     * @brief Construct ring
+     * @param capacity Requested capacity, rounded up to a power of two
+     */
+    explicit StreamReassemblyRing(size_t capacity)
+        : m_capacity(roundUpToPowerOfTwo(std::max<size_t>(capacity, 64)))
+        , m_mask(m_capacity - 1)
+        , m_storage(new uint8_t[m_capacity])
+    {
+    }
+
+    StreamReassemblyRing(const StreamReassemblyRing&) = delete;
+    StreamReassemblyRing& operator=(const StreamReassemblyRing&) = delete;
+
+    size_t capacity() const { return m_capacity; }
+    size_t size() const { return static_cast<size_t>(m_write - m_read); }
+    size_t freeSpace() const { return m_capacity - size(); }
+    bool empty() const { return m_write == m_read; }
+
+    /**
+     * @brief Largest contiguous free region, for reading straight into the ring
+     *
+     * Follow with commitWrite(); call again to obtain the wrapped remainder.
+     */
+    Region writeRegion() {
+        const size_t offset = static_cast<size_t>(m_write) & m_mask;
+        return Region{m_storage.get() + offset, std::min(freeSpace(), m_capacity - offset)};
+    }
+
+    /**
+     * @brief Publish @p count bytes written into the last writeRegion()
+     */
+    void commitWrite(size_t count) {
+        m_write += std::min(count, freeSpace());
+    }
+
+    /**
+     * @brief Copy bytes from the ring without consuming them
+     * @param dest Destination buffer
+     * @param count Number of bytes to copy
+     * @param offset Offset from the read cursor
+     * @return Number of bytes copied (less than @p count if not buffered)
+     */
+    size_t peek(void* dest, size_t count, size_t offset = 0) const {
+        if (offset >= size()) {
+            return 0;
+        }
+        count = std::min(count, size() - offset);
+
+        const size_t start = static_cast<size_t>(m_read + offset) & m_mask;
+        const size_t first = std::min(count, m_capacity - start);
+        std::memcpy(dest, m_storage.get() + start, first);
+        if (first < count) {
+            std::memcpy(static_cast<uint8_t*>(dest) + first, m_storage.get(), count - first);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Discard @p count bytes at the read cursor
+     */
+    void consume(size_t count) {
+        m_read += std::min(count, size());
+    }
+
+    /**
+     * @brief Discard everything buffered
+     */
+    void clear() {
+        m_read = m_write;
+    }
+
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<uint8_t[]> m_storage;
+    uint64_t m_read = 0;
+    uint64_t m_write = 0;
+};
+
+} // namespace Network
+} // namespace Monitor
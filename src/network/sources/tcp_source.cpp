@@ -15,8 +15,12 @@ TcpSource::TcpSource(const NetworkConfig& config, QObject* parent)
     , m_connectionState(ConnectionState::Disconnected)
     , m_shouldReconnect(false)
     , m_reconnectAttempt(0)
-    , m_expectedPacketSize(0)
-    , m_parsingHeader(true)
+    , m_streamRing(STREAM_RING_CAPACITY)
+    , m_pendingSize(0)
+    , m_pendingFilled(0)
+    , m_skipRemaining(0)
+    , m_resyncing(false)
+    , m_resyncDiscarded(0)
     , m_pauseRequested(false)
     , m_consecutiveErrors(0)
     , m_connectionFailures(0)
@@ -186,6 +190,9 @@ void TcpSource::configureSocketOptions() {
     m_socket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 
                              m_networkConfig.receiveBufferSize);
     
+    // Bound Qt's internal read buffer so a stalled parser applies TCP flow control
+    m_socket->setReadBufferSize(STREAM_BUFFER_MAX_SIZE);
+    
     // Enable low delay for real-time applications
     m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
     
@@ -274,72 +281,259 @@ void TcpSource::onDataReady() {
 void TcpSource::processIncomingData() {
     if (!m_socket) return;
     
-    // Read available data
-    QByteArray newData = m_socket->readAll();
-    if (newData.isEmpty()) return;
-    
-    // Update statistics
-    m_networkStats.bytesReceived += newData.size();
-    
-    // Append to stream buffer
-    m_streamBuffer.append(newData);
-    
-    // Prevent buffer overflow
-    if (m_streamBuffer.size() > STREAM_BUFFER_MAX_SIZE) {
-        m_logger->warning("TcpSource", "Stream buffer overflow, resetting");
-        resetStreamState();
-        m_networkStats.packetErrors++;
-        return;
-    }
-    
-    // Parse packets from buffer
-    while (parsePacketFromStream()) {
-        // Continue parsing until no complete packets found
+    for (;;) {
+        // A large packet already under way is read straight into its pooled buffer
+        if (m_pendingBuffer) {
+            if (!readPendingPacket()) {
+                return;
+            }
+            continue;
+        }
+        
+        if (m_skipRemaining > 0) {
+            if (!skipPendingBytes()) {
+                return;
+            }
+            continue;
+        }
+        
+        const size_t filled = fillStreamRing();
+        parseBufferedPackets();
+        
+        if (!m_pendingBuffer && m_skipRemaining == 0 && filled == 0) {
+            return; // Socket drained; the ring holds at most a partial packet
+        }
     }
 }
 
-bool TcpSource::parsePacketFromStream() {
-    if (m_streamBuffer.size() < MIN_PACKET_SIZE) {
-        return false; // Not enough data
+size_t TcpSource::fillStreamRing() {
+    size_t total = 0;
+    
+    // At most two reads: up to the end of the storage, then the wrapped part
+    while (m_streamRing.freeSpace() > 0 && m_socket->bytesAvailable() > 0) {
+        auto region = m_streamRing.writeRegion();
+        const qint64 bytesRead = m_socket->read(reinterpret_cast<char*>(region.data), 
+                                                static_cast<qint64>(region.size));
+        if (bytesRead <= 0) {
+            break;
+        }
+        m_streamRing.commitWrite(static_cast<size_t>(bytesRead));
+        total += static_cast<size_t>(bytesRead);
     }
     
-    if (m_parsingHeader) {
-        // Need at least header size
-        if (m_streamBuffer.size() < static_cast<qsizetype>(sizeof(Packet::PacketHeader))) {
-            return false;
+    m_stats.bytesCopied += total;
+    return total;
+}
+
+void TcpSource::parseBufferedPackets() {
+    while (m_streamRing.size() >= Packet::PACKET_HEADER_SIZE) {
+        if (m_resyncing && !resyncStream()) {
+            return; // No confirmed header boundary buffered yet
         }
         
-        // Extract packet size from header
-        const Packet::PacketHeader* header = 
-            reinterpret_cast<const Packet::PacketHeader*>(m_streamBuffer.constData());
+        Packet::PacketHeader header;
+        m_streamRing.peek(&header, sizeof(header));
+        header.convertToHostOrder(m_networkConfig.headerByteOrder);
+        
+        if (!isPlausibleHeader(header)) {
+            // Corrupt length or header: drop the byte and hunt for the next header
+            m_resyncing = true;
+            m_resyncDiscarded = 1;
+            m_streamRing.consume(1);
+            m_networkStats.resyncEvents++;
+            m_networkStats.packetErrors++;
+            m_networkStats.bytesDiscarded++;
+            m_logger->warning("TcpSource", "Corrupt packet header in stream, resynchronising");
+            continue;
+        }
         
-        // Calculate total packet size (header + payload)
-        m_expectedPacketSize = sizeof(Packet::PacketHeader) + header->payloadSize;
+        const size_t packetSize = Packet::PACKET_HEADER_SIZE + header.payloadSize;
         
-        // Validate packet size
-        if (m_expectedPacketSize < MIN_PACKET_SIZE || 
-            m_expectedPacketSize > MAX_PACKET_SIZE) {
+        if (packetSize > Packet::PacketBuffer::maxBufferSize()) {
+            // Well-formed but larger than any pooled buffer: skip it, keep framing
             m_logger->warning("TcpSource", 
-                QString("Invalid packet size in header: %1").arg(m_expectedPacketSize));
-            resetStreamState();
-            m_networkStats.packetErrors++;
-            return false;
+                QString("No pooled buffer for %1 byte packet, skipping").arg(packetSize));
+            const size_t buffered = std::min(packetSize, m_streamRing.size());
+            m_streamRing.consume(buffered);
+            m_skipRemaining = static_cast<qint64>(packetSize - buffered);
+            m_networkStats.bytesReceived += buffered;
+            handleParsedPacket(nullptr);
+            if (m_skipRemaining > 0) {
+                return;
+            }
+            continue;
         }
         
-        m_parsingHeader = false;
+        if (m_streamRing.size() < packetSize) {
+            if (packetSize >= static_cast<size_t>(DIRECT_READ_THRESHOLD)) {
+                startPendingPacket(packetSize);
+            }
+            return; // Wait for more data
+        }
+        
+        handleParsedPacket(slicePacketFromRing(packetSize));
+    }
+}
+
+Packet::PacketPtr TcpSource::slicePacketFromRing(size_t packetSize) {
+    m_networkStats.bytesReceived += packetSize;
+    
+    if (!m_packetFactory) {
+        m_logger->error("TcpSource", "Packet factory not set");
+        m_streamRing.consume(packetSize);
+        return nullptr;
     }
     
-    // Check if we have complete packet
-    if (m_streamBuffer.size() < m_expectedPacketSize) {
-        return false; // Wait for more data
+    auto buffer = m_packetFactory->acquireBuffer(packetSize);
+    if (!buffer || buffer->capacity() < packetSize) {
+        m_logger->error("TcpSource", 
+            QString("No pooled buffer for %1 byte packet, skipping").arg(packetSize));
+        m_streamRing.consume(packetSize);
+        return nullptr;
     }
     
-    // Extract packet data
-    QByteArray packetData = m_streamBuffer.left(m_expectedPacketSize);
-    m_streamBuffer.remove(0, m_expectedPacketSize);
+    // Copies at most two spans when the packet wraps around the ring
+    m_streamRing.peek(buffer->bytes(), packetSize);
+    m_streamRing.consume(packetSize);
+    m_stats.bytesCopied += packetSize;
     
-    // Create packet
-    auto packet = createPacketFromData(packetData);
+    auto result = m_packetFactory->commitBuffer(std::move(buffer), packetSize,
+                                                m_networkConfig.headerByteOrder);
+    if (!result.success) {
+        m_logger->error("TcpSource", 
+            QString("Failed to create packet: %1").arg(QString::fromStdString(result.error)));
+        return nullptr;
+    }
+    
+    return result.packet;
+}
+
+void TcpSource::startPendingPacket(size_t packetSize) {
+    const size_t buffered = m_streamRing.size();
+    
+    auto buffer = m_packetFactory ? m_packetFactory->acquireBuffer(packetSize) : nullptr;
+    if (!buffer || buffer->capacity() < packetSize) {
+        m_logger->error("TcpSource", 
+            QString("No pooled buffer for %1 byte packet, skipping").arg(packetSize));
+        m_streamRing.consume(buffered);
+        m_skipRemaining = static_cast<qint64>(packetSize - buffered);
+        m_networkStats.bytesReceived += buffered;
+        handleParsedPacket(nullptr);
+        return;
+    }
+    
+    // The ring holds only the start of this packet; the rest bypasses it
+    m_streamRing.peek(buffer->bytes(), buffered);
+    m_streamRing.consume(buffered);
+    m_stats.bytesCopied += buffered;
+    
+    m_pendingBuffer = std::move(buffer);
+    m_pendingSize = packetSize;
+    m_pendingFilled = buffered;
+}
+
+bool TcpSource::readPendingPacket() {
+    while (m_pendingFilled < m_pendingSize) {
+        const qint64 bytesRead = m_socket->read(
+            reinterpret_cast<char*>(m_pendingBuffer->bytes() + m_pendingFilled),
+            static_cast<qint64>(m_pendingSize - m_pendingFilled));
+        if (bytesRead <= 0) {
+            return false; // Wait for more data
+        }
+        m_pendingFilled += static_cast<size_t>(bytesRead);
+        m_stats.bytesCopied += static_cast<uint64_t>(bytesRead);
+    }
+    
+    m_networkStats.bytesReceived += m_pendingSize;
+    
+    auto result = m_packetFactory->commitBuffer(std::move(m_pendingBuffer), m_pendingSize,
+                                                m_networkConfig.headerByteOrder);
+    m_pendingBuffer.reset();
+    m_pendingSize = 0;
+    m_pendingFilled = 0;
+    
+    if (!result.success) {
+        m_logger->error("TcpSource", 
+            QString("Failed to create packet: %1").arg(QString::fromStdString(result.error)));
+    }
+    handleParsedPacket(result.success ? result.packet : nullptr);
+    return true;
+}
+
+bool TcpSource::skipPendingBytes() {
+    while (m_skipRemaining > 0) {
+        const qint64 skipped = m_socket->skip(m_skipRemaining);
+        if (skipped <= 0) {
+            return false; // Wait for more data
+        }
+        m_skipRemaining -= skipped;
+        m_networkStats.bytesReceived += static_cast<uint64_t>(skipped);
+    }
+    return true;
+}
+
+bool TcpSource::resyncStream() {
+    const size_t buffered = m_streamRing.size();
+    size_t tentative = buffered;
+    size_t offset = 0;
+    
+    // A candidate only counts once the headers of the packets following it
+    // are plausible too and close to it in time; a lone match is too easy to
+    // hit inside payload bytes
+    Packet::PacketHeader header;
+    for (; offset + Packet::PACKET_HEADER_SIZE <= buffered; ++offset) {
+        size_t position = offset;
+        uint64_t previousTimestamp = 0;
+        int confirmed = -1;
+        bool complete = true;
+        
+        while (confirmed < RESYNC_CONFIRMATIONS) {
+            if (position + Packet::PACKET_HEADER_SIZE > buffered) {
+                complete = false;
+                break;
+            }
+            m_streamRing.peek(&header, sizeof(header), position);
+            header.convertToHostOrder(m_networkConfig.headerByteOrder);
+            if (!isPlausibleHeader(header)) {
+                break;
+            }
+            if (confirmed >= 0) {
+                const uint64_t gap = header.timestamp > previousTimestamp ? 
+                    header.timestamp - previousTimestamp : previousTimestamp - header.timestamp;
+                if (gap > RESYNC_MAX_TIMESTAMP_GAP_NS) {
+                    break;
+                }
+            }
+            previousTimestamp = header.timestamp;
+            position += Packet::PACKET_HEADER_SIZE + header.payloadSize;
+            ++confirmed;
+        }
+        
+        if (!complete && confirmed >= 0) {
+            tentative = std::min(tentative, offset); // Cannot be confirmed yet
+            continue;
+        }
+        
+        if (confirmed == RESYNC_CONFIRMATIONS) {
+            m_streamRing.consume(offset);
+            m_resyncDiscarded += offset;
+            m_networkStats.bytesDiscarded += offset;
+            m_resyncing = false;
+            m_logger->info("TcpSource", 
+                QString("Stream resynchronised after %1 discarded bytes").arg(m_resyncDiscarded));
+            return true;
+        }
+    }
+    
+    // Keep the earliest unconfirmed candidate (or the unscanned tail) and wait
+    const size_t discard = std::min(tentative, offset);
+    m_streamRing.consume(discard);
+    m_resyncDiscarded += discard;
+    m_networkStats.bytesDiscarded += discard;
+    return false;
+}
+
+void TcpSource::handleParsedPacket(const Packet::PacketPtr& packet) {
     if (packet) {
         // Update statistics
         m_networkStats.packetsReceived++;
@@ -354,37 +548,16 @@ bool TcpSource::parsePacketFromStream() {
         m_consecutiveErrors++;
     }
     
-    // Reset for next packet
-    m_parsingHeader = true;
-    m_expectedPacketSize = 0;
-    
     // Check for too many consecutive errors
     if (m_consecutiveErrors > MAX_CONSECUTIVE_ERRORS) {
         m_logger->error("TcpSource", "Too many consecutive packet parsing errors");
         resetConnection();
-        return false;
     }
-    
-    return true; // Continue parsing if more data available
 }
 
-Packet::PacketPtr TcpSource::createPacketFromData(const QByteArray& data) {
-    if (!m_packetFactory) {
-        m_logger->error("TcpSource", "Packet factory not set");
-        return nullptr;
-    }
-    
-    // Create packet using factory
-    auto result = m_packetFactory->createFromRawData(data.constData(), data.size());
-    if (!result.success) {
-        m_logger->error("TcpSource", 
-            QString("Failed to create packet: %1").arg(QString::fromStdString(result.error)));
-        return nullptr;
-    }
-    
-    auto packet = result.packet;
-    
-    return packet;
+bool TcpSource::isPlausibleHeader(const Packet::PacketHeader& header) {
+    return header.isValid() && 
+           Packet::PACKET_HEADER_SIZE + header.payloadSize <= static_cast<size_t>(MAX_PACKET_SIZE);
 }
 
 void TcpSource::onSocketError(QAbstractSocket::SocketError error) {
@@ -546,9 +719,17 @@ void TcpSource::setConnectionState(ConnectionState newState) {
 }
 
 void TcpSource::resetStreamState() {
-    m_streamBuffer.clear();
-    m_expectedPacketSize = 0;
-    m_parsingHeader = true;
+    // Drop everything buffered for the old stream, ours and the socket's
+    if (m_socket && m_socket->bytesAvailable() > 0) {
+        m_socket->skip(m_socket->bytesAvailable());
+    }
+    m_streamRing.clear();
+    m_pendingBuffer.reset();
+    m_pendingSize = 0;
+    m_pendingFilled = 0;
+    m_skipRemaining = 0;
+    m_resyncing = false;
+    m_resyncDiscarded = 0;
 }
 
 void TcpSource::updateNetworkStatistics() {
@@ -2,6 +2,7 @@
 
 #include "../../packet/sources/packet_source.h"
 #include "../config/network_config.h"
+#include "stream_reassembly_ring.h"
 #include "../../concurrent/spsc_ring_buffer.h"
 #include "../../logging/logger.h"
 
@@ -26,7 +27,8 @@ namespace Network {
  * - Event-driven TCP connection management
  * - Stream-based packet boundary detection
  * - Automatic reconnection with exponential backoff
- * - Partial packet assembly and buffering
+ * - Partial packet assembly in a fixed reassembly ring (no memory shifting)
+ * - Resynchronisation on corrupt headers instead of dropping the stream
  * - Connection state monitoring
  * - Comprehensive error recovery
  */
@@ -201,14 +203,48 @@ private:
     void processIncomingData();
     
     /**
-     * @brief Parse packet from stream buffer
+     * @brief Append available socket data to the reassembly ring
+     * @return Number of bytes moved into the ring
      */
-    bool parsePacketFromStream();
+    size_t fillStreamRing();
     
     /**
-     * @brief Create packet from parsed data
+     * @brief Parse every complete packet currently in the reassembly ring
      */
-    Packet::PacketPtr createPacketFromData(const QByteArray& data);
+    void parseBufferedPackets();
+    
+    /**
+     * @brief Copy one complete packet out of the ring into a pooled buffer
+     */
+    Packet::PacketPtr slicePacketFromRing(size_t packetSize);
+    
+    /**
+     * @brief Start reading a large, partially received packet directly into pool memory
+     */
+    void startPendingPacket(size_t packetSize);
+    
+    /**
+     * @brief Continue a direct read started by startPendingPacket()
+     * @return True once the packet is complete
+     */
+    bool readPendingPacket();
+    
+    /**
+     * @brief Discard the rest of a packet that cannot be pooled
+     * @return True once all of it has been skipped
+     */
+    bool skipPendingBytes();
+    
+    /**
+     * @brief Drop bytes until the ring starts with a confirmed packet header
+     * @return False if more data is needed to confirm a candidate
+     */
+    bool resyncStream();
+    
+    /**
+     * @brief Update statistics and deliver a parsed packet (or count the failure)
+     */
+    void handleParsedPacket(const Packet::PacketPtr& packet);
     
     /**
      * @brief Handle connection establishment
@@ -246,14 +282,9 @@ private:
     void updateNetworkStatistics();
     
     /**
-     * @brief Find packet boundary in stream
-     */
-    int findPacketBoundary(const QByteArray& data, int startPos) const;
-    
-    /**
-     * @brief Validate packet size and structure
+     * @brief Check whether a header could start a valid packet
      */
-    bool isValidPacket(const QByteArray& data) const;
+    static bool isPlausibleHeader(const Packet::PacketHeader& header);
     
     // Network configuration
     NetworkConfig m_networkConfig;
@@ -267,9 +298,13 @@ private:
     std::unique_ptr<QTimer> m_keepAliveTimer;
     
     // Stream processing
-    QByteArray m_streamBuffer;
-    int m_expectedPacketSize;
-    bool m_parsingHeader;
+    StreamReassemblyRing m_streamRing;
+    Packet::PacketBuffer::ManagedBufferPtr m_pendingBuffer;  ///< Large packet being read in place
+    size_t m_pendingSize;
+    size_t m_pendingFilled;
+    qint64 m_skipRemaining;                                  ///< Bytes left of an unpoolable packet
+    bool m_resyncing;
+    uint64_t m_resyncDiscarded;
     std::atomic<bool> m_pauseRequested;
     
     // Statistics and monitoring
@@ -285,6 +320,10 @@ private:
     // Performance tuning
     static constexpr int STATISTICS_UPDATE_INTERVAL = 1000;    // 1 second
     static constexpr int STREAM_BUFFER_MAX_SIZE = 1048576;     // 1MB
+    static constexpr int STREAM_RING_CAPACITY = 262144;        // Reassembly ring (256KB)
+    static constexpr int DIRECT_READ_THRESHOLD = 2048;         // Larger partial packets bypass the ring
+    static constexpr int RESYNC_CONFIRMATIONS = 2;             // Plausible headers required after a candidate
+    static constexpr uint64_t RESYNC_MAX_TIMESTAMP_GAP_NS = 3600ULL * 1000000000ULL; // 1 hour
     static constexpr int MIN_PACKET_SIZE = 24;                 // Minimum packet size
     static constexpr int MAX_PACKET_SIZE = 65536;              // Maximum packet size (64KB)
     static constexpr int BASE_RECONNECT_DELAY = 1000;          // Base delay: 1 second
@@ -74,6 +74,8 @@ bool UdpSource::doStart() {
     
     // Reset statistics
     m_networkStats.reset();
+    m_packetsSinceLastCheck = 0;
+    m_lastRateCheck = std::chrono::steady_clock::now();
     m_consecutiveErrors = 0;
     m_pauseRequested = false;
     
@@ -94,6 +96,11 @@ bool UdpSource::doStart() {
         }
     }
     
+    // Hand the socket to the receive thread if batched receive is requested
+    if (m_networkConfig.enableBatchReceive && !startBatchReceiver()) {
+        m_logger->warning("UdpSource", "Batched receive unavailable, using event loop receive");
+    }
+    
     // Start statistics timer
     m_statisticsTimer->start(STATISTICS_UPDATE_INTERVAL);
     
@@ -114,6 +121,12 @@ void UdpSource::doStop() {
         m_statisticsTimer->stop();
     }
     
+    // The receive thread must be gone before its descriptor is closed
+    if (m_batchReceiver) {
+        m_batchReceiver->stop();
+        m_batchReceiver.reset();
+    }
+    
     // Cleanup multicast
     if (m_multicastJoined) {
         cleanupMulticast();
@@ -135,6 +148,9 @@ void UdpSource::doStop() {
 
 void UdpSource::doPause() {
     m_pauseRequested = true;
+    if (m_batchReceiver) {
+        m_batchReceiver->setPaused(true);
+    }
     m_logger->info("UdpSource", 
         QString("UDP source paused: %1")
         .arg(QString::fromStdString(m_networkConfig.name)));
@@ -142,6 +158,9 @@ void UdpSource::doPause() {
 
 bool UdpSource::doResume() {
     m_pauseRequested = false;
+    if (m_batchReceiver) {
+        m_batchReceiver->setPaused(false);
+    }
     m_logger->info("UdpSource", 
         QString("UDP source resumed: %1")
         .arg(QString::fromStdString(m_networkConfig.name)));
@@ -280,17 +299,14 @@ void UdpSource::cleanupMulticast() {
 }
 
 void UdpSource::onDatagramReady() {
-    if (m_pauseRequested.load()) {
-        return; // Skip processing while paused
+    if (m_pauseRequested.load() || m_batchReceiver) {
+        return; // Skip processing while paused or owned by the receive thread
     }
     
     auto receiveTime = std::chrono::steady_clock::now();
     
     while (m_socket && m_socket->hasPendingDatagrams()) {
-        QNetworkDatagram datagram = m_socket->receiveDatagram();
-        
-        if (datagram.isValid()) {
-            processDatagram(datagram);
+        if (receivePendingDatagram()) {
             updateLatencyStats(receiveTime);
         } else {
             m_networkStats.packetErrors++;
@@ -307,62 +323,144 @@ void UdpSource::onDatagramReady() {
     m_consecutiveErrors = 0;
 }
 
-void UdpSource::processDatagram(const QNetworkDatagram& datagram) {
+bool UdpSource::receivePendingDatagram() {
+    const qint64 pendingSize = m_socket->pendingDatagramSize();
+    if (pendingSize < 0) {
+        return false;
+    }
+    
     // Check rate limiting
     if (shouldDropForRateLimit()) {
+        discardPendingDatagram();
         m_networkStats.packetsDropped++;
-        return;
+        return true;
     }
     
-    // Create packet from datagram
-    auto packet = createPacketFromDatagram(datagram.data(),
-                                          datagram.senderAddress(),
-                                          datagram.senderPort());
-    
-    if (packet) {
-        // Update statistics
-        m_networkStats.packetsReceived++;
-        m_networkStats.bytesReceived += datagram.data().size();
-        m_networkStats.lastPacketTime = std::chrono::steady_clock::now();
-        
-        // Deliver packet
-        deliverPacket(packet);
-        
-        m_packetsSinceLastCheck++;
-    } else {
-        m_networkStats.packetErrors++;
-    }
-}
-
-Packet::PacketPtr UdpSource::createPacketFromDatagram(const QByteArray& data,
-                                                     const QHostAddress& /* sender */,
-                                                     quint16 /* senderPort */) {
     if (!m_packetFactory) {
         m_logger->error("UdpSource", "Packet factory not set");
-        return nullptr;
+        discardPendingDatagram();
+        m_networkStats.packetErrors++;
+        return true;
     }
     
     // Ensure minimum packet size
-    if (data.size() < static_cast<qsizetype>(sizeof(Packet::PacketHeader))) {
+    if (pendingSize < static_cast<qint64>(sizeof(Packet::PacketHeader))) {
+        m_logger->warning("UdpSource", 
+            QString("Received datagram too small: %1 bytes").arg(pendingSize));
+        discardPendingDatagram();
+        m_networkStats.packetErrors++;
+        return true;
+    }
+    
+    // Receive straight from the kernel into pool memory: the only copy
+    auto buffer = m_packetFactory->acquireBuffer(static_cast<size_t>(pendingSize));
+    if (!buffer || buffer->capacity() < static_cast<size_t>(pendingSize)) {
         m_logger->warning("UdpSource", 
-            QString("Received datagram too small: %1 bytes").arg(data.size()));
-        return nullptr;
+            QString("No pooled buffer for %1 byte datagram, dropping").arg(pendingSize));
+        discardPendingDatagram();
+        m_networkStats.packetsDropped++;
+        return true;
     }
     
-    // Create packet using factory
-    auto result = m_packetFactory->createFromRawData(data.constData(), data.size());
+    const qint64 bytesRead = m_socket->readDatagram(reinterpret_cast<char*>(buffer->bytes()), 
+                                                    pendingSize);
+    if (bytesRead < 0) {
+        return false;
+    }
+    
+    m_stats.bytesCopied += static_cast<uint64_t>(bytesRead);
+    
+    auto result = m_packetFactory->commitBuffer(std::move(buffer), static_cast<size_t>(bytesRead),
+                                                m_networkConfig.headerByteOrder);
     if (!result.success) {
         m_logger->error("UdpSource", 
             QString("Failed to create packet: %1").arg(QString::fromStdString(result.error)));
-        return nullptr;
+        m_networkStats.packetErrors++;
+        return true;
     }
     
-    auto packet = result.packet;
+    // Update statistics
+    m_networkStats.packetsReceived++;
+    m_networkStats.bytesReceived += bytesRead;
+    m_networkStats.lastPacketTime = std::chrono::steady_clock::now();
     
-    // Set network-specific metadata if needed
-    // This could include sender information, network interface, etc.
+    // Deliver packet
+    deliverPacket(result.packet);
     
-    return packet;
+    m_packetsSinceLastCheck++;
+    return true;
+}
+
+void UdpSource::discardPendingDatagram() {
+    // A zero-length read consumes the datagram without copying its payload
+    m_socket->readDatagram(nullptr, 0);
+}
+
+bool UdpSource::startBatchReceiver() {
+    if (!BatchUdpReceiver::isSupported() || !m_socket || !m_packetFactory) {
+        return false;
+    }
+    
+    BatchUdpReceiver::Configuration receiverConfig;
+    receiverConfig.batchSize = m_networkConfig.receiveBatchSize;
+    receiverConfig.cpuCore = m_networkConfig.receiveThreadCore;
+    if (!m_networkConfig.receiveThreadCpus.isEmpty()) {
+        bool ok = false;
+        receiverConfig.cpus = Threading::CpuTopology::parseCpuList(
+            m_networkConfig.receiveThreadCpus.toStdString(), &ok);
+        if (!ok) {
+            m_logger->warning("UdpSource", QString("Ignoring malformed receive thread CPU list '%1'")
+                .arg(m_networkConfig.receiveThreadCpus));
+        }
+    }
+    receiverConfig.maxDatagramSize = static_cast<size_t>(m_networkConfig.maxPacketSize);
+    receiverConfig.kernelTimestamps = m_networkConfig.enableTimestamping;
+    receiverConfig.headerByteOrder = m_networkConfig.headerByteOrder;
+    
+    m_batchReceiver = std::make_unique<BatchUdpReceiver>(receiverConfig, m_packetFactory,
+        [this](std::vector<Packet::PacketPtr>& packets) { onDatagramBatch(packets); });
+    
+    // Qt stops polling an unbuffered UDP socket after readyRead until it is
+    // read through Qt again, so the event loop leaves the descriptor alone
+    if (!m_batchReceiver->start(m_socket->socketDescriptor())) {
+        m_batchReceiver.reset();
+        return false;
+    }
+    
+    m_logger->info("UdpSource", 
+        QString("Batched receive active: %1 datagrams per call")
+        .arg(m_networkConfig.receiveBatchSize));
+    return true;
+}
+
+void UdpSource::onDatagramBatch(std::vector<Packet::PacketPtr>& packets) {
+    uint64_t bytes = 0;
+    size_t kept = 0;
+    
+    for (size_t i = 0; i < packets.size(); ++i) {
+        if (shouldDropForRateLimit()) {
+            m_networkStats.packetsDropped++;
+            continue;
+        }
+        bytes += packets[i]->totalSize();
+        if (kept != i) {
+            packets[kept] = std::move(packets[i]);
+        }
+        ++kept;
+    }
+    packets.resize(kept);
+    
+    if (packets.empty()) {
+        return;
+    }
+    
+    m_stats.bytesCopied += bytes;
+    m_networkStats.packetsReceived += packets.size();
+    m_networkStats.bytesReceived += bytes;
+    m_networkStats.lastPacketTime = std::chrono::steady_clock::now();
+    m_packetsSinceLastCheck += static_cast<uint32_t>(packets.size());
+    
+    deliverPacketBatch(packets);
 }
 
 void UdpSource::onSocketError(QAbstractSocket::SocketError error) {
@@ -438,15 +536,14 @@ bool UdpSource::shouldDropForRateLimit() {
     }
     
     auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastRateCheck);
+    auto lastCheck = m_lastRateCheck.load();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastCheck);
     
-    // Check every 100ms
-    if (elapsed.count() >= 100) {
+    // Check every 100ms; only the caller that moves the check time on takes the interval
+    if (elapsed.count() >= 100 && m_lastRateCheck.compare_exchange_strong(lastCheck, now)) {
         uint32_t packetsInInterval = m_packetsSinceLastCheck.exchange(0);
         double currentRate = (packetsInInterval * 1000.0) / elapsed.count();
         
-        m_lastRateCheck = now;
-        
         return currentRate > m_config.maxPacketRate;
     }
     
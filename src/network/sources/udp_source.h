@@ -2,6 +2,7 @@
 
 #include "../../packet/sources/packet_source.h"
 #include "../config/network_config.h"
+#include "batch_udp_receiver.h"
 #include "../../concurrent/spsc_ring_buffer.h"
 #include "../../threading/thread_worker.h"
 #include "../../logging/logger.h"
@@ -31,6 +32,9 @@ namespace Network {
  * - High-precision packet timestamping
  * - Comprehensive network statistics
  * - Automatic error recovery
+ * - Optional batched receive mode (Linux): a dedicated, optionally pinned
+ *   thread drains the socket with recvmmsg() and hands whole batches to the
+ *   batch callback without going through the Qt event loop
  */
 class UdpSource : public Packet::PacketSource {
     Q_OBJECT
@@ -72,6 +76,18 @@ public:
      * @brief Get current socket state for diagnostics
      */
     QString getSocketState() const;
+    
+    /**
+     * @brief Check if the batched receive thread is active
+     */
+    bool isBatchReceiveActive() const { return m_batchReceiver && m_batchReceiver->isRunning(); }
+    
+    /**
+     * @brief Get batched receive statistics (nullptr when not in batch mode)
+     */
+    const BatchUdpReceiver::Statistics* getBatchReceiveStatistics() const {
+        return m_batchReceiver ? &m_batchReceiver->getStatistics() : nullptr;
+    }
 
 public slots:
     /**
@@ -147,16 +163,25 @@ private:
     void configureSocketOptions();
     
     /**
-     * @brief Process received datagram and create packet
+     * @brief Receive the next pending datagram straight into a pooled buffer
+     * @return False if the socket reported a read error
      */
-    void processDatagram(const QNetworkDatagram& datagram);
+    bool receivePendingDatagram();
     
     /**
-     * @brief Create packet from datagram data
+     * @brief Drop the next pending datagram without copying it
      */
-    Packet::PacketPtr createPacketFromDatagram(const QByteArray& data, 
-                                               const QHostAddress& sender,
-                                               quint16 senderPort);
+    void discardPendingDatagram();
+    
+    /**
+     * @brief Start the recvmmsg() receive thread on the bound socket
+     */
+    bool startBatchReceiver();
+    
+    /**
+     * @brief Handle a batch from the receive thread (runs on that thread)
+     */
+    void onDatagramBatch(std::vector<Packet::PacketPtr>& packets);
     
     /**
      * @brief Handle socket binding
@@ -188,6 +213,9 @@ private:
     bool m_multicastJoined;
     QNetworkInterface m_networkInterface;
     
+    // Batched receive mode
+    std::unique_ptr<BatchUdpReceiver> m_batchReceiver;
+    
     // Statistics and monitoring
     NetworkStatistics m_networkStats;
     std::unique_ptr<QTimer> m_statisticsTimer;
@@ -199,9 +227,9 @@ private:
     std::chrono::steady_clock::time_point m_lastPacketTime;
     std::atomic<bool> m_pauseRequested;
     
-    // Rate limiting
+    // Rate limiting; checked on the batched receive thread when there is one
     std::atomic<uint32_t> m_packetsSinceLastCheck;
-    std::chrono::steady_clock::time_point m_lastRateCheck;
+    std::atomic<std::chrono::steady_clock::time_point> m_lastRateCheck;
     
     // Error handling
     std::atomic<uint32_t> m_consecutiveErrors;
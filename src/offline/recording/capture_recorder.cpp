@@ -0,0 +1,465 @@
+#include "capture_recorder.h"
+#include "../../packet/core/packet_header.h"
+#include "../../packet/routing/packet_dispatcher.h"
+#include "../../memory/numa_memory.h"
+
+#include <QDir>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Monitor {
+namespace Offline {
+
+CaptureRecorder::CaptureRecorder(const Configuration& config)
+    : m_config(config)
+    , m_logger(Logging::Logger::instance())
+    , m_alignment(1)
+    , m_bufferCapacity(0)
+    , m_active(nullptr)
+    , m_fileBytes(0)
+    , m_accepting(false)
+    , m_stopRequested(false)
+    , m_recording(false)
+    , m_fileSequence(0)
+    , m_fileEnd(0)
+    , m_allocatedBytes(0)
+    , m_filePackets(0)
+    , m_preallocate(false)
+    , m_indexer(std::make_unique<FileIndexer>())
+    , m_dispatcher(nullptr)
+    , m_subscriberId(0)
+{
+}
+
+CaptureRecorder::~CaptureRecorder() {
+    detach();
+    stop();
+}
+
+bool CaptureRecorder::start() {
+    if (m_recording.load()) {
+        return true;
+    }
+    m_error.clear();
+
+    if (m_config.bufferCount < 2) {
+        return fail("At least two write buffers are required");
+    }
+    if (m_config.bufferSize < MIN_BUFFER_SIZE) {
+        return fail(QString("Write buffers must hold at least %1 bytes").arg(MIN_BUFFER_SIZE));
+    }
+    if (!QDir().mkpath(m_config.directory)) {
+        return fail(QString("Cannot create recording directory %1").arg(m_config.directory));
+    }
+
+    m_alignment = 1;
+#ifdef Q_OS_LINUX
+    if (m_config.directIo) {
+        m_alignment = DIRECT_IO_ALIGNMENT;
+    }
+#endif
+
+    m_startTime = QDateTime::currentDateTime();
+    if (!openFile(m_fileSequence + 1)) {
+        return fail(QString("Failed to create recording in %1").arg(m_config.directory));
+    }
+
+    // Aligned for O_DIRECT, which needs aligned memory as well as offsets
+    m_bufferCapacity = (m_config.bufferSize + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT;
+    m_buffers.resize(m_config.bufferCount);
+    for (Buffer& buffer : m_buffers) {
+        buffer.data = static_cast<uchar*>(qMallocAligned(m_bufferCapacity, DIRECT_IO_ALIGNMENT));
+        if (!buffer.data) {
+            finishFile();
+            for (Buffer& allocated : m_buffers) {
+                qFreeAligned(allocated.data);
+            }
+            m_buffers.clear();
+            return fail("Failed to allocate write buffers");
+        }
+        if (m_config.memoryNode >= 0 &&
+            !Memory::placeOnNumaNode(buffer.data, m_bufferCapacity, m_config.memoryNode)) {
+            m_logger->warning("CaptureRecorder",
+                QString("Failed to place write buffers on NUMA node %1").arg(m_config.memoryNode));
+        }
+    }
+
+    m_active = &m_buffers[0];
+    m_active->fileSequence = m_fileSequence;
+    m_freeBuffers.clear();
+    for (size_t i = 1; i < m_buffers.size(); ++i) {
+        m_freeBuffers.push_back(&m_buffers[i]);
+    }
+    m_fullBuffers.clear();
+    m_fileBytes = 0;
+    m_fileStarted = std::chrono::steady_clock::now();
+    m_accepting = true;
+    m_stopRequested = false;
+
+    m_recording.store(true);
+    m_writerThread = std::thread(&CaptureRecorder::writerLoop, this);
+
+    m_logger->info("CaptureRecorder",
+        QString("Recording started: %1 x %2 byte buffers, %3 I/O")
+        .arg(m_buffers.size()).arg(m_bufferCapacity).arg(m_alignment > 1 ? "direct" : "buffered"));
+    return true;
+}
+
+void CaptureRecorder::stop() {
+    if (!m_recording.load()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_accepting = false;
+        m_stopRequested = true;
+    }
+    m_writerWake.notify_one();
+
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+
+    for (Buffer& buffer : m_buffers) {
+        qFreeAligned(buffer.data);
+    }
+    m_buffers.clear();
+    m_freeBuffers.clear();
+    m_fullBuffers.clear();
+    m_active = nullptr;
+
+    m_recording.store(false);
+
+    m_logger->info("CaptureRecorder",
+        QString("Recording stopped: %1 packets, %2 dropped, %3 files")
+        .arg(m_stats.packetsRecorded.load()).arg(m_stats.packetsDropped.load()).arg(m_stats.filesCompleted.load()));
+}
+
+bool CaptureRecorder::record(const uchar* data, uint32_t size) {
+    // Only whole packets keep the file, and the index built from it, walkable
+    Packet::PacketHeader header;
+    if (!data || size < sizeof(header)) {
+        m_stats.packetsDropped++;
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (!header.isValid() || sizeof(header) + header.payloadSize != size) {
+        m_stats.packetsDropped++;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_accepting) {
+            return false;
+        }
+
+        // Carried bytes of a partial block stay below the alignment
+        if (size > m_bufferCapacity - (m_alignment - 1)) {
+            m_stats.packetsDropped++;
+            return false;
+        }
+
+        const bool rotate = m_config.maxFileSize > 0 && m_fileBytes > 0 &&
+                            m_fileBytes + size > m_config.maxFileSize;
+        if ((rotate || m_active->used + size > m_bufferCapacity) && !swapActive(rotate)) {
+            m_stats.packetsDropped++;
+            return false;
+        }
+
+        std::memcpy(m_active->data + m_active->used, data, size);
+        m_active->used += size;
+        m_fileBytes += size;
+    }
+
+    m_stats.packetsRecorded++;
+    m_stats.bytesRecorded += size;
+    return true;
+}
+
+bool CaptureRecorder::attach(Packet::PacketDispatcher* dispatcher, uint32_t priority) {
+    detach();
+    if (!dispatcher) {
+        return false;
+    }
+
+    Packet::SubscriptionManager::SubscriptionOptions options;
+    options.policy = Packet::SubscriptionManager::DeliveryPolicy::Block;
+    options.mailboxCapacity = m_config.mailboxCapacity;
+    options.critical = true;
+    options.priority = priority;
+
+    m_subscriberId = dispatcher->subscribeBatch("CaptureRecorder", Packet::SubscriptionManager::ALL_PACKETS,
+        [this](Packet::PacketSpan packets) {
+            for (const Packet::PacketPtr& packet : packets) {
+                record(*packet);
+            }
+        }, options);
+    if (m_subscriberId == 0) {
+        return false;
+    }
+
+    m_dispatcher = dispatcher;
+    return true;
+}
+
+void CaptureRecorder::detach() {
+    if (m_dispatcher) {
+        // Record what is still queued in the mailbox; unsubscribing would discard it
+        if (!m_dispatcher->getSubscriptionManager()->flush(m_subscriberId, std::chrono::seconds(5))) {
+            m_logger->warning("CaptureRecorder", "Detached with packets still queued for recording");
+        }
+        m_dispatcher->unsubscribe(m_subscriberId);
+        m_dispatcher = nullptr;
+        m_subscriberId = 0;
+    }
+}
+
+QStringList CaptureRecorder::getCompletedFiles() const {
+    std::lock_guard<std::mutex> lock(m_completedMutex);
+    return m_completedFiles;
+}
+
+bool CaptureRecorder::swapActive(bool rotate) {
+    if (m_freeBuffers.empty()) {
+        return false;
+    }
+
+    Buffer* previous = m_active;
+    Buffer* next = m_freeBuffers.back();
+    m_freeBuffers.pop_back();
+
+    if (rotate) {
+        next->fileSequence = previous->fileSequence + 1;
+        next->fileOffset = 0;
+        next->used = 0;
+        next->carry = 0;
+        m_fileBytes = 0;
+        m_fileStarted = std::chrono::steady_clock::now();
+    } else {
+        // Writes start on aligned offsets, so the partial block at the end of
+        // the previous buffer is written again at the start of this one
+        const qint64 end = previous->fileOffset + static_cast<qint64>(previous->used);
+        const qint64 alignedEnd = end - end % static_cast<qint64>(m_alignment);
+        next->fileSequence = previous->fileSequence;
+        next->fileOffset = alignedEnd;
+        next->carry = static_cast<size_t>(end - alignedEnd);
+        next->used = next->carry;
+        std::memcpy(next->data, previous->data + (previous->used - next->carry), next->carry);
+    }
+
+    m_fullBuffers.push_back(previous);
+    m_active = next;
+    m_writerWake.notify_one();
+    return true;
+}
+
+void CaptureRecorder::writerLoop() {
+    if (!m_config.writerCpus.empty() && !Threading::pinCurrentThread(m_config.writerCpus)) {
+        m_logger->warning("CaptureRecorder", QString("Failed to pin writer thread to CPUs %1")
+            .arg(Threading::CpuTopology::formatCpuList(m_config.writerCpus)));
+    }
+
+    const auto flushInterval = std::chrono::milliseconds(std::max(1, m_config.flushIntervalMs));
+    const auto maxFileAge = std::chrono::milliseconds(m_config.maxFileDurationMs);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        if (m_fullBuffers.empty()) {
+            const bool pending = m_active->used > m_active->carry;
+            if (m_stopRequested) {
+                if (!pending) {
+                    break;
+                }
+                swapActive(false);
+            } else if (m_writerWake.wait_for(lock, flushInterval) == std::cv_status::timeout &&
+                       m_fullBuffers.empty() && m_active->used > m_active->carry) {
+                // Light traffic: write what the active buffer holds so far
+                swapActive(false);
+            }
+        }
+
+        // Size limits are applied as packets arrive, age limits here
+        if (maxFileAge.count() > 0 && m_fileBytes > 0 &&
+            std::chrono::steady_clock::now() - m_fileStarted >= maxFileAge) {
+            swapActive(true);
+        }
+
+        if (m_fullBuffers.empty()) {
+            continue;
+        }
+
+        Buffer* buffer = m_fullBuffers.front();
+        m_fullBuffers.pop_front();
+
+        lock.unlock();
+        writeBuffer(*buffer);
+        lock.lock();
+
+        m_freeBuffers.push_back(buffer);
+    }
+    lock.unlock();
+
+    finishFile();
+}
+
+void CaptureRecorder::writeBuffer(Buffer& buffer) {
+    if (buffer.fileSequence != m_fileSequence) {
+        finishFile();
+        openFile(buffer.fileSequence);
+    }
+    if (!m_file) {
+        m_stats.writeErrors++;
+        return;
+    }
+
+    // Index the packets the buffer adds; the carry was indexed with the previous one
+    m_newEntries.clear();
+    for (size_t offset = buffer.carry; offset < buffer.used; ) {
+        Packet::PacketHeader header;
+        std::memcpy(&header, buffer.data + offset, sizeof(header));
+        const uint32_t size = static_cast<uint32_t>(sizeof(header) + header.payloadSize);
+        m_newEntries.push_back(PacketIndexEntry(buffer.fileOffset + static_cast<qint64>(offset), size,
+                                                header.timestamp, header.id, header.sequence));
+        offset += size;
+    }
+
+    // Whole blocks under direct I/O; the padding lies past the logical end
+    const size_t length = (buffer.used + m_alignment - 1) / m_alignment * m_alignment;
+    std::memset(buffer.data + buffer.used, 0, length - buffer.used);
+
+#ifdef Q_OS_LINUX
+    const qint64 end = buffer.fileOffset + static_cast<qint64>(length);
+    if (m_preallocate && end > m_allocatedBytes) {
+        const qint64 extent = std::max(PREALLOCATION_STEP, end - m_allocatedBytes);
+        if (::fallocate(m_file->handle(), FALLOC_FL_KEEP_SIZE, m_allocatedBytes, extent) == 0) {
+            m_allocatedBytes += extent;
+        } else {
+            // Not supported by this file system
+            m_preallocate = false;
+        }
+    }
+#endif
+
+    const auto writeStart = std::chrono::steady_clock::now();
+    const bool written = m_file->seek(buffer.fileOffset) &&
+        m_file->write(reinterpret_cast<const char*>(buffer.data), static_cast<qint64>(length)) == static_cast<qint64>(length);
+    const auto writeTime = std::chrono::steady_clock::now() - writeStart;
+    m_stats.writeTimeNs += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(writeTime).count());
+    m_stats.writeCalls++;
+
+    if (!written) {
+        m_stats.writeErrors++;
+        m_logger->error("CaptureRecorder",
+            QString("Failed to write %1 bytes to %2: %3").arg(length).arg(m_fileName).arg(m_file->errorString()));
+        return;
+    }
+
+    m_fileEnd = std::max(m_fileEnd, buffer.fileOffset + static_cast<qint64>(buffer.used));
+    m_stats.bytesWritten += buffer.used - buffer.carry;
+
+    if (!m_newEntries.empty()) {
+        m_filePackets += m_newEntries.size();
+        m_indexer->appendEntries(m_fileName, m_newEntries);
+    }
+}
+
+bool CaptureRecorder::openFile(uint64_t sequence) {
+    const QString filename = fileName(sequence);
+    m_fileSequence = sequence;
+
+    auto file = std::make_unique<QFile>(filename);
+    bool opened = false;
+
+#ifdef Q_OS_LINUX
+    if (m_alignment > 1) {
+        const int fd = ::open(QFile::encodeName(filename).constData(),
+                              O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT | O_CLOEXEC, 0644);
+        if (fd >= 0) {
+            opened = file->open(fd, QIODevice::WriteOnly | QIODevice::Unbuffered, QFileDevice::AutoCloseHandle);
+            if (!opened) {
+                ::close(fd);
+            }
+        }
+        if (!opened) {
+            m_logger->warning("CaptureRecorder",
+                QString("Direct I/O unavailable for %1, using buffered writes").arg(filename));
+            // Nothing depends on the alignment until the writer starts
+            if (!m_writerThread.joinable()) {
+                m_alignment = 1;
+            }
+        }
+    }
+#endif
+
+    if (!opened && !file->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        m_logger->error("CaptureRecorder",
+            QString("Failed to create recording %1: %2").arg(filename).arg(file->errorString()));
+        return false;
+    }
+
+    m_file = std::move(file);
+    m_fileName = filename;
+    m_fileEnd = 0;
+    m_allocatedBytes = 0;
+    m_filePackets = 0;
+    m_preallocate = m_config.preallocate;
+
+    m_logger->info("CaptureRecorder", QString("Recording to %1").arg(filename));
+    return true;
+}
+
+void CaptureRecorder::finishFile() {
+    if (!m_file) {
+        return;
+    }
+
+    // Cut the padding of the last aligned write and any preallocated extent
+    if (!m_file->resize(m_fileEnd)) {
+        m_logger->warning("CaptureRecorder",
+            QString("Failed to truncate %1: %2").arg(m_fileName).arg(m_file->errorString()));
+    }
+    m_file->close();
+    m_file.reset();
+
+    // The index cache fingerprints the file, so it is saved once the file is final
+    if (m_config.saveIndex && m_filePackets > 0 &&
+        !m_indexer->saveIndexToCache(FileIndexer::getCacheFilename(m_fileName))) {
+        m_logger->warning("CaptureRecorder", QString("Failed to save index of %1").arg(m_fileName));
+    }
+
+    m_stats.filesCompleted++;
+    {
+        std::lock_guard<std::mutex> lock(m_completedMutex);
+        m_completedFiles.append(m_fileName);
+    }
+
+    m_logger->info("CaptureRecorder",
+        QString("Recording complete: %1 (%2 packets, %3 bytes)").arg(m_fileName).arg(m_filePackets).arg(m_fileEnd));
+
+    if (m_fileCallback) {
+        m_fileCallback(m_fileName, m_filePackets, m_fileEnd);
+    }
+}
+
+QString CaptureRecorder::fileName(uint64_t sequence) const {
+    return QDir(m_config.directory).filePath(QString("%1_%2_%3.dat")
+        .arg(m_config.baseName)
+        .arg(m_startTime.toString("yyyyMMdd_hhmmss_zzz"))
+        .arg(sequence, 4, 10, QChar('0')));
+}
+
+bool CaptureRecorder::fail(const QString& error) {
+    m_error = error;
+    m_logger->error("CaptureRecorder", error);
+    return false;
+}
+
+} // namespace Offline
+} // namespace Monitor
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "../../packet/core/packet.h"
+#include "../../logging/logger.h"
+#include "../../threading/pipeline_topology.h"
+#include "../sources/file_indexer.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Monitor {
+namespace Packet {
+class PacketDispatcher;
+}
+
+namespace Offline {
+
+/**
+ * @brief Records live packets into files that FileSource can replay
+ *
+ * record() copies each packet into the active write buffer under a short
+ * lock and never waits for the disk. When the active buffer fills, it is
+ * queued for the writer thread and an empty one takes its place; if every
+ * other buffer is still queued the packet is dropped and counted instead.
+ * The writer thread writes whole buffers in large blocks, and hands over
+ * the partly filled buffer every flush interval so data reaches the disk
+ * even when traffic is light.
+ *
+ * On Linux the files can be opened with O_DIRECT, in which case every write
+ * covers whole aligned blocks (the partial block at the end of one buffer is
+ * repeated at the start of the next), and extents are preallocated ahead of
+ * the writes. Where the file system refuses O_DIRECT, buffered writes are
+ * used.
+ *
+ * Each file holds whole packets back to back in the native binary format.
+ * The writer builds the file's FileIndexer index from the headers as it
+ * writes and saves it as the index cache when the file is closed, so a
+ * recording opens without a scan. Files are rotated when they reach a size
+ * or age limit.
+ *
+ * record() is thread-safe; start(), stop(), attach() and detach() are not.
+ */
+class CaptureRecorder {
+public:
+    /**
+     * @brief Callback invoked on the writer thread when a file is complete
+     */
+    using FileCallback = std::function<void(const QString& filename, uint64_t packets, qint64 bytes)>;
+
+    /**
+     * @brief Recorder configuration
+     */
+    struct Configuration {
+        QString directory;                          ///< Directory the files are created in
+        QString baseName = "recording";             ///< File name prefix
+        size_t bufferSize = 8 * 1024 * 1024;        ///< Bytes per write buffer
+        size_t bufferCount = 2;                     ///< Write buffers, at least two
+        qint64 maxFileSize = 1024LL * 1024 * 1024;  ///< Rotate before a file grows past this; 0 for no limit
+        int maxFileDurationMs = 0;                  ///< Rotate files older than this; 0 for no limit
+        int flushIntervalMs = 100;                  ///< Longest a packet waits in a buffer
+        bool directIo = false;                      ///< Bypass the page cache (Linux)
+        bool preallocate = true;                    ///< Reserve extents ahead of the writes (Linux)
+        bool saveIndex = true;                      ///< Save an index cache next to each file
+        Threading::CpuSet writerCpus;               ///< CPUs for the writer thread; empty to float
+        int memoryNode = -1;                        ///< NUMA node for the write buffers; -1 for default placement
+        size_t mailboxCapacity = 16384;             ///< Packets queued between router and recorder
+
+        /**
+         * @brief Take writerCpus and memoryNode from @p topology's recorder stage
+         */
+        void applyTopology(const Threading::PipelineTopology& topology,
+                           const Threading::CpuTopology& machine = Threading::CpuTopology::system()) {
+            using Stage = Threading::PipelineTopology::Stage;
+            writerCpus = topology.cpuSetFor(Stage::Recorder, 0, machine);
+            memoryNode = topology.memoryNodeFor(Stage::Recorder, machine);
+        }
+    };
+
+    /**
+     * @brief Recorder statistics
+     */
+    struct Statistics {
+        std::atomic<uint64_t> packetsRecorded{0};   ///< Packets accepted into a buffer
+        std::atomic<uint64_t> bytesRecorded{0};
+        std::atomic<uint64_t> packetsDropped{0};    ///< Buffers full, malformed or oversized packets
+        std::atomic<uint64_t> bytesWritten{0};      ///< Recorded bytes on disk
+        std::atomic<uint64_t> writeCalls{0};
+        std::atomic<uint64_t> writeTimeNs{0};       ///< Time spent in write calls
+        std::atomic<uint64_t> writeErrors{0};
+        std::atomic<uint64_t> filesCompleted{0};
+    };
+
+    explicit CaptureRecorder(const Configuration& config);
+    ~CaptureRecorder();
+
+    CaptureRecorder(const CaptureRecorder&) = delete;
+    CaptureRecorder& operator=(const CaptureRecorder&) = delete;
+
+    /**
+     * @brief Open the first file and start the writer thread
+     */
+    bool start();
+
+    /**
+     * @brief Write everything recorded so far, close the file and stop
+     */
+    void stop();
+
+    bool isRecording() const { return m_recording.load(); }
+
+    /**
+     * @brief Append one framed packet (PacketHeader + payload)
+     * @return False if the packet was dropped
+     */
+    bool record(const uchar* data, uint32_t size);
+
+    bool record(const Packet::Packet& packet) {
+        return record(packet.data(), static_cast<uint32_t>(packet.totalSize()));
+    }
+
+    /**
+     * @brief Record every packet @p dispatcher delivers
+     *
+     * Subscribes to SubscriptionManager::ALL_PACKETS as a critical subscriber
+     * with a blocking mailbox of mailboxCapacity packets: nothing is lost
+     * between router and recorder, and a recorder that falls behind holds the
+     * sources back rather than the router. Packets are copied on the
+     * dispatcher's thread pool, or on the router's worker threads without one.
+     */
+    bool attach(Packet::PacketDispatcher* dispatcher, uint32_t priority = 0);
+
+    /**
+     * @brief Stop recording the attached dispatcher's packets
+     */
+    void detach();
+
+    void setFileCallback(FileCallback callback) { m_fileCallback = std::move(callback); }
+
+    /**
+     * @brief True if the files are written with O_DIRECT
+     */
+    bool isDirectIo() const { return m_alignment > 1; }
+
+    /**
+     * @brief Files completed so far, oldest first
+     */
+    QStringList getCompletedFiles() const;
+
+    const Statistics& getStatistics() const { return m_stats; }
+
+    const QString& errorString() const { return m_error; }
+
+    static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+    static constexpr size_t MIN_BUFFER_SIZE = 128 * 1024;   ///< Holds the largest valid packet
+
+private:
+    /**
+     * @brief Write buffer and the file range it covers
+     */
+    struct Buffer {
+        uchar* data = nullptr;
+        size_t used = 0;                ///< Bytes filled, including the carry
+        size_t carry = 0;               ///< Bytes repeated from the previous buffer to keep writes aligned
+        qint64 fileOffset = 0;          ///< Where data[0] lands in the file
+        uint64_t fileSequence = 0;      ///< File the buffer belongs to
+    };
+
+    /**
+     * @brief Queue the active buffer and activate a free one
+     *
+     * Caller must hold m_mutex.
+     *
+     * @param rotate Start the next file with the new buffer
+     * @return False if no buffer is free
+     */
+    bool swapActive(bool rotate);
+
+    void writerLoop();
+    void writeBuffer(Buffer& buffer);
+    bool openFile(uint64_t sequence);
+    void finishFile();
+    QString fileName(uint64_t sequence) const;
+
+    bool fail(const QString& error);
+
+    Configuration m_config;
+    Logging::Logger* m_logger;
+    QString m_error;
+    QDateTime m_startTime;
+    size_t m_alignment;
+    size_t m_bufferCapacity;
+
+    // Buffers; everything below is guarded by m_mutex
+    std::vector<Buffer> m_buffers;
+    std::mutex m_mutex;
+    std::condition_variable m_writerWake;
+    Buffer* m_active;
+    std::vector<Buffer*> m_freeBuffers;
+    std::deque<Buffer*> m_fullBuffers;
+    qint64 m_fileBytes;                 ///< Bytes recorded into the newest file
+    std::chrono::steady_clock::time_point m_fileStarted;
+    bool m_accepting;
+    bool m_stopRequested;
+
+    // Writer thread state
+    std::thread m_writerThread;
+    std::atomic<bool> m_recording;
+    std::unique_ptr<QFile> m_file;
+    QString m_fileName;
+    uint64_t m_fileSequence;
+    qint64 m_fileEnd;                   ///< Logical end of the file; writes may run past it
+    qint64 m_allocatedBytes;            ///< Extent reserved by preallocation
+    uint64_t m_filePackets;
+    bool m_preallocate;
+    std::unique_ptr<FileIndexer> m_indexer;     ///< Index of the current file
+    std::vector<PacketIndexEntry> m_newEntries;
+    FileCallback m_fileCallback;
+
+    mutable std::mutex m_completedMutex;
+    QStringList m_completedFiles;
+
+    // Dispatcher attachment
+    Packet::PacketDispatcher* m_dispatcher;
+    uint64_t m_subscriberId;
+
+    Statistics m_stats;
+
+    static constexpr qint64 PREALLOCATION_STEP = 64 * 1024 * 1024;
+};
+
+} // namespace Offline
+} // namespace Monitor
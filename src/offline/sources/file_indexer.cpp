@@ -1,23 +1,164 @@
 #include "file_indexer.h"
+#include "pcap_reader.h"
 #include "../../packet/core/packet_header.h"
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
+#include <QSaveFile>
 #include <QStandardPaths>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
 #include <QCryptographicHash>
 #include <QElapsedTimer>
 #include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
 
 namespace Monitor {
 namespace Offline {
 
+namespace {
+
+/**
+ * @brief Fixed-size header at the start of a binary index cache
+ * 
+ * Followed by the UTF-8 data filename, padding to 8 bytes and one array per
+ * PacketIndexEntry field at the recorded column offsets, then the secondary
+ * indexes: the skip-index blocks, the packet IDs with posting lists, where
+ * each ID's list starts in the concatenated postings, and the postings.
+ * Every array starts on an 8-byte boundary. Written in native byte order; a
+ * cache from a machine of the other endianness fails the magic check and is
+ * rebuilt. The header byte order the data file was indexed with is kept in
+ * the header, so Native reads as 0 in caches written before it was.
+ */
+struct IndexCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t entryCount;
+    int64_t fileSize;
+    int64_t modifiedMs;
+    uint64_t headHash;
+    uint64_t tailHash;
+    int64_t indexedBytes;
+    uint64_t errorPackets;
+    uint32_t filenameBytes;
+    uint32_t headerByteOrder;   ///< Parser::Layout::ByteOrder of the indexed packet headers
+    uint64_t positionOffset;    ///< int64_t[entryCount]
+    uint64_t timestampOffset;   ///< uint64_t[entryCount]
+    uint64_t sizeOffset;        ///< uint32_t[entryCount]
+    uint64_t idOffset;          ///< uint32_t[entryCount]
+    uint64_t sequenceOffset;    ///< uint32_t[entryCount]
+    uint64_t blockCount;
+    uint64_t postingIdCount;
+    uint64_t blockOffset;           ///< PacketSecondaryIndex::Block[blockCount]
+    uint64_t postingIdOffset;       ///< uint32_t[postingIdCount]
+    uint64_t postingStartOffset;    ///< uint64_t[postingIdCount + 1]
+    uint64_t postingOffset;         ///< uint32_t[entryCount]
+    uint64_t totalSize;
+};
+
+static_assert(std::is_trivially_copyable<IndexCacheHeader>::value, "Cache header is written as raw bytes");
+
+constexpr uint32_t INDEX_CACHE_MAGIC = 0x5844494D;     // "MIDX"
+constexpr uint32_t INDEX_CACHE_VERSION = 3;             // 1 was the sampled JSON cache, 2 had no secondary indexes
+constexpr size_t COLUMN_CHUNK_ENTRIES = 65536;
+
+uint64_t hashBlock(const QByteArray& data) {
+    // FNV-1a: not cryptographic, only needs to notice a changed file
+    uint64_t hash = 14695981039346656037ULL;
+    for (char byte : data) {
+        hash ^= static_cast<uint8_t>(byte);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t alignColumn(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+/**
+ * @brief Fill in the array offsets and total size implied by the counts
+ */
+void layoutCache(IndexCacheHeader& header) {
+    const uint64_t count = header.entryCount;
+    header.positionOffset = alignColumn(sizeof(header) + header.filenameBytes);
+    header.timestampOffset = header.positionOffset + count * sizeof(int64_t);
+    header.sizeOffset = header.timestampOffset + count * sizeof(uint64_t);
+    header.idOffset = header.sizeOffset + count * sizeof(uint32_t);
+    header.sequenceOffset = header.idOffset + count * sizeof(uint32_t);
+    header.blockOffset = alignColumn(header.sequenceOffset + count * sizeof(uint32_t));
+    header.postingIdOffset = header.blockOffset + header.blockCount * sizeof(PacketSecondaryIndex::Block);
+    header.postingStartOffset = alignColumn(header.postingIdOffset + header.postingIdCount * sizeof(uint32_t));
+    header.postingOffset = header.postingStartOffset + (header.postingIdCount + 1) * sizeof(uint64_t);
+    header.totalSize = header.postingOffset + count * sizeof(uint32_t);
+}
+
+bool writePadding(QIODevice& out, uint64_t offset) {
+    const qint64 bytes = static_cast<qint64>(offset) - out.pos();
+    return bytes >= 0 && out.write(QByteArray(static_cast<int>(bytes), '\0')) == bytes;
+}
+
+template<typename T>
+bool writeArray(QIODevice& out, const std::vector<T>& values) {
+    const qint64 bytes = static_cast<qint64>(values.size() * sizeof(T));
+    return values.empty() || out.write(reinterpret_cast<const char*>(values.data()), bytes) == bytes;
+}
+
+template<typename T, typename Field>
+bool writeColumn(QIODevice& out, const std::vector<PacketIndexEntry>& index, Field field) {
+    std::vector<T> chunk;
+    chunk.reserve(std::min(index.size(), COLUMN_CHUNK_ENTRIES));
+    
+    for (size_t start = 0; start < index.size(); start += COLUMN_CHUNK_ENTRIES) {
+        const size_t end = std::min(index.size(), start + COLUMN_CHUNK_ENTRIES);
+        chunk.clear();
+        for (size_t i = start; i < end; ++i) {
+            chunk.push_back(static_cast<T>(field(index[i])));
+        }
+        
+        const qint64 bytes = static_cast<qint64>(chunk.size() * sizeof(T));
+        if (out.write(reinterpret_cast<const char*>(chunk.data()), bytes) != bytes) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+T readColumnValue(const uchar* base, uint64_t columnOffset, size_t i) {
+    T value;
+    std::memcpy(&value, base + columnOffset + i * sizeof(T), sizeof(T));
+    return value;
+}
+
+bool readCacheHeader(QFile& cacheFile, IndexCacheHeader& header) {
+    if (cacheFile.read(reinterpret_cast<char*>(&header), sizeof(header)) != static_cast<qint64>(sizeof(header))) {
+        return false;
+    }
+    return header.magic == INDEX_CACHE_MAGIC && header.version == INDEX_CACHE_VERSION;
+}
+
+FileFingerprint fingerprintFromHeader(const IndexCacheHeader& header) {
+    FileFingerprint fingerprint;
+    fingerprint.fileSize = header.fileSize;
+    fingerprint.modifiedMs = header.modifiedMs;
+    fingerprint.headHash = header.headHash;
+    fingerprint.tailHash = header.tailHash;
+    return fingerprint;
+}
+
+} // namespace
+
 FileIndexer::FileIndexer(QObject* parent)
     : QThread(parent)
     , m_status(IndexStatus::NotStarted)
     , m_cancelRequested(false)
+    , m_indexedBytes(0)
+    , m_resumePosition(0)
+    , m_threadPool(nullptr)
+    , m_chunkSize(DEFAULT_CHUNK_SIZE)
+    , m_headerByteOrder(Parser::Layout::ByteOrder::Native)
+    , m_bytesScanned(0)
     , m_lastProgressPercentage(-1)
     , m_logger(Logging::Logger::instance())
 {
@@ -46,20 +187,31 @@ bool FileIndexer::startIndexing(const QString& filename, bool background) {
         return false;
     }
     
+    // An index of the same file is extended rather than rebuilt if the file
+    // has only grown since it was built. Captures cannot resume mid-stream.
+    const bool resume = filename == m_filename && !m_index.empty() && m_indexedBytes > 0 &&
+                        matchFingerprint(filename, m_fingerprint) != FingerprintMatch::Stale &&
+                        !PcapReader::isCaptureFile(filename);
+    const uint64_t previousErrors = resume ? m_statistics.errorPackets : 0;
+    
     m_filename = filename;
     m_cancelRequested = false;
-    clearIndex();
+    if (!resume) {
+        clearIndex();
+    }
+    m_resumePosition = resume ? m_indexedBytes : 0;
     
     // Initialize statistics
     QFileInfo fileInfo(filename);
     m_statistics = IndexStatistics();
     m_statistics.filename = filename;
     m_statistics.fileSize = fileInfo.size();
+    m_statistics.errorPackets = previousErrors;
     m_statistics.indexStartTime = QDateTime::currentDateTime();
     
     m_logger->info("FileIndexer", 
-        QString("Starting indexing of file: %1 (%2 bytes)")
-        .arg(filename).arg(m_statistics.fileSize));
+        QString("Starting indexing of file: %1 (%2 bytes, resuming at %3)")
+        .arg(filename).arg(m_statistics.fileSize).arg(m_resumePosition));
     
     setStatus(IndexStatus::InProgress);
     emit indexingStarted(filename);
@@ -85,6 +237,23 @@ bool FileIndexer::startIndexing(const QString& filename, bool background) {
     }
 }
 
+void FileIndexer::setChunkSize(qint64 bytes) {
+    m_chunkSize = std::max(bytes, MIN_CHUNK_SIZE);
+}
+
+void FileIndexer::setHeaderByteOrder(Parser::Layout::ByteOrder order) {
+    if (order == m_headerByteOrder) {
+        return;
+    }
+    if (m_status == IndexStatus::InProgress) {
+        m_logger->warning("FileIndexer", "Cannot change the header byte order while indexing");
+        return;
+    }
+    
+    m_headerByteOrder = order;
+    clearIndex();
+}
+
 void FileIndexer::cancelIndexing() {
     if (m_status == IndexStatus::InProgress) {
         m_logger->info("FileIndexer", "Cancelling indexing operation");
@@ -129,56 +298,80 @@ bool FileIndexer::performIndexing() {
     }
     
     qint64 fileSize = file.size();
-    qint64 position = 0;
-    uint64_t packetCount = 0;
-    uint64_t errorCount = 0;
+    qint64 position = std::min(m_resumePosition, fileSize);
+    uint64_t packetCount = m_index.size();
+    uint64_t errorCount = m_statistics.errorPackets;
     
     QElapsedTimer timer;
     timer.start();
     
     m_logger->info("FileIndexer", 
-        QString("Indexing file: %1 bytes").arg(fileSize));
+        QString("Indexing file: %1 bytes from offset %2").arg(fileSize).arg(position));
     
     // Reserve space for index (estimate)
-    uint64_t estimatedPackets = fileSize / 100; // Rough estimate
-    m_index.reserve(estimatedPackets);
+    uint64_t estimatedPackets = (fileSize - position) / 100; // Rough estimate
+    {
+        QMutexLocker locker(&m_indexMutex);
+        m_index.reserve(m_index.size() + estimatedPackets);
+    }
     
-    while (position < fileSize && !m_cancelRequested) {
-        PacketIndexEntry entry;
-        
-        if (readPacketAtPosition(file, position, entry)) {
-            // Add valid packet to index
-            {
-                QMutexLocker locker(&m_indexMutex);
-                m_index.push_back(entry);
-            }
-            
-            // Move to next packet
-            position += entry.packetSize;
-            packetCount++;
+    // Scanning the mapping avoids a seek and read per packet; files that
+    // cannot be mapped fall back to reading headers one at a time
+    uchar* data = fileSize > position ? file.map(0, fileSize) : nullptr;
+    const bool capture = PcapReader::isCaptureFile(m_filename);
+    if (capture && !data) {
+        m_logger->error("FileIndexer", QString("Failed to map capture: %1").arg(file.errorString()));
+        return false;
+    }
+    
+    if (capture) {
+        const bool success = performCaptureIndexing(data, fileSize, packetCount, errorCount);
+        file.unmap(data);
+        if (!success) {
+            return false;
+        }
+    } else if (data) {
+        performChunkedIndexing(data, fileSize, position, packetCount, errorCount);
+        file.unmap(data);
+    } else {
+        while (position < fileSize && !m_cancelRequested) {
+            PacketIndexEntry entry;
             
-            // Update statistics periodically
-            if (packetCount % BATCH_SIZE == 0) {
-                m_statistics.indexedPackets = packetCount;
-                m_statistics.validPackets = packetCount;
-                m_statistics.errorPackets = errorCount;
+            if (readPacketAtPosition(file, position, entry)) {
+                // Add valid packet to index
+                {
+                    QMutexLocker locker(&m_indexMutex);
+                    m_index.push_back(entry);
+                    extendSecondaryIndex();
+                }
                 
-                updateProgress(position, fileSize);
-                emit statisticsUpdated(m_statistics);
-            }
-            
-        } else {
-            // Invalid packet - try to find next valid packet
-            errorCount++;
-            
-            // Skip ahead and look for next packet
-            position = findNextValidPacket(file, position + 1, fileSize);
-            if (position == -1) {
-                break; // No more valid packets found
+                // Move to next packet
+                position += entry.packetSize;
+                packetCount++;
+                
+                // Update statistics periodically
+                if (packetCount % BATCH_SIZE == 0) {
+                    m_statistics.indexedPackets = packetCount;
+                    m_statistics.validPackets = packetCount;
+                    m_statistics.errorPackets = errorCount;
+                    
+                    updateProgress(position, fileSize);
+                    emit statisticsUpdated(m_statistics);
+                }
+                
+            } else {
+                // Invalid packet - try to find next valid packet
+                errorCount++;
+                
+                // Skip ahead and look for next packet
+                position = findNextValidPacket(file, position + 1, fileSize);
+                if (position == -1) {
+                    break; // No more valid packets found
+                }
             }
         }
     }
-    
+        
     // Final statistics update
     m_statistics.indexedPackets = packetCount;
     m_statistics.validPackets = packetCount;
@@ -193,6 +386,15 @@ bool FileIndexer::performIndexing() {
         return false;
     }
     
+    // Remember where this run ended so appended data can be indexed later
+    {
+        QMutexLocker locker(&m_indexMutex);
+        m_indexedBytes = m_index.empty() ? 0 : m_index.back().filePosition + m_index.back().packetSize;
+    }
+    if (!computeFingerprint(m_filename, fileSize, m_fingerprint)) {
+        m_fingerprint = FileFingerprint();
+    }
+    
     m_logger->info("FileIndexer", 
         QString("Indexing completed: %1 packets, %2 errors, %3ms")
         .arg(packetCount).arg(errorCount).arg(m_statistics.indexingTimeMs));
@@ -209,21 +411,19 @@ bool FileIndexer::readPacketAtPosition(QFile& file, qint64 position, PacketIndex
     }
     
     // Read packet header
-    QByteArray headerData = file.read(sizeof(Packet::PacketHeader));
-    if (headerData.size() != sizeof(Packet::PacketHeader)) {
+    Packet::PacketHeader header;
+    if (file.read(reinterpret_cast<char*>(&header), sizeof(header)) != static_cast<qint64>(sizeof(header))) {
         return false;
     }
+    header.convertToHostOrder(m_headerByteOrder);
     
     // Validate header
-    if (!validatePacketHeader(headerData)) {
+    if (!validatePacketHeader(header)) {
         return false;
     }
     
-    const Packet::PacketHeader* header = 
-        reinterpret_cast<const Packet::PacketHeader*>(headerData.constData());
-    
     // Calculate total packet size (header + payload)
-    uint32_t totalSize = sizeof(Packet::PacketHeader) + header->payloadSize;
+    uint32_t totalSize = sizeof(Packet::PacketHeader) + header.payloadSize;
     
     // Check if complete packet is available
     if (position + totalSize > file.size()) {
@@ -233,23 +433,16 @@ bool FileIndexer::readPacketAtPosition(QFile& file, qint64 position, PacketIndex
     // Fill index entry
     entry.filePosition = position;
     entry.packetSize = totalSize;
-    entry.timestamp = header->timestamp;
-    entry.packetId = header->id;
-    entry.sequenceNumber = header->sequence;
+    entry.timestamp = header.timestamp;
+    entry.packetId = header.id;
+    entry.sequenceNumber = header.sequence;
     
     return true;
 }
 
-bool FileIndexer::validatePacketHeader(const QByteArray& headerData) const {
-    if (headerData.size() != sizeof(Packet::PacketHeader)) {
-        return false;
-    }
-    
-    const Packet::PacketHeader* header = 
-        reinterpret_cast<const Packet::PacketHeader*>(headerData.constData());
-    
+bool FileIndexer::validatePacketHeader(const Packet::PacketHeader& header) const {
     // Calculate total packet size
-    uint32_t totalSize = sizeof(Packet::PacketHeader) + header->payloadSize;
+    uint32_t totalSize = sizeof(Packet::PacketHeader) + header.payloadSize;
     
     // Validate size
     if (totalSize < MIN_PACKET_SIZE || totalSize > MAX_PACKET_SIZE) {
@@ -257,7 +450,7 @@ bool FileIndexer::validatePacketHeader(const QByteArray& headerData) const {
     }
     
     // Use the isValid() method from PacketHeader
-    return header->isValid();
+    return header.isValid();
 }
 
 qint64 FileIndexer::findNextValidPacket(QFile& file, qint64 startPosition, qint64 fileSize) {
@@ -275,15 +468,11 @@ qint64 FileIndexer::findNextValidPacket(QFile& file, qint64 startPosition, qint6
         
         // Look for valid packet headers
         for (size_t i = 0; i <= buffer.size() - sizeof(Packet::PacketHeader); ++i) {
-            const Packet::PacketHeader* header = 
-                reinterpret_cast<const Packet::PacketHeader*>(buffer.constData() + i);
+            Packet::PacketHeader header;
+            std::memcpy(&header, buffer.constData() + i, sizeof(header));
+            header.convertToHostOrder(m_headerByteOrder);
             
-            // Calculate total packet size
-            uint32_t totalSize = sizeof(Packet::PacketHeader) + header->payloadSize;
-            
-            if (totalSize >= MIN_PACKET_SIZE &&
-                totalSize <= MAX_PACKET_SIZE &&
-                header->isValid()) {
+            if (validatePacketHeader(header)) {
                 
                 qint64 candidatePos = pos + i;
                 
@@ -299,6 +488,277 @@ qint64 FileIndexer::findNextValidPacket(QFile& file, qint64 startPosition, qint6
     return -1; // No valid packet found
 }
 
+bool FileIndexer::performChunkedIndexing(const uchar* data, qint64 fileSize, qint64 start,
+                                         uint64_t& packetCount, uint64_t& errorCount) {
+    const qint64 chunkSize = m_chunkSize;
+    const size_t chunkCount = static_cast<size_t>((fileSize - start + chunkSize - 1) / chunkSize);
+    
+    std::vector<IndexChunk> chunks(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        chunks[i].begin = start + static_cast<qint64>(i) * chunkSize;
+        chunks[i].end = std::min(fileSize, chunks[i].begin + chunkSize);
+    }
+    
+    Threading::ThreadPool* pool = m_threadPool;
+    const bool parallel = pool && pool->isRunning() && !pool->isPaused() && chunkCount > 1;
+    const size_t window = parallel ? std::max<size_t>(1, pool->getNumThreads() * CHUNKS_IN_FLIGHT_PER_THREAD) : 1;
+    
+    m_logger->info("FileIndexer", 
+        QString("Scanning %1 chunks of %2 bytes on %3 threads")
+        .arg(chunkCount).arg(chunkSize).arg(parallel ? pool->getNumThreads() : 1));
+    
+    // Only a bounded window of chunks is queued ahead of the one being
+    // stitched, so finished chunks do not pile up in memory
+    std::vector<std::future<void>> pending(chunkCount);
+    size_t submitted = 0;
+    auto submitUpTo = [&](size_t limit) {
+        for (; submitted < std::min(limit, chunkCount); ++submitted) {
+            IndexChunk* chunk = &chunks[submitted];
+            const bool synced = submitted == 0;
+            pending[submitted] = pool->submitTask([this, data, fileSize, chunk, synced]() {
+                scanChunk(data, fileSize, *chunk, synced);
+            });
+        }
+    };
+    
+    m_bytesScanned.store(0);
+    StitchCursor cursor{start, false};
+    
+    for (size_t i = 0; i < chunkCount && !m_cancelRequested; ++i) {
+        IndexChunk& chunk = chunks[i];
+        
+        if (parallel) {
+            submitUpTo(i + window);
+            while (pending[i].wait_for(std::chrono::milliseconds(PROGRESS_UPDATE_INTERVAL)) != std::future_status::ready) {
+                updateProgress(start + m_bytesScanned.load(), fileSize);
+            }
+            try {
+                pending[i].get();
+            } catch (const std::exception& e) {
+                // Rejected by a saturated or stopping pool: scan it here instead
+                m_logger->warning("FileIndexer", 
+                    QString("Chunk %1 not scanned on thread pool (%2), scanning inline").arg(i).arg(e.what()));
+                chunk.entries.clear();
+                chunk.errorPositions.clear();
+                scanChunk(data, fileSize, chunk, i == 0);
+            }
+        } else {
+            scanChunk(data, fileSize, chunk, i == 0);
+        }
+        
+        if (m_cancelRequested) {
+            break;
+        }
+        
+        stitchChunk(data, fileSize, chunk, cursor, errorCount);
+        std::vector<PacketIndexEntry>().swap(chunk.entries);
+        std::vector<qint64>().swap(chunk.errorPositions);
+        
+        packetCount = getPacketCount();
+        m_statistics.indexedPackets = packetCount;
+        m_statistics.validPackets = packetCount;
+        m_statistics.errorPackets = errorCount;
+        
+        updateProgress(start + m_bytesScanned.load(), fileSize);
+        emit statisticsUpdated(m_statistics);
+    }
+    
+    // Scans still queued reference the mapping, which the caller unmaps next
+    for (auto& future : pending) {
+        if (future.valid()) {
+            future.wait();
+        }
+    }
+    
+    return !m_cancelRequested;
+}
+
+bool FileIndexer::performCaptureIndexing(const uchar* data, qint64 fileSize,
+                                         uint64_t& packetCount, uint64_t& errorCount) {
+    PcapReader::Configuration readerConfig;
+    readerConfig.headerByteOrder = m_headerByteOrder;
+    PcapReader reader(data, fileSize, readerConfig);
+    if (!reader.isValid()) {
+        m_logger->error("FileIndexer", QString("Failed to read capture: %1").arg(reader.errorString()));
+        return false;
+    }
+    
+    std::vector<PacketIndexEntry> batch;
+    batch.reserve(BATCH_SIZE);
+    
+    auto flush = [&]() {
+        QMutexLocker locker(&m_indexMutex);
+        m_index.insert(m_index.end(), batch.begin(), batch.end());
+        extendSecondaryIndex();
+        batch.clear();
+    };
+    
+    CapturedPacket packet;
+    while (!m_cancelRequested && reader.readNext(packet)) {
+        Packet::PacketHeader header;
+        std::memcpy(&header, packet.data, sizeof(header));
+        header.convertToHostOrder(m_headerByteOrder);
+        
+        const qint64 position = packet.position >= 0 ? packet.position : packet.recordPosition;
+        batch.push_back(PacketIndexEntry(position, packet.size, packet.timestampNs, header.id, header.sequence));
+        packetCount++;
+        
+        if (batch.size() == static_cast<size_t>(BATCH_SIZE)) {
+            flush();
+            
+            m_statistics.indexedPackets = packetCount;
+            m_statistics.validPackets = packetCount;
+            m_statistics.errorPackets = errorCount + reader.getStatistics().framingErrors;
+            
+            updateProgress(reader.position(), fileSize);
+            emit statisticsUpdated(m_statistics);
+        }
+    }
+    flush();
+    
+    if (!reader.errorString().isEmpty()) {
+        m_logger->warning("FileIndexer", reader.errorString());
+    }
+    
+    const auto& stats = reader.getStatistics();
+    errorCount += stats.framingErrors;
+    m_logger->info("FileIndexer", 
+        QString("Capture read: %1 records, %2 reassembled packets, %3 records skipped, %4 TCP gaps")
+        .arg(stats.records).arg(stats.reassembledPackets).arg(stats.skippedRecords).arg(stats.tcpGaps));
+    
+    return true;
+}
+
+void FileIndexer::scanChunk(const uchar* data, qint64 fileSize, IndexChunk& chunk, bool synced) {
+    qint64 position = synced ? chunk.begin : findNextMappedPacket(data, fileSize, chunk.begin, chunk.end);
+    qint64 reported = chunk.begin;
+    
+    chunk.entries.reserve(static_cast<size_t>((chunk.end - chunk.begin) / 100)); // Rough estimate
+    
+    while (position >= 0 && position < chunk.end) {
+        PacketIndexEntry entry;
+        if (readMappedPacket(data, fileSize, position, m_headerByteOrder, entry)) {
+            chunk.entries.push_back(entry);
+            position += entry.packetSize;
+        } else {
+            chunk.errorPositions.push_back(position);
+            position = findNextMappedPacket(data, fileSize, position + 1, chunk.end);
+        }
+        
+        if (position - reported >= SCAN_PROGRESS_STEP) {
+            if (m_cancelRequested.load(std::memory_order_relaxed)) {
+                return;
+            }
+            const qint64 scanned = std::min(position, chunk.end);
+            m_bytesScanned.fetch_add(scanned - reported, std::memory_order_relaxed);
+            reported = scanned;
+        }
+    }
+    
+    chunk.nextPosition = position;
+    m_bytesScanned.fetch_add(chunk.end - reported, std::memory_order_relaxed);
+}
+
+void FileIndexer::stitchChunk(const uchar* data, qint64 fileSize, IndexChunk& chunk,
+                              StitchCursor& cursor, uint64_t& errorCount) {
+    const auto& entries = chunk.entries;
+    std::vector<PacketIndexEntry> bridge;
+    size_t join = 0;
+    bool adopt = cursor.resync;
+    
+    // If the previous chunk ended mid-resynchronisation, the next valid packet
+    // is exactly where this chunk synchronised. Otherwise follow the packet
+    // chain from the previous chunk until it lands on this chunk's chain,
+    // which it normally does at the first entry.
+    if (!cursor.resync) {
+        qint64 position = cursor.position;
+        while (position >= 0 && position < chunk.end) {
+            auto it = std::lower_bound(entries.begin(), entries.end(), position,
+                [](const PacketIndexEntry& entry, qint64 pos) { return entry.filePosition < pos; });
+            if (it != entries.end() && it->filePosition == position) {
+                join = static_cast<size_t>(it - entries.begin());
+                adopt = true;
+                break;
+            }
+            
+            PacketIndexEntry entry;
+            if (readMappedPacket(data, fileSize, position, m_headerByteOrder, entry)) {
+                bridge.push_back(entry);
+                position += entry.packetSize;
+            } else {
+                errorCount++;
+                position = findNextMappedPacket(data, fileSize, position + 1, chunk.end);
+            }
+        }
+        
+        if (!adopt) {
+            // The chain skipped over every packet this chunk found
+            cursor = position >= 0 ? StitchCursor{position, false} : StitchCursor{chunk.end, true};
+        }
+    }
+    
+    if (adopt) {
+        const qint64 joinPosition = join < entries.size() ? entries[join].filePosition : chunk.begin;
+        errorCount += static_cast<uint64_t>(std::count_if(chunk.errorPositions.begin(), chunk.errorPositions.end(),
+            [joinPosition](qint64 errorPosition) { return errorPosition >= joinPosition; }));
+        cursor = chunk.nextPosition >= 0 ? StitchCursor{chunk.nextPosition, false} : StitchCursor{chunk.end, true};
+    }
+    
+    QMutexLocker locker(&m_indexMutex);
+    m_index.insert(m_index.end(), bridge.begin(), bridge.end());
+    if (adopt) {
+        m_index.insert(m_index.end(), entries.begin() + static_cast<std::ptrdiff_t>(join), entries.end());
+    }
+    extendSecondaryIndex();
+}
+
+void FileIndexer::extendSecondaryIndex() {
+    for (size_t i = static_cast<size_t>(m_secondaryIndex.size()); i < m_index.size(); ++i) {
+        m_secondaryIndex.append(m_index[i].packetId, m_index[i].timestamp, m_index[i].sequenceNumber);
+    }
+}
+
+bool FileIndexer::readMappedPacket(const uchar* data, qint64 fileSize, qint64 position,
+                                   Parser::Layout::ByteOrder headerByteOrder, PacketIndexEntry& entry) {
+    if (position < 0 || position + static_cast<qint64>(sizeof(Packet::PacketHeader)) > fileSize) {
+        return false;
+    }
+    
+    Packet::PacketHeader header;
+    std::memcpy(&header, data + position, sizeof(header));
+    header.convertToHostOrder(headerByteOrder);
+    
+    // Same checks as validatePacketHeader() and readPacketAtPosition()
+    const uint32_t totalSize = sizeof(Packet::PacketHeader) + header.payloadSize;
+    if (totalSize < MIN_PACKET_SIZE || totalSize > MAX_PACKET_SIZE || !header.isValid() ||
+        position + totalSize > fileSize) {
+        return false;
+    }
+    
+    entry.filePosition = position;
+    entry.packetSize = totalSize;
+    entry.timestamp = header.timestamp;
+    entry.packetId = header.id;
+    entry.sequenceNumber = header.sequence;
+    return true;
+}
+
+qint64 FileIndexer::findNextMappedPacket(const uchar* data, qint64 fileSize, qint64 startPosition, qint64 limit) const {
+    const qint64 last = std::min(limit, fileSize - static_cast<qint64>(sizeof(Packet::PacketHeader)) + 1);
+    PacketIndexEntry entry;
+    
+    for (qint64 pos = startPosition; pos < last; ++pos) {
+        if ((pos & 0xFFFF) == 0 && m_cancelRequested.load(std::memory_order_relaxed)) {
+            return -1;
+        }
+        if (readMappedPacket(data, fileSize, pos, m_headerByteOrder, entry)) {
+            return pos;
+        }
+    }
+    
+    return -1; // No valid packet found
+}
+
 int FileIndexer::findPacketByPosition(qint64 position) const {
     QMutexLocker locker(&m_indexMutex);
     
@@ -317,16 +777,8 @@ int FileIndexer::findPacketByPosition(qint64 position) const {
 int FileIndexer::findPacketByTimestamp(uint64_t timestamp) const {
     QMutexLocker locker(&m_indexMutex);
     
-    auto it = std::lower_bound(m_index.begin(), m_index.end(), timestamp,
-        [](const PacketIndexEntry& entry, uint64_t ts) {
-            return entry.timestamp < ts;
-        });
-    
-    if (it != m_index.end()) {
-        return std::distance(m_index.begin(), it);
-    }
-    
-    return -1;
+    return static_cast<int>(m_secondaryIndex.findFirstAtOrAfter(timestamp,
+        [this](uint64_t i) { return m_index[i].timestamp; }));
 }
 
 std::vector<int> FileIndexer::findPacketsByPacketId(uint32_t packetId) const {
@@ -334,10 +786,8 @@ std::vector<int> FileIndexer::findPacketsByPacketId(uint32_t packetId) const {
     
     std::vector<int> indices;
     
-    for (size_t i = 0; i < m_index.size(); ++i) {
-        if (m_index[i].packetId == packetId) {
-            indices.push_back(static_cast<int>(i));
-        }
+    if (const auto* postings = m_secondaryIndex.postingList(packetId)) {
+        indices.assign(postings->begin(), postings->end());
     }
     
     return indices;
@@ -346,16 +796,16 @@ std::vector<int> FileIndexer::findPacketsByPacketId(uint32_t packetId) const {
 int FileIndexer::findPacketBySequence(uint32_t sequenceNumber) const {
     QMutexLocker locker(&m_indexMutex);
     
-    auto it = std::find_if(m_index.begin(), m_index.end(),
-        [sequenceNumber](const PacketIndexEntry& entry) {
-            return entry.sequenceNumber == sequenceNumber;
-        });
-    
-    if (it != m_index.end()) {
-        return std::distance(m_index.begin(), it);
-    }
+    return static_cast<int>(m_secondaryIndex.findSequence(sequenceNumber,
+        [this](uint64_t i) { return m_index[i].sequenceNumber; }));
+}
+
+std::vector<uint32_t> FileIndexer::selectPackets(const std::vector<uint32_t>& packetIds,
+                                                 uint64_t startTimestamp, uint64_t endTimestamp) const {
+    QMutexLocker locker(&m_indexMutex);
     
-    return -1;
+    return m_secondaryIndex.select(packetIds, startTimestamp, endTimestamp,
+        [this](uint64_t i) { return m_index[i].timestamp; });
 }
 
 const PacketIndexEntry* FileIndexer::getPacketEntry(int index) const {
@@ -368,61 +818,116 @@ const PacketIndexEntry* FileIndexer::getPacketEntry(int index) const {
     return nullptr;
 }
 
+void FileIndexer::appendEntries(const QString& filename, const std::vector<PacketIndexEntry>& entries) {
+    if (filename != m_filename || m_statistics.filename != filename) {
+        clearIndex();
+        m_filename = filename;
+        m_statistics = IndexStatistics();
+        m_statistics.filename = filename;
+        m_statistics.indexStartTime = QDateTime::currentDateTime();
+    }
+    
+    {
+        QMutexLocker locker(&m_indexMutex);
+        m_index.insert(m_index.end(), entries.begin(), entries.end());
+        extendSecondaryIndex();
+        if (!m_index.empty()) {
+            m_indexedBytes = m_index.back().filePosition + m_index.back().packetSize;
+        }
+        m_fingerprint = FileFingerprint();
+    }
+    
+    m_statistics.fileSize = m_indexedBytes;
+    m_statistics.indexedPackets = m_index.size();
+    m_statistics.validPackets = m_index.size();
+    m_statistics.totalPackets = m_index.size();
+    m_statistics.indexEndTime = QDateTime::currentDateTime();
+    
+    setStatus(IndexStatus::Completed);
+}
+
 bool FileIndexer::saveIndexToCache(const QString& cacheFilename) const {
     QMutexLocker locker(&m_indexMutex);
     
-    QJsonObject cacheObject;
-    cacheObject["version"] = 1;
-    cacheObject["filename"] = m_statistics.filename;
-    cacheObject["fileSize"] = m_statistics.fileSize;
-    cacheObject["totalPackets"] = static_cast<qint64>(m_statistics.totalPackets);
-    cacheObject["indexedPackets"] = static_cast<qint64>(m_statistics.indexedPackets);
-    cacheObject["created"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-    
-    // Create checksum of original file
-    QFile originalFile(m_statistics.filename);
-    if (originalFile.open(QIODevice::ReadOnly)) {
-        QCryptographicHash hash(QCryptographicHash::Md5);
-        hash.addData(originalFile.readAll());
-        cacheObject["fileChecksum"] = QString(hash.result().toHex());
-        originalFile.close();
-    }
-    
-    // Save index entries (sample for large indices)
-    QJsonArray indexArray;
-    size_t maxEntries = 10000; // Limit cache size
-    size_t step = std::max(static_cast<size_t>(1), m_index.size() / maxEntries);
-    
-    for (size_t i = 0; i < m_index.size(); i += step) {
-        const auto& entry = m_index[i];
-        QJsonObject entryObject;
-        entryObject["position"] = entry.filePosition;
-        entryObject["size"] = static_cast<int>(entry.packetSize);
-        entryObject["timestamp"] = static_cast<qint64>(entry.timestamp);
-        entryObject["packetId"] = static_cast<int>(entry.packetId);
-        entryObject["sequence"] = static_cast<int>(entry.sequenceNumber);
-        indexArray.append(entryObject);
-    }
-    cacheObject["index"] = indexArray;
-    
-    // Write cache file
-    QFile cacheFile(cacheFilename);
+    FileFingerprint fingerprint = m_fingerprint;
+    if (!fingerprint.isValid() && 
+        !computeFingerprint(m_statistics.filename, m_statistics.fileSize, fingerprint)) {
+        m_logger->error("FileIndexer", 
+            QString("Cannot fingerprint data file for index cache: %1").arg(m_statistics.filename));
+        return false;
+    }
+    
+    const QByteArray filename = m_statistics.filename.toUtf8();
+    const uint64_t count = m_index.size();
+    
+    IndexCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = INDEX_CACHE_MAGIC;
+    header.version = INDEX_CACHE_VERSION;
+    header.entryCount = count;
+    header.fileSize = fingerprint.fileSize;
+    header.modifiedMs = fingerprint.modifiedMs;
+    header.headHash = fingerprint.headHash;
+    header.tailHash = fingerprint.tailHash;
+    header.indexedBytes = m_index.empty() ? 0 : m_index.back().filePosition + m_index.back().packetSize;
+    header.errorPackets = m_statistics.errorPackets;
+    header.filenameBytes = static_cast<uint32_t>(filename.size());
+    header.headerByteOrder = static_cast<uint32_t>(m_headerByteOrder);
+    
+    // Posting lists in ascending ID order, concatenated behind their start offsets
+    const auto& postings = m_secondaryIndex.postings();
+    std::vector<uint32_t> postingIds;
+    postingIds.reserve(postings.size());
+    for (const auto& list : postings) {
+        postingIds.push_back(list.first);
+    }
+    std::sort(postingIds.begin(), postingIds.end());
+    
+    std::vector<uint64_t> postingStarts;
+    postingStarts.reserve(postingIds.size() + 1);
+    postingStarts.push_back(0);
+    for (uint32_t packetId : postingIds) {
+        postingStarts.push_back(postingStarts.back() + postings.at(packetId).size());
+    }
+    
+    header.blockCount = m_secondaryIndex.blocks().size();
+    header.postingIdCount = postingIds.size();
+    layoutCache(header);
+    
+    // Written to a temporary file and renamed, so readers never see a torn cache
+    QSaveFile cacheFile(cacheFilename);
     if (!cacheFile.open(QIODevice::WriteOnly)) {
         m_logger->error("FileIndexer", 
             QString("Failed to create cache file: %1").arg(cacheFile.errorString()));
         return false;
     }
     
-    QJsonDocument doc(cacheObject);
-    qint64 bytesWritten = cacheFile.write(doc.toJson(QJsonDocument::Compact));
-    cacheFile.close();
+    bool success = 
+        cacheFile.write(reinterpret_cast<const char*>(&header), sizeof(header)) == static_cast<qint64>(sizeof(header)) &&
+        cacheFile.write(filename) == filename.size() &&
+        writePadding(cacheFile, header.positionOffset) &&
+        writeColumn<int64_t>(cacheFile, m_index, [](const PacketIndexEntry& e) { return e.filePosition; }) &&
+        writeColumn<uint64_t>(cacheFile, m_index, [](const PacketIndexEntry& e) { return e.timestamp; }) &&
+        writeColumn<uint32_t>(cacheFile, m_index, [](const PacketIndexEntry& e) { return e.packetSize; }) &&
+        writeColumn<uint32_t>(cacheFile, m_index, [](const PacketIndexEntry& e) { return e.packetId; }) &&
+        writeColumn<uint32_t>(cacheFile, m_index, [](const PacketIndexEntry& e) { return e.sequenceNumber; }) &&
+        writePadding(cacheFile, header.blockOffset) &&
+        writeArray(cacheFile, m_secondaryIndex.blocks()) &&
+        writeArray(cacheFile, postingIds) &&
+        writePadding(cacheFile, header.postingStartOffset) &&
+        writeArray(cacheFile, postingStarts);
+    
+    for (size_t i = 0; success && i < postingIds.size(); ++i) {
+        success = writeArray(cacheFile, postings.at(postingIds[i]));
+    }
     
-    bool success = (bytesWritten > 0);
+    success = success && cacheFile.commit();
     
     if (success) {
         m_logger->info("FileIndexer", 
-            QString("Index cache saved: %1").arg(cacheFilename));
+            QString("Index cache saved: %1 (%2 packets)").arg(cacheFilename).arg(count));
     } else {
+        cacheFile.cancelWriting();
         m_logger->error("FileIndexer", 
             QString("Failed to write index cache: %1").arg(cacheFilename));
     }
@@ -436,59 +941,190 @@ bool FileIndexer::loadIndexFromCache(const QString& cacheFilename) {
         return false;
     }
     
-    QJsonParseError parseError;
-    QJsonDocument doc = QJsonDocument::fromJson(cacheFile.readAll(), &parseError);
-    cacheFile.close();
+    IndexCacheHeader header;
+    if (!readCacheHeader(cacheFile, header)) {
+        m_logger->warning("FileIndexer", 
+            QString("Unrecognised index cache format: %1").arg(cacheFilename));
+        return false;
+    }
+    if (header.headerByteOrder != static_cast<uint32_t>(m_headerByteOrder)) {
+        m_logger->info("FileIndexer", 
+            QString("Index cache was built for another header byte order: %1").arg(cacheFilename));
+        return false;
+    }
+    
+    const uint64_t count = header.entryCount;
+    if (count > static_cast<uint64_t>(cacheFile.size()) || header.blockCount > count ||
+        header.postingIdCount > count) {
+        m_logger->warning("FileIndexer", 
+            QString("Truncated or inconsistent index cache: %1").arg(cacheFilename));
+        return false;
+    }
     
-    if (parseError.error != QJsonParseError::NoError) {
+    const uint64_t expectedBlocks = (count + PacketSecondaryIndex::BLOCK_SIZE - 1) / PacketSecondaryIndex::BLOCK_SIZE;
+    IndexCacheHeader expected = header;
+    layoutCache(expected);
+    if (std::memcmp(&expected, &header, sizeof(header)) != 0 ||
+        header.blockCount != expectedBlocks ||
+        static_cast<uint64_t>(cacheFile.size()) < header.totalSize) {
         m_logger->warning("FileIndexer", 
-            QString("Cache file parse error: %1").arg(parseError.errorString()));
+            QString("Truncated or inconsistent index cache: %1").arg(cacheFilename));
         return false;
     }
     
-    QJsonObject cacheObject = doc.object();
+    const uchar* base = cacheFile.map(0, static_cast<qint64>(header.totalSize));
+    if (!base) {
+        m_logger->warning("FileIndexer", 
+            QString("Failed to map index cache: %1").arg(cacheFile.errorString()));
+        return false;
+    }
     
-    // Verify cache validity
-    QString cachedFilename = cacheObject["filename"].toString();
-    qint64 cachedFileSize = cacheObject["fileSize"].toVariant().toLongLong();
+    const QString cachedFilename = QString::fromUtf8(
+        reinterpret_cast<const char*>(base + sizeof(header)), static_cast<int>(header.filenameBytes));
     
-    if (cachedFilename != m_statistics.filename || 
-        cachedFileSize != m_statistics.fileSize) {
+    // Verify cache validity
+    if (!m_statistics.filename.isEmpty() && cachedFilename != m_statistics.filename) {
         m_logger->warning("FileIndexer", "Cache file mismatch");
         return false;
     }
     
-    // Load index entries
-    QJsonArray indexArray = cacheObject["index"].toArray();
+    const FileFingerprint cachedFingerprint = fingerprintFromHeader(header);
+    const FingerprintMatch match = matchFingerprint(cachedFilename, cachedFingerprint);
+    if (match == FingerprintMatch::Stale) {
+        m_logger->warning("FileIndexer", 
+            QString("Index cache is stale for %1").arg(cachedFilename));
+        return false;
+    }
     
-    QMutexLocker locker(&m_indexMutex);
-    m_index.clear();
-    m_index.reserve(indexArray.size());
+    std::vector<PacketSecondaryIndex::Block> blocks(header.blockCount);
+    if (!blocks.empty()) {
+        std::memcpy(blocks.data(), base + header.blockOffset, blocks.size() * sizeof(PacketSecondaryIndex::Block));
+    }
     
-    for (const auto& value : indexArray) {
-        QJsonObject entryObject = value.toObject();
-        PacketIndexEntry entry;
-        entry.filePosition = entryObject["position"].toVariant().toLongLong();
-        entry.packetSize = static_cast<uint32_t>(entryObject["size"].toInt());
-        entry.timestamp = static_cast<uint64_t>(entryObject["timestamp"].toVariant().toLongLong());
-        entry.packetId = static_cast<uint32_t>(entryObject["packetId"].toInt());
-        entry.sequenceNumber = static_cast<uint32_t>(entryObject["sequence"].toInt());
-        m_index.push_back(entry);
+    // Every entry sits in exactly one ascending posting list
+    PacketSecondaryIndex::PostingMap postings;
+    postings.reserve(header.postingIdCount);
+    for (size_t i = 0; i < header.postingIdCount; ++i) {
+        const uint64_t first = readColumnValue<uint64_t>(base, header.postingStartOffset, i);
+        const uint64_t last = readColumnValue<uint64_t>(base, header.postingStartOffset, i + 1);
+        if ((i == 0 && first != 0) || last < first || last > count) {
+            m_logger->warning("FileIndexer", 
+                QString("Corrupt posting lists in index cache: %1").arg(cacheFilename));
+            return false;
+        }
+        
+        PacketSecondaryIndex::PostingList& list = postings[readColumnValue<uint32_t>(base, header.postingIdOffset, i)];
+        list.resize(static_cast<size_t>(last - first));
+        if (!list.empty()) {
+            std::memcpy(list.data(), base + header.postingOffset + first * sizeof(uint32_t),
+                        list.size() * sizeof(uint32_t));
+        }
+        for (size_t j = 0; j < list.size(); ++j) {
+            if (list[j] >= count || (j > 0 && list[j] <= list[j - 1])) {
+                m_logger->warning("FileIndexer", 
+                    QString("Corrupt posting lists in index cache: %1").arg(cacheFilename));
+                return false;
+            }
+        }
+    }
+    if (postings.size() != header.postingIdCount ||
+        readColumnValue<uint64_t>(base, header.postingStartOffset, header.postingIdCount) != count) {
+        m_logger->warning("FileIndexer", 
+            QString("Corrupt posting lists in index cache: %1").arg(cacheFilename));
+        return false;
+    }
+    
+    {
+        QMutexLocker locker(&m_indexMutex);
+        m_index.clear();
+        m_index.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            PacketIndexEntry& entry = m_index[i];
+            entry.filePosition = readColumnValue<int64_t>(base, header.positionOffset, i);
+            entry.timestamp = readColumnValue<uint64_t>(base, header.timestampOffset, i);
+            entry.packetSize = readColumnValue<uint32_t>(base, header.sizeOffset, i);
+            entry.packetId = readColumnValue<uint32_t>(base, header.idOffset, i);
+            entry.sequenceNumber = readColumnValue<uint32_t>(base, header.sequenceOffset, i);
+        }
+        m_secondaryIndex.restore(count, std::move(blocks), std::move(postings));
     }
     
+    m_filename = cachedFilename;
+    m_fingerprint = cachedFingerprint;
+    m_indexedBytes = header.indexedBytes;
+    
     // Update statistics
+    m_statistics = IndexStatistics();
+    m_statistics.filename = cachedFilename;
+    m_statistics.fileSize = cachedFingerprint.fileSize;
     m_statistics.totalPackets = m_index.size();
     m_statistics.indexedPackets = m_index.size();
     m_statistics.validPackets = m_index.size();
+    m_statistics.errorPackets = header.errorPackets;
     
-    setStatus(IndexStatus::Completed);
+    if (match == FingerprintMatch::Exact) {
+        setStatus(IndexStatus::Completed);
+        m_logger->info("FileIndexer", 
+            QString("Index cache loaded: %1 packets").arg(m_index.size()));
+    } else {
+        m_logger->info("FileIndexer", 
+            QString("Index cache loaded: %1 packets, data appended after byte %2 still to be indexed")
+            .arg(m_index.size()).arg(cachedFingerprint.fileSize));
+    }
     
-    m_logger->info("FileIndexer", 
-        QString("Index cache loaded: %1 packets").arg(m_index.size()));
+    return true;
+}
+
+bool FileIndexer::computeFingerprint(const QString& filename, qint64 length, FileFingerprint& fingerprint) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    
+    if (length < 0) {
+        length = file.size();
+    }
+    if (length > file.size()) {
+        return false;
+    }
     
+    const qint64 blockSize = std::min(length, FINGERPRINT_BLOCK_SIZE);
+    const QByteArray head = file.read(blockSize);
+    if (!file.seek(length - blockSize)) {
+        return false;
+    }
+    const QByteArray tail = file.read(blockSize);
+    if (head.size() != blockSize || tail.size() != blockSize) {
+        return false;
+    }
+    
+    fingerprint.fileSize = length;
+    fingerprint.modifiedMs = QFileInfo(filename).lastModified().toMSecsSinceEpoch();
+    fingerprint.headHash = hashBlock(head);
+    fingerprint.tailHash = hashBlock(tail);
     return true;
 }
 
+FileIndexer::FingerprintMatch FileIndexer::matchFingerprint(const QString& filename, const FileFingerprint& recorded) {
+    FileFingerprint current;
+    if (!recorded.isValid() || !computeFingerprint(filename, -1, current)) {
+        return FingerprintMatch::Stale;
+    }
+    
+    if (current.sameContent(recorded) && current.modifiedMs == recorded.modifiedMs) {
+        return FingerprintMatch::Exact;
+    }
+    
+    // Grown file: the range that was indexed must be untouched
+    FileFingerprint prefix;
+    if (current.fileSize > recorded.fileSize && 
+        computeFingerprint(filename, recorded.fileSize, prefix) && prefix.sameContent(recorded)) {
+        return FingerprintMatch::Appended;
+    }
+    
+    return FingerprintMatch::Stale;
+}
+
 QString FileIndexer::getCacheFilename(const QString& dataFilename) {
     QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
     QDir().mkpath(cacheDir);
@@ -500,18 +1136,18 @@ QString FileIndexer::getCacheFilename(const QString& dataFilename) {
     return QString("%1/%2_%3.idx").arg(cacheDir).arg(baseName).arg(QString(hash).left(8));
 }
 
-bool FileIndexer::isCacheValid(const QString& dataFilename) {
-    QString cacheFilename = getCacheFilename(dataFilename);
-    
-    if (!QFileInfo::exists(cacheFilename)) {
+bool FileIndexer::isCacheValid(const QString& dataFilename, Parser::Layout::ByteOrder headerByteOrder) {
+    QFile cacheFile(getCacheFilename(dataFilename));
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
         return false;
     }
     
-    QFileInfo dataInfo(dataFilename);
-    QFileInfo cacheInfo(cacheFilename);
+    IndexCacheHeader header;
+    if (!readCacheHeader(cacheFile, header) || header.headerByteOrder != static_cast<uint32_t>(headerByteOrder)) {
+        return false;
+    }
     
-    // Check if cache is newer than data file
-    return cacheInfo.lastModified() >= dataInfo.lastModified();
+    return matchFingerprint(dataFilename, fingerprintFromHeader(header)) == FingerprintMatch::Exact;
 }
 
 void FileIndexer::setStatus(IndexStatus newStatus) {
@@ -529,10 +1165,11 @@ void FileIndexer::updateProgress(qint64 bytesProcessed, qint64 totalBytes) {
     
     percentage = std::clamp(percentage, 0, 100);
     
-    // Only emit progress if it has changed and enough time has passed
+    // Only emit progress if it has changed and enough time has passed;
+    // completion is never throttled away
     QDateTime now = QDateTime::currentDateTime();
     if (percentage != m_lastProgressPercentage && 
-        (m_lastProgressUpdate.isNull() || 
+        (percentage == 100 || m_lastProgressUpdate.isNull() || 
          m_lastProgressUpdate.msecsTo(now) >= PROGRESS_UPDATE_INTERVAL)) {
         
         m_lastProgressPercentage = percentage;
@@ -555,6 +1192,9 @@ void FileIndexer::calculateStatistics() {
 void FileIndexer::clearIndex() {
     QMutexLocker locker(&m_indexMutex);
     m_index.clear();
+    m_secondaryIndex.clear();
+    m_indexedBytes = 0;
+    m_fingerprint = FileFingerprint();
     m_lastProgressPercentage = -1;
 }
 
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "../../logging/logger.h"
+#include "../../packet/core/packet_header.h"
+#include "../../parser/layout/byte_order.h"
+#include "../../threading/thread_pool.h"
+#include "packet_secondary_index.h"
 #include <QString>
 #include <QDateTime>
 #include <QThread>
@@ -30,6 +34,29 @@ struct PacketIndexEntry {
         : filePosition(pos), packetSize(size), timestamp(ts), packetId(id), sequenceNumber(seq) {}
 };
 
+/**
+ * @brief Cheap identity of a data file for validating a cached index
+ * 
+ * Hashes only the first and last FINGERPRINT_BLOCK_SIZE bytes of the indexed
+ * range, so validating a multi-GB capture costs two small reads. Together
+ * with size and modification time this catches replaced or rewritten files;
+ * a file that has only been appended to keeps its prefix fingerprint.
+ */
+struct FileFingerprint {
+    qint64 fileSize;            ///< Length of the fingerprinted range (bytes)
+    qint64 modifiedMs;          ///< Modification time (ms since epoch)
+    uint64_t headHash;          ///< Hash of the first block of the range
+    uint64_t tailHash;          ///< Hash of the last block of the range
+    
+    FileFingerprint() : fileSize(-1), modifiedMs(0), headHash(0), tailHash(0) {}
+    
+    bool isValid() const { return fileSize >= 0; }
+    
+    bool sameContent(const FileFingerprint& other) const {
+        return fileSize == other.fileSize && headHash == other.headHash && tailHash == other.tailHash;
+    }
+};
+
 /**
  * @brief Index statistics and metadata
  */
@@ -59,13 +86,22 @@ struct IndexStatistics {
  * 
  * Key Features:
  * - Background indexing in separate thread
+ * - Parallel chunked scanning of memory-mapped files on a ThreadPool
  * - Memory-efficient streaming indexer
  * - Progress reporting during indexing
- * - Index caching and persistence
+ * - Index caching and persistence (complete binary columnar cache)
+ * - Incremental re-indexing of files that have grown
  * - Fast binary search for seeking
- * - Timestamp-based navigation
- * - Packet ID and sequence filtering
+ * - Timestamp-based navigation, correct for out-of-order timestamps
+ * - Packet ID posting lists and time-window selection
  * - Error recovery and validation
+ * - PCAP/PCAPNG captures (see PcapReader)
+ * 
+ * Captures are indexed sequentially because TCP reassembly carries state
+ * from record to record, and are always rebuilt rather than extended. Their
+ * entries hold the capture timestamp in nanoseconds; the file position is
+ * the packet itself, or the record holding its first byte if it is split
+ * across segments, so positions are not strictly ascending.
  */
 class FileIndexer : public QThread {
     Q_OBJECT
@@ -95,12 +131,45 @@ public:
     
     /**
      * @brief Start indexing file
+     * 
+     * If this indexer already holds an index of @p filename (from a previous
+     * run or loadIndexFromCache()) and the file has only been appended to
+     * since, indexing continues after the last indexed packet instead of
+     * starting from zero.
+     * 
      * @param filename File to index
      * @param background True to index in background thread
      * @return True if indexing started successfully
      */
     bool startIndexing(const QString& filename, bool background = true);
     
+    /**
+     * @brief Scan the file in chunks on @p threadPool
+     * 
+     * Chunks are scanned concurrently and stitched back into one index in
+     * file order. Without a running pool the same chunks are scanned one
+     * after another on the indexing thread.
+     */
+    void setThreadPool(Threading::ThreadPool* threadPool) { m_threadPool = threadPool; }
+    Threading::ThreadPool* getThreadPool() const { return m_threadPool; }
+    
+    /**
+     * @brief Set size of the file ranges scanned independently
+     */
+    void setChunkSize(qint64 bytes);
+    qint64 getChunkSize() const { return m_chunkSize; }
+    
+    /**
+     * @brief Set the byte order the file's packet headers were written in
+     * 
+     * Headers are converted to host order before they are validated and
+     * indexed. Set it before startIndexing() or loadIndexFromCache(); a
+     * change discards the index held so far, which was read in the old
+     * order.
+     */
+    void setHeaderByteOrder(Parser::Layout::ByteOrder order);
+    Parser::Layout::ByteOrder getHeaderByteOrder() const { return m_headerByteOrder; }
+    
     /**
      * @brief Cancel ongoing indexing operation
      */
@@ -136,7 +205,7 @@ public:
     /**
      * @brief Find packet by timestamp
      * @param timestamp Target timestamp
-     * @return Index of packet at or after timestamp, or -1 if not found
+     * @return Index of the first packet in file order at or after timestamp, or -1 if not found
      */
     int findPacketByTimestamp(uint64_t timestamp) const;
     
@@ -154,6 +223,26 @@ public:
      */
     int findPacketBySequence(uint32_t sequenceNumber) const;
     
+    /**
+     * @brief Select packets by ID set and time window
+     * 
+     * Walks only the posting lists of the requested IDs and skips index
+     * blocks whose timestamp range misses the window.
+     * 
+     * @param packetIds Packet IDs to keep; empty keeps every ID
+     * @param startTimestamp First timestamp in the window (inclusive)
+     * @param endTimestamp Last timestamp in the window (inclusive)
+     * @return Ascending indices of matching packets
+     */
+    std::vector<uint32_t> selectPackets(const std::vector<uint32_t>& packetIds,
+                                        uint64_t startTimestamp = 0,
+                                        uint64_t endTimestamp = UINT64_MAX) const;
+    
+    /**
+     * @brief Get packet-ID posting lists and timestamp skip index
+     */
+    const PacketSecondaryIndex& getSecondaryIndex() const { return m_secondaryIndex; }
+    
     /**
      * @brief Get packet entry by index
      * @param index Packet index
@@ -166,8 +255,35 @@ public:
      */
     uint64_t getPacketCount() const { return m_index.size(); }
     
+    /**
+     * @brief Get end of the last indexed packet; indexing resumes from here
+     */
+    qint64 getIndexedBytes() const { return m_indexedBytes; }
+    
+    /**
+     * @brief Get fingerprint of the file as it was when last indexed
+     */
+    const FileFingerprint& getFingerprint() const { return m_fingerprint; }
+    
+    /**
+     * @brief Extend the index with entries built while @p filename is written
+     * 
+     * Lets a writer index its packets as it goes instead of scanning the
+     * file afterwards. Entries must follow the current index in file order;
+     * an index of another file is discarded first. The file is fingerprinted
+     * again by the next saveIndexToCache().
+     * 
+     * @param filename Data file the entries point into
+     * @param entries New entries in file order
+     */
+    void appendEntries(const QString& filename, const std::vector<PacketIndexEntry>& entries);
+    
     /**
      * @brief Save index to cache file
+     * 
+     * Writes every entry in a versioned binary columnar layout (one array per
+     * field), the secondary indexes and the fingerprint of the indexed file.
+     * 
      * @param cacheFilename Cache file path
      * @return True if saved successfully
      */
@@ -175,11 +291,32 @@ public:
     
     /**
      * @brief Load index from cache file
+     * 
+     * The cache is memory-mapped and validated against the data file's
+     * current fingerprint. If the data file has grown since, the cached
+     * entries are still loaded and the next startIndexing() of the same file
+     * only indexes the appended data.
+     * 
+     * Loading is one sequential decode of the cached columns and posting
+     * lists into the in-memory index, so it is still linear in the number
+     * of packets; what it saves is the scan of the data file. The mapping
+     * is released before returning, because getIndex() and the entry
+     * pointers are served from the vector, which later runs extend in place.
+     * 
      * @param cacheFilename Cache file path
      * @return True if loaded successfully
      */
     bool loadIndexFromCache(const QString& cacheFilename);
     
+    /**
+     * @brief Compute fingerprint of a file
+     * @param filename Data file path
+     * @param length Length of the range to fingerprint, or -1 for the whole file
+     * @param fingerprint Output fingerprint
+     * @return False if the file cannot be read or is shorter than @p length
+     */
+    static bool computeFingerprint(const QString& filename, qint64 length, FileFingerprint& fingerprint);
+    
     /**
      * @brief Get recommended cache filename for a data file
      * @param dataFilename Original data file path
@@ -188,11 +325,13 @@ public:
     static QString getCacheFilename(const QString& dataFilename);
     
     /**
-     * @brief Check if cache file exists and is valid
+     * @brief Check if cache file exists and matches the data file exactly
      * @param dataFilename Original data file path
+     * @param headerByteOrder Header byte order the cache must have been built with
      * @return True if valid cache exists
      */
-    static bool isCacheValid(const QString& dataFilename);
+    static bool isCacheValid(const QString& dataFilename,
+                             Parser::Layout::ByteOrder headerByteOrder = Parser::Layout::ByteOrder::Native);
 
 public slots:
     /**
@@ -243,11 +382,91 @@ protected:
     void run() override;
 
 private:
+    /**
+     * @brief How a data file relates to a previously recorded fingerprint
+     */
+    enum class FingerprintMatch {
+        Stale,          ///< Different file or rewritten contents
+        Exact,          ///< Unchanged
+        Appended        ///< Unchanged prefix with data appended
+    };
+    
+    /**
+     * @brief Compare a data file against a recorded fingerprint
+     */
+    static FingerprintMatch matchFingerprint(const QString& filename, const FileFingerprint& recorded);
+    
     /**
      * @brief Perform the actual indexing
      */
     bool performIndexing();
     
+    /**
+     * @brief File range scanned independently of its neighbours
+     * 
+     * Every chunk but the first starts by resynchronising on the first valid
+     * header in its range, which may sit inside a payload; stitchChunk()
+     * reconciles that against the chain of packets from the previous chunk.
+     */
+    struct IndexChunk {
+        qint64 begin = 0;                       ///< First byte of the range
+        qint64 end = 0;                         ///< Packets starting here or later belong to the next chunk
+        std::vector<PacketIndexEntry> entries;
+        std::vector<qint64> errorPositions;     ///< Invalid packets skipped by the scan
+        qint64 nextPosition = -1;               ///< Packet after the range, or -1 if still resynchronising
+    };
+    
+    /**
+     * @brief Where the stitched index continues
+     */
+    struct StitchCursor {
+        qint64 position;        ///< Next packet, or where resynchronisation resumes
+        bool resync;            ///< Next packet is the first valid one at or after position
+    };
+    
+    /**
+     * @brief Index a memory-mapped file from @p start in chunks
+     */
+    bool performChunkedIndexing(const uchar* data, qint64 fileSize, qint64 start,
+                                uint64_t& packetCount, uint64_t& errorCount);
+    
+    /**
+     * @brief Index the packets carried in a mapped PCAP or PCAPNG capture
+     */
+    bool performCaptureIndexing(const uchar* data, qint64 fileSize,
+                                uint64_t& packetCount, uint64_t& errorCount);
+    
+    /**
+     * @brief Scan one chunk; safe to run concurrently for distinct chunks
+     * @param synced True if the chunk starts on a packet boundary
+     */
+    void scanChunk(const uchar* data, qint64 fileSize, IndexChunk& chunk, bool synced);
+    
+    /**
+     * @brief Append a scanned chunk to the index in file order
+     */
+    void stitchChunk(const uchar* data, qint64 fileSize, IndexChunk& chunk,
+                     StitchCursor& cursor, uint64_t& errorCount);
+    
+    /**
+     * @brief Add index entries not yet covered to the secondary indexes
+     * 
+     * Caller must hold m_indexMutex.
+     */
+    void extendSecondaryIndex();
+    
+    /**
+     * @brief Mapped-memory counterpart of readPacketAtPosition()
+     */
+    static bool readMappedPacket(const uchar* data, qint64 fileSize, qint64 position,
+                                 Parser::Layout::ByteOrder headerByteOrder, PacketIndexEntry& entry);
+    
+    /**
+     * @brief Mapped-memory counterpart of findNextValidPacket()
+     * @return First valid packet in [@p startPosition, @p limit), or -1
+     */
+    qint64 findNextMappedPacket(const uchar* data, qint64 fileSize, qint64 startPosition, qint64 limit) const;
+    
     /**
      * @brief Read and validate packet at position
      * @param file File handle
@@ -259,10 +478,10 @@ private:
     
     /**
      * @brief Validate packet header
-     * @param headerData Header bytes
+     * @param header Header already converted to host order
      * @return True if header is valid
      */
-    bool validatePacketHeader(const QByteArray& headerData) const;
+    bool validatePacketHeader(const Packet::PacketHeader& header) const;
     
     /**
      * @brief Set indexing status
@@ -300,7 +519,17 @@ private:
     
     // Index data
     std::vector<PacketIndexEntry> m_index;
+    PacketSecondaryIndex m_secondaryIndex;  ///< Kept in step with m_index
     mutable QMutex m_indexMutex;
+    qint64 m_indexedBytes;              ///< End of the last indexed packet
+    qint64 m_resumePosition;            ///< Where the current run starts
+    FileFingerprint m_fingerprint;      ///< Data file as of the last completed run
+    
+    // Parallel indexing
+    Threading::ThreadPool* m_threadPool;
+    qint64 m_chunkSize;
+    Parser::Layout::ByteOrder m_headerByteOrder;
+    std::atomic<qint64> m_bytesScanned;     ///< Progress across all chunk scans
     
     // Statistics
     IndexStatistics m_statistics;
@@ -317,6 +546,11 @@ private:
     static constexpr int MAX_PACKET_SIZE = 65536;           // 64KB
     static constexpr int MIN_PACKET_SIZE = 24;              // Minimum header size
     static constexpr int BATCH_SIZE = 1000;                 // Packets per batch
+    static constexpr qint64 FINGERPRINT_BLOCK_SIZE = 65536; // Bytes hashed at each end
+    static constexpr qint64 DEFAULT_CHUNK_SIZE = 16 * 1024 * 1024;
+    static constexpr qint64 MIN_CHUNK_SIZE = 1024;
+    static constexpr qint64 SCAN_PROGRESS_STEP = 1024 * 1024;   // Bytes between progress updates
+    static constexpr size_t CHUNKS_IN_FLIGHT_PER_THREAD = 2;
 };
 
 /**
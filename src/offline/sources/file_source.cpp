@@ -1,4 +1,5 @@
 #include "file_source.h"
+#include "pcap_reader.h"
 #include "../../packet/core/packet_header.h"
 #include <QFileInfo>
 #include <QDateTime>
@@ -7,6 +8,7 @@
 #include <QStandardPaths>
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 namespace Monitor {
 namespace Offline {
@@ -18,10 +20,12 @@ FileSource::FileSource(const FileSourceConfig& config, QObject* parent)
     , m_fileLoaded(false)
     , m_playbackState(PlaybackState::Stopped)
     , m_file(nullptr)
+    , m_mappedData(nullptr)
     , m_fileSize(0)
     , m_currentPosition(0)
     , m_currentPacketIndex(0)
     , m_indexBuilt(false)
+    , m_batchPlaying(false)
     , m_packetsDelivered(0)
 {
     // Setup timers
@@ -77,6 +81,22 @@ bool FileSource::loadFile(const QString& filename, FileFormat format) {
         return false;
     }
     
+    // Map the whole file; indexing and playback then read without syscalls.
+    // Captures are always read through the mapping.
+    if (m_config.memoryMapped || m_fileFormat == FileFormat::PCAP) {
+        m_mappedData = m_file->map(0, m_fileSize);
+        if (!m_mappedData && m_fileFormat == FileFormat::PCAP) {
+            m_logger->error("FileSource", 
+                QString("Failed to map capture: %1").arg(m_file->errorString()));
+            m_file.reset();
+            return false;
+        }
+        if (!m_mappedData) {
+            m_logger->warning("FileSource", 
+                QString("Failed to map file, using buffered reads: %1").arg(m_file->errorString()));
+        }
+    }
+    
     // Build packet index
     if (!indexPackets()) {
         m_logger->warning("FileSource", "Failed to build packet index, seeking will be limited");
@@ -87,7 +107,7 @@ bool FileSource::loadFile(const QString& filename, FileFormat format) {
     m_fileStats.filename = filename;
     m_fileStats.fileSize = m_fileSize;
     m_fileStats.fileCreated = fileInfo.birthTime();
-    m_fileStats.totalPackets = m_packetIndex.size();
+    m_fileStats.totalPackets = playbackIndex().size();
     m_fileStats.currentPacket = 0;
     m_fileStats.playbackProgress = 0.0;
     
@@ -111,9 +131,14 @@ void FileSource::closeFile() {
     
     // Stop playback
     stopPlayback();
+    m_playbackEngine.reset();
     
     // Close file
     if (m_file) {
+        if (m_mappedData) {
+            m_file->unmap(m_mappedData);
+            m_mappedData = nullptr;
+        }
         m_file->close();
         m_file.reset();
     }
@@ -122,10 +147,14 @@ void FileSource::closeFile() {
     m_fileLoaded = false;
     m_currentFilename.clear();
     m_fileSize = 0;
+    m_reassembledData.clear();
     m_currentPosition = 0;
     m_currentPacketIndex = 0;
     m_indexBuilt = false;
     m_packetIndex.clear();
+    m_secondaryIndex.clear();
+    m_filteredIndex.clear();
+    m_filteredEntries.clear();
     m_packetsDelivered = 0;
     
     // Reset statistics
@@ -184,7 +213,8 @@ FileSource::FileFormat FileSource::detectFileFormat(const QString& filename) con
     
     QString mimeTypeName = mimeType.name();
     
-    if (mimeTypeName == "application/vnd.tcpdump.pcap" || filename.endsWith(".pcap")) {
+    if (mimeTypeName == "application/vnd.tcpdump.pcap" || filename.endsWith(".pcap") ||
+        filename.endsWith(".pcapng") || PcapReader::isCaptureFile(filename)) {
         return FileFormat::PCAP;
     }
     
@@ -218,6 +248,13 @@ bool FileSource::indexPackets() {
     m_logger->info("FileSource", "Building packet index...");
     
     m_packetIndex.clear();
+    m_secondaryIndex.clear();
+    m_reassembledData.clear();
+    
+    if (m_fileFormat == FileFormat::PCAP) {
+        return indexCapture();
+    }
+    
     m_file->seek(0);
     
     qint64 position = 0;
@@ -230,18 +267,13 @@ bool FileSource::indexPackets() {
         }
         
         // Read packet header to get size
-        m_file->seek(position);
-        QByteArray headerData = m_file->read(sizeof(Packet::PacketHeader));
-        
-        if (headerData.size() != sizeof(Packet::PacketHeader)) {
+        Packet::PacketHeader header;
+        if (!readHeaderAt(position, header)) {
             break;
         }
         
-        const Packet::PacketHeader* header = 
-            reinterpret_cast<const Packet::PacketHeader*>(headerData.constData());
-        
         // Calculate total packet size
-        uint32_t totalSize = sizeof(Packet::PacketHeader) + header->payloadSize;
+        uint32_t totalSize = sizeof(Packet::PacketHeader) + header.payloadSize;
         
         // Validate packet header
         if (totalSize < sizeof(Packet::PacketHeader) || totalSize > 65536) { // Max 64KB packet
@@ -258,7 +290,8 @@ bool FileSource::indexPackets() {
         }
         
         // Add to index
-        m_packetIndex.emplace_back(position, totalSize, header->timestamp);
+        m_packetIndex.push_back(PacketIndex(position, totalSize, header.timestamp));
+        m_secondaryIndex.append(header.id, header.timestamp, header.sequence);
         
         // Move to next packet
         position += totalSize;
@@ -272,6 +305,7 @@ bool FileSource::indexPackets() {
     }
     
     m_indexBuilt = true;
+    applyPlaybackFilter();
     
     m_logger->info("FileSource", 
         QString("Packet index built: %1 packets").arg(m_packetIndex.size()));
@@ -279,6 +313,110 @@ bool FileSource::indexPackets() {
     return true;
 }
 
+bool FileSource::indexCapture() {
+    PcapReader::Configuration readerConfig;
+    readerConfig.headerByteOrder = m_config.headerByteOrder;
+    PcapReader reader(m_mappedData, m_mappedData ? m_fileSize : 0, readerConfig);
+    if (!reader.isValid()) {
+        m_logger->error("FileSource", QString("Failed to read capture: %1").arg(reader.errorString()));
+        return false;
+    }
+    
+    CapturedPacket packet;
+    while (reader.readNext(packet)) {
+        // Packets split across segments are kept past the end of the file
+        qint64 position = packet.position;
+        if (position < 0) {
+            position = m_fileSize + static_cast<qint64>(m_reassembledData.size());
+            m_reassembledData.insert(m_reassembledData.end(), packet.data, packet.data + packet.size);
+        }
+        
+        Packet::PacketHeader header;
+        std::memcpy(&header, packet.data, sizeof(header));
+        header.convertToHostOrder(m_config.headerByteOrder);
+        
+        // Capture time drives playback pacing
+        m_packetIndex.push_back(PacketIndex(position, packet.size, packet.timestampNs));
+        m_secondaryIndex.append(header.id, packet.timestampNs, header.sequence);
+        
+        if (m_packetIndex.size() % 10000 == 0) {
+            m_logger->debug("FileSource", 
+                QString("Indexed %1 packets...").arg(m_packetIndex.size()));
+        }
+    }
+    
+    if (!reader.errorString().isEmpty()) {
+        m_logger->warning("FileSource", reader.errorString());
+    }
+    
+    const auto& stats = reader.getStatistics();
+    m_indexBuilt = true;
+    applyPlaybackFilter();
+    
+    m_logger->info("FileSource", 
+        QString("Capture index built: %1 packets from %2 records (%3 reassembled, %4 records skipped, %5 framing errors)")
+        .arg(m_packetIndex.size()).arg(stats.records).arg(stats.reassembledPackets)
+        .arg(stats.skippedRecords).arg(stats.framingErrors));
+    
+    return true;
+}
+
+void FileSource::setPlaybackFilter(const PlaybackFilter& filter) {
+    // The reader thread holds on to the playback index while running
+    const bool resumeBatch = m_batchPlaying;
+    stopBatchPlayback();
+    
+    // Entry of the full index playback has reached; file positions are not
+    // in playback order for reassembled capture packets
+    uint64_t currentEntry = m_currentPacketIndex;
+    if (m_playbackFilter.isActive()) {
+        currentEntry = m_currentPacketIndex < m_filteredEntries.size() ? 
+            m_filteredEntries[m_currentPacketIndex] : m_packetIndex.size();
+    }
+    
+    m_playbackFilter = filter;
+    applyPlaybackFilter();
+    
+    // Carry on from the first matching packet at or after that entry
+    const auto& index = playbackIndex();
+    if (m_playbackFilter.isActive()) {
+        auto next = std::lower_bound(m_filteredEntries.begin(), m_filteredEntries.end(), currentEntry);
+        m_currentPacketIndex = static_cast<uint64_t>(std::distance(m_filteredEntries.begin(), next));
+    } else {
+        m_currentPacketIndex = std::min<uint64_t>(currentEntry, index.size());
+    }
+    m_fileStats.totalPackets = index.size();
+    updateFileStatistics();
+    
+    if (resumeBatch && !startBatchPlayback() && m_playbackState == PlaybackState::Playing) {
+        m_playbackTimer->start(calculatePlaybackInterval());
+    }
+    
+    emit fileStatisticsUpdated(m_fileStats);
+    
+    m_logger->info("FileSource", 
+        QString("Playback filter %1: %2 of %3 packets")
+        .arg(m_playbackFilter.isActive() ? "set" : "cleared")
+        .arg(index.size()).arg(m_packetIndex.size()));
+}
+
+void FileSource::applyPlaybackFilter() {
+    m_filteredIndex.clear();
+    m_filteredEntries.clear();
+    if (!m_playbackFilter.isActive() || !m_indexBuilt) {
+        return;
+    }
+    
+    m_filteredEntries = m_secondaryIndex.select(
+        m_playbackFilter.packetIds, m_playbackFilter.startTimestamp, m_playbackFilter.endTimestamp,
+        [this](uint64_t i) { return m_packetIndex[i].timestamp; });
+    
+    m_filteredIndex.reserve(m_filteredEntries.size());
+    for (uint32_t entry : m_filteredEntries) {
+        m_filteredIndex.push_back(m_packetIndex[entry]);
+    }
+}
+
 void FileSource::play() {
     if (!m_fileLoaded) {
         return;
@@ -299,12 +437,16 @@ void FileSource::play() {
     m_playbackStartTime = QDateTime::currentDateTime();
     m_fileStats.playbackStarted = m_playbackStartTime;
     
-    // Calculate playback interval
-    int interval = calculatePlaybackInterval();
-    m_playbackTimer->start(interval);
+    // Batch playback from the mapping when possible, one packet per tick otherwise
+    if (!startBatchPlayback()) {
+        int interval = calculatePlaybackInterval();
+        m_playbackTimer->start(interval);
+    }
     
     m_logger->info("FileSource", 
-        QString("Playback started at speed %1x").arg(m_config.playbackSpeed));
+        QString("Playback started at speed %1x (%2)")
+        .arg(m_config.playbackSpeed)
+        .arg(m_batchPlaying ? "batched" : "timer"));
 }
 
 void FileSource::pausePlayback() {
@@ -314,6 +456,7 @@ void FileSource::pausePlayback() {
     
     setPlaybackState(PlaybackState::Paused);
     m_playbackTimer->stop();
+    stopBatchPlayback();
     
     m_logger->info("FileSource", "Playback paused");
 }
@@ -325,6 +468,7 @@ void FileSource::stopPlayback() {
     
     setPlaybackState(PlaybackState::Stopped);
     m_playbackTimer->stop();
+    stopBatchPlayback();
     
     // Reset to beginning
     seekToPacket(0);
@@ -373,17 +517,30 @@ void FileSource::seekToPacket(uint64_t packetNumber) {
         return;
     }
     
-    if (packetNumber >= m_packetIndex.size()) {
-        packetNumber = m_packetIndex.size() - 1;
+    const auto& packets = playbackIndex();
+    if (packets.empty()) {
+        return;
     }
     
-    const auto& index = m_packetIndex[packetNumber];
+    if (packetNumber >= packets.size()) {
+        packetNumber = packets.size() - 1;
+    }
+    
+    // The reader thread is restarted at the new position
+    const bool resumeBatch = m_batchPlaying;
+    stopBatchPlayback();
+    
+    const auto& index = packets[packetNumber];
     m_currentPosition = index.position;
     m_currentPacketIndex = packetNumber;
     
     // Update statistics
     m_fileStats.currentPacket = packetNumber;
-    m_fileStats.playbackProgress = static_cast<double>(packetNumber) / m_packetIndex.size();
+    m_fileStats.playbackProgress = static_cast<double>(packetNumber) / packets.size();
+    
+    if (resumeBatch) {
+        startBatchPlayback();
+    }
     
     emit seekCompleted(packetNumber);
     emit fileStatisticsUpdated(m_fileStats);
@@ -397,7 +554,7 @@ void FileSource::seekToPosition(double position) {
         return;
     }
     
-    uint64_t packetNumber = static_cast<uint64_t>(position * m_packetIndex.size());
+    uint64_t packetNumber = static_cast<uint64_t>(position * playbackIndex().size());
     seekToPacket(packetNumber);
 }
 
@@ -408,15 +565,26 @@ void FileSource::seekToTimestamp(const QDateTime& timestamp) {
     
     uint64_t targetTimestamp = timestamp.toMSecsSinceEpoch();
     
-    // Binary search for closest timestamp
-    auto it = std::lower_bound(m_packetIndex.begin(), m_packetIndex.end(), 
-        PacketIndex(0, 0, targetTimestamp),
-        [](const PacketIndex& a, const PacketIndex& b) {
-            return a.timestamp < b.timestamp;
+    // First packet in file order at or after the timestamp; the skip index
+    // keeps this correct when timestamps are not monotonic
+    const int64_t first = m_secondaryIndex.findFirstAtOrAfter(targetTimestamp,
+        [this](uint64_t i) { return m_packetIndex[i].timestamp; });
+    if (first < 0) {
+        return;
+    }
+    
+    // Every earlier packet is older, so a filtered match cannot come before it
+    const auto& packets = playbackIndex();
+    auto it = std::lower_bound(packets.begin(), packets.end(), m_packetIndex[first].position,
+        [](const PacketIndex& entry, qint64 position) {
+            return entry.position < position;
         });
+    it = std::find_if(it, packets.end(), [targetTimestamp](const PacketIndex& entry) {
+        return entry.timestamp >= targetTimestamp;
+    });
     
-    if (it != m_packetIndex.end()) {
-        uint64_t packetNumber = std::distance(m_packetIndex.begin(), it);
+    if (it != packets.end()) {
+        uint64_t packetNumber = std::distance(packets.begin(), it);
         seekToPacket(packetNumber);
     }
 }
@@ -427,6 +595,10 @@ void FileSource::setPlaybackSpeed(double speed) {
     if (std::abs(m_config.playbackSpeed - speed) > 0.01) {
         m_config.playbackSpeed = speed;
         
+        if (m_playbackEngine) {
+            m_playbackEngine->setSpeed(speed);
+        }
+        
         // Update timer interval if playing
         if (m_playbackState == PlaybackState::Playing) {
             int interval = calculatePlaybackInterval();
@@ -442,11 +614,19 @@ void FileSource::setPlaybackSpeed(double speed) {
 
 void FileSource::setLoopPlayback(bool loop) {
     m_config.loopPlayback = loop;
+    
+    if (m_playbackEngine) {
+        m_playbackEngine->setLoop(loop);
+    }
 }
 
 void FileSource::setRealTimePlayback(bool realTime) {
     m_config.realTimePlayback = realTime;
     
+    if (m_playbackEngine) {
+        m_playbackEngine->setRealTime(realTime);
+    }
+    
     // Update timer if playing
     if (m_playbackState == PlaybackState::Playing) {
         int interval = calculatePlaybackInterval();
@@ -476,9 +656,9 @@ bool FileSource::readNextPacket() {
     }
     
     // Use indexed position if available
-    if (m_indexBuilt && m_currentPacketIndex < m_packetIndex.size()) {
-        const auto& index = m_packetIndex[m_currentPacketIndex];
-        auto packet = readPacketAtPosition(index.position);
+    if (m_indexBuilt && m_currentPacketIndex < playbackIndex().size()) {
+        const auto& index = playbackIndex()[m_currentPacketIndex];
+        auto packet = readPacketAtPosition(index.position, index.size);
         
         if (packet) {
             // Update position
@@ -496,62 +676,152 @@ bool FileSource::readNextPacket() {
     return false;
 }
 
-Packet::PacketPtr FileSource::readPacketAtPosition(qint64 position) {
-    if (!m_file || position >= m_fileSize) {
+Packet::PacketPtr FileSource::readPacketAtPosition(qint64 position, uint32_t knownSize) {
+    const qint64 dataEnd = m_fileSize + static_cast<qint64>(m_reassembledData.size());
+    if (!m_file || position < 0 || position >= dataEnd) {
         return nullptr;
     }
     
-    // Seek to position
-    if (!m_file->seek(position)) {
-        m_logger->error("FileSource", 
-            QString("Failed to seek to position %1").arg(position));
+    if (!m_packetFactory) {
+        m_logger->error("FileSource", "Packet factory not set");
         return nullptr;
     }
     
-    // Read packet header
-    QByteArray headerData = m_file->read(sizeof(Packet::PacketHeader));
-    if (headerData.size() != sizeof(Packet::PacketHeader)) {
-        return nullptr;
+    // Without an index entry the size comes from the header
+    uint32_t totalSize = knownSize;
+    if (totalSize == 0) {
+        Packet::PacketHeader header;
+        if (!readHeaderAt(position, header) || header.payloadSize > Packet::PacketHeader::MAX_PAYLOAD_SIZE) {
+            return nullptr;
+        }
+        totalSize = sizeof(Packet::PacketHeader) + header.payloadSize;
     }
     
-    const Packet::PacketHeader* header = 
-        reinterpret_cast<const Packet::PacketHeader*>(headerData.constData());
-    
-    // Calculate total packet size
-    uint32_t totalSize = sizeof(Packet::PacketHeader) + header->payloadSize;
-    
     // Validate packet size
-    if (totalSize < sizeof(Packet::PacketHeader) || totalSize > 65536) {
+    if (totalSize < sizeof(Packet::PacketHeader) || totalSize > 65536 || position + totalSize > dataEnd) {
         return nullptr;
     }
     
-    // Read complete packet
-    m_file->seek(position);
-    QByteArray packetData = m_file->read(totalSize);
-    if (packetData.size() != static_cast<int>(totalSize)) {
+    // Read the complete packet straight into pool memory
+    auto buffer = m_packetFactory->acquireBuffer(totalSize);
+    if (!buffer || buffer->capacity() < totalSize) {
+        m_logger->error("FileSource", 
+            QString("No pooled buffer for %1 byte packet at position %2").arg(totalSize).arg(position));
         return nullptr;
     }
     
-    return createPacketFromData(packetData);
-}
-
-Packet::PacketPtr FileSource::createPacketFromData(const QByteArray& data) {
-    if (!m_packetFactory) {
-        m_logger->error("FileSource", "Packet factory not set");
+    if (const uchar* source = dataAt(position, totalSize)) {
+        std::memcpy(buffer->bytes(), source, totalSize);
+    } else if (!m_file->seek(position) || 
+               m_file->read(reinterpret_cast<char*>(buffer->bytes()), totalSize) != static_cast<qint64>(totalSize)) {
+        m_logger->error("FileSource", 
+            QString("Failed to read %1 byte packet at position %2").arg(totalSize).arg(position));
         return nullptr;
     }
+    m_stats.bytesCopied += totalSize;
     
-    // Create packet using factory
-    auto result = m_packetFactory->createFromRawData(data.constData(), data.size());
+    auto result = m_packetFactory->commitBuffer(std::move(buffer), totalSize, m_config.headerByteOrder);
     if (!result.success) {
         m_logger->error("FileSource", 
             QString("Failed to create packet: %1").arg(QString::fromStdString(result.error)));
         return nullptr;
     }
     
-    auto packet = result.packet;
+    return result.packet;
+}
+
+bool FileSource::readHeaderAt(qint64 position, Packet::PacketHeader& header) {
+    if (const uchar* source = dataAt(position, sizeof(header))) {
+        std::memcpy(&header, source, sizeof(header));
+    } else if (position < 0 || position + static_cast<qint64>(sizeof(header)) > m_fileSize ||
+               !m_file || !m_file->seek(position) ||
+               m_file->peek(reinterpret_cast<char*>(&header), sizeof(header)) != static_cast<qint64>(sizeof(header))) {
+        return false;
+    }
     
-    return packet;
+    header.convertToHostOrder(m_config.headerByteOrder);
+    return true;
+}
+
+const uchar* FileSource::dataAt(qint64 position, qint64 length) const {
+    if (position < 0 || length < 0) {
+        return nullptr;
+    }
+    
+    if (position >= m_fileSize) {
+        const qint64 offset = position - m_fileSize;
+        return offset + length <= static_cast<qint64>(m_reassembledData.size()) ? 
+            m_reassembledData.data() + offset : nullptr;
+    }
+    
+    return m_mappedData && position + length <= m_fileSize ? m_mappedData + position : nullptr;
+}
+
+bool FileSource::startBatchPlayback() {
+    if (!m_config.memoryMapped || !m_mappedData || !m_indexBuilt || !m_packetFactory) {
+        return false;
+    }
+    
+    if (!m_playbackEngine || m_playbackEngine->packetFactory() != m_packetFactory) {
+        m_playbackEngine = std::make_unique<MappedPlaybackEngine>(m_packetFactory,
+            [this](std::vector<Packet::PacketPtr>& packets) {
+                uint64_t bytes = 0;
+                for (const auto& packet : packets) {
+                    bytes += packet->totalSize();
+                }
+                m_stats.bytesCopied += bytes;
+                deliverPacketBatch(packets);
+            },
+            [this](bool looping) { handleBatchPlaybackEnd(looping); });
+    }
+    
+    MappedPlaybackEngine::Configuration engineConfig;
+    engineConfig.batchSize = m_config.playbackBatchSize;
+    engineConfig.realTime = m_config.realTimePlayback;
+    engineConfig.speed = m_config.playbackSpeed;
+    engineConfig.loop = m_config.loopPlayback;
+    engineConfig.headerByteOrder = m_config.headerByteOrder;
+    
+    m_batchPlaying = m_playbackEngine->start(m_mappedData, m_fileSize, &playbackIndex(), 
+                                             m_currentPacketIndex, engineConfig,
+                                             m_reassembledData.data(), static_cast<qint64>(m_reassembledData.size()));
+    return m_batchPlaying;
+}
+
+void FileSource::stopBatchPlayback() {
+    if (!m_batchPlaying) {
+        return;
+    }
+    
+    m_playbackEngine->stop();
+    syncBatchPlaybackPosition();
+    m_packetsDelivered += m_playbackEngine->getStatistics().packetsDelivered.load();
+    m_batchPlaying = false;
+}
+
+void FileSource::syncBatchPlaybackPosition() {
+    if (!m_batchPlaying) {
+        return;
+    }
+    
+    const auto& packets = playbackIndex();
+    m_currentPacketIndex = std::min<uint64_t>(m_playbackEngine->position(), packets.size());
+    m_currentPosition = m_currentPacketIndex < packets.size() ? 
+        packets[m_currentPacketIndex].position : m_fileSize;
+}
+
+void FileSource::handleBatchPlaybackEnd(bool looping) {
+    // Runs on the reader thread; state changes belong to the owning thread
+    QMetaObject::invokeMethod(this, [this, looping]() {
+        emit endOfFileReached();
+        
+        if (looping) {
+            m_logger->debug("FileSource", "End of file reached, looping playback");
+        } else if (m_batchPlaying && !m_playbackEngine->isRunning()) {
+            stopPlayback();
+            m_logger->info("FileSource", "End of file reached, playback stopped");
+        }
+    }, Qt::QueuedConnection);
 }
 
 int FileSource::calculatePlaybackInterval() const {
@@ -582,6 +852,7 @@ void FileSource::updateFileStatistics() {
         return;
     }
     
+    syncBatchPlaybackPosition();
     m_fileStats.currentPacket = m_currentPacketIndex;
     
     if (m_fileStats.totalPackets > 0) {
@@ -623,7 +894,7 @@ bool FileSource::isAtEndOfFile() const {
         return true;
     }
     
-    return m_currentPacketIndex >= m_packetIndex.size();
+    return m_currentPacketIndex >= playbackIndex().size();
 }
 
 bool FileSource::isAtBeginningOfFile() const {
@@ -633,6 +904,12 @@ bool FileSource::isAtBeginningOfFile() const {
 void FileSource::setFileConfig(const FileSourceConfig& config) {
     m_config = config;
     
+    if (m_playbackEngine) {
+        m_playbackEngine->setSpeed(m_config.playbackSpeed);
+        m_playbackEngine->setRealTime(m_config.realTimePlayback);
+        m_playbackEngine->setLoop(m_config.loopPlayback);
+    }
+    
     // Update playback if currently playing
     if (m_playbackState == PlaybackState::Playing) {
         int interval = calculatePlaybackInterval();
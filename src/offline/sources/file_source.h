@@ -1,8 +1,11 @@
 #pragma once
 
 #include "../../packet/sources/packet_source.h"
+#include "mapped_playback_engine.h"
+#include "packet_secondary_index.h"
 #include "../../concurrent/spsc_ring_buffer.h"
 #include "../../logging/logger.h"
+#include "../../parser/layout/byte_order.h"
 
 #include <QFile>
 #include <QTimer>
@@ -33,15 +36,42 @@ struct FileSourceConfig {
     bool loopPlayback;                 ///< Loop playback when reaching end
     bool realTimePlayback;             ///< Use original timing or play as fast as possible
     int bufferSize;                    ///< Internal packet buffer size
+    bool memoryMapped;                 ///< Map the file and play back in batches on a reader thread
+    int playbackBatchSize;             ///< Maximum packets per batch in memory-mapped playback
+    Parser::Layout::ByteOrder headerByteOrder; ///< Byte order of the recorded packet headers; set before loading
     
     FileSourceConfig()
         : playbackSpeed(1.0)
         , loopPlayback(false)
         , realTimePlayback(true)
         , bufferSize(1000)
+        , memoryMapped(true)
+        , playbackBatchSize(256)
+        , headerByteOrder(Parser::Layout::ByteOrder::Native)
     {}
 };
 
+/**
+ * @brief Subset of a recording to play back
+ * 
+ * A packet is played if its ID is in packetIds (or packetIds is empty) and
+ * its timestamp lies in [startTimestamp, endTimestamp].
+ */
+struct PlaybackFilter {
+    std::vector<uint32_t> packetIds;    ///< IDs to play; empty plays every ID
+    uint64_t startTimestamp;            ///< First timestamp to play (inclusive)
+    uint64_t endTimestamp;              ///< Last timestamp to play (inclusive)
+    
+    PlaybackFilter()
+        : startTimestamp(0)
+        , endTimestamp(UINT64_MAX)
+    {}
+    
+    bool isActive() const {
+        return !packetIds.empty() || startTimestamp > 0 || endTimestamp < UINT64_MAX;
+    }
+};
+
 /**
  * @brief File-based packet source for offline data playback
  * 
@@ -50,6 +80,12 @@ struct FileSourceConfig {
  * and variable speed playback. Supports both real-time playback
  * (matching original timing) and fast playback modes.
  * 
+ * When the file can be memory-mapped, playback runs on a reader thread
+ * that delivers packets in batches straight from the mapping (see
+ * MappedPlaybackEngine). Real-time mode paces batches by the recorded
+ * timestamps; fast mode runs as fast as the consumers accept packets.
+ * Otherwise playback falls back to one packet per timer tick.
+ * 
  * Key Features:
  * - Drag-and-drop file support
  * - Memory-mapped file access for large files
@@ -58,7 +94,16 @@ struct FileSourceConfig {
  * - Step-by-step packet navigation
  * - Timeline scrubbing
  * - Loop playback support
+ * - Filtered playback by packet ID set and time window
  * - Progress tracking
+ * 
+ * With a playback filter set, packet numbers (seeking, statistics and
+ * progress) count only the packets that pass the filter.
+ * 
+ * PCAP and PCAPNG captures are read in place: packets are located inside
+ * the capture records and played from the mapping with their capture
+ * timestamps. Packets split across TCP segments are kept reassembled in
+ * memory.
  */
 class FileSource : public Packet::PacketSource {
     Q_OBJECT
@@ -70,7 +115,7 @@ public:
     enum class FileFormat {
         AutoDetect,     ///< Automatically detect format
         Binary,         ///< Raw binary packet data
-        PCAP,           ///< PCAP capture format
+        PCAP,           ///< PCAP or PCAPNG network capture (see PcapReader)
         Custom          ///< Custom application format
     };
     
@@ -129,6 +174,11 @@ public:
      */
     PlaybackState getPlaybackState() const { return m_playbackState; }
     
+    /**
+     * @brief Format of the loaded file
+     */
+    FileFormat getFileFormat() const { return m_fileFormat; }
+    
     /**
      * @brief Get file statistics
      */
@@ -158,6 +208,49 @@ public:
      * @brief Check if at beginning of file
      */
     bool isAtBeginningOfFile() const;
+    
+    /**
+     * @brief Check if the loaded file is memory-mapped
+     */
+    bool isMemoryMapped() const { return m_mappedData != nullptr; }
+    
+    /**
+     * @brief Check if the batch playback thread is running
+     */
+    bool isBatchPlaybackActive() const { return m_playbackEngine && m_playbackEngine->isRunning(); }
+    
+    /**
+     * @brief Get batch playback statistics
+     * @return nullptr if batch playback has not been used since the file was loaded
+     */
+    const MappedPlaybackEngine::Statistics* getBatchPlaybackStatistics() const {
+        return m_playbackEngine ? &m_playbackEngine->getStatistics() : nullptr;
+    }
+    
+    /**
+     * @brief Play back only packets passing @p filter
+     * 
+     * The matching packets are looked up in the packet-ID posting lists and
+     * timestamp skip index, so playback never reads the packets filtered
+     * out. Playback continues from the first matching packet at or after
+     * the current file position. Kept across loadFile().
+     */
+    void setPlaybackFilter(const PlaybackFilter& filter);
+    
+    /**
+     * @brief Play back every packet again
+     */
+    void clearPlaybackFilter() { setPlaybackFilter(PlaybackFilter()); }
+    
+    /**
+     * @brief Get current playback filter
+     */
+    const PlaybackFilter& getPlaybackFilter() const { return m_playbackFilter; }
+    
+    /**
+     * @brief Get number of packets that playback will deliver per pass
+     */
+    uint64_t getPlaybackPacketCount() const { return playbackIndex().size(); }
 
 public slots:
     /**
@@ -297,19 +390,32 @@ private:
     bool indexPackets();
     
     /**
-     * @brief Read next packet from file
+     * @brief Index the packets carried in a PCAP or PCAPNG capture
      */
-    bool readNextPacket();
+    bool indexCapture();
     
     /**
-     * @brief Read packet at specific position
+     * @brief Rebuild the filtered index from the current playback filter
      */
-    Packet::PacketPtr readPacketAtPosition(qint64 position);
+    void applyPlaybackFilter();
     
     /**
-     * @brief Create packet from file data
+     * @brief Packets played in order: the filtered index, or every packet
      */
-    Packet::PacketPtr createPacketFromData(const QByteArray& data);
+    const std::vector<PlaybackIndexEntry>& playbackIndex() const {
+        return m_playbackFilter.isActive() ? m_filteredIndex : m_packetIndex;
+    }
+    
+    /**
+     * @brief Read next packet from file
+     */
+    bool readNextPacket();
+    
+    /**
+     * @brief Read packet at specific position directly into a pooled buffer
+     * @param knownSize Total packet size from the index, or 0 to read it from the header
+     */
+    Packet::PacketPtr readPacketAtPosition(qint64 position, uint32_t knownSize = 0);
     
     /**
      * @brief Calculate playback timing
@@ -341,6 +447,37 @@ private:
      */
     bool isValidPacketAtPosition(qint64 position) const;
     
+    /**
+     * @brief Read a packet header from the mapping, or the file if unmapped, in host order
+     */
+    bool readHeaderAt(qint64 position, Packet::PacketHeader& header);
+    
+    /**
+     * @brief Mapped or reassembled bytes at @p position, or nullptr if out of range
+     */
+    const uchar* dataAt(qint64 position, qint64 length) const;
+    
+    /**
+     * @brief Start batch playback from the current packet
+     * @return False if the timer-driven path has to be used instead
+     */
+    bool startBatchPlayback();
+    
+    /**
+     * @brief Stop batch playback and take over its position
+     */
+    void stopBatchPlayback();
+    
+    /**
+     * @brief Copy the batch playback position into the playback state
+     */
+    void syncBatchPlaybackPosition();
+    
+    /**
+     * @brief Handle the reader thread reaching the end of the file
+     */
+    void handleBatchPlaybackEnd(bool looping);
+    
     // File configuration and state
     FileSourceConfig m_config;
     QString m_currentFilename;
@@ -350,27 +487,29 @@ private:
     
     // File handling
     std::unique_ptr<QFile> m_file;
+    uchar* m_mappedData;
     qint64 m_fileSize;
+    std::vector<uchar> m_reassembledData;       ///< Capture packets split across segments, positioned past m_fileSize
     qint64 m_currentPosition;
     
     // Packet indexing
-    struct PacketIndex {
-        qint64 position;        ///< File position
-        uint32_t size;          ///< Packet size
-        uint64_t timestamp;     ///< Packet timestamp (if available)
-        
-        PacketIndex() : position(0), size(0), timestamp(0) {}
-        PacketIndex(qint64 pos, uint32_t sz, uint64_t ts = 0) 
-            : position(pos), size(sz), timestamp(ts) {}
-    };
+    using PacketIndex = PlaybackIndexEntry;
     
     std::vector<PacketIndex> m_packetIndex;
-    uint64_t m_currentPacketIndex;
+    PacketSecondaryIndex m_secondaryIndex;      ///< ID postings and time blocks over m_packetIndex
+    uint64_t m_currentPacketIndex;              ///< Next packet in playbackIndex()
     bool m_indexBuilt;
     
+    // Filtered playback
+    PlaybackFilter m_playbackFilter;
+    std::vector<PacketIndex> m_filteredIndex;
+    std::vector<uint32_t> m_filteredEntries;    ///< m_packetIndex entry of every m_filteredIndex entry
+    
     // Playback timing
     std::unique_ptr<QTimer> m_playbackTimer;
     std::unique_ptr<QTimer> m_progressTimer;
+    std::unique_ptr<MappedPlaybackEngine> m_playbackEngine;
+    bool m_batchPlaying;                ///< Reader thread owns the playback position
     QDateTime m_playbackStartTime;
     uint64_t m_packetsDelivered;
     
@@ -0,0 +1,229 @@
+#include "mapped_playback_engine.h"
+#include "../../packet/core/packet_header.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace Monitor {
+namespace Offline {
+
+MappedPlaybackEngine::MappedPlaybackEngine(Packet::PacketFactory* factory, BatchCallback callback,
+                                           EndCallback endCallback)
+    : m_factory(factory)
+    , m_callback(std::move(callback))
+    , m_endCallback(std::move(endCallback))
+    , m_logger(Logging::Logger::instance())
+    , m_data(nullptr)
+    , m_size(0)
+    , m_extraData(nullptr)
+    , m_extraSize(0)
+    , m_index(nullptr)
+    , m_batchSize(1)
+    , m_pacingWindowNs(0)
+    , m_headerByteOrder(Parser::Layout::ByteOrder::Native)
+{
+}
+
+MappedPlaybackEngine::~MappedPlaybackEngine() {
+    stop();
+}
+
+bool MappedPlaybackEngine::start(const uchar* data, qint64 size, const std::vector<PlaybackIndexEntry>* index,
+                                 uint64_t startPacket, const Configuration& config,
+                                 const uchar* extraData, qint64 extraSize) {
+    stop();
+
+    if (!m_factory || !m_callback || !data || !index) {
+        m_logger->error("MappedPlaybackEngine", "Playback needs a packet factory, callback, mapping and index");
+        return false;
+    }
+
+    m_data = data;
+    m_size = size;
+    m_extraData = extraData;
+    m_extraSize = extraData ? extraSize : 0;
+    m_index = index;
+    m_batchSize = std::clamp(config.batchSize, 1, 65536);
+    m_pacingWindowNs = static_cast<int64_t>(std::max(config.pacingWindowUs, 0)) * 1000;
+    m_headerByteOrder = config.headerByteOrder;
+    m_speed.store(config.speed);
+    m_realTime.store(config.realTime);
+    m_loop.store(config.loop);
+    m_position.store(startPacket);
+
+    m_stats.reset();
+    m_stopRequested.store(false);
+    m_running.store(true);
+    m_thread = std::thread(&MappedPlaybackEngine::playbackLoop, this);
+    return true;
+}
+
+void MappedPlaybackEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopRequested.store(true);
+    }
+    m_wakeCondition.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_running.store(false);
+}
+
+void MappedPlaybackEngine::setSpeed(double speed) {
+    m_speed.store(speed);
+    notifyPacingChange();
+}
+
+void MappedPlaybackEngine::setRealTime(bool realTime) {
+    m_realTime.store(realTime);
+    notifyPacingChange();
+}
+
+void MappedPlaybackEngine::notifyPacingChange() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_pacingGeneration++;
+    }
+    m_wakeCondition.notify_all();
+}
+
+void MappedPlaybackEngine::playbackLoop() {
+    using Clock = std::chrono::steady_clock;
+
+    const std::vector<PlaybackIndexEntry>& index = *m_index;
+    std::vector<Packet::PacketPtr> packets;
+    packets.reserve(static_cast<size_t>(m_batchSize));
+
+    // Capture-time offset of the next packet, accumulated from clamped
+    // inter-packet gaps so out-of-order or idle stretches do not stall playback
+    auto gapBefore = [&index](uint64_t i) -> int64_t {
+        const int64_t gap = static_cast<int64_t>(index[i].timestamp - index[i - 1].timestamp);
+        return std::clamp<int64_t>(gap, 0, MAX_PACKET_GAP_NS);
+    };
+
+    uint64_t cursor = m_position.load();
+    int64_t captureNs = 0;
+    bool rebase = true;
+    uint32_t generation = 0;
+    bool realTime = true;
+    double speed = 1.0;
+    Clock::time_point baseWall;
+    int64_t baseCaptureNs = 0;
+
+    auto dueAt = [&](int64_t capture) {
+        return baseWall + std::chrono::nanoseconds(static_cast<int64_t>((capture - baseCaptureNs) / speed));
+    };
+
+    while (!m_stopRequested.load(std::memory_order_relaxed)) {
+        if (cursor >= index.size()) {
+            const bool looping = m_loop.load() && !index.empty();
+            if (!looping) {
+                // Observers reacting to the end must already see playback as finished
+                m_running.store(false);
+            }
+            if (m_endCallback) {
+                m_endCallback(looping);
+            }
+            if (!looping) {
+                break;
+            }
+            cursor = 0;
+            captureNs = 0;
+            rebase = true;
+            m_position.store(0);
+        }
+
+        // Speed or mode changes restart the schedule from the next packet
+        const uint32_t currentGeneration = m_pacingGeneration.load();
+        if (rebase || currentGeneration != generation) {
+            generation = currentGeneration;
+            realTime = m_realTime.load();
+            speed = std::max(m_speed.load(), 0.001);
+            baseWall = Clock::now();
+            baseCaptureNs = captureNs;
+            rebase = false;
+        }
+
+        Clock::time_point horizon = Clock::time_point::max();
+        if (realTime) {
+            const auto now = Clock::now();
+            const auto due = dueAt(captureNs);
+            if (due > now) {
+                std::unique_lock<std::mutex> lock(m_wakeMutex);
+                m_wakeCondition.wait_until(lock, due, [this, generation]() {
+                    return m_stopRequested.load() || m_pacingGeneration.load() != generation;
+                });
+                m_stats.pacingSleeps++;
+                continue;
+            }
+            horizon = now + std::chrono::nanoseconds(m_pacingWindowNs);
+        }
+
+        bool exhausted = false;
+        uint64_t bytes = 0;
+        while (packets.size() < static_cast<size_t>(m_batchSize) && cursor < index.size() &&
+               (!realTime || dueAt(captureNs) <= horizon)) {
+            const size_t before = packets.size();
+            if (!appendPacket(index[cursor], packets)) {
+                exhausted = true;
+                break;
+            }
+            if (packets.size() > before) {
+                bytes += index[cursor].size;
+            }
+            ++cursor;
+            if (cursor < index.size()) {
+                captureNs += gapBefore(cursor);
+            }
+        }
+
+        if (!packets.empty()) {
+            m_stats.batchesDelivered++;
+            m_stats.packetsDelivered += packets.size();
+            m_stats.bytesDelivered += bytes;
+            m_callback(packets);
+            packets.clear();
+        }
+        m_position.store(cursor);
+
+        if (exhausted) {
+            // Pool exhausted: give consumers a moment to release buffers
+            m_stats.bufferExhaustion++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    m_running.store(false);
+}
+
+bool MappedPlaybackEngine::appendPacket(const PlaybackIndexEntry& entry, std::vector<Packet::PacketPtr>& packets) {
+    // Positions past the mapping address the extra data
+    const bool extra = entry.position >= m_size;
+    const qint64 offset = extra ? entry.position - m_size : entry.position;
+    if (entry.position < 0 || offset + static_cast<qint64>(entry.size) > (extra ? m_extraSize : m_size) ||
+        entry.size < Packet::PACKET_HEADER_SIZE || entry.size > Packet::PacketBuffer::maxBufferSize()) {
+        m_stats.invalidPackets++;
+        return true;
+    }
+
+    auto buffer = m_factory->acquireBuffer(entry.size);
+    if (!buffer) {
+        return false;
+    }
+
+    std::memcpy(buffer->bytes(), (extra ? m_extraData : m_data) + offset, entry.size);
+
+    auto result = m_factory->commitBuffer(std::move(buffer), entry.size, m_headerByteOrder);
+    if (!result.success) {
+        m_stats.invalidPackets++;
+        return true;
+    }
+
+    packets.push_back(std::move(result.packet));
+    return true;
+}
+
+} // namespace Offline
+} // namespace Monitor
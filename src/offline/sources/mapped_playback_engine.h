@@ -0,0 +1,180 @@
+#pragma once
+
+#include "../../packet/core/packet.h"
+#include "../../packet/core/packet_factory.h"
+#include "../../logging/logger.h"
+
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Monitor {
+namespace Offline {
+
+/**
+ * @brief Location and capture time of one packet in a recording
+ */
+struct PlaybackIndexEntry {
+    qint64 position;        ///< File position
+    uint32_t size;          ///< Packet size
+    uint64_t timestamp;     ///< Packet timestamp (if available)
+
+    PlaybackIndexEntry() : position(0), size(0), timestamp(0) {}
+    PlaybackIndexEntry(qint64 pos, uint32_t sz, uint64_t ts = 0)
+        : position(pos), size(sz), timestamp(ts) {}
+};
+
+/**
+ * @brief Batch playback of a memory-mapped recording on a reader thread
+ *
+ * Walks the packet index of a mapped file and copies packets straight from
+ * the mapping into pooled buffers, handing them to the callback in batches.
+ * No file I/O happens on the playback path.
+ *
+ * In fast mode batches are produced back to back, limited only by memory
+ * bandwidth and the consumer. In real-time mode each packet is due at its
+ * capture-time offset divided by the playback speed; every batch collects
+ * the packets due within the pacing window and the thread then sleeps once
+ * until the next one is due, rather than once per packet.
+ *
+ * The mapping, extra data and index passed to start() must stay untouched
+ * until stop() returns.
+ */
+class MappedPlaybackEngine {
+public:
+    /**
+     * @brief Callback invoked on the reader thread for every non-empty batch
+     */
+    using BatchCallback = std::function<void(std::vector<Packet::PacketPtr>& packets)>;
+
+    /**
+     * @brief Callback invoked on the reader thread at the end of the index
+     * @param looping True if playback wraps to the first packet and carries on
+     */
+    using EndCallback = std::function<void(bool looping)>;
+
+    /**
+     * @brief Playback configuration
+     */
+    struct Configuration {
+        int batchSize = 256;            ///< Maximum packets per batch
+        bool realTime = true;           ///< Pace by capture timestamps
+        double speed = 1.0;             ///< Real-time speed multiplier
+        bool loop = false;              ///< Wrap to the first packet at the end
+        int pacingWindowUs = 1000;      ///< Packets due within this window share a batch
+        Parser::Layout::ByteOrder headerByteOrder = Parser::Layout::ByteOrder::Native;  ///< Byte order of the recorded packet headers
+    };
+
+    /**
+     * @brief Playback statistics
+     */
+    struct Statistics {
+        std::atomic<uint64_t> batchesDelivered{0};
+        std::atomic<uint64_t> packetsDelivered{0};
+        std::atomic<uint64_t> bytesDelivered{0};
+        std::atomic<uint64_t> pacingSleeps{0};        ///< Sleeps waiting for the next due packet
+        std::atomic<uint64_t> invalidPackets{0};      ///< Index entries rejected by the factory
+        std::atomic<uint64_t> bufferExhaustion{0};    ///< Batches cut short by an empty pool
+
+        double getAverageBatchSize() const {
+            uint64_t batches = batchesDelivered.load();
+            if (batches == 0) return 0.0;
+            return static_cast<double>(packetsDelivered.load()) / batches;
+        }
+
+        void reset() {
+            batchesDelivered = 0;
+            packetsDelivered = 0;
+            bytesDelivered = 0;
+            pacingSleeps = 0;
+            invalidPackets = 0;
+            bufferExhaustion = 0;
+        }
+    };
+
+    MappedPlaybackEngine(Packet::PacketFactory* factory, BatchCallback callback, EndCallback endCallback);
+    ~MappedPlaybackEngine();
+
+    MappedPlaybackEngine(const MappedPlaybackEngine&) = delete;
+    MappedPlaybackEngine& operator=(const MappedPlaybackEngine&) = delete;
+
+    /**
+     * @brief Start playback from @p startPacket
+     * @param data Start of the mapped file
+     * @param size Size of the mapping in bytes
+     * @param index Packet index into the mapping
+     * @param extraData Packets that are not contiguous in the file, addressed
+     *        by index positions at or past @p size (reassembled captures)
+     * @param extraSize Size of @p extraData in bytes
+     */
+    bool start(const uchar* data, qint64 size, const std::vector<PlaybackIndexEntry>* index,
+               uint64_t startPacket, const Configuration& config,
+               const uchar* extraData = nullptr, qint64 extraSize = 0);
+
+    /**
+     * @brief Stop the reader thread and wait for it to exit
+     */
+    void stop();
+
+    /**
+     * @brief Whether the reader thread is producing packets
+     */
+    bool isRunning() const { return m_running.load(); }
+
+    /**
+     * @brief Index of the next packet to be delivered
+     */
+    uint64_t position() const { return m_position.load(); }
+
+    void setSpeed(double speed);
+    void setRealTime(bool realTime);
+    void setLoop(bool loop) { m_loop.store(loop); }
+
+    Packet::PacketFactory* packetFactory() const { return m_factory; }
+
+    const Statistics& getStatistics() const { return m_stats; }
+
+private:
+    void playbackLoop();
+    void notifyPacingChange();
+    bool appendPacket(const PlaybackIndexEntry& entry, std::vector<Packet::PacketPtr>& packets);
+
+    Packet::PacketFactory* m_factory;
+    BatchCallback m_callback;
+    EndCallback m_endCallback;
+    Logging::Logger* m_logger;
+
+    const uchar* m_data;
+    qint64 m_size;
+    const uchar* m_extraData;
+    qint64 m_extraSize;
+    const std::vector<PlaybackIndexEntry>* m_index;
+    int m_batchSize;
+    int64_t m_pacingWindowNs;
+    Parser::Layout::ByteOrder m_headerByteOrder;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_stopRequested{false};
+    std::atomic<uint64_t> m_position{0};
+    std::atomic<double> m_speed{1.0};
+    std::atomic<bool> m_realTime{true};
+    std::atomic<bool> m_loop{false};
+    std::atomic<uint32_t> m_pacingGeneration{0};   ///< Bumped when speed or mode changes
+
+    // Pacing sleeps wait here so stop() and speed changes take effect at once
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+
+    Statistics m_stats;
+
+    static constexpr int64_t MAX_PACKET_GAP_NS = 10000000000LL;  // Longer capture gaps are shortened
+};
+
+} // namespace Offline
+} // namespace Monitor
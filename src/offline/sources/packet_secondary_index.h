@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Monitor {
+namespace Offline {
+
+/**
+ * @brief Packet-ID posting lists and a sparse time/sequence skip index
+ *
+ * Built alongside a packet index that stores entries in file order. For
+ * every packet ID it keeps the ascending list of entry numbers carrying
+ * that ID, and for every block of BLOCK_SIZE consecutive entries the
+ * timestamp and sequence ranges seen in the block. Queries skip whole
+ * blocks that cannot match and only look at individual entries in blocks
+ * that straddle a bound, so they stay correct when timestamps are not
+ * monotonic without paying for a full scan.
+ *
+ * Per-entry fields live in the owner's index; queries that need them take
+ * an accessor returning the field for an entry number.
+ *
+ * Not thread-safe: the owner serialises access.
+ */
+class PacketSecondaryIndex {
+public:
+    static constexpr uint32_t BLOCK_SIZE = 1024;
+
+    /**
+     * @brief Field ranges of BLOCK_SIZE consecutive entries
+     */
+    struct Block {
+        uint64_t minTimestamp;
+        uint64_t maxTimestamp;
+        uint32_t minSequence;
+        uint32_t maxSequence;
+    };
+
+    using PostingList = std::vector<uint32_t>;
+    using PostingMap = std::unordered_map<uint32_t, PostingList>;
+
+    void clear() {
+        m_count = 0;
+        m_blocks.clear();
+        m_prefixMaxTimestamp.clear();
+        m_postings.clear();
+    }
+
+    /**
+     * @brief Number of entries indexed
+     */
+    uint64_t size() const { return m_count; }
+
+    /**
+     * @brief Add the next entry in file order
+     */
+    void append(uint32_t packetId, uint64_t timestamp, uint32_t sequence) {
+        const uint32_t entry = static_cast<uint32_t>(m_count++);
+
+        if (entry % BLOCK_SIZE == 0) {
+            m_blocks.push_back(Block{timestamp, timestamp, sequence, sequence});
+            const uint64_t previousMax = m_prefixMaxTimestamp.empty() ? 0 : m_prefixMaxTimestamp.back();
+            m_prefixMaxTimestamp.push_back(std::max(previousMax, timestamp));
+        } else {
+            Block& block = m_blocks.back();
+            block.minTimestamp = std::min(block.minTimestamp, timestamp);
+            block.maxTimestamp = std::max(block.maxTimestamp, timestamp);
+            block.minSequence = std::min(block.minSequence, sequence);
+            block.maxSequence = std::max(block.maxSequence, sequence);
+            m_prefixMaxTimestamp.back() = std::max(m_prefixMaxTimestamp.back(), timestamp);
+        }
+
+        m_postings[packetId].push_back(entry);
+    }
+
+    /**
+     * @brief Replace the contents with previously saved blocks and postings
+     */
+    void restore(uint64_t count, std::vector<Block> blocks, PostingMap postings) {
+        m_count = count;
+        m_blocks = std::move(blocks);
+        m_postings = std::move(postings);
+
+        m_prefixMaxTimestamp.clear();
+        m_prefixMaxTimestamp.reserve(m_blocks.size());
+        uint64_t runningMax = 0;
+        for (const Block& block : m_blocks) {
+            runningMax = std::max(runningMax, block.maxTimestamp);
+            m_prefixMaxTimestamp.push_back(runningMax);
+        }
+    }
+
+    const std::vector<Block>& blocks() const { return m_blocks; }
+    const PostingMap& postings() const { return m_postings; }
+
+    /**
+     * @brief Ascending entry numbers of packets with @p packetId, or nullptr
+     */
+    const PostingList* postingList(uint32_t packetId) const {
+        auto it = m_postings.find(packetId);
+        return it != m_postings.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * @brief First entry in file order with a timestamp at or after @p timestamp
+     * @return Entry number, or -1 if there is none
+     */
+    template<typename TimestampOf>
+    int64_t findFirstAtOrAfter(uint64_t timestamp, TimestampOf timestampOf) const {
+        // Every block before this one only holds earlier timestamps
+        const size_t block = firstBlockReaching(timestamp);
+        if (block >= m_blocks.size()) {
+            return -1;
+        }
+
+        const uint64_t end = blockEnd(block);
+        for (uint64_t i = static_cast<uint64_t>(block) * BLOCK_SIZE; i < end; ++i) {
+            if (timestampOf(i) >= timestamp) {
+                return static_cast<int64_t>(i);
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief First entry in file order with sequence number @p sequence
+     * @return Entry number, or -1 if there is none
+     */
+    template<typename SequenceOf>
+    int64_t findSequence(uint32_t sequence, SequenceOf sequenceOf) const {
+        for (size_t block = 0; block < m_blocks.size(); ++block) {
+            if (sequence < m_blocks[block].minSequence || sequence > m_blocks[block].maxSequence) {
+                continue;
+            }
+            const uint64_t end = blockEnd(block);
+            for (uint64_t i = static_cast<uint64_t>(block) * BLOCK_SIZE; i < end; ++i) {
+                if (sequenceOf(i) == sequence) {
+                    return static_cast<int64_t>(i);
+                }
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * @brief Entries in file order whose ID is in @p packetIds and whose
+     * timestamp lies in [@p startTimestamp, @p endTimestamp]
+     * @param packetIds IDs to keep; empty keeps every ID
+     */
+    template<typename TimestampOf>
+    std::vector<uint32_t> select(const std::vector<uint32_t>& packetIds, uint64_t startTimestamp,
+                                 uint64_t endTimestamp, TimestampOf timestampOf) const {
+        std::vector<uint32_t> selected;
+        if (startTimestamp > endTimestamp) {
+            return selected;
+        }
+
+        const size_t firstBlock = firstBlockReaching(startTimestamp);
+        if (firstBlock >= m_blocks.size()) {
+            return selected;
+        }
+
+        auto inWindow = [&](uint32_t entry) {
+            const Block& block = m_blocks[entry / BLOCK_SIZE];
+            if (block.maxTimestamp < startTimestamp || block.minTimestamp > endTimestamp) {
+                return false;
+            }
+            if (block.minTimestamp >= startTimestamp && block.maxTimestamp <= endTimestamp) {
+                return true;
+            }
+            const uint64_t timestamp = timestampOf(entry);
+            return timestamp >= startTimestamp && timestamp <= endTimestamp;
+        };
+
+        if (packetIds.empty()) {
+            for (size_t block = firstBlock; block < m_blocks.size(); ++block) {
+                const uint64_t end = blockEnd(block);
+                for (uint64_t i = static_cast<uint64_t>(block) * BLOCK_SIZE; i < end; ++i) {
+                    if (inWindow(static_cast<uint32_t>(i))) {
+                        selected.push_back(static_cast<uint32_t>(i));
+                    }
+                }
+            }
+            return selected;
+        }
+
+        const uint32_t firstEntry = static_cast<uint32_t>(firstBlock * BLOCK_SIZE);
+        size_t lists = 0;
+        for (uint32_t packetId : packetIds) {
+            const PostingList* postings = postingList(packetId);
+            if (!postings) {
+                continue;
+            }
+            for (auto it = std::lower_bound(postings->begin(), postings->end(), firstEntry); it != postings->end(); ++it) {
+                if (inWindow(*it)) {
+                    selected.push_back(*it);
+                }
+            }
+            ++lists;
+        }
+
+        if (lists > 1) {
+            std::sort(selected.begin(), selected.end());
+            selected.erase(std::unique(selected.begin(), selected.end()), selected.end());
+        }
+        return selected;
+    }
+
+private:
+    size_t firstBlockReaching(uint64_t timestamp) const {
+        auto it = std::lower_bound(m_prefixMaxTimestamp.begin(), m_prefixMaxTimestamp.end(), timestamp);
+        return static_cast<size_t>(it - m_prefixMaxTimestamp.begin());
+    }
+
+    uint64_t blockEnd(size_t block) const {
+        return std::min<uint64_t>(m_count, (static_cast<uint64_t>(block) + 1) * BLOCK_SIZE);
+    }
+
+    uint64_t m_count = 0;
+    std::vector<Block> m_blocks;
+    std::vector<uint64_t> m_prefixMaxTimestamp;     ///< Largest timestamp up to and including each block
+    PostingMap m_postings;
+};
+
+} // namespace Offline
+} // namespace Monitor
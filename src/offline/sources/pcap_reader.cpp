@@ -0,0 +1,741 @@
+#include "pcap_reader.h"
+#include "../../packet/core/packet_header.h"
+#include <QFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace Monitor {
+namespace Offline {
+
+namespace {
+
+// PCAPNG block types
+constexpr uint32_t BLOCK_INTERFACE_DESCRIPTION = 0x00000001;
+constexpr uint32_t BLOCK_OBSOLETE_PACKET = 0x00000002;
+constexpr uint32_t BLOCK_SIMPLE_PACKET = 0x00000003;
+constexpr uint32_t BLOCK_ENHANCED_PACKET = 0x00000006;
+
+// PCAPNG interface options
+constexpr uint16_t OPTION_END = 0;
+constexpr uint16_t OPTION_TIMESTAMP_RESOLUTION = 9;
+constexpr uint16_t OPTION_TIMESTAMP_OFFSET = 14;
+
+// Link-layer header types
+constexpr uint32_t LINKTYPE_NULL = 0;
+constexpr uint32_t LINKTYPE_ETHERNET = 1;
+constexpr uint32_t LINKTYPE_RAW = 101;
+constexpr uint32_t LINKTYPE_LOOP = 108;
+constexpr uint32_t LINKTYPE_LINUX_SLL = 113;
+constexpr uint32_t LINKTYPE_IPV4 = 228;
+constexpr uint32_t LINKTYPE_IPV6 = 229;
+constexpr uint32_t LINKTYPE_LINUX_SLL2 = 276;
+
+constexpr uint16_t ETHERTYPE_IPV4 = 0x0800;
+constexpr uint16_t ETHERTYPE_IPV6 = 0x86DD;
+constexpr uint16_t ETHERTYPE_VLAN = 0x8100;
+constexpr uint16_t ETHERTYPE_QINQ = 0x88A8;
+constexpr uint16_t ETHERTYPE_VLAN_LEGACY = 0x9100;
+
+constexpr uint8_t PROTOCOL_TCP = 6;
+constexpr uint8_t PROTOCOL_UDP = 17;
+
+constexpr uint8_t TCP_FIN = 0x01;
+constexpr uint8_t TCP_SYN = 0x02;
+constexpr uint8_t TCP_RST = 0x04;
+
+constexpr uint64_t NANOSECONDS_PER_SECOND = 1000000000ULL;
+
+// Plausible headers that must follow a candidate before framing resumes on it
+constexpr uint32_t RESYNC_CONFIRMATIONS = 2;
+
+uint16_t networkOrder16(const uchar* p) {
+    return qFromBigEndian<quint16>(p);
+}
+
+uint32_t networkOrder32(const uchar* p) {
+    return qFromBigEndian<quint32>(p);
+}
+
+/**
+ * @brief Ethertype of the link-layer payload, or 0 if not IP
+ */
+uint16_t ethertypeFromFamily(uint32_t family) {
+    switch (family) {
+        case 2: return ETHERTYPE_IPV4;
+        case 24: case 28: case 30: return ETHERTYPE_IPV6;  // AF_INET6 differs between BSDs
+        default: return 0;
+    }
+}
+
+} // namespace
+
+size_t PcapReader::FlowKeyHash::operator()(const FlowKey& key) const {
+    // FNV-1a over the endpoints
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const uint8_t* bytes, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(key.source.data(), key.source.size());
+    mix(key.destination.data(), key.destination.size());
+    mix(reinterpret_cast<const uint8_t*>(&key.sourcePort), sizeof(key.sourcePort));
+    mix(reinterpret_cast<const uint8_t*>(&key.destinationPort), sizeof(key.destinationPort));
+    return static_cast<size_t>(hash);
+}
+
+PcapReader::PcapReader(const uchar* data, qint64 size, const Configuration& config)
+    : m_data(data)
+    , m_size(data ? size : 0)
+    , m_config(config)
+    , m_format(Format::Unknown)
+    , m_bigEndian(false)
+    , m_position(0)
+    , m_lastTimestampNs(0)
+{
+    readHeader();
+}
+
+PcapReader::Format PcapReader::detectFormat(const uchar* data, qint64 size) {
+    if (!data || size < 12) {
+        return Format::Unknown;
+    }
+
+    const uint32_t magic = qFromLittleEndian<quint32>(data);
+    if ((magic == PCAP_MAGIC_US || magic == PCAP_MAGIC_NS ||
+         qFromBigEndian<quint32>(data) == PCAP_MAGIC_US || qFromBigEndian<quint32>(data) == PCAP_MAGIC_NS) &&
+        size >= 24) {
+        return Format::Pcap;
+    }
+
+    // The section header type reads the same in both byte orders
+    if (magic == PCAPNG_SECTION_HEADER &&
+        (qFromLittleEndian<quint32>(data + 8) == PCAPNG_BYTE_ORDER_MAGIC ||
+         qFromBigEndian<quint32>(data + 8) == PCAPNG_BYTE_ORDER_MAGIC)) {
+        return Format::PcapNg;
+    }
+
+    return Format::Unknown;
+}
+
+bool PcapReader::isCaptureFile(const QString& filename) {
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const QByteArray head = file.read(24);
+    return detectFormat(reinterpret_cast<const uchar*>(head.constData()), head.size()) != Format::Unknown;
+}
+
+void PcapReader::readHeader() {
+    m_format = detectFormat(m_data, m_size);
+
+    if (m_format == Format::Pcap) {
+        const uint32_t magic = qFromLittleEndian<quint32>(m_data);
+        m_bigEndian = magic != PCAP_MAGIC_US && magic != PCAP_MAGIC_NS;
+
+        const bool nanoseconds = read32(m_data) == PCAP_MAGIC_NS;
+        m_pcapInterface.unitsPerSecond = nanoseconds ? NANOSECONDS_PER_SECOND : 1000000;
+        m_pcapInterface.linkType = read32(m_data + 20) & 0xFFFF;    // Upper bits describe the FCS
+        m_position = 24;
+    } else if (m_format == Format::Unknown) {
+        m_error = "Not a PCAP or PCAPNG capture";
+    }
+    // PCAPNG section headers are read as blocks
+}
+
+bool PcapReader::readNext(CapturedPacket& packet) {
+    while (m_ready.empty()) {
+        Record record;
+        if (!nextRecord(record)) {
+            // Packets still incomplete at the end of the capture are lost
+            for (const auto& flow : m_flows) {
+                m_stats.bytesDiscarded += flow.second.buffer.size();
+            }
+            m_flows.clear();
+            return false;
+        }
+        processRecord(record);
+    }
+
+    m_current = std::move(m_ready.front());
+    m_ready.pop_front();
+    if (!m_current.storage.empty()) {
+        m_current.packet.data = m_current.storage.data();
+    }
+    packet = m_current.packet;
+    return true;
+}
+
+bool PcapReader::nextRecord(Record& record) {
+    switch (m_format) {
+        case Format::Pcap: return nextPcapRecord(record);
+        case Format::PcapNg: return nextPcapNgRecord(record);
+        default: return false;
+    }
+}
+
+bool PcapReader::nextPcapRecord(Record& record) {
+    if (m_position + 16 > m_size) {
+        if (m_position < m_size) {
+            m_stats.truncatedRecords++;     // Partial record header at the end
+            m_position = m_size;
+        }
+        return false;
+    }
+
+    const uchar* header = m_data + m_position;
+    const uint32_t seconds = read32(header);
+    const uint32_t fraction = read32(header + 4);
+    const uint32_t capturedLength = read32(header + 8);
+
+    if (capturedLength > MAX_RECORD_SIZE) {
+        m_error = QString("Corrupt record length %1 at offset %2").arg(capturedLength).arg(m_position);
+        m_position = m_size;
+        return false;
+    }
+    if (m_position + 16 + capturedLength > m_size) {
+        m_stats.truncatedRecords++;         // Capture cut off mid-record
+        m_position = m_size;
+        return false;
+    }
+
+    record.data = header + 16;
+    record.capturedLength = capturedLength;
+    record.originalLength = read32(header + 12);
+    record.position = m_position;
+    record.timestampNs = toNanoseconds(static_cast<uint64_t>(seconds) * m_pcapInterface.unitsPerSecond + fraction,
+                                       m_pcapInterface);
+    record.linkType = m_pcapInterface.linkType;
+
+    m_position += 16 + capturedLength;
+    return true;
+}
+
+bool PcapReader::nextPcapNgRecord(Record& record) {
+    while (m_position + 12 <= m_size) {
+        const uchar* block = m_data + m_position;
+
+        if (qFromLittleEndian<quint32>(block) == PCAPNG_SECTION_HEADER && !readSectionHeader(block)) {
+            m_position = m_size;
+            return false;
+        }
+
+        const uint32_t type = read32(block);
+        const uint32_t length = read32(block + 4);
+        if (length < 12 || length % 4 != 0 || length > m_size - m_position) {
+            if (length > m_size - m_position) {
+                m_stats.truncatedRecords++;
+            } else {
+                m_error = QString("Corrupt block length %1 at offset %2").arg(length).arg(m_position);
+            }
+            m_position = m_size;
+            return false;
+        }
+
+        const qint64 blockPosition = m_position;
+        m_position += length;
+
+        uint32_t interfaceId = 0;
+        uint64_t timestamp = 0;
+        uint32_t capturedLength = 0;
+        uint32_t originalLength = 0;
+        uint32_t dataOffset = 0;
+        bool hasTimestamp = true;
+
+        switch (type) {
+            case BLOCK_INTERFACE_DESCRIPTION:
+                readInterfaceDescription(block, length);
+                continue;
+
+            case BLOCK_ENHANCED_PACKET:
+            case BLOCK_OBSOLETE_PACKET:
+                if (length < 32) {
+                    continue;
+                }
+                interfaceId = type == BLOCK_ENHANCED_PACKET ? read32(block + 8) : read16(block + 8);
+                timestamp = (static_cast<uint64_t>(read32(block + 12)) << 32) | read32(block + 16);
+                capturedLength = read32(block + 20);
+                originalLength = read32(block + 24);
+                dataOffset = 28;
+                break;
+
+            case BLOCK_SIMPLE_PACKET:
+                if (length < 16) {
+                    continue;
+                }
+                originalLength = read32(block + 8);
+                capturedLength = std::min(originalLength, length - 16);
+                dataOffset = 12;
+                hasTimestamp = false;
+                break;
+
+            default:
+                continue;   // Name resolution, statistics, custom blocks
+        }
+
+        if (capturedLength > length - dataOffset - 4 || interfaceId >= m_interfaces.size()) {
+            m_stats.skippedRecords++;
+            continue;
+        }
+
+        const Interface& iface = m_interfaces[interfaceId];
+        record.data = block + dataOffset;
+        record.capturedLength = capturedLength;
+        record.originalLength = originalLength;
+        record.position = blockPosition;
+        record.timestampNs = hasTimestamp ? toNanoseconds(timestamp, iface) : m_lastTimestampNs;
+        record.linkType = iface.linkType;
+        m_lastTimestampNs = record.timestampNs;
+        return true;
+    }
+
+    if (m_position < m_size) {
+        m_stats.truncatedRecords++;
+        m_position = m_size;
+    }
+    return false;
+}
+
+bool PcapReader::readSectionHeader(const uchar* block) {
+    if (qFromLittleEndian<quint32>(block + 8) == PCAPNG_BYTE_ORDER_MAGIC) {
+        m_bigEndian = false;
+    } else if (qFromBigEndian<quint32>(block + 8) == PCAPNG_BYTE_ORDER_MAGIC) {
+        m_bigEndian = true;
+    } else {
+        m_error = QString("Corrupt section header at offset %1").arg(m_position);
+        return false;
+    }
+
+    // Interface IDs are numbered per section
+    m_interfaces.clear();
+    return true;
+}
+
+void PcapReader::readInterfaceDescription(const uchar* block, uint32_t blockLength) {
+    Interface iface;
+    if (blockLength >= 20) {
+        iface.linkType = read16(block + 8);
+    }
+
+    uint32_t offset = 16;
+    while (offset + 4 <= blockLength - 4) {
+        const uint16_t code = read16(block + offset);
+        const uint16_t length = read16(block + offset + 2);
+        const uchar* value = block + offset + 4;
+        if (code == OPTION_END || offset + 4 + length > blockLength - 4) {
+            break;
+        }
+
+        if (code == OPTION_TIMESTAMP_RESOLUTION && length >= 1) {
+            // High bit set: negative power of two, otherwise of ten
+            const uint8_t exponent = value[0] & 0x7F;
+            uint64_t units = 1;
+            if (value[0] & 0x80) {
+                units = uint64_t(1) << std::min<uint8_t>(exponent, 63);
+            } else {
+                for (uint8_t i = 0; i < std::min<uint8_t>(exponent, 19); ++i) {
+                    units *= 10;
+                }
+            }
+            iface.unitsPerSecond = units;
+        } else if (code == OPTION_TIMESTAMP_OFFSET && length >= 8) {
+            iface.offsetSeconds = static_cast<int64_t>(read64(value));
+        }
+
+        offset += 4 + ((length + 3u) & ~3u);
+    }
+
+    m_interfaces.push_back(iface);
+}
+
+void PcapReader::processRecord(const Record& record) {
+    m_stats.records++;
+
+    const uchar* frame = record.data;
+    const uint32_t captured = record.capturedLength;
+    bool truncated = captured < record.originalLength;
+
+    // Link layer: find the IP header
+    uint32_t offset = 0;
+    uint16_t ethertype = 0;
+    switch (record.linkType) {
+        case LINKTYPE_ETHERNET:
+            if (captured < 14) break;
+            ethertype = networkOrder16(frame + 12);
+            offset = 14;
+            while ((ethertype == ETHERTYPE_VLAN || ethertype == ETHERTYPE_QINQ || ethertype == ETHERTYPE_VLAN_LEGACY) &&
+                   captured >= offset + 4) {
+                ethertype = networkOrder16(frame + offset + 2);
+                offset += 4;
+            }
+            break;
+
+        case LINKTYPE_NULL:
+        case LINKTYPE_LOOP:
+            if (captured < 4) break;
+            {
+                // LOOP is in network order; NULL in the order of the capturing host
+                uint32_t family = networkOrder32(frame);
+                if (record.linkType == LINKTYPE_NULL && family > 0xFFFF) {
+                    family = qFromLittleEndian<quint32>(frame);
+                }
+                ethertype = ethertypeFromFamily(family);
+            }
+            offset = 4;
+            break;
+
+        case LINKTYPE_RAW:
+        case LINKTYPE_IPV4:
+        case LINKTYPE_IPV6:
+            if (captured < 1) break;
+            ethertype = (frame[0] >> 4) == 4 ? ETHERTYPE_IPV4 : (frame[0] >> 4) == 6 ? ETHERTYPE_IPV6 : 0;
+            break;
+
+        case LINKTYPE_LINUX_SLL:
+            if (captured < 16) break;
+            ethertype = networkOrder16(frame + 14);
+            offset = 16;
+            break;
+
+        case LINKTYPE_LINUX_SLL2:
+            if (captured < 20) break;
+            ethertype = networkOrder16(frame);
+            offset = 20;
+            break;
+
+        default:
+            break;
+    }
+
+    // Network layer: find the transport header and its end
+    FlowKey key;
+    key.source.fill(0);
+    key.destination.fill(0);
+    uint8_t protocol = 0;
+    uint32_t transport = 0;
+    uint32_t end = 0;           // End of the IP packet within the captured bytes
+    uint32_t claimedEnd = 0;    // End of the IP packet as sent
+
+    if (ethertype == ETHERTYPE_IPV4 && captured >= offset + 20) {
+        const uchar* ip = frame + offset;
+        const uint32_t headerLength = (ip[0] & 0x0F) * 4u;
+        const uint16_t fragment = networkOrder16(ip + 6);
+        if (headerLength >= 20 && (fragment & 0x3FFF) == 0) {    // More-fragments flag or offset
+            protocol = ip[9];
+            transport = offset + headerLength;
+            claimedEnd = offset + networkOrder16(ip + 2);
+            // IPv4-mapped addresses keep one key layout for both versions
+            key.source[10] = key.source[11] = 0xFF;
+            key.destination[10] = key.destination[11] = 0xFF;
+            std::memcpy(key.source.data() + 12, ip + 12, 4);
+            std::memcpy(key.destination.data() + 12, ip + 16, 4);
+        }
+    } else if (ethertype == ETHERTYPE_IPV6 && captured >= offset + 40) {
+        const uchar* ip = frame + offset;
+        protocol = ip[6];
+        transport = offset + 40;
+        claimedEnd = transport + networkOrder16(ip + 4);
+        std::memcpy(key.source.data(), ip + 8, 16);
+        std::memcpy(key.destination.data(), ip + 24, 16);
+
+        // Hop-by-hop, routing and destination options headers
+        while ((protocol == 0 || protocol == 43 || protocol == 60) && captured >= transport + 8) {
+            protocol = frame[transport];
+            transport += (frame[transport + 1] + 1u) * 8;
+        }
+        if (protocol == 0 || protocol == 43 || protocol == 60 || protocol == 44) {
+            protocol = 0;   // Truncated extension headers or a fragment
+        }
+    }
+
+    if (protocol == 0 || transport >= claimedEnd) {
+        m_stats.skippedRecords++;
+        return;
+    }
+
+    // Ethernet padding beyond the IP packet is not payload
+    end = std::min(captured, claimedEnd);
+    truncated = truncated || end < claimedEnd;
+
+    if (protocol == PROTOCOL_UDP && end >= transport + 8) {
+        const uchar* udp = frame + transport;
+        const uint16_t length = networkOrder16(udp + 4);
+        if ((m_config.port != 0 && networkOrder16(udp) != m_config.port && networkOrder16(udp + 2) != m_config.port) ||
+            length < 8) {
+            m_stats.skippedRecords++;
+            return;
+        }
+        if (transport + length > end) {
+            m_stats.truncatedRecords++;     // Framing needs the whole datagram
+            return;
+        }
+        processUdp(record, udp + 8, length - 8u);
+    } else if (protocol == PROTOCOL_TCP && end >= transport + 20) {
+        const uchar* tcp = frame + transport;
+        const uint32_t headerLength = (tcp[12] >> 4) * 4u;
+        key.sourcePort = networkOrder16(tcp);
+        key.destinationPort = networkOrder16(tcp + 2);
+        if ((m_config.port != 0 && key.sourcePort != m_config.port && key.destinationPort != m_config.port) ||
+            headerLength < 20 || transport + headerLength > claimedEnd) {
+            m_stats.skippedRecords++;
+            return;
+        }
+
+        const uint32_t payload = transport + headerLength;
+        const uint32_t capturedLength = end > payload ? end - payload : 0;
+        if (truncated) {
+            m_stats.truncatedRecords++;
+        }
+        processTcp(record, key, networkOrder32(tcp + 4), tcp[13], frame + payload, capturedLength,
+                   claimedEnd - payload);
+    } else {
+        m_stats.skippedRecords++;
+    }
+}
+
+void PcapReader::processUdp(const Record& record, const uchar* payload, uint32_t length) {
+    m_stats.udpDatagrams++;
+
+    // A datagram carries one or more whole framed packets
+    uint32_t offset = 0;
+    while (offset < length) {
+        const uint32_t size = length - offset >= Packet::PACKET_HEADER_SIZE ? framedPacketSize(payload + offset) : 0;
+        if (size == 0 || size > length - offset) {
+            m_stats.framingErrors++;
+            m_stats.bytesDiscarded += length - offset;
+            return;
+        }
+        emitPacket(payload + offset, size, payload + offset - m_data, record.position, record.timestampNs, false);
+        offset += size;
+    }
+}
+
+void PcapReader::processTcp(const Record& record, const FlowKey& key, uint32_t sequence, uint8_t flags,
+                            const uchar* payload, uint32_t capturedLength, uint32_t length) {
+    m_stats.tcpSegments++;
+
+    if (flags & TCP_RST) {
+        m_flows.erase(key);
+        return;
+    }
+
+    Flow& flow = m_flows[key];
+    if (flags & TCP_SYN) {
+        // A new connection: framing starts with the first data byte
+        flow = Flow();
+        flow.synchronised = true;
+        flow.resyncing = false;
+        flow.nextSequence = sequence + 1;
+        return;
+    }
+
+    if (length > 0) {
+        if (!flow.synchronised) {
+            // Capture started mid-stream
+            flow.synchronised = true;
+            flow.nextSequence = sequence;
+        }
+
+        const int32_t ahead = static_cast<int32_t>(sequence - flow.nextSequence);
+        if (ahead > 0) {
+            // Hold segments that arrive before the data preceding them
+            auto& held = flow.outOfOrder[sequence];
+            if (capturedLength > held.size()) {
+                flow.outOfOrderBytes += capturedLength - held.size();
+                held.assign(payload, payload + capturedLength);
+            }
+            if (flow.outOfOrderBytes > m_config.maxOutOfOrderBytes) {
+                skipGap(flow, flow.outOfOrder.begin()->first);
+                drainOutOfOrder(flow, record);
+            }
+        } else {
+            // Drop bytes already seen in a retransmission
+            const uint32_t seen = static_cast<uint32_t>(-static_cast<int64_t>(ahead));
+            if (seen < length) {
+                const uint32_t skip = std::min(seen, capturedLength);
+                consumeStream(flow, record, payload + skip, capturedLength - skip, true);
+                flow.nextSequence += capturedLength - skip;
+                if (capturedLength < length) {
+                    skipGap(flow, sequence + length);   // Bytes beyond the snapshot length
+                }
+                drainOutOfOrder(flow, record);
+            }
+        }
+    }
+
+    if ((flags & TCP_FIN) && flow.outOfOrder.empty()) {
+        m_stats.bytesDiscarded += flow.buffer.size();
+        m_flows.erase(key);
+    }
+}
+
+void PcapReader::consumeStream(Flow& flow, const Record& record, const uchar* data, uint32_t length,
+                               bool fromCapture) {
+    uint32_t offset = 0;
+
+    // Packets that lie wholly within this segment are used in place
+    if (flow.buffer.empty() && !flow.resyncing && fromCapture) {
+        while (length - offset >= Packet::PACKET_HEADER_SIZE) {
+            const uint32_t size = framedPacketSize(data + offset);
+            if (size == 0) {
+                m_stats.framingErrors++;
+                flow.resyncing = true;
+                break;
+            }
+            if (size > length - offset) {
+                break;
+            }
+            emitPacket(data + offset, size, data + offset - m_data, record.position, record.timestampNs, false);
+            offset += size;
+        }
+        if (offset == length) {
+            return;
+        }
+    }
+
+    if (flow.buffer.empty()) {
+        flow.bufferRecordPosition = record.position;
+    }
+    flow.buffer.insert(flow.buffer.end(), data + offset, data + length);
+
+    std::vector<uchar>& buffer = flow.buffer;
+    size_t position = 0;
+    while (buffer.size() - position >= Packet::PACKET_HEADER_SIZE) {
+        if (flow.resyncing) {
+            // A plausible header only counts once the headers of the next
+            // packets are plausible too; payload bytes often pass on their
+            // own. Candidates whose chain runs past the buffered bytes are
+            // waited on unless a later one is confirmed first.
+            size_t candidate = position;
+            size_t pending = buffer.size();
+            bool confirmed = false;
+            for (; candidate + Packet::PACKET_HEADER_SIZE <= buffer.size(); ++candidate) {
+                size_t next = candidate;
+                uint32_t chained = 0;
+                while (chained <= RESYNC_CONFIRMATIONS && next + Packet::PACKET_HEADER_SIZE <= buffer.size()) {
+                    const uint32_t size = framedPacketSize(buffer.data() + next);
+                    if (size == 0) {
+                        break;
+                    }
+                    next += size;
+                    chained++;
+                }
+                if (chained > RESYNC_CONFIRMATIONS) {
+                    confirmed = true;
+                    break;
+                }
+                if (chained > 0 && next + Packet::PACKET_HEADER_SIZE > buffer.size()) {
+                    pending = std::min(pending, candidate);
+                }
+            }
+            if (!confirmed) {
+                candidate = std::min(candidate, pending);
+            }
+            m_stats.bytesDiscarded += candidate - position;
+            position = candidate;
+            if (!confirmed) {
+                break;
+            }
+            flow.resyncing = false;
+        }
+
+        const uint32_t size = framedPacketSize(buffer.data() + position);
+        if (size == 0) {
+            m_stats.framingErrors++;
+            flow.resyncing = true;
+            continue;
+        }
+        if (size > buffer.size() - position) {
+            break;
+        }
+
+        emitPacket(buffer.data() + position, size, -1, flow.bufferRecordPosition, record.timestampNs, true);
+        m_stats.reassembledPackets++;
+        position += size;
+        flow.bufferRecordPosition = record.position;
+    }
+
+    buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(position));
+}
+
+void PcapReader::drainOutOfOrder(Flow& flow, const Record& record) {
+    while (!flow.outOfOrder.empty()) {
+        auto it = flow.outOfOrder.begin();
+        const int32_t ahead = static_cast<int32_t>(it->first - flow.nextSequence);
+        if (ahead > 0) {
+            return;
+        }
+
+        const std::vector<uchar>& segment = it->second;
+        const uint32_t seen = static_cast<uint32_t>(-static_cast<int64_t>(ahead));
+        if (seen < segment.size()) {
+            consumeStream(flow, record, segment.data() + seen, static_cast<uint32_t>(segment.size()) - seen, false);
+            flow.nextSequence += static_cast<uint32_t>(segment.size()) - seen;
+        }
+        flow.outOfOrderBytes -= segment.size();
+        flow.outOfOrder.erase(it);
+    }
+}
+
+void PcapReader::skipGap(Flow& flow, uint32_t sequence) {
+    m_stats.tcpGaps++;
+    m_stats.bytesDiscarded += flow.buffer.size();
+    flow.buffer.clear();
+    flow.resyncing = true;
+    flow.nextSequence = sequence;
+}
+
+void PcapReader::emitPacket(const uchar* data, uint32_t size, qint64 position, qint64 recordPosition,
+                            uint64_t timestampNs, bool copy) {
+    Pending pending;
+    pending.packet.data = data;
+    pending.packet.size = size;
+    pending.packet.position = position;
+    pending.packet.recordPosition = recordPosition;
+    pending.packet.timestampNs = timestampNs;
+    if (copy) {
+        pending.storage.assign(data, data + size);
+    }
+
+    m_ready.push_back(std::move(pending));
+    m_stats.packets++;
+}
+
+uint16_t PcapReader::read16(const uchar* p) const {
+    return m_bigEndian ? qFromBigEndian<quint16>(p) : qFromLittleEndian<quint16>(p);
+}
+
+uint32_t PcapReader::read32(const uchar* p) const {
+    return m_bigEndian ? qFromBigEndian<quint32>(p) : qFromLittleEndian<quint32>(p);
+}
+
+uint64_t PcapReader::read64(const uchar* p) const {
+    return m_bigEndian ? qFromBigEndian<quint64>(p) : qFromLittleEndian<quint64>(p);
+}
+
+uint64_t PcapReader::toNanoseconds(uint64_t timestamp, const Interface& iface) {
+    const uint64_t units = std::max<uint64_t>(iface.unitsPerSecond, 1);
+    const uint64_t seconds = timestamp / units;
+    const uint64_t fraction = timestamp % units;
+
+    // Resolutions finer than about 50 ps would overflow the integer product
+    const uint64_t fractionNs = fraction <= UINT64_MAX / NANOSECONDS_PER_SECOND ?
+        fraction * NANOSECONDS_PER_SECOND / units :
+        static_cast<uint64_t>(static_cast<long double>(fraction) * NANOSECONDS_PER_SECOND / units);
+
+    return static_cast<uint64_t>(static_cast<int64_t>(seconds) + iface.offsetSeconds) * NANOSECONDS_PER_SECOND + fractionNs;
+}
+
+uint32_t PcapReader::framedPacketSize(const uchar* data) const {
+    Packet::PacketHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    header.convertToHostOrder(m_config.headerByteOrder);
+    return header.isValid() ? static_cast<uint32_t>(sizeof(header)) + header.payloadSize : 0;
+}
+
+} // namespace Offline
+} // namespace Monitor
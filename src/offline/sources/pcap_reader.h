@@ -0,0 +1,246 @@
+#pragma once
+
+#include "../../parser/layout/byte_order.h"
+#include <QString>
+#include <QtGlobal>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace Monitor {
+namespace Offline {
+
+/**
+ * @brief Application packet recovered from a network capture
+ */
+struct CapturedPacket {
+    const uchar* data;          ///< Framed packet (PacketHeader + payload), valid until the next read
+    uint32_t size;              ///< Framed packet size; the header is as captured, in wire order
+    qint64 position;            ///< Offset of the packet in the capture, or -1 if split across segments
+    qint64 recordPosition;      ///< Offset of the capture record holding the first byte
+    uint64_t timestampNs;       ///< Capture time of the record completing the packet
+
+    CapturedPacket()
+        : data(nullptr), size(0), position(-1), recordPosition(0), timestampNs(0) {}
+};
+
+/**
+ * @brief Streaming reader for PCAP and PCAPNG captures
+ *
+ * Walks a capture held in memory (normally a file mapping) record by record
+ * and strips the link, IP and transport headers. UDP datagrams carry whole
+ * framed packets; TCP payloads are reassembled per flow in sequence order
+ * and cut at the PacketHeader boundaries. A packet that lies within one
+ * record is returned as a pointer into the capture together with its
+ * offset, so callers can index and play it back from the mapping without
+ * copying; only packets split across segments are assembled in memory.
+ * Flows picked up mid-stream, or after a gap, resume framing at the first
+ * run of consecutive plausible headers.
+ *
+ * Supported: classic pcap (microsecond and nanosecond, either byte order),
+ * pcapng (SHB/IDB/EPB/SPB/OPB, any timestamp resolution, multiple
+ * sections), Ethernet with VLAN tags, Linux cooked (v1 and v2), raw IP and
+ * BSD loopback link types, IPv4 and IPv6. IP fragments are skipped.
+ *
+ * Not thread-safe.
+ */
+class PcapReader {
+public:
+    /**
+     * @brief Capture file format
+     */
+    enum class Format {
+        Unknown,
+        Pcap,
+        PcapNg
+    };
+
+    /**
+     * @brief Reader configuration
+     */
+    struct Configuration {
+        uint16_t port = 0;                              ///< Only flows with this port at either end; 0 for all
+        size_t maxOutOfOrderBytes = 4 * 1024 * 1024;    ///< Per TCP flow before a gap is given up on
+        Parser::Layout::ByteOrder headerByteOrder = Parser::Layout::ByteOrder::Native;  ///< Sender's packet header byte order
+    };
+
+    /**
+     * @brief Reader statistics
+     */
+    struct Statistics {
+        uint64_t records = 0;               ///< Capture records read
+        uint64_t packets = 0;               ///< Framed packets returned
+        uint64_t reassembledPackets = 0;    ///< Packets assembled from more than one segment
+        uint64_t udpDatagrams = 0;
+        uint64_t tcpSegments = 0;
+        uint64_t skippedRecords = 0;        ///< Unsupported link layer, protocol, fragment or port
+        uint64_t truncatedRecords = 0;      ///< Records cut short by the snapshot length
+        uint64_t framingErrors = 0;         ///< Payloads that did not hold valid framed packets
+        uint64_t tcpGaps = 0;               ///< Missing TCP data skipped over
+        uint64_t bytesDiscarded = 0;        ///< Payload bytes dropped while resynchronising
+    };
+
+    /**
+     * @brief Construct reader over a capture in memory
+     * @param data Start of the capture; must outlive the reader
+     * @param size Capture size in bytes
+     */
+    PcapReader(const uchar* data, qint64 size, const Configuration& config);
+    PcapReader(const uchar* data, qint64 size) : PcapReader(data, size, Configuration()) {}
+
+    /**
+     * @brief Detect the capture format from the leading bytes
+     */
+    static Format detectFormat(const uchar* data, qint64 size);
+
+    /**
+     * @brief Check whether a file starts with a PCAP or PCAPNG header
+     */
+    static bool isCaptureFile(const QString& filename);
+
+    /**
+     * @brief Check that the capture header was recognised
+     */
+    bool isValid() const { return m_format != Format::Unknown; }
+
+    Format format() const { return m_format; }
+
+    /**
+     * @brief Read the next framed packet
+     * @return False at the end of the capture
+     */
+    bool readNext(CapturedPacket& packet);
+
+    /**
+     * @brief Bytes of the capture consumed so far
+     */
+    qint64 position() const { return m_position; }
+
+    const Statistics& getStatistics() const { return m_stats; }
+
+    /**
+     * @brief Description of the last format error, if any
+     */
+    const QString& errorString() const { return m_error; }
+
+private:
+    /**
+     * @brief Link layer and clock of one capture interface
+     */
+    struct Interface {
+        uint32_t linkType = 0;
+        uint64_t unitsPerSecond = 1000000;
+        int64_t offsetSeconds = 0;
+    };
+
+    /**
+     * @brief Captured bytes of one record
+     */
+    struct Record {
+        const uchar* data;
+        uint32_t capturedLength;
+        uint32_t originalLength;
+        qint64 position;
+        uint64_t timestampNs;
+        uint32_t linkType;
+    };
+
+    /**
+     * @brief Transport endpoints identifying a TCP flow in one direction
+     */
+    struct FlowKey {
+        std::array<uint8_t, 16> source;
+        std::array<uint8_t, 16> destination;
+        uint16_t sourcePort;
+        uint16_t destinationPort;
+
+        bool operator==(const FlowKey& other) const {
+            return source == other.source && destination == other.destination &&
+                   sourcePort == other.sourcePort && destinationPort == other.destinationPort;
+        }
+    };
+
+    struct FlowKeyHash {
+        size_t operator()(const FlowKey& key) const;
+    };
+
+    /**
+     * @brief Reassembly state of one TCP flow
+     */
+    struct Flow {
+        bool synchronised = false;              ///< nextSequence is known
+        bool resyncing = true;                  ///< Next byte is not known to start a packet
+        uint32_t nextSequence = 0;
+        std::vector<uchar> buffer;              ///< Bytes of packets not yet complete
+        qint64 bufferRecordPosition = 0;        ///< Record holding the first buffered byte
+        std::map<uint32_t, std::vector<uchar>> outOfOrder;  ///< Segments ahead of nextSequence
+        size_t outOfOrderBytes = 0;
+    };
+
+    /**
+     * @brief Packet waiting to be returned
+     */
+    struct Pending {
+        CapturedPacket packet;
+        std::vector<uchar> storage;             ///< Owns the bytes of reassembled packets
+    };
+
+    void readHeader();
+    bool nextRecord(Record& record);
+    bool nextPcapRecord(Record& record);
+    bool nextPcapNgRecord(Record& record);
+    bool readSectionHeader(const uchar* block);
+    void readInterfaceDescription(const uchar* block, uint32_t blockLength);
+
+    void processRecord(const Record& record);
+    void processUdp(const Record& record, const uchar* payload, uint32_t length);
+    void processTcp(const Record& record, const FlowKey& key, uint32_t sequence, uint8_t flags,
+                    const uchar* payload, uint32_t capturedLength, uint32_t length);
+    void consumeStream(Flow& flow, const Record& record, const uchar* data, uint32_t length, bool fromCapture);
+    void drainOutOfOrder(Flow& flow, const Record& record);
+    void skipGap(Flow& flow, uint32_t sequence);
+    void emitPacket(const uchar* data, uint32_t size, qint64 position, qint64 recordPosition,
+                    uint64_t timestampNs, bool copy);
+
+    uint16_t read16(const uchar* p) const;
+    uint32_t read32(const uchar* p) const;
+    uint64_t read64(const uchar* p) const;
+    static uint64_t toNanoseconds(uint64_t timestamp, const Interface& iface);
+
+    /**
+     * @brief Size of the framed packet starting at @p data, or 0 if not a plausible header
+     */
+    uint32_t framedPacketSize(const uchar* data) const;
+
+    const uchar* m_data;
+    qint64 m_size;
+    Configuration m_config;
+    Format m_format;
+    bool m_bigEndian;                   ///< Byte order of the current file or section
+    qint64 m_position;
+    QString m_error;
+
+    // Classic pcap
+    Interface m_pcapInterface;
+
+    // PCAPNG, reset for every section
+    std::vector<Interface> m_interfaces;
+    uint64_t m_lastTimestampNs;         ///< For simple packet blocks, which carry no time
+
+    std::unordered_map<FlowKey, Flow, FlowKeyHash> m_flows;
+    std::deque<Pending> m_ready;
+    Pending m_current;                  ///< Backs the packet returned by the last readNext()
+    Statistics m_stats;
+
+    static constexpr uint32_t PCAP_MAGIC_US = 0xA1B2C3D4;
+    static constexpr uint32_t PCAP_MAGIC_NS = 0xA1B23C4D;
+    static constexpr uint32_t PCAPNG_SECTION_HEADER = 0x0A0D0D0A;
+    static constexpr uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1A2B3C4D;
+    static constexpr uint32_t MAX_RECORD_SIZE = 256 * 1024;
+};
+
+} // namespace Offline
+} // namespace Monitor
@@ -0,0 +1,249 @@
+#include "pcap_writer.h"
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace Monitor {
+namespace Offline {
+
+namespace {
+
+constexpr uint32_t PCAP_MAGIC_NS = 0xA1B23C4D;
+constexpr uint32_t SNAPSHOT_LENGTH = 262144;
+constexpr uint32_t LINKTYPE_ETHERNET = 1;
+
+constexpr size_t RECORD_HEADER_SIZE = 16;
+constexpr size_t ETHERNET_HEADER_SIZE = 14;
+constexpr size_t IPV4_HEADER_SIZE = 20;
+constexpr size_t UDP_HEADER_SIZE = 8;
+constexpr size_t TCP_HEADER_SIZE = 20;
+
+constexpr uint8_t TCP_FIN = 0x01;
+constexpr uint8_t TCP_SYN = 0x02;
+constexpr uint8_t TCP_PSH = 0x08;
+constexpr uint8_t TCP_ACK = 0x10;
+
+constexpr uint32_t TCP_INITIAL_SEQUENCE = 1;
+constexpr uint64_t NANOSECONDS_PER_SECOND = 1000000000ULL;
+
+/**
+ * @brief Ones' complement sum of big-endian 16-bit words, as used by IP checksums
+ */
+uint32_t checksumAdd(uint32_t sum, const uchar* data, size_t length) {
+    for (size_t i = 0; i + 1 < length; i += 2) {
+        sum += static_cast<uint32_t>(data[i] << 8 | data[i + 1]);
+    }
+    if (length & 1) {
+        sum += static_cast<uint32_t>(data[length - 1] << 8);
+    }
+    return sum;
+}
+
+uint16_t checksumFinish(uint32_t sum) {
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return static_cast<uint16_t>(~sum);
+}
+
+} // namespace
+
+PcapWriter::PcapWriter()
+    : PcapWriter(Configuration())
+{
+}
+
+PcapWriter::PcapWriter(const Configuration& config)
+    : m_config(config)
+    , m_logger(Logging::Logger::instance())
+    , m_tcpSequence(TCP_INITIAL_SEQUENCE)
+    , m_ipIdentification(0)
+    , m_lastTimestampNs(0)
+    , m_packetsWritten(0)
+    , m_bytesWritten(0)
+{
+}
+
+PcapWriter::~PcapWriter() {
+    close();
+}
+
+bool PcapWriter::open(const QString& filename) {
+    close();
+    m_error.clear();
+
+    m_file = std::make_unique<QFile>(filename);
+    if (!m_file->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        const QString error = QString("Failed to create capture %1: %2").arg(filename).arg(m_file->errorString());
+        m_file.reset();
+        return fail(error);
+    }
+
+    uint8_t header[24];
+    const uint32_t magic = PCAP_MAGIC_NS;
+    const uint16_t versionMajor = 2;
+    const uint16_t versionMinor = 4;
+    const uint32_t zero = 0;
+    const uint32_t snapshotLength = SNAPSHOT_LENGTH;
+    const uint32_t linkType = LINKTYPE_ETHERNET;
+    std::memcpy(header, &magic, 4);
+    std::memcpy(header + 4, &versionMajor, 2);
+    std::memcpy(header + 6, &versionMinor, 2);
+    std::memcpy(header + 8, &zero, 4);      // GMT offset
+    std::memcpy(header + 12, &zero, 4);     // Timestamp accuracy
+    std::memcpy(header + 16, &snapshotLength, 4);
+    std::memcpy(header + 20, &linkType, 4);
+
+    if (m_file->write(reinterpret_cast<const char*>(header), sizeof(header)) != static_cast<qint64>(sizeof(header))) {
+        return fail(QString("Failed to write capture header: %1").arg(m_file->errorString()));
+    }
+
+    m_tcpSequence = TCP_INITIAL_SEQUENCE;
+    m_ipIdentification = 0;
+    m_lastTimestampNs = Packet::PacketHeader::getCurrentTimestampNs();
+    m_packetsWritten = 0;
+    m_bytesWritten = sizeof(header);
+
+    // Readers start framing the stream at the byte after the SYN
+    if (m_config.transport == Transport::Tcp && !writeFrame(nullptr, 0, m_lastTimestampNs, TCP_SYN)) {
+        return false;
+    }
+
+    m_logger->info("PcapWriter", QString("Capture opened: %1").arg(filename));
+    return true;
+}
+
+void PcapWriter::close() {
+    if (!m_file) {
+        return;
+    }
+
+    if (m_config.transport == Transport::Tcp) {
+        writeFrame(nullptr, 0, m_lastTimestampNs, TCP_FIN | TCP_ACK);
+    }
+    m_file->close();
+    m_file.reset();
+
+    m_logger->info("PcapWriter",
+        QString("Capture closed: %1 packets, %2 bytes").arg(m_packetsWritten).arg(m_bytesWritten));
+}
+
+bool PcapWriter::writePacket(const uchar* data, uint32_t size, uint64_t timestampNs) {
+    if (!m_file) {
+        return fail("Capture is not open");
+    }
+
+    m_lastTimestampNs = timestampNs;
+
+    if (m_config.transport == Transport::Udp) {
+        if (size > MAX_UDP_PAYLOAD) {
+            m_error = QString("%1 byte packet does not fit in a UDP datagram").arg(size);
+            return false;
+        }
+        if (!writeFrame(data, size, timestampNs, 0)) {
+            return false;
+        }
+    } else {
+        for (uint32_t offset = 0; offset < size; offset += MAX_TCP_SEGMENT) {
+            if (!writeFrame(data + offset, std::min(size - offset, MAX_TCP_SEGMENT), timestampNs, TCP_PSH | TCP_ACK)) {
+                return false;
+            }
+        }
+    }
+
+    m_packetsWritten++;
+    return true;
+}
+
+bool PcapWriter::writePacket(const Packet::Packet& packet) {
+    const uint64_t timestamp = packet.receiveTimestamp() != 0 ? packet.receiveTimestamp() : packet.timestamp();
+    return writePacket(packet.data(), static_cast<uint32_t>(packet.totalSize()), timestamp);
+}
+
+bool PcapWriter::flush() {
+    return m_file && m_file->flush();
+}
+
+bool PcapWriter::writeFrame(const uchar* payload, uint32_t length, uint64_t timestampNs, uint8_t tcpFlags) {
+    const bool tcp = m_config.transport == Transport::Tcp;
+    const size_t transportHeader = tcp ? TCP_HEADER_SIZE : UDP_HEADER_SIZE;
+    const size_t headers = ETHERNET_HEADER_SIZE + IPV4_HEADER_SIZE + transportHeader;
+    const uint32_t frameLength = static_cast<uint32_t>(headers + length);
+
+    uint8_t frame[RECORD_HEADER_SIZE + ETHERNET_HEADER_SIZE + IPV4_HEADER_SIZE + TCP_HEADER_SIZE];
+    std::memset(frame, 0, sizeof(frame));
+
+    // Record header in host byte order, like the file header
+    const uint32_t seconds = static_cast<uint32_t>(timestampNs / NANOSECONDS_PER_SECOND);
+    const uint32_t nanoseconds = static_cast<uint32_t>(timestampNs % NANOSECONDS_PER_SECOND);
+    std::memcpy(frame, &seconds, 4);
+    std::memcpy(frame + 4, &nanoseconds, 4);
+    std::memcpy(frame + 8, &frameLength, 4);
+    std::memcpy(frame + 12, &frameLength, 4);
+
+    // Ethernet: locally administered addresses
+    uint8_t* ethernet = frame + RECORD_HEADER_SIZE;
+    const uint8_t destinationMac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x02};
+    const uint8_t sourceMac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+    std::memcpy(ethernet, destinationMac, 6);
+    std::memcpy(ethernet + 6, sourceMac, 6);
+    qToBigEndian<quint16>(0x0800, ethernet + 12);
+
+    uint8_t* ip = ethernet + ETHERNET_HEADER_SIZE;
+    ip[0] = 0x45;
+    qToBigEndian<quint16>(static_cast<quint16>(IPV4_HEADER_SIZE + transportHeader + length), ip + 2);
+    qToBigEndian<quint16>(m_ipIdentification++, ip + 4);
+    qToBigEndian<quint16>(0x4000, ip + 6);     // Don't fragment
+    ip[8] = 64;
+    ip[9] = tcp ? 6 : 17;
+    qToBigEndian<quint32>(m_config.sourceAddress, ip + 12);
+    qToBigEndian<quint32>(m_config.destinationAddress, ip + 16);
+    qToBigEndian<quint16>(checksumFinish(checksumAdd(0, ip, IPV4_HEADER_SIZE)), ip + 10);
+
+    uint8_t* transport = ip + IPV4_HEADER_SIZE;
+    qToBigEndian<quint16>(m_config.sourcePort, transport);
+    qToBigEndian<quint16>(m_config.destinationPort, transport + 2);
+    if (tcp) {
+        qToBigEndian<quint32>(m_tcpSequence, transport + 4);
+        qToBigEndian<quint32>((tcpFlags & TCP_ACK) ? 1 : 0, transport + 8);
+        transport[12] = static_cast<uint8_t>((TCP_HEADER_SIZE / 4) << 4);
+        transport[13] = tcpFlags;
+        qToBigEndian<quint16>(65535, transport + 14);  // Window
+
+        // Checksum over the pseudo-header, TCP header and payload
+        uint8_t pseudo[12];
+        std::memcpy(pseudo, ip + 12, 8);
+        pseudo[8] = 0;
+        pseudo[9] = 6;
+        qToBigEndian<quint16>(static_cast<quint16>(TCP_HEADER_SIZE + length), pseudo + 10);
+        uint32_t sum = checksumAdd(0, pseudo, sizeof(pseudo));
+        sum = checksumAdd(sum, transport, TCP_HEADER_SIZE);
+        if (length > 0) {
+            sum = checksumAdd(sum, payload, length);
+        }
+        qToBigEndian<quint16>(checksumFinish(sum), transport + 16);
+
+        m_tcpSequence += length + ((tcpFlags & (TCP_SYN | TCP_FIN)) ? 1 : 0);
+    } else {
+        qToBigEndian<quint16>(static_cast<quint16>(UDP_HEADER_SIZE + length), transport + 4);
+        // UDP checksum left at zero: optional over IPv4
+    }
+
+    const qint64 headerBytes = static_cast<qint64>(RECORD_HEADER_SIZE + headers);
+    if (m_file->write(reinterpret_cast<const char*>(frame), headerBytes) != headerBytes ||
+        (length > 0 && m_file->write(reinterpret_cast<const char*>(payload), length) != static_cast<qint64>(length))) {
+        return fail(QString("Failed to write capture record: %1").arg(m_file->errorString()));
+    }
+
+    m_bytesWritten += static_cast<uint64_t>(headerBytes) + length;
+    return true;
+}
+
+bool PcapWriter::fail(const QString& error) {
+    m_error = error;
+    m_logger->error("PcapWriter", error);
+    return false;
+}
+
+} // namespace Offline
+} // namespace Monitor
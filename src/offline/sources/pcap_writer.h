@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../../packet/core/packet.h"
+#include "../../logging/logger.h"
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <memory>
+
+namespace Monitor {
+namespace Offline {
+
+/**
+ * @brief Writes framed packets to a standard PCAP capture
+ *
+ * Each packet is wrapped in synthetic Ethernet, IPv4 and UDP (or TCP)
+ * headers so the capture opens in Wireshark or tcpdump and reads back
+ * through PcapReader into the same offline path as range captures. Files
+ * use the nanosecond pcap format in host byte order.
+ *
+ * UDP carries one packet per datagram, so packets larger than a datagram
+ * are rejected; TCP writes one stream, opened with a SYN and closed with a
+ * FIN, and splits large packets across segments.
+ *
+ * Not thread-safe.
+ */
+class PcapWriter {
+public:
+    /**
+     * @brief Transport the packets are wrapped in
+     */
+    enum class Transport {
+        Udp,
+        Tcp
+    };
+
+    /**
+     * @brief Synthetic endpoints written into every frame
+     */
+    struct Configuration {
+        Transport transport = Transport::Udp;
+        uint32_t sourceAddress = 0x7F000001;        ///< IPv4 address, host byte order
+        uint32_t destinationAddress = 0x7F000001;   ///< IPv4 address, host byte order
+        uint16_t sourcePort = 50000;
+        uint16_t destinationPort = 50001;
+    };
+
+    PcapWriter();
+    explicit PcapWriter(const Configuration& config);
+    ~PcapWriter();
+
+    PcapWriter(const PcapWriter&) = delete;
+    PcapWriter& operator=(const PcapWriter&) = delete;
+
+    /**
+     * @brief Create or truncate @p filename and write the capture header
+     */
+    bool open(const QString& filename);
+
+    /**
+     * @brief Finish the capture and close the file
+     */
+    void close();
+
+    bool isOpen() const { return m_file != nullptr; }
+
+    /**
+     * @brief Append one framed packet
+     * @param data Packet bytes (PacketHeader + payload)
+     * @param size Packet size
+     * @param timestampNs Capture time written to the record
+     */
+    bool writePacket(const uchar* data, uint32_t size, uint64_t timestampNs);
+
+    /**
+     * @brief Append @p packet, stamped with its receive time if recorded
+     */
+    bool writePacket(const Packet::Packet& packet);
+
+    /**
+     * @brief Push buffered records to the file
+     */
+    bool flush();
+
+    uint64_t getPacketsWritten() const { return m_packetsWritten; }
+    uint64_t getBytesWritten() const { return m_bytesWritten; }
+
+    const QString& errorString() const { return m_error; }
+
+    static constexpr uint32_t MAX_UDP_PAYLOAD = 65507;
+    static constexpr uint32_t MAX_TCP_SEGMENT = 65495;
+
+private:
+    /**
+     * @brief Write one record holding the headers and @p length payload bytes
+     */
+    bool writeFrame(const uchar* payload, uint32_t length, uint64_t timestampNs, uint8_t tcpFlags);
+
+    bool fail(const QString& error);
+
+    Configuration m_config;
+    Logging::Logger* m_logger;
+    std::unique_ptr<QFile> m_file;
+    QString m_error;
+
+    uint32_t m_tcpSequence;
+    uint16_t m_ipIdentification;
+    uint64_t m_lastTimestampNs;
+    uint64_t m_packetsWritten;
+    uint64_t m_bytesWritten;
+};
+
+} // namespace Offline
+} // namespace Monitor
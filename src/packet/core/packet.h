@@ -2,21 +2,33 @@
 
 #include "packet_header.h"
 #include "packet_buffer.h"
+#include "packet_type_registry.h"
 #include "../../parser/ast/ast_nodes.h"
 
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <string>
 #include <unordered_map>
 
 namespace Monitor {
 namespace Packet {
 
+class PacketHandle;
+class LatestPacketTable;
+
 /**
  * @brief Main packet class representing a complete data packet
  * 
  * This class combines header, payload, and metadata into a cohesive packet
  * representation. It provides zero-copy access to packet data and integrates
  * with the Phase 2 structure parsing system for typed field access.
+ * 
+ * Shared packets are made with create() and held through PacketHandle,
+ * whose reference count is embedded in the packet. The structure is
+ * referenced by its PacketTypeRegistry slot, so a packet carries no
+ * per-packet strings or validation state and fits one 64-byte pool block.
  */
 class Packet {
 public:
@@ -45,65 +57,63 @@ public:
     };
 
 private:
-    PacketBuffer::ManagedBufferPtr m_buffer;    ///< Managed packet buffer
-    mutable PacketHeader* m_header;              ///< Cached header pointer
-    size_t m_totalSize;                         ///< Total packet size
-    std::shared_ptr<Parser::AST::StructDeclaration> m_structure; ///< Associated structure definition
-    
-    // Cached metadata
-    mutable bool m_metadataValid;
-    mutable std::string m_structureName;
-    mutable size_t m_payloadOffset;
-    mutable ValidationResult m_lastValidation;
+    mutable std::atomic<uint32_t> m_refCount;   ///< Handles referring to this packet
+    PacketTypeRegistry::Slot m_structureSlot;   ///< Registry slot holding the structure, or INVALID_SLOT
+    Memory::SizeClassAllocator* m_blockAllocator; ///< Pool this packet was placed in (nullptr = heap)
+    PacketBuffer::ManagedBuffer m_buffer;       ///< Packet bytes, header first
+    uint64_t m_receiveTimestamp;                ///< Local receive time in ns (0 = not recorded)
 
 public:
+    /**
+     * @brief Size class of the pool block a packet is placed in by create()
+     */
+    static constexpr Memory::SizeClass::Index BLOCK_CLASS = Memory::SizeClass::forSize(64);
+    
+    /**
+     * @brief Create a reference-counted packet owning @p buffer
+     * 
+     * The packet is placed in a block of @p allocator when one is given and
+     * has a free block, next to the buffers it draws packet data from;
+     * otherwise it is heap allocated. Either way there is no separate
+     * control block.
+     */
+    static PacketHandle create(PacketBuffer::ManagedBufferPtr buffer,
+                               Memory::SizeClassAllocator* allocator = nullptr);
+    
     /**
      * @brief Construct packet from managed buffer
+     * 
+     * Packets shared between components are made with create(); a packet
+     * constructed directly is owned by its creator.
      */
     explicit Packet(PacketBuffer::ManagedBufferPtr buffer)
-        : m_buffer(std::move(buffer))
-        , m_header(nullptr)
-        , m_totalSize(0)
-        , m_metadataValid(false)
-        , m_payloadOffset(PACKET_HEADER_SIZE)
+        : m_refCount(0)
+        , m_structureSlot(PacketTypeRegistry::INVALID_SLOT)
+        , m_blockAllocator(nullptr)
+        , m_buffer(buffer ? std::move(*buffer) : emptyBuffer())
+        , m_receiveTimestamp(0)
     {
-        if (m_buffer && m_buffer->isValid()) {
-            m_header = m_buffer->as<PacketHeader>();
-            m_totalSize = m_buffer->size();
-        }
     }
     
     // Move constructor
     Packet(Packet&& other) noexcept
-        : m_buffer(std::move(other.m_buffer))
-        , m_header(other.m_header)
-        , m_totalSize(other.m_totalSize)
-        , m_structure(std::move(other.m_structure))
-        , m_metadataValid(other.m_metadataValid)
-        , m_structureName(std::move(other.m_structureName))
-        , m_payloadOffset(other.m_payloadOffset)
-        , m_lastValidation(std::move(other.m_lastValidation))
+        : m_refCount(0)
+        , m_structureSlot(other.m_structureSlot)
+        , m_blockAllocator(nullptr)
+        , m_buffer(std::move(other.m_buffer))
+        , m_receiveTimestamp(other.m_receiveTimestamp)
     {
-        other.m_header = nullptr;
-        other.m_totalSize = 0;
-        other.m_metadataValid = false;
+        other.m_structureSlot = PacketTypeRegistry::INVALID_SLOT;
     }
     
-    // Move assignment
+    // Move assignment; the reference count and placement stay with the object
     Packet& operator=(Packet&& other) noexcept {
         if (this != &other) {
+            m_structureSlot = other.m_structureSlot;
             m_buffer = std::move(other.m_buffer);
-            m_header = other.m_header;
-            m_totalSize = other.m_totalSize;
-            m_structure = std::move(other.m_structure);
-            m_metadataValid = other.m_metadataValid;
-            m_structureName = std::move(other.m_structureName);
-            m_payloadOffset = other.m_payloadOffset;
-            m_lastValidation = std::move(other.m_lastValidation);
+            m_receiveTimestamp = other.m_receiveTimestamp;
             
-            other.m_header = nullptr;
-            other.m_totalSize = 0;
-            other.m_metadataValid = false;
+            other.m_structureSlot = PacketTypeRegistry::INVALID_SLOT;
         }
         return *this;
     }
@@ -116,140 +126,165 @@ public:
      * @brief Check if packet is valid
      */
     bool isValid() const {
-        return m_buffer && 
-               m_buffer->isValid() && 
-               m_header && 
-               m_header->isValid() &&
-               m_totalSize >= PACKET_HEADER_SIZE;
+        return m_buffer.isValid() && 
+               m_buffer.size() >= PACKET_HEADER_SIZE &&
+               header()->isValid();
     }
     
     /**
      * @brief Get packet header (read-only)
      */
     const PacketHeader* header() const { 
-        return m_header; 
+        return m_buffer.as<PacketHeader>(); 
     }
     
     /**
      * @brief Get mutable packet header
      */
     PacketHeader* header() { 
-        m_metadataValid = false; // Invalidate cache when header might change
-        return m_header; 
+        return m_buffer.as<PacketHeader>(); 
     }
     
     /**
      * @brief Get packet ID
      */
     PacketId id() const {
-        return m_header ? m_header->id : 0;
+        return header() ? header()->id : 0;
     }
     
     /**
      * @brief Get sequence number
      */
     SequenceNumber sequence() const {
-        return m_header ? m_header->sequence : 0;
+        return header() ? header()->sequence : 0;
     }
     
     /**
      * @brief Get timestamp
      */
     uint64_t timestamp() const {
-        return m_header ? m_header->timestamp : 0;
+        return header() ? header()->timestamp : 0;
     }
     
     /**
      * @brief Get timestamp as time_point
      */
     std::chrono::high_resolution_clock::time_point getTimestamp() const {
-        return m_header ? m_header->getTimestamp() : std::chrono::high_resolution_clock::time_point{};
+        return header() ? header()->getTimestamp() : std::chrono::high_resolution_clock::time_point{};
+    }
+    
+    /**
+     * @brief Get local receive timestamp in nanoseconds (0 if not recorded)
+     * 
+     * Unlike timestamp(), which is written by the sender, this is taken on
+     * arrival, from the kernel where the source supports it.
+     */
+    uint64_t receiveTimestamp() const {
+        return m_receiveTimestamp;
+    }
+    
+    /**
+     * @brief Record the local receive timestamp in nanoseconds
+     */
+    void setReceiveTimestamp(uint64_t timestampNs) {
+        m_receiveTimestamp = timestampNs;
     }
     
     /**
      * @brief Get packet age in nanoseconds
      */
     uint64_t getAgeNs() const {
-        return m_header ? m_header->getAgeNs() : 0;
+        return header() ? header()->getAgeNs() : 0;
     }
     
     /**
      * @brief Get payload size
      */
     size_t payloadSize() const {
-        return m_header ? m_header->payloadSize : 0;
+        return header() ? header()->payloadSize : 0;
     }
     
     /**
      * @brief Get total packet size
      */
     size_t totalSize() const {
-        return m_totalSize;
+        return m_buffer.data() ? m_buffer.size() : 0;
     }
     
     /**
      * @brief Get raw packet data
      */
     const uint8_t* data() const {
-        return m_buffer ? m_buffer->bytes() : nullptr;
+        return m_buffer.bytes();
     }
     
     /**
      * @brief Get payload data (after header)
      */
     const uint8_t* payload() const {
-        if (!m_buffer || m_totalSize <= PACKET_HEADER_SIZE) {
+        if (totalSize() <= PACKET_HEADER_SIZE) {
             return nullptr;
         }
-        return m_buffer->bytes() + PACKET_HEADER_SIZE;
+        return m_buffer.bytes() + PACKET_HEADER_SIZE;
     }
     
     /**
      * @brief Get mutable payload data
      */
     uint8_t* payload() {
-        if (!m_buffer || m_totalSize <= PACKET_HEADER_SIZE) {
+        if (totalSize() <= PACKET_HEADER_SIZE) {
             return nullptr;
         }
-        return m_buffer->bytes() + PACKET_HEADER_SIZE;
+        return m_buffer.bytes() + PACKET_HEADER_SIZE;
     }
     
     /**
-     * @brief Associate packet with structure definition
+     * @brief Set the structure definition of this packet's type
+     * 
+     * The structure is kept once per packet type in the registry and the
+     * packet refers to it by slot, so this changes getStructure() for every
+     * packet of this ID attached to the type, not just this one. Passing
+     * nullptr detaches this packet only and leaves the type's structure.
      */
-    void setStructure(std::shared_ptr<Parser::AST::StructDeclaration> structure) {
-        m_structure = structure;
-        m_metadataValid = false;
+    void setTypeStructure(std::shared_ptr<Parser::AST::StructDeclaration> structure) {
+        if (!structure) {
+            m_structureSlot = PacketTypeRegistry::INVALID_SLOT;
+            return;
+        }
+        
+        PacketTypeRegistry* registry = PacketTypeRegistry::instance();
+        m_structureSlot = registry->registerPacketId(id());
+        registry->setStructure(m_structureSlot, std::move(structure));
     }
     
     /**
      * @brief Get associated structure definition
      */
     std::shared_ptr<Parser::AST::StructDeclaration> getStructure() const {
-        return m_structure;
+        return PacketTypeRegistry::instance()->structure(m_structureSlot);
     }
     
     /**
-     * @brief Get structure name
+     * @brief Get structure name ("Unknown" without a structure)
      */
-    const std::string& getStructureName() const {
-        updateMetadata();
-        return m_structureName;
+    std::string getStructureName() const {
+        auto structure = getStructure();
+        return structure ? structure->getName() : std::string("Unknown");
     }
     
     /**
      * @brief Check if packet has specific flag
      */
     bool hasFlag(PacketHeader::Flags flag) const {
-        return m_header ? m_header->hasFlag(flag) : false;
+        return header() ? header()->hasFlag(flag) : false;
     }
     
     /**
      * @brief Set packet flag
      */
     void setFlag(PacketHeader::Flags flag) {
-        if (m_header) {
-            m_header->setFlag(flag);
+        if (PacketHeader* packetHeader = header()) {
+            packetHeader->setFlag(flag);
         }
     }
     
@@ -257,8 +292,8 @@ public:
      * @brief Clear packet flag
      */
     void clearFlag(PacketHeader::Flags flag) {
-        if (m_header) {
-            m_header->clearFlag(flag);
+        if (PacketHeader* packetHeader = header()) {
+            packetHeader->clearFlag(flag);
         }
     }
     
@@ -269,34 +304,37 @@ public:
         ValidationResult result;
         
         // Basic buffer validation
-        if (!m_buffer || !m_buffer->isValid()) {
+        if (!m_buffer.isValid()) {
             result.addError("Invalid or null packet buffer");
             return result;
         }
         
         // Header validation
-        if (!m_header) {
+        const PacketHeader* packetHeader = header();
+        if (!packetHeader) {
             result.addError("Null packet header");
             return result;
         }
         
-        if (!m_header->isValid()) {
-            result.addError("Invalid packet header");
-        }
-        
         // Size validation
-        if (m_totalSize < PACKET_HEADER_SIZE) {
+        const size_t size = totalSize();
+        if (size < PACKET_HEADER_SIZE) {
             result.addError("Packet size smaller than header size");
+            return result;
+        }
+        
+        if (!packetHeader->isValid()) {
+            result.addError("Invalid packet header");
         }
         
-        if (m_header->payloadSize > m_totalSize - PACKET_HEADER_SIZE) {
+        if (packetHeader->payloadSize > size - PACKET_HEADER_SIZE) {
             result.addError("Header payload size exceeds actual payload size");
         }
         
         // Structure validation (if available)
-        if (m_structure) {
-            size_t expectedSize = m_structure->getTotalSize();
-            if (expectedSize > 0 && m_header->payloadSize != expectedSize) {
+        if (auto structure = getStructure()) {
+            size_t expectedSize = structure->getTotalSize();
+            if (expectedSize > 0 && packetHeader->payloadSize != expectedSize) {
                 result.addWarning("Payload size mismatch with structure definition");
             }
         }
@@ -314,19 +352,12 @@ public:
         return result;
     }
     
-    /**
-     * @brief Get cached validation result
-     */
-    const ValidationResult& getLastValidation() const {
-        return m_lastValidation;
-    }
-    
     /**
      * @brief Update sequence number
      */
     void setSequence(SequenceNumber seq) {
-        if (m_header) {
-            m_header->sequence = seq;
+        if (PacketHeader* packetHeader = header()) {
+            packetHeader->sequence = seq;
         }
     }
     
@@ -334,8 +365,8 @@ public:
      * @brief Update timestamp to current time
      */
     void updateTimestamp() {
-        if (m_header) {
-            m_header->timestamp = PacketHeader::getCurrentTimestampNs();
+        if (PacketHeader* packetHeader = header()) {
+            packetHeader->timestamp = PacketHeader::getCurrentTimestampNs();
         }
     }
     
@@ -343,44 +374,177 @@ public:
      * @brief Get buffer pool name
      */
     std::string getPoolName() const {
-        return m_buffer ? m_buffer->poolName().toStdString() : "";
+        return m_buffer.data() ? m_buffer.poolName().toStdString() : "";
     }
     
     /**
      * @brief Get buffer capacity
      */
     size_t getBufferCapacity() const {
-        return m_buffer ? m_buffer->capacity() : 0;
+        return m_buffer.data() ? m_buffer.capacity() : 0;
     }
     
 private:
+    friend class PacketHandle;
+    friend class LatestPacketTable;
+    
+    static PacketBuffer::ManagedBuffer emptyBuffer() {
+        return PacketBuffer::ManagedBuffer(nullptr, 0, Memory::SizeClass::INVALID, nullptr);
+    }
+    
+    void retain() const noexcept {
+        m_refCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    void release() const noexcept {
+        if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            destroy();
+        }
+    }
+    
     /**
-     * @brief Update cached metadata
+     * @brief Free a packet made by create() once its last handle is gone
      */
-    void updateMetadata() const {
-        if (m_metadataValid) {
-            return;
+    void destroy() const noexcept;
+};
+
+static_assert(sizeof(Packet) <= Memory::SizeClass::blockSize(Packet::BLOCK_CLASS),
+              "Packet must fit the pool block create() places it in");
+
+/**
+ * @brief Reference-counted handle to a packet made by Packet::create()
+ * 
+ * The count lives in the packet itself, next to the data it guards, so a
+ * handle is a single pointer and copying one touches no control block.
+ * The count is atomic because handles cross from sources to router
+ * workers and subscribers; the hot path passes handles by const reference
+ * and moves them into queues so it rarely changes the count at all.
+ * Otherwise a handle behaves like the std::shared_ptr it replaces.
+ */
+class PacketHandle {
+public:
+    PacketHandle() noexcept = default;
+    PacketHandle(std::nullptr_t) noexcept {}
+    
+    PacketHandle(const PacketHandle& other) noexcept : m_packet(other.m_packet) {
+        if (m_packet) {
+            m_packet->retain();
         }
-        
-        if (m_structure) {
-            m_structureName = m_structure->getName();
-        } else {
-            m_structureName = "Unknown";
+    }
+    
+    PacketHandle(PacketHandle&& other) noexcept : m_packet(other.m_packet) {
+        other.m_packet = nullptr;
+    }
+    
+    ~PacketHandle() {
+        if (m_packet) {
+            m_packet->release();
         }
-        
-        m_metadataValid = true;
     }
+    
+    PacketHandle& operator=(const PacketHandle& other) noexcept {
+        PacketHandle(other).swap(*this);
+        return *this;
+    }
+    
+    PacketHandle& operator=(PacketHandle&& other) noexcept {
+        PacketHandle(std::move(other)).swap(*this);
+        return *this;
+    }
+    
+    PacketHandle& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+    
+    void reset() noexcept { PacketHandle().swap(*this); }
+    void swap(PacketHandle& other) noexcept { std::swap(m_packet, other.m_packet); }
+    
+    Packet* get() const noexcept { return m_packet; }
+    Packet* operator->() const noexcept { return m_packet; }
+    Packet& operator*() const noexcept { return *m_packet; }
+    explicit operator bool() const noexcept { return m_packet != nullptr; }
+    
+    /**
+     * @brief Handles sharing the packet (0 for an empty handle)
+     */
+    long use_count() const noexcept {
+        return m_packet ? static_cast<long>(m_packet->m_refCount.load(std::memory_order_relaxed)) : 0;
+    }
+    
+    friend bool operator==(const PacketHandle& a, const PacketHandle& b) noexcept { return a.m_packet == b.m_packet; }
+    friend bool operator!=(const PacketHandle& a, const PacketHandle& b) noexcept { return a.m_packet != b.m_packet; }
+    friend bool operator==(const PacketHandle& a, std::nullptr_t) noexcept { return !a.m_packet; }
+    friend bool operator!=(const PacketHandle& a, std::nullptr_t) noexcept { return a.m_packet != nullptr; }
+    friend bool operator==(std::nullptr_t, const PacketHandle& b) noexcept { return !b.m_packet; }
+    friend bool operator!=(std::nullptr_t, const PacketHandle& b) noexcept { return b.m_packet != nullptr; }
+    
+private:
+    friend class Packet;
+    friend class LatestPacketTable;
+    
+    // Adopts a packet with no handles yet
+    explicit PacketHandle(Packet* packet) noexcept : m_packet(packet) {
+        m_packet->retain();
+    }
+    
+    Packet* m_packet = nullptr;
 };
 
 /**
- * @brief Shared pointer to packet for efficient sharing
+ * @brief Handle to a packet for efficient sharing
  */
-using PacketPtr = std::shared_ptr<Packet>;
+using PacketPtr = PacketHandle;
 
 /**
- * @brief Weak pointer to packet to avoid circular references
+ * @brief Non-owning view of consecutive packets, as handed to batch consumers
+ * 
+ * Valid only for the duration of the call it is passed to; consumers that
+ * keep packets copy the PacketPtrs they need.
  */
-using PacketWeakPtr = std::weak_ptr<Packet>;
+class PacketSpan {
+public:
+    PacketSpan() = default;
+    PacketSpan(const PacketPtr* packets, size_t count) : m_packets(packets), m_count(count) {}
+    
+    const PacketPtr* begin() const { return m_packets; }
+    const PacketPtr* end() const { return m_packets + m_count; }
+    const PacketPtr& operator[](size_t index) const { return m_packets[index]; }
+    const PacketPtr* data() const { return m_packets; }
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    
+private:
+    const PacketPtr* m_packets = nullptr;
+    size_t m_count = 0;
+};
+
+// Implementation
+
+inline PacketHandle Packet::create(PacketBuffer::ManagedBufferPtr buffer, Memory::SizeClassAllocator* allocator)
+{
+    void* block = allocator ? allocator->allocate(BLOCK_CLASS) : nullptr;
+    if (!block) {
+        return PacketHandle(new Packet(std::move(buffer)));
+    }
+    
+    Packet* packet = new (block) Packet(std::move(buffer));
+    packet->m_blockAllocator = allocator;
+    return PacketHandle(packet);
+}
+
+inline void Packet::destroy() const noexcept
+{
+    Packet* packet = const_cast<Packet*>(this);
+    Memory::SizeClassAllocator* allocator = m_blockAllocator;
+    if (!allocator) {
+        delete packet;
+        return;
+    }
+    
+    packet->~Packet();
+    allocator->deallocate(BLOCK_CLASS, packet);
+}
 
 } // namespace Packet
 } // namespace Monitor
\ No newline at end of file
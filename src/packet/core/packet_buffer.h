@@ -7,17 +7,20 @@
 #include <memory>
 #include <cstring>
 #include <stdexcept>
+#include <algorithm>
+#include <vector>
 #include <QString>
 
 namespace Monitor {
 namespace Packet {
 
 /**
- * @brief Zero-copy packet buffer management using Phase 1 memory pools
+ * @brief Zero-copy packet buffer management using the size-class allocator
  * 
- * This class manages packet data storage using the existing memory pool
- * infrastructure. It provides zero-copy semantics where possible and
- * ensures proper memory alignment for high-performance packet processing.
+ * This class manages packet data storage using the index-addressed
+ * SizeClassAllocator owned by the MemoryPoolManager. It provides zero-copy
+ * semantics where possible and ensures proper memory alignment for
+ * high-performance packet processing.
  */
 class PacketBuffer {
 public:
@@ -28,66 +31,66 @@ public:
         void* data = nullptr;           ///< Pointer to allocated memory
         size_t size = 0;                ///< Size of allocated buffer
         size_t capacity = 0;            ///< Total capacity of buffer
-        QString poolName;               ///< Name of memory pool used
+        Memory::SizeClass::Index sizeClass = Memory::SizeClass::INVALID; ///< Size class used
         bool success = false;           ///< Allocation success flag
         
         BufferAllocation() = default;
-        BufferAllocation(void* ptr, size_t sz, size_t cap, const QString& pool)
-            : data(ptr), size(sz), capacity(cap), poolName(pool), success(ptr != nullptr)
+        BufferAllocation(void* ptr, size_t sz, Memory::SizeClass::Index cls)
+            : data(ptr), size(sz), capacity(Memory::SizeClass::blockSize(cls)), 
+              sizeClass(cls), success(ptr != nullptr)
         {
         }
     };
     
     /**
      * @brief Smart pointer for packet buffer with automatic cleanup
+     * 
+     * Holds the size class index of its block, so releasing it is a direct
+     * allocator call with no name lookup.
      */
     class ManagedBuffer {
     private:
         void* m_data;
         size_t m_size;
-        size_t m_capacity;
-        QString m_poolName;
-        Memory::MemoryPoolManager* m_manager;
+        Memory::SizeClass::Index m_sizeClass;
+        Memory::SizeClassAllocator* m_allocator;
         
     public:
-        ManagedBuffer(void* data, size_t size, size_t capacity, 
-                     const QString& poolName, Memory::MemoryPoolManager* manager)
-            : m_data(data), m_size(size), m_capacity(capacity), 
-              m_poolName(poolName), m_manager(manager)
+        ManagedBuffer(void* data, size_t size, Memory::SizeClass::Index sizeClass,
+                     Memory::SizeClassAllocator* allocator)
+            : m_data(data), m_size(size), m_sizeClass(sizeClass), m_allocator(allocator)
         {
         }
         
         ~ManagedBuffer() {
-            if (m_data && m_manager) {
-                m_manager->deallocate(m_poolName, m_data);
+            if (m_data && m_allocator) {
+                m_allocator->deallocate(m_sizeClass, m_data);
             }
         }
         
         // Move constructor
         ManagedBuffer(ManagedBuffer&& other) noexcept
             : m_data(other.m_data), m_size(other.m_size), 
-              m_capacity(other.m_capacity), m_poolName(other.m_poolName),
-              m_manager(other.m_manager)
+              m_sizeClass(other.m_sizeClass), m_allocator(other.m_allocator)
         {
             other.m_data = nullptr;
-            other.m_manager = nullptr;
+            other.m_allocator = nullptr;
         }
         
         // Move assignment
         ManagedBuffer& operator=(ManagedBuffer&& other) noexcept {
             if (this != &other) {
-                if (m_data && m_manager) {
-                    m_manager->deallocate(m_poolName, m_data);
+                if (m_data && m_allocator) {
+                    m_allocator->deallocate(m_sizeClass, m_data);
                 }
                 
                 m_data = other.m_data;
                 m_size = other.m_size;
-                m_capacity = other.m_capacity;
-                m_poolName = other.m_poolName;
-                m_manager = other.m_manager;
+                m_sizeClass = other.m_sizeClass;
+                m_allocator = other.m_allocator;
                 
                 other.m_data = nullptr;
-                other.m_manager = nullptr;
+                other.m_allocator = nullptr;
             }
             return *this;
         }
@@ -98,10 +101,22 @@ public:
         
         void* data() const { return m_data; }
         size_t size() const { return m_size; }
-        size_t capacity() const { return m_capacity; }
-        const QString& poolName() const { return m_poolName; }
+        size_t capacity() const { return Memory::SizeClass::blockSize(m_sizeClass); }
+        Memory::SizeClass::Index sizeClass() const { return m_sizeClass; }
+        QString poolName() const { return QString::fromLatin1(Memory::SizeClass::name(m_sizeClass)); }
         
-        bool isValid() const { return m_data != nullptr && m_manager != nullptr; }
+        bool isValid() const { return m_data != nullptr && m_allocator != nullptr; }
+        
+        /**
+         * @brief Set the number of valid bytes (must fit the block)
+         */
+        bool resize(size_t newSize) {
+            if (newSize > capacity()) {
+                return false;
+            }
+            m_size = newSize;
+            return true;
+        }
         
         template<typename T>
         T* as() const {
@@ -117,11 +132,13 @@ public:
     
 private:
     Memory::MemoryPoolManager* m_memoryManager;
+    Memory::SizeClassAllocator* m_allocator;
     Logging::Logger* m_logger;
     
 public:
     explicit PacketBuffer(Memory::MemoryPoolManager* manager)
         : m_memoryManager(manager)
+        , m_allocator(manager ? manager->packetAllocator() : nullptr)
         , m_logger(Logging::Logger::instance())
     {
         if (!m_memoryManager) {
@@ -132,42 +149,43 @@ public:
     /**
      * @brief Allocate buffer for packet of given size
      * 
-     * Selects appropriate memory pool based on packet size:
+     * Selects the smallest compile-time size class that fits:
      * - SmallObjects (64B): Packets up to 64 bytes
      * - MediumObjects (512B): Packets up to 512 bytes  
      * - WidgetData (1KB): Packets up to 1KB
      * - TestFramework (2KB): Packets up to 2KB
      * - PacketBuffer (4KB): Packets up to 4KB
      * - LargeObjects (8KB): Packets up to 8KB
+     * 
+     * The requested range is zero-filled.
      */
     ManagedBufferPtr allocate(size_t totalSize) {
-        if (totalSize == 0) {
-            m_logger->warning("PacketBuffer", "Attempted to allocate zero-size buffer");
-            return nullptr;
-        }
-        
-        if (totalSize > PacketHeader::MAX_PAYLOAD_SIZE + PACKET_HEADER_SIZE) {
-            m_logger->error("PacketBuffer", 
-                QString("Requested size %1 exceeds maximum packet size %2")
-                .arg(totalSize).arg(PacketHeader::MAX_PAYLOAD_SIZE + PACKET_HEADER_SIZE));
-            return nullptr;
+        auto buffer = allocateUninitialized(totalSize);
+        if (buffer) {
+            std::memset(buffer->data(), 0, totalSize);
         }
-        
-        QString poolName = selectMemoryPool(totalSize);
-        void* data = m_memoryManager->allocate(poolName);
-        
-        if (!data) {
-            m_logger->error("PacketBuffer", 
-                QString("Failed to allocate %1 bytes from pool %2")
-                .arg(totalSize).arg(poolName));
-            return nullptr;
+        return buffer;
+    }
+    
+    /**
+     * @brief Allocate an uninitialised buffer for a producer to write into
+     * 
+     * The buffer's size is set to its full block capacity; the producer
+     * shrinks it with ManagedBuffer::resize() once the real length is known.
+     */
+    ManagedBufferPtr allocateForWrite(size_t capacity) {
+        auto buffer = allocateUninitialized(capacity);
+        if (buffer) {
+            buffer->resize(buffer->capacity());
         }
-        
-        size_t poolBlockSize = getPoolBlockSize(poolName);
-        
-        return std::make_unique<ManagedBuffer>(
-            data, totalSize, poolBlockSize, poolName, m_memoryManager
-        );
+        return buffer;
+    }
+    
+    /**
+     * @brief Largest buffer a single allocation can provide
+     */
+    static constexpr size_t maxBufferSize() {
+        return Memory::SizeClass::MAX_BLOCK_SIZE;
     }
     
     /**
@@ -181,7 +199,7 @@ public:
      * @brief Create buffer from existing data (copy)
      */
     ManagedBufferPtr createFromData(const void* data, size_t size) {
-        auto buffer = allocate(size);
+        auto buffer = data ? allocateUninitialized(size) : allocate(size);
         if (buffer && data) {
             std::memcpy(buffer->data(), data, size);
         }
@@ -192,14 +210,16 @@ public:
      * @brief Create buffer for specific packet ID with payload size
      */
     ManagedBufferPtr createForPacket(PacketId id, const void* payload, size_t payloadSize) {
-        auto buffer = allocateForPacket(payloadSize);
+        const bool copyPayload = payload && payloadSize > 0;
+        auto buffer = copyPayload ? allocateUninitialized(PACKET_HEADER_SIZE + payloadSize)
+                                  : allocateForPacket(payloadSize);
         if (buffer) {
             // Initialize header
             PacketHeader* header = buffer->as<PacketHeader>();
             *header = PacketHeader(id, 0, static_cast<uint32_t>(payloadSize));
             
             // Copy payload if provided
-            if (payload && payloadSize > 0) {
+            if (copyPayload) {
                 uint8_t* payloadPtr = buffer->bytes() + PACKET_HEADER_SIZE;
                 std::memcpy(payloadPtr, payload, payloadSize);
             }
@@ -221,23 +241,23 @@ public:
     
     std::vector<PoolStats> getPoolStatistics() const {
         std::vector<PoolStats> stats;
+        if (!m_allocator) {
+            return stats;
+        }
+        stats.reserve(Memory::SizeClass::COUNT);
         
-        // Get statistics from all packet-related pools
-        std::vector<QString> pools = {
-            "SmallObjects", "MediumObjects", "WidgetData", 
-            "TestFramework", "PacketBuffer", "LargeObjects"
-        };
-        
-        for (const auto& poolName : pools) {
-            // For now, just return basic stats since hasPool and getPoolStatistics
-            // methods need to be added to MemoryPoolManager
+        for (size_t i = 0; i < Memory::SizeClass::COUNT; ++i) {
+            const auto index = static_cast<Memory::SizeClass::Index>(i);
+            const auto classStats = m_allocator->getClassStatistics(index);
+            const size_t used = std::min(classStats.usedBlocks, classStats.blockCount);
+            
             stats.push_back({
-                poolName,
-                getPoolBlockSize(poolName),
-                0,  // totalBlocks - would need to be implemented
-                0,  // usedBlocks - would need to be implemented
-                0,  // freeBlocks - would need to be implemented
-                0.0 // utilization - would need to be implemented
+                QString::fromLatin1(Memory::SizeClass::name(index)),
+                classStats.blockSize,
+                classStats.blockCount,
+                used,
+                classStats.blockCount - used,
+                classStats.blockCount > 0 ? static_cast<double>(used) / classStats.blockCount : 0.0
             });
         }
         
@@ -248,38 +268,48 @@ public:
      * @brief Get total memory usage across all packet pools
      */
     size_t getTotalMemoryUsage() const {
-        size_t total = 0;
-        auto stats = getPoolStatistics();
-        for (const auto& stat : stats) {
-            total += stat.usedBlocks * stat.blockSize;
-        }
-        return total;
+        return m_allocator ? m_allocator->getTotalMemoryUsed() : 0;
     }
     
 private:
     /**
-     * @brief Select appropriate memory pool based on size
-     */
-    QString selectMemoryPool(size_t size) const {
-        if (size <= 64) return "SmallObjects";
-        if (size <= 512) return "MediumObjects";
-        if (size <= 1024) return "WidgetData";
-        if (size <= 2048) return "TestFramework";
-        if (size <= 4096) return "PacketBuffer";
-        return "LargeObjects"; // Up to 8KB
-    }
-    
-    /**
-     * @brief Get block size for memory pool
+     * @brief Allocate a block without clearing it (for paths that overwrite it)
      */
-    size_t getPoolBlockSize(const QString& poolName) const {
-        if (poolName == "SmallObjects") return 64;
-        if (poolName == "MediumObjects") return 512;
-        if (poolName == "WidgetData") return 1024;
-        if (poolName == "TestFramework") return 2048;
-        if (poolName == "PacketBuffer") return 4096;
-        if (poolName == "LargeObjects") return 8192;
-        return 0;
+    ManagedBufferPtr allocateUninitialized(size_t totalSize) {
+        if (!m_allocator) {
+            m_logger->error("PacketBuffer", "No packet allocator; memory manager was not provided");
+            return nullptr;
+        }
+        
+        if (totalSize == 0) {
+            m_logger->warning("PacketBuffer", "Attempted to allocate zero-size buffer");
+            return nullptr;
+        }
+        
+        if (totalSize > PacketHeader::MAX_PAYLOAD_SIZE + PACKET_HEADER_SIZE) {
+            m_logger->error("PacketBuffer", 
+                QString("Requested size %1 exceeds maximum packet size %2")
+                .arg(totalSize).arg(PacketHeader::MAX_PAYLOAD_SIZE + PACKET_HEADER_SIZE));
+            return nullptr;
+        }
+        
+        const Memory::SizeClass::Index sizeClass = Memory::SizeClass::forSize(totalSize);
+        if (sizeClass == Memory::SizeClass::INVALID) {
+            m_logger->error("PacketBuffer", 
+                QString("Requested size %1 exceeds largest size class %2")
+                .arg(totalSize).arg(Memory::SizeClass::MAX_BLOCK_SIZE));
+            return nullptr;
+        }
+        
+        void* data = m_allocator->allocate(sizeClass);
+        if (!data) {
+            m_logger->error("PacketBuffer", 
+                QString("Failed to allocate %1 bytes from size class %2")
+                .arg(totalSize).arg(Memory::SizeClass::name(sizeClass)));
+            return nullptr;
+        }
+        
+        return std::make_unique<ManagedBuffer>(data, totalSize, sizeClass, m_allocator);
     }
 };
 
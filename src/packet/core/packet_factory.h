@@ -2,6 +2,7 @@
 
 #include "packet.h"
 #include "packet_buffer.h"
+#include "packet_type_registry.h"
 #include "../../parser/manager/structure_manager.h"
 #include "../../events/event_dispatcher.h"
 #include "../../logging/logger.h"
@@ -13,6 +14,7 @@
 #include <unordered_map>
 #include <functional>
 #include <atomic>
+#include <algorithm>
 
 namespace Monitor {
 namespace Packet {
@@ -38,7 +40,7 @@ public:
         std::chrono::nanoseconds creationTime{0};
         
         CreationResult() = default;
-        CreationResult(PacketPtr pkt) : packet(pkt), success(pkt != nullptr) {}
+        CreationResult(PacketPtr pkt) : packet(std::move(pkt)), success(packet != nullptr) {}
         CreationResult(const std::string& err) : success(false), error(err) {}
     };
     
@@ -73,13 +75,15 @@ public:
 
 private:
     std::unique_ptr<PacketBuffer> m_packetBuffer;
+    Memory::SizeClassAllocator* m_packetAllocator;  ///< Pool packets are placed in
     Parser::StructureManager* m_structureManager;
     Events::EventDispatcher* m_eventDispatcher;
     Logging::Logger* m_logger;
     Profiling::Profiler* m_profiler;
     
-    // Structure cache for fast packet ID to structure mapping
-    std::unordered_map<PacketId, std::shared_ptr<Parser::AST::StructDeclaration>> m_structureCache;
+    // Structure cache for fast packet ID to structure mapping, indexed by packet type slot
+    PacketSlotTable<std::shared_ptr<Parser::AST::StructDeclaration>> m_structureCache;
+    PacketTypeRegistry* m_registry;
     mutable std::shared_mutex m_cacheMutex;
     
     // Statistics
@@ -92,10 +96,12 @@ public:
     explicit PacketFactory(Memory::MemoryPoolManager* memoryManager, QObject* parent = nullptr)
         : QObject(parent)
         , m_packetBuffer(std::make_unique<PacketBuffer>(memoryManager))
+        , m_packetAllocator(memoryManager ? memoryManager->packetAllocator() : nullptr)
         , m_structureManager(nullptr)
         , m_eventDispatcher(nullptr)
         , m_logger(Logging::Logger::instance())
         , m_profiler(Profiling::Profiler::instance())
+        , m_registry(PacketTypeRegistry::instance())
     {
         if (!memoryManager) {
             throw std::invalid_argument("Memory manager cannot be null");
@@ -127,8 +133,10 @@ public:
     
     /**
      * @brief Create packet from raw data
+     * @param headerOrder Byte order the packet header was written in
      */
-    CreationResult createFromRawData(const void* data, size_t size) {
+    CreationResult createFromRawData(const void* data, size_t size,
+                                     Parser::Layout::ByteOrder headerOrder = Parser::Layout::ByteOrder::Native) {
         PROFILE_FUNCTION();
         auto startTime = std::chrono::high_resolution_clock::now();
         
@@ -148,26 +156,47 @@ public:
             return CreationResult(error);
         }
         
-        // Create packet
-        auto packet = std::make_shared<Packet>(std::move(buffer));
-        if (!packet->isValid()) {
-            std::string error = "Created invalid packet";
+        return finalizeRawPacket(std::move(buffer), size, headerOrder, startTime);
+    }
+    
+    /**
+     * @brief Acquire a writable pooled buffer for zero-copy ingestion
+     * 
+     * Sources receive straight into the returned (uninitialised) buffer and
+     * hand it to commitBuffer(), so each packet is copied exactly once from
+     * the kernel or file into pool memory. @p capacity is clamped to the
+     * largest size class; pass the pending datagram or packet size when it is
+     * known to avoid tying up a larger block than necessary.
+     */
+    PacketBuffer::ManagedBufferPtr acquireBuffer(size_t capacity) {
+        capacity = std::min(capacity, PacketBuffer::maxBufferSize());
+        if (capacity < PACKET_HEADER_SIZE) {
+            m_stats.packetsWithErrors++;
+            return nullptr;
+        }
+        return m_packetBuffer->allocateForWrite(capacity);
+    }
+    
+    /**
+     * @brief Turn a buffer filled by a source into a packet without copying
+     * @param buffer Buffer obtained from acquireBuffer()
+     * @param bytesWritten Number of valid packet bytes written into it
+     * @param headerOrder Byte order the sender wrote the packet header in;
+     *        the header is swapped to host order in place
+     */
+    CreationResult commitBuffer(PacketBuffer::ManagedBufferPtr buffer, size_t bytesWritten,
+                                Parser::Layout::ByteOrder headerOrder = Parser::Layout::ByteOrder::Native) {
+        auto startTime = std::chrono::high_resolution_clock::now();
+        
+        if (!buffer || !buffer->isValid() || bytesWritten < PACKET_HEADER_SIZE || 
+            !buffer->resize(bytesWritten)) {
+            std::string error = "Invalid buffer or size for committed packet";
             m_logger->error("PacketFactory", error.c_str());
             m_stats.packetsWithErrors++;
             return CreationResult(error);
         }
         
-        // Try to associate with structure
-        associateStructure(packet);
-        
-        // Update statistics
-        updateCreationStats(startTime, size, CreationType::FromRawData);
-        
-        m_logger->debug("PacketFactory", 
-            QString("Created packet from raw data: ID=%1, size=%2 bytes")
-            .arg(packet->id()).arg(size));
-        
-        return CreationResult(packet);
+        return finalizeRawPacket(std::move(buffer), bytesWritten, headerOrder, startTime);
     }
     
     /**
@@ -187,7 +216,7 @@ public:
         }
         
         // Create packet
-        auto packet = std::make_shared<Packet>(std::move(buffer));
+        auto packet = Packet::create(std::move(buffer), m_packetAllocator);
         if (!packet->isValid()) {
             std::string error = "Created invalid packet";
             m_logger->error("PacketFactory", error.c_str());
@@ -208,7 +237,7 @@ public:
             QString("Created new packet: ID=%1, payload size=%2 bytes")
             .arg(id).arg(payloadSize));
         
-        return CreationResult(packet);
+        return CreationResult(std::move(packet));
     }
     
     /**
@@ -244,9 +273,9 @@ public:
             return result;
         }
         
-        // Associate with structure (cast away const for compatibility)
+        // The structure becomes that of the whole packet type (cast away const for compatibility)
         auto nonConstStructure = std::const_pointer_cast<Parser::AST::StructDeclaration>(structure);
-        result.packet->setStructure(nonConstStructure);
+        result.packet->setTypeStructure(nonConstStructure);
         
         // Cache structure for future lookups
         cacheStructure(id, nonConstStructure);
@@ -307,14 +336,15 @@ public:
      */
     bool hasStructureForPacketId(PacketId id) const {
         std::shared_lock lock(m_cacheMutex);
-        return m_structureCache.find(id) != m_structureCache.end();
+        const auto* entry = m_structureCache.find(m_registry->findSlot(id));
+        return entry && *entry;
     }
 
 signals:
     /**
      * @brief Emitted when a packet is successfully created
      */
-    void packetCreated(PacketPtr packet);
+    void packetCreated(const PacketPtr& packet);
     
     /**
      * @brief Emitted when packet creation fails
@@ -336,13 +366,12 @@ private slots:
         m_logger->debug("PacketFactory", QString("Structure removed: %1").arg(name));
         // Invalidate cache entries that use this structure
         std::unique_lock lock(m_cacheMutex);
-        for (auto it = m_structureCache.begin(); it != m_structureCache.end();) {
-            if (it->second && it->second->getName() == name.toStdString()) {
-                it = m_structureCache.erase(it);
-            } else {
-                ++it;
+        const std::string structureName = name.toStdString();
+        m_structureCache.forEach([&](PacketTypeRegistry::Slot, std::shared_ptr<Parser::AST::StructDeclaration>& structure) {
+            if (structure && structure->getName() == structureName) {
+                structure.reset();
             }
-        }
+        });
     }
 
 private:
@@ -352,10 +381,39 @@ private:
         New
     };
     
+    /**
+     * @brief Wrap a filled raw buffer into a validated packet
+     */
+    CreationResult finalizeRawPacket(PacketBuffer::ManagedBufferPtr buffer, size_t size,
+                                     Parser::Layout::ByteOrder headerOrder,
+                                     const std::chrono::high_resolution_clock::time_point& startTime) {
+        buffer->as<PacketHeader>()->convertToHostOrder(headerOrder);
+        
+        auto packet = Packet::create(std::move(buffer), m_packetAllocator);
+        if (!packet->isValid()) {
+            std::string error = "Created invalid packet";
+            m_logger->error("PacketFactory", error.c_str());
+            m_stats.packetsWithErrors++;
+            return CreationResult(error);
+        }
+        
+        // Try to associate with structure
+        associateStructure(packet);
+        
+        // Update statistics
+        updateCreationStats(startTime, size, CreationType::FromRawData);
+        
+        m_logger->debug("PacketFactory", 
+            QString("Created packet from raw data: ID=%1, size=%2 bytes")
+            .arg(packet->id()).arg(size));
+        
+        return CreationResult(std::move(packet));
+    }
+    
     /**
      * @brief Associate packet with structure definition if possible
      */
-    void associateStructure(PacketPtr packet) {
+    void associateStructure(const PacketPtr& packet) {
         if (!packet || !m_structureManager) {
             return;
         }
@@ -365,9 +423,10 @@ private:
         // Check cache first
         {
             std::shared_lock lock(m_cacheMutex);
-            auto it = m_structureCache.find(id);
-            if (it != m_structureCache.end() && it->second) {
-                packet->setStructure(it->second);
+            const auto* entry = m_structureCache.find(m_registry->findSlot(id));
+            if (entry && *entry) {
+                // The cache is per type too, so this re-sets the type's own structure
+                packet->setTypeStructure(*entry);
                 return;
             }
         }
@@ -381,8 +440,14 @@ private:
      * @brief Cache structure for packet ID
      */
     void cacheStructure(PacketId id, std::shared_ptr<Parser::AST::StructDeclaration> structure) {
+        auto* entry = m_structureCache.obtain(m_registry->registerPacketId(id));
+        if (!entry) {
+            m_logger->warning("PacketFactory", QString("No packet type slot left to cache packet ID %1").arg(id));
+            return;
+        }
+        
         std::unique_lock lock(m_cacheMutex);
-        m_structureCache[id] = structure;
+        *entry = structure;
     }
     
     /**
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <chrono>
 
+#include "../../parser/layout/byte_order.h"
+
 namespace Monitor {
 namespace Packet {
 
@@ -99,6 +101,23 @@ struct PacketHeader {
         flags &= ~static_cast<uint32_t>(flag);
     }
     
+    /**
+     * @brief Convert a header that arrived in @p wireOrder to host order in place
+     *
+     * Sources call this once per packet, before anything reads the header,
+     * so the rest of the pipeline always sees host order.
+     */
+    void convertToHostOrder(Parser::Layout::ByteOrder wireOrder) {
+        if (!Parser::Layout::needsByteSwap(wireOrder)) {
+            return;
+        }
+        id = Parser::Layout::byteSwap(id);
+        sequence = Parser::Layout::byteSwap(sequence);
+        timestamp = Parser::Layout::byteSwap(timestamp);
+        payloadSize = Parser::Layout::byteSwap(payloadSize);
+        flags = Parser::Layout::byteSwap(flags);
+    }
+    
     /**
      * @brief Get current timestamp in nanoseconds
      */
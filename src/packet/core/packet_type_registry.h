@@ -0,0 +1,266 @@
+#pragma once
+
+#include "packet_header.h"
+#include "../../concurrent/rcu_pointer.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace Monitor {
+namespace Parser {
+namespace AST {
+class StructDeclaration;
+}
+}
+
+namespace Packet {
+
+/**
+ * @brief Assigns every known packet ID a compact slot number
+ *
+ * Components that keep per-packet-type state index it by slot in a
+ * PacketSlotTable rather than hashing the packet ID on every packet.
+ * Slots are handed out in registration order and never reused, so the
+ * tables stay as small as the number of packet types in use.
+ *
+ * IDs below DIRECT_ID_LIMIT, which covers the dense IDs of the packet
+ * definitions, resolve with a single array load. Larger IDs go through a
+ * hash map that is read without locking. Lookups are lock-free; only
+ * registering a new ID takes a mutex.
+ *
+ * The registry also holds the structure definition of each packet type,
+ * so packets refer to their structure by slot instead of each keeping a
+ * pointer to it.
+ */
+class PacketTypeRegistry
+{
+public:
+    using Slot = uint32_t;
+
+    static constexpr Slot INVALID_SLOT = std::numeric_limits<Slot>::max();
+    static constexpr Slot MAX_SLOTS = 4096;
+    static constexpr PacketId DIRECT_ID_LIMIT = 65536;
+
+    /**
+     * @brief Process-wide registry shared by all components
+     */
+    static PacketTypeRegistry* instance() {
+        static PacketTypeRegistry registry;
+        return &registry;
+    }
+
+    PacketTypeRegistry()
+        : m_directSlots(new std::atomic<Slot>[DIRECT_ID_LIMIT])
+    {
+        for (PacketId id = 0; id < DIRECT_ID_LIMIT; ++id) {
+            m_directSlots[id].store(INVALID_SLOT, std::memory_order_relaxed);
+        }
+    }
+
+    PacketTypeRegistry(const PacketTypeRegistry&) = delete;
+    PacketTypeRegistry& operator=(const PacketTypeRegistry&) = delete;
+
+    /**
+     * @brief Slot of a registered packet ID
+     * @return INVALID_SLOT if @p id was never registered
+     */
+    Slot findSlot(PacketId id) const noexcept {
+        if (id < DIRECT_ID_LIMIT) {
+            return m_directSlots[id].load(std::memory_order_acquire);
+        }
+
+        Concurrent::EpochDomain::ReadGuard guard;
+        const auto* sparse = m_sparseSlots.load();
+        auto it = sparse->find(id);
+        return (it != sparse->end()) ? it->second : INVALID_SLOT;
+    }
+
+    /**
+     * @brief Slot of a packet ID, registering it on first use
+     * @return INVALID_SLOT once all MAX_SLOTS slots are taken
+     */
+    Slot registerPacketId(PacketId id);
+
+    /**
+     * @brief Packet ID a slot was assigned to
+     */
+    PacketId packetId(Slot slot) const noexcept {
+        return slot < slotCount() ? m_slotIds[slot] : 0;
+    }
+
+    /**
+     * @brief Slots assigned so far
+     */
+    Slot slotCount() const noexcept {
+        return m_slotCount.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Set the structure definition of the packet type in @p slot
+     */
+    void setStructure(Slot slot, std::shared_ptr<Parser::AST::StructDeclaration> structure) {
+        if (slot < MAX_SLOTS) {
+            std::atomic_store_explicit(&m_structures[slot], std::move(structure), std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Structure definition of the packet type in @p slot, or nullptr
+     */
+    std::shared_ptr<Parser::AST::StructDeclaration> structure(Slot slot) const {
+        if (slot >= MAX_SLOTS) {
+            return nullptr;
+        }
+        return std::atomic_load_explicit(&m_structures[slot], std::memory_order_acquire);
+    }
+
+private:
+    std::unique_ptr<std::atomic<Slot>[]> m_directSlots;     ///< Indexed by packet ID
+    Concurrent::RcuPointer<std::unordered_map<PacketId, Slot>> m_sparseSlots;
+    std::array<PacketId, MAX_SLOTS> m_slotIds{};            ///< Written before the slot is published
+    std::atomic<Slot> m_slotCount{0};
+    std::mutex m_registerMutex;
+    std::array<std::shared_ptr<Parser::AST::StructDeclaration>, MAX_SLOTS> m_structures;  ///< Accessed atomically
+};
+
+/**
+ * @brief Per-packet-type state indexed by PacketTypeRegistry slot
+ *
+ * Entries are cache-line aligned so state updated by different threads
+ * for different packet types never shares a line. Storage grows in chunks
+ * that are never moved or freed before the table, so find() is lock-free
+ * and a returned pointer stays valid for the table's lifetime. Entries
+ * start default constructed; synchronising access to their contents is up
+ * to the caller.
+ */
+template<typename T>
+class PacketSlotTable
+{
+public:
+    using Slot = PacketTypeRegistry::Slot;
+
+    PacketSlotTable() = default;
+    ~PacketSlotTable();
+
+    PacketSlotTable(const PacketSlotTable&) = delete;
+    PacketSlotTable& operator=(const PacketSlotTable&) = delete;
+
+    /**
+     * @brief Entry for @p slot, or nullptr if it was never obtained
+     */
+    T* find(Slot slot) const noexcept {
+        if (slot >= PacketTypeRegistry::MAX_SLOTS) {
+            return nullptr;
+        }
+        Entry* chunk = m_chunks[slot / CHUNK_SLOTS].load(std::memory_order_acquire);
+        return chunk ? &chunk[slot % CHUNK_SLOTS].value : nullptr;
+    }
+
+    /**
+     * @brief Entry for @p slot, allocating its chunk if needed
+     * @return nullptr if @p slot is out of range
+     */
+    T* obtain(Slot slot);
+
+    /**
+     * @brief Visit every entry in allocated chunks with its slot
+     */
+    template<typename Function>
+    void forEach(Function&& function) const;
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr Slot CHUNK_SLOTS = 64;
+    static constexpr Slot CHUNK_COUNT = PacketTypeRegistry::MAX_SLOTS / CHUNK_SLOTS;
+
+    struct alignas(CACHE_LINE_SIZE) Entry {
+        T value{};
+    };
+
+    std::array<std::atomic<Entry*>, CHUNK_COUNT> m_chunks{};
+};
+
+// Implementation
+
+inline PacketTypeRegistry::Slot PacketTypeRegistry::registerPacketId(PacketId id)
+{
+    Slot slot = findSlot(id);
+    if (slot != INVALID_SLOT) {
+        return slot;
+    }
+
+    std::lock_guard<std::mutex> lock(m_registerMutex);
+
+    slot = findSlot(id);
+    if (slot != INVALID_SLOT) {
+        return slot;
+    }
+
+    slot = m_slotCount.load(std::memory_order_relaxed);
+    if (slot >= MAX_SLOTS) {
+        return INVALID_SLOT;
+    }
+
+    m_slotIds[slot] = id;
+    m_slotCount.store(slot + 1, std::memory_order_release);
+
+    if (id < DIRECT_ID_LIMIT) {
+        m_directSlots[id].store(slot, std::memory_order_release);
+    } else {
+        auto sparse = std::make_unique<std::unordered_map<PacketId, Slot>>(*m_sparseSlots.writerView());
+        (*sparse)[id] = slot;
+        m_sparseSlots.publish(std::move(sparse));
+    }
+    return slot;
+}
+
+template<typename T>
+PacketSlotTable<T>::~PacketSlotTable()
+{
+    for (auto& chunk : m_chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+template<typename T>
+T* PacketSlotTable<T>::obtain(Slot slot)
+{
+    if (slot >= PacketTypeRegistry::MAX_SLOTS) {
+        return nullptr;
+    }
+
+    auto& chunkPointer = m_chunks[slot / CHUNK_SLOTS];
+    Entry* chunk = chunkPointer.load(std::memory_order_acquire);
+    if (!chunk) {
+        Entry* allocated = new Entry[CHUNK_SLOTS];
+        if (chunkPointer.compare_exchange_strong(chunk, allocated, std::memory_order_acq_rel)) {
+            chunk = allocated;
+        } else {
+            delete[] allocated;     // Another thread allocated it first
+        }
+    }
+    return &chunk[slot % CHUNK_SLOTS].value;
+}
+
+template<typename T>
+template<typename Function>
+void PacketSlotTable<T>::forEach(Function&& function) const
+{
+    for (Slot chunkIndex = 0; chunkIndex < CHUNK_COUNT; ++chunkIndex) {
+        Entry* chunk = m_chunks[chunkIndex].load(std::memory_order_acquire);
+        if (!chunk) {
+            continue;
+        }
+        for (Slot i = 0; i < CHUNK_SLOTS; ++i) {
+            function(chunkIndex * CHUNK_SLOTS + i, chunk[i].value);
+        }
+    }
+}
+
+} // namespace Packet
+} // namespace Monitor
@@ -8,12 +8,15 @@
 #include "processing/packet_processor.h"
 #include "../parser/manager/structure_manager.h"
 #include "../threading/thread_manager.h"
+#include "../threading/pipeline_topology.h"
 #include "../events/event_dispatcher.h"
 #include "../memory/memory_pool.h"
 #include "../logging/logger.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
 #include <QString>
 #include <memory>
 #include <vector>
@@ -45,6 +48,9 @@ public:
         uint32_t statisticsUpdateIntervalMs; ///< Statistics update interval
         bool enablePerformanceMonitoring;    ///< Enable performance monitoring
         
+        // Placement of the pipeline's threads and memory; empty to let everything float
+        Threading::PipelineTopology topology;
+        
         Configuration() 
             : autoStart(false)
             , statisticsUpdateIntervalMs(1000)
@@ -159,6 +165,8 @@ public:
         }
         
         try {
+            applyTopology();
+            
             // Initialize components in dependency order
             if (!initializePacketFactory()) {
                 setState(State::Error);
@@ -365,6 +373,20 @@ public:
         return m_packetDispatcher->subscribe(subscriberName, packetId, callback, priority);
     }
     
+    /**
+     * @brief Subscribe to packet type with a delivery policy
+     */
+    SubscriptionManager::SubscriberId subscribe(const std::string& subscriberName,
+                                               PacketId packetId,
+                                               SubscriptionManager::PacketCallback callback,
+                                               const SubscriptionManager::SubscriptionOptions& options) {
+        if (!m_packetDispatcher) {
+            return 0;
+        }
+        
+        return m_packetDispatcher->subscribe(subscriberName, packetId, callback, options);
+    }
+    
     /**
      * @brief Unsubscribe from packets
      */
@@ -397,6 +419,33 @@ public:
         return m_packetDispatcher.get();
     }
     
+    /**
+     * @brief Get the pipeline placement in use
+     *
+     * Receive threads and the recorder belong to their sources and
+     * recorders, which take their stage's CPUs and memory node from here.
+     */
+    const Threading::PipelineTopology& getTopology() const {
+        return m_config.topology;
+    }
+
+    /**
+     * @brief Replace the pipeline placement, e.g. when a workspace loads
+     *
+     * Before initialize() the whole placement is applied there. Afterwards
+     * the processor pool, packet memory and GUI thread move at once, while
+     * the router's workers keep the CPUs they started on.
+     */
+    void setTopology(const Threading::PipelineTopology& topology) {
+        m_config.topology = topology;
+        if (m_state == State::Uninitialized || m_state == State::Initializing || m_state == State::Error) {
+            return;
+        }
+
+        applyTopology();
+        m_logger->info("PacketManager", "Topology: router workers keep the CPUs they started on");
+    }
+    
     /**
      * @brief Get current state
      */
@@ -568,6 +617,69 @@ private:
         return true;
     }
     
+    /**
+     * @brief Place the router, processor pool, packet memory and GUI thread
+     *        as the configured topology says, and log the placement
+     *
+     * Runs before the dispatcher is created so its router starts with the
+     * worker CPUs already set.
+     */
+    void applyTopology() {
+        const Threading::PipelineTopology& topology = m_config.topology;
+        if (topology.isEmpty()) {
+            return;
+        }
+        
+        using Stage = Threading::PipelineTopology::Stage;
+        const Threading::CpuTopology& machine = Threading::CpuTopology::system();
+        
+        for (const QString& problem : topology.validate(machine)) {
+            m_logger->warning("PacketManager", QString("Topology: %1").arg(problem));
+        }
+        
+        PacketRouter::Configuration& routerConfig = m_config.dispatcherConfig.routerConfig;
+        routerConfig.workerCpus = topology.cpuSetsFor(Stage::Router, routerConfig.workerThreads, machine);
+        
+        Threading::ThreadPool* threadPool = m_threadManager ? m_threadManager->getDefaultThreadPool() : nullptr;
+        const size_t processorThreads = threadPool ? threadPool->getNumThreads() : 0;
+        if (threadPool) {
+            threadPool->setWorkerCpuSets(topology.cpuSetsFor(Stage::Processor, processorThreads, machine));
+            
+            const int processorNode = topology.memoryNodeFor(Stage::Processor, machine);
+            if (processorNode >= 0 && !threadPool->placeTaskMemoryOnNumaNode(processorNode)) {
+                m_logger->warning("PacketManager",
+                    QString("Failed to place processor task memory on NUMA node %1").arg(processorNode));
+            }
+        }
+        
+        // Receive threads allocate and fill the packet buffers
+        const int receiveNode = topology.memoryNodeFor(Stage::Receive, machine);
+        Memory::SizeClassAllocator* packetAllocator = m_memoryManager->packetAllocator();
+        if (receiveNode >= 0 && packetAllocator && !packetAllocator->placeOnNumaNode(receiveNode)) {
+            m_logger->warning("PacketManager",
+                QString("Failed to place packet memory on NUMA node %1").arg(receiveNode));
+        }
+        
+        const Threading::CpuSet guiCpus = topology.cpuSetFor(Stage::Gui, 0, machine);
+        if (!guiCpus.empty()) {
+            QCoreApplication* application = QCoreApplication::instance();
+            if (!application || QThread::currentThread() != application->thread()) {
+                m_logger->warning("PacketManager", "GUI placement ignored: not initialized on the GUI thread");
+            } else if (!Threading::pinCurrentThread(guiCpus)) {
+                m_logger->warning("PacketManager", QString("Failed to pin the GUI thread to CPUs %1")
+                    .arg(Threading::CpuTopology::formatCpuList(guiCpus)));
+            }
+        }
+        
+        const QStringList report = topology.report(machine, {
+            {Stage::Router, routerConfig.workerThreads},
+            {Stage::Processor, processorThreads}
+        });
+        for (const QString& line : report) {
+            m_logger->info("PacketManager", QString("Topology: %1").arg(line));
+        }
+    }
+    
     /**
      * @brief Initialize packet factory
      */
@@ -577,7 +689,7 @@ private:
         m_packetFactory->setEventDispatcher(m_eventDispatcher);
         
         connect(m_packetFactory.get(), &PacketFactory::packetCreated,
-                this, [](PacketPtr /*packet*/) {
+                this, [](const PacketPtr& /*packet*/) {
                     // Could emit signal for packet creation monitoring
                 });
         
@@ -599,7 +711,7 @@ private:
         }
         
         connect(m_packetProcessor.get(), &PacketProcessor::processingFailed,
-                this, [this](PacketPtr packet, const QString& error) {
+                this, [this](const PacketPtr& packet, const QString& error) {
                     Q_UNUSED(packet);
                     addError("Processing failed: " + error.toStdString());
                 });
@@ -620,7 +732,7 @@ private:
         
         // Connect packet processing
         connect(m_packetDispatcher.get(), &PacketDispatcher::packetProcessed,
-                this, [this](PacketPtr packet) {
+                this, [this](const PacketPtr& packet) {
                     if (m_packetProcessor) {
                         m_packetProcessor->processPacket(packet);
                     }
@@ -0,0 +1,441 @@
+#include "batch_field_extractor.h"
+#include "../../parser/layout/byte_order.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+// The AVX2 kernel is compiled for AVX2 by function attribute, so the rest of
+// the binary still runs on CPUs without it
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MONITOR_BATCH_AVX2 1
+#include <immintrin.h>
+#else
+#define MONITOR_BATCH_AVX2 0
+#endif
+
+namespace Monitor {
+namespace Packet {
+
+namespace {
+
+// Packets staged per pass when extracting from packet handles
+constexpr size_t STAGE_SIZE = 256;
+
+// Packets decoded field by field at a time; small enough that their
+// payloads stay in L1 while every field is read from them
+constexpr size_t BLOCK_SIZE = 32;
+
+template<typename T>
+uint64_t loadAs(const uint8_t* data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+uint64_t signExtend(uint64_t value, uint64_t signBit)
+{
+    return signBit ? (value ^ signBit) - signBit : value;
+}
+
+} // namespace
+
+BatchFieldExtractor::Implementation BatchFieldExtractor::detect()
+{
+#if MONITOR_BATCH_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        return Implementation::Avx2;
+    }
+#endif
+    return Implementation::Scalar;
+}
+
+bool BatchFieldExtractor::isSupported(Implementation implementation)
+{
+    return implementation == Implementation::Scalar || detect() == implementation;
+}
+
+const char* BatchFieldExtractor::implementationName(Implementation implementation)
+{
+    switch (implementation) {
+        case Implementation::Scalar: return "scalar";
+        case Implementation::Avx2:   return "AVX2";
+    }
+    return "unknown";
+}
+
+BatchFieldExtractor::BatchFieldExtractor(const ExtractionPlan& plan)
+    : m_implementation(detect())
+{
+    compile(plan);
+}
+
+BatchFieldExtractor::BatchFieldExtractor(const ExtractionPlan& plan, Implementation implementation)
+    : m_implementation(isSupported(implementation) ? implementation : Implementation::Scalar)
+{
+    compile(plan);
+}
+
+void BatchFieldExtractor::compile(const ExtractionPlan& plan)
+{
+    using Kind = ExtractionPlan::Kind;
+
+    m_columnCount = plan.columnCount();
+    m_extent = plan.extent();
+    m_lanes.clear();
+    m_lanes.reserve(plan.ops().size());
+
+    for (const ExtractionPlan::Op& op : plan.ops()) {
+        Lane lane;
+        lane.offset = op.offset;
+        lane.column = op.column;
+        lane.width = op.width;
+        lane.shift = op.kind == Kind::Bits ? op.shift : 0;
+        lane.isBool = op.kind == Kind::Bool;
+        lane.gather = op.offset + sizeof(uint64_t) <= m_extent;
+        lane.byteMask = op.width >= sizeof(uint64_t) ? ~uint64_t(0) : (uint64_t(1) << (op.width * 8)) - 1;
+        lane.mask = op.kind == Kind::Bits ? op.mask : ~uint64_t(0);
+        lane.swap = op.swapped;
+        lane.swapShift = static_cast<uint8_t>(64 - op.width * 8);
+
+        // Byte i of the word takes byte width - 1 - i; 0x80 selects zero
+        for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+            const uint64_t source = i < op.width ? op.width - 1 - i : 0x80;
+            lane.swapControl |= source << (i * 8);
+        }
+
+        switch (op.kind) {
+            case Kind::Int8:
+            case Kind::Int16:
+            case Kind::Int32:
+                lane.signBit = uint64_t(1) << (op.width * 8 - 1);
+                lane.conversion = Conversion::Int32;
+                break;
+            case Kind::Bool:
+            case Kind::UInt8:
+            case Kind::UInt16:
+                lane.conversion = Conversion::Int32;
+                break;
+            case Kind::UInt32:
+            case Kind::Int64:
+                lane.conversion = Conversion::Int64;
+                break;
+            case Kind::UInt64:
+                lane.conversion = Conversion::UInt64;
+                break;
+            case Kind::Bits:
+                lane.conversion = op.mask <= uint64_t(std::numeric_limits<int32_t>::max())
+                    ? Conversion::Int32 : Conversion::UInt64;
+                break;
+            case Kind::Float:
+                lane.conversion = Conversion::Float;
+                break;
+            case Kind::Double:
+                lane.conversion = Conversion::Double;
+                break;
+        }
+        m_lanes.push_back(lane);
+    }
+
+    // Lanes an 8-byte gather could read past a payload's end go last and
+    // decode one packet at a time
+    const auto tail = std::stable_partition(m_lanes.begin(), m_lanes.end(),
+                                            [](const Lane& lane) { return lane.gather; });
+    m_gatherLanes = static_cast<size_t>(tail - m_lanes.begin());
+}
+
+size_t BatchFieldExtractor::extract(const PacketPtr* packets, size_t count, FieldColumns& columns) const
+{
+    if (columns.columns() < m_columnCount || columns.rows() < count) {
+        columns.resize(m_columnCount, count);
+    }
+
+    // Stage payload pointers in chunks; rows keep their batch position
+    const uint8_t* payloads[STAGE_SIZE];
+    size_t sizes[STAGE_SIZE];
+    size_t complete = 0;
+
+    for (size_t first = 0; first < count; first += STAGE_SIZE) {
+        const size_t chunk = std::min(STAGE_SIZE, count - first);
+        for (size_t i = 0; i < chunk; ++i) {
+            const PacketPtr& packet = packets[first + i];
+            const bool usable = packet && packet->isValid();
+            payloads[i] = usable ? packet->payload() : nullptr;
+            sizes[i] = usable ? packet->payloadSize() : 0;
+            complete += payloads[i] && sizes[i] >= m_extent;
+        }
+
+        if (m_implementation == Implementation::Avx2) {
+            extractAvx2(payloads, sizes, chunk, columns, first);
+        } else {
+            extractScalar(payloads, sizes, chunk, columns, first);
+        }
+    }
+    return complete;
+}
+
+size_t BatchFieldExtractor::extract(const uint8_t* const* payloads, const size_t* sizes, size_t count,
+                                    FieldColumns& columns) const
+{
+    if (columns.columns() < m_columnCount || columns.rows() < count) {
+        columns.resize(m_columnCount, count);
+    }
+
+    if (m_implementation == Implementation::Avx2) {
+        extractAvx2(payloads, sizes, count, columns, 0);
+    } else {
+        extractScalar(payloads, sizes, count, columns, 0);
+    }
+
+    size_t complete = 0;
+    for (size_t i = 0; i < count; ++i) {
+        complete += payloads[i] && sizes[i] >= m_extent;
+    }
+    return complete;
+}
+
+inline void BatchFieldExtractor::decodeScalar(const Lane& lane, const uint8_t* payload, double& real, int64_t& integer)
+{
+    const uint8_t* field = payload + lane.offset;
+
+    if (lane.conversion == Conversion::Float) {
+        float value;
+        std::memcpy(&value, field, sizeof(value));
+        real = static_cast<double>(lane.swap ? Parser::Layout::byteSwapped(value) : value);
+        integer = 0;
+        return;
+    }
+    if (lane.conversion == Conversion::Double) {
+        std::memcpy(&real, field, sizeof(real));
+        if (lane.swap) {
+            real = Parser::Layout::byteSwapped(real);
+        }
+        integer = 0;
+        return;
+    }
+
+    // Gather lanes may read a whole word; the byte mask drops what is not
+    // the field's. Loading whole integers, not bytes into a zeroed word,
+    // keeps each read one load with no store to forward.
+    uint64_t raw = 0;
+    switch (lane.gather ? sizeof(raw) : lane.width) {
+        case 1: raw = loadAs<uint8_t>(field); break;
+        case 2: raw = loadAs<uint16_t>(field); break;
+        case 4: raw = loadAs<uint32_t>(field); break;
+        case 8: raw = loadAs<uint64_t>(field); break;
+        default: std::memcpy(&raw, field, lane.width); break;
+    }
+    // Reversed, the field's bytes sit at the top and whatever followed it
+    // at the bottom, where the shift drops it
+    raw = lane.swap ? Parser::Layout::byteSwap(raw) >> lane.swapShift : raw & lane.byteMask;
+    uint64_t value = signExtend((raw >> lane.shift) & lane.mask, lane.signBit);
+    if (lane.isBool) {
+        value = value != 0;
+    }
+
+    integer = static_cast<int64_t>(value);
+    real = lane.conversion == Conversion::UInt64
+        ? static_cast<double>(value)
+        : static_cast<double>(static_cast<int64_t>(value));
+}
+
+void BatchFieldExtractor::clearCell(const Lane& lane, size_t row, FieldColumns& columns)
+{
+    columns.reals(lane.column)[row] = std::numeric_limits<double>::quiet_NaN();
+    columns.integers(lane.column)[row] = 0;
+}
+
+void BatchFieldExtractor::extractRow(const uint8_t* payload, size_t size, size_t row, FieldColumns& columns) const
+{
+    for (const Lane& lane : m_lanes) {
+        if (payload && size >= m_extent) {
+            decodeScalar(lane, payload, columns.reals(lane.column)[row], columns.integers(lane.column)[row]);
+        } else if (payload && lane.offset + lane.width <= size) {
+            // Too short for a word read
+            Lane exact = lane;
+            exact.gather = false;
+            decodeScalar(exact, payload, columns.reals(lane.column)[row], columns.integers(lane.column)[row]);
+        } else {
+            clearCell(lane, row, columns);
+        }
+    }
+}
+
+void BatchFieldExtractor::extractScalar(const uint8_t* const* payloads, const size_t* sizes, size_t count,
+                                        FieldColumns& columns, size_t firstRow) const
+{
+    // Field by field within each block, so columns are written front to back
+    for (size_t first = 0; first < count; first += BLOCK_SIZE) {
+        const size_t last = std::min(first + BLOCK_SIZE, count);
+        for (const Lane& lane : m_lanes) {
+            double* reals = columns.reals(lane.column) + firstRow;
+            int64_t* integers = columns.integers(lane.column) + firstRow;
+            for (size_t i = first; i < last; ++i) {
+                if (payloads[i] && sizes[i] >= m_extent) {
+                    decodeScalar(lane, payloads[i], reals[i], integers[i]);
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!payloads[i] || sizes[i] < m_extent) {
+            extractRow(payloads[i], sizes[i], firstRow + i, columns);
+        }
+    }
+}
+
+#if MONITOR_BATCH_AVX2
+
+namespace {
+
+/**
+ * @brief Four payloads gathered together; each lane reads base + offset + index
+ */
+struct GatherGroup {
+    __m256i index;
+    const uint8_t* base;
+    size_t row;
+};
+
+} // namespace
+
+__attribute__((target("avx2")))
+void BatchFieldExtractor::gatherLane(const Lane& lane, const void* groupData, size_t groupCount,
+                                     FieldColumns& columns)
+{
+    const GatherGroup* groups = static_cast<const GatherGroup*>(groupData);
+    double* reals = columns.reals(lane.column);
+    int64_t* integers = columns.integers(lane.column);
+
+    const __m256i lowDwords = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i byteMask = _mm256_set1_epi64x(static_cast<long long>(lane.byteMask));
+    const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(lane.mask));
+    const __m256i signBit = _mm256_set1_epi64x(static_cast<long long>(lane.signBit));
+    const __m128i shift = _mm_cvtsi32_si128(lane.shift);
+    // Shuffles stay within 128-bit halves, so the odd words index bytes 8-15
+    const long long swapLow = static_cast<long long>(lane.swapControl);
+    const long long swapHigh = static_cast<long long>(lane.swapControl + 0x0808080808080808ULL);
+    const __m256i swapControl = _mm256_setr_epi64x(swapLow, swapHigh, swapLow, swapHigh);
+
+    for (size_t g = 0; g < groupCount; ++g) {
+        const GatherGroup& group = groups[g];
+        __m256i raw = _mm256_i64gather_epi64(
+            reinterpret_cast<const long long*>(group.base + lane.offset), group.index, 1);
+        if (lane.swap) {
+            raw = _mm256_shuffle_epi8(raw, swapControl);
+        }
+        double* groupReals = reals + group.row;
+        __m256i* groupIntegers = reinterpret_cast<__m256i*>(integers + group.row);
+
+        switch (lane.conversion) {
+            case Conversion::Double:
+                _mm256_storeu_pd(groupReals, _mm256_castsi256_pd(raw));
+                _mm256_storeu_si256(groupIntegers, zero);
+                continue;
+            case Conversion::Float: {
+                const __m128i low = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(raw, lowDwords));
+                _mm256_storeu_pd(groupReals, _mm256_cvtps_pd(_mm_castsi128_ps(low)));
+                _mm256_storeu_si256(groupIntegers, zero);
+                continue;
+            }
+            default:
+                break;
+        }
+
+        __m256i value = _mm256_and_si256(_mm256_srl_epi64(_mm256_and_si256(raw, byteMask), shift), mask);
+        value = _mm256_sub_epi64(_mm256_xor_si256(value, signBit), signBit);
+        if (lane.isBool) {
+            value = _mm256_andnot_si256(_mm256_cmpeq_epi64(value, zero), one);
+        }
+        _mm256_storeu_si256(groupIntegers, value);
+
+        if (lane.conversion == Conversion::Int32) {
+            const __m128i low = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(value, lowDwords));
+            _mm256_storeu_pd(groupReals, _mm256_cvtepi32_pd(low));
+        } else {
+            // AVX2 has no 64-bit integer to double conversion
+            alignas(32) int64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), value);
+            for (int i = 0; i < 4; ++i) {
+                groupReals[i] = lane.conversion == Conversion::UInt64
+                    ? static_cast<double>(static_cast<uint64_t>(lanes[i]))
+                    : static_cast<double>(lanes[i]);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+void BatchFieldExtractor::extractAvx2(const uint8_t* const* payloads, const size_t* sizes, size_t count,
+                                      FieldColumns& columns, size_t firstRow) const
+{
+    GatherGroup groups[BLOCK_SIZE / 4];
+
+    for (size_t first = 0; first < count; first += BLOCK_SIZE) {
+        const size_t chunk = std::min(BLOCK_SIZE, count - first);
+
+        // Groups of four full payloads gather; the rest decode one by one
+        size_t groupCount = 0;
+        size_t i = 0;
+        for (; i + 4 <= chunk; i += 4) {
+            const uint8_t* const* four = payloads + first + i;
+            const size_t* fourSizes = sizes + first + i;
+            bool full = true;
+            for (size_t k = 0; k < 4; ++k) {
+                full &= four[k] != nullptr && fourSizes[k] >= m_extent;
+            }
+            if (!full) {
+                for (size_t k = 0; k < 4; ++k) {
+                    extractRow(four[k], fourSizes[k], firstRow + first + i + k, columns);
+                }
+                continue;
+            }
+
+            // Offsets from the first payload; uintptr_t keeps the
+            // subtraction defined for unrelated buffers
+            const uintptr_t base = reinterpret_cast<uintptr_t>(four[0]);
+            GatherGroup& group = groups[groupCount++];
+            group.base = four[0];
+            group.row = firstRow + first + i;
+            group.index = _mm256_setr_epi64x(
+                0,
+                static_cast<long long>(reinterpret_cast<uintptr_t>(four[1]) - base),
+                static_cast<long long>(reinterpret_cast<uintptr_t>(four[2]) - base),
+                static_cast<long long>(reinterpret_cast<uintptr_t>(four[3]) - base));
+        }
+        for (; i < chunk; ++i) {
+            extractRow(payloads[first + i], sizes[first + i], firstRow + first + i, columns);
+        }
+
+        for (size_t lane = 0; lane < m_gatherLanes; ++lane) {
+            gatherLane(m_lanes[lane], groups, groupCount, columns);
+        }
+        for (size_t lane = m_gatherLanes; lane < m_lanes.size(); ++lane) {
+            const Lane& tail = m_lanes[lane];
+            double* reals = columns.reals(tail.column);
+            int64_t* integers = columns.integers(tail.column);
+            for (size_t g = 0; g < groupCount; ++g) {
+                for (size_t k = 0; k < 4; ++k) {
+                    const size_t row = groups[g].row + k;
+                    decodeScalar(tail, payloads[row - firstRow], reals[row], integers[row]);
+                }
+            }
+        }
+    }
+}
+
+#else
+
+void BatchFieldExtractor::extractAvx2(const uint8_t* const* payloads, const size_t* sizes, size_t count,
+                                      FieldColumns& columns, size_t firstRow) const
+{
+    extractScalar(payloads, sizes, count, columns, firstRow);
+}
+
+#endif
+
+} // namespace Packet
+} // namespace Monitor
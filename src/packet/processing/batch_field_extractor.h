@@ -0,0 +1,136 @@
+#pragma once
+
+#include "extraction_plan.h"
+#include "../core/packet.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Monitor {
+namespace Packet {
+
+/**
+ * @brief Decodes one packet type's extraction plan across a burst of its packets
+ *
+ * Extracting the same fields from many packets of one ID is a gather: each
+ * field sits at the same offset in every payload. The batch extractor runs
+ * the plan field by field instead of packet by packet and writes
+ * FieldColumns, one contiguous array per field.
+ *
+ * The AVX2 implementation gathers a field from four payloads with one
+ * instruction and shifts, masks and sign-extends the four values together.
+ * Fields in the other byte order are reversed in the same registers with
+ * one byte shuffle per gather. It is picked at run time when the CPU has
+ * AVX2; otherwise the scalar implementation runs. Both produce exactly
+ * what ExtractionPlan::run() produces for each packet.
+ */
+class BatchFieldExtractor {
+public:
+    enum class Implementation {
+        Scalar,
+        Avx2
+    };
+
+    /**
+     * @brief Fastest implementation this CPU supports
+     */
+    static Implementation detect();
+
+    static bool isSupported(Implementation implementation);
+    static const char* implementationName(Implementation implementation);
+
+    /**
+     * @brief Prepare @p plan for batch decoding with the detected implementation
+     */
+    explicit BatchFieldExtractor(const ExtractionPlan& plan);
+
+    /**
+     * @brief Prepare @p plan for @p implementation, or Scalar if the CPU lacks it
+     */
+    BatchFieldExtractor(const ExtractionPlan& plan, Implementation implementation);
+
+    Implementation implementation() const { return m_implementation; }
+    size_t columnCount() const { return m_columnCount; }
+
+    /**
+     * @brief Decode @p count packets into rows 0 to @p count - 1 of @p columns
+     *
+     * The packets must all have the ID the plan was compiled for; IDs are
+     * not checked. @p columns is resized if it has too few columns or rows.
+     * Fields past the end of a short payload, and every field of a null or
+     * invalid packet, read NaN and 0.
+     *
+     * @return Packets decoded in full
+     */
+    size_t extract(const PacketPtr* packets, size_t count, FieldColumns& columns) const;
+
+    /**
+     * @brief extract() on raw payloads; a null payload decodes as empty
+     */
+    size_t extract(const uint8_t* const* payloads, const size_t* sizes, size_t count,
+                   FieldColumns& columns) const;
+
+private:
+    /**
+     * @brief How a lane's decoded bits become a double
+     */
+    enum class Conversion : uint8_t {
+        Int32,      ///< Value fits in int32
+        Int64,
+        UInt64,
+        Float,
+        Double
+    };
+
+    /**
+     * @brief One plan op, widened to the form every packet of a batch shares
+     *
+     * Integer kinds and bitfields decode alike: keep the op's bytes, shift,
+     * mask, then sign-extend from signBit if the kind is signed.
+     */
+    struct Lane {
+        uint32_t offset = 0;
+        uint32_t column = 0;
+        uint8_t width = 0;
+        uint8_t shift = 0;
+        bool isBool = false;
+        bool gather = false;        ///< An 8-byte load at offset stays inside a full payload
+        bool swap = false;          ///< Stored in the other byte order
+        uint8_t swapShift = 0;      ///< Drops what follows the field after a 64-bit swap
+        Conversion conversion = Conversion::Int32;
+        uint64_t byteMask = 0;      ///< Low width bytes
+        uint64_t mask = 0;
+        uint64_t signBit = 0;       ///< Top bit of a signed kind, 0 if unsigned
+        uint64_t swapControl = 0;   ///< Byte shuffle reversing the low width bytes of a word
+    };
+
+    void compile(const ExtractionPlan& plan);
+
+    static void decodeScalar(const Lane& lane, const uint8_t* payload, double& real, int64_t& integer);
+    static void clearCell(const Lane& lane, size_t row, FieldColumns& columns);
+
+    void extractScalar(const uint8_t* const* payloads, const size_t* sizes, size_t count,
+                       FieldColumns& columns, size_t firstRow) const;
+    void extractAvx2(const uint8_t* const* payloads, const size_t* sizes, size_t count,
+                     FieldColumns& columns, size_t firstRow) const;
+
+    /**
+     * @brief Gather one lane from groups of four payloads; AVX2 only
+     */
+    static void gatherLane(const Lane& lane, const void* groups, size_t groupCount, FieldColumns& columns);
+
+    /**
+     * @brief Decode one packet lane by lane, blanking fields it is too short for
+     */
+    void extractRow(const uint8_t* payload, size_t size, size_t row, FieldColumns& columns) const;
+
+    Implementation m_implementation = Implementation::Scalar;
+    std::vector<Lane> m_lanes;      ///< Gather lanes first
+    size_t m_gatherLanes = 0;
+    size_t m_columnCount = 0;
+    size_t m_extent = 0;
+};
+
+} // namespace Packet
+} // namespace Monitor
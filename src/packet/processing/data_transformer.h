@@ -1,10 +1,14 @@
 #pragma once
 
 #include "field_extractor.h"
+#include "transform_kernel.h"
+#include "../core/packet_type_registry.h"
 #include "../../logging/logger.h"
 #include "../../profiling/profiler.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <functional>
 #include <cmath>
@@ -21,6 +25,14 @@ namespace Packet {
  * This class applies various transformations to extracted field values,
  * including type conversions, mathematical operations, and formatting.
  * It supports chaining multiple transformations for complex processing.
+ *
+ * The numeric steps at the start of each chain are compiled into a
+ * TransformKernel when the chain is set, and only the steps after the
+ * first string, custom or unknown one are interpreted per value. Fully
+ * numeric chains can also be bound to frame columns of a packet type with
+ * bindColumns() and run over whole batches with transformColumns(), or a
+ * packet at a time with transformFrame(). Bind again after a chain changes
+ * (see isBound()).
  */
 class DataTransformer {
 public:
@@ -109,6 +121,15 @@ public:
             : operation(OperationType::Custom), params(p), customFunc(func) {}
     };
     
+    /**
+     * @brief Numeric type a compiled run of steps hands on
+     */
+    enum class ValueKind : uint8_t {
+        Integer,
+        Float,
+        Double
+    };
+    
     /**
      * @brief Transformation chain for a field
      */
@@ -121,6 +142,12 @@ public:
         mutable double cumulativeValue = 0.0;
         mutable bool initialized = false;
         
+        // Leading numeric steps, compiled
+        TransformKernel kernel;
+        size_t compiledSteps = 0;
+        ValueKind compiledKind = ValueKind::Double;    ///< Type the last compiled step produces
+        uint64_t version = 0;                           ///< Chain version it was last changed at
+        
         TransformationChain() : fieldName("") {}
         TransformationChain(const std::string& name) : fieldName(name) {}
     };
@@ -139,13 +166,37 @@ public:
     };
 
 private:
+    /**
+     * @brief A compiled chain bound to one frame column
+     */
+    struct ColumnKernel {
+        size_t column;
+        std::string fieldName;
+        ValueKind kind;
+        uint64_t chainVersion;          ///< TransformationChain::version it was compiled from
+        TransformKernel kernel;
+    };
+    
+    /**
+     * @brief The bound columns of one packet type
+     */
+    struct ColumnBinding {
+        std::vector<ColumnKernel> kernels;
+        uint64_t chainVersion = 0;      ///< m_chainVersion when bound; 0 if unbound
+    };
+    
     std::unordered_map<std::string, TransformationChain> m_transformationChains;
+    std::atomic<uint64_t> m_chainVersion{1};    ///< Bumped by every chain change
+    PacketSlotTable<ColumnBinding> m_columnBindings;
+    mutable std::mutex m_columnMutex;           ///< Guards m_columnBindings and the kernels in it
+    PacketTypeRegistry* m_registry;
     Logging::Logger* m_logger;
     Profiling::Profiler* m_profiler;
 
 public:
     explicit DataTransformer()
-        : m_logger(Logging::Logger::instance())
+        : m_registry(PacketTypeRegistry::instance())
+        , m_logger(Logging::Logger::instance())
         , m_profiler(Profiling::Profiler::instance())
     {
     }
@@ -154,8 +205,11 @@ public:
      * @brief Add transformation chain for field
      */
     void addTransformationChain(const std::string& fieldName, const std::vector<Transformation>& transformations) {
-        m_transformationChains[fieldName] = TransformationChain(fieldName);
-        m_transformationChains[fieldName].transformations = transformations;
+        auto& chain = m_transformationChains[fieldName];
+        chain = TransformationChain(fieldName);
+        chain.transformations = transformations;
+        compileChain(chain);
+        chain.version = m_chainVersion.fetch_add(1, std::memory_order_relaxed) + 1;
         
         m_logger->debug("DataTransformer", 
             QString("Added transformation chain for field '%1' with %2 transformations")
@@ -169,6 +223,9 @@ public:
         auto& chain = m_transformationChains[fieldName];
         chain.fieldName = fieldName;
         chain.transformations.push_back(transformation);
+        compileChain(chain);
+        resetChainState(chain);
+        chain.version = m_chainVersion.fetch_add(1, std::memory_order_relaxed) + 1;
         
         m_logger->debug("DataTransformer", 
             QString("Added transformation to field '%1'")
@@ -180,6 +237,7 @@ public:
      */
     void clearTransformations(const std::string& fieldName) {
         m_transformationChains.erase(fieldName);
+        m_chainVersion.fetch_add(1, std::memory_order_relaxed);
     }
     
     /**
@@ -194,7 +252,17 @@ public:
         
         PROFILE_SCOPE("DataTransformer::transform");
         
-        return applyTransformationChain(it->second, value);
+        TransformationChain& chain = it->second;
+        double numericValue = 0.0;
+        if (chain.compiledSteps > 0 && toNumeric(value, numericValue)) {
+            const FieldExtractor::FieldValue compiled = fromNumeric(chain.kernel.apply(numericValue), chain.compiledKind);
+            if (chain.compiledSteps == chain.transformations.size()) {
+                return TransformationResult(compiled);
+            }
+            return applyTransformationChain(chain, compiled, chain.compiledSteps);
+        }
+        
+        return applyTransformationChain(chain, value);
     }
     
     /**
@@ -222,6 +290,163 @@ public:
         return results;
     }
     
+    /**
+     * @brief Copy of the compiled chain of @p fieldName, with fresh state
+     *
+     * Each consumer that transforms a field's values (a chart, a grid, the
+     * logger) takes its own kernel, so their moving windows stay apart.
+     *
+     * @return False, leaving @p kernel unchanged, if the field has no chain
+     *         or its chain has steps that only run per value (strings,
+     *         custom functions, division by zero)
+     */
+    bool compileKernel(const std::string& fieldName, TransformKernel& kernel) const {
+        auto it = m_transformationChains.find(fieldName);
+        if (it == m_transformationChains.end() || it->second.compiledSteps != it->second.transformations.size()) {
+            return false;
+        }
+        
+        kernel = it->second.kernel;
+        kernel.reset();
+        return true;
+    }
+    
+    /**
+     * @brief Bind the chains of @p columnNames to frame columns of @p packetId
+     *
+     * Column i takes the chain of columnNames[i] if it compiles fully; the
+     * other columns, and those with an empty name, are left as decoded.
+     * Binding replaces earlier bindings of the packet type, which hold
+     * until a chain changes (see isBound()); a column whose chain has not
+     * changed since keeps its state.
+     *
+     * @return Columns bound
+     */
+    size_t bindColumns(PacketId packetId, const std::vector<std::string>& columnNames) {
+        std::lock_guard<std::mutex> lock(m_columnMutex);
+        ColumnBinding* binding = m_columnBindings.obtain(m_registry->registerPacketId(packetId));
+        if (!binding) {
+            return 0;
+        }
+        
+        std::vector<ColumnKernel> previous = std::move(binding->kernels);
+        binding->kernels.clear();
+        binding->chainVersion = m_chainVersion.load(std::memory_order_relaxed);
+        size_t next = 0;
+        for (size_t column = 0; column < columnNames.size(); ++column) {
+            auto it = columnNames[column].empty() ? m_transformationChains.end() : m_transformationChains.find(columnNames[column]);
+            if (it == m_transformationChains.end() || it->second.compiledSteps != it->second.transformations.size()) {
+                continue;
+            }
+            const TransformationChain& chain = it->second;
+            
+            while (next < previous.size() && previous[next].column < column) {
+                ++next;
+            }
+            if (next < previous.size() && previous[next].column == column &&
+                previous[next].fieldName == columnNames[column] && previous[next].chainVersion == chain.version) {
+                binding->kernels.push_back(std::move(previous[next]));
+                continue;
+            }
+            
+            ColumnKernel bound{column, columnNames[column], chain.compiledKind, chain.version, chain.kernel};
+            bound.kernel.reset();
+            binding->kernels.push_back(std::move(bound));
+        }
+        
+        m_logger->debug("DataTransformer", 
+            QString("Bound %1 of %2 columns of packet ID %3 to compiled chains")
+                .arg(binding->kernels.size()).arg(columnNames.size()).arg(packetId));
+        return binding->kernels.size();
+    }
+    
+    /**
+     * @brief Check if @p packetId has column bindings made since the last chain change
+     */
+    bool isBound(PacketId packetId) const {
+        std::lock_guard<std::mutex> lock(m_columnMutex);
+        const ColumnBinding* binding = m_columnBindings.find(m_registry->findSlot(packetId));
+        return binding && binding->chainVersion == m_chainVersion.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Make isBound() false for @p packetId, e.g. when the fields to
+     *        transform change
+     *
+     * The bound columns still run until bound again, and keep their state
+     * if bound again to the same chain.
+     */
+    void invalidateColumns(PacketId packetId) {
+        std::lock_guard<std::mutex> lock(m_columnMutex);
+        ColumnBinding* binding = m_columnBindings.find(m_registry->findSlot(packetId));
+        if (binding) {
+            binding->chainVersion = 0;
+        }
+    }
+    
+    /**
+     * @brief Run the bound chains of @p packetId down the first @p rows rows, in place
+     *
+     * Rows are taken as consecutive packets. Only reals() change;
+     * integers() keep the decoded values.
+     */
+    void transformColumns(PacketId packetId, FieldColumns& columns, size_t rows) {
+        std::lock_guard<std::mutex> lock(m_columnMutex);
+        ColumnBinding* binding = m_columnBindings.find(m_registry->findSlot(packetId));
+        if (!binding) {
+            return;
+        }
+        
+        rows = std::min(rows, columns.rows());
+        for (ColumnKernel& bound : binding->kernels) {
+            if (bound.column < columns.columns()) {
+                double* values = columns.reals(bound.column);
+                bound.kernel.run(values, values, rows);
+            }
+        }
+    }
+    
+    /**
+     * @brief Run the bound chains of @p packetId on one frame row, in place
+     */
+    void transformFrame(PacketId packetId, FieldFrame& frame, size_t row = 0) {
+        std::lock_guard<std::mutex> lock(m_columnMutex);
+        ColumnBinding* binding = m_columnBindings.find(m_registry->findSlot(packetId));
+        if (!binding || row >= frame.rows()) {
+            return;
+        }
+        
+        double* values = frame.reals(row);
+        for (ColumnKernel& bound : binding->kernels) {
+            if (bound.column < frame.columns()) {
+                values[bound.column] = bound.kernel.apply(values[bound.column]);
+            }
+        }
+    }
+    
+    /**
+     * @brief Run the bound chains of @p packetId on one frame row into
+     *        @p results, by field name, as transform() would type them
+     *
+     * Cells that are NaN, which is how a plan marks fields it could not
+     * decode, are skipped and leave their chain's state alone.
+     */
+    void transformFrame(PacketId packetId, const FieldFrame& frame, size_t row,
+                        std::unordered_map<std::string, TransformationResult>& results) {
+        std::lock_guard<std::mutex> lock(m_columnMutex);
+        ColumnBinding* binding = m_columnBindings.find(m_registry->findSlot(packetId));
+        if (!binding || row >= frame.rows()) {
+            return;
+        }
+        
+        const double* values = frame.reals(row);
+        for (ColumnKernel& bound : binding->kernels) {
+            if (bound.column < frame.columns() && !std::isnan(values[bound.column])) {
+                results[bound.fieldName] = TransformationResult(fromNumeric(bound.kernel.apply(values[bound.column]), bound.kind));
+            }
+        }
+    }
+    
     /**
      * @brief Check if field has transformations
      */
@@ -246,6 +471,12 @@ public:
             for (auto& pair : m_transformationChains) {
                 resetChainState(pair.second);
             }
+            std::lock_guard<std::mutex> lock(m_columnMutex);
+            m_columnBindings.forEach([](PacketTypeRegistry::Slot, ColumnBinding& binding) {
+                for (ColumnKernel& bound : binding.kernels) {
+                    bound.kernel.reset();
+                }
+            });
         } else {
             // Reset specific field
             auto it = m_transformationChains.find(fieldName);
@@ -257,12 +488,96 @@ public:
 
 private:
     /**
-     * @brief Apply transformation chain to value
+     * @brief Compile the leading numeric steps of @p chain into its kernel
+     *
+     * Stops at the first step the kernel cannot express with the
+     * interpreter's exact results: string and custom steps, operations the
+     * interpreter rejects, and division by zero, which it reports as an
+     * error.
      */
-    TransformationResult applyTransformationChain(TransformationChain& chain, const FieldExtractor::FieldValue& inputValue) {
-        FieldExtractor::FieldValue currentValue = inputValue;
+    static void compileChain(TransformationChain& chain) {
+        chain.kernel.clear();
+        chain.compiledSteps = 0;
+        chain.compiledKind = ValueKind::Double;
         
         for (const auto& transformation : chain.transformations) {
+            const TransformationParams& params = transformation.params;
+            ValueKind kind = ValueKind::Double;
+            
+            switch (transformation.operation) {
+                case OperationType::ToInteger:     chain.kernel.truncate(); kind = ValueKind::Integer; break;
+                case OperationType::ToFloat:       chain.kernel.roundToFloat(); kind = ValueKind::Float; break;
+                case OperationType::ToDouble:      break;
+                case OperationType::Add:           chain.kernel.add(params.numericValue); break;
+                case OperationType::Subtract:      chain.kernel.add(-params.numericValue); break;
+                case OperationType::Multiply:      chain.kernel.multiply(params.numericValue); break;
+                case OperationType::Modulo:        chain.kernel.modulo(params.numericValue); break;
+                case OperationType::Power:         chain.kernel.power(params.numericValue); break;
+                case OperationType::Abs:           chain.kernel.absolute(); break;
+                case OperationType::Sqrt:          chain.kernel.function(TransformKernel::Function::Sqrt); break;
+                case OperationType::Log:           chain.kernel.function(TransformKernel::Function::Log); break;
+                case OperationType::Log10:         chain.kernel.function(TransformKernel::Function::Log10); break;
+                case OperationType::Sin:           chain.kernel.function(TransformKernel::Function::Sin); break;
+                case OperationType::Cos:           chain.kernel.function(TransformKernel::Function::Cos); break;
+                case OperationType::Tan:           chain.kernel.function(TransformKernel::Function::Tan); break;
+                case OperationType::MovingAverage: chain.kernel.movingAverage(params.windowSize); break;
+                case OperationType::Diff:          chain.kernel.difference(); break;
+                case OperationType::CumulativeSum: chain.kernel.cumulativeSum(); break;
+                case OperationType::Clamp:         chain.kernel.clamp(params.minValue, params.maxValue); break;
+                
+                case OperationType::Divide:
+                    if (params.numericValue == 0.0) {
+                        return;
+                    }
+                    chain.kernel.divide(params.numericValue);
+                    break;
+                    
+                default:
+                    return;
+            }
+            
+            chain.compiledKind = kind;
+            ++chain.compiledSteps;
+        }
+    }
+    
+    /**
+     * @brief Numeric value of an arithmetic FieldValue
+     * @return False for strings and byte arrays
+     */
+    static bool toNumeric(const FieldExtractor::FieldValue& value, double& numericValue) {
+        return std::visit([&numericValue](const auto& val) -> bool {
+            using T = std::decay_t<decltype(val)>;
+            if constexpr (std::is_arithmetic_v<T>) {
+                numericValue = static_cast<double>(val);
+                return true;
+            } else {
+                return false;
+            }
+        }, value);
+    }
+    
+    static FieldExtractor::FieldValue fromNumeric(double value, ValueKind kind) {
+        switch (kind) {
+            case ValueKind::Integer:
+                return std::isfinite(value) ? static_cast<int64_t>(value) : int64_t(0);
+            case ValueKind::Float:
+                return static_cast<float>(value);
+            case ValueKind::Double:
+                break;
+        }
+        return value;
+    }
+    
+    /**
+     * @brief Apply transformation chain to value, from step @p firstStep on
+     */
+    TransformationResult applyTransformationChain(TransformationChain& chain, const FieldExtractor::FieldValue& inputValue,
+                                                  size_t firstStep = 0) {
+        FieldExtractor::FieldValue currentValue = inputValue;
+        
+        for (size_t step = firstStep; step < chain.transformations.size(); ++step) {
+            const auto& transformation = chain.transformations[step];
             auto result = applyTransformation(transformation, currentValue, chain);
             if (!result.success) {
                 return result;
@@ -497,8 +812,8 @@ private:
     /**
      * @brief Apply mathematical operation with parameter
      */
-    TransformationResult applyMath(const FieldExtractor::FieldValue& value, double param, 
-                                  std::function<double(double, double)> operation) {
+    template<typename Operation>
+    TransformationResult applyMath(const FieldExtractor::FieldValue& value, double param, Operation operation) {
         return std::visit([&](const auto& val) -> TransformationResult {
             using T = std::decay_t<decltype(val)>;
             if constexpr (std::is_arithmetic_v<T>) {
@@ -513,8 +828,8 @@ private:
     /**
      * @brief Apply mathematical function
      */
-    TransformationResult applyMathFunction(const FieldExtractor::FieldValue& value, 
-                                          std::function<double(double)> function) {
+    template<typename Function>
+    TransformationResult applyMathFunction(const FieldExtractor::FieldValue& value, Function function) {
         return std::visit([&](const auto& val) -> TransformationResult {
             using T = std::decay_t<decltype(val)>;
             if constexpr (std::is_arithmetic_v<T>) {
@@ -648,6 +963,7 @@ private:
         chain.history.clear();
         chain.cumulativeValue = 0.0;
         chain.initialized = false;
+        chain.kernel.reset();
     }
 };
 
@@ -0,0 +1,432 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../../parser/layout/byte_order.h"
+
+namespace Monitor {
+namespace Packet {
+
+/**
+ * @brief Decoded field values of packets, one row per packet and one column per field slot
+ *
+ * Every numeric field is stored in reals() as a double. Integer and
+ * bitfield values are also stored exactly in integers(), unsigned 64-bit
+ * values by their bit pattern. Floating-point fields leave 0 there. A
+ * column no op fills, such as an array, reads NaN and 0. Rows are
+ * contiguous, so a batch of packets decodes into one allocation.
+ */
+class FieldFrame {
+public:
+    FieldFrame() = default;
+
+    explicit FieldFrame(size_t columns, size_t rows = 1) {
+        resize(columns, rows);
+    }
+
+    /**
+     * @brief Reshape the frame and reset every cell to NaN and 0
+     */
+    void resize(size_t columns, size_t rows = 1) {
+        m_columns = columns;
+        m_rows = rows;
+        m_reals.assign(columns * rows, std::numeric_limits<double>::quiet_NaN());
+        m_integers.assign(columns * rows, 0);
+    }
+
+    size_t columns() const { return m_columns; }
+    size_t rows() const { return m_rows; }
+
+    double* reals(size_t row = 0) { return m_reals.data() + row * m_columns; }
+    const double* reals(size_t row = 0) const { return m_reals.data() + row * m_columns; }
+    int64_t* integers(size_t row = 0) { return m_integers.data() + row * m_columns; }
+    const int64_t* integers(size_t row = 0) const { return m_integers.data() + row * m_columns; }
+
+    double real(size_t column, size_t row = 0) const { return m_reals[row * m_columns + column]; }
+    int64_t integer(size_t column, size_t row = 0) const { return m_integers[row * m_columns + column]; }
+
+private:
+    size_t m_columns = 0;
+    size_t m_rows = 0;
+    std::vector<double> m_reals;
+    std::vector<int64_t> m_integers;
+};
+
+/**
+ * @brief Decoded field values of a batch of packets, stored column by column
+ *
+ * The struct-of-arrays counterpart of FieldFrame, with the same cell
+ * conventions: column c of every packet is contiguous, so consumers that
+ * work on one field across many packets read it sequentially.
+ */
+class FieldColumns {
+public:
+    FieldColumns() = default;
+
+    FieldColumns(size_t columns, size_t rows) {
+        resize(columns, rows);
+    }
+
+    /**
+     * @brief Reshape and reset every cell to NaN and 0
+     */
+    void resize(size_t columns, size_t rows) {
+        m_columns = columns;
+        m_rows = rows;
+        m_reals.assign(columns * rows, std::numeric_limits<double>::quiet_NaN());
+        m_integers.assign(columns * rows, 0);
+    }
+
+    size_t columns() const { return m_columns; }
+    size_t rows() const { return m_rows; }
+
+    double* reals(size_t column) { return m_reals.data() + column * m_rows; }
+    const double* reals(size_t column) const { return m_reals.data() + column * m_rows; }
+    int64_t* integers(size_t column) { return m_integers.data() + column * m_rows; }
+    const int64_t* integers(size_t column) const { return m_integers.data() + column * m_rows; }
+
+    double real(size_t column, size_t row) const { return m_reals[column * m_rows + row]; }
+    int64_t integer(size_t column, size_t row) const { return m_integers[column * m_rows + row]; }
+
+private:
+    size_t m_columns = 0;
+    size_t m_rows = 0;
+    std::vector<double> m_reals;
+    std::vector<int64_t> m_integers;
+};
+
+/**
+ * @brief Compiled decoder for the numeric fields of one packet type
+ *
+ * A flat array of ops, one per field, each with the byte offset and width
+ * to read, the shift and mask of a bitfield, the frame column to write and
+ * a decode function picked when the plan was compiled. Running the plan
+ * calls the ops in order: no type names are compared and no results
+ * allocated per packet. Callers resolve field names to columns once, when
+ * they subscribe, and read the frame by column from then on.
+ *
+ * Fields stored in the other byte order than the host's get decoders that
+ * swap with a single bswap after the load, so a foreign-endian packet type
+ * costs what a native one does.
+ */
+class ExtractionPlan {
+public:
+    enum class Kind : uint8_t {
+        Bool,
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+        Bits        ///< Bitfield: shifted and masked unsigned value
+    };
+
+    using ByteOrder = Parser::Layout::ByteOrder;
+
+    struct Op;
+
+    /**
+     * @brief Decode one field of @p payload into column op.column of a row
+     */
+    using DecodeFunction = void (*)(const uint8_t* payload, const Op& op, double* reals, int64_t* integers);
+
+    struct Op {
+        uint32_t offset = 0;            ///< Byte offset in the payload
+        uint8_t width = 0;              ///< Bytes read
+        Kind kind = Kind::UInt8;
+        uint8_t shift = 0;              ///< Bits dropped below a bitfield
+        uint64_t mask = 0;              ///< Bits kept after the shift; bitfields only
+        uint32_t column = 0;            ///< Frame column written
+        bool swapped = false;           ///< Bytes are reversed before decoding
+        DecodeFunction decode = nullptr;
+    };
+
+    /**
+     * @brief Kind of a C type name, spelled as the parser spells it
+     * @return False for types a plan does not decode
+     */
+    static bool kindOf(const std::string& typeName, Kind& kind) {
+        if (typeName == "bool" || typeName == "_Bool") {
+            kind = Kind::Bool;
+        } else if (typeName == "char" || typeName == "signed char") {
+            kind = Kind::Int8;
+        } else if (typeName == "unsigned char") {
+            kind = Kind::UInt8;
+        } else if (typeName == "short" || typeName == "short int" || typeName == "signed short") {
+            kind = Kind::Int16;
+        } else if (typeName == "unsigned short" || typeName == "unsigned short int") {
+            kind = Kind::UInt16;
+        } else if (typeName == "int" || typeName == "signed int") {
+            kind = Kind::Int32;
+        } else if (typeName == "unsigned int") {
+            kind = Kind::UInt32;
+        } else if (typeName == "long" || typeName == "long int" || typeName == "signed long" ||
+                   typeName == "long long" || typeName == "signed long long") {
+            kind = Kind::Int64;
+        } else if (typeName == "unsigned long" || typeName == "unsigned long int" ||
+                   typeName == "unsigned long long") {
+            kind = Kind::UInt64;
+        } else if (typeName == "float") {
+            kind = Kind::Float;
+        } else if (typeName == "double") {
+            kind = Kind::Double;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Bytes a field of @p kind occupies; bitfields give their own
+     */
+    static size_t widthOf(Kind kind) {
+        switch (kind) {
+            case Kind::Bool:
+            case Kind::Int8:
+            case Kind::UInt8:  return 1;
+            case Kind::Int16:
+            case Kind::UInt16: return 2;
+            case Kind::Int32:
+            case Kind::UInt32:
+            case Kind::Float:  return 4;
+            case Kind::Int64:
+            case Kind::UInt64:
+            case Kind::Double: return 8;
+            case Kind::Bits:   return 0;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Set the number of frame columns; fields without an op keep theirs unwritten
+     */
+    void setColumnCount(size_t columns) { m_columnCount = columns; }
+
+    /**
+     * @brief Decode a whole field of @p kind at @p offset, stored in
+     *        @p byteOrder, into @p column
+     */
+    void addField(uint32_t column, size_t offset, Kind kind, ByteOrder byteOrder = ByteOrder::Native) {
+        Op op;
+        op.offset = static_cast<uint32_t>(offset);
+        op.width = static_cast<uint8_t>(widthOf(kind));
+        op.kind = kind;
+        op.column = column;
+        op.swapped = op.width > 1 && Parser::Layout::needsByteSwap(byteOrder);
+        op.decode = op.swapped ? swappedDecoderFor(kind) : decoderFor(kind);
+        addOp(op);
+    }
+
+    /**
+     * @brief Decode @p bitWidth bits, @p bitOffset up from the start of a
+     *        @p width byte unit at @p offset, into @p column
+     *
+     * A unit stored in the other byte order is swapped to host order first;
+     * @p bitOffset counts from the least significant bit of the swapped unit.
+     */
+    void addBitfield(uint32_t column, size_t offset, size_t width, uint8_t bitOffset, uint8_t bitWidth,
+                     ByteOrder byteOrder = ByteOrder::Native) {
+        Op op;
+        op.offset = static_cast<uint32_t>(offset);
+        op.width = static_cast<uint8_t>(std::min(std::max<size_t>(width, 1), sizeof(uint64_t)));
+        op.kind = Kind::Bits;
+        op.shift = bitOffset;
+        op.mask = bitWidth >= 64 ? ~uint64_t(0) : (uint64_t(1) << bitWidth) - 1;
+        op.column = column;
+        op.swapped = op.width > 1 && Parser::Layout::needsByteSwap(byteOrder);
+        op.decode = (op.swapped ? SWAPPED_BITS_DECODERS : BITS_DECODERS)[op.width - 1];
+        addOp(op);
+    }
+
+    void clear() {
+        m_ops.clear();
+        m_columnCount = 0;
+        m_extent = 0;
+    }
+
+    const std::vector<Op>& ops() const { return m_ops; }
+    size_t columnCount() const { return m_columnCount; }
+    bool isEmpty() const { return m_ops.empty(); }
+
+    /**
+     * @brief Smallest payload every op fits in
+     */
+    size_t extent() const { return m_extent; }
+
+    /**
+     * @brief Decode @p payload into one frame row of columnCount() columns
+     *
+     * A payload shorter than extent() decodes the fields that fit and sets
+     * the rest to NaN and 0.
+     *
+     * @return Fields decoded
+     */
+    size_t run(const uint8_t* payload, size_t payloadSize, double* reals, int64_t* integers) const {
+        if (payload && payloadSize >= m_extent) {
+            for (const Op& op : m_ops) {
+                op.decode(payload, op, reals, integers);
+            }
+            return m_ops.size();
+        }
+
+        size_t decoded = 0;
+        for (const Op& op : m_ops) {
+            if (payload && op.offset + op.width <= payloadSize) {
+                op.decode(payload, op, reals, integers);
+                ++decoded;
+            } else {
+                reals[op.column] = std::numeric_limits<double>::quiet_NaN();
+                integers[op.column] = 0;
+            }
+        }
+        return decoded;
+    }
+
+    size_t run(const uint8_t* payload, size_t payloadSize, FieldFrame& frame, size_t row = 0) const {
+        return run(payload, payloadSize, frame.reals(row), frame.integers(row));
+    }
+
+private:
+    void addOp(const Op& op) {
+        m_ops.push_back(op);
+        if (op.column >= m_columnCount) {
+            m_columnCount = op.column + 1;
+        }
+        if (op.offset + op.width > m_extent) {
+            m_extent = op.offset + op.width;
+        }
+    }
+
+    template<typename T>
+    static void decodeInteger(const uint8_t* payload, const Op& op, double* reals, int64_t* integers) {
+        T value;
+        std::memcpy(&value, payload + op.offset, sizeof(T));
+        reals[op.column] = static_cast<double>(value);
+        integers[op.column] = static_cast<int64_t>(value);
+    }
+
+    template<typename T>
+    static void decodeFloating(const uint8_t* payload, const Op& op, double* reals, int64_t* integers) {
+        T value;
+        std::memcpy(&value, payload + op.offset, sizeof(T));
+        reals[op.column] = static_cast<double>(value);
+        integers[op.column] = 0;
+    }
+
+    template<typename T>
+    static void decodeSwappedInteger(const uint8_t* payload, const Op& op, double* reals, int64_t* integers) {
+        T value;
+        std::memcpy(&value, payload + op.offset, sizeof(T));
+        value = Parser::Layout::byteSwapped(value);
+        reals[op.column] = static_cast<double>(value);
+        integers[op.column] = static_cast<int64_t>(value);
+    }
+
+    template<typename T>
+    static void decodeSwappedFloating(const uint8_t* payload, const Op& op, double* reals, int64_t* integers) {
+        T value;
+        std::memcpy(&value, payload + op.offset, sizeof(T));
+        reals[op.column] = static_cast<double>(Parser::Layout::byteSwapped(value));
+        integers[op.column] = 0;
+    }
+
+    static void decodeBool(const uint8_t* payload, const Op& op, double* reals, int64_t* integers) {
+        const bool value = payload[op.offset] != 0;
+        reals[op.column] = value ? 1.0 : 0.0;
+        integers[op.column] = value ? 1 : 0;
+    }
+
+    // Power-of-two widths load as whole integers; copying bytes into a
+    // zeroed word instead makes the following read wait on the stores
+    template<size_t Width>
+    static uint64_t loadBits(const uint8_t* data) {
+        if constexpr (Width == 1 || Width == 2 || Width == 4 || Width == 8) {
+            using Unit = std::conditional_t<Width == 1, uint8_t,
+                         std::conditional_t<Width == 2, uint16_t,
+                         std::conditional_t<Width == 4, uint32_t, uint64_t>>>;
+            Unit unit;
+            std::memcpy(&unit, data, Width);
+            return unit;
+        } else {
+            uint64_t raw = 0;
+            std::memcpy(&raw, data, Width);
+            return raw;
+        }
+    }
+
+    // Fixed width, so the read compiles to one load. Swapped units are
+    // reversed as a whole word, which leaves their bytes at the top.
+    template<size_t Width, bool Swapped>
+    static void decodeBits(const uint8_t* payload, const Op& op, double* reals, int64_t* integers) {
+        uint64_t raw = loadBits<Width>(payload + op.offset);
+        if constexpr (Swapped) {
+            raw = Parser::Layout::byteSwap(raw) >> (64 - 8 * Width);
+        }
+        const uint64_t value = (raw >> op.shift) & op.mask;
+        reals[op.column] = static_cast<double>(value);
+        integers[op.column] = static_cast<int64_t>(value);
+    }
+
+    static DecodeFunction decoderFor(Kind kind) {
+        switch (kind) {
+            case Kind::Bool:   return &decodeBool;
+            case Kind::Int8:   return &decodeInteger<int8_t>;
+            case Kind::UInt8:  return &decodeInteger<uint8_t>;
+            case Kind::Int16:  return &decodeInteger<int16_t>;
+            case Kind::UInt16: return &decodeInteger<uint16_t>;
+            case Kind::Int32:  return &decodeInteger<int32_t>;
+            case Kind::UInt32: return &decodeInteger<uint32_t>;
+            case Kind::Int64:  return &decodeInteger<int64_t>;
+            case Kind::UInt64: return &decodeInteger<uint64_t>;
+            case Kind::Float:  return &decodeFloating<float>;
+            case Kind::Double: return &decodeFloating<double>;
+            case Kind::Bits:   return &decodeBits<sizeof(uint64_t), false>;
+        }
+        return nullptr;
+    }
+
+    // Single-byte kinds read the same in either order
+    static DecodeFunction swappedDecoderFor(Kind kind) {
+        switch (kind) {
+            case Kind::Int16:  return &decodeSwappedInteger<int16_t>;
+            case Kind::UInt16: return &decodeSwappedInteger<uint16_t>;
+            case Kind::Int32:  return &decodeSwappedInteger<int32_t>;
+            case Kind::UInt32: return &decodeSwappedInteger<uint32_t>;
+            case Kind::Int64:  return &decodeSwappedInteger<int64_t>;
+            case Kind::UInt64: return &decodeSwappedInteger<uint64_t>;
+            case Kind::Float:  return &decodeSwappedFloating<float>;
+            case Kind::Double: return &decodeSwappedFloating<double>;
+            case Kind::Bits:   return &decodeBits<sizeof(uint64_t), true>;
+            default:           return decoderFor(kind);
+        }
+    }
+
+    static constexpr DecodeFunction BITS_DECODERS[sizeof(uint64_t)] = {
+        &decodeBits<1, false>, &decodeBits<2, false>, &decodeBits<3, false>, &decodeBits<4, false>,
+        &decodeBits<5, false>, &decodeBits<6, false>, &decodeBits<7, false>, &decodeBits<8, false>
+    };
+
+    static constexpr DecodeFunction SWAPPED_BITS_DECODERS[sizeof(uint64_t)] = {
+        &decodeBits<1, true>, &decodeBits<2, true>, &decodeBits<3, true>, &decodeBits<4, true>,
+        &decodeBits<5, true>, &decodeBits<6, true>, &decodeBits<7, true>, &decodeBits<8, true>
+    };
+
+    std::vector<Op> m_ops;
+    size_t m_columnCount = 0;
+    size_t m_extent = 0;    ///< Largest offset + width of any op
+};
+
+} // namespace Packet
+} // namespace Monitor
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../core/packet.h"
+#include "../core/packet_type_registry.h"
+#include "extraction_plan.h"
 #include "../../parser/layout/layout_calculator.h"
 #include "../../logging/logger.h"
 #include "../../profiling/profiler.h"
@@ -58,16 +60,19 @@ public:
         bool isArray;               ///< True if field is an array
         size_t arraySize;           ///< Array size (if isArray)
         bool isNullTerminated;      ///< True for null-terminated strings
+        Parser::Layout::ByteOrder byteOrder;    ///< Byte order the value is stored in
         
         FieldDescriptor() 
             : offset(0), size(0), isBitfield(false), bitOffset(0), bitWidth(0),
-              isArray(false), arraySize(0), isNullTerminated(false)
+              isArray(false), arraySize(0), isNullTerminated(false),
+              byteOrder(Parser::Layout::ByteOrder::Native)
         {
         }
         
         FieldDescriptor(const std::string& fieldName, size_t fieldOffset, size_t fieldSize, const std::string& type)
             : name(fieldName), offset(fieldOffset), size(fieldSize), typeName(type),
-              isBitfield(false), bitOffset(0), bitWidth(0), isArray(false), arraySize(0), isNullTerminated(false)
+              isBitfield(false), bitOffset(0), bitWidth(0), isArray(false), arraySize(0), isNullTerminated(false),
+              byteOrder(Parser::Layout::ByteOrder::Native)
         {
         }
         
@@ -99,6 +104,7 @@ public:
         std::vector<FieldDescriptor> fields;
         std::unordered_map<std::string, size_t> fieldIndex; ///< Name to index lookup
         size_t totalPayloadSize;
+        ExtractionPlan plan;                                ///< Numeric fields, column i is fields[i]
         
         PacketFieldMap() : packetId(0), totalPayloadSize(0) {}
         PacketFieldMap(PacketId id, const std::string& name) 
@@ -106,8 +112,9 @@ public:
     };
 
 private:
-    // Field descriptor cache
-    std::unordered_map<PacketId, PacketFieldMap> m_fieldMaps;
+    // Field descriptor cache, indexed by packet type slot
+    PacketSlotTable<std::unique_ptr<PacketFieldMap>> m_fieldMaps;
+    PacketTypeRegistry* m_registry;
     
     // Utilities
     Logging::Logger* m_logger;
@@ -115,16 +122,21 @@ private:
 
 public:
     explicit FieldExtractor()
-        : m_logger(Logging::Logger::instance())
+        : m_registry(PacketTypeRegistry::instance())
+        , m_logger(Logging::Logger::instance())
         , m_profiler(Profiling::Profiler::instance())
     {
     }
     
     /**
      * @brief Build field map from structure definition
+     * @param byteOrder Byte order of the packets' payloads, e.g. from
+     *        StructureManager::getByteOrder(); Native keeps the order the
+     *        structure was declared in
      */
     bool buildFieldMap(PacketId packetId, 
-                      std::shared_ptr<const Parser::AST::StructDeclaration> structure) {
+                      std::shared_ptr<const Parser::AST::StructDeclaration> structure,
+                      Parser::Layout::ByteOrder byteOrder = Parser::Layout::ByteOrder::Native) {
         if (!structure) {
             m_logger->error("FieldExtractor", "Null structure definition");
             return false;
@@ -132,6 +144,13 @@ public:
         
         PROFILE_SCOPE("FieldExtractor::buildFieldMap");
         
+        auto* entry = m_fieldMaps.obtain(m_registry->registerPacketId(packetId));
+        if (!entry) {
+            m_logger->error("FieldExtractor", 
+                QString("No packet type slot left for packet ID %1").arg(packetId));
+            return false;
+        }
+        
         PacketFieldMap fieldMap(packetId, structure->getName());
         
         // Use layout calculator to get field offsets
@@ -146,39 +165,55 @@ public:
         
         // Build field descriptors from layout information
         buildFieldDescriptorsRecursive(structure, layoutResult, "", 0, fieldMap.fields);
+        fieldMap.totalPayloadSize = layoutResult.totalSize;
         
-        // Build lookup index
-        for (size_t i = 0; i < fieldMap.fields.size(); ++i) {
-            fieldMap.fieldIndex[fieldMap.fields[i].name] = i;
+        if (byteOrder == Parser::Layout::ByteOrder::Native) {
+            byteOrder = structure->getByteOrder();
+        }
+        for (auto& descriptor : fieldMap.fields) {
+            descriptor.byteOrder = byteOrder;
         }
         
-        fieldMap.totalPayloadSize = layoutResult.totalSize;
+        storeFieldMap(*entry, std::move(fieldMap));
+        return true;
+    }
+    
+    /**
+     * @brief Build field map from descriptors whose layout is already known
+     */
+    bool buildFieldMap(PacketId packetId, const std::string& structureName,
+                      std::vector<FieldDescriptor> fields, size_t totalPayloadSize = 0) {
+        PROFILE_SCOPE("FieldExtractor::buildFieldMap");
         
-        // Store in cache
-        m_fieldMaps[packetId] = std::move(fieldMap);
+        auto* entry = m_fieldMaps.obtain(m_registry->registerPacketId(packetId));
+        if (!entry) {
+            m_logger->error("FieldExtractor", 
+                QString("No packet type slot left for packet ID %1").arg(packetId));
+            return false;
+        }
         
-        m_logger->info("FieldExtractor", 
-            QString("Built field map for packet ID %1 (%2): %3 fields, %4 bytes total")
-                .arg(packetId).arg(QString::fromStdString(structure->getName()))
-                .arg(fieldMap.fields.size()).arg(layoutResult.totalSize));
+        PacketFieldMap fieldMap(packetId, structureName);
+        fieldMap.fields = std::move(fields);
+        fieldMap.totalPayloadSize = totalPayloadSize;
         
+        storeFieldMap(*entry, std::move(fieldMap));
         return true;
     }
     
     /**
      * @brief Extract single field by name
      */
-    ExtractionResult extractField(PacketPtr packet, const std::string& fieldName) const {
+    ExtractionResult extractField(const PacketPtr& packet, const std::string& fieldName) const {
         if (!packet || !packet->isValid()) {
             return ExtractionResult(std::string("Invalid packet"));
         }
         
-        auto it = m_fieldMaps.find(packet->id());
-        if (it == m_fieldMaps.end()) {
+        const PacketFieldMap* fieldMapPtr = findFieldMap(packet->id());
+        if (!fieldMapPtr) {
             return ExtractionResult(std::string("No field map for packet ID " + std::to_string(packet->id())));
         }
         
-        const auto& fieldMap = it->second;
+        const auto& fieldMap = *fieldMapPtr;
         auto fieldIt = fieldMap.fieldIndex.find(fieldName);
         if (fieldIt == fieldMap.fieldIndex.end()) {
             return ExtractionResult(std::string("Field not found: " + fieldName));
@@ -191,7 +226,7 @@ public:
     /**
      * @brief Extract field by pre-built descriptor (most efficient)
      */
-    ExtractionResult extractFieldByDescriptor(PacketPtr packet, const FieldDescriptor& descriptor) const {
+    ExtractionResult extractFieldByDescriptor(const PacketPtr& packet, const FieldDescriptor& descriptor) const {
         if (!packet || !packet->isValid()) {
             return ExtractionResult(std::string("Invalid packet"));
         }
@@ -225,7 +260,7 @@ public:
      * @brief Extract multiple fields efficiently
      */
     std::unordered_map<std::string, ExtractionResult> extractFields(
-        PacketPtr packet, const std::vector<std::string>& fieldNames) const {
+        const PacketPtr& packet, const std::vector<std::string>& fieldNames) const {
         
         std::unordered_map<std::string, ExtractionResult> results;
         
@@ -236,8 +271,8 @@ public:
             return results;
         }
         
-        auto it = m_fieldMaps.find(packet->id());
-        if (it == m_fieldMaps.end()) {
+        const PacketFieldMap* fieldMapPtr = findFieldMap(packet->id());
+        if (!fieldMapPtr) {
             std::string error = "No field map for packet ID " + std::to_string(packet->id());
             for (const auto& name : fieldNames) {
                 results[name] = ExtractionResult(std::string(error));
@@ -247,7 +282,7 @@ public:
         
         PROFILE_SCOPE("FieldExtractor::extractFields");
         
-        const auto& fieldMap = it->second;
+        const auto& fieldMap = *fieldMapPtr;
         
         for (const auto& fieldName : fieldNames) {
             auto fieldIt = fieldMap.fieldIndex.find(fieldName);
@@ -266,53 +301,160 @@ public:
     /**
      * @brief Extract all fields from packet
      */
-    std::unordered_map<std::string, ExtractionResult> extractAllFields(PacketPtr packet) const {
+    std::unordered_map<std::string, ExtractionResult> extractAllFields(const PacketPtr& packet) const {
         std::unordered_map<std::string, ExtractionResult> results;
         
         if (!packet || !packet->isValid()) {
             return results;
         }
         
-        auto it = m_fieldMaps.find(packet->id());
-        if (it == m_fieldMaps.end()) {
+        const PacketFieldMap* fieldMap = findFieldMap(packet->id());
+        if (!fieldMap) {
             return results;
         }
         
         PROFILE_SCOPE("FieldExtractor::extractAllFields");
         
-        const auto& fieldMap = it->second;
         
-        for (const auto& descriptor : fieldMap.fields) {
+        for (const auto& descriptor : fieldMap->fields) {
             results[descriptor.name] = extractFieldByDescriptor(packet, descriptor);
         }
         
         return results;
     }
     
+    /**
+     * @brief Compiled plan for packet type, or nullptr if no field map was built
+     *
+     * Column i of the plan's frame holds field i of getFieldDescriptors().
+     * The plan lives until the packet type's field map is rebuilt.
+     */
+    const ExtractionPlan* getExtractionPlan(PacketId packetId) const {
+        const PacketFieldMap* fieldMap = findFieldMap(packetId);
+        return fieldMap ? &fieldMap->plan : nullptr;
+    }
+    
+    /**
+     * @brief Frame columns of @p fieldNames; -1 for names the packet type lacks
+     *
+     * Resolve names once, when subscribing, and index frames by column after.
+     */
+    std::vector<int> resolveColumns(PacketId packetId, const std::vector<std::string>& fieldNames) const {
+        std::vector<int> columns(fieldNames.size(), -1);
+        const PacketFieldMap* fieldMap = findFieldMap(packetId);
+        if (!fieldMap) {
+            return columns;
+        }
+        
+        for (size_t i = 0; i < fieldNames.size(); ++i) {
+            auto fieldIt = fieldMap->fieldIndex.find(fieldNames[i]);
+            if (fieldIt != fieldMap->fieldIndex.end()) {
+                columns[i] = static_cast<int>(fieldIt->second);
+            }
+        }
+        return columns;
+    }
+    
+    /**
+     * @brief Decode every numeric field of @p packet into row @p row of @p frame
+     * @return False if the packet is invalid, has no field map, or the frame
+     *         is too narrow or short for it
+     */
+    bool extractInto(const PacketPtr& packet, FieldFrame& frame, size_t row = 0) const {
+        if (!packet || !packet->isValid()) {
+            return false;
+        }
+        
+        const PacketFieldMap* fieldMap = findFieldMap(packet->id());
+        if (!fieldMap || frame.columns() < fieldMap->plan.columnCount() || row >= frame.rows()) {
+            return false;
+        }
+        
+        fieldMap->plan.run(packet->payload(), packet->payloadSize(), frame, row);
+        return true;
+    }
+    
     /**
      * @brief Get field descriptors for packet type
      */
     std::vector<FieldDescriptor> getFieldDescriptors(PacketId packetId) const {
-        auto it = m_fieldMaps.find(packetId);
-        return (it != m_fieldMaps.end()) ? it->second.fields : std::vector<FieldDescriptor>();
+        const PacketFieldMap* fieldMap = findFieldMap(packetId);
+        return fieldMap ? fieldMap->fields : std::vector<FieldDescriptor>();
     }
     
     /**
      * @brief Check if packet type has field map
      */
     bool hasFieldMap(PacketId packetId) const {
-        return m_fieldMaps.find(packetId) != m_fieldMaps.end();
+        return findFieldMap(packetId) != nullptr;
     }
     
     /**
      * @brief Get field count for packet type
      */
     size_t getFieldCount(PacketId packetId) const {
-        auto it = m_fieldMaps.find(packetId);
-        return (it != m_fieldMaps.end()) ? it->second.fields.size() : 0;
+        const PacketFieldMap* fieldMap = findFieldMap(packetId);
+        return fieldMap ? fieldMap->fields.size() : 0;
     }
 
 private:
+    /**
+     * @brief Field map for packet type, or nullptr if none was built
+     */
+    const PacketFieldMap* findFieldMap(PacketId packetId) const {
+        const auto* entry = m_fieldMaps.find(m_registry->findSlot(packetId));
+        return entry ? entry->get() : nullptr;
+    }
+    
+    /**
+     * @brief Index, compile and cache @p fieldMap
+     */
+    void storeFieldMap(std::unique_ptr<PacketFieldMap>& entry, PacketFieldMap fieldMap) {
+        for (size_t i = 0; i < fieldMap.fields.size(); ++i) {
+            fieldMap.fieldIndex[fieldMap.fields[i].name] = i;
+        }
+        compilePlan(fieldMap);
+        
+        entry = std::make_unique<PacketFieldMap>(std::move(fieldMap));
+        
+        m_logger->info("FieldExtractor", 
+            QString("Built field map for packet ID %1 (%2): %3 fields, %4 compiled, %5 bytes total")
+                .arg(entry->packetId).arg(QString::fromStdString(entry->structureName))
+                .arg(entry->fields.size()).arg(entry->plan.ops().size()).arg(entry->totalPayloadSize));
+    }
+    
+    /**
+     * @brief Compile the numeric fields of @p fieldMap into its plan
+     *
+     * Type names are matched here, once per packet type, instead of per
+     * extracted field. Arrays and types extractPrimitive() returns as raw
+     * bytes get a column but no op.
+     */
+    static void compilePlan(PacketFieldMap& fieldMap) {
+        ExtractionPlan& plan = fieldMap.plan;
+        plan.clear();
+        plan.setColumnCount(fieldMap.fields.size());
+        
+        for (size_t i = 0; i < fieldMap.fields.size(); ++i) {
+            const FieldDescriptor& descriptor = fieldMap.fields[i];
+            const uint32_t column = static_cast<uint32_t>(i);
+            if (!descriptor.isValid() || descriptor.isArray) {
+                continue;
+            }
+            
+            if (descriptor.isBitfield) {
+                plan.addBitfield(column, descriptor.offset, descriptor.size,
+                                 descriptor.bitOffset, descriptor.bitWidth, descriptor.byteOrder);
+                continue;
+            }
+            
+            ExtractionPlan::Kind kind;
+            if (ExtractionPlan::kindOf(descriptor.typeName, kind)) {
+                plan.addField(column, descriptor.offset, kind, descriptor.byteOrder);
+            }
+        }
+    }
+    
     /**
      * @brief Recursively build field descriptors from structure
      */
@@ -369,6 +511,10 @@ private:
         uint64_t value = 0;
         size_t bytesToRead = std::min(descriptor.size, sizeof(uint64_t));
         std::memcpy(&value, data, bytesToRead);
+        if (bytesToRead > 1 && Parser::Layout::needsByteSwap(descriptor.byteOrder)) {
+            // Reversing the whole word leaves the unit's bytes at the top
+            value = Parser::Layout::byteSwap(value) >> (64 - 8 * bytesToRead);
+        }
         
         // Extract bits
         uint64_t mask = (1ULL << descriptor.bitWidth) - 1;
@@ -421,6 +567,7 @@ private:
         }
         
         const std::string& typeName = descriptor.typeName;
+        const Parser::Layout::ByteOrder order = descriptor.byteOrder;
         
         // Handle primitive types based on name and size
         if (typeName == "bool" || typeName == "_Bool") {
@@ -438,37 +585,37 @@ private:
         } else if (typeName == "short" || typeName == "short int" || typeName == "signed short") {
             int16_t value;
             std::memcpy(&value, data, sizeof(int16_t));
-            return ExtractionResult(value);
+            return ExtractionResult(Parser::Layout::toHostOrder(value, order));
         } else if (typeName == "unsigned short" || typeName == "unsigned short int") {
             uint16_t value;
             std::memcpy(&value, data, sizeof(uint16_t));
-            return ExtractionResult(value);
+            return ExtractionResult(Parser::Layout::toHostOrder(value, order));
         } else if (typeName == "int" || typeName == "signed int") {
             int32_t value;
             std::memcpy(&value, data, sizeof(int32_t));
-            return ExtractionResult(value);
+            return ExtractionResult(Parser::Layout::toHostOrder(value, order));
         } else if (typeName == "unsigned int") {
             uint32_t value;
             std::memcpy(&value, data, sizeof(uint32_t));
-            return ExtractionResult(value);
+            return ExtractionResult(Parser::Layout::toHostOrder(value, order));
         } else if (typeName == "long" || typeName == "long int" || typeName == "signed long" ||
                    typeName == "long long" || typeName == "signed long long") {
             int64_t value;
             std::memcpy(&value, data, sizeof(int64_t));
-            return ExtractionResult(value);
+            return ExtractionResult(Parser::Layout::toHostOrder(value, order));
         } else if (typeName == "unsigned long" || typeName == "unsigned long int" ||
                    typeName == "unsigned long long") {
             uint64_t value;
             std::memcpy(&value, data, sizeof(uint64_t));
-            return ExtractionResult(value);
+            return ExtractionResult(Parser::Layout::toHostOrder(value, order));
         } else if (typeName == "float") {
             float value;
             std::memcpy(&value, data, sizeof(float));
-            return ExtractionResult(value);
+            return ExtractionResult(Parser::Layout::toHostOrder(value, order));
         } else if (typeName == "double") {
             double value;
             std::memcpy(&value, data, sizeof(double));
-            return ExtractionResult(value);
+            return ExtractionResult(Parser::Layout::toHostOrder(value, order));
         } else {
             // Unknown type, return as raw bytes
             std::vector<uint8_t> bytes(data, data + descriptor.size);
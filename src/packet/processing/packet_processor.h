@@ -12,6 +12,7 @@
 
 #include <QtCore/QObject>
 #include <QString>
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
 #include <functional>
@@ -71,8 +72,8 @@ public:
         std::string error;
         
         ProcessingResult() = default;
-        ProcessingResult(PacketPtr pkt) : packet(pkt), success(true) {}
-        ProcessingResult(PacketPtr pkt, const std::string& err) : packet(pkt), success(false), error(err) {}
+        ProcessingResult(PacketPtr pkt) : packet(std::move(pkt)), success(true) {}
+        ProcessingResult(PacketPtr pkt, const std::string& err) : packet(std::move(pkt)), success(false), error(err) {}
     };
     
     /**
@@ -235,7 +236,7 @@ public:
     /**
      * @brief Process single packet
      */
-    ProcessingResult processPacket(PacketPtr packet) {
+    ProcessingResult processPacket(const PacketPtr& packet) {
         if (!packet || !packet->isValid()) {
             m_stats.packetsDropped++;
             return ProcessingResult(packet, "Invalid packet");
@@ -292,7 +293,7 @@ public:
         }
         
         // Submit to thread pool
-        return m_threadPool->submitTask([this, packet]() -> ProcessingResult {
+        return m_threadPool->submitTask([this, packet = std::move(packet)]() -> ProcessingResult {
             return processPacket(packet);
         });
     }
@@ -303,6 +304,7 @@ public:
     void setFieldProcessingConfig(PacketId packetId, const FieldProcessingConfig& config) {
         std::unique_lock lock(m_configMutex);
         m_fieldConfigs[packetId] = config;
+        m_dataTransformer->invalidateColumns(packetId);
         
         m_logger->debug("PacketProcessor", 
             QString("Set field config for packet ID %1: extract %2 fields, transform %3 fields")
@@ -387,7 +389,7 @@ signals:
     /**
      * @brief Emitted when processing fails
      */
-    void processingFailed(PacketPtr packet, const QString& error);
+    void processingFailed(const PacketPtr& packet, const QString& error);
     
     /**
      * @brief Emitted when statistics are updated
@@ -398,7 +400,7 @@ private:
     /**
      * @brief Internal packet processing implementation
      */
-    ProcessingResult processPacketInternal(PacketPtr packet) {
+    ProcessingResult processPacketInternal(const PacketPtr& packet) {
         ProcessingResult result(packet);
         
         try {
@@ -414,8 +416,27 @@ private:
                 }
             }
             
-            // Step 2: Data transformation
-            if (m_config.enableTransformation) {
+            // Packet types with a compiled plan are also decoded into a frame,
+            // which transformation and statistics index by column
+            const bool transform = m_config.enableTransformation && m_config.enableFieldExtraction;
+            const bool statistics = m_config.enableStatistics && config.enableStatistics;
+            const ExtractionPlan* plan = (transform || statistics) ? m_fieldExtractor->getExtractionPlan(packet->id()) : nullptr;
+            thread_local FieldFrame frame;
+            if (plan) {
+                // Reset every packet: columns without an op must read NaN, not a previous packet's value
+                frame.resize(plan->columnCount());
+                plan->run(packet->payload(), packet->payloadSize(), frame);
+            }
+            
+            // Step 2: Data transformation, by frame column for fully compiled chains
+            if (transform) {
+                if (plan) {
+                    if (!m_dataTransformer->isBound(packet->id())) {
+                        bindTransformColumns(packet->id(), config);
+                    }
+                    m_dataTransformer->transformFrame(packet->id(), frame, 0, result.transformedFields);
+                }
+                
                 std::vector<std::string> fieldsToTransform = config.fieldsToTransform;
                 if (fieldsToTransform.empty()) {
                     // Transform all extracted fields
@@ -424,7 +445,11 @@ private:
                     }
                 }
                 
+                // The rest one value at a time
                 for (const auto& fieldName : fieldsToTransform) {
+                    if (result.transformedFields.count(fieldName)) {
+                        continue;
+                    }
                     auto extractIt = result.extractedFields.find(fieldName);
                     if (extractIt != result.extractedFields.end() && extractIt->second.success) {
                         result.transformedFields[fieldName] = m_dataTransformer->transform(fieldName, extractIt->second.value);
@@ -432,9 +457,13 @@ private:
                 }
             }
             
-            // Step 3: Statistics update
-            if (m_config.enableStatistics && config.enableStatistics) {
-                m_statisticsCalculator->updateStatistics(result.extractedFields);
+            // Step 3: Statistics update, by field slot when the packet type has a compiled plan
+            if (statistics) {
+                if (plan) {
+                    m_statisticsCalculator->updateStatistics(packet->id(), frame);
+                } else {
+                    m_statisticsCalculator->updateStatistics(result.extractedFields);
+                }
             }
             
             result.success = true;
@@ -454,6 +483,30 @@ private:
         return result;
     }
     
+    /**
+     * @brief Bind the chains of the fields @p config transforms to the frame
+     *        columns of @p packetId
+     *
+     * Those are the fields listed to transform, or else every extracted one,
+     * as in the per-value path.
+     */
+    void bindTransformColumns(PacketId packetId, const FieldProcessingConfig& config) {
+        auto listed = [](const std::vector<std::string>& fields, const std::string& name) {
+            return fields.empty() || std::find(fields.begin(), fields.end(), name) != fields.end();
+        };
+        
+        const std::vector<FieldExtractor::FieldDescriptor> descriptors = m_fieldExtractor->getFieldDescriptors(packetId);
+        std::vector<std::string> columnNames;
+        columnNames.reserve(descriptors.size());
+        for (const auto& descriptor : descriptors) {
+            const bool transformed = listed(config.fieldsToTransform, descriptor.name) &&
+                                     listed(config.fieldsToExtract, descriptor.name);
+            columnNames.push_back(transformed ? descriptor.name : std::string());
+        }
+        
+        m_dataTransformer->bindColumns(packetId, columnNames);
+    }
+    
     /**
      * @brief Get field processing configuration
      */
@@ -491,7 +544,7 @@ private:
     /**
      * @brief Get cached processing result
      */
-    std::optional<ProcessingResult> getCachedResult(PacketPtr packet) const {
+    std::optional<ProcessingResult> getCachedResult(const PacketPtr& packet) const {
         std::shared_lock lock(m_cacheMutex);
         
         // Create hash from packet data
@@ -508,7 +561,7 @@ private:
     /**
      * @brief Cache processing result
      */
-    void cacheResult(PacketPtr packet, const ProcessingResult& result) {
+    void cacheResult(const PacketPtr& packet, const ProcessingResult& result) {
         std::unique_lock lock(m_cacheMutex);
         
         if (m_resultCache.size() >= m_config.maxCacheSize) {
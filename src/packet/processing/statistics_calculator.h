@@ -1,6 +1,8 @@
 #pragma once
 
 #include "field_extractor.h"
+#include "streaming_statistics.h"
+#include "../core/packet_type_registry.h"
 #include "../../logging/logger.h"
 #include "../../profiling/profiler.h"
 
@@ -25,6 +27,13 @@ namespace Packet {
  * This class provides running statistical calculations for field values,
  * maintaining efficient incremental updates and supporting windowed
  * statistics with configurable window sizes.
+ *
+ * Every statistic is updated in amortised O(1) per value (see
+ * SlidingWindowStatistics); nothing is re-summed or sorted per sample.
+ * Fields decoded by an ExtractionPlan are tracked by packet type slot and
+ * frame column: updateStatistics(PacketId, const FieldFrame&) takes one
+ * lock and one slot lookup per packet for all its fields. The by-name
+ * overloads remain for values that do not come from a frame.
  */
 class StatisticsCalculator {
 public:
@@ -36,6 +45,7 @@ public:
         std::atomic<uint64_t> sampleCount{0};
         std::atomic<double> sum{0.0};
         std::atomic<double> sumSquared{0.0};
+        std::atomic<double> sumSquaredDeviations{0.0};  ///< Welford's M2
         std::atomic<double> min{std::numeric_limits<double>::max()};
         std::atomic<double> max{std::numeric_limits<double>::lowest()};
         
@@ -43,7 +53,7 @@ public:
         std::atomic<double> current{0.0};
         std::atomic<double> previous{0.0};
         
-        // Computed statistics (updated periodically)
+        // Computed statistics (updated with every sample)
         std::atomic<double> mean{0.0};
         std::atomic<double> variance{0.0};
         std::atomic<double> standardDeviation{0.0};
@@ -68,6 +78,7 @@ public:
             sampleCount.store(other.sampleCount.load());
             sum.store(other.sum.load());
             sumSquared.store(other.sumSquared.load());
+            sumSquaredDeviations.store(other.sumSquaredDeviations.load());
             min.store(other.min.load());
             max.store(other.max.load());
             current.store(other.current.load());
@@ -88,6 +99,7 @@ public:
                 sampleCount.store(other.sampleCount.load());
                 sum.store(other.sum.load());
                 sumSquared.store(other.sumSquared.load());
+                sumSquaredDeviations.store(other.sumSquaredDeviations.load());
                 min.store(other.min.load());
                 max.store(other.max.load());
                 current.store(other.current.load());
@@ -108,6 +120,7 @@ public:
             sampleCount = 0;
             sum = 0.0;
             sumSquared = 0.0;
+            sumSquaredDeviations = 0.0;
             min = std::numeric_limits<double>::max();
             max = std::numeric_limits<double>::lowest();
             current = 0.0;
@@ -127,10 +140,13 @@ public:
     
     /**
      * @brief Windowed statistics for moving calculations
+     *
+     * The window* values are refreshed on every addValue() except
+     * windowMedian, which needs a sketch merge and is filled in by
+     * refreshMedian(); getWindowedStatistics() returns it filled in.
      */
     struct WindowedStatistics {
-        std::deque<double> values;
-        std::deque<std::chrono::steady_clock::time_point> timestamps;
+        SlidingWindowStatistics window;
         size_t maxWindowSize;
         std::chrono::milliseconds timeWindow;
         
@@ -141,67 +157,30 @@ public:
         double windowStdDev = 0.0;
         double windowMedian = 0.0;
         
-        WindowedStatistics(size_t maxSize = 1000, std::chrono::milliseconds timeWin = std::chrono::milliseconds(60000))
-            : maxWindowSize(maxSize), timeWindow(timeWin) {}
+        WindowedStatistics(size_t maxSize = 1000, std::chrono::milliseconds timeWin = std::chrono::milliseconds(60000),
+                           uint32_t sketchAccuracy = QuantileSketch::DEFAULT_ACCURACY)
+            : window(maxSize, timeWin, sketchAccuracy), maxWindowSize(maxSize), timeWindow(timeWin) {}
         
         void addValue(double value, std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now()) {
-            values.push_back(value);
-            timestamps.push_back(timestamp);
-            
-            // Remove old values based on window size
-            while (values.size() > maxWindowSize) {
-                values.pop_front();
-                timestamps.pop_front();
-            }
-            
-            // Remove old values based on time window
-            auto cutoffTime = timestamp - timeWindow;
-            while (!timestamps.empty() && timestamps.front() < cutoffTime) {
-                values.pop_front();
-                timestamps.pop_front();
-            }
-            
+            window.add(value, timestamp);
             updateWindowStatistics();
         }
         
         void updateWindowStatistics() {
-            if (values.empty()) return;
-            
-            // Calculate mean
-            double sum = 0.0;
-            windowMin = std::numeric_limits<double>::max();
-            windowMax = std::numeric_limits<double>::lowest();
+            if (window.isEmpty()) return;
             
-            for (double val : values) {
-                sum += val;
-                windowMin = std::min(windowMin, val);
-                windowMax = std::max(windowMax, val);
-            }
-            
-            windowMean = sum / values.size();
-            
-            // Calculate standard deviation
-            double variance = 0.0;
-            for (double val : values) {
-                double diff = val - windowMean;
-                variance += diff * diff;
-            }
-            windowStdDev = std::sqrt(variance / values.size());
-            
-            // Calculate median
-            std::vector<double> sortedValues(values.begin(), values.end());
-            std::sort(sortedValues.begin(), sortedValues.end());
-            size_t mid = sortedValues.size() / 2;
-            if (sortedValues.size() % 2 == 0) {
-                windowMedian = (sortedValues[mid - 1] + sortedValues[mid]) / 2.0;
-            } else {
-                windowMedian = sortedValues[mid];
-            }
+            windowMean = window.mean();
+            windowMin = window.min();
+            windowMax = window.max();
+            windowStdDev = window.standardDeviation();
+        }
+        
+        void refreshMedian() {
+            windowMedian = window.isEmpty() ? 0.0 : window.quantile(0.5);
         }
         
         void clear() {
-            values.clear();
-            timestamps.clear();
+            window.clear();
             windowMean = 0.0;
             windowMin = std::numeric_limits<double>::max();
             windowMax = std::numeric_limits<double>::lowest();
@@ -210,6 +189,29 @@ public:
         }
     };
     
+    /**
+     * @brief Statistics of one field slot, copied out under its packet type's lock
+     */
+    struct FieldSnapshot {
+        uint64_t sampleCount = 0;
+        double current = 0.0;
+        double previous = 0.0;
+        double mean = 0.0;
+        double variance = 0.0;          ///< Sample variance
+        double standardDeviation = 0.0;
+        double min = std::numeric_limits<double>::max();
+        double max = std::numeric_limits<double>::lowest();
+        double range = 0.0;
+        double rate = 0.0;              ///< Samples per second since the first
+        
+        size_t windowCount = 0;
+        double windowMean = 0.0;
+        double windowMin = std::numeric_limits<double>::max();
+        double windowMax = std::numeric_limits<double>::lowest();
+        double windowStdDev = 0.0;      ///< Population deviation of the window
+        double windowMedian = 0.0;
+    };
+    
     /**
      * @brief Configuration for statistics calculation
      */
@@ -219,7 +221,7 @@ public:
         std::chrono::milliseconds timeWindow; ///< Time window (1 minute)
         bool enablePercentiles;        ///< Enable percentile calculations
         std::vector<double> percentiles; ///< Percentiles to calculate
-        uint32_t updateIntervalMs;      ///< Statistics update interval
+        uint32_t sketchAccuracy;        ///< QuantileSketch accuracy of each window block
         
         Configuration() 
             : enableWindowed(true)
@@ -227,7 +229,7 @@ public:
             , timeWindow(std::chrono::milliseconds(60000))
             , enablePercentiles(false)
             , percentiles({25.0, 50.0, 75.0, 90.0, 95.0, 99.0})
-            , updateIntervalMs(1000)
+            , sketchAccuracy(QuantileSketch::DEFAULT_ACCURACY)
         {}
     };
 
@@ -239,8 +241,33 @@ private:
     std::unordered_map<std::string, WindowedStatistics> m_windowedStats;
     mutable std::shared_mutex m_statsMutex;
     
+    /**
+     * @brief Running state of one frame column
+     */
+    struct SlotState {
+        RunningMoments moments;
+        SlidingWindowStatistics window;
+        double current = 0.0;
+        double previous = 0.0;
+        std::chrono::steady_clock::time_point firstSample;
+        std::chrono::steady_clock::time_point lastSample;
+        
+        SlotState(size_t windowSize, std::chrono::milliseconds timeWindow, uint32_t sketchAccuracy)
+            : window(windowSize, timeWindow, sketchAccuracy) {}
+    };
+    
+    /**
+     * @brief Field slots of one packet type, indexed by frame column
+     */
+    struct PacketTypeStatistics {
+        mutable std::mutex mutex;
+        std::vector<SlotState> fields;
+    };
+    
+    PacketSlotTable<PacketTypeStatistics> m_slotStats;
+    PacketTypeRegistry* m_registry;
+    
     // Update tracking
-    std::chrono::steady_clock::time_point m_lastUpdate;
     std::atomic<uint64_t> m_totalSamples{0};
     
     // Utilities
@@ -250,7 +277,7 @@ private:
 public:
     explicit StatisticsCalculator(const Configuration& config = Configuration())
         : m_config(config)
-        , m_lastUpdate(std::chrono::steady_clock::now())
+        , m_registry(PacketTypeRegistry::instance())
         , m_logger(Logging::Logger::instance())
         , m_profiler(Profiling::Profiler::instance())
     {
@@ -279,23 +306,16 @@ public:
             
             // Update windowed statistics if enabled
             if (m_config.enableWindowed) {
-                auto& windowedStats = m_windowedStats[fieldName];
-                if (windowedStats.maxWindowSize == 0) {
-                    // Initialize windowed statistics
-                    windowedStats.maxWindowSize = m_config.windowSize;
-                    windowedStats.timeWindow = m_config.timeWindow;
+                auto windowIt = m_windowedStats.find(fieldName);
+                if (windowIt == m_windowedStats.end()) {
+                    windowIt = m_windowedStats.emplace(fieldName, WindowedStatistics(
+                        m_config.windowSize, m_config.timeWindow, m_config.sketchAccuracy)).first;
                 }
-                windowedStats.addValue(numericValue, now);
+                windowIt->second.addValue(numericValue, now);
             }
         }
         
         m_totalSamples++;
-        
-        // Periodically update computed statistics
-        if (now - m_lastUpdate > std::chrono::milliseconds(m_config.updateIntervalMs)) {
-            updateComputedStatistics();
-            m_lastUpdate = now;
-        }
     }
     
     /**
@@ -314,6 +334,164 @@ public:
         }
     }
     
+    /**
+     * @brief Update the field slots of @p packetId from one decoded frame row
+     *
+     * Column c of the row updates slot c of the packet type, as numbered by
+     * FieldExtractor::getFieldDescriptors(). NaN cells, such as arrays and
+     * fields past the end of a short packet, are skipped.
+     */
+    void updateStatistics(PacketId packetId, const FieldFrame& frame, size_t row = 0,
+                          std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now()) {
+        PacketTypeStatistics* statistics = m_slotStats.obtain(m_registry->registerPacketId(packetId));
+        if (!statistics || row >= frame.rows()) {
+            return;
+        }
+        
+        const double* reals = frame.reals(row);
+        uint64_t samples = 0;
+        {
+            std::lock_guard<std::mutex> lock(statistics->mutex);
+            ensureSlots(*statistics, frame.columns());
+            for (size_t column = 0; column < frame.columns(); ++column) {
+                samples += addSample(statistics->fields[column], reals[column], timestamp);
+            }
+        }
+        
+        m_totalSamples.fetch_add(samples, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Update the field slots of @p packetId from the first @p rows rows of a batch
+     *
+     * Walks the batch a column at a time, so each slot's state stays in
+     * cache while its values stream past. Every row counts as arriving at
+     * @p timestamp.
+     */
+    void updateStatistics(PacketId packetId, const FieldColumns& columns, size_t rows,
+                          std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now()) {
+        PROFILE_SCOPE("StatisticsCalculator::updateColumnStatistics");
+        
+        PacketTypeStatistics* statistics = m_slotStats.obtain(m_registry->registerPacketId(packetId));
+        if (!statistics) {
+            return;
+        }
+        
+        rows = std::min(rows, columns.rows());
+        uint64_t samples = 0;
+        {
+            std::lock_guard<std::mutex> lock(statistics->mutex);
+            ensureSlots(*statistics, columns.columns());
+            for (size_t column = 0; column < columns.columns(); ++column) {
+                SlotState& state = statistics->fields[column];
+                const double* values = columns.reals(column);
+                for (size_t row = 0; row < rows; ++row) {
+                    samples += addSample(state, values[row], timestamp);
+                }
+            }
+        }
+        
+        m_totalSamples.fetch_add(samples, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Statistics of frame column @p column of @p packetId
+     * @return An empty snapshot if the slot has seen no frames
+     */
+    FieldSnapshot getFieldSnapshot(PacketId packetId, size_t column) const {
+        FieldSnapshot snapshot;
+        const PacketTypeStatistics* statistics = m_slotStats.find(m_registry->findSlot(packetId));
+        if (!statistics) {
+            return snapshot;
+        }
+        
+        std::lock_guard<std::mutex> lock(statistics->mutex);
+        if (column >= statistics->fields.size()) {
+            return snapshot;
+        }
+        
+        const SlotState& state = statistics->fields[column];
+        const RunningMoments& moments = state.moments;
+        snapshot.sampleCount = moments.count;
+        if (moments.count > 0) {
+            snapshot.current = state.current;
+            snapshot.previous = state.previous;
+            snapshot.mean = moments.mean;
+            snapshot.variance = moments.variance();
+            snapshot.standardDeviation = std::sqrt(snapshot.variance);
+            snapshot.min = moments.min;
+            snapshot.max = moments.max;
+            snapshot.range = moments.max - moments.min;
+            
+            const double seconds = std::chrono::duration<double>(state.lastSample - state.firstSample).count();
+            snapshot.rate = seconds > 0.0 ? static_cast<double>(moments.count - 1) / seconds : 0.0;
+        }
+        
+        const SlidingWindowStatistics& window = state.window;
+        snapshot.windowCount = window.size();
+        if (!window.isEmpty()) {
+            snapshot.windowMean = window.mean();
+            snapshot.windowMin = window.min();
+            snapshot.windowMax = window.max();
+            snapshot.windowStdDev = window.standardDeviation();
+            snapshot.windowMedian = window.quantile(0.5);
+        }
+        return snapshot;
+    }
+    
+    /**
+     * @brief @p percentiles (0 to 100) of the window of frame column @p column
+     *
+     * All of them come from one merge of the window's sketches. Each is 0
+     * if the window is empty.
+     */
+    std::vector<double> calculatePercentiles(PacketId packetId, size_t column,
+                                             const std::vector<double>& percentiles) const {
+        std::vector<double> results(percentiles.size(), 0.0);
+        const PacketTypeStatistics* statistics = m_slotStats.find(m_registry->findSlot(packetId));
+        if (!statistics) {
+            return results;
+        }
+        
+        std::vector<double> fractions;
+        fractions.reserve(percentiles.size());
+        for (double percentile : percentiles) {
+            fractions.push_back(percentile / 100.0);
+        }
+        
+        std::lock_guard<std::mutex> lock(statistics->mutex);
+        if (column < statistics->fields.size() && !statistics->fields[column].window.isEmpty()) {
+            statistics->fields[column].window.quantiles(fractions.data(), fractions.size(), results.data());
+        }
+        return results;
+    }
+    
+    /**
+     * @brief Percentile (0 to 100) of the window of frame column @p column
+     */
+    double calculatePercentile(PacketId packetId, size_t column, double percentile) const {
+        return calculatePercentiles(packetId, column, {percentile}).front();
+    }
+    
+    /**
+     * @brief Quantile sketch of the window of frame column @p column
+     *
+     * Sketches of the same accuracy merge, so a caller can combine a field
+     * across packet types or calculators.
+     */
+    QuantileSketch getWindowSketch(PacketId packetId, size_t column) const {
+        const PacketTypeStatistics* statistics = m_slotStats.find(m_registry->findSlot(packetId));
+        if (!statistics) {
+            return QuantileSketch(m_config.sketchAccuracy);
+        }
+        
+        std::lock_guard<std::mutex> lock(statistics->mutex);
+        if (column >= statistics->fields.size()) {
+            return QuantileSketch(m_config.sketchAccuracy);
+        }
+        return statistics->fields[column].window.mergedSketch();
+    }
+    
     /**
      * @brief Get statistics for specific field
      */
@@ -329,7 +507,13 @@ public:
     WindowedStatistics getWindowedStatistics(const std::string& fieldName) const {
         std::shared_lock lock(m_statsMutex);
         auto it = m_windowedStats.find(fieldName);
-        return (it != m_windowedStats.end()) ? it->second : WindowedStatistics();
+        if (it == m_windowedStats.end()) {
+            return WindowedStatistics(m_config.windowSize, m_config.timeWindow, m_config.sketchAccuracy);
+        }
+        
+        WindowedStatistics windowed = it->second;
+        windowed.refreshMedian();
+        return windowed;
     }
     
     /**
@@ -380,8 +564,12 @@ public:
             pair.second.clear();
         }
         
+        m_slotStats.forEach([](PacketTypeRegistry::Slot, PacketTypeStatistics& statistics) {
+            std::lock_guard<std::mutex> slotLock(statistics.mutex);
+            statistics.fields.clear();
+        });
+        
         m_totalSamples = 0;
-        m_lastUpdate = std::chrono::steady_clock::now();
         
         m_logger->info("StatisticsCalculator", "Reset all statistics");
     }
@@ -407,24 +595,11 @@ public:
         std::shared_lock lock(m_statsMutex);
         
         auto it = m_windowedStats.find(fieldName);
-        if (it == m_windowedStats.end() || it->second.values.empty()) {
+        if (it == m_windowedStats.end() || it->second.window.isEmpty()) {
             return 0.0;
         }
         
-        const auto& values = it->second.values;
-        std::vector<double> sortedValues(values.begin(), values.end());
-        std::sort(sortedValues.begin(), sortedValues.end());
-        
-        double index = (percentile / 100.0) * (sortedValues.size() - 1);
-        size_t lowerIndex = static_cast<size_t>(std::floor(index));
-        size_t upperIndex = static_cast<size_t>(std::ceil(index));
-        
-        if (lowerIndex == upperIndex) {
-            return sortedValues[lowerIndex];
-        } else {
-            double weight = index - lowerIndex;
-            return sortedValues[lowerIndex] * (1.0 - weight) + sortedValues[upperIndex] * weight;
-        }
+        return it->second.window.quantile(percentile / 100.0);
     }
     
     /**
@@ -472,27 +647,31 @@ private:
      */
     void updateBasicStatistics(FieldStatistics& stats, double value, 
                               std::chrono::steady_clock::time_point timestamp) {
-        // Update basic counters
-        uint64_t count = stats.sampleCount.load();
-        stats.sampleCount = count + 1;
-        
-        // Update sum and sum of squares
-        double currentSum = stats.sum.load();
-        stats.sum = currentSum + value;
-        
-        double currentSumSquared = stats.sumSquared.load();
-        stats.sumSquared = currentSumSquared + (value * value);
-        
-        // Update min/max
-        double currentMin = stats.min.load();
-        while (value < currentMin && !stats.min.compare_exchange_weak(currentMin, value)) {
-            // Retry if another thread modified min
+        // Callers hold m_statsMutex exclusively, so plain loads and stores suffice
+        const uint64_t count = stats.sampleCount.load(std::memory_order_relaxed) + 1;
+        stats.sampleCount = count;
+        
+        stats.sum = stats.sum.load(std::memory_order_relaxed) + value;
+        stats.sumSquared = stats.sumSquared.load(std::memory_order_relaxed) + value * value;
+        
+        // Welford's update keeps mean and variance current without cancellation
+        const double mean = stats.mean.load(std::memory_order_relaxed);
+        const double delta = value - mean;
+        const double newMean = mean + delta / static_cast<double>(count);
+        const double m2 = stats.sumSquaredDeviations.load(std::memory_order_relaxed) + delta * (value - newMean);
+        const double variance = count > 1 ? m2 / static_cast<double>(count - 1) : 0.0;
+        stats.mean = newMean;
+        stats.sumSquaredDeviations = m2;
+        stats.variance = variance;
+        stats.standardDeviation = std::sqrt(variance);
+        
+        if (value < stats.min.load(std::memory_order_relaxed)) {
+            stats.min = value;
         }
-        
-        double currentMax = stats.max.load();
-        while (value > currentMax && !stats.max.compare_exchange_weak(currentMax, value)) {
-            // Retry if another thread modified max
+        if (value > stats.max.load(std::memory_order_relaxed)) {
+            stats.max = value;
         }
+        stats.range = stats.max.load(std::memory_order_relaxed) - stats.min.load(std::memory_order_relaxed);
         
         // Update current/previous
         stats.previous = stats.current.load();
@@ -518,38 +697,39 @@ private:
     }
     
     /**
-     * @brief Update computed statistics
+     * @brief Grow @p statistics to @p columns slots; caller holds its mutex
      */
-    void updateComputedStatistics() {
-        std::shared_lock lock(m_statsMutex);
+    void ensureSlots(PacketTypeStatistics& statistics, size_t columns) const {
+        if (statistics.fields.size() >= columns) {
+            return;
+        }
+        statistics.fields.reserve(columns);
+        while (statistics.fields.size() < columns) {
+            statistics.fields.emplace_back(m_config.windowSize, m_config.timeWindow, m_config.sketchAccuracy);
+        }
+    }
+    
+    /**
+     * @brief Add one frame cell to its slot
+     * @return 1 if the value was counted, 0 if it was NaN or infinite
+     */
+    uint64_t addSample(SlotState& state, double value, std::chrono::steady_clock::time_point timestamp) const {
+        if (!std::isfinite(value)) {
+            return 0;
+        }
         
-        for (auto& pair : m_fieldStats) {
-            auto& stats = pair.second;
-            uint64_t count = stats.sampleCount.load();
-            
-            if (count > 0) {
-                // Calculate mean
-                double mean = stats.sum.load() / count;
-                stats.mean = mean;
-                
-                // Calculate variance and standard deviation
-                if (count > 1) {
-                    double sumSquared = stats.sumSquared.load();
-                    double variance = (sumSquared - (count * mean * mean)) / (count - 1);
-                    stats.variance = variance;
-                    stats.standardDeviation = std::sqrt(std::max(0.0, variance));
-                } else {
-                    stats.variance = 0.0;
-                    stats.standardDeviation = 0.0;
-                }
-                
-                // Calculate range
-                stats.range = stats.max.load() - stats.min.load();
-            }
+        state.moments.add(value);
+        state.previous = state.moments.count > 1 ? state.current : value;
+        state.current = value;
+        if (state.moments.count == 1) {
+            state.firstSample = timestamp;
         }
+        state.lastSample = timestamp;
         
-        m_logger->debug("StatisticsCalculator", 
-            QString("Updated computed statistics for %1 fields").arg(m_fieldStats.size()));
+        if (m_config.enableWindowed) {
+            state.window.add(value, timestamp);
+        }
+        return 1;
     }
 };
 
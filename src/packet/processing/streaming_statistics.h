@@ -0,0 +1,559 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Monitor {
+namespace Packet {
+
+/**
+ * @brief Running sum with Neumaier's compensation
+ *
+ * Carries the low-order bits each addition rounds away, so long runs of
+ * adds and subtracts of the same values return to where they started
+ * instead of drifting.
+ */
+class KahanSum {
+public:
+    void add(double value) {
+        const double total = m_sum + value;
+        if (std::fabs(m_sum) >= std::fabs(value)) {
+            m_compensation += (m_sum - total) + value;
+        } else {
+            m_compensation += (value - total) + m_sum;
+        }
+        m_sum = total;
+    }
+
+    double value() const { return m_sum + m_compensation; }
+
+    void reset() {
+        m_sum = 0.0;
+        m_compensation = 0.0;
+    }
+
+private:
+    double m_sum = 0.0;
+    double m_compensation = 0.0;
+};
+
+/**
+ * @brief Count, mean, variance and extremes of every value seen, by Welford's method
+ */
+struct RunningMoments {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;        ///< Sum of squared deviations from the mean
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+
+    void add(double value) {
+        ++count;
+        const double delta = value - mean;
+        mean += delta / static_cast<double>(count);
+        m2 += delta * (value - mean);
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    /**
+     * @brief Sample variance; 0 below two values
+     */
+    double variance() const {
+        return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0;
+    }
+
+    void reset() { *this = RunningMoments(); }
+};
+
+/**
+ * @brief Mergeable streaming quantile sketch (KLL)
+ *
+ * Values go into level 0. When the sketch holds more than its capacity,
+ * the lowest full level is sorted and every other value, starting at a
+ * random one of the first two, moves up a level with twice the weight.
+ * Level capacities shrink by 2/3 per level down from the top, so the
+ * sketch keeps O(accuracy) values however many it has seen, and a rank
+ * query is off by about 1.7 / accuracy of the count with high
+ * probability. Until the first compaction every value is kept and
+ * quantiles are exact.
+ *
+ * Two sketches of the same accuracy merge by concatenating their levels,
+ * which is what lets windowed statistics keep one sketch per block of
+ * the window and combine the live blocks when asked.
+ */
+class QuantileSketch {
+public:
+    struct WeightedValue {
+        double value;
+        uint64_t weight;
+    };
+
+    static constexpr uint32_t DEFAULT_ACCURACY = 200;
+
+    explicit QuantileSketch(uint32_t accuracy = DEFAULT_ACCURACY)
+        : m_accuracy(std::max<uint32_t>(accuracy, MIN_LEVEL_CAPACITY))
+    {
+        clear();
+    }
+
+    void add(double value) {
+        m_levels[0].push_back(value);
+        ++m_count;
+        if (++m_retained >= m_capacity) {
+            compress();
+        }
+    }
+
+    /**
+     * @brief Fold @p other into this sketch; @p other is left unchanged
+     */
+    void merge(const QuantileSketch& other) {
+        if (other.m_count == 0) {
+            return;
+        }
+        if (m_levels.size() < other.m_levels.size()) {
+            m_levels.resize(other.m_levels.size());
+            updateCapacity();
+        }
+        for (size_t level = 0; level < other.m_levels.size(); ++level) {
+            m_levels[level].insert(m_levels[level].end(), other.m_levels[level].begin(), other.m_levels[level].end());
+        }
+        m_count += other.m_count;
+        m_retained += other.m_retained;
+        while (m_retained >= m_capacity) {
+            compress();
+        }
+    }
+
+    /**
+     * @brief Append every retained value with its weight to @p values
+     */
+    void collect(std::vector<WeightedValue>& values) const {
+        for (size_t level = 0; level < m_levels.size(); ++level) {
+            const uint64_t weight = uint64_t(1) << level;
+            for (double value : m_levels[level]) {
+                values.push_back({value, weight});
+            }
+        }
+    }
+
+    /**
+     * @brief Value at @p fraction (0 to 1) of the way through the values seen
+     * @return NaN if the sketch is empty
+     */
+    double quantile(double fraction) const {
+        std::vector<WeightedValue> values;
+        values.reserve(m_retained);
+        collect(values);
+        return quantileOf(values, fraction);
+    }
+
+    /**
+     * @brief Quantile of weighted values, sorting @p values in place
+     *
+     * A value of weight w stands for w equal values, centred on its rank.
+     * Ranks between two values are interpolated linearly, which for
+     * unit weights is the usual interpolated percentile of a sorted array.
+     *
+     * @return NaN if @p values is empty
+     */
+    static double quantileOf(std::vector<WeightedValue>& values, double fraction) {
+        if (values.empty()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        std::sort(values.begin(), values.end(),
+                  [](const WeightedValue& a, const WeightedValue& b) { return a.value < b.value; });
+
+        uint64_t total = 0;
+        for (const WeightedValue& value : values) {
+            total += value.weight;
+        }
+
+        const double target = std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total - 1);
+        double previousRank = 0.0;
+        double previousValue = values.front().value;
+        uint64_t before = 0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            const double rank = static_cast<double>(before) + static_cast<double>(values[i].weight - 1) / 2.0;
+            if (rank >= target) {
+                if (i == 0 || rank == previousRank) {
+                    return values[i].value;
+                }
+                const double weight = (target - previousRank) / (rank - previousRank);
+                return previousValue * (1.0 - weight) + values[i].value * weight;
+            }
+            previousRank = rank;
+            previousValue = values[i].value;
+            before += values[i].weight;
+        }
+        return values.back().value;
+    }
+
+    uint64_t count() const { return m_count; }
+    size_t retained() const { return m_retained; }
+    bool isEmpty() const { return m_count == 0; }
+    uint32_t accuracy() const { return m_accuracy; }
+
+    void clear() {
+        m_levels.assign(1, std::vector<double>());
+        m_count = 0;
+        m_retained = 0;
+        updateCapacity();
+    }
+
+private:
+    static constexpr uint32_t MIN_LEVEL_CAPACITY = 8;
+
+    size_t levelCapacity(size_t level) const {
+        const double depth = static_cast<double>(m_levels.size() - level - 1);
+        const auto capacity = static_cast<size_t>(std::ceil(m_accuracy * std::pow(2.0 / 3.0, depth)));
+        return std::max<size_t>(capacity, MIN_LEVEL_CAPACITY);
+    }
+
+    void updateCapacity() {
+        m_capacity = 0;
+        for (size_t level = 0; level < m_levels.size(); ++level) {
+            m_capacity += levelCapacity(level);
+        }
+    }
+
+    /**
+     * @brief Compact the lowest level at or over its capacity
+     */
+    void compress() {
+        for (size_t level = 0; level < m_levels.size(); ++level) {
+            if (m_levels[level].size() >= levelCapacity(level)) {
+                if (level + 1 == m_levels.size()) {
+                    m_levels.emplace_back();
+                    updateCapacity();
+                }
+                compact(level);
+                return;
+            }
+        }
+    }
+
+    void compact(size_t level) {
+        std::vector<double>& values = m_levels[level];
+        std::vector<double>& above = m_levels[level + 1];
+        std::sort(values.begin(), values.end());
+
+        const size_t pairs = values.size() / 2;
+        const size_t offset = nextCoin();
+        for (size_t i = 0; i < pairs; ++i) {
+            above.push_back(values[2 * i + offset]);
+        }
+
+        // An odd value out stays behind at this level
+        const bool odd = values.size() % 2 != 0;
+        const double leftover = values.back();
+        values.clear();
+        if (odd) {
+            values.push_back(leftover);
+        }
+        m_retained -= pairs;
+    }
+
+    size_t nextCoin() {
+        // xorshift64: cheap, and the same stream every run
+        m_random ^= m_random << 13;
+        m_random ^= m_random >> 7;
+        m_random ^= m_random << 17;
+        return static_cast<size_t>(m_random & 1);
+    }
+
+    std::vector<std::vector<double>> m_levels;     ///< Level h values weigh 2^h
+    uint64_t m_count = 0;
+    size_t m_retained = 0;
+    size_t m_capacity = 0;
+    uint32_t m_accuracy;
+    uint64_t m_random = 0x9E3779B97F4A7C15ull;
+};
+
+/**
+ * @brief Mean, deviation, extremes and quantiles of the most recent values
+ *
+ * The window holds the last maxSize values no older than timeWindow. Every
+ * statistic is maintained as values enter and leave, in amortised O(1)
+ * per value:
+ *
+ * - mean and deviation from compensated sums of each value's distance to
+ *   a pivot near the mean, re-centred from the stored values once per
+ *   window turnover so cancellation cannot build up. A pivot taken from
+ *   the first value is re-centred as soon as that value leaves, so an
+ *   outlier there skews nothing once it is gone
+ * - min and max from monotonic queues, whose fronts are the extremes of
+ *   what is still in the window
+ * - quantiles from a QuantileSketch per 1/BLOCKS of the window; a block
+ *   is dropped once all its values have left, and the live ones merge on
+ *   query. A quantile therefore also counts the values already evicted
+ *   from the oldest live block, up to maxSize / BLOCKS of them.
+ *
+ * A zero timeWindow keeps values however old they are, and a zero
+ * sketchAccuracy skips the sketches for callers that need no quantiles.
+ * Non-finite values are ignored.
+ */
+class SlidingWindowStatistics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t BLOCKS = 8;
+
+    explicit SlidingWindowStatistics(size_t maxSize = 1000,
+                                     std::chrono::milliseconds timeWindow = std::chrono::milliseconds(60000),
+                                     uint32_t sketchAccuracy = QuantileSketch::DEFAULT_ACCURACY)
+        : m_maxSize(std::max<size_t>(maxSize, 1))
+        , m_timeWindow(timeWindow)
+        , m_sketchAccuracy(sketchAccuracy)
+        , m_blockSize((m_maxSize + BLOCKS - 1) / BLOCKS)
+        , m_blocks(sketchAccuracy > 0 ? BLOCKS + 1 : 0, Block(sketchAccuracy))
+    {
+    }
+
+    void add(double value, Clock::time_point timestamp = Clock::now()) {
+        if (!std::isfinite(value)) {
+            return;
+        }
+
+        if (m_size == m_maxSize) {
+            evictOldest();
+        }
+        if (m_timeWindow.count() > 0) {
+            expireBefore(timestamp - m_timeWindow);
+        }
+
+        // The ring grows to maxSize as values arrive; until it wraps, the
+        // next slot is always the end of the vector
+        const size_t index = (m_head + m_size) % m_maxSize;
+        if (index == m_values.size()) {
+            m_values.push_back(value);
+            m_timestamps.push_back(timestamp);
+        } else {
+            m_values[index] = value;
+            m_timestamps[index] = timestamp;
+        }
+        ++m_size;
+
+        const uint64_t sequence = m_nextSequence++;
+        if (m_size == 1) {
+            m_pivot = value;
+            m_pivotSequence = sequence;
+        }
+        const double distance = value - m_pivot;
+        m_sum.add(distance);
+        m_sumSquares.add(distance * distance);
+
+        while (!m_minQueue.empty() && m_minQueue.back().second >= value) {
+            m_minQueue.pop_back();
+        }
+        m_minQueue.emplace_back(sequence, value);
+        while (!m_maxQueue.empty() && m_maxQueue.back().second <= value) {
+            m_maxQueue.pop_back();
+        }
+        m_maxQueue.emplace_back(sequence, value);
+
+        if (m_blocks.empty()) {
+            return;
+        }
+        Block* block = &m_blocks[m_currentBlock];
+        if (block->count == m_blockSize) {
+            m_currentBlock = (m_currentBlock + 1) % m_blocks.size();
+            block = &m_blocks[m_currentBlock];
+            block->clear();
+        }
+        block->sketch.add(value);
+        block->lastSequence = sequence;
+        ++block->count;
+    }
+
+    /**
+     * @brief Drop values older than @p cutoff without adding one
+     */
+    void expireBefore(Clock::time_point cutoff) {
+        while (m_size > 0 && m_timestamps[m_head] < cutoff) {
+            evictOldest();
+        }
+    }
+
+    size_t size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+    size_t maxSize() const { return m_maxSize; }
+    std::chrono::milliseconds timeWindow() const { return m_timeWindow; }
+
+    double mean() const {
+        return m_size > 0 ? m_pivot + m_sum.value() / static_cast<double>(m_size) : 0.0;
+    }
+
+    /**
+     * @brief Population variance of the window
+     */
+    double variance() const {
+        if (m_size == 0) {
+            return 0.0;
+        }
+        const double n = static_cast<double>(m_size);
+        const double sum = m_sum.value();
+        return std::max(0.0, (m_sumSquares.value() - sum * sum / n) / n);
+    }
+
+    double standardDeviation() const { return std::sqrt(variance()); }
+
+    double min() const { return m_minQueue.empty() ? std::numeric_limits<double>::max() : m_minQueue.front().second; }
+    double max() const { return m_maxQueue.empty() ? std::numeric_limits<double>::lowest() : m_maxQueue.front().second; }
+
+    /**
+     * @brief Value at @p fraction (0 to 1) of the way through the window
+     * @return NaN if the window is empty or keeps no sketches
+     */
+    double quantile(double fraction) const {
+        double result = 0.0;
+        quantiles(&fraction, 1, &result);
+        return result;
+    }
+
+    /**
+     * @brief Several quantiles from a single merge of the live blocks
+     */
+    void quantiles(const double* fractions, size_t count, double* results) const {
+        std::vector<QuantileSketch::WeightedValue> values;
+        values.reserve(m_size + m_blockSize);
+        if (m_size > 0) {
+            for (const Block& block : m_blocks) {
+                if (block.count > 0 && block.lastSequence >= firstSequence()) {
+                    block.sketch.collect(values);
+                }
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            results[i] = QuantileSketch::quantileOf(values, fractions[i]);
+        }
+    }
+
+    /**
+     * @brief One sketch of every live block, to merge with other windows
+     */
+    QuantileSketch mergedSketch() const {
+        QuantileSketch merged(m_sketchAccuracy > 0 ? m_sketchAccuracy : QuantileSketch::DEFAULT_ACCURACY);
+        if (m_size > 0) {
+            for (const Block& block : m_blocks) {
+                if (block.count > 0 && block.lastSequence >= firstSequence()) {
+                    merged.merge(block.sketch);
+                }
+            }
+        }
+        return merged;
+    }
+
+    void clear() {
+        m_values.clear();
+        m_timestamps.clear();
+        m_head = 0;
+        m_size = 0;
+        m_evictionsSinceRebase = 0;
+        m_pivot = 0.0;
+        m_pivotSequence = NO_PIVOT_SEQUENCE;
+        m_sum.reset();
+        m_sumSquares.reset();
+        m_minQueue.clear();
+        m_maxQueue.clear();
+        for (Block& block : m_blocks) {
+            block.clear();
+        }
+        m_currentBlock = 0;
+    }
+
+private:
+    struct Block {
+        QuantileSketch sketch;
+        uint64_t lastSequence = 0;
+        size_t count = 0;
+
+        explicit Block(uint32_t accuracy) : sketch(accuracy) {}
+
+        void clear() {
+            sketch.clear();
+            lastSequence = 0;
+            count = 0;
+        }
+    };
+
+    static constexpr uint64_t NO_PIVOT_SEQUENCE = std::numeric_limits<uint64_t>::max();
+
+    uint64_t firstSequence() const { return m_nextSequence - m_size; }
+
+    void evictOldest() {
+        const uint64_t sequence = firstSequence();
+        const double distance = m_values[m_head] - m_pivot;
+        m_sum.add(-distance);
+        m_sumSquares.add(-distance * distance);
+        m_head = (m_head + 1) % m_maxSize;
+        --m_size;
+
+        if (!m_minQueue.empty() && m_minQueue.front().first == sequence) {
+            m_minQueue.pop_front();
+        }
+        if (!m_maxQueue.empty() && m_maxQueue.front().first == sequence) {
+            m_maxQueue.pop_front();
+        }
+
+        if (m_size == 0) {
+            m_sum.reset();
+            m_sumSquares.reset();
+            m_evictionsSinceRebase = 0;
+        } else if (++m_evictionsSinceRebase >= m_maxSize || sequence == m_pivotSequence) {
+            rebase();
+        }
+    }
+
+    /**
+     * @brief Re-centre the sums on the current mean, from the stored values
+     */
+    void rebase() {
+        m_pivot = mean();
+        m_sum.reset();
+        m_sumSquares.reset();
+        for (size_t i = 0; i < m_size; ++i) {
+            const double distance = m_values[(m_head + i) % m_maxSize] - m_pivot;
+            m_sum.add(distance);
+            m_sumSquares.add(distance * distance);
+        }
+        m_evictionsSinceRebase = 0;
+        m_pivotSequence = NO_PIVOT_SEQUENCE;
+    }
+
+    size_t m_maxSize;
+    std::chrono::milliseconds m_timeWindow;
+
+    // Ring of the values in the window, oldest at m_head
+    std::vector<double> m_values;
+    std::vector<Clock::time_point> m_timestamps;
+    size_t m_head = 0;
+    size_t m_size = 0;
+    uint64_t m_nextSequence = 0;    ///< Sequence number of the next value added
+
+    double m_pivot = 0.0;
+    uint64_t m_pivotSequence = NO_PIVOT_SEQUENCE;    ///< Of the value the pivot was taken from, if any
+    KahanSum m_sum;                 ///< Of value - pivot
+    KahanSum m_sumSquares;          ///< Of (value - pivot)^2
+    size_t m_evictionsSinceRebase = 0;
+
+    std::deque<std::pair<uint64_t, double>> m_minQueue;    ///< (sequence, value), values increasing
+    std::deque<std::pair<uint64_t, double>> m_maxQueue;    ///< (sequence, value), values decreasing
+
+    uint32_t m_sketchAccuracy;
+    size_t m_blockSize;
+    std::vector<Block> m_blocks;    ///< One more than BLOCKS, so a full window never reuses a live block
+    size_t m_currentBlock = 0;
+};
+
+} // namespace Packet
+} // namespace Monitor
@@ -0,0 +1,450 @@
+#pragma once
+
+#include "streaming_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Monitor {
+namespace Packet {
+
+/**
+ * @brief Compiled numeric transformation chain, run one value or one column at a time
+ *
+ * Built by appending steps. Consecutive add, subtract, multiply, divide
+ * and negate steps fold into one (x * scale + offset) / divisor step, so a
+ * unit conversion costs one multiply-add however it was spelled. run()
+ * applies each step to the whole column before the next, in tight loops
+ * without per-value dispatch that the stateless steps vectorise.
+ *
+ * Stateful steps keep their own state, so two moving averages in a chain
+ * do not share a history. Moving windows are maintained incrementally,
+ * so their cost does not grow with the window: the average from a ring of
+ * the last values and their compensated sum, the other windows by
+ * SlidingWindowStatistics, with monotonic queues for min and max. A NaN
+ * or infinite input to a stateful step comes out NaN and leaves its state
+ * as it was; stateless steps follow IEEE arithmetic.
+ *
+ * A kernel is a value: copy it to give another consumer a chain with
+ * independent state.
+ */
+class TransformKernel {
+public:
+    enum class Function : uint8_t {
+        Sqrt,
+        Log,
+        Log10,
+        Sin,
+        Cos,
+        Tan
+    };
+
+    TransformKernel& add(double value) {
+        Step& step = affineStep(std::isfinite(value));
+        step.b += value * step.c;
+        return *this;
+    }
+
+    TransformKernel& multiply(double factor) {
+        Step& step = affineStep(std::isfinite(factor));
+        step.a *= factor;
+        if (step.b != 0.0) {
+            step.b *= factor;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Divide by @p divisor; by zero gives NaN
+     */
+    TransformKernel& divide(double divisor) {
+        if (divisor == 0.0) {
+            return constant(std::numeric_limits<double>::quiet_NaN());
+        }
+        affineStep(std::isfinite(divisor)).c *= divisor;
+        return *this;
+    }
+
+    TransformKernel& negate() { return multiply(-1.0); }
+
+    /**
+     * @brief Remainder of division by @p divisor, as std::fmod; by zero gives NaN
+     */
+    TransformKernel& modulo(double divisor) { return push(Step(Kind::Modulo, divisor)); }
+    TransformKernel& power(double exponent) { return push(Step(Kind::Power, exponent)); }
+    TransformKernel& absolute() { return push(Step(Kind::Absolute)); }
+    TransformKernel& function(Function function) { return push(Step(kindOf(function))); }
+
+    /**
+     * @brief Limit to [@p min, @p max]; NaN becomes @p max
+     */
+    TransformKernel& clamp(double min, double max) { return push(Step(Kind::Clamp, min, max)); }
+
+    /**
+     * @brief Drop the fraction, as a conversion to an integer type does
+     */
+    TransformKernel& truncate() { return push(Step(Kind::Truncate)); }
+
+    /**
+     * @brief Round to the nearest float, as a conversion to float does
+     */
+    TransformKernel& roundToFloat() { return push(Step(Kind::RoundToFloat)); }
+
+    /**
+     * @brief 1 for any non-zero value, 0 for zero
+     */
+    TransformKernel& toBoolean() { return push(Step(Kind::ToBoolean)); }
+
+    /**
+     * @brief Value minus the previous one; 0 for the first
+     */
+    TransformKernel& difference() { return push(Step(Kind::Difference)); }
+
+    TransformKernel& cumulativeSum() { return push(Step(Kind::CumulativeSum)); }
+
+    /**
+     * @brief Mean of the last @p window values, this one included
+     */
+    TransformKernel& movingAverage(size_t window) {
+        Step step(Kind::MovingAverage);
+        step.window = m_sums.size();
+        m_sums.emplace_back(std::max<size_t>(window, 1));
+        return push(step);
+    }
+
+    TransformKernel& movingMinimum(size_t window) { return pushWindow(Kind::MovingMinimum, window); }
+    TransformKernel& movingMaximum(size_t window) { return pushWindow(Kind::MovingMaximum, window); }
+    TransformKernel& movingRange(size_t window) { return pushWindow(Kind::MovingRange, window); }
+
+    /**
+     * @brief Sample standard deviation of the last @p window values; NaN below two
+     */
+    TransformKernel& movingStandardDeviation(size_t window) { return pushWindow(Kind::MovingStandardDeviation, window); }
+
+    /**
+     * @brief Transform one value
+     */
+    double apply(double value) {
+        run(&value, &value, 1);
+        return value;
+    }
+
+    /**
+     * @brief Transform @p count values in order; @p output may be @p input
+     */
+    void run(const double* input, double* output, size_t count) {
+        if (input != output) {
+            std::copy(input, input + count, output);
+        }
+        for (Step& step : m_steps) {
+            runStep(step, output, count);
+        }
+    }
+
+    /**
+     * @brief Forget every value seen; the steps stay
+     */
+    void reset() {
+        for (Step& step : m_steps) {
+            step.previous = 0.0;
+            step.primed = false;
+            step.total.reset();
+        }
+        for (SlidingWindowStatistics& window : m_windows) {
+            window.clear();
+        }
+        for (MovingSum& sum : m_sums) {
+            sum.clear();
+        }
+    }
+
+    void clear() {
+        m_steps.clear();
+        m_windows.clear();
+        m_sums.clear();
+    }
+
+    size_t stepCount() const { return m_steps.size(); }
+    bool isEmpty() const { return m_steps.empty(); }
+
+private:
+    enum class Kind : uint8_t {
+        Affine,
+        Constant,
+        Modulo,
+        Power,
+        Absolute,
+        Sqrt,
+        Log,
+        Log10,
+        Sin,
+        Cos,
+        Tan,
+        Clamp,
+        Truncate,
+        RoundToFloat,
+        ToBoolean,
+        Difference,
+        CumulativeSum,
+        MovingAverage,
+        MovingMinimum,
+        MovingMaximum,
+        MovingRange,
+        MovingStandardDeviation
+    };
+
+    struct Step {
+        Kind kind;
+        double a = 0.0;         ///< Affine scale, or the step's parameter
+        double b = 0.0;         ///< Affine offset, or the clamp maximum
+        double c = 1.0;         ///< Affine divisor
+        size_t window = 0;      ///< Index into m_sums of a moving average, m_windows of other moving steps
+        double previous = 0.0;
+        bool primed = false;    ///< previous holds a value
+        KahanSum total;
+
+        explicit Step(Kind stepKind, double first = 0.0, double second = 0.0)
+            : kind(stepKind), a(first), b(second) {}
+    };
+
+    /**
+     * @brief Ring of a moving average's last values, and their sum
+     *
+     * Subtracting evicted values leaves rounding behind, so the sum is
+     * recomputed from the ring once per window of evictions: O(1) per value
+     * amortised, and no drift however long the stream.
+     */
+    class MovingSum {
+    public:
+        explicit MovingSum(size_t capacity) : m_capacity(capacity) {}
+
+        /**
+         * @brief Push @p value, evicting the oldest if full; returns the mean
+         */
+        double add(double value) {
+            if (m_values.size() < m_capacity) {
+                m_values.push_back(value);
+                m_sum.add(value);
+                return m_sum.value() / static_cast<double>(m_values.size());
+            }
+
+            const double evicted = m_values[m_head];
+            m_values[m_head] = value;
+            m_head = m_head + 1 == m_capacity ? 0 : m_head + 1;
+            if (++m_evictions == m_capacity) {
+                m_evictions = 0;
+                m_sum.reset();
+                for (double retained : m_values) {
+                    m_sum.add(retained);
+                }
+            } else {
+                m_sum.add(value);
+                m_sum.add(-evicted);
+            }
+            return m_sum.value() / static_cast<double>(m_capacity);
+        }
+
+        void clear() {
+            m_values.clear();
+            m_head = 0;
+            m_evictions = 0;
+            m_sum.reset();
+        }
+
+    private:
+        std::vector<double> m_values;
+        size_t m_capacity;
+        size_t m_head = 0;          ///< Oldest value, once full
+        size_t m_evictions = 0;     ///< Since the sum was last recomputed
+        KahanSum m_sum;
+    };
+
+    static Kind kindOf(Function function) {
+        switch (function) {
+            case Function::Sqrt:  return Kind::Sqrt;
+            case Function::Log:   return Kind::Log;
+            case Function::Log10: return Kind::Log10;
+            case Function::Sin:   return Kind::Sin;
+            case Function::Cos:   return Kind::Cos;
+            case Function::Tan:   return Kind::Tan;
+        }
+        return Kind::Sqrt;
+    }
+
+    TransformKernel& push(const Step& step) {
+        m_steps.push_back(step);
+        return *this;
+    }
+
+    TransformKernel& pushWindow(Kind kind, size_t window) {
+        Step step(kind);
+        step.window = m_windows.size();
+        m_windows.emplace_back(std::max<size_t>(window, 1), std::chrono::milliseconds(0), 0);
+        return push(step);
+    }
+
+    /**
+     * @brief A step whose output is @p value for every input
+     */
+    TransformKernel& constant(double value) {
+        return push(Step(Kind::Constant, value));
+    }
+
+    /**
+     * @brief The trailing affine step to fold into, appending an identity
+     *        one if there is none or @p fold is false
+     *
+     * A non-finite coefficient gets a step of its own: folded, it would
+     * meet the other coefficients in inf - inf or 0 * inf = NaN where
+     * applying the steps one by one does not.
+     */
+    Step& affineStep(bool fold = true) {
+        if (!fold || m_steps.empty() || m_steps.back().kind != Kind::Affine || !isFinite(m_steps.back())) {
+            m_steps.push_back(Step(Kind::Affine, 1.0, 0.0));
+        }
+        return m_steps.back();
+    }
+
+    static bool isFinite(const Step& step) {
+        return std::isfinite(step.a) && std::isfinite(step.b) && std::isfinite(step.c);
+    }
+
+    template<typename Operation>
+    static void each(double* values, size_t count, Operation operation) {
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = operation(values[i]);
+        }
+    }
+
+    void runStep(Step& step, double* values, size_t count) {
+        constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+        const double a = step.a;
+        const double b = step.b;
+
+        switch (step.kind) {
+            case Kind::Affine: {
+                const double c = step.c;
+                if (c == 1.0) {
+                    each(values, count, [=](double x) { return x * a + b; });
+                } else {
+                    each(values, count, [=](double x) { return (x * a + b) / c; });
+                }
+                break;
+            }
+            case Kind::Constant:
+                std::fill(values, values + count, a);
+                break;
+            case Kind::Modulo:
+                each(values, count, [=](double x) { return a != 0.0 ? std::fmod(x, a) : nan; });
+                break;
+            case Kind::Power:
+                each(values, count, [=](double x) { return std::pow(x, a); });
+                break;
+            case Kind::Absolute:
+                each(values, count, [](double x) { return std::fabs(x); });
+                break;
+            case Kind::Sqrt:
+                each(values, count, [](double x) { return std::sqrt(x); });
+                break;
+            case Kind::Log:
+                each(values, count, [](double x) { return std::log(x); });
+                break;
+            case Kind::Log10:
+                each(values, count, [](double x) { return std::log10(x); });
+                break;
+            case Kind::Sin:
+                each(values, count, [](double x) { return std::sin(x); });
+                break;
+            case Kind::Cos:
+                each(values, count, [](double x) { return std::cos(x); });
+                break;
+            case Kind::Tan:
+                each(values, count, [](double x) { return std::tan(x); });
+                break;
+            case Kind::Clamp:
+                each(values, count, [=](double x) { return std::max(a, std::min(b, x)); });
+                break;
+            case Kind::Truncate:
+                each(values, count, [](double x) { return std::trunc(x); });
+                break;
+            case Kind::RoundToFloat:
+                each(values, count, [](double x) { return static_cast<double>(static_cast<float>(x)); });
+                break;
+            case Kind::ToBoolean:
+                each(values, count, [](double x) { return x != 0.0 ? 1.0 : 0.0; });
+                break;
+            case Kind::Difference:
+                each(values, count, [&step](double x) {
+                    if (!std::isfinite(x)) {
+                        return nan;
+                    }
+                    const double difference = step.primed ? x - step.previous : 0.0;
+                    step.previous = x;
+                    step.primed = true;
+                    return difference;
+                });
+                break;
+            case Kind::CumulativeSum:
+                each(values, count, [&step](double x) {
+                    if (!std::isfinite(x)) {
+                        return nan;
+                    }
+                    step.total.add(x);
+                    return step.total.value();
+                });
+                break;
+            case Kind::MovingAverage: {
+                MovingSum& sum = m_sums[step.window];
+                each(values, count, [&sum](double x) { return std::isfinite(x) ? sum.add(x) : nan; });
+                break;
+            }
+            case Kind::MovingMinimum:
+            case Kind::MovingMaximum:
+            case Kind::MovingRange:
+            case Kind::MovingStandardDeviation:
+                runWindow(step.kind, m_windows[step.window], values, count);
+                break;
+        }
+    }
+
+    static void runWindow(Kind kind, SlidingWindowStatistics& window, double* values, size_t count) {
+        // Moving steps keep no age limit, so every value can share one timestamp
+        const SlidingWindowStatistics::Clock::time_point timestamp{};
+        for (size_t i = 0; i < count; ++i) {
+            if (!std::isfinite(values[i])) {
+                values[i] = std::numeric_limits<double>::quiet_NaN();
+                continue;
+            }
+            window.add(values[i], timestamp);
+
+            switch (kind) {
+                case Kind::MovingMinimum:
+                    values[i] = window.min();
+                    break;
+                case Kind::MovingMaximum:
+                    values[i] = window.max();
+                    break;
+                case Kind::MovingRange:
+                    values[i] = window.max() - window.min();
+                    break;
+                default: {
+                    const double n = static_cast<double>(window.size());
+                    values[i] = window.size() > 1 ? std::sqrt(window.variance() * n / (n - 1.0))
+                                                  : std::numeric_limits<double>::quiet_NaN();
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<Step> m_steps;
+    std::vector<SlidingWindowStatistics> m_windows;
+    std::vector<MovingSum> m_sums;
+};
+
+} // namespace Packet
+} // namespace Monitor
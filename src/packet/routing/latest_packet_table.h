@@ -0,0 +1,173 @@
+#pragma once
+
+#include "../core/packet.h"
+#include "../core/packet_type_registry.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace Monitor {
+namespace Packet {
+
+/**
+ * @brief Latest packet of each watched packet type, overwritten in place
+ *
+ * Display widgets that show current values need only the newest packet of
+ * an ID, once per frame. Router threads publish() every packet of a
+ * watched ID into that ID's slot, replacing the previous one, and widgets
+ * read the slot with latest() on their frame timer; nothing is queued, so
+ * the cost per packet is one atomic exchange however fast packets arrive
+ * and however slowly the widget reads them.
+ *
+ * Slots are lock-free for any number of writers and readers, and a read
+ * is one atomic add. A slot holds its packet with a bias of BIAS
+ * references and keeps, next to the packet pointer, how many of them
+ * readers have taken; each reader adopts one. Replacing the packet gives
+ * back the ones no reader took. A reader that finds most of the bias taken
+ * tops it up again.
+ */
+class LatestPacketTable {
+public:
+    using Slot = PacketTypeRegistry::Slot;
+
+    LatestPacketTable() = default;
+
+    ~LatestPacketTable() {
+        m_slots.forEach([](Slot, Entry& entry) {
+            dropPacket(entry.word.exchange(0, std::memory_order_acquire));
+        });
+    }
+
+    LatestPacketTable(const LatestPacketTable&) = delete;
+    LatestPacketTable& operator=(const LatestPacketTable&) = delete;
+
+    /**
+     * @brief Start keeping the latest packet of @p slot; watches nest
+     * @return False if @p slot is out of range
+     */
+    bool watch(Slot slot) {
+        Entry* entry = m_slots.obtain(slot);
+        if (!entry) {
+            return false;
+        }
+        entry->watchers.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Undo one watch(); the last one releases the slot's packet
+     */
+    void unwatch(Slot slot) {
+        Entry* entry = m_slots.find(slot);
+        if (entry && entry->watchers.fetch_sub(1, std::memory_order_relaxed) == 1) {
+            dropPacket(entry->word.exchange(0, std::memory_order_acq_rel));
+        }
+    }
+
+    bool isWatched(Slot slot) const {
+        const Entry* entry = m_slots.find(slot);
+        return entry && entry->watchers.load(std::memory_order_relaxed) > 0;
+    }
+
+    /**
+     * @brief Make @p packet the latest of @p slot if the slot is watched
+     */
+    void publish(Slot slot, const PacketPtr& packet) {
+        Entry* entry = m_slots.find(slot);
+        if (!entry || entry->watchers.load(std::memory_order_relaxed) == 0 || !packet) {
+            return;
+        }
+
+        packet.m_packet->m_refCount.fetch_add(BIAS, std::memory_order_relaxed);
+        const uint64_t previous = entry->word.exchange(
+            reinterpret_cast<uintptr_t>(packet.m_packet), std::memory_order_acq_rel);
+        entry->version.fetch_add(1, std::memory_order_release);
+        dropPacket(previous);
+    }
+
+    /**
+     * @brief Latest packet of @p slot, or an empty handle if none was published
+     * @param version Set to the slot's publish count, which changes with
+     *        every publish(); a reader skips work while it stays the same
+     */
+    PacketPtr latest(Slot slot, uint64_t* version = nullptr) const {
+        Entry* entry = m_slots.find(slot);
+        if (version) {
+            // Read before the packet, so the packet is at least this new
+            *version = entry ? entry->version.load(std::memory_order_acquire) : 0;
+        }
+        if (!entry || (entry->word.load(std::memory_order_acquire) & POINTER_MASK) == 0) {
+            return PacketPtr();
+        }
+
+        const uint64_t word = entry->word.fetch_add(READER, std::memory_order_acquire) + READER;
+        Packet* packet = pointerOf(word);
+        if (!packet) {
+            return PacketPtr();
+        }
+
+        // Adopt one of the slot's references
+        PacketPtr handle;
+        handle.m_packet = packet;
+
+        // Top the bias up before readers can exhaust it; a failed swap means
+        // the word changed and a later reader will try again
+        const uint64_t taken = word >> POINTER_BITS;
+        if (taken >= REFILL_THRESHOLD) {
+            packet->m_refCount.fetch_add(static_cast<uint32_t>(taken), std::memory_order_relaxed);
+            uint64_t expected = word;
+            if (!entry->word.compare_exchange_strong(expected, word & POINTER_MASK, std::memory_order_acq_rel,
+                                                     std::memory_order_relaxed)) {
+                // The handle keeps the packet alive, so this cannot free it
+                packet->m_refCount.fetch_sub(static_cast<uint32_t>(taken), std::memory_order_relaxed);
+            }
+        }
+        return handle;
+    }
+
+    /**
+     * @brief Publish count of @p slot, without taking its packet
+     */
+    uint64_t version(Slot slot) const {
+        const Entry* entry = m_slots.find(slot);
+        return entry ? entry->version.load(std::memory_order_acquire) : 0;
+    }
+
+private:
+    static_assert(sizeof(void*) == sizeof(uint64_t), "Slots pack a pointer into 48 bits of a 64-bit word");
+
+    static constexpr unsigned POINTER_BITS = 48;
+    static constexpr uint64_t POINTER_MASK = (uint64_t(1) << POINTER_BITS) - 1;
+    static constexpr uint64_t READER = uint64_t(1) << POINTER_BITS;
+    static constexpr uint32_t BIAS = 0xFFFF;                ///< References a slot holds its packet with
+    static constexpr uint64_t REFILL_THRESHOLD = 0x1000;    ///< Taken references that trigger a top-up
+
+    struct Entry {
+        std::atomic<uint64_t> word{0};          ///< Packet pointer and references readers took
+        std::atomic<uint64_t> version{0};
+        std::atomic<uint32_t> watchers{0};
+    };
+
+    static Packet* pointerOf(uint64_t word) noexcept {
+        return reinterpret_cast<Packet*>(static_cast<uintptr_t>(word & POINTER_MASK));
+    }
+
+    /**
+     * @brief Give back the references of a replaced packet that no reader took
+     */
+    static void dropPacket(uint64_t word) noexcept {
+        Packet* packet = pointerOf(word);
+        if (!packet) {
+            return;
+        }
+        const uint32_t unused = BIAS - static_cast<uint32_t>(word >> POINTER_BITS);
+        if (packet->m_refCount.fetch_sub(unused, std::memory_order_acq_rel) == unused) {
+            packet->destroy();
+        }
+    }
+
+    PacketSlotTable<Entry> m_slots;
+};
+
+} // namespace Packet
+} // namespace Monitor
@@ -35,12 +35,14 @@ public:
         PacketRouter::Configuration routerConfig;
         bool enableBackPressure;        ///< Enable back-pressure handling
         uint32_t backPressureThreshold; ///< Queue threshold for back-pressure
+        uint32_t creditWaitMs;          ///< How long a batching source waits for critical subscribers
         uint32_t maxSources;             ///< Maximum number of packet sources
         bool enableMetrics;             ///< Enable detailed metrics collection
         
         Configuration() 
             : enableBackPressure(true)
             , backPressureThreshold(8000)
+            , creditWaitMs(100)
             , maxSources(100)
             , enableMetrics(true)
         {}
@@ -54,6 +56,7 @@ public:
         std::atomic<uint64_t> totalPacketsProcessed{0};
         std::atomic<uint64_t> totalPacketsDropped{0};
         std::atomic<uint64_t> backPressureEvents{0};
+        std::atomic<uint64_t> creditStalls{0};          ///< Batches that had to wait for critical subscribers
         std::atomic<uint64_t> sourceCount{0};
         std::atomic<uint64_t> subscriberCount{0};
         
@@ -67,6 +70,7 @@ public:
             totalPacketsProcessed.store(other.totalPacketsProcessed.load());
             totalPacketsDropped.store(other.totalPacketsDropped.load());
             backPressureEvents.store(other.backPressureEvents.load());
+            creditStalls.store(other.creditStalls.load());
             sourceCount.store(other.sourceCount.load());
             subscriberCount.store(other.subscriberCount.load());
         }
@@ -78,6 +82,7 @@ public:
                 totalPacketsProcessed.store(other.totalPacketsProcessed.load());
                 totalPacketsDropped.store(other.totalPacketsDropped.load());
                 backPressureEvents.store(other.backPressureEvents.load());
+                creditStalls.store(other.creditStalls.load());
                 sourceCount.store(other.sourceCount.load());
                 subscriberCount.store(other.subscriberCount.load());
                 startTime = other.startTime;
@@ -173,6 +178,7 @@ public:
         if (m_router) {
             m_router->setThreadPool(threadPool);
         }
+        m_subscriptionManager->setThreadPool(threadPool);
     }
     
     /**
@@ -285,6 +291,11 @@ public:
         connect(source, &PacketSource::error,
                 this, &PacketDispatcher::onSourceError);
         
+        // Batching sources hand over whole batches from their receive thread
+        source->setPacketBatchCallback([this](std::vector<PacketPtr>& packets) {
+            dispatchBatch(packets);
+        });
+        
         m_stats.sourceCount++;
         
         m_logger->info("PacketDispatcher", 
@@ -322,6 +333,7 @@ public:
         if (registration.source) {
             registration.source->stop();
             registration.source->disconnect(this);
+            registration.source->setPacketBatchCallback(nullptr);
         }
         
         // Remove from containers (swap with last element for efficiency)
@@ -344,6 +356,55 @@ public:
         return true;
     }
     
+    /**
+     * @brief Route a batch of packets directly, bypassing the Qt event loop
+     * 
+     * Safe to call from a source's receive thread: routing goes through the
+     * router's multi-producer queues and statistics are atomic. Back-pressure
+     * is evaluated once per batch, and the router queues the batch in one call.
+     * 
+     * The calling thread first waits, up to creditWaitMs, for every critical
+     * subscriber's mailbox to have room for the batch. That holds the source
+     * back, leaving excess datagrams in the socket buffer, instead of the
+     * router blocking on the subscriber later; slow non-critical subscribers
+     * drop by their own policy and never hold it back.
+     */
+    void dispatchBatch(std::vector<PacketPtr>& packets) {
+        const uint64_t before = m_stats.totalPacketsReceived.fetch_add(packets.size());
+        
+        if (!m_subscriptionManager->hasCredit(packets.size())) {
+            m_stats.creditStalls++;
+            if (!m_subscriptionManager->waitForCredit(packets.size(), std::chrono::milliseconds(m_config.creditWaitMs))) {
+                m_logger->warning("PacketDispatcher", 
+                    QString("Critical subscribers behind, dropping batch of %1 packets").arg(packets.size()));
+                m_stats.totalPacketsDropped += packets.size();
+                m_stats.backPressureEvents++;
+                emit backPressureDetected("Critical subscriber behind");
+                return;
+            }
+        }
+        
+        if (m_config.enableBackPressure && checkBackPressure()) {
+            m_logger->warning("PacketDispatcher", 
+                QString("Back-pressure detected, dropping batch of %1 packets").arg(packets.size()));
+            m_stats.totalPacketsDropped += packets.size();
+            m_stats.backPressureEvents++;
+            emit backPressureDetected("Queue overflow");
+            return;
+        }
+        
+        // The router queues the whole batch at once; invalid packets count as dropped
+        const size_t batchSize = packets.size();
+        const size_t routed = m_router->routePacketsAuto(packets);
+        m_stats.totalPacketsProcessed += routed;
+        m_stats.totalPacketsDropped += batchSize - routed;
+        
+        // Emit statistics update periodically
+        if (before / 1000 != (before + batchSize) / 1000) {
+            emit statisticsUpdated(m_stats);
+        }
+    }
+    
     /**
      * @brief Subscribe to packet type
      */
@@ -358,6 +419,34 @@ public:
         return id;
     }
     
+    /**
+     * @brief Subscribe to packet type with a delivery policy, see SubscriptionManager::SubscriptionOptions
+     */
+    SubscriptionManager::SubscriberId subscribe(const std::string& subscriberName, 
+                                               PacketId packetId,
+                                               SubscriptionManager::PacketCallback callback,
+                                               const SubscriptionManager::SubscriptionOptions& options) {
+        auto id = m_subscriptionManager->subscribe(subscriberName, packetId, callback, options);
+        if (id != 0) {
+            m_stats.subscriberCount++;
+        }
+        return id;
+    }
+    
+    /**
+     * @brief Subscribe to packet type in batches with a delivery policy
+     */
+    SubscriptionManager::SubscriberId subscribeBatch(const std::string& subscriberName, 
+                                                    PacketId packetId,
+                                                    SubscriptionManager::PacketBatchCallback callback,
+                                                    const SubscriptionManager::SubscriptionOptions& options) {
+        auto id = m_subscriptionManager->subscribeBatch(subscriberName, packetId, callback, options);
+        if (id != 0) {
+            m_stats.subscriberCount++;
+        }
+        return id;
+    }
+    
     /**
      * @brief Unsubscribe from packets
      */
@@ -457,7 +546,7 @@ signals:
     /**
      * @brief Emitted when packet is processed
      */
-    void packetProcessed(PacketPtr packet);
+    void packetProcessed(const PacketPtr& packet);
     
     /**
      * @brief Emitted when back-pressure occurs
@@ -473,7 +562,7 @@ private slots:
     /**
      * @brief Handle packet from source
      */
-    void onPacketReceived(PacketPtr packet) {
+    void onPacketReceived(const PacketPtr& packet) {
         if (!packet || !packet->isValid()) {
             m_stats.totalPacketsDropped++;
             return;
@@ -481,6 +570,15 @@ private slots:
         
         m_stats.totalPacketsReceived++;
         
+        // The event loop cannot wait for credit, so a full critical mailbox drops here
+        if (!m_subscriptionManager->hasCredit(1)) {
+            m_stats.totalPacketsDropped++;
+            m_stats.creditStalls++;
+            m_stats.backPressureEvents++;
+            emit backPressureDetected("Critical subscriber behind");
+            return;
+        }
+        
         // Check back-pressure
         if (m_config.enableBackPressure) {
             if (checkBackPressure()) {
@@ -509,7 +607,7 @@ private slots:
     /**
      * @brief Handle packet routing completion
      */
-    void onPacketRouted(PacketPtr packet, PacketRouter::Priority priority) {
+    void onPacketRouted(const PacketPtr& packet, PacketRouter::Priority priority) {
         Q_UNUSED(priority);
         emit packetProcessed(packet);
     }
@@ -517,7 +615,7 @@ private slots:
     /**
      * @brief Handle packet drop
      */
-    void onPacketDropped(PacketPtr packet, const QString& reason) {
+    void onPacketDropped(const PacketPtr& packet, const QString& reason) {
         Q_UNUSED(packet);
         Q_UNUSED(reason);
         m_stats.totalPacketsDropped++;
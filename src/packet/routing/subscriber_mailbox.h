@@ -0,0 +1,211 @@
+#pragma once
+
+#include "../core/packet.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Monitor {
+namespace Packet {
+
+/**
+ * @brief Bounded queue of packets waiting for one subscriber
+ *
+ * Router threads push packets in; the subscriber's drain pops them out on
+ * its own thread. When the mailbox is full, the policy decides who loses:
+ *
+ * - Block: the pushing thread waits for room, so nothing is lost
+ * - DropOldest: the oldest queued packet makes room
+ * - DropNewest: the incoming packet is discarded
+ * - ConflateLatest: one slot per packet ID; a newer packet of a queued ID
+ *   replaces it in place, and the capacity bounds the distinct IDs queued
+ *
+ * The mailbox also tracks whether a drain is scheduled: push() reports the
+ * transition that needs one, and pop() clears it when it finds the mailbox
+ * empty, both under the mailbox lock, so exactly one drain runs at a time
+ * and none is missed.
+ */
+class SubscriberMailbox {
+public:
+    enum class Policy {
+        Block,
+        DropOldest,
+        DropNewest,
+        ConflateLatest
+    };
+
+    /**
+     * @brief Outcome of a push()
+     */
+    struct PushResult {
+        size_t consumed = 0;        ///< Leading packets taken, queued or dropped; fewer only under Block
+        size_t dropped = 0;         ///< Queued or incoming packets discarded for lack of room
+        size_t conflated = 0;       ///< Queued packets replaced by a newer one of their ID
+        bool needsDrain = false;    ///< A drain must be scheduled
+    };
+
+    SubscriberMailbox(Policy policy, size_t capacity)
+        : m_policy(policy)
+        , m_capacity(std::max<size_t>(capacity, 1))
+        , m_ring(m_capacity)
+    {
+    }
+
+    SubscriberMailbox(const SubscriberMailbox&) = delete;
+    SubscriberMailbox& operator=(const SubscriberMailbox&) = delete;
+
+    /**
+     * @brief Queue packets, applying the policy when full
+     * @param timeNs steady_clock ns the packets were handed over, for lag
+     */
+    PushResult push(const PacketPtr* packets, size_t count, uint64_t timeNs) {
+        PushResult result;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closed) {
+            result.consumed = count;
+            result.dropped = count;
+            return result;
+        }
+
+        for (; result.consumed < count; ++result.consumed) {
+            const PacketPtr& packet = packets[result.consumed];
+
+            if (m_policy == Policy::ConflateLatest) {
+                auto queued = m_conflated.find(packet->id());
+                if (queued != m_conflated.end()) {
+                    m_ring[queued->second % m_capacity].packet = packet;
+                    ++result.conflated;
+                    continue;
+                }
+            }
+
+            if (m_tail - m_head == m_capacity) {
+                if (m_policy == Policy::Block) {
+                    break;
+                }
+                ++result.dropped;
+                if (m_policy == Policy::DropOldest) {
+                    m_ring[m_head++ % m_capacity].packet = PacketPtr();
+                } else {
+                    continue;
+                }
+            }
+
+            if (m_policy == Policy::ConflateLatest) {
+                m_conflated.emplace(packet->id(), m_tail);
+            }
+            m_ring[m_tail % m_capacity] = Entry{packet, timeNs};
+            ++m_tail;
+        }
+
+        m_size.store(m_tail - m_head, std::memory_order_relaxed);
+        if (m_tail != m_head && !m_drainScheduled) {
+            m_drainScheduled = true;
+            result.needsDrain = true;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Take up to @p maxCount packets, oldest first
+     *
+     * Returns 0 and clears the drain flag once the mailbox is empty; the
+     * drain then stops.
+     *
+     * @param enqueuedNs Set to the hand-over time of the oldest packet taken
+     */
+    size_t pop(std::vector<PacketPtr>& packets, size_t maxCount, uint64_t& enqueuedNs) {
+        size_t taken = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_tail == m_head) {
+                m_drainScheduled = false;
+                return 0;
+            }
+
+            enqueuedNs = m_ring[m_head % m_capacity].enqueuedNs;
+            for (; taken < maxCount && m_head != m_tail; ++taken, ++m_head) {
+                Entry& entry = m_ring[m_head % m_capacity];
+                if (m_policy == Policy::ConflateLatest) {
+                    m_conflated.erase(entry.packet->id());
+                }
+                packets.push_back(std::move(entry.packet));
+            }
+            m_size.store(m_tail - m_head, std::memory_order_relaxed);
+        }
+
+        if (m_policy == Policy::Block) {
+            m_spaceAvailable.notify_all();
+        }
+        return taken;
+    }
+
+    /**
+     * @brief Wait until a Block mailbox has room or is closed
+     * @return False once closed
+     */
+    bool waitForSpace() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_spaceAvailable.wait(lock, [this]() { return m_closed || m_tail - m_head < m_capacity; });
+        return !m_closed;
+    }
+
+    /**
+     * @brief Refuse further packets, release queued ones and wake blocked pushers
+     */
+    void close() {
+        std::vector<Entry> released;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+            released.swap(m_ring);
+            m_head = m_tail = 0;
+            m_conflated.clear();
+            m_size.store(0, std::memory_order_relaxed);
+        }
+        m_spaceAvailable.notify_all();
+    }
+
+    Policy policy() const { return m_policy; }
+    size_t capacity() const { return m_capacity; }
+
+    /**
+     * @brief Packets queued; approximate while pushes and pops run
+     */
+    size_t size() const { return m_size.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Room for @p count more packets, or an empty mailbox for more than fit
+     */
+    bool hasCredit(size_t count) const {
+        return m_capacity - std::min(size(), m_capacity) >= std::min(count, m_capacity);
+    }
+
+private:
+    struct Entry {
+        PacketPtr packet;
+        uint64_t enqueuedNs = 0;
+    };
+
+    const Policy m_policy;
+    const size_t m_capacity;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_spaceAvailable;
+    std::vector<Entry> m_ring;
+    uint64_t m_head = 0;                                ///< Sequence number of the oldest entry
+    uint64_t m_tail = 0;                                ///< Sequence number of the next entry
+    std::unordered_map<PacketId, uint64_t> m_conflated; ///< Queued sequence per ID, ConflateLatest only
+    bool m_drainScheduled = false;
+    bool m_closed = false;
+
+    std::atomic<size_t> m_size{0};
+};
+
+} // namespace Packet
+} // namespace Monitor
@@ -1,16 +1,27 @@
 #pragma once
 
 #include "../core/packet.h"
+#include "../core/packet_type_registry.h"
 #include "../../logging/logger.h"
+#include "../../concurrent/rcu_pointer.h"
+#include "../../threading/thread_pool.h"
+#include "subscriber_mailbox.h"
+#include "latest_packet_table.h"
 
 #include <QtCore/QObject>
 #include <QString>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include <deque>
+#include <algorithm>
 #include <functional>
-#include <shared_mutex>
+#include <mutex>
+#include <thread>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
 
 namespace Monitor {
 namespace Packet {
@@ -22,6 +33,29 @@ namespace Packet {
  * enabling efficient multicast distribution of packets to interested
  * components. It uses thread-safe operations to support concurrent
  * access from multiple threads.
+ * 
+ * Delivery takes no lock: the subscriber lists are published as immutable
+ * snapshots through an RcuPointer, which subscribe() and unsubscribe()
+ * replace under a writer mutex. A slow callback therefore never blocks
+ * subscription changes, and router threads share no lock cache line.
+ * 
+ * Batch subscribers registered with subscribeBatch() take a PacketSpan per
+ * call. distributeBatch() hands them all packets of their ID in a batch at
+ * once, and wildcard batch subscribers the whole batch in arrival order, so
+ * a widget or recorder sees one call per batch instead of one per packet.
+ * 
+ * By default callbacks run on the distributing router thread, so a slow
+ * subscriber holds up every subscriber after it. A subscription with a
+ * mailbox policy (see SubscriptionOptions) instead has its packets queued
+ * in a bounded SubscriberMailbox and delivered by a drain on its own
+ * executor; a full mailbox then blocks, drops or conflates for that
+ * subscriber alone. Critical subscribers grant credits: waitForCredit()
+ * holds sources back while a critical mailbox is full, and no other
+ * subscriber can.
+ * 
+ * Widgets showing only current values need no subscription at all: after
+ * watchLatest() every distributed packet of the ID overwrites a single
+ * slot, and the widget reads latestPacket() once per frame.
  */
 class SubscriptionManager : public QObject {
     Q_OBJECT
@@ -33,26 +67,80 @@ public:
     using SubscriberId = uint64_t;
     
     /**
-     * @brief Packet delivery callback
+     * @brief Packet delivery callback; copy the handle to keep the packet
+     */
+    using PacketCallback = std::function<void(const PacketPtr& packet)>;
+    
+    /**
+     * @brief Batch delivery callback; the span is valid for the call only
+     */
+    using PacketBatchCallback = std::function<void(PacketSpan packets)>;
+    
+    /**
+     * @brief Packet ID that subscribes to every packet type
+     * 
+     * Wildcard subscribers receive each packet together with the subscribers
+     * of its own ID, interleaved by priority.
      */
-    using PacketCallback = std::function<void(PacketPtr packet)>;
+    static constexpr PacketId ALL_PACKETS = std::numeric_limits<PacketId>::max();
+    
+    /**
+     * @brief How packets reach a subscriber
+     */
+    enum class DeliveryPolicy {
+        Direct,             ///< Callback on the distributing thread, unbounded
+        Block,              ///< Mailbox; router threads wait while it is full
+        DropOldest,         ///< Mailbox; a full mailbox discards its oldest packet
+        DropNewest,         ///< Mailbox; a full mailbox discards the incoming packet
+        ConflateLatest      ///< Mailbox holding only the latest packet of each ID
+    };
+    
+    /**
+     * @brief Runs a mailbox drain on the subscriber's thread of choice
+     */
+    using DrainExecutor = std::function<void(std::function<void()> drain)>;
+    
+    /**
+     * @brief Delivery options of a subscription
+     */
+    struct SubscriptionOptions {
+        DeliveryPolicy policy = DeliveryPolicy::Direct;
+        size_t mailboxCapacity = 1024;  ///< Packets queued, or distinct IDs for ConflateLatest
+        size_t drainBatchSize = 256;    ///< Packets per drain call; the drain is rescheduled after each
+        bool critical = false;          ///< Hold sources back while the mailbox is full
+        DrainExecutor executor;         ///< Drain runner; unset uses the thread pool, or the distributing thread
+        uint32_t priority = 0;          ///< Delivery priority (lower = first, 0 = highest)
+    };
     
     /**
      * @brief Subscription information
      */
-    struct Subscription {
+    struct Subscription : std::enable_shared_from_this<Subscription> {
         SubscriberId id;
         std::string name;               ///< Human-readable subscriber name
         PacketId packetId;              ///< Subscribed packet ID
         PacketCallback callback;        ///< Delivery callback
+        PacketBatchCallback batchCallback;  ///< Batch delivery callback, used instead of callback when set
         uint32_t priority;              ///< Delivery priority (lower = first, 0 = highest)
-        bool enabled;                   ///< Enable/disable subscription
+        std::atomic<bool> enabled;      ///< Enable/disable subscription
         std::chrono::steady_clock::time_point createdAt;
         
         // Statistics
         std::atomic<uint64_t> packetsReceived{0};
         std::atomic<uint64_t> packetsDropped{0};
-        std::atomic<uint64_t> lastDeliveryTime{0};
+        std::atomic<uint64_t> lastDeliveryTime{0};  ///< steady_clock ns when the last delivered packet was distributed
+        
+        std::atomic<uint32_t> activeCalls{0};       ///< Callbacks in progress, awaited by unsubscribe()
+        
+        // Mailbox delivery, set for every policy but Direct
+        std::unique_ptr<SubscriberMailbox> mailbox;
+        DrainExecutor executor;
+        size_t drainBatchSize = 256;
+        bool critical = false;
+        std::atomic<uint64_t> packetsConflated{0};  ///< Replaced by a newer packet of their ID, also counted as dropped
+        std::atomic<uint64_t> lagNs{0};             ///< Wait in the mailbox of the oldest packet of the last drain
+        std::atomic<uint64_t> maxLagNs{0};
+        std::atomic<uint64_t> blockedPushes{0};     ///< Times a router thread waited for room
         
         Subscription(SubscriberId subId, const std::string& subName, 
                     PacketId pktId, PacketCallback cb, uint32_t prio = 0)
@@ -60,6 +148,32 @@ public:
               priority(prio), enabled(true), createdAt(std::chrono::steady_clock::now())
         {
         }
+        
+        Subscription(SubscriberId subId, const std::string& subName, 
+                    PacketId pktId, PacketBatchCallback cb, uint32_t prio = 0)
+            : id(subId), name(subName), packetId(pktId), batchCallback(cb), 
+              priority(prio), enabled(true), createdAt(std::chrono::steady_clock::now())
+        {
+        }
+    };
+    
+    /**
+     * @brief Point-in-time view of one subscriber, for dashboards
+     */
+    struct SubscriberStatistics {
+        SubscriberId id = 0;
+        std::string name;
+        PacketId packetId = 0;
+        DeliveryPolicy policy = DeliveryPolicy::Direct;
+        bool critical = false;
+        size_t queueDepth = 0;          ///< Packets waiting in the mailbox
+        size_t mailboxCapacity = 0;     ///< 0 for Direct delivery
+        uint64_t packetsReceived = 0;
+        uint64_t packetsDropped = 0;
+        uint64_t packetsConflated = 0;
+        uint64_t lagNs = 0;
+        uint64_t maxLagNs = 0;
+        uint64_t blockedPushes = 0;
     };
     
     /**
@@ -71,6 +185,7 @@ public:
         std::atomic<uint64_t> packetsDistributed{0};
         std::atomic<uint64_t> deliveryFailures{0};
         std::atomic<uint64_t> averageDeliveryTimeNs{0};
+        std::atomic<uint64_t> mailboxDrops{0};      ///< Packets a mailbox policy dropped or conflated
         
         std::unordered_map<PacketId, uint64_t> subscriptionsPerPacketType;
         std::chrono::steady_clock::time_point startTime;
@@ -92,27 +207,74 @@ public:
     };
 
 private:
-    // Thread-safe containers
+    using SubscriberList = std::vector<std::shared_ptr<Subscription>>;
+    
+    /**
+     * @brief Immutable view of the subscriber lists read by distributePacket()
+     * 
+     * Lists are shared between snapshots, so a change only copies the list of
+     * the packet ID it affects.
+     */
+    struct SubscriberSnapshot {
+        std::vector<std::shared_ptr<const SubscriberList>> lists;  ///< Indexed by packet type slot
+        std::shared_ptr<const SubscriberList> wildcards;            ///< ALL_PACKETS subscribers
+        std::shared_ptr<const SubscriberList> critical;             ///< Critical mailbox subscribers, any ID
+    };
+    
+    // Master tables, guarded by m_subscriptionMutex
     std::unordered_map<SubscriberId, std::shared_ptr<Subscription>> m_subscriptions;
-    std::unordered_map<PacketId, std::vector<std::shared_ptr<Subscription>>> m_packetSubscriptions;
-    mutable std::shared_mutex m_subscriptionMutex;
+    std::unordered_map<PacketId, SubscriberList> m_packetSubscriptions;
+    mutable std::mutex m_subscriptionMutex;
+    
+    // Published copy of m_packetSubscriptions, replaced under m_subscriptionMutex
+    Concurrent::RcuPointer<SubscriberSnapshot> m_snapshot;
     
     // Statistics
     Statistics m_stats;
     
     // Utilities
     Logging::Logger* m_logger;
+    PacketTypeRegistry* m_registry;
     std::atomic<SubscriberId> m_nextSubscriberId{1};
+    
+    // Mailbox drains without their own executor run here
+    std::atomic<Threading::ThreadPool*> m_threadPool{nullptr};
+    
+    // Signalled as critical mailboxes drain, for waitForCredit()
+    std::mutex m_creditMutex;
+    std::condition_variable m_creditAvailable;
+    
+    // Latest packet of each watched ID, indexed by packet type slot
+    LatestPacketTable m_latestPackets;
 
 public:
     explicit SubscriptionManager(QObject* parent = nullptr)
         : QObject(parent)
         , m_logger(Logging::Logger::instance())
+        , m_registry(PacketTypeRegistry::instance())
     {
     }
     
+    ~SubscriptionManager() {
+        // Scheduled drains outlive the manager's callers; stop them and wait for running ones
+        std::vector<std::shared_ptr<Subscription>> subscriptions;
+        {
+            std::lock_guard lock(m_subscriptionMutex);
+            for (const auto& pair : m_subscriptions) {
+                pair.second->enabled = false;
+                if (pair.second->mailbox) {
+                    pair.second->mailbox->close();
+                }
+                subscriptions.push_back(pair.second);
+            }
+        }
+        for (const auto& subscription : subscriptions) {
+            waitForDeliveries(*subscription);
+        }
+    }
+    
     /**
-     * @brief Subscribe to packets of specific type
+     * @brief Subscribe to packets of specific type, or to all with ALL_PACKETS
      */
     SubscriberId subscribe(const std::string& subscriberName, PacketId packetId, 
                           PacketCallback callback, uint32_t priority = 0) {
@@ -122,42 +284,222 @@ public:
             return 0;
         }
         
-        SubscriberId id = m_nextSubscriberId++;
-        auto subscription = std::make_shared<Subscription>(id, subscriberName, packetId, callback, priority);
+        if (packetId != ALL_PACKETS && m_registry->registerPacketId(packetId) == PacketTypeRegistry::INVALID_SLOT) {
+            m_logger->error("SubscriptionManager", 
+                QString("No packet type slot left for packet ID %1").arg(packetId));
+            return 0;
+        }
         
-        {
-            std::unique_lock lock(m_subscriptionMutex);
-            
-            // Add to main subscription map
-            m_subscriptions[id] = subscription;
-            
-            // Add to packet-specific map
-            auto& packetSubs = m_packetSubscriptions[packetId];
-            packetSubs.push_back(subscription);
-            
-            // Sort by priority (lower value = higher priority, 0 = highest)
-            std::sort(packetSubs.begin(), packetSubs.end(),
-                [](const std::shared_ptr<Subscription>& a, const std::shared_ptr<Subscription>& b) {
-                    return a->priority < b->priority;
-                });
-            
-            // Update statistics
-            m_stats.totalSubscriptions++;
-            m_stats.activeSubscriptions++;
-            m_stats.subscriptionsPerPacketType[packetId]++;
+        return addSubscription(std::make_shared<Subscription>(
+            m_nextSubscriberId++, subscriberName, packetId, callback, priority));
+    }
+    
+    /**
+     * @brief Subscribe with explicit delivery options
+     */
+    SubscriberId subscribe(const std::string& subscriberName, PacketId packetId, 
+                          PacketCallback callback, const SubscriptionOptions& options) {
+        if (!callback) {
+            m_logger->error("SubscriptionManager", 
+                QString("Null callback for subscriber %1").arg(QString::fromStdString(subscriberName)));
+            return 0;
         }
         
-        m_logger->info("SubscriptionManager", 
-            QString("Subscriber '%1' registered for packet ID %2 (priority %3)")
-            .arg(QString::fromStdString(subscriberName)).arg(packetId).arg(priority));
+        if (packetId != ALL_PACKETS && m_registry->registerPacketId(packetId) == PacketTypeRegistry::INVALID_SLOT) {
+            m_logger->error("SubscriptionManager", 
+                QString("No packet type slot left for packet ID %1").arg(packetId));
+            return 0;
+        }
         
-        emit subscriptionAdded(id, QString::fromStdString(subscriberName), packetId);
+        auto subscription = std::make_shared<Subscription>(
+            m_nextSubscriberId++, subscriberName, packetId, callback, options.priority);
+        applyOptions(*subscription, options);
+        return addSubscription(std::move(subscription));
+    }
+    
+    /**
+     * @brief Subscribe with a callback that takes packets in batches
+     * 
+     * distributeBatch() calls @p callback once per batch with the batch's
+     * packets of @p packetId, or with the whole batch in arrival order for ALL_PACKETS.
+     * distributePacket() calls it with a single packet.
+     */
+    SubscriberId subscribeBatch(const std::string& subscriberName, PacketId packetId, 
+                               PacketBatchCallback callback, uint32_t priority = 0) {
+        if (!callback) {
+            m_logger->error("SubscriptionManager", 
+                QString("Null batch callback for subscriber %1").arg(QString::fromStdString(subscriberName)));
+            return 0;
+        }
         
-        return id;
+        if (packetId != ALL_PACKETS && m_registry->registerPacketId(packetId) == PacketTypeRegistry::INVALID_SLOT) {
+            m_logger->error("SubscriptionManager", 
+                QString("No packet type slot left for packet ID %1").arg(packetId));
+            return 0;
+        }
+        
+        return addSubscription(std::make_shared<Subscription>(
+            m_nextSubscriberId++, subscriberName, packetId, callback, priority));
+    }
+    
+    /**
+     * @brief Batch subscription with explicit delivery options
+     * 
+     * A mailbox drain hands the callback up to drainBatchSize packets per
+     * call, of any ID the subscription matches.
+     */
+    SubscriberId subscribeBatch(const std::string& subscriberName, PacketId packetId, 
+                               PacketBatchCallback callback, const SubscriptionOptions& options) {
+        if (!callback) {
+            m_logger->error("SubscriptionManager", 
+                QString("Null batch callback for subscriber %1").arg(QString::fromStdString(subscriberName)));
+            return 0;
+        }
+        
+        if (packetId != ALL_PACKETS && m_registry->registerPacketId(packetId) == PacketTypeRegistry::INVALID_SLOT) {
+            m_logger->error("SubscriptionManager", 
+                QString("No packet type slot left for packet ID %1").arg(packetId));
+            return 0;
+        }
+        
+        auto subscription = std::make_shared<Subscription>(
+            m_nextSubscriberId++, subscriberName, packetId, callback, options.priority);
+        applyOptions(*subscription, options);
+        return addSubscription(std::move(subscription));
+    }
+    
+    /**
+     * @brief Thread pool that runs mailbox drains of subscriptions without an executor
+     * 
+     * Without one, such drains run on the distributing thread right after
+     * the packets are queued.
+     */
+    void setThreadPool(Threading::ThreadPool* threadPool) {
+        m_threadPool.store(threadPool);
+    }
+    
+    /**
+     * @brief Wait until every critical mailbox has room for @p count packets
+     * 
+     * Sources call this before handing over a batch, so they are held back
+     * by critical subscribers and by no one else.
+     * 
+     * @return False if a critical mailbox was still short of room after @p timeout
+     */
+    bool waitForCredit(size_t count, std::chrono::milliseconds timeout = std::chrono::milliseconds(0)) {
+        if (hasCredit(count)) {
+            return true;
+        }
+        if (timeout.count() <= 0) {
+            return false;
+        }
+        
+        // Drains notify after each batch; the short slices bound a missed notification
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(m_creditMutex);
+        while (!hasCredit(count)) {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                return false;
+            }
+            m_creditAvailable.wait_for(lock, std::min<std::chrono::steady_clock::duration>(
+                deadline - now, std::chrono::milliseconds(1)));
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Whether every critical mailbox has room for @p count packets now
+     */
+    bool hasCredit(size_t count) const {
+        Concurrent::EpochDomain::ReadGuard guard;
+        const SubscriberSnapshot* snapshot = m_snapshot.load();
+        if (!snapshot->critical) {
+            return true;
+        }
+        for (const auto& subscription : *snapshot->critical) {
+            if (subscription->enabled.load(std::memory_order_relaxed) && !subscription->mailbox->hasCredit(count)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Keep the latest packet of @p packetId for latestPacket(); watches nest
+     * 
+     * Costs distribution one atomic exchange per packet of the ID, whatever
+     * the rate, instead of a delivery.
+     */
+    bool watchLatest(PacketId packetId) {
+        if (packetId == ALL_PACKETS || !m_latestPackets.watch(m_registry->registerPacketId(packetId))) {
+            m_logger->error("SubscriptionManager", 
+                QString("Cannot keep latest packets of packet ID %1").arg(packetId));
+            return false;
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Undo one watchLatest(); the last one releases the kept packet
+     */
+    void unwatchLatest(PacketId packetId) {
+        m_latestPackets.unwatch(m_registry->findSlot(packetId));
+    }
+    
+    /**
+     * @brief Latest distributed packet of a watched ID; lock-free, any thread
+     * @param version Set to a count that changes whenever the packet does
+     */
+    PacketPtr latestPacket(PacketId packetId, uint64_t* version = nullptr) const {
+        return m_latestPackets.latest(m_registry->findSlot(packetId), version);
+    }
+    
+    /**
+     * @brief Count that changes whenever latestPacket() of @p packetId does
+     */
+    uint64_t latestVersion(PacketId packetId) const {
+        return m_latestPackets.version(m_registry->findSlot(packetId));
+    }
+    
+    /**
+     * @brief Wait until a mailbox subscriber has been handed every queued packet
+     * 
+     * unsubscribe() discards what is still queued; a subscriber that must
+     * see every packet flushes first. Returns at once for Direct delivery.
+     * 
+     * @return False if packets were still queued after @p timeout
+     */
+    bool flush(SubscriberId id, std::chrono::milliseconds timeout) {
+        std::shared_ptr<Subscription> subscription;
+        {
+            std::lock_guard lock(m_subscriptionMutex);
+            auto it = m_subscriptions.find(id);
+            if (it == m_subscriptions.end()) {
+                return false;
+            }
+            subscription = it->second;
+        }
+        if (!subscription->mailbox) {
+            return true;
+        }
+        
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (subscription->mailbox->size() > 0) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
     }
     
     /**
      * @brief Unsubscribe from packets
+     * 
+     * Returns once no callback of the subscription is running, so its captured
+     * state may be destroyed. Called from a delivery callback it does not wait,
+     * as the caller may be that very delivery.
      */
     bool unsubscribe(SubscriberId id) {
         std::unique_lock lock(m_subscriptionMutex);
@@ -171,6 +513,10 @@ public:
         
         auto subscription = it->second;
         PacketId packetId = subscription->packetId;
+        subscription->enabled = false;
+        if (subscription->mailbox) {
+            subscription->mailbox->close();
+        }
         
         // Remove from main map
         m_subscriptions.erase(it);
@@ -187,10 +533,14 @@ public:
         if (packetSubs.empty()) {
             m_packetSubscriptions.erase(packetId);
         }
+        publishSubscribers(packetId);
         
         // Update statistics
         m_stats.activeSubscriptions--;
         m_stats.subscriptionsPerPacketType[packetId]--;
+        lock.unlock();
+        
+        waitForDeliveries(*subscription);
         
         m_logger->info("SubscriptionManager", 
             QString("Subscriber '%1' unsubscribed from packet ID %2")
@@ -205,7 +555,7 @@ public:
      * @brief Enable/disable subscription
      */
     bool enableSubscription(SubscriberId id, bool enabled) {
-        std::shared_lock lock(m_subscriptionMutex);
+        std::lock_guard lock(m_subscriptionMutex);
         
         auto it = m_subscriptions.find(id);
         if (it == m_subscriptions.end()) {
@@ -222,60 +572,56 @@ public:
     
     /**
      * @brief Distribute packet to all subscribers
+     * 
+     * Lock-free; safe to call from any number of threads, and callbacks may
+     * subscribe and unsubscribe.
      */
-    size_t distributePacket(PacketPtr packet) {
+    size_t distributePacket(const PacketPtr& packet) {
         if (!packet || !packet->isValid()) {
             m_stats.deliveryFailures++;
             return 0;
         }
         
         PacketId packetId = packet->id();
-        auto startTime = std::chrono::high_resolution_clock::now();
         
-        std::shared_lock lock(m_subscriptionMutex);
+        Concurrent::EpochDomain::ReadGuard guard;
+        const SubscriberSnapshot* snapshot = m_snapshot.load();
         
-        auto it = m_packetSubscriptions.find(packetId);
-        if (it == m_packetSubscriptions.end()) {
+        const PacketTypeRegistry::Slot slot = m_registry->findSlot(packetId);
+        m_latestPackets.publish(slot, packet);
+        
+        const SubscriberList* subscribersPtr = (slot < snapshot->lists.size()) ? snapshot->lists[slot].get() : nullptr;
+        const SubscriberList* wildcardsPtr = (packetId != ALL_PACKETS) ? snapshot->wildcards.get() : nullptr;
+        if (!subscribersPtr && !wildcardsPtr) {
             // No subscribers for this packet type
             return 0;
         }
         
-        const auto& subscribers = it->second;
+        static const SubscriberList noSubscribers;
+        const auto& subscribers = subscribersPtr ? *subscribersPtr : noSubscribers;
+        const auto& wildcards = wildcardsPtr ? *wildcardsPtr : noSubscribers;
         size_t deliveredCount = 0;
         
-        for (const auto& subscription : subscribers) {
-            if (!subscription->enabled) {
-                continue;
-            }
-            
-            try {
-                subscription->callback(packet);
-                subscription->packetsReceived++;
-                deliveredCount++;
-                
-                auto now = std::chrono::high_resolution_clock::now();
-                auto deliveryTime = std::chrono::duration_cast<std::chrono::nanoseconds>(now - startTime).count();
-                subscription->lastDeliveryTime = static_cast<uint64_t>(deliveryTime);
-                
-            } catch (const std::exception& e) {
-                m_logger->error("SubscriptionManager", 
-                    QString("Exception in subscriber '%1': %2")
-                    .arg(QString::fromStdString(subscription->name)).arg(QString::fromStdString(e.what())));
-                subscription->packetsDropped++;
-                m_stats.deliveryFailures++;
-            } catch (...) {
-                m_logger->error("SubscriptionManager", 
-                    QString("Unknown exception in subscriber '%1'")
-                    .arg(QString::fromStdString(subscription->name)));
-                subscription->packetsDropped++;
-                m_stats.deliveryFailures++;
-            }
+        auto startTime = std::chrono::steady_clock::now();
+        const uint64_t startTimeNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(startTime.time_since_epoch()).count());
+        ++deliveryDepth();
+        
+        // Merge the two priority-sorted lists; ties go to the packet's own subscribers
+        size_t next = 0;
+        size_t nextWildcard = 0;
+        while (next < subscribers.size() || nextWildcard < wildcards.size()) {
+            const bool takeWildcard = next == subscribers.size() ||
+                (nextWildcard < wildcards.size() && wildcards[nextWildcard]->priority < subscribers[next]->priority);
+            Subscription& subscription = takeWildcard ? *wildcards[nextWildcard++] : *subscribers[next++];
+            deliveredCount += deliver(subscription, &packet, 1, startTimeNs);
         }
+        --deliveryDepth();
         
         // Update global statistics
         m_stats.packetsDistributed++;
         
-        auto endTime = std::chrono::high_resolution_clock::now();
+        auto endTime = std::chrono::steady_clock::now();
         auto totalDeliveryTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
         
         // Update average delivery time
@@ -292,11 +638,110 @@ public:
         return deliveredCount;
     }
     
+    /**
+     * @brief Distribute a batch of packets, one call per subscriber and packet ID
+     * 
+     * Drops invalid packets from @p packets, keeping the others in arrival
+     * order, and groups them by ID in a per-thread copy. Each subscriber of
+     * an ID then receives that ID's packets back to back, in arrival order: a
+     * batch subscriber in one call, others one call per packet. Wildcard
+     * batch subscribers receive the whole batch, in arrival order, in one
+     * call after the per-ID deliveries. Lock-free like distributePacket().
+     * 
+     * @return Number of packet deliveries made
+     */
+    size_t distributeBatch(std::vector<PacketPtr>& packets) {
+        dropInvalid(packets);
+        if (packets.empty()) {
+            return 0;
+        }
+        
+        // Callbacks may distribute again on this thread, so each depth has its own copy
+        thread_local std::deque<std::vector<PacketPtr>> groupedByDepth;
+        while (groupedByDepth.size() <= deliveryDepth()) {
+            groupedByDepth.emplace_back();
+        }
+        std::vector<PacketPtr>& scratch = groupedByDepth[deliveryDepth()];
+        const std::vector<PacketPtr>& grouped = groupByPacketId(packets, scratch);
+        
+        Concurrent::EpochDomain::ReadGuard guard;
+        const SubscriberSnapshot* snapshot = m_snapshot.load();
+        
+        static const SubscriberList noSubscribers;
+        const auto& wildcards = snapshot->wildcards ? *snapshot->wildcards : noSubscribers;
+        size_t deliveredCount = 0;
+        
+        auto startTime = std::chrono::steady_clock::now();
+        const uint64_t startTimeNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(startTime.time_since_epoch()).count());
+        ++deliveryDepth();
+        
+        for (size_t begin = 0; begin < grouped.size();) {
+            const PacketId packetId = grouped[begin]->id();
+            size_t end = begin + 1;
+            while (end < grouped.size() && grouped[end]->id() == packetId) {
+                ++end;
+            }
+            
+            const PacketTypeRegistry::Slot slot = m_registry->findSlot(packetId);
+            m_latestPackets.publish(slot, grouped[end - 1]);
+            
+            const SubscriberList* subscribersPtr = (slot < snapshot->lists.size()) ? snapshot->lists[slot].get() : nullptr;
+            const auto& subscribers = subscribersPtr ? *subscribersPtr : noSubscribers;
+            const auto& idWildcards = (packetId != ALL_PACKETS) ? wildcards : noSubscribers;
+            
+            // Same priority merge as distributePacket(); wildcard batch subscribers come last
+            size_t next = 0;
+            size_t nextWildcard = 0;
+            for (;;) {
+                while (nextWildcard < idWildcards.size() && idWildcards[nextWildcard]->batchCallback) {
+                    ++nextWildcard;
+                }
+                if (next == subscribers.size() && nextWildcard == idWildcards.size()) {
+                    break;
+                }
+                const bool takeWildcard = next == subscribers.size() ||
+                    (nextWildcard < idWildcards.size() && idWildcards[nextWildcard]->priority < subscribers[next]->priority);
+                Subscription& subscription = takeWildcard ? *idWildcards[nextWildcard++] : *subscribers[next++];
+                deliveredCount += deliver(subscription, &grouped[begin], end - begin, startTimeNs);
+            }
+            
+            begin = end;
+        }
+        scratch.clear();
+        
+        for (const auto& subscription : wildcards) {
+            if (subscription->batchCallback) {
+                deliveredCount += deliver(*subscription, packets.data(), packets.size(), startTimeNs);
+            }
+        }
+        --deliveryDepth();
+        
+        // Update global statistics once for the batch
+        m_stats.packetsDistributed += packets.size();
+        
+        auto endTime = std::chrono::steady_clock::now();
+        auto totalDeliveryTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+        
+        // Update average delivery time per packet
+        uint64_t currentAvg = m_stats.averageDeliveryTimeNs.load();
+        uint64_t newAvg = (currentAvg + static_cast<uint64_t>(totalDeliveryTime) / packets.size()) / 2;
+        m_stats.averageDeliveryTimeNs.store(newAvg);
+        
+        if (deliveredCount > 0) {
+            m_logger->debug("SubscriptionManager", 
+                QString("Distributed batch of %1 packets as %2 deliveries in %3 ns")
+                .arg(packets.size()).arg(deliveredCount).arg(totalDeliveryTime));
+        }
+        
+        return deliveredCount;
+    }
+    
     /**
      * @brief Get subscription information
      */
     std::shared_ptr<Subscription> getSubscription(SubscriberId id) const {
-        std::shared_lock lock(m_subscriptionMutex);
+        std::lock_guard lock(m_subscriptionMutex);
         auto it = m_subscriptions.find(id);
         return (it != m_subscriptions.end()) ? it->second : nullptr;
     }
@@ -305,7 +750,7 @@ public:
      * @brief Get all subscribers for packet type
      */
     std::vector<std::shared_ptr<Subscription>> getSubscribersForPacket(PacketId packetId) const {
-        std::shared_lock lock(m_subscriptionMutex);
+        std::lock_guard lock(m_subscriptionMutex);
         auto it = m_packetSubscriptions.find(packetId);
         return (it != m_packetSubscriptions.end()) ? it->second : std::vector<std::shared_ptr<Subscription>>();
     }
@@ -314,7 +759,7 @@ public:
      * @brief Get all active subscriptions
      */
     std::vector<std::shared_ptr<Subscription>> getAllSubscriptions() const {
-        std::shared_lock lock(m_subscriptionMutex);
+        std::lock_guard lock(m_subscriptionMutex);
         std::vector<std::shared_ptr<Subscription>> result;
         result.reserve(m_subscriptions.size());
         
@@ -329,7 +774,7 @@ public:
      * @brief Get subscription count for packet type
      */
     size_t getSubscriberCount(PacketId packetId) const {
-        std::shared_lock lock(m_subscriptionMutex);
+        std::lock_guard lock(m_subscriptionMutex);
         auto it = m_packetSubscriptions.find(packetId);
         return (it != m_packetSubscriptions.end()) ? it->second.size() : 0;
     }
@@ -338,10 +783,54 @@ public:
      * @brief Get total subscription count
      */
     size_t getTotalSubscriberCount() const {
-        std::shared_lock lock(m_subscriptionMutex);
+        std::lock_guard lock(m_subscriptionMutex);
         return m_subscriptions.size();
     }
     
+    /**
+     * @brief Delivery, drop and lag figures of every subscriber
+     */
+    std::vector<SubscriberStatistics> getSubscriberStatistics() const {
+        std::vector<SubscriberStatistics> result;
+        for (const auto& subscription : getAllSubscriptions()) {
+            SubscriberStatistics stats;
+            stats.id = subscription->id;
+            stats.name = subscription->name;
+            stats.packetId = subscription->packetId;
+            stats.critical = subscription->critical;
+            if (subscription->mailbox) {
+                stats.policy = policyOf(*subscription->mailbox);
+                stats.queueDepth = subscription->mailbox->size();
+                stats.mailboxCapacity = subscription->mailbox->capacity();
+            }
+            stats.packetsReceived = subscription->packetsReceived.load(std::memory_order_relaxed);
+            stats.packetsDropped = subscription->packetsDropped.load(std::memory_order_relaxed);
+            stats.packetsConflated = subscription->packetsConflated.load(std::memory_order_relaxed);
+            stats.lagNs = subscription->lagNs.load(std::memory_order_relaxed);
+            stats.maxLagNs = subscription->maxLagNs.load(std::memory_order_relaxed);
+            stats.blockedPushes = subscription->blockedPushes.load(std::memory_order_relaxed);
+            result.push_back(std::move(stats));
+        }
+        
+        std::sort(result.begin(), result.end(),
+            [](const SubscriberStatistics& a, const SubscriberStatistics& b) { return a.id < b.id; });
+        return result;
+    }
+    
+    /**
+     * @brief Name of a delivery policy, for logs and dashboards
+     */
+    static const char* policyName(DeliveryPolicy policy) {
+        switch (policy) {
+            case DeliveryPolicy::Direct:         return "direct";
+            case DeliveryPolicy::Block:          return "block";
+            case DeliveryPolicy::DropOldest:     return "drop-oldest";
+            case DeliveryPolicy::DropNewest:     return "drop-newest";
+            case DeliveryPolicy::ConflateLatest: return "conflate-latest";
+        }
+        return "unknown";
+    }
+    
     /**
      * @brief Get subscription statistics
      */
@@ -355,12 +844,28 @@ public:
     void clearAllSubscriptions() {
         std::unique_lock lock(m_subscriptionMutex);
         
+        std::vector<std::shared_ptr<Subscription>> removed;
+        removed.reserve(m_subscriptions.size());
+        for (const auto& pair : m_subscriptions) {
+            pair.second->enabled = false;
+            if (pair.second->mailbox) {
+                pair.second->mailbox->close();
+            }
+            removed.push_back(pair.second);
+        }
+        
         size_t count = m_subscriptions.size();
         m_subscriptions.clear();
         m_packetSubscriptions.clear();
+        m_snapshot.publish(std::make_unique<SubscriberSnapshot>());
         
         m_stats.activeSubscriptions = 0;
         m_stats.subscriptionsPerPacketType.clear();
+        lock.unlock();
+        
+        for (const auto& subscription : removed) {
+            waitForDeliveries(*subscription);
+        }
         
         m_logger->info("SubscriptionManager", 
             QString("Cleared %1 subscriptions").arg(count));
@@ -368,6 +873,356 @@ public:
         emit allSubscriptionsCleared();
     }
 
+private:
+    /**
+     * @brief Register a new subscription and publish its packet ID's list
+     */
+    SubscriberId addSubscription(std::shared_ptr<Subscription> subscription) {
+        const SubscriberId id = subscription->id;
+        const PacketId packetId = subscription->packetId;
+        
+        {
+            std::lock_guard lock(m_subscriptionMutex);
+            
+            // Add to main subscription map
+            m_subscriptions[id] = subscription;
+            
+            // Add to packet-specific map
+            auto& packetSubs = m_packetSubscriptions[packetId];
+            packetSubs.push_back(subscription);
+            
+            // Sort by priority (lower value = higher priority, 0 = highest)
+            std::sort(packetSubs.begin(), packetSubs.end(),
+                [](const std::shared_ptr<Subscription>& a, const std::shared_ptr<Subscription>& b) {
+                    return a->priority < b->priority;
+                });
+            publishSubscribers(packetId);
+            
+            // Update statistics
+            m_stats.totalSubscriptions++;
+            m_stats.activeSubscriptions++;
+            m_stats.subscriptionsPerPacketType[packetId]++;
+        }
+        
+        m_logger->info("SubscriptionManager", 
+            QString("Subscriber '%1' registered for packet ID %2 (priority %3)")
+            .arg(QString::fromStdString(subscription->name)).arg(packetId).arg(subscription->priority));
+        
+        emit subscriptionAdded(id, QString::fromStdString(subscription->name), packetId);
+        
+        return id;
+    }
+    
+    /**
+     * @brief Publish a snapshot with the current list for @p packetId
+     * 
+     * Caller must hold m_subscriptionMutex.
+     */
+    void publishSubscribers(PacketId packetId) {
+        auto snapshot = std::make_unique<SubscriberSnapshot>(*m_snapshot.writerView());
+        
+        std::shared_ptr<const SubscriberList> list;
+        auto it = m_packetSubscriptions.find(packetId);
+        if (it != m_packetSubscriptions.end()) {
+            list = std::make_shared<const SubscriberList>(it->second);
+        }
+        
+        if (packetId == ALL_PACKETS) {
+            snapshot->wildcards = std::move(list);
+        } else {
+            const PacketTypeRegistry::Slot slot = m_registry->findSlot(packetId);
+            if (slot >= snapshot->lists.size()) {
+                snapshot->lists.resize(slot + 1);
+            }
+            snapshot->lists[slot] = std::move(list);
+        }
+        
+        SubscriberList critical;
+        for (const auto& pair : m_subscriptions) {
+            if (pair.second->critical) {
+                critical.push_back(pair.second);
+            }
+        }
+        snapshot->critical = critical.empty() ? nullptr : std::make_shared<const SubscriberList>(std::move(critical));
+        
+        m_snapshot.publish(std::move(snapshot));
+    }
+    
+    /**
+     * @brief Call one subscriber with consecutive packets
+     * @return Number of packets delivered
+     */
+    size_t deliver(Subscription& subscription, const PacketPtr* packets, size_t count, uint64_t timeNs) {
+        if (subscription.mailbox) {
+            return post(subscription, packets, count, timeNs);
+        }
+        return invoke(subscription, packets, count, timeNs);
+    }
+    
+    /**
+     * @brief Run the callbacks of one subscriber with consecutive packets
+     * @return Number of packets delivered
+     */
+    size_t invoke(Subscription& subscription, const PacketPtr* packets, size_t count, uint64_t timeNs) {
+        // Announce the call before checking enabled, pairing with unsubscribe()
+        subscription.activeCalls.fetch_add(1);
+        if (!subscription.enabled.load()) {
+            subscription.activeCalls.fetch_sub(1, std::memory_order_release);
+            return 0;
+        }
+        
+        size_t delivered = 0;
+        if (subscription.batchCallback) {
+            if (invokeCallback(subscription, count, [&]() { subscription.batchCallback(PacketSpan(packets, count)); })) {
+                delivered = count;
+            }
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                if (invokeCallback(subscription, 1, [&]() { subscription.callback(packets[i]); })) {
+                    delivered++;
+                }
+            }
+        }
+        
+        if (delivered > 0) {
+            subscription.packetsReceived.fetch_add(delivered, std::memory_order_relaxed);
+            subscription.lastDeliveryTime.store(timeNs, std::memory_order_relaxed);
+        }
+        subscription.activeCalls.fetch_sub(1, std::memory_order_release);
+        return delivered;
+    }
+    
+    /**
+     * @brief Queue packets in a subscriber's mailbox and schedule its drain
+     * @return Number of packets queued
+     */
+    size_t post(Subscription& subscription, const PacketPtr* packets, size_t count, uint64_t timeNs) {
+        if (!subscription.enabled.load()) {
+            return 0;
+        }
+        
+        SubscriberMailbox& mailbox = *subscription.mailbox;
+        size_t queued = 0;
+        size_t offered = 0;
+        while (offered < count) {
+            const SubscriberMailbox::PushResult result = mailbox.push(packets + offered, count - offered, timeNs);
+            offered += result.consumed;
+            queued += result.consumed - result.dropped - result.conflated;
+            if (result.dropped + result.conflated > 0) {
+                subscription.packetsDropped.fetch_add(result.dropped + result.conflated, std::memory_order_relaxed);
+                subscription.packetsConflated.fetch_add(result.conflated, std::memory_order_relaxed);
+                m_stats.mailboxDrops.fetch_add(result.dropped + result.conflated, std::memory_order_relaxed);
+            }
+            
+            const bool inlineDrain = result.needsDrain && !scheduleDrain(subscription);
+            if (inlineDrain) {
+                drain(subscription, false);
+            }
+            
+            // Only Block stops short; an inline drain has already made room
+            if (offered < count && !inlineDrain) {
+                subscription.blockedPushes.fetch_add(1, std::memory_order_relaxed);
+                if (!mailbox.waitForSpace()) {
+                    break;
+                }
+            }
+        }
+        return queued;
+    }
+    
+    /**
+     * @brief Hand a drain to the subscriber's executor or the thread pool
+     * @return False if neither took it, leaving the caller to drain inline
+     */
+    bool scheduleDrain(Subscription& subscription) {
+        // The run holds the subscription; the manager waits for it as for any callback
+        auto run = [this, owner = subscription.shared_from_this()]() {
+            owner->activeCalls.fetch_add(1);
+            if (owner->enabled.load()) {
+                drain(*owner, true);
+            }
+            owner->activeCalls.fetch_sub(1, std::memory_order_release);
+        };
+        
+        if (subscription.executor) {
+            subscription.executor(std::move(run));
+            return true;
+        }
+        
+        Threading::ThreadPool* threadPool = m_threadPool.load(std::memory_order_relaxed);
+        return threadPool && threadPool->submitDetached(std::move(run));
+    }
+    
+    /**
+     * @brief Deliver queued packets of a mailbox subscriber
+     * 
+     * A scheduled drain delivers one batch and reschedules itself while
+     * packets remain, so a busy subscriber shares its executor fairly. An
+     * inline drain empties the mailbox.
+     */
+    void drain(Subscription& subscription, bool scheduled) {
+        // Not thread_local: a callback may distribute and drain another mailbox inline
+        std::vector<PacketPtr> packets;
+        packets.reserve(subscription.drainBatchSize);
+        SubscriberMailbox& mailbox = *subscription.mailbox;
+        
+        for (;;) {
+            uint64_t enqueuedNs = 0;
+            if (mailbox.pop(packets, subscription.drainBatchSize, enqueuedNs) == 0) {
+                return;
+            }
+            
+            const uint64_t nowNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+            const uint64_t lag = nowNs > enqueuedNs ? nowNs - enqueuedNs : 0;
+            subscription.lagNs.store(lag, std::memory_order_relaxed);
+            if (lag > subscription.maxLagNs.load(std::memory_order_relaxed)) {
+                subscription.maxLagNs.store(lag, std::memory_order_relaxed);
+            }
+            
+            ++deliveryDepth();
+            invoke(subscription, packets.data(), packets.size(), enqueuedNs);
+            --deliveryDepth();
+            packets.clear();
+            
+            if (subscription.critical) {
+                m_creditAvailable.notify_all();
+            }
+            
+            // The drain flag is still set, so the rescheduled run is the only drain
+            if (scheduled && mailbox.size() > 0 && scheduleDrain(subscription)) {
+                return;
+            }
+        }
+    }
+    
+    /**
+     * @brief Give a new subscription the mailbox and executor its options ask for
+     */
+    static void applyOptions(Subscription& subscription, const SubscriptionOptions& options) {
+        subscription.critical = options.critical && options.policy != DeliveryPolicy::Direct;
+        subscription.drainBatchSize = std::max<size_t>(options.drainBatchSize, 1);
+        subscription.executor = options.executor;
+        
+        switch (options.policy) {
+            case DeliveryPolicy::Direct:
+                return;
+            case DeliveryPolicy::Block:
+                subscription.mailbox = std::make_unique<SubscriberMailbox>(
+                    SubscriberMailbox::Policy::Block, options.mailboxCapacity);
+                return;
+            case DeliveryPolicy::DropOldest:
+                subscription.mailbox = std::make_unique<SubscriberMailbox>(
+                    SubscriberMailbox::Policy::DropOldest, options.mailboxCapacity);
+                return;
+            case DeliveryPolicy::DropNewest:
+                subscription.mailbox = std::make_unique<SubscriberMailbox>(
+                    SubscriberMailbox::Policy::DropNewest, options.mailboxCapacity);
+                return;
+            case DeliveryPolicy::ConflateLatest:
+                subscription.mailbox = std::make_unique<SubscriberMailbox>(
+                    SubscriberMailbox::Policy::ConflateLatest, options.mailboxCapacity);
+                return;
+        }
+    }
+    
+    static DeliveryPolicy policyOf(const SubscriberMailbox& mailbox) {
+        switch (mailbox.policy()) {
+            case SubscriberMailbox::Policy::Block:          return DeliveryPolicy::Block;
+            case SubscriberMailbox::Policy::DropOldest:     return DeliveryPolicy::DropOldest;
+            case SubscriberMailbox::Policy::DropNewest:     return DeliveryPolicy::DropNewest;
+            case SubscriberMailbox::Policy::ConflateLatest: return DeliveryPolicy::ConflateLatest;
+        }
+        return DeliveryPolicy::Direct;
+    }
+    
+    /**
+     * @brief Run a subscriber callback, counting @p count dropped packets if it throws
+     */
+    template<typename Call>
+    bool invokeCallback(Subscription& subscription, size_t count, Call&& call) {
+        try {
+            call();
+            return true;
+            
+        } catch (const std::exception& e) {
+            m_logger->error("SubscriptionManager", 
+                QString("Exception in subscriber '%1': %2")
+                .arg(QString::fromStdString(subscription.name)).arg(QString::fromStdString(e.what())));
+        } catch (...) {
+            m_logger->error("SubscriptionManager", 
+                QString("Unknown exception in subscriber '%1'")
+                .arg(QString::fromStdString(subscription.name)));
+        }
+        subscription.packetsDropped += count;
+        m_stats.deliveryFailures++;
+        return false;
+    }
+    
+    /**
+     * @brief Remove null and invalid packets, keeping the others' order
+     */
+    void dropInvalid(std::vector<PacketPtr>& packets) {
+        auto valid = std::remove_if(packets.begin(), packets.end(), [](const PacketPtr& packet) {
+            return !packet || !packet->isValid();
+        });
+        m_stats.deliveryFailures += static_cast<uint64_t>(packets.end() - valid);
+        packets.erase(valid, packets.end());
+    }
+    
+    /**
+     * @brief Packets of @p packets with those of one ID adjacent, each ID in arrival order
+     * 
+     * @return @p packets itself if its IDs already ascend, else @p scratch
+     *         filled with the grouped packets. @p packets is left as it is.
+     */
+    const std::vector<PacketPtr>& groupByPacketId(const std::vector<PacketPtr>& packets,
+                                                  std::vector<PacketPtr>& scratch) {
+        bool grouped = true;
+        for (size_t i = 1; i < packets.size() && grouped; ++i) {
+            grouped = packets[i - 1]->id() <= packets[i]->id();
+        }
+        if (grouped) {
+            return packets;
+        }
+        
+        thread_local std::vector<std::pair<PacketId, uint32_t>> order;
+        order.clear();
+        for (size_t i = 0; i < packets.size(); ++i) {
+            order.emplace_back(packets[i]->id(), static_cast<uint32_t>(i));
+        }
+        
+        // Index breaks ties, so each ID keeps its arrival order
+        std::sort(order.begin(), order.end());
+        scratch.clear();
+        for (const auto& entry : order) {
+            scratch.push_back(packets[entry.second]);
+        }
+        return scratch;
+    }
+    
+    /**
+     * @brief Wait for callbacks of a disabled subscription to return
+     * 
+     * Skipped on a delivering thread, which may be inside that callback.
+     */
+    void waitForDeliveries(const Subscription& subscription) const {
+        if (deliveryDepth() > 0) {
+            return;
+        }
+        while (subscription.activeCalls.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+    
+    /**
+     * @brief distributePacket() calls in progress on this thread
+     */
+    static uint32_t& deliveryDepth() {
+        thread_local uint32_t depth = 0;
+        return depth;
+    }
+
 signals:
     /**
      * @brief Emitted when subscription is added
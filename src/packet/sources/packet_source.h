@@ -11,6 +11,7 @@
 #include <memory>
 #include <atomic>
 #include <string>
+#include <vector>
 
 namespace Monitor {
 namespace Packet {
@@ -72,19 +73,21 @@ public:
         std::atomic<uint64_t> packetsDelivered{0};
         std::atomic<uint64_t> packetsDropped{0};
         std::atomic<uint64_t> bytesGenerated{0};
+        std::atomic<uint64_t> bytesCopied{0};       ///< Bytes memcpy'd/read on the ingest path
         std::atomic<uint64_t> errorCount{0};
         
         std::chrono::steady_clock::time_point startTime;
-        std::chrono::steady_clock::time_point lastPacketTime;
+        std::atomic<std::chrono::steady_clock::time_point> lastPacketTime{std::chrono::steady_clock::time_point()};    ///< Also stored by receive threads
         
         Statistics() : startTime(std::chrono::steady_clock::now()) {}
         
         // Copy constructor
-        Statistics(const Statistics& other) : startTime(other.startTime), lastPacketTime(other.lastPacketTime) {
+        Statistics(const Statistics& other) : startTime(other.startTime), lastPacketTime(other.lastPacketTime.load()) {
             packetsGenerated.store(other.packetsGenerated.load());
             packetsDelivered.store(other.packetsDelivered.load());
             packetsDropped.store(other.packetsDropped.load());
             bytesGenerated.store(other.bytesGenerated.load());
+            bytesCopied.store(other.bytesCopied.load());
             errorCount.store(other.errorCount.load());
         }
         
@@ -95,9 +98,10 @@ public:
                 packetsDelivered.store(other.packetsDelivered.load());
                 packetsDropped.store(other.packetsDropped.load());
                 bytesGenerated.store(other.bytesGenerated.load());
+                bytesCopied.store(other.bytesCopied.load());
                 errorCount.store(other.errorCount.load());
                 startTime = other.startTime;
-                lastPacketTime = other.lastPacketTime;
+                lastPacketTime = other.lastPacketTime.load();
             }
             return *this;
         }
@@ -116,6 +120,24 @@ public:
             return static_cast<double>(bytesGenerated.load()) / elapsed;
         }
         
+        /**
+         * @brief Average bytes copied per delivered packet
+         */
+        double getBytesCopiedPerPacket() const {
+            uint64_t delivered = packetsDelivered.load();
+            if (delivered == 0) return 0.0;
+            return static_cast<double>(bytesCopied.load()) / delivered;
+        }
+        
+        /**
+         * @brief Copies per delivered byte (1.0 means single-copy ingestion)
+         */
+        double getCopyAmplification() const {
+            uint64_t bytes = bytesGenerated.load();
+            if (bytes == 0) return 0.0;
+            return static_cast<double>(bytesCopied.load()) / bytes;
+        }
+        
         double getDropRate() const {
             uint64_t total = packetsGenerated.load();
             if (total == 0) return 0.0;
@@ -126,7 +148,15 @@ public:
     /**
      * @brief Packet callback function type
      */
-    using PacketCallback = std::function<void(PacketPtr packet)>;
+    using PacketCallback = std::function<void(const PacketPtr& packet)>;
+    
+    /**
+     * @brief Batch callback function type
+     * 
+     * Invoked on the source's receive thread; the callee may move packets
+     * out of the vector.
+     */
+    using PacketBatchCallback = std::function<void(std::vector<PacketPtr>& packets)>;
     
     /**
      * @brief Error callback function type
@@ -143,6 +173,7 @@ protected:
     Statistics m_stats;
     
     PacketCallback m_packetCallback;
+    PacketBatchCallback m_packetBatchCallback;
     ErrorCallback m_errorCallback;
 
 public:
@@ -179,6 +210,13 @@ public:
         m_packetCallback = callback;
     }
     
+    /**
+     * @brief Set batch callback for sources that deliver whole batches
+     */
+    void setPacketBatchCallback(const PacketBatchCallback& callback) {
+        m_packetBatchCallback = callback;
+    }
+    
     /**
      * @brief Set error callback
      */
@@ -333,7 +371,7 @@ signals:
     /**
      * @brief Emitted when a packet is available
      */
-    void packetReady(PacketPtr packet);
+    void packetReady(const PacketPtr& packet);
     
     /**
      * @brief Emitted when an error occurs
@@ -373,7 +411,7 @@ protected:
     /**
      * @brief Deliver packet to callbacks and emit signals
      */
-    void deliverPacket(PacketPtr packet) {
+    void deliverPacket(const PacketPtr& packet) {
         if (!packet) {
             m_stats.errorCount++;
             return;
@@ -397,6 +435,42 @@ protected:
         }
     }
     
+    /**
+     * @brief Deliver a batch of packets received off the Qt event loop
+     * 
+     * Goes to the batch callback when one is set, so the batch never passes
+     * through queued signals. Otherwise each packet takes the regular
+     * deliverPacket() path.
+     */
+    void deliverPacketBatch(std::vector<PacketPtr>& packets) {
+        if (packets.empty()) {
+            return;
+        }
+        
+        if (!m_packetBatchCallback) {
+            for (auto& packet : packets) {
+                deliverPacket(std::move(packet));
+            }
+            return;
+        }
+        
+        const uint64_t before = m_stats.packetsDelivered.load();
+        uint64_t bytes = 0;
+        for (const auto& packet : packets) {
+            bytes += packet->totalSize();
+        }
+        m_stats.packetsDelivered += packets.size();
+        m_stats.bytesGenerated += bytes;
+        m_stats.lastPacketTime = std::chrono::steady_clock::now();
+        
+        m_packetBatchCallback(packets);
+        
+        // Emit statistics update periodically
+        if (before / 1000 != (before + packets.size()) / 1000) {
+            emit statisticsUpdated(m_stats);
+        }
+    }
+    
     /**
      * @brief Report error to callbacks and emit signals
      */
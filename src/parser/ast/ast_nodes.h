@@ -5,6 +5,8 @@
 #include <memory>
 #include <unordered_map>
 
+#include "../layout/byte_order.h"
+
 namespace Monitor {
 namespace Parser {
 namespace AST {
@@ -256,11 +258,13 @@ public:
     size_t getAlignment() const { return m_alignment; }
     bool isPacked() const { return m_isPacked; }
     uint8_t getPackValue() const { return m_packValue; }
+    Layout::ByteOrder getByteOrder() const { return m_byteOrder; }   ///< From #pragma scalar_storage_order
     
     void setTotalSize(size_t size) { m_totalSize = size; }
     void setAlignment(size_t alignment) { m_alignment = alignment; }
     void setPacked(bool packed) { m_isPacked = packed; }
     void setPackValue(uint8_t packValue) { m_packValue = packValue; }
+    void setByteOrder(Layout::ByteOrder byteOrder) { m_byteOrder = byteOrder; }
     
     // Dependencies
     const std::vector<std::string>& getDependencies() const { return m_dependencies; }
@@ -278,6 +282,7 @@ private:
     size_t m_alignment = 0;
     bool m_isPacked = false;
     uint8_t m_packValue = 0;
+    Layout::ByteOrder m_byteOrder = Layout::ByteOrder::Native;
 };
 
 // Union declaration
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace Monitor {
+namespace Parser {
+namespace Layout {
+
+/**
+ * @brief Byte order scalars of a structure are stored in
+ *
+ * Native means nothing was declared: values are read as the host stores
+ * them. Little and Big name a wire order, which is swapped on read when it
+ * differs from the host's.
+ */
+enum class ByteOrder : uint8_t {
+    Native,
+    Little,
+    Big
+};
+
+/**
+ * @brief Byte order of the machine this build runs on
+ */
+constexpr ByteOrder hostByteOrder() {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return ByteOrder::Big;
+#else
+    return ByteOrder::Little;
+#endif
+}
+
+/**
+ * @brief True if values stored in @p order must be swapped to read on this host
+ */
+constexpr bool needsByteSwap(ByteOrder order) {
+    return order != ByteOrder::Native && order != hostByteOrder();
+}
+
+inline uint8_t byteSwap(uint8_t value) { return value; }
+inline uint16_t byteSwap(uint16_t value) { return __builtin_bswap16(value); }
+inline uint32_t byteSwap(uint32_t value) { return __builtin_bswap32(value); }
+inline uint64_t byteSwap(uint64_t value) { return __builtin_bswap64(value); }
+
+/**
+ * @brief @p value with its bytes reversed; works for any 1, 2, 4 or 8 byte scalar
+ */
+template<typename T>
+T byteSwapped(T value) {
+    static_assert(std::is_arithmetic_v<T>, "byteSwapped() reverses scalars only");
+    using Bits = std::conditional_t<sizeof(T) == 1, uint8_t,
+                 std::conditional_t<sizeof(T) == 2, uint16_t,
+                 std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+    static_assert(sizeof(Bits) == sizeof(T), "Unsupported scalar size");
+
+    Bits bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits = byteSwap(bits);
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief @p value as stored in @p order converted to host order, or back
+ */
+template<typename T>
+T toHostOrder(T value, ByteOrder order) {
+    return needsByteSwap(order) ? byteSwapped(value) : value;
+}
+
+inline const char* byteOrderName(ByteOrder order) {
+    switch (order) {
+        case ByteOrder::Native: return "native";
+        case ByteOrder::Little: return "little";
+        case ByteOrder::Big:    return "big";
+    }
+    return "native";
+}
+
+/**
+ * @brief Parse "native", "little", "big" and their usual spellings
+ *
+ * Accepts GCC's "big-endian"/"little-endian"/"default" as well as
+ * "network" for big-endian.
+ *
+ * @return False, leaving @p order unchanged, for anything else
+ */
+inline bool parseByteOrder(const std::string& name, ByteOrder& order) {
+    if (name == "native" || name == "host" || name == "default") {
+        order = ByteOrder::Native;
+    } else if (name == "little" || name == "little-endian" || name == "little_endian" || name == "le") {
+        order = ByteOrder::Little;
+    } else if (name == "big" || name == "big-endian" || name == "big_endian" || name == "be" ||
+               name == "network") {
+        order = ByteOrder::Big;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace Layout
+} // namespace Parser
+} // namespace Monitor
@@ -22,6 +22,10 @@ std::vector<Token> Preprocessor::process(const std::vector<Token>& tokens) {
     clearErrors();
     std::vector<Token> processedTokens;
 
+    // Byte order carries over from earlier input, like the pack stack
+    m_byteOrderRegions.clear();
+    m_byteOrderRegions.emplace_back(0, m_byteOrder);
+
     for (size_t i = 0; i < tokens.size(); ++i) {
         const Token& token = tokens[i];
 
@@ -30,17 +34,30 @@ std::vector<Token> Preprocessor::process(const std::vector<Token>& tokens) {
             std::vector<Token> directiveTokens;
             directiveTokens.push_back(token);
 
-            // Read until end of line or end of tokens
+            // Read until end of line or end of tokens. The tokenizer drops
+            // NEWLINE tokens by default, so a new line number ends it too.
             ++i;
             while (i < tokens.size() &&
                    tokens[i].type != TokenType::NEWLINE &&
-                   tokens[i].type != TokenType::EOF_TOKEN) {
+                   tokens[i].type != TokenType::EOF_TOKEN &&
+                   tokens[i].line == token.line) {
                 directiveTokens.push_back(tokens[i]);
                 ++i;
             }
+            if (i < tokens.size() && tokens[i].type != TokenType::NEWLINE) {
+                --i; // Not part of the directive; the next iteration keeps it
+            }
 
             processDirective(directiveTokens);
 
+            if (m_byteOrder != m_byteOrderRegions.back().order) {
+                if (m_byteOrderRegions.back().firstToken == processedTokens.size()) {
+                    m_byteOrderRegions.back().order = m_byteOrder;
+                } else {
+                    m_byteOrderRegions.emplace_back(processedTokens.size(), m_byteOrder);
+                }
+            }
+
             // Don't include pragma tokens in output
             continue;
         }
@@ -61,13 +78,17 @@ bool Preprocessor::processDirective(const std::vector<Token>& directiveTokens) {
         return false;
     }
 
-    // Look for "pack" keyword
+    // Look for "pack" or "scalar_storage_order" keyword
     for (size_t i = 1; i < directiveTokens.size(); ++i) {
         if (directiveTokens[i].value == "pack") {
             // Parse pack directive arguments
             std::vector<std::string> args = parseArguments(directiveTokens, i + 1);
             return processPragmaPack(args, directiveTokens[0].line, directiveTokens[0].column);
         }
+        if (directiveTokens[i].value == "scalar_storage_order") {
+            std::vector<std::string> args = parseArguments(directiveTokens, i + 1);
+            return processPragmaScalarStorageOrder(args, directiveTokens[0].line, directiveTokens[0].column);
+        }
     }
 
     return true; // Unknown pragma, but not an error
@@ -167,6 +188,24 @@ bool Preprocessor::processPragmaPack(const std::vector<std::string>& args, size_
     return true;
 }
 
+bool Preprocessor::processPragmaScalarStorageOrder(const std::vector<std::string>& args, size_t line, size_t column) {
+    // GCC spelling: #pragma scalar_storage_order big-endian | little-endian | default.
+    // The tokenizer splits "big-endian" at the '-', so rejoin the words.
+    std::string name;
+    for (const auto& arg : args) {
+        name += name.empty() ? arg : "-" + arg;
+    }
+
+    Layout::ByteOrder order;
+    if (!Layout::parseByteOrder(name, order)) {
+        addError("Invalid scalar storage order: " + name, line, column, "scalar_storage_order");
+        return false;
+    }
+
+    m_byteOrder = order;
+    return true;
+}
+
 bool Preprocessor::processInclude(const std::vector<std::string>& args, size_t line, size_t column) {
     (void)args;
     (void)line;
@@ -192,6 +231,15 @@ bool Preprocessor::isPackActive() const {
     return !m_packStack.empty() && m_packStack.top().packValue != m_defaultPackValue;
 }
 
+Layout::ByteOrder Preprocessor::getByteOrderAt(size_t tokenIndex) const {
+    for (auto it = m_byteOrderRegions.rbegin(); it != m_byteOrderRegions.rend(); ++it) {
+        if (it->firstToken <= tokenIndex) {
+            return it->order;
+        }
+    }
+    return m_byteOrder;
+}
+
 void Preprocessor::defineMacro(const std::string& name, const std::string& value) {
     m_macros[name] = value;
 }
@@ -230,6 +278,9 @@ void Preprocessor::reset() {
     }
     m_packStack.push(PackState(m_defaultPackValue));
 
+    m_byteOrder = Layout::ByteOrder::Native;
+    m_byteOrderRegions.clear();
+
     m_macros.clear();
     m_errors.clear();
     m_directives.clear();
@@ -239,6 +290,9 @@ Preprocessor::DirectiveType Preprocessor::identifyDirective(const std::string& d
     if (directiveName == "pack") {
         return DirectiveType::PRAGMA_PACK_SET;
     }
+    if (directiveName == "scalar_storage_order") {
+        return DirectiveType::PRAGMA_SCALAR_STORAGE_ORDER;
+    }
     if (directiveName == "include") {
         return DirectiveType::INCLUDE;
     }
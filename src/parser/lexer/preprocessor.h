@@ -1,6 +1,7 @@
 #pragma once
 
 #include "token_types.h"
+#include "../layout/byte_order.h"
 #include <vector>
 #include <stack>
 #include <unordered_map>
@@ -21,6 +22,7 @@ public:
         PRAGMA_PACK_POP,
         PRAGMA_PACK_SET,
         PRAGMA_PACK_RESET,
+        PRAGMA_SCALAR_STORAGE_ORDER,
         INCLUDE,
         DEFINE,
         UNDEF,
@@ -50,6 +52,17 @@ public:
             : packValue(value), identifier(id) {}
     };
     
+    /**
+     * @brief Byte order in effect from token firstToken of the processed output on
+     */
+    struct ByteOrderRegion {
+        size_t firstToken;
+        Layout::ByteOrder order;
+        
+        ByteOrderRegion(size_t first = 0, Layout::ByteOrder byteOrder = Layout::ByteOrder::Native)
+            : firstToken(first), order(byteOrder) {}
+    };
+    
     // Main preprocessing interface
     std::vector<Token> process(const std::vector<Token>& tokens);
     
@@ -58,6 +71,15 @@ public:
     bool isPackActive() const;
     const std::stack<PackState>& getPackStack() const { return m_packStack; }
     
+    // Byte order queries (#pragma scalar_storage_order)
+    Layout::ByteOrder getCurrentByteOrder() const { return m_byteOrder; }
+    
+    /**
+     * @brief Byte order declared for token @p tokenIndex of the last process() output
+     */
+    Layout::ByteOrder getByteOrderAt(size_t tokenIndex) const;
+    const std::vector<ByteOrderRegion>& getByteOrderRegions() const { return m_byteOrderRegions; }
+    
     // Directive processing
     bool processDirective(const std::vector<Token>& directiveTokens);
     DirectiveType identifyDirective(const std::string& directiveName) const;
@@ -89,11 +111,16 @@ private:
     std::vector<PreprocessorError> m_errors;
     std::vector<Directive> m_directives;
     
+    // Byte order state; regions index the last process() output
+    Layout::ByteOrder m_byteOrder = Layout::ByteOrder::Native;
+    std::vector<ByteOrderRegion> m_byteOrderRegions;
+    
     // Default pack value (platform-specific)
     uint8_t m_defaultPackValue;
     
     // Directive processors
     bool processPragmaPack(const std::vector<std::string>& args, size_t line, size_t column);
+    bool processPragmaScalarStorageOrder(const std::vector<std::string>& args, size_t line, size_t column);
     bool processInclude(const std::vector<std::string>& args, size_t line, size_t column);
     bool processDefine(const std::vector<std::string>& args, size_t line, size_t column);
     
@@ -166,6 +166,7 @@ std::vector<StructureManager::StructureInfo> StructureManager::getStructureInfos
             info.totalSize = pair.second->getTotalSize();
             info.alignment = pair.second->getAlignment();
             info.isPacked = pair.second->isPacked();
+            info.byteOrder = getByteOrder(pair.first);
             info.dependencies = pair.second->getDependencies();
         }
         infos.push_back(info);
@@ -327,6 +328,39 @@ StructParser::ParserOptions StructureManager::getParserOptions() const {
     return StructParser::ParserOptions();
 }
 
+void StructureManager::setDefaultByteOrder(Layout::ByteOrder order) {
+    m_defaultByteOrder = order;
+}
+
+Layout::ByteOrder StructureManager::getDefaultByteOrder() const {
+    return m_defaultByteOrder;
+}
+
+void StructureManager::setByteOrder(const std::string& structName, Layout::ByteOrder order) {
+    m_byteOrders[structName] = order;
+    emit structureInvalidated(QString::fromStdString(structName));
+}
+
+void StructureManager::clearByteOrder(const std::string& structName) {
+    if (m_byteOrders.erase(structName) > 0) {
+        emit structureInvalidated(QString::fromStdString(structName));
+    }
+}
+
+Layout::ByteOrder StructureManager::getByteOrder(const std::string& structName) const {
+    auto overrideIt = m_byteOrders.find(structName);
+    if (overrideIt != m_byteOrders.end()) {
+        return overrideIt->second;
+    }
+
+    auto structIt = m_structures.find(structName);
+    if (structIt != m_structures.end() && structIt->second &&
+        structIt->second->getByteOrder() != Layout::ByteOrder::Native) {
+        return structIt->second->getByteOrder();
+    }
+    return m_defaultByteOrder;
+}
+
 void StructureManager::setCacheSize(size_t maxSize) {
     Q_UNUSED(maxSize);
 }
@@ -65,6 +65,7 @@ public:
         size_t fieldCount = 0;
         size_t bitfieldCount = 0;
         bool isPacked = false;
+        Layout::ByteOrder byteOrder = Layout::ByteOrder::Native;
         std::vector<std::string> dependencies;
         std::chrono::steady_clock::time_point lastModified;
         
@@ -133,6 +134,32 @@ public:
     void setParserOptions(const StructParser::ParserOptions& options);
     StructParser::ParserOptions getParserOptions() const;
     
+    /**
+     * @brief Byte order for structures that declare none
+     *
+     * Applies to structures parsed without #pragma scalar_storage_order and
+     * without a setByteOrder() override, e.g. a whole feed of big-endian
+     * headers.
+     */
+    void setDefaultByteOrder(Layout::ByteOrder order);
+    Layout::ByteOrder getDefaultByteOrder() const;
+    
+    /**
+     * @brief Override the byte order of @p structName, declared or not
+     *
+     * Emits structureInvalidated() so field maps built from it are rebuilt.
+     */
+    void setByteOrder(const std::string& structName, Layout::ByteOrder order);
+    void clearByteOrder(const std::string& structName);
+    
+    /**
+     * @brief Byte order @p structName is decoded in
+     *
+     * The setByteOrder() override if any, else the order the structure was
+     * declared in, else the default byte order.
+     */
+    Layout::ByteOrder getByteOrder(const std::string& structName) const;
+    
     void setCacheSize(size_t maxSize);
     size_t getCacheSize() const;
     
@@ -242,6 +269,8 @@ private:
     Layout::AlignmentRules::CompilerType m_compilerType;
     Layout::AlignmentRules::Architecture m_architecture;
     std::shared_ptr<Layout::AlignmentRules> m_alignmentRules;
+    Layout::ByteOrder m_defaultByteOrder = Layout::ByteOrder::Native;
+    std::unordered_map<std::string, Layout::ByteOrder> m_byteOrders;   ///< setByteOrder() overrides
     
     // Statistics and errors
     mutable Statistics m_statistics;
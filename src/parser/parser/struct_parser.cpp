@@ -56,7 +56,7 @@ StructParser::ParseResult StructParser::parse(const std::string& source) {
 
         // Parse
         auto parseStart = std::chrono::high_resolution_clock::now();
-        result = parseFromTokens(tokens);
+        result = parseFromTokens(tokens, m_preprocessor->getByteOrderRegions());
         auto parseEnd = std::chrono::high_resolution_clock::now();
         m_statistics.parsingTime = std::chrono::duration_cast<std::chrono::milliseconds>(parseEnd - parseStart);
 
@@ -87,10 +87,15 @@ StructParser::ParseResult StructParser::parseFromFile(const std::string& filePat
     return parseFromTokens(tokens);
 }
 
-StructParser::ParseResult StructParser::parseFromTokens(const std::vector<Lexer::Token>& tokens) {
+StructParser::ParseResult StructParser::parseFromTokens(const std::vector<Lexer::Token>& tokens,
+                                                       const std::vector<Lexer::Preprocessor::ByteOrderRegion>& byteOrderRegions) {
     m_state.tokens = tokens;
     m_state.currentIndex = 0;
     m_state.nestingDepth = 0;
+    m_state.byteOrderRegions = byteOrderRegions;
+    m_state.structures.clear();
+    m_state.unions.clear();
+    m_state.typedefs.clear();
 
     ParseResult result;
 
@@ -98,9 +103,10 @@ StructParser::ParseResult StructParser::parseFromTokens(const std::vector<Lexer:
         if (parseTopLevelDeclarations()) {
             result.success = true;
 
-            // Transfer parsed structures to result
-            // Note: This is a simplified implementation
-            // In a real implementation, we'd use the AST builder properly
+            // Transfer parsed declarations to result
+            result.structures = std::move(m_state.structures);
+            result.unions = std::move(m_state.unions);
+            result.typedefs = std::move(m_state.typedefs);
 
             result.totalNodes = m_statistics.structsParsed + m_statistics.unionsParsed + m_statistics.typedefsParsed;
         } else {
@@ -194,18 +200,21 @@ bool StructParser::parseTopLevelDeclarations() {
             if (structDecl) {
                 hasValidDeclarations = true;
                 m_statistics.structsParsed++;
+                m_state.structures.push_back(std::move(structDecl));
             }
         } else if (current == Lexer::TokenType::UNION) {
             auto unionDecl = parseUnionDeclaration();
             if (unionDecl) {
                 hasValidDeclarations = true;
                 m_statistics.unionsParsed++;
+                m_state.unions.push_back(std::move(unionDecl));
             }
         } else if (current == Lexer::TokenType::TYPEDEF) {
             auto typedefDecl = parseTypedefDeclaration();
             if (typedefDecl) {
                 hasValidDeclarations = true;
                 m_statistics.typedefsParsed++;
+                m_state.typedefs.push_back(std::move(typedefDecl));
             }
         } else if (current == Lexer::TokenType::PRAGMA) {
             if (parsePragmaDirective()) {
@@ -221,6 +230,7 @@ bool StructParser::parseTopLevelDeclarations() {
 }
 
 std::unique_ptr<AST::StructDeclaration> StructParser::parseStructDeclaration() {
+    const size_t startIndex = m_state.currentIndex;
     if (!matchAndConsume(Lexer::TokenType::STRUCT)) {
         addError("Expected 'struct' keyword");
         return nullptr;
@@ -250,6 +260,7 @@ std::unique_ptr<AST::StructDeclaration> StructParser::parseStructDeclaration() {
     m_state.nestingDepth++;
 
     auto structDecl = std::make_unique<AST::StructDeclaration>(structName);
+    structDecl->setByteOrder(byteOrderAt(startIndex));
 
     // Parse fields
     auto fields = parseFieldDeclarations();
@@ -531,9 +542,32 @@ std::unique_ptr<AST::NamedType> StructParser::parseNamedType() {
 
 // Pragma parsing
 bool StructParser::parsePragmaDirective() {
-    // This is handled by the preprocessor, so we just skip
-    skipTo(Lexer::TokenType::NEWLINE);
-    return true;
+    // Preprocessed input has no pragmas left; these come from tokens passed
+    // straight to parseFromTokens(). Newlines may have been dropped, so the
+    // directive ends with its line.
+    const size_t line = currentToken().line;
+    std::vector<Lexer::Token> directiveTokens;
+    while (hasMoreTokens() && currentToken().type != Lexer::TokenType::NEWLINE &&
+           currentToken().line == line) {
+        directiveTokens.push_back(currentToken());
+        advance();
+    }
+
+    const bool processed = m_preprocessor->processDirective(directiveTokens);
+    const Layout::ByteOrder order = m_preprocessor->getCurrentByteOrder();
+    if (order != byteOrderAt(m_state.currentIndex)) {
+        m_state.byteOrderRegions.emplace_back(m_state.currentIndex, order);
+    }
+    return processed;
+}
+
+Layout::ByteOrder StructParser::byteOrderAt(size_t tokenIndex) const {
+    for (auto it = m_state.byteOrderRegions.rbegin(); it != m_state.byteOrderRegions.rend(); ++it) {
+        if (it->firstToken <= tokenIndex) {
+            return it->order;
+        }
+    }
+    return Layout::ByteOrder::Native;
 }
 
 bool StructParser::parseAttributeDirective() {
@@ -41,7 +41,14 @@ public:
     
     ParseResult parse(const std::string& source);
     ParseResult parseFromFile(const std::string& filePath);
-    ParseResult parseFromTokens(const std::vector<Lexer::Token>& tokens);
+    /**
+     * @brief Parse @p tokens; @p byteOrderRegions are the preprocessor's for them
+     *
+     * Unpreprocessed tokens may carry their own #pragma scalar_storage_order
+     * lines, which are honoured as they are reached.
+     */
+    ParseResult parseFromTokens(const std::vector<Lexer::Token>& tokens,
+                                const std::vector<Lexer::Preprocessor::ByteOrderRegion>& byteOrderRegions = {});
     
     // Configuration options
     struct ParserOptions {
@@ -102,6 +109,10 @@ private:
         size_t currentIndex = 0;
         std::stack<std::string> contextStack;
         std::unordered_map<std::string, uint8_t> packStateStack;
+        std::vector<Lexer::Preprocessor::ByteOrderRegion> byteOrderRegions;
+        std::vector<std::unique_ptr<AST::StructDeclaration>> structures;
+        std::vector<std::unique_ptr<AST::UnionDeclaration>> unions;
+        std::vector<std::unique_ptr<AST::TypedefDeclaration>> typedefs;
         size_t nestingDepth = 0;
         bool inStructDefinition = false;
         bool inUnionDefinition = false;
@@ -150,6 +161,7 @@ private:
     // Pragma and attribute parsing
     bool parsePragmaDirective();
     bool parseAttributeDirective();
+    Layout::ByteOrder byteOrderAt(size_t tokenIndex) const;
     
     // Utility methods
     bool isTypeKeyword(Lexer::TokenType tokenType) const;
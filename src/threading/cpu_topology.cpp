@@ -0,0 +1,317 @@
+#include "cpu_topology.h"
+#include <QtCore/QDebug>
+#include <QtCore/QStringList>
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <set>
+#include <thread>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#elif defined(Q_OS_WIN)
+#include <Windows.h>
+#elif defined(Q_OS_MAC)
+#include <pthread.h>
+#include <mach/thread_policy.h>
+#include <mach/thread_act.h>
+#endif
+
+namespace Monitor {
+namespace Threading {
+
+namespace {
+
+/**
+ * @brief First line of a sysfs file, or an empty string if it cannot be read
+ */
+std::string readLine(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (file) {
+        std::getline(file, line);
+    }
+    while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back()))) {
+        line.pop_back();
+    }
+    return line;
+}
+
+int readInt(const std::string& path, int fallback)
+{
+    const std::string text = readLine(path);
+    if (text.empty()) {
+        return fallback;
+    }
+    try {
+        return std::stoi(text);
+    } catch (...) {
+        return fallback;
+    }
+}
+
+} // namespace
+
+CpuTopology::CpuTopology(std::vector<Cpu> cpus)
+    : m_cpus(std::move(cpus))
+{
+    std::sort(m_cpus.begin(), m_cpus.end(), [](const Cpu& a, const Cpu& b) { return a.id < b.id; });
+    m_cpus.erase(std::unique(m_cpus.begin(), m_cpus.end(),
+                             [](const Cpu& a, const Cpu& b) { return a.id == b.id; }),
+                 m_cpus.end());
+
+    std::set<int> nodes;
+    for (const Cpu& cpu : m_cpus) {
+        nodes.insert(cpu.node);
+    }
+    m_nodes.assign(nodes.begin(), nodes.end());
+}
+
+const CpuTopology& CpuTopology::system()
+{
+    static const CpuTopology topology = []() {
+        CpuTopology detected;
+#ifdef Q_OS_LINUX
+        detected = fromSysfs("/sys/devices/system");
+#endif
+        if (detected.isEmpty()) {
+            detected = uniform(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+        }
+        qInfo() << "CpuTopology:" << detected.describe();
+        return detected;
+    }();
+    return topology;
+}
+
+CpuTopology CpuTopology::fromSysfs(const std::string& root)
+{
+    bool ok = false;
+    const CpuSet online = parseCpuList(readLine(root + "/cpu/online"), &ok);
+    if (!ok || online.empty()) {
+        return CpuTopology();
+    }
+
+    std::vector<Cpu> cpus;
+    cpus.reserve(online.size());
+    for (int id : online) {
+        const std::string base = root + "/cpu/cpu" + std::to_string(id);
+        Cpu cpu;
+        cpu.id = id;
+        cpu.package = readInt(base + "/topology/physical_package_id", 0);
+        cpu.core = readInt(base + "/topology/core_id", id);
+
+        // The last-level cache is named after the first CPU sharing it
+        const CpuSet sharing = parseCpuList(readLine(base + "/cache/index3/shared_cpu_list"));
+        cpu.cache = sharing.empty() ? cpu.package : sharing.front();
+        cpus.push_back(cpu);
+    }
+
+    // Without NUMA support in the kernel there is no node directory: one node
+    const CpuSet nodes = parseCpuList(readLine(root + "/node/online"), &ok);
+    if (ok) {
+        for (int node : nodes) {
+            const CpuSet members = parseCpuList(readLine(root + "/node/node" + std::to_string(node) + "/cpulist"));
+            for (Cpu& cpu : cpus) {
+                if (std::binary_search(members.begin(), members.end(), cpu.id)) {
+                    cpu.node = node;
+                }
+            }
+        }
+    }
+
+    return CpuTopology(std::move(cpus));
+}
+
+CpuTopology CpuTopology::uniform(int cpuCount)
+{
+    std::vector<Cpu> cpus;
+    for (int id = 0; id < cpuCount; ++id) {
+        Cpu cpu;
+        cpu.id = id;
+        cpu.core = id;
+        cpus.push_back(cpu);
+    }
+    return CpuTopology(std::move(cpus));
+}
+
+CpuSet CpuTopology::parseCpuList(const std::string& list, bool* ok)
+{
+    if (ok) {
+        *ok = false;
+    }
+
+    std::set<int> cpus;
+    size_t position = 0;
+    while (position < list.size()) {
+        size_t end = list.find(',', position);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        const std::string item = list.substr(position, end - position);
+        position = end + 1;
+
+        int first = 0;
+        int last = 0;
+        try {
+            size_t used = 0;
+            first = std::stoi(item, &used);
+            if (used < item.size()) {
+                if (item[used] != '-') {
+                    return CpuSet();
+                }
+                size_t rest = 0;
+                last = std::stoi(item.substr(used + 1), &rest);
+                if (used + 1 + rest != item.size()) {
+                    return CpuSet();
+                }
+            } else {
+                last = first;
+            }
+        } catch (...) {
+            return CpuSet();
+        }
+
+        if (first < 0 || last < first) {
+            return CpuSet();
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.insert(cpu);
+        }
+    }
+
+    if (ok) {
+        *ok = !cpus.empty();
+    }
+    return CpuSet(cpus.begin(), cpus.end());
+}
+
+QString CpuTopology::formatCpuList(const CpuSet& cpus)
+{
+    CpuSet sorted = cpus;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    QStringList ranges;
+    for (size_t i = 0; i < sorted.size();) {
+        size_t j = i;
+        while (j + 1 < sorted.size() && sorted[j + 1] == sorted[j] + 1) {
+            ++j;
+        }
+        ranges << (j == i ? QString::number(sorted[i])
+                          : QString("%1-%2").arg(sorted[i]).arg(sorted[j]));
+        i = j + 1;
+    }
+    return ranges.join(",");
+}
+
+bool CpuTopology::hasNode(int node) const
+{
+    return std::binary_search(m_nodes.begin(), m_nodes.end(), node);
+}
+
+int CpuTopology::nodeOfCpu(int cpu) const
+{
+    const Cpu* found = find(cpu);
+    return found ? found->node : -1;
+}
+
+CpuSet CpuTopology::cpusOfNode(int node) const
+{
+    CpuSet cpus;
+    for (const Cpu& cpu : m_cpus) {
+        if (cpu.node == node) {
+            cpus.push_back(cpu.id);
+        }
+    }
+    return cpus;
+}
+
+CpuSet CpuTopology::spreadOrder() const
+{
+    // Rank each CPU among the SMT siblings of its core, then sort by rank,
+    // node and id
+    std::vector<std::pair<int, const Cpu*>> ranked;
+    std::set<std::pair<int, int>> seenCores;
+    for (const Cpu& cpu : m_cpus) {
+        const bool first = seenCores.insert({cpu.package, cpu.core}).second;
+        ranked.push_back({first ? 0 : 1, &cpu});
+    }
+    std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        return a.second->node < b.second->node;
+    });
+
+    CpuSet order;
+    order.reserve(ranked.size());
+    for (const auto& entry : ranked) {
+        order.push_back(entry.second->id);
+    }
+    return order;
+}
+
+QString CpuTopology::describe() const
+{
+    std::set<int> packages;
+    std::set<std::pair<int, int>> cores;
+    std::set<int> caches;
+    for (const Cpu& cpu : m_cpus) {
+        packages.insert(cpu.package);
+        cores.insert({cpu.package, cpu.core});
+        caches.insert(cpu.cache);
+    }
+    return QString("%1 nodes, %2 packages, %3 last-level caches, %4 cores, %5 CPUs")
+        .arg(m_nodes.size())
+        .arg(packages.size())
+        .arg(caches.size())
+        .arg(cores.size())
+        .arg(m_cpus.size());
+}
+
+const CpuTopology::Cpu* CpuTopology::find(int cpu) const
+{
+    auto it = std::lower_bound(m_cpus.begin(), m_cpus.end(), cpu,
+                               [](const Cpu& entry, int id) { return entry.id < id; });
+    return (it != m_cpus.end() && it->id == cpu) ? &*it : nullptr;
+}
+
+bool pinCurrentThread(const CpuSet& cpus)
+{
+    if (cpus.empty()) {
+        return false;
+    }
+
+#ifdef Q_OS_LINUX
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuset);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#elif defined(Q_OS_WIN)
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+            mask |= DWORD_PTR(1) << cpu;
+        }
+    }
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(Q_OS_MAC)
+    // macOS has no hard affinity; threads sharing a tag are kept together
+    thread_affinity_policy_data_t policy = { cpus.front() + 1 };
+    return thread_policy_set(pthread_mach_thread_np(pthread_self()),
+                             THREAD_AFFINITY_POLICY,
+                             (thread_policy_t)&policy,
+                             THREAD_AFFINITY_POLICY_COUNT) == KERN_SUCCESS;
+#else
+    return false;
+#endif
+}
+
+} // namespace Threading
+} // namespace Monitor
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <string>
+#include <vector>
+
+namespace Monitor {
+namespace Threading {
+
+/**
+ * @brief Logical CPU numbers a thread may run on
+ */
+using CpuSet = std::vector<int>;
+
+/**
+ * @brief Logical CPUs of the machine and the NUMA nodes, packages and
+ *        caches they share
+ *
+ * On Linux the layout is read from sysfs; elsewhere, or when sysfs is not
+ * readable, every CPU reported by the OS is put on node 0 of one package,
+ * each as its own core.
+ */
+class CpuTopology
+{
+public:
+    struct Cpu {
+        int id = 0;
+        int node = 0;       ///< NUMA node
+        int package = 0;    ///< Physical socket
+        int core = 0;       ///< Physical core within the package; SMT siblings share it
+        int cache = 0;      ///< Last-level cache domain
+    };
+
+    CpuTopology() = default;
+    explicit CpuTopology(std::vector<Cpu> cpus);
+
+    /**
+     * @brief Topology of this machine, detected on first use
+     */
+    static const CpuTopology& system();
+
+    /**
+     * @brief Read the topology from a sysfs tree rooted at @p root
+     *
+     * Expects @p root/cpu/online, @p root/cpu/cpuN/topology and
+     * @p root/node/nodeN/cpulist, as under /sys/devices/system.
+     * @return An empty topology if the CPU list cannot be read
+     */
+    static CpuTopology fromSysfs(const std::string& root);
+
+    /**
+     * @brief @p cpuCount CPUs on one node, package and cache
+     */
+    static CpuTopology uniform(int cpuCount);
+
+    /**
+     * @brief Parse a kernel-style CPU list such as "0-3,8,10-11"
+     * @return The CPUs in ascending order without duplicates; empty with
+     *         @p ok false if the list is malformed
+     */
+    static CpuSet parseCpuList(const std::string& list, bool* ok = nullptr);
+
+    /**
+     * @brief Format @p cpus as a CPU list, collapsing runs into ranges
+     */
+    static QString formatCpuList(const CpuSet& cpus);
+
+    const std::vector<Cpu>& cpus() const { return m_cpus; }
+    int cpuCount() const { return static_cast<int>(m_cpus.size()); }
+    int nodeCount() const { return static_cast<int>(m_nodes.size()); }
+    bool isEmpty() const { return m_cpus.empty(); }
+
+    bool hasCpu(int cpu) const { return find(cpu) != nullptr; }
+    bool hasNode(int node) const;
+
+    /**
+     * @brief NUMA node of @p cpu, or -1 if there is no such CPU
+     */
+    int nodeOfCpu(int cpu) const;
+
+    /**
+     * @brief CPUs of NUMA node @p node, ascending
+     */
+    CpuSet cpusOfNode(int node) const;
+
+    /**
+     * @brief All CPUs, one per physical core first and SMT siblings after
+     *
+     * Within each round the CPUs are grouped by node, so a prefix of the
+     * list stays on as few nodes and caches as possible.
+     */
+    CpuSet spreadOrder() const;
+
+    /**
+     * @brief One-line summary of the node, package, cache, core and CPU counts
+     */
+    QString describe() const;
+
+private:
+    const Cpu* find(int cpu) const;
+
+    std::vector<Cpu> m_cpus;        ///< Sorted by id
+    std::vector<int> m_nodes;       ///< Distinct node numbers, ascending
+};
+
+/**
+ * @brief Restrict the calling thread to @p cpus
+ * @return False if @p cpus is empty, the platform cannot pin threads or the OS refused
+ */
+bool pinCurrentThread(const CpuSet& cpus);
+
+} // namespace Threading
+} // namespace Monitor
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Monitor {
+namespace Threading {
+
+/**
+ * @brief Move-only void() callable with small-buffer storage
+ *
+ * Callables of up to Capacity bytes, and no stricter than pointer
+ * alignment, are constructed in place; larger ones are kept on the heap.
+ * Unlike std::function, whose libstdc++ buffer holds only 16 bytes, a
+ * lambda capturing a few pointers, a shared_ptr or a whole std::function
+ * needs no allocation, and move-only captures are allowed.
+ */
+template<size_t Capacity>
+class InlineFunction
+{
+public:
+    InlineFunction() noexcept = default;
+
+    template<typename F,
+             typename D = std::decay_t<F>,
+             typename = std::enable_if_t<!std::is_same_v<D, InlineFunction> && std::is_invocable_v<D&>>>
+    InlineFunction(F&& function) {
+        // An empty std::function or null function pointer stays empty
+        if constexpr (std::is_constructible_v<bool, const D&>) {
+            if (!static_cast<bool>(function)) {
+                return;
+            }
+        }
+        if constexpr (fitsInline<D>()) {
+            ::new (static_cast<void*>(m_storage)) D(std::forward<F>(function));
+            m_ops = &InlineOps<D>::OPS;
+        } else {
+            ::new (static_cast<void*>(m_storage)) D*(new D(std::forward<F>(function)));
+            m_ops = &HeapOps<D>::OPS;
+        }
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept {
+        moveFrom(other);
+    }
+
+    InlineFunction& operator=(InlineFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    ~InlineFunction() { reset(); }
+
+    void operator()() { m_ops->invoke(m_storage); }
+
+    explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+    /**
+     * @brief Whether the callable lives in the object rather than on the heap
+     */
+    bool isInline() const noexcept { return m_ops != nullptr && m_ops->isInline; }
+
+    void reset() noexcept {
+        if (m_ops) {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+    template<typename D>
+    static constexpr bool fitsInline() {
+        return sizeof(D) <= Capacity && alignof(D) <= alignof(void*) &&
+               std::is_nothrow_move_constructible_v<D>;
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* target, void* source) noexcept;     ///< Also destroys the source
+        void (*destroy)(void* storage) noexcept;
+        bool isInline;
+    };
+
+    template<typename D>
+    struct InlineOps {
+        static void invoke(void* storage) { (*static_cast<D*>(storage))(); }
+        static void move(void* target, void* source) noexcept {
+            ::new (target) D(std::move(*static_cast<D*>(source)));
+            static_cast<D*>(source)->~D();
+        }
+        static void destroy(void* storage) noexcept { static_cast<D*>(storage)->~D(); }
+        static constexpr Ops OPS = {&invoke, &move, &destroy, true};
+    };
+
+    template<typename D>
+    struct HeapOps {
+        static void invoke(void* storage) { (**static_cast<D**>(storage))(); }
+        static void move(void* target, void* source) noexcept {
+            ::new (target) D*(*static_cast<D**>(source));
+        }
+        static void destroy(void* storage) noexcept { delete *static_cast<D**>(storage); }
+        static constexpr Ops OPS = {&invoke, &move, &destroy, false};
+    };
+
+    void moveFrom(InlineFunction& other) noexcept {
+        if (other.m_ops) {
+            other.m_ops->move(m_storage, other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    alignas(void*) unsigned char m_storage[Capacity];
+    const Ops* m_ops = nullptr;
+};
+
+} // namespace Threading
+} // namespace Monitor
@@ -0,0 +1,281 @@
+#include "pipeline_topology.h"
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonValue>
+#include <algorithm>
+#include <set>
+
+namespace Monitor {
+namespace Threading {
+
+namespace {
+
+constexpr PipelineTopology::Stage ALL_STAGES[] = {
+    PipelineTopology::Stage::Receive,
+    PipelineTopology::Stage::Router,
+    PipelineTopology::Stage::Processor,
+    PipelineTopology::Stage::Recorder,
+    PipelineTopology::Stage::Gui
+};
+
+} // namespace
+
+bool PipelineTopology::fromJson(const QJsonObject& json, QStringList* errors)
+{
+    QStringList problems;
+
+    for (const QString& key : json.keys()) {
+        bool known = false;
+        for (Stage stage : ALL_STAGES) {
+            known |= key == stageName(stage);
+        }
+        if (!known) {
+            problems << QString("Unknown pipeline stage '%1'").arg(key);
+        }
+    }
+
+    for (Stage stage : ALL_STAGES) {
+        const QString name = stageName(stage);
+        if (!json.contains(name)) {
+            m_placements[index(stage)] = Placement();
+            continue;
+        }
+
+        const QJsonObject entry = json.value(name).toObject();
+        Placement placement;
+        bool valid = true;
+
+        if (entry.contains("cpus") && !parseCpus(entry.value("cpus"), placement.cpus)) {
+            problems << QString("%1: malformed CPU list").arg(name);
+            valid = false;
+        }
+        if (entry.contains("node")) {
+            placement.node = entry.value("node").toInt(-1);
+            if (placement.node < 0) {
+                problems << QString("%1: node must be a non-negative number").arg(name);
+                valid = false;
+            }
+        }
+        if (entry.contains("memoryNode")) {
+            placement.memoryNode = entry.value("memoryNode").toInt(-1);
+            if (placement.memoryNode < 0) {
+                problems << QString("%1: memoryNode must be a non-negative number").arg(name);
+                valid = false;
+            }
+        }
+
+        m_placements[index(stage)] = valid ? placement : Placement();
+    }
+
+    if (errors) {
+        *errors = problems;
+    }
+    return problems.isEmpty();
+}
+
+QJsonObject PipelineTopology::toJson() const
+{
+    QJsonObject json;
+    for (Stage stage : ALL_STAGES) {
+        const Placement& entry = placement(stage);
+        if (entry.isEmpty()) {
+            continue;
+        }
+
+        QJsonObject object;
+        if (!entry.cpus.empty()) {
+            object["cpus"] = CpuTopology::formatCpuList(entry.cpus);
+        }
+        if (entry.node >= 0) {
+            object["node"] = entry.node;
+        }
+        if (entry.memoryNode >= 0) {
+            object["memoryNode"] = entry.memoryNode;
+        }
+        json[stageName(stage)] = object;
+    }
+    return json;
+}
+
+void PipelineTopology::setPlacement(Stage stage, const Placement& placement)
+{
+    m_placements[index(stage)] = placement;
+}
+
+bool PipelineTopology::isEmpty() const
+{
+    return std::all_of(m_placements.begin(), m_placements.end(),
+                       [](const Placement& placement) { return placement.isEmpty(); });
+}
+
+CpuSet PipelineTopology::cpuSetFor(Stage stage, size_t threadIndex, const CpuTopology& topology) const
+{
+    const Placement& entry = placement(stage);
+    if (!entry.cpus.empty()) {
+        return CpuSet{entry.cpus[threadIndex % entry.cpus.size()]};
+    }
+    if (entry.node >= 0) {
+        return topology.cpusOfNode(entry.node);
+    }
+    return CpuSet();
+}
+
+std::vector<CpuSet> PipelineTopology::cpuSetsFor(Stage stage, size_t threadCount, const CpuTopology& topology) const
+{
+    const Placement& entry = placement(stage);
+    if (entry.cpus.empty() && entry.node < 0) {
+        return {};
+    }
+
+    std::vector<CpuSet> sets;
+    sets.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        sets.push_back(cpuSetFor(stage, i, topology));
+    }
+    return sets;
+}
+
+int PipelineTopology::memoryNodeFor(Stage stage, const CpuTopology& topology) const
+{
+    const Placement& entry = placement(stage);
+    if (entry.memoryNode >= 0) {
+        return entry.memoryNode;
+    }
+    if (entry.cpus.empty()) {
+        return entry.node;
+    }
+
+    const int node = topology.nodeOfCpu(entry.cpus.front());
+    for (int cpu : entry.cpus) {
+        if (topology.nodeOfCpu(cpu) != node) {
+            return -1;
+        }
+    }
+    return node;
+}
+
+QStringList PipelineTopology::validate(const CpuTopology& topology) const
+{
+    QStringList problems;
+    std::set<int> pinned;
+
+    for (Stage stage : ALL_STAGES) {
+        const Placement& entry = placement(stage);
+        const QString name = stageName(stage);
+
+        CpuSet missing;
+        for (int cpu : entry.cpus) {
+            if (!topology.hasCpu(cpu)) {
+                missing.push_back(cpu);
+            }
+        }
+        if (!missing.empty()) {
+            problems << QString("%1: CPUs %2 do not exist").arg(name, CpuTopology::formatCpuList(missing));
+        }
+        if (entry.node >= 0 && !topology.hasNode(entry.node)) {
+            problems << QString("%1: NUMA node %2 does not exist").arg(name).arg(entry.node);
+        }
+        if (entry.memoryNode >= 0 && !topology.hasNode(entry.memoryNode)) {
+            problems << QString("%1: NUMA memory node %2 does not exist").arg(name).arg(entry.memoryNode);
+        }
+        if (!entry.cpus.empty() && entry.node >= 0) {
+            problems << QString("%1: both cpus and node are given; the node is ignored").arg(name);
+        }
+
+        // Stages pinned to the same core compete for it
+        CpuSet shared;
+        for (int cpu : entry.cpus) {
+            if (!pinned.insert(cpu).second) {
+                shared.push_back(cpu);
+            }
+        }
+        if (!shared.empty()) {
+            problems << QString("%1: CPUs %2 are also given to another stage")
+                            .arg(name, CpuTopology::formatCpuList(shared));
+        }
+    }
+    return problems;
+}
+
+QStringList PipelineTopology::report(const CpuTopology& topology,
+                                     const std::vector<std::pair<Stage, size_t>>& threadCounts) const
+{
+    QStringList lines;
+    lines << QString("Machine: %1").arg(topology.describe());
+
+    for (Stage stage : ALL_STAGES) {
+        const Placement& entry = placement(stage);
+        QString line = QString("%1: ").arg(stageName(stage), -10);
+
+        if (entry.cpus.empty() && entry.node < 0) {
+            line += "floating";
+        } else {
+            auto known = std::find_if(threadCounts.begin(), threadCounts.end(),
+                                      [stage](const auto& count) { return count.first == stage; });
+            if (known != threadCounts.end() && known->second > 0) {
+                QStringList threads;
+                for (size_t i = 0; i < known->second; ++i) {
+                    threads << QString("#%1 -> %2").arg(i).arg(
+                        CpuTopology::formatCpuList(cpuSetFor(stage, i, topology)));
+                }
+                line += threads.join(", ");
+            } else if (!entry.cpus.empty()) {
+                line += QString("CPUs %1").arg(CpuTopology::formatCpuList(entry.cpus));
+            } else {
+                line += QString("node %1 (CPUs %2)").arg(entry.node).arg(
+                    CpuTopology::formatCpuList(topology.cpusOfNode(entry.node)));
+            }
+        }
+
+        const int memoryNode = memoryNodeFor(stage, topology);
+        if (memoryNode >= 0) {
+            line += QString("; memory on node %1").arg(memoryNode);
+        }
+        lines << line;
+    }
+    return lines;
+}
+
+QString PipelineTopology::stageName(Stage stage)
+{
+    switch (stage) {
+        case Stage::Receive:   return "receive";
+        case Stage::Router:    return "router";
+        case Stage::Processor: return "processor";
+        case Stage::Recorder:  return "recorder";
+        case Stage::Gui:       return "gui";
+    }
+    return QString();
+}
+
+bool PipelineTopology::parseCpus(const QJsonValue& value, CpuSet& cpus)
+{
+    bool ok = false;
+    if (value.isString()) {
+        cpus = CpuTopology::parseCpuList(value.toString().toStdString(), &ok);
+        return ok;
+    }
+
+    if (value.isArray()) {
+        // Listed order is thread order, so an array is kept as given
+        const QJsonArray array = value.toArray();
+        cpus.clear();
+        for (const QJsonValue& entry : array) {
+            const int cpu = entry.toInt(-1);
+            if (cpu < 0) {
+                return false;
+            }
+            cpus.push_back(cpu);
+        }
+        return !cpus.empty();
+    }
+
+    if (value.isDouble()) {
+        const int cpu = value.toInt(-1);
+        cpus = cpu >= 0 ? CpuSet{cpu} : CpuSet{};
+        return cpu >= 0;
+    }
+    return false;
+}
+
+} // namespace Threading
+} // namespace Monitor
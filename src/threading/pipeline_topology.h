@@ -0,0 +1,111 @@
+#pragma once
+
+#include "cpu_topology.h"
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace Monitor {
+namespace Threading {
+
+/**
+ * @brief Declarative placement of the pipeline's threads and memory on CPUs
+ *        and NUMA nodes
+ *
+ * Read from the "topology" section of a workspace:
+ *
+ *     "topology": {
+ *         "receive":   { "cpus": "2-3" },
+ *         "router":    { "cpus": [4, 5, 6, 7] },
+ *         "processor": { "node": 1 },
+ *         "recorder":  { "cpus": "8", "memoryNode": 0 },
+ *         "gui":       { "node": 0 }
+ *     }
+ *
+ * With "cpus", thread i of a stage (receive thread of source i, router
+ * worker i, processor pool worker i) is pinned to the i-th listed CPU,
+ * wrapping around. With only "node", the stage's threads may run on any
+ * CPU of that node. A stage that is not listed floats.
+ *
+ * The memory a stage allocates from is kept on "memoryNode" if given, or
+ * else on the node of its CPUs: packet buffers on the receive stage's
+ * node, since receive threads allocate and first touch them, and queued
+ * task blocks on the processor stage's node.
+ */
+class PipelineTopology
+{
+public:
+    enum class Stage {
+        Receive,
+        Router,
+        Processor,
+        Recorder,
+        Gui
+    };
+
+    static constexpr size_t STAGE_COUNT = 5;
+
+    struct Placement {
+        CpuSet cpus;            ///< One CPU per thread, in order; empty to use the node
+        int node = -1;          ///< NUMA node, if no CPUs are listed
+        int memoryNode = -1;    ///< Node for the stage's memory; -1 follows the CPUs
+
+        bool isEmpty() const { return cpus.empty() && node < 0 && memoryNode < 0; }
+    };
+
+    /**
+     * @brief Read a "topology" section
+     * @return False if it is malformed; @p errors then says why, and the
+     *         topology keeps the stages that did parse
+     */
+    bool fromJson(const QJsonObject& json, QStringList* errors = nullptr);
+    QJsonObject toJson() const;
+
+    void setPlacement(Stage stage, const Placement& placement);
+    const Placement& placement(Stage stage) const { return m_placements[index(stage)]; }
+
+    bool isEmpty() const;
+
+    /**
+     * @brief CPUs thread @p threadIndex of @p stage may run on; empty if it floats
+     */
+    CpuSet cpuSetFor(Stage stage, size_t threadIndex, const CpuTopology& topology) const;
+
+    /**
+     * @brief cpuSetFor() for threads 0 to @p threadCount - 1; empty if the stage floats
+     */
+    std::vector<CpuSet> cpuSetsFor(Stage stage, size_t threadCount, const CpuTopology& topology) const;
+
+    /**
+     * @brief Node to keep the stage's memory on, or -1 if unplaced or its
+     *        CPUs span several nodes
+     */
+    int memoryNodeFor(Stage stage, const CpuTopology& topology) const;
+
+    /**
+     * @brief Problems applying this topology to @p topology, such as CPUs or nodes it lacks
+     */
+    QStringList validate(const CpuTopology& topology) const;
+
+    /**
+     * @brief Placement report, one line per stage
+     * @param threadCounts Threads known per stage, listed CPU by CPU
+     */
+    QStringList report(const CpuTopology& topology,
+                       const std::vector<std::pair<Stage, size_t>>& threadCounts = {}) const;
+
+    static QString stageName(Stage stage);
+
+private:
+    static size_t index(Stage stage) { return static_cast<size_t>(stage); }
+    static bool parseCpus(const QJsonValue& value, CpuSet& cpus);
+
+    std::array<Placement, STAGE_COUNT> m_placements;
+};
+
+} // namespace Threading
+} // namespace Monitor
@@ -0,0 +1,97 @@
+#include "task_group.h"
+#include <QtCore/QDebug>
+
+namespace Monitor {
+namespace Threading {
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : m_pool(pool)
+    , m_state(new State)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    // Pending tasks may reference the caller's stack, so they must not outlive the group
+    if (m_state->pending.load(std::memory_order_acquire) != 0) {
+        qWarning() << "TaskGroup destroyed with pending tasks; cancelling them";
+        cancel();
+        try {
+            wait();
+        } catch (...) {
+        }
+    }
+    m_state->release();
+}
+
+bool TaskGroup::wait()
+{
+    Concurrent::SpinWait backoff(SPIN_ITERATIONS, YIELD_ITERATIONS);
+
+    while (m_state->pending.load(std::memory_order_acquire) != 0) {
+        if (m_pool.runPendingTask()) {
+            backoff.reset();
+            continue;
+        }
+
+        if (!backoff.idle()) {
+            continue;
+        }
+
+        // Nothing left to take: the remaining tasks are running elsewhere
+        auto key = m_state->finished.prepareWait();
+        if (m_state->pending.load(std::memory_order_acquire) == 0) {
+            m_state->finished.cancelWait();
+        } else {
+            m_state->finished.wait(key);
+        }
+        backoff.reset();
+    }
+
+    // Reset for reuse before reporting how this round went
+    const bool cancelled = m_state->cancelled.exchange(false, std::memory_order_relaxed);
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(m_state->errorMutex);
+        error = std::exchange(m_state->error, nullptr);
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return !cancelled;
+}
+
+void TaskGroup::cancel() noexcept
+{
+    m_state->cancelled.store(true, std::memory_order_relaxed);
+}
+
+void TaskGroup::State::fail(std::exception_ptr exception) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+            error = exception;
+        }
+    }
+    cancelled.store(true, std::memory_order_relaxed);
+}
+
+void TaskGroup::State::finish() noexcept
+{
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        finished.notifyAll();
+    }
+    release();
+}
+
+void TaskGroup::State::release() noexcept
+{
+    if (references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete this;
+    }
+}
+
+} // namespace Threading
+} // namespace Monitor
@@ -0,0 +1,360 @@
+#pragma once
+
+#include "thread_pool.h"
+#include "../concurrent/event_count.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Monitor {
+namespace Threading {
+
+/**
+ * @brief Set of tasks on a ThreadPool that is waited for, or cancelled, as one
+ *
+ * run() queues a callable on the pool; a task run from inside a pool task
+ * lands on that worker's deque, so nested runs fork locally. wait() returns
+ * once every task of the group has finished, and meanwhile the waiting
+ * thread runs queued tasks itself, parking only when none are left to take.
+ * Waiting from inside a task therefore never ties up a worker.
+ *
+ * cancel() makes tasks that have not started yet skip their callable;
+ * running ones can poll isCancelling(). The first exception a task throws
+ * cancels the group and is rethrown by wait(). A task the pool does not
+ * accept, because it is stopped or paused or its queues are full, runs on
+ * the calling thread before run() returns. One that is dropped unrun when
+ * the pool shuts down counts as cancelled.
+ *
+ * Once wait() returns the group can be reused.
+ */
+class TaskGroup
+{
+public:
+    explicit TaskGroup(ThreadPool& pool);
+
+    /**
+     * @brief Cancels and waits for tasks still pending
+     */
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief Queue @p function as a task of this group
+     */
+    template<typename F>
+    void run(F&& function);
+
+    /**
+     * @brief Run tasks until every task of the group has finished
+     * @return False if the group was cancelled, so some tasks may have been skipped
+     * @throws The first exception thrown by a task of the group
+     */
+    bool wait();
+
+    /**
+     * @brief Skip the tasks of the group that have not started yet
+     */
+    void cancel() noexcept;
+
+    bool isCancelling() const noexcept { return m_state->cancelled.load(std::memory_order_relaxed); }
+
+    ThreadPool& getThreadPool() const noexcept { return m_pool; }
+
+private:
+    /**
+     * @brief Completion state, shared with the queued tasks
+     *
+     * Reference counted, as the last task still notifies it after the
+     * waiter may have seen the group finish and destroyed it.
+     */
+    struct State {
+        std::atomic<size_t> pending{0};
+        std::atomic<size_t> references{1};
+        std::atomic<bool> cancelled{false};
+        Concurrent::EventCount finished;
+
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        void fail(std::exception_ptr exception) noexcept;
+        void finish() noexcept;
+        void release() noexcept;
+    };
+
+    /**
+     * @brief Queued callable; finishes its group once, whether run or dropped
+     */
+    template<typename F>
+    class GroupTask
+    {
+    public:
+        template<typename G>
+        GroupTask(State* state, G&& function)
+            : m_state(state)
+            , m_function(std::forward<G>(function))
+        {}
+
+        GroupTask(GroupTask&& other) noexcept(std::is_nothrow_move_constructible_v<F>)
+            : m_state(std::exchange(other.m_state, nullptr))
+            , m_function(std::move(other.m_function))
+        {}
+
+        GroupTask(const GroupTask&) = delete;
+        GroupTask& operator=(const GroupTask&) = delete;
+
+        ~GroupTask() {
+            if (m_state) {
+                m_state->cancelled.store(true, std::memory_order_relaxed);
+                m_state->finish();
+            }
+        }
+
+        void operator()() {
+            State* state = std::exchange(m_state, nullptr);
+            if (!state->cancelled.load(std::memory_order_relaxed)) {
+                try {
+                    m_function();
+                } catch (...) {
+                    state->fail(std::current_exception());
+                }
+            }
+            state->finish();
+        }
+
+    private:
+        State* m_state;
+        F m_function;
+    };
+
+    ThreadPool& m_pool;
+    State* m_state;
+
+    static constexpr uint32_t SPIN_ITERATIONS = 64;
+    static constexpr uint32_t YIELD_ITERATIONS = 16;
+};
+
+template<typename F>
+void TaskGroup::run(F&& function)
+{
+    m_state->pending.fetch_add(1, std::memory_order_relaxed);
+    m_state->references.fetch_add(1, std::memory_order_relaxed);
+
+    Memory::SizeClassAllocator* allocator = m_pool.m_taskAllocator.get();
+    Task* task = Task::create(allocator, GroupTask<std::decay_t<F>>(m_state, std::forward<F>(function)),
+                              0, m_pool.m_nextTaskId.fetchAndAddRelaxed(1));
+    if (!m_pool.dispatch(task)) {
+        task->function();
+        Task::release(task, allocator);
+    }
+}
+
+namespace Detail {
+
+/**
+ * @brief Worker queue length under which a range is split rather than run
+ *
+ * A worker only splits while its own queue is empty, which it is again as
+ * soon as an idle sibling has stolen the last half it forked: ranges are
+ * cut about as finely as the other workers' hunger requires.
+ */
+inline constexpr size_t LAZY_SPLIT_QUEUE_SIZE = 1;
+
+/**
+ * @brief Leaf chunks per thread when no grain size is given
+ */
+inline constexpr size_t CHUNKS_PER_THREAD = 16;
+
+inline size_t defaultGrain(const ThreadPool& pool, size_t count, size_t grain)
+{
+    if (grain > 0) {
+        return grain;
+    }
+    const size_t threads = std::max<size_t>(pool.getNumThreads(), 1);
+    return std::max<size_t>(count / (threads * CHUNKS_PER_THREAD), 1);
+}
+
+/**
+ * @brief Splits allowed on a thread outside the pool, enough for a few chunks per worker
+ */
+inline int offPoolSplitDepth(const ThreadPool& pool)
+{
+    int depth = 2;
+    for (size_t threads = 1; threads < pool.getNumThreads(); threads <<= 1) {
+        ++depth;
+    }
+    return depth;
+}
+
+/**
+ * @brief Lazy binary splitting of [begin, end) within one task
+ *
+ * Runs @p leaf over grains taken from the front of the range. Before each
+ * grain, while the range is still larger than one, the back half is handed
+ * to @p fork if the worker's queue is short. A thread outside the pool
+ * cannot see a queue of its own, so it splits @p depth more times at most.
+ */
+template<typename Index, typename Leaf, typename Fork>
+void splitLazily(const TaskGroup& group, Index begin, Index end, size_t grain, int depth,
+                 Leaf&& leaf, Fork&& fork)
+{
+    const ThreadPool* pool = &group.getThreadPool();
+    while (static_cast<size_t>(end - begin) > grain) {
+        if (group.isCancelling()) {
+            return;
+        }
+
+        ThreadWorker* worker = ThreadWorker::current();
+        const bool split = (worker && worker->getThreadPool() == pool)
+            ? worker->getQueueSize() < LAZY_SPLIT_QUEUE_SIZE
+            : depth > 0;
+
+        if (split) {
+            const Index middle = begin + (end - begin) / 2;
+            --depth;
+            fork(middle, end, depth);
+            end = middle;
+        } else {
+            const Index next = begin + static_cast<Index>(grain);
+            leaf(begin, next);
+            begin = next;
+        }
+    }
+
+    if (begin < end && !group.isCancelling()) {
+        leaf(begin, end);
+    }
+}
+
+template<typename Index, typename Body>
+struct ForTask {
+    TaskGroup* group;
+    Body* body;
+    size_t grain;
+
+    void operator()(Index begin, Index end, int depth) const {
+        splitLazily(*group, begin, end, grain, depth,
+                    [this](Index first, Index last) { (*body)(first, last); },
+                    [this](Index first, Index last, int remaining) {
+                        group->run([this, first, last, remaining]() { (*this)(first, last, remaining); });
+                    });
+    }
+};
+
+template<typename Index, typename T, typename Body>
+struct ReduceTask {
+    TaskGroup* group;
+    Body* body;
+    size_t grain;
+    const T* identity;
+    std::mutex* partialsMutex;
+    std::vector<std::pair<Index, T>>* partials;
+
+    void operator()(Index begin, Index end, int depth) const {
+        // A task folds one contiguous run from begin onwards; its forks
+        // cover what follows
+        T accumulated = *identity;
+        splitLazily(*group, begin, end, grain, depth,
+                    [this, &accumulated](Index first, Index last) {
+                        accumulated = (*body)(first, last, std::move(accumulated));
+                    },
+                    [this](Index first, Index last, int remaining) {
+                        group->run([this, first, last, remaining]() { (*this)(first, last, remaining); });
+                    });
+
+        std::lock_guard<std::mutex> lock(*partialsMutex);
+        partials->emplace_back(begin, std::move(accumulated));
+    }
+};
+
+} // namespace Detail
+
+/**
+ * @brief Call @p body(first, last) over disjoint subranges covering [begin, end)
+ *
+ * Subranges are cut by lazy binary splitting: a task keeps running grains
+ * of @p grain indices from the front of its range and forks off the back
+ * half only while its worker's queue is empty, so the range is divided
+ * no further than idle workers steal it. @p grain defaults to about
+ * CHUNKS_PER_THREAD grains per pool thread. The calling thread runs tasks
+ * until all are done. Cancelling @p group stops further grains.
+ *
+ * @return False if the group was cancelled
+ * @throws The first exception thrown by @p body
+ */
+template<typename Index, typename Body>
+bool parallelFor(TaskGroup& group, Index begin, Index end, Body&& body, size_t grain = 0)
+{
+    static_assert(std::is_integral_v<Index>, "parallelFor iterates over an integer range");
+
+    if (!(begin < end)) {
+        return group.wait();
+    }
+
+    ThreadPool& pool = group.getThreadPool();
+    Detail::ForTask<Index, std::remove_reference_t<Body>> task{
+        &group, &body, Detail::defaultGrain(pool, static_cast<size_t>(end - begin), grain)};
+    group.run([&task, begin, end, depth = Detail::offPoolSplitDepth(pool)]() { task(begin, end, depth); });
+    return group.wait();
+}
+
+template<typename Index, typename Body>
+bool parallelFor(ThreadPool& pool, Index begin, Index end, Body&& body, size_t grain = 0)
+{
+    TaskGroup group(pool);
+    return parallelFor(group, begin, end, std::forward<Body>(body), grain);
+}
+
+/**
+ * @brief Fold [begin, end) in parallel
+ *
+ * Each task starts from @p identity and folds consecutive grains with
+ * @p body(first, last, accumulated), which returns the new value. The
+ * partial results are then merged in index order with @p combine(left,
+ * right), so @p combine must be associative but need not be commutative.
+ * Ranges are split as by parallelFor().
+ *
+ * @throws The first exception thrown by @p body, or std::runtime_error if
+ *         the pool dropped some of the work while shutting down
+ */
+template<typename Index, typename T, typename Body, typename Combine>
+T parallelReduce(ThreadPool& pool, Index begin, Index end, T identity, Body&& body, Combine&& combine,
+                 size_t grain = 0)
+{
+    static_assert(std::is_integral_v<Index>, "parallelReduce folds over an integer range");
+
+    if (!(begin < end)) {
+        return identity;
+    }
+
+    std::mutex partialsMutex;
+    std::vector<std::pair<Index, T>> partials;
+
+    TaskGroup group(pool);
+    Detail::ReduceTask<Index, T, std::remove_reference_t<Body>> task{
+        &group, &body, Detail::defaultGrain(pool, static_cast<size_t>(end - begin), grain),
+        &identity, &partialsMutex, &partials};
+    group.run([&task, begin, end, depth = Detail::offPoolSplitDepth(pool)]() { task(begin, end, depth); });
+
+    if (!group.wait()) {
+        throw std::runtime_error("parallelReduce was cancelled before covering its range");
+    }
+
+    std::sort(partials.begin(), partials.end(),
+              [](const auto& left, const auto& right) { return left.first < right.first; });
+
+    T result = std::move(identity);
+    for (auto& partial : partials) {
+        result = combine(std::move(result), std::move(partial.second));
+    }
+    return result;
+}
+
+} // namespace Threading
+} // namespace Monitor
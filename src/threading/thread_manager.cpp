@@ -350,6 +350,28 @@ void ThreadManager::setGlobalLoadBalancingEnabled(bool enabled)
     }
 }
 
+void ThreadManager::setOptimalCpuAffinityForPool(const QString& poolName)
+{
+    ThreadPool* pool = getThreadPool(poolName);
+    if (!pool) {
+        qWarning() << "ThreadManager: Cannot set affinity of unknown pool" << poolName;
+        return;
+    }
+    
+    pool->setCpuAffinityPattern(generateOptimalCpuAffinityPattern(pool->getNumThreads()));
+}
+
+void ThreadManager::setCpuAffinityPattern(const QString& poolName, const std::vector<int>& coreIds)
+{
+    ThreadPool* pool = getThreadPool(poolName);
+    if (!pool) {
+        qWarning() << "ThreadManager: Cannot set affinity of unknown pool" << poolName;
+        return;
+    }
+    
+    pool->setCpuAffinityPattern(coreIds);
+}
+
 void ThreadManager::enablePerformanceMonitoring(bool enabled)
 {
     m_performanceMonitoringEnabled = enabled;
@@ -435,6 +457,22 @@ size_t ThreadManager::detectOptimalThreadCount() const
     return optimal;
 }
 
+std::vector<int> ThreadManager::generateOptimalCpuAffinityPattern(size_t numThreads) const
+{
+    // Separate physical cores before SMT siblings, filling one node first
+    const CpuSet order = CpuTopology::system().spreadOrder();
+    std::vector<int> pattern;
+    if (order.empty()) {
+        return pattern;
+    }
+    
+    pattern.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        pattern.push_back(order[i % order.size()]);
+    }
+    return pattern;
+}
+
 double ThreadManager::calculateCpuUsage() const
 {
     // This is a simplified implementation
@@ -7,21 +7,45 @@
 namespace Monitor {
 namespace Threading {
 
+namespace {
+
+Memory::SizeClassAllocator::Config taskAllocatorConfig(size_t taskBlocks)
+{
+    Memory::SizeClassAllocator::Config config;
+    config.blockCounts.fill(0);
+    config.blockCounts[Task::BLOCK_CLASS] = taskBlocks;
+    return config;
+}
+
+/**
+ * @brief Per-thread xorshift64 for picking workers without shared state
+ */
+uint64_t nextRandom()
+{
+    thread_local uint64_t state = 0x9E3779B97F4A7C15ULL ^
+        static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+} // namespace
+
 ThreadPool::ThreadPool(QObject* parent)
     : QObject(parent)
+    , m_taskAllocator(std::make_unique<Memory::SizeClassAllocator>(taskAllocatorConfig(TASK_BLOCKS)))
     , m_schedulingPolicy(SchedulingPolicy::WorkStealing)
     , m_isRunning(false)
     , m_isPaused(false)
     , m_nextTaskId(1)
     , m_nextWorkerIndex(0)
     , m_workStealingEnabled(true)
-    , m_stealingAttempts(0)
-    , m_successfulSteals(0)
+    , m_forwardTaskCompleted(false)
+    , m_forwardTaskStolen(false)
     , m_loadBalancingEnabled(true)
     , m_loadBalanceTimer(nullptr)
-    , m_randomGenerator(m_randomDevice())
     , m_idleWorkerCount(0)
-    , m_totalTasksCompleted(0)
 {
     m_loadBalanceTimer = new QTimer(this);
     m_loadBalanceTimer->setInterval(DEFAULT_LOAD_BALANCE_INTERVAL_MS);
@@ -56,20 +80,17 @@ bool ThreadPool::initialize(size_t numThreads)
             auto worker = std::make_unique<ThreadWorker>(static_cast<int>(i), this, this);
             
             // Connect worker signals
-            connect(worker.get(), &ThreadWorker::taskCompleted, 
-                    this, &ThreadPool::onTaskCompleted);
             connect(worker.get(), &ThreadWorker::workerIdle, 
                     this, &ThreadPool::onWorkerIdle);
             connect(worker.get(), &ThreadWorker::workerBusy, 
                     this, &ThreadPool::onWorkerBusy);
-            connect(worker.get(), &ThreadWorker::taskStolen,
-                    this, &ThreadPool::onTaskStolen);
+            forwardWorkerSignals(worker.get());
             
             m_workers.push_back(std::move(worker));
         }
         
-        // Initialize random distribution
-        m_randomDistribution = std::uniform_int_distribution<size_t>(0, numThreads - 1);
+        // Workers start out idle
+        m_idleWorkerCount.store(m_workers.size(), std::memory_order_relaxed);
         
         qInfo() << "ThreadPool initialized successfully with" << numThreads << "workers";
         return true;
@@ -168,9 +189,7 @@ void ThreadPool::resume()
     }
     
     // Wake up all workers
-    for (auto& worker : m_workers) {
-        worker->wakeUp();
-    }
+    m_wakeEvent.notifyAll();
 }
 
 bool ThreadPool::submitTask(TaskFunction function, int priority)
@@ -179,14 +198,33 @@ bool ThreadPool::submitTask(TaskFunction function, int priority)
         return false;
     }
     
-    auto task = std::make_shared<Task>(std::move(function), priority, 
-                                     m_nextTaskId.fetchAndAddRelaxed(1));
-    return submitTask(task);
+    return enqueue(Task::create(m_taskAllocator.get(), std::move(function), priority,
+                                m_nextTaskId.fetchAndAddRelaxed(1)));
 }
 
 bool ThreadPool::submitTask(TaskPtr task)
 {
-    if (!task || !m_isRunning.loadRelaxed() || m_isPaused.loadRelaxed()) {
+    if (!task || !task->function || !m_isRunning.loadRelaxed() || m_isPaused.loadRelaxed()) {
+        return false;
+    }
+    
+    // The caller keeps its handle, so the queued task shares it
+    return enqueue(Task::create(m_taskAllocator.get(), [task]() { task->function(); },
+                                task->priority, task->id));
+}
+
+bool ThreadPool::enqueue(Task* task)
+{
+    if (!dispatch(task)) {
+        Task::release(task, m_taskAllocator.get());
+        return false;
+    }
+    return true;
+}
+
+bool ThreadPool::dispatch(Task* task)
+{
+    if (!task->function || !m_isRunning.loadRelaxed() || m_isPaused.loadRelaxed()) {
         return false;
     }
     
@@ -196,25 +234,21 @@ bool ThreadPool::submitTask(TaskPtr task)
         return false;
     }
     
-    bool success = selectedWorker->addTask(task);
+    if (selectedWorker->post(task)) {
+        return true;
+    }
     
-    if (!success) {
-        // If primary worker is full, try work stealing or alternative workers
-        if (m_workStealingEnabled) {
-            for (auto& worker : m_workers) {
-                if (worker.get() != selectedWorker && worker->addTask(task)) {
-                    success = true;
-                    break;
-                }
+    // If the primary worker's inbox is full, try the others
+    if (isWorkStealingEnabled()) {
+        for (auto& worker : m_workers) {
+            if (worker.get() != selectedWorker && worker->post(task)) {
+                return true;
             }
         }
     }
     
-    if (!success) {
-        qWarning() << "Failed to submit task - all workers busy";
-    }
-    
-    return success;
+    qWarning() << "Failed to submit task - all workers busy";
+    return false;
 }
 
 bool ThreadPool::submitTasks(const std::vector<TaskPtr>& tasks)
@@ -244,7 +278,11 @@ size_t ThreadPool::getTotalQueueSize() const
 
 size_t ThreadPool::getTotalTasksProcessed() const
 {
-    return m_totalTasksCompleted.load(std::memory_order_relaxed);
+    size_t totalProcessed = 0;
+    for (const auto& worker : m_workers) {
+        totalProcessed += worker->getTasksProcessed();
+    }
+    return totalProcessed;
 }
 
 size_t ThreadPool::getTotalTasksStolen() const
@@ -314,6 +352,18 @@ void ThreadPool::setWorkerCpuAffinity(size_t workerIndex, int coreId)
     }
 }
 
+void ThreadPool::setWorkerCpuSets(const std::vector<CpuSet>& cpuSets)
+{
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        m_workers[i]->setCpuSet(cpuSets.empty() ? CpuSet{} : cpuSets[i % cpuSets.size()]);
+    }
+}
+
+bool ThreadPool::placeTaskMemoryOnNumaNode(int node)
+{
+    return m_taskAllocator->placeOnNumaNode(node);
+}
+
 void ThreadPool::setLoadBalanceInterval(int intervalMs)
 {
     if (m_loadBalanceTimer) {
@@ -335,58 +385,119 @@ ThreadWorker* ThreadPool::selectWorker(int priority)
             return m_workers[index].get();
         }
         
-        case SchedulingPolicy::LeastLoaded:
-            return findLeastLoadedWorker();
-        
-        case SchedulingPolicy::Random: {
-            size_t index = m_randomDistribution(m_randomGenerator);
-            return m_workers[index].get();
+        case SchedulingPolicy::LeastLoaded: {
+            // The less loaded of two random workers balances nearly as well
+            // as scanning all of them, and reads only two queue sizes
+            ThreadWorker* first = m_workers[nextRandom() % m_workers.size()].get();
+            ThreadWorker* second = m_workers[nextRandom() % m_workers.size()].get();
+            return second->getQueueSize() < first->getQueueSize() ? second : first;
         }
         
+        case SchedulingPolicy::Random:
+            return m_workers[nextRandom() % m_workers.size()].get();
+        
         case SchedulingPolicy::WorkStealing:
-        default:
-            // For work stealing, start with least loaded then rely on stealing
-            return findLeastLoadedWorker();
+        default: {
+            // Forked tasks stay on the forking worker's deque until stolen
+            ThreadWorker* current = ThreadWorker::current();
+            if (current && current->getThreadPool() == this) {
+                return current;
+            }
+            return m_workers[nextRandom() % m_workers.size()].get();
+        }
     }
 }
 
-ThreadWorker* ThreadPool::findLeastLoadedWorker()
+Task* ThreadPool::stealFor(ThreadWorker* thief)
 {
-    if (m_workers.empty()) {
+    const size_t count = m_workers.size();
+    if (count < 2 || !isWorkStealingEnabled()) {
         return nullptr;
     }
     
-    ThreadWorker* leastLoaded = m_workers[0].get();
-    size_t minQueueSize = leastLoaded->getQueueSize();
-    
-    for (size_t i = 1; i < m_workers.size(); ++i) {
-        size_t queueSize = m_workers[i]->getQueueSize();
-        if (queueSize < minQueueSize) {
-            minQueueSize = queueSize;
-            leastLoaded = m_workers[i].get();
+    size_t index = thief->nextRandom() % count;
+    for (size_t i = 0; i < count; ++i, index = (index + 1 == count) ? 0 : index + 1) {
+        ThreadWorker* victim = m_workers[index].get();
+        if (victim == thief) {
+            continue;
+        }
+        if (Task* task = victim->steal()) {
+            emit thief->taskStolen(victim->getWorkerId(), thief->getWorkerId());
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+bool ThreadPool::runPendingTask()
+{
+    ThreadWorker* current = ThreadWorker::current();
+    if (current && current->getThreadPool() == this) {
+        Task* task = current->nextTask();
+        if (task) {
+            current->execute(task);
         }
+        return task != nullptr;
+    }
+    
+    // Any other thread takes the oldest task of a random worker, whatever
+    // the stealing setting, and runs it on that worker's account
+    const size_t count = m_workers.size();
+    if (count == 0) {
+        return false;
     }
     
-    return leastLoaded;
+    size_t index = nextRandom() % count;
+    for (size_t i = 0; i < count; ++i, index = (index + 1 == count) ? 0 : index + 1) {
+        ThreadWorker* victim = m_workers[index].get();
+        if (Task* task = victim->steal()) {
+            victim->execute(task);
+            return true;
+        }
+    }
+    return false;
 }
 
-void ThreadPool::attemptWorkStealing(ThreadWorker* idleWorker)
+bool ThreadPool::hasStealableWork() const
 {
-    if (!m_workStealingEnabled || !idleWorker) {
-        return;
+    if (!isWorkStealingEnabled()) {
+        return false;
+    }
+    for (const auto& worker : m_workers) {
+        if (worker->getQueueSize() > 0) {
+            return true;
+        }
     }
+    return false;
+}
+
+void ThreadPool::connectNotify(const QMetaMethod& signal)
+{
+    QObject::connectNotify(signal);
     
-    m_stealingAttempts.fetch_add(1);
+    if (signal == QMetaMethod::fromSignal(&ThreadPool::taskCompleted) && !m_forwardTaskCompleted) {
+        m_forwardTaskCompleted = true;
+    } else if (signal == QMetaMethod::fromSignal(&ThreadPool::workStealingOccurred) && !m_forwardTaskStolen) {
+        m_forwardTaskStolen = true;
+    } else {
+        return;
+    }
     
-    // Find a worker with tasks to steal from
     for (auto& worker : m_workers) {
-        if (worker.get() != idleWorker && worker->getQueueSize() > 1) {
-            TaskPtr stolenTask = worker->stealTask();
-            if (stolenTask && idleWorker->addTask(stolenTask)) {
-                m_successfulSteals.fetch_add(1);
-                break;
-            }
-        }
+        forwardWorkerSignals(worker.get());
+    }
+}
+
+void ThreadPool::forwardWorkerSignals(ThreadWorker* worker)
+{
+    // UniqueConnection makes repeated calls for the same worker harmless
+    if (m_forwardTaskCompleted) {
+        connect(worker, &ThreadWorker::taskCompleted,
+                this, &ThreadPool::onTaskCompleted, Qt::UniqueConnection);
+    }
+    if (m_forwardTaskStolen) {
+        connect(worker, &ThreadWorker::taskStolen,
+                this, &ThreadPool::onTaskStolen, Qt::UniqueConnection);
     }
 }
 
@@ -404,20 +515,12 @@ void ThreadPool::checkPoolState()
 
 void ThreadPool::onTaskCompleted(size_t taskId, qint64 executionTimeUs)
 {
-    m_totalTasksCompleted.fetch_add(1);
     emit taskCompleted(taskId, executionTimeUs);
-    checkPoolState();
 }
 
 void ThreadPool::onWorkerIdle()
 {
-    ThreadWorker* worker = qobject_cast<ThreadWorker*>(sender());
     m_idleWorkerCount.fetch_add(1);
-    
-    if (m_workStealingEnabled && worker) {
-        attemptWorkStealing(worker);
-    }
-    
     checkPoolState();
 }
 
@@ -438,33 +541,14 @@ void ThreadPool::performLoadBalancing()
         return;
     }
     
-    // Simple load balancing: identify overloaded workers and help them
-    auto queueSizes = getWorkerQueueSizes();
-    if (queueSizes.empty()) {
-        return;
+    // Idle workers steal for themselves; this only reports the pool state
+    // and, as a backstop, wakes parked workers while tasks are queued
+    if (m_idleWorkerCount.load(std::memory_order_relaxed) > 0 && getTotalQueueSize() > 0) {
+        m_wakeEvent.notifyAll();
     }
     
-    // Find average queue size
-    size_t totalSize = 0;
-    for (size_t size : queueSizes) {
-        totalSize += size;
-    }
-    double averageSize = static_cast<double>(totalSize) / queueSizes.size();
-    
-    // If imbalance is significant, trigger work stealing for overloaded workers
-    for (size_t i = 0; i < queueSizes.size(); ++i) {
-        if (queueSizes[i] > averageSize * 1.5 && queueSizes[i] > 10) {
-            // Find an idle worker to help
-            for (size_t j = 0; j < m_workers.size(); ++j) {
-                if (i != j && m_workers[j]->isIdle()) {
-                    attemptWorkStealing(m_workers[j].get());
-                    break;
-                }
-            }
-        }
-    }
+    checkPoolState();
 }
 
 } // namespace Threading  
 } // namespace Monitor
-
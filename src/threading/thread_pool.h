@@ -1,18 +1,35 @@
 #pragma once
 
 #include "thread_worker.h"
+#include "../concurrent/event_count.h"
+#include "../memory/size_class_allocator.h"
 #include <QtCore/QObject>
-#include <QtCore/QMutex>
+#include <QtCore/QMetaMethod>
 #include <QtCore/QAtomicInteger>
 #include <QtCore/QTimer>
 #include <vector>
 #include <memory>
 #include <atomic>
-#include <random>
+#include <future>
 
 namespace Monitor {
 namespace Threading {
 
+/**
+ * @brief Pool of work-stealing ThreadWorkers
+ *
+ * Tasks are placed in blocks of a pool-owned SizeClassAllocator and
+ * queued by pointer. Under WorkStealing, a task submitted from one of the
+ * pool's own workers goes onto that worker's deque, so fork/join code
+ * keeps its subtasks local until an idle sibling steals them; tasks from
+ * other threads are posted to a worker picked at random, or by the other
+ * policies. Idle workers steal from random victims and park on one
+ * EventCount shared by the pool.
+ *
+ * taskCompleted and workStealingOccurred are forwarded from the workers
+ * only while something is connected to them, as each one is a queued
+ * call per task.
+ */
 class ThreadPool : public QObject
 {
     Q_OBJECT
@@ -35,8 +52,8 @@ public:
     void setSchedulingPolicy(SchedulingPolicy policy) { m_schedulingPolicy = policy; }
     SchedulingPolicy getSchedulingPolicy() const { return m_schedulingPolicy; }
     
-    void setWorkStealingEnabled(bool enabled) { m_workStealingEnabled = enabled; }
-    bool isWorkStealingEnabled() const { return m_workStealingEnabled; }
+    void setWorkStealingEnabled(bool enabled) { m_workStealingEnabled.store(enabled, std::memory_order_relaxed); }
+    bool isWorkStealingEnabled() const { return m_workStealingEnabled.load(std::memory_order_relaxed); }
     
     // Task submission
     bool submitTask(TaskFunction function, int priority = 0);
@@ -45,6 +62,16 @@ public:
     template<typename F, typename... Args>
     auto submitTask(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>>;
     
+    /**
+     * @brief Submit a callable without a future
+     *
+     * The callable is moved straight into the pooled task, so one whose
+     * captures fit TaskCallable's buffer is queued without any allocation.
+     * Called from one of this pool's workers, this is the fork of fork/join.
+     */
+    template<typename F>
+    bool submitDetached(F&& function, int priority = 0);
+    
     // Batch operations
     bool submitTasks(const std::vector<TaskPtr>& tasks);
     
@@ -68,6 +95,16 @@ public:
     void setCpuAffinityPattern(const std::vector<int>& coreIds);
     void setWorkerCpuAffinity(size_t workerIndex, int coreId);
     
+    /**
+     * @brief Run worker i on @p cpuSets[i % size]; an empty list lets them all float
+     */
+    void setWorkerCpuSets(const std::vector<CpuSet>& cpuSets);
+    
+    /**
+     * @brief Keep the blocks queued tasks are placed in on NUMA node @p node
+     */
+    bool placeTaskMemoryOnNumaNode(int node);
+    
     // Load balancing
     void enableLoadBalancing(bool enabled) { m_loadBalancingEnabled = enabled; }
     void setLoadBalanceInterval(int intervalMs);
@@ -78,6 +115,9 @@ signals:
     void poolSaturated(size_t totalQueueSize);
     void poolIdle();
 
+protected:
+    void connectNotify(const QMetaMethod& signal) override;
+
 private slots:
     void onTaskCompleted(size_t taskId, qint64 executionTimeUs);
     void onWorkerIdle();
@@ -86,41 +126,72 @@ private slots:
     void performLoadBalancing();
 
 private:
+    friend class ThreadWorker;
+    friend class TaskGroup;
+    
+    /**
+     * @brief Queue a task from Task::create(); releases it if the pool is
+     *        not accepting tasks or no worker takes it
+     */
+    bool enqueue(Task* task);
+    
+    /**
+     * @brief Queue a task like enqueue(), but leave it with the caller on failure
+     */
+    bool dispatch(Task* task);
+    
+    /**
+     * @brief Run one queued task on the calling thread
+     *
+     * A worker of this pool takes its next task as it would in its own loop;
+     * any other thread takes the oldest task of a random worker.
+     * @return False if no queued task was found
+     */
+    bool runPendingTask();
     ThreadWorker* selectWorker(int priority = 0);
-    ThreadWorker* findLeastLoadedWorker();
-    void initializeWorkStealing();
-    void attemptWorkStealing(ThreadWorker* idleWorker);
+    
+    /**
+     * @brief Steal one task for @p thief, trying victims from a random one onwards
+     */
+    Task* stealFor(ThreadWorker* thief);
+    
+    /**
+     * @brief Whether any worker has queued tasks an idle worker may steal
+     */
+    bool hasStealableWork() const;
+    
+    void forwardWorkerSignals(ThreadWorker* worker);
     void checkPoolState();
     
+    // Declared before the workers, whose queued tasks live in its blocks
+    std::unique_ptr<Memory::SizeClassAllocator> m_taskAllocator;
+    Concurrent::EventCount m_wakeEvent;
+    
     std::vector<std::unique_ptr<ThreadWorker>> m_workers;
     SchedulingPolicy m_schedulingPolicy;
     
-    mutable QMutex m_statsMutex;
     QAtomicInteger<bool> m_isRunning;
     QAtomicInteger<bool> m_isPaused;
     QAtomicInteger<size_t> m_nextTaskId;
     QAtomicInteger<size_t> m_nextWorkerIndex;
     
     // Work stealing
-    bool m_workStealingEnabled;
-    std::atomic<size_t> m_stealingAttempts;
-    std::atomic<size_t> m_successfulSteals;
+    std::atomic<bool> m_workStealingEnabled;
+    
+    // Signals forwarded per task, connected on demand
+    bool m_forwardTaskCompleted;
+    bool m_forwardTaskStolen;
     
     // Load balancing
     bool m_loadBalancingEnabled;
     QTimer* m_loadBalanceTimer;
     
-    // Random number generator for random scheduling
-    std::random_device m_randomDevice;
-    std::mt19937 m_randomGenerator;
-    std::uniform_int_distribution<size_t> m_randomDistribution;
-    
     // Pool state tracking
     std::atomic<size_t> m_idleWorkerCount;
-    std::atomic<size_t> m_totalTasksCompleted;
     
     static constexpr size_t MIN_THREADS = 1;
     static constexpr size_t MAX_THREADS = 64;
+    static constexpr size_t TASK_BLOCKS = 8192;
     static constexpr int DEFAULT_LOAD_BALANCE_INTERVAL_MS = 100;
     static constexpr size_t SATURATION_THRESHOLD = 500;
 };
@@ -133,7 +204,7 @@ auto ThreadPool::submitTask(F&& f, Args&&... args) -> std::future<std::invoke_re
     auto taskPromise = std::make_shared<std::promise<ReturnType>>();
     auto future = taskPromise->get_future();
     
-    auto task = std::make_shared<Task>([taskPromise, f = std::forward<F>(f), args...]() mutable {
+    Task* task = Task::create(m_taskAllocator.get(), [taskPromise, f = std::forward<F>(f), args...]() mutable {
         try {
             if constexpr (std::is_void_v<ReturnType>) {
                 f(args...);
@@ -147,7 +218,7 @@ auto ThreadPool::submitTask(F&& f, Args&&... args) -> std::future<std::invoke_re
         }
     }, 0, m_nextTaskId.fetchAndAddRelaxed(1));
     
-    if (!submitTask(task)) {
+    if (!enqueue(task)) {
         // If submission fails, set exception
         taskPromise->set_exception(std::make_exception_ptr(
             std::runtime_error("Failed to submit task to thread pool")));
@@ -156,5 +227,16 @@ auto ThreadPool::submitTask(F&& f, Args&&... args) -> std::future<std::invoke_re
     return future;
 }
 
+template<typename F>
+bool ThreadPool::submitDetached(F&& function, int priority)
+{
+    if (!m_isRunning.loadRelaxed() || m_isPaused.loadRelaxed()) {
+        return false;
+    }
+    
+    return enqueue(Task::create(m_taskAllocator.get(), std::forward<F>(function), priority,
+                                m_nextTaskId.fetchAndAddRelaxed(1)));
+}
+
 } // namespace Threading  
 } // namespace Monitor
\ No newline at end of file
@@ -1,33 +1,33 @@
 #include "thread_worker.h"
 #include "thread_pool.h"
 #include <QtCore/QDebug>
+#include <algorithm>
 #include <thread>
 
-#ifdef Q_OS_LINUX
-#include <pthread.h>
-#include <sched.h>
-#elif defined(Q_OS_WIN)
-#include <Windows.h>
-#elif defined(Q_OS_MAC)
-#include <pthread.h>
-#include <mach/thread_policy.h>
-#include <mach/thread_act.h>
-#endif
-
 namespace Monitor {
 namespace Threading {
 
+namespace {
+thread_local ThreadWorker* t_currentWorker = nullptr;
+}
+
 ThreadWorker::ThreadWorker(int workerId, ThreadPool* pool, QObject* parent)
     : QThread(parent)
     , m_workerId(workerId)
     , m_threadPool(pool)
+    , m_taskAllocator(pool ? pool->m_taskAllocator.get() : nullptr)
+    , m_deque(DEQUE_CAPACITY)
+    , m_inbox(INBOX_CAPACITY)
+    , m_wakeEvent(pool ? &pool->m_wakeEvent : &m_ownWakeEvent)
     , m_isRunning(false)
     , m_shouldStop(false)
     , m_isIdle(true)
     , m_tasksProcessed(0)
     , m_tasksStolen(0)
-    , m_cpuAffinity(-1)
-    , m_totalTaskTime(0)
+    , m_cpuSetChanged(false)
+    , m_pinned(false)
+    , m_randomState(0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(workerId + 1))
+    , m_totalTaskTimeNs(0)
 {
 }
 
@@ -35,6 +35,12 @@ ThreadWorker::~ThreadWorker()
 {
     stop();
     wait();
+    
+    // Tasks still queued are dropped unrun, as before
+    Task* task = nullptr;
+    while (m_deque.pop(task) || m_inbox.tryPop(task)) {
+        Task::release(task, m_taskAllocator);
+    }
 }
 
 void ThreadWorker::start(Priority priority)
@@ -47,191 +53,296 @@ void ThreadWorker::start(Priority priority)
 void ThreadWorker::stop()
 {
     m_shouldStop.storeRelaxed(true);
-    wakeUp();
+    m_wakeEvent->notifyAll();
 }
 
 void ThreadWorker::wakeUp()
 {
-    QMutexLocker locker(&m_queueMutex);
-    m_wakeCondition.wakeOne();
+    m_wakeEvent->notifyAll();
 }
 
 bool ThreadWorker::addTask(TaskPtr task)
 {
-    if (!task || m_shouldStop.loadRelaxed()) {
+    if (!task || !task->function || m_shouldStop.loadRelaxed()) {
         return false;
     }
     
-    QMutexLocker locker(&m_queueMutex);
-    
-    if (m_taskQueue.size() >= MAX_QUEUE_SIZE) {
+    // The caller keeps its handle, so the queued task shares it
+    Task* queued = Task::create(m_taskAllocator, [task]() { task->function(); }, task->priority, task->id);
+    if (!post(queued)) {
+        Task::release(queued, m_taskAllocator);
         return false; // Queue full
     }
-    
-    m_taskQueue.push(task);
-    
-    if (m_isIdle.loadRelaxed()) {
-        m_wakeCondition.wakeOne();
-    }
-    
     return true;
 }
 
 TaskPtr ThreadWorker::stealTask()
 {
-    QMutexLocker locker(&m_queueMutex);
-    
-    if (m_taskQueue.empty()) {
+    Task* task = steal();
+    if (!task) {
         return nullptr;
     }
     
-    // Create a temporary vector to extract tasks
-    std::vector<TaskPtr> tasks;
-    while (!m_taskQueue.empty()) {
-        tasks.push_back(m_taskQueue.top());
-        m_taskQueue.pop();
+    Memory::SizeClassAllocator* allocator = m_taskAllocator;
+    return TaskPtr(task, [allocator](Task* stolen) { Task::release(stolen, allocator); });
+}
+
+bool ThreadWorker::post(Task* task)
+{
+    if (m_shouldStop.loadRelaxed()) {
+        return false;
     }
     
-    if (tasks.empty()) {
-        return nullptr;
+    if (t_currentWorker == this) {
+        m_deque.push(task);
+    } else if (!m_inbox.tryPush(task)) {
+        return false;
     }
     
-    // Take the lowest priority task (for work stealing)
-    TaskPtr stolenTask = tasks.back();
-    tasks.pop_back();
-    
-    // Put the rest back
-    for (auto& task : tasks) {
-        m_taskQueue.push(task);
+    notifyWork();
+    return true;
+}
+
+Task* ThreadWorker::steal()
+{
+    Task* task = nullptr;
+    if (m_deque.steal(task) || m_inbox.tryPop(task)) {
+        m_tasksStolen.fetchAndAddRelaxed(1);
+        return task;
     }
-    
-    m_tasksStolen.fetchAndAddRelaxed(1);
-    return stolenTask;
+    return nullptr;
+}
+
+ThreadWorker* ThreadWorker::current()
+{
+    return t_currentWorker;
 }
 
 size_t ThreadWorker::getQueueSize() const
 {
-    QMutexLocker locker(&m_queueMutex);
-    return m_taskQueue.size();
+    return m_deque.size() + m_inbox.size();
 }
 
 double ThreadWorker::getAverageTaskTime() const
 {
-    QMutexLocker locker(&m_statsMutex);
     size_t processed = m_tasksProcessed.loadRelaxed();
     if (processed == 0) {
         return 0.0;
     }
-    return static_cast<double>(m_totalTaskTime.count()) / processed;
+    return static_cast<double>(m_totalTaskTimeNs.load(std::memory_order_relaxed)) / processed;
 }
 
 void ThreadWorker::setCpuAffinity(int coreId)
 {
-    m_cpuAffinity = coreId;
-    
-    if (isRunning() && coreId >= 0) {
-#ifdef Q_OS_LINUX
-        cpu_set_t cpuset;
-        CPU_ZERO(&cpuset);
-        CPU_SET(coreId, &cpuset);
-        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
-#elif defined(Q_OS_WIN)
-        SetThreadAffinityMask(GetCurrentThread(), 1ULL << coreId);
-#elif defined(Q_OS_MAC)
-        thread_affinity_policy_data_t policy = { coreId };
-        thread_policy_set(pthread_mach_thread_np(pthread_self()),
-                          THREAD_AFFINITY_POLICY,
-                          (thread_policy_t)&policy,
-                          THREAD_AFFINITY_POLICY_COUNT);
-#endif
-    }
+    setCpuSet(coreId >= 0 ? CpuSet{coreId} : CpuSet{});
 }
 
-void ThreadWorker::run()
+int ThreadWorker::getCpuAffinity() const
 {
-    // Set CPU affinity if specified
-    if (m_cpuAffinity >= 0) {
-        setCpuAffinity(m_cpuAffinity);
+    std::lock_guard<std::mutex> lock(m_cpuSetMutex);
+    return m_cpuSet.size() == 1 ? m_cpuSet.front() : -1;
+}
+
+void ThreadWorker::setCpuSet(const CpuSet& cpus)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_cpuSetMutex);
+        m_cpuSet = cpus;
+        m_cpuSetChanged.store(true, std::memory_order_relaxed);
     }
     
-    m_isRunning.storeRelaxed(true);
-    
-    while (!m_shouldStop.loadRelaxed()) {
-        processTaskQueue();
-        
-        if (!m_shouldStop.loadRelaxed()) {
-            // Wait for new tasks or timeout
-            QMutexLocker locker(&m_queueMutex);
-            if (m_taskQueue.empty()) {
-                updateIdleState(true);
-                m_wakeCondition.wait(&m_queueMutex, IDLE_TIMEOUT_MS);
-                updateIdleState(false);
-            }
-        }
+    // A parked worker applies it once woken
+    if (m_isRunning.loadRelaxed()) {
+        m_wakeEvent->notifyAll();
     }
-    
-    m_isRunning.storeRelaxed(false);
 }
 
-void ThreadWorker::processTaskQueue()
+CpuSet ThreadWorker::getCpuSet() const
+{
+    std::lock_guard<std::mutex> lock(m_cpuSetMutex);
+    return m_cpuSet;
+}
+
+void ThreadWorker::run()
 {
+    m_isRunning.storeRelaxed(true);
+    t_currentWorker = this;
+    applyCpuSet();
+    
+    Concurrent::SpinWait backoff(SPIN_ITERATIONS, YIELD_ITERATIONS);
+    
     while (!m_shouldStop.loadRelaxed()) {
-        TaskPtr currentTask;
-        
-        // Get next task
-        {
-            QMutexLocker locker(&m_queueMutex);
-            if (m_taskQueue.empty()) {
-                break;
-            }
-            currentTask = m_taskQueue.top();
-            m_taskQueue.pop();
+        if (m_cpuSetChanged.load(std::memory_order_relaxed)) {
+            applyCpuSet();
         }
         
-        if (!currentTask || !currentTask->function) {
+        if (Task* task = nextTask()) {
+            updateIdleState(false);
+            execute(task);
+            backoff.reset();
             continue;
         }
         
-        // Execute task with timing
-        auto startTime = std::chrono::high_resolution_clock::now();
-        
-        try {
-            currentTask->function();
-        } catch (const std::exception& e) {
-            qWarning() << "Task execution error in worker" << m_workerId << ":" << e.what();
-        } catch (...) {
-            qWarning() << "Unknown task execution error in worker" << m_workerId;
+        if (!backoff.idle()) {
+            continue;
         }
         
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto executionTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
-        auto executionTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(executionTime).count();
-        
-        // Update statistics
-        {
-            QMutexLocker locker(&m_statsMutex);
-            m_totalTaskTime += executionTime;
+        // Park; a task posted or pushed after prepareWait() cancels or ends the wait
+        auto key = m_wakeEvent->prepareWait();
+        if (m_shouldStop.loadRelaxed() || hasPendingWork()) {
+            m_wakeEvent->cancelWait();
+        } else {
+            updateIdleState(true);
+            m_wakeEvent->wait(key);
         }
-        
-        m_tasksProcessed.fetchAndAddRelaxed(1);
-        
-        // Emit completion signal
-        emit taskCompleted(currentTask->id, executionTimeUs);
+        backoff.reset();
+    }
+    
+    t_currentWorker = nullptr;
+    m_isRunning.storeRelaxed(false);
+}
+
+Task* ThreadWorker::nextTask()
+{
+    Task* task = nullptr;
+    if (m_deque.pop(task)) {
+        return task;
+    }
+    
+    if (drainInbox() && m_deque.pop(task)) {
+        return task;
+    }
+    
+    return m_threadPool ? m_threadPool->stealFor(this) : nullptr;
+}
+
+bool ThreadWorker::drainInbox()
+{
+    Task* batch[INBOX_BATCH];
+    const size_t count = m_inbox.tryPopBatch(batch, INBOX_BATCH);
+    if (count == 0) {
+        return false;
+    }
+    
+    // Newest first, then a stable insertion sort by ascending priority: the
+    // bottom of the deque ends up holding the oldest of the most urgent tasks
+    std::reverse(batch, batch + count);
+    for (size_t i = 1; i < count; ++i) {
+        Task* task = batch[i];
+        size_t j = i;
+        for (; j > 0 && batch[j - 1]->priority > task->priority; --j) {
+            batch[j] = batch[j - 1];
+        }
+        batch[j] = task;
+    }
+    
+    for (size_t i = 0; i < count; ++i) {
+        m_deque.push(batch[i]);
+    }
+    
+    // The batch is stealable now; let a parked sibling have some of it
+    if (count > 1) {
+        notifyWork();
+    }
+    return true;
+}
+
+void ThreadWorker::execute(Task* task)
+{
+    // Execute task with timing
+    auto startTime = std::chrono::steady_clock::now();
+    
+    try {
+        task->function();
+    } catch (const std::exception& e) {
+        qWarning() << "Task execution error in worker" << m_workerId << ":" << e.what();
+    } catch (...) {
+        qWarning() << "Unknown task execution error in worker" << m_workerId;
+    }
+    
+    auto executionTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    auto executionTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(executionTime).count();
+    
+    const size_t taskId = task->id;
+    Task::release(task, m_taskAllocator);
+    
+    // Update statistics
+    m_totalTaskTimeNs.fetch_add(executionTime.count(), std::memory_order_relaxed);
+    m_tasksProcessed.fetchAndAddRelaxed(1);
+    
+    // Queued to the receiver's thread only while something is connected
+    emit taskCompleted(taskId, executionTimeUs);
+}
+
+bool ThreadWorker::hasPendingWork() const
+{
+    if (getQueueSize() > 0) {
+        return true;
+    }
+    return m_threadPool && m_threadPool->hasStealableWork();
+}
+
+void ThreadWorker::notifyWork()
+{
+    // Without stealing only this worker can run the task, so wake them all
+    if (m_threadPool && !m_threadPool->isWorkStealingEnabled()) {
+        m_wakeEvent->notifyAll();
+    } else {
+        m_wakeEvent->notifyOne();
     }
 }
 
 void ThreadWorker::updateIdleState(bool idle)
 {
-    bool wasIdle = m_isIdle.loadRelaxed();
+    if (m_isIdle.loadRelaxed() == idle) {
+        return;
+    }
     m_isIdle.storeRelaxed(idle);
     
-    if (idle && !wasIdle) {
+    if (idle) {
         emit workerIdle();
-    } else if (!idle && wasIdle) {
+    } else {
         emit workerBusy();
     }
 }
 
+void ThreadWorker::applyCpuSet()
+{
+    CpuSet cpus;
+    {
+        std::lock_guard<std::mutex> lock(m_cpuSetMutex);
+        m_cpuSetChanged.store(false, std::memory_order_relaxed);
+        cpus = m_cpuSet;
+    }
+    
+    // Clearing the set only needs undoing an earlier pin
+    const bool pin = !cpus.empty();
+    if (!pin) {
+        if (!m_pinned) {
+            return;
+        }
+        for (const CpuTopology::Cpu& cpu : CpuTopology::system().cpus()) {
+            cpus.push_back(cpu.id);
+        }
+    }
+    
+    if (pinCurrentThread(cpus)) {
+        m_pinned = pin;
+    } else {
+        qWarning() << "Worker" << m_workerId << "could not be pinned to CPUs" << CpuTopology::formatCpuList(cpus);
+    }
+}
+
+uint64_t ThreadWorker::nextRandom()
+{
+    // xorshift64
+    m_randomState ^= m_randomState << 13;
+    m_randomState ^= m_randomState >> 7;
+    m_randomState ^= m_randomState << 17;
+    return m_randomState;
+}
+
 } // namespace Threading  
 } // namespace Monitor
 
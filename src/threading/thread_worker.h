@@ -1,13 +1,18 @@
 #pragma once
 
+#include "inline_function.h"
+#include "cpu_topology.h"
+#include "../concurrent/chase_lev_deque.h"
+#include "../concurrent/mpsc_ring_buffer.h"
+#include "../concurrent/event_count.h"
+#include "../memory/size_class_allocator.h"
 #include <QtCore/QObject>
 #include <QtCore/QThread>
-#include <QtCore/QMutex>
-#include <QtCore/QWaitCondition>
 #include <QtCore/QAtomicInteger>
+#include <atomic>
 #include <functional>
-#include <queue>
 #include <memory>
+#include <mutex>
 #include <chrono>
 
 namespace Monitor {
@@ -15,30 +20,69 @@ namespace Threading {
 
 using TaskFunction = std::function<void()>;
 
+/**
+ * @brief Callable type stored in a Task; 40 bytes keep a Task in one cache line
+ */
+using TaskCallable = InlineFunction<40>;
+
 struct Task {
-    TaskFunction function;
-    int priority;
-    std::chrono::steady_clock::time_point enqueueTime;
-    size_t id;
-    
+    TaskCallable function;
+    size_t id = 0;
+    int priority = 0;
+
+    /// Pool block class tasks are placed in
+    static constexpr Memory::SizeClass::Index BLOCK_CLASS = Memory::SizeClass::forSize(64);
+
     Task() = default;
-    Task(TaskFunction func, int prio = 0, size_t taskId = 0)
-        : function(std::move(func))
-        , priority(prio)
-        , enqueueTime(std::chrono::steady_clock::now())
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F&& func, int prio = 0, size_t taskId = 0)
+        : function(std::forward<F>(func))
         , id(taskId)
+        , priority(prio)
     {}
-    
+
     bool operator<(const Task& other) const {
         // Higher priority values have higher precedence
         return priority < other.priority;
     }
+
+    /**
+     * @brief Construct a task in a block of @p allocator, or on the heap without one
+     */
+    template<typename F>
+    static Task* create(Memory::SizeClassAllocator* allocator, F&& func, int prio, size_t taskId);
+
+    /**
+     * @brief Destroy a task from create() and return its block
+     */
+    static void release(Task* task, Memory::SizeClassAllocator* allocator) noexcept;
 };
 
+static_assert(sizeof(Task) <= Memory::SizeClass::blockSize(Task::BLOCK_CLASS),
+              "A task must fit its pool block");
+
+/**
+ * @brief Legacy shared task handle, accepted by addTask() and ThreadPool::submitTask()
+ */
 using TaskPtr = std::shared_ptr<Task>;
 
 class ThreadPool; // Forward declaration
 
+/**
+ * @brief Worker thread with a work-stealing task deque
+ *
+ * Tasks the worker submits itself, forked from a running task, go onto
+ * the bottom of its Chase-Lev deque and come back off the bottom, newest
+ * first. Other threads post tasks to a bounded lock-free inbox, which the
+ * worker moves onto its deque in batches, highest priority last so it
+ * runs first. When both are empty the worker steals from the top of a
+ * randomly chosen sibling's deque or inbox, and once there is nothing to
+ * steal it spins briefly and parks on its pool's EventCount.
+ *
+ * Queued tasks are pointers to Task objects placed in pool blocks, so
+ * queueing, popping and stealing allocate nothing and take no lock.
+ */
 class ThreadWorker : public QThread
 {
     Q_OBJECT
@@ -46,24 +90,53 @@ class ThreadWorker : public QThread
 public:
     explicit ThreadWorker(int workerId, ThreadPool* pool, QObject* parent = nullptr);
     ~ThreadWorker() override;
-    
+
     void start(Priority priority = NormalPriority);
     void stop();
     void wakeUp();
-    
+
     bool addTask(TaskPtr task);
     TaskPtr stealTask(); // For work stealing
-    
+
+    /**
+     * @brief Queue a task from create(); from this worker's own thread it
+     *        goes onto the deque, from any other into the inbox
+     * @return False if the worker is stopping or its inbox is full; the task is not taken then
+     */
+    bool post(Task* task);
+
+    /**
+     * @brief Take a task from the top of the deque, or else from the inbox
+     */
+    Task* steal();
+
+    /**
+     * @brief Worker running on the calling thread, or nullptr
+     */
+    static ThreadWorker* current();
+
+    int getWorkerId() const { return m_workerId; }
+    ThreadPool* getThreadPool() const { return m_threadPool; }
+
     // Statistics
     size_t getQueueSize() const;
     size_t getTasksProcessed() const { return m_tasksProcessed.loadRelaxed(); }
     size_t getTasksStolen() const { return m_tasksStolen.loadRelaxed(); }
     double getAverageTaskTime() const;
     bool isIdle() const { return m_isIdle.loadRelaxed(); }
-    
+
     // CPU affinity control
     void setCpuAffinity(int coreId);
-    int getCpuAffinity() const { return m_cpuAffinity; }
+    int getCpuAffinity() const;
+    
+    /**
+     * @brief Restrict the worker to @p cpus, or let it run anywhere if empty
+     *
+     * Takes effect when the thread starts, or at the running thread's next
+     * loop iteration.
+     */
+    void setCpuSet(const CpuSet& cpus);
+    CpuSet getCpuSet() const;
 
 signals:
     void taskCompleted(size_t taskId, qint64 executionTimeUs);
@@ -75,39 +148,77 @@ protected:
     void run() override;
 
 private:
-    void processTaskQueue();
+    friend class ThreadPool;
+
+    Task* nextTask();
+    bool drainInbox();
+    void execute(Task* task);
+    bool hasPendingWork() const;
+    void notifyWork();
     void updateIdleState(bool idle);
-    
-    struct TaskComparator {
-        bool operator()(const TaskPtr& a, const TaskPtr& b) const {
-            return *a < *b; // Use Task's operator<
-        }
-    };
-    
-    using TaskQueue = std::priority_queue<TaskPtr, std::vector<TaskPtr>, TaskComparator>;
-    
+    void applyCpuSet();
+    uint64_t nextRandom();
+
     int m_workerId;
     ThreadPool* m_threadPool;
-    
-    mutable QMutex m_queueMutex;
-    QWaitCondition m_wakeCondition;
-    TaskQueue m_taskQueue;
-    
+    Memory::SizeClassAllocator* m_taskAllocator;    ///< The pool's, or nullptr to use the heap
+
+    Concurrent::ChaseLevDeque<Task*> m_deque;       ///< Pushed and popped by this worker only
+    Concurrent::MPSCRingBuffer<Task*> m_inbox;      ///< Tasks posted by other threads
+    Concurrent::EventCount m_ownWakeEvent;          ///< Parks a worker without a pool
+    Concurrent::EventCount* m_wakeEvent;            ///< The pool's, shared by all its workers
+
     QAtomicInteger<bool> m_isRunning;
     QAtomicInteger<bool> m_shouldStop;
     QAtomicInteger<bool> m_isIdle;
     QAtomicInteger<size_t> m_tasksProcessed;
     QAtomicInteger<size_t> m_tasksStolen;
-    
-    int m_cpuAffinity;
-    
+
+    mutable std::mutex m_cpuSetMutex;
+    CpuSet m_cpuSet;
+    std::atomic<bool> m_cpuSetChanged;
+    bool m_pinned;                                  ///< Worker thread only
+    uint64_t m_randomState;                         ///< Victim selection, this worker only
+
     // Performance tracking
-    std::chrono::nanoseconds m_totalTaskTime;
-    mutable QMutex m_statsMutex;
-    
-    static constexpr size_t MAX_QUEUE_SIZE = 1000;
-    static constexpr int IDLE_TIMEOUT_MS = 100;
+    std::atomic<int64_t> m_totalTaskTimeNs;
+
+    static constexpr size_t DEQUE_CAPACITY = 256;
+    static constexpr size_t INBOX_CAPACITY = 1024;
+    static constexpr size_t INBOX_BATCH = 64;
+    static constexpr uint32_t SPIN_ITERATIONS = 64;
+    static constexpr uint32_t YIELD_ITERATIONS = 16;
 };
 
-} // namespace Threading  
-} // namespace Monitor
\ No newline at end of file
+template<typename F>
+Task* Task::create(Memory::SizeClassAllocator* allocator, F&& func, int prio, size_t taskId)
+{
+    void* block = allocator ? allocator->allocate(BLOCK_CLASS) : nullptr;
+    if (!block) {
+        block = ::operator new(sizeof(Task));
+    }
+
+    try {
+        return new (block) Task(std::forward<F>(func), prio, taskId);
+    } catch (...) {
+        if (allocator && allocator->owns(BLOCK_CLASS, block)) {
+            allocator->deallocate(BLOCK_CLASS, block);
+        } else {
+            ::operator delete(block);
+        }
+        throw;
+    }
+}
+
+inline void Task::release(Task* task, Memory::SizeClassAllocator* allocator) noexcept
+{
+    task->~Task();
+    if (allocator && allocator->owns(BLOCK_CLASS, task)) {
+        allocator->deallocate(BLOCK_CLASS, task);
+    } else {
+        ::operator delete(task);
+    }
+}
+
+} // namespace Threading
+} // namespace Monitor
@@ -251,8 +251,17 @@ bool SettingsManager::loadWorkspace(const QString &workspacePath)
         return false;
     }
     
+    const QJsonObject topologyJson = workspaceData["topology"].toObject();
+    const Monitor::Threading::PipelineTopology topology = parsePipelineTopology(topologyJson);
+    {
+        QMutexLocker locker(&m_settingsMutex);
+        m_workspaceTopology = topologyJson;
+        m_pipelineTopology = topology;
+    }
+    
     m_currentWorkspacePath = path;
     addRecentWorkspace(path);
+    emit pipelineTopologyChanged(topology);
     emit workspaceLoaded(path, true);
     emit workspaceChanged(path);
     
@@ -276,9 +285,51 @@ QJsonObject SettingsManager::createWorkspaceJson(const QString &name) const
     workspace["testFramework"] = QJsonObject();
     workspace["globalSettings"] = QJsonObject();
     
+    {
+        QMutexLocker locker(&m_settingsMutex);
+        workspace["topology"] = m_workspaceTopology;
+    }
+    
     return workspace;
 }
 
+QJsonObject SettingsManager::getWorkspaceTopology() const
+{
+    QMutexLocker locker(&m_settingsMutex);
+    return m_workspaceTopology;
+}
+
+void SettingsManager::setWorkspaceTopology(const QJsonObject &topology)
+{
+    const Monitor::Threading::PipelineTopology pipelineTopology = parsePipelineTopology(topology);
+    {
+        QMutexLocker locker(&m_settingsMutex);
+        m_workspaceTopology = topology;
+        m_pipelineTopology = pipelineTopology;
+        m_settingsDirty = true;
+    }
+    emit settingsChanged("workspace/topology", topology.toVariantMap());
+    emit pipelineTopologyChanged(pipelineTopology);
+}
+
+Monitor::Threading::PipelineTopology SettingsManager::getPipelineTopology() const
+{
+    QMutexLocker locker(&m_settingsMutex);
+    return m_pipelineTopology;
+}
+
+Monitor::Threading::PipelineTopology SettingsManager::parsePipelineTopology(const QJsonObject &json) const
+{
+    Monitor::Threading::PipelineTopology topology;
+    QStringList errors;
+    if (!topology.fromJson(json, &errors)) {
+        for (const QString &error : errors) {
+            qCWarning(settingsManager) << "Workspace topology:" << error;
+        }
+    }
+    return topology;
+}
+
 bool SettingsManager::saveWorkspaceToFile(const QString &filePath, const QJsonObject &data)
 {
     QFile file(filePath);
@@ -16,6 +16,8 @@
 #include <QMutexLocker>
 #include <QStandardPaths>
 
+#include "../../threading/pipeline_topology.h"
+
 // Forward declarations
 class MainWindow;
 class TabManager;
@@ -46,6 +48,11 @@ public:
     QString getCurrentWorkspacePath() const { return m_currentWorkspacePath; }
     QString getCurrentWorkspaceName() const;
     
+    // Pipeline placement ("topology" section, see Monitor::Threading::PipelineTopology)
+    QJsonObject getWorkspaceTopology() const;
+    void setWorkspaceTopology(const QJsonObject &topology);
+    Monitor::Threading::PipelineTopology getPipelineTopology() const;
+    
     // Recent workspaces
     QStringList getRecentWorkspaces() const;
     void addRecentWorkspace(const QString &path);
@@ -106,6 +113,8 @@ signals:
     void workspaceChanged(const QString &workspacePath);
     void workspaceSaved(const QString &workspacePath, bool success);
     void workspaceLoaded(const QString &workspacePath, bool success);
+    // Parsed "topology" section, for PacketManager::setTopology(), NetworkConfig and CaptureRecorder
+    void pipelineTopologyChanged(const Monitor::Threading::PipelineTopology &topology);
     void themeChanged(const QString &themeName);
     void autoSaveCompleted(bool success);
     void settingsValidationFailed(const QString &error);
@@ -135,6 +144,7 @@ private:
         QJsonObject widgets;
         QJsonObject testFramework;
         QJsonObject globalSettings;
+        QJsonObject topology;
     };
 
     // Settings initialization
@@ -154,6 +164,7 @@ private:
     QJsonObject createWorkspaceJson(const QString &name) const;
     bool saveWorkspaceToFile(const QString &filePath, const QJsonObject &data);
     QJsonObject loadWorkspaceFromFile(const QString &filePath);
+    Monitor::Threading::PipelineTopology parsePipelineTopology(const QJsonObject &json) const;
     bool isValidWorkspaceFile(const QString &filePath) const;
     QString generateWorkspaceName() const;
     
@@ -184,6 +195,8 @@ private:
     // File system paths
     SettingsFiles m_files;
     QString m_currentWorkspacePath;
+    QJsonObject m_workspaceTopology;
+    Monitor::Threading::PipelineTopology m_pipelineTopology;
     
     // Auto-save functionality
     QTimer *m_autoSaveTimer;
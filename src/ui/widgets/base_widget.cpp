@@ -34,6 +34,8 @@ BaseWidget::BaseWidget(const QString& widgetId, const QString& windowTitle, QWid
     , m_updatePending(false)
     , m_maxUpdateRate(60) // 60 FPS default
     , m_lastUpdateTime(std::chrono::steady_clock::now())
+    , m_packetDelivery(PacketDelivery::EveryPacket)
+    , m_latestValueTimer(new QTimer(this))
     , m_contextMenu(new QMenu(this))
     , m_settingsAction(nullptr)
     , m_clearFieldsAction(nullptr)
@@ -258,16 +260,40 @@ bool BaseWidget::subscribeToPacket(Monitor::Packet::PacketId packetId) {
             return true; // Already subscribed
         }
         
+        // Current-value widgets poll the latest packet instead of subscribing
+        if (m_packetDelivery == PacketDelivery::LatestValue) {
+            if (!m_subscriptionManager->watchLatest(packetId)) {
+                Monitor::Logging::Logger::instance()->error("BaseWidget", 
+                    QString("Failed to watch packet ID %1 for widget '%2'").arg(packetId).arg(m_widgetId));
+                return false;
+            }
+            
+            m_subscriptions[packetId] = 0;
+            m_latestValues[packetId] = LatestValue();
+            updateLatestValueTimer();
+            
+            Monitor::Logging::Logger::instance()->debug("BaseWidget", 
+                QString("Widget '%1' watching latest packet ID %2").arg(m_widgetId).arg(packetId));
+            return true;
+        }
+        
         // Create subscription
         std::string subscriberName = QString("Widget_%1").arg(m_widgetId).toStdString();
-        auto callback = [this](Monitor::Packet::PacketPtr packet) {
-            // Schedule update on main thread
-            QMetaObject::invokeMethod(this, [this, packet]() {
-                onPacketReceived(packet);
-            }, Qt::QueuedConnection);
+        auto callback = [this](const Monitor::Packet::PacketPtr& packet) {
+            onPacketReceived(packet);
         };
         
-        auto subscriptionId = m_subscriptionManager->subscribe(subscriberName, packetId, callback);
+        // Packets wait in a bounded mailbox drained on the widget's thread, one
+        // queued call per drain; a widget that falls behind, such as one in a
+        // hidden tab, loses its oldest packets without holding up the router
+        Monitor::Packet::SubscriptionManager::SubscriptionOptions options;
+        options.policy = Monitor::Packet::SubscriptionManager::DeliveryPolicy::DropOldest;
+        options.mailboxCapacity = 1024;
+        options.executor = [this](std::function<void()> drain) {
+            QMetaObject::invokeMethod(this, std::move(drain), Qt::QueuedConnection);
+        };
+        
+        auto subscriptionId = m_subscriptionManager->subscribe(subscriberName, packetId, callback, options);
         if (subscriptionId == 0) {
             Monitor::Logging::Logger::instance()->error("BaseWidget", 
                 QString("Failed to subscribe widget '%1' to packet ID %2").arg(m_widgetId).arg(packetId));
@@ -293,8 +319,11 @@ bool BaseWidget::unsubscribeFromPacket(Monitor::Packet::PacketId packetId) {
         if (m_subscriptionManagerMock) {
             m_subscriptionManagerMock->unsubscribe(it->second);
         }
-    } else {
-        if (m_subscriptionManager) {
+    } else if (m_subscriptionManager) {
+        if (m_latestValues.erase(packetId) > 0) {
+            m_subscriptionManager->unwatchLatest(packetId);
+            updateLatestValueTimer();
+        } else {
             m_subscriptionManager->unsubscribe(it->second);
         }
     }
@@ -320,8 +349,14 @@ void BaseWidget::clearSubscriptions() {
             return;
         }
         for (const auto& pair : m_subscriptions) {
-            m_subscriptionManager->unsubscribe(pair.second);
+            if (m_latestValues.count(pair.first) > 0) {
+                m_subscriptionManager->unwatchLatest(pair.first);
+            } else {
+                m_subscriptionManager->unsubscribe(pair.second);
+            }
         }
+        m_latestValues.clear();
+        updateLatestValueTimer();
     }
     
     m_subscriptions.clear();
@@ -472,6 +507,7 @@ void BaseWidget::setMaxUpdateRate(int fps) {
         // Update timer interval
         int intervalMs = 1000 / fps;
         m_updateTimer->setInterval(intervalMs);
+        m_latestValueTimer->setInterval(intervalMs);
         
         Monitor::Logging::Logger::instance()->debug("BaseWidget", 
             QString("Widget '%1' max update rate set to %2 FPS").arg(m_widgetId).arg(fps));
@@ -507,6 +543,9 @@ void BaseWidget::setupUpdateTimer() {
     m_updateTimer->setSingleShot(true);
     connect(m_updateTimer, &QTimer::timeout, this, &BaseWidget::onUpdateTimer);
     
+    m_latestValueTimer->setSingleShot(false);
+    connect(m_latestValueTimer, &QTimer::timeout, this, &BaseWidget::onLatestValueTimer);
+    
     // Set initial interval
     setMaxUpdateRate(m_maxUpdateRate);
 }
@@ -595,6 +634,7 @@ void BaseWidget::showEvent(QShowEvent* event) {
     if (m_updateEnabled && !m_fieldAssignments.empty()) {
         refreshDisplay();
     }
+    updateLatestValueTimer();
 }
 
 void BaseWidget::hideEvent(QHideEvent* event) {
@@ -606,6 +646,7 @@ void BaseWidget::hideEvent(QHideEvent* event) {
     if (m_updateTimer->isActive()) {
         m_updateTimer->stop();
     }
+    updateLatestValueTimer();
 }
 
 void BaseWidget::closeEvent(QCloseEvent* event) {
@@ -637,7 +678,7 @@ bool BaseWidget::hasField(const QString& fieldPath) const {
     return findFieldAssignment(fieldPath) != nullptr;
 }
 
-void BaseWidget::onPacketReceived(Monitor::Packet::PacketPtr packet) {
+void BaseWidget::onPacketReceived(const Monitor::Packet::PacketPtr& packet) {
     if (!packet || !m_updateEnabled || !m_isVisible) {
         return;
     }
@@ -702,6 +743,60 @@ void BaseWidget::performUpdate() {
     emit updatePerformed();
 }
 
+void BaseWidget::setPacketDelivery(PacketDelivery delivery) {
+    if (m_packetDelivery == delivery) {
+        return;
+    }
+    
+    // Move existing subscriptions over to the new delivery
+    const QList<Monitor::Packet::PacketId> packets = getSubscribedPackets();
+    clearSubscriptions();
+    m_packetDelivery = delivery;
+    for (Monitor::Packet::PacketId packetId : packets) {
+        subscribeToPacket(packetId);
+    }
+}
+
+Monitor::Packet::PacketPtr BaseWidget::takeLatestPacket(Monitor::Packet::PacketId packetId) {
+    auto it = m_latestValues.find(packetId);
+    if (it == m_latestValues.end() || !it->second.fresh || !m_subscriptionManager) {
+        return Monitor::Packet::PacketPtr();
+    }
+    
+    it->second.fresh = false;
+    return m_subscriptionManager->latestPacket(packetId);
+}
+
+void BaseWidget::onLatestValueTimer() {
+    if (m_updateEnabled && m_isVisible && pollLatestValues()) {
+        performUpdate();
+    }
+}
+
+bool BaseWidget::pollLatestValues() {
+    // One atomic load per watched ID and frame, however many packets arrived
+    bool changed = false;
+    for (auto& pair : m_latestValues) {
+        const uint64_t version = m_subscriptionManager->latestVersion(pair.first);
+        if (version != pair.second.version) {
+            pair.second.version = version;
+            pair.second.fresh = true;
+            m_statistics.packetsReceived++;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+void BaseWidget::updateLatestValueTimer() {
+    const bool needed = m_isVisible && !m_latestValues.empty();
+    if (needed && !m_latestValueTimer->isActive()) {
+        m_latestValueTimer->start(1000 / m_maxUpdateRate);
+    } else if (!needed && m_latestValueTimer->isActive()) {
+        m_latestValueTimer->stop();
+    }
+}
+
 void BaseWidget::processFieldExtraction() {
     // This could be optimized with batched extraction in the future
     // For now, extraction is handled on-demand by concrete widgets
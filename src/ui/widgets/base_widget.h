@@ -25,8 +25,8 @@ namespace Monitor::Packet {
     class FieldExtractor;
     class SubscriptionManagerMock;
     class FieldExtractorMock;
-    class Packet;
-    using PacketPtr = std::shared_ptr<Packet>;
+    class PacketHandle;
+    using PacketPtr = PacketHandle;
     using SubscriberId = uint64_t;
     using PacketId = uint32_t;
 }
@@ -40,6 +40,7 @@ namespace Monitor::Packet {
  * - Drag-and-drop field assignment
  * - Settings persistence
  * - Update throttling for performance
+ * - Latest-value polling for widgets that show current values only
  * - Context menu framework
  * 
  * This class follows the Template Method pattern, with concrete widgets implementing
@@ -103,6 +104,14 @@ public:
             : fieldPath(path), displayName(path), packetId(pktId), isActive(true) {}
     };
 
+    /**
+     * @brief How subscribed packets reach the widget
+     */
+    enum class PacketDelivery {
+        EveryPacket,    ///< Each packet is delivered through a subscription mailbox
+        LatestValue     ///< The latest packet per ID is polled once per frame
+    };
+
     explicit BaseWidget(const QString& widgetId, const QString& windowTitle, QWidget* parent = nullptr);
     ~BaseWidget() override;
 
@@ -138,6 +147,7 @@ public:
     bool isUpdateEnabled() const { return m_updateEnabled; }
     void setMaxUpdateRate(int fps);
     int getMaxUpdateRate() const { return m_maxUpdateRate; }
+    PacketDelivery getPacketDelivery() const { return m_packetDelivery; }
 
 public slots:
     void onSettingsChanged();
@@ -185,6 +195,10 @@ protected:
     const FieldAssignment* findFieldAssignment(const QString& fieldPath) const;
     bool hasField(const QString& fieldPath) const;
 
+    // Latest-value delivery: set by current-value widgets, usually in their constructor
+    void setPacketDelivery(PacketDelivery delivery);
+    Monitor::Packet::PacketPtr takeLatestPacket(Monitor::Packet::PacketId packetId);
+
     // Access to managers
     Monitor::Packet::SubscriptionManager* getSubscriptionManager() const { return m_subscriptionManager; }
     Monitor::Packet::FieldExtractor* getFieldExtractor() const { return m_fieldExtractor; }
@@ -193,9 +207,12 @@ protected:
     QMenu* getContextMenu() const { return m_contextMenu; }
 
 private slots:
-    // Internal packet processing
-    void onPacketReceived(Monitor::Packet::PacketPtr packet);
     void onUpdateTimer();
+    void onLatestValueTimer();
+    
+private:
+    // Internal packet processing, on the GUI thread
+    void onPacketReceived(const Monitor::Packet::PacketPtr& packet);
     
 protected:
     // Field management (accessible to derived classes)
@@ -223,6 +240,15 @@ private:
     int m_maxUpdateRate;
     std::chrono::steady_clock::time_point m_lastUpdateTime;
 
+    // Latest-value delivery, polled by m_latestValueTimer at the update rate
+    struct LatestValue {
+        uint64_t version = 0;       ///< Publish count last seen
+        bool fresh = false;         ///< Changed since the last takeLatestPacket()
+    };
+    PacketDelivery m_packetDelivery;
+    QTimer* m_latestValueTimer;
+    std::unordered_map<Monitor::Packet::PacketId, LatestValue> m_latestValues;
+
     // Context menu
     QMenu* m_contextMenu;
     QAction* m_settingsAction;
@@ -242,6 +268,8 @@ private:
     void setupBaseContextMenu();
     void performUpdate();
     void processFieldExtraction();
+    bool pollLatestValues();
+    void updateLatestValueTimer();
     bool validateFieldAssignment(const QString& fieldPath, Monitor::Packet::PacketId packetId) const;
     QString generateUniqueDisplayName(const QString& baseName) const;
 };
@@ -112,6 +112,9 @@ BarChartWidget::BarChartWidget(const QString& widgetId, QWidget* parent)
     // Initialize bar chart configuration
     m_barConfig = BarChartConfig();
     
+    // Bars track current values; poll the latest packets rather than every one
+    setPacketDelivery(PacketDelivery::LatestValue);
+    
     // Setup real-time update timer
     m_realTimeTimer->setSingleShot(false);
     m_realTimeTimer->setInterval(m_barConfig.updateInterval);
@@ -124,6 +124,9 @@ PieChartWidget::PieChartWidget(const QString& widgetId, QWidget* parent)
     // Initialize pie chart configuration
     m_pieConfig = PieChartConfig();
     
+    // Slices are sized from current values only
+    setPacketDelivery(PacketDelivery::LatestValue);
+    
     // Setup real-time update timer
     m_realTimeTimer->setSingleShot(false);
     m_realTimeTimer->setInterval(m_pieConfig.updateInterval);
@@ -28,6 +28,7 @@
 #include <cmath>
 #include <numeric>
 #include <algorithm>
+#include <type_traits>
 
 DisplayWidget::DisplayWidget(const QString& widgetId, const QString& windowTitle, QWidget* parent)
     : BaseWidget(widgetId, windowTitle, parent)
@@ -54,6 +55,7 @@ void DisplayWidget::setDisplayConfig(const QString& fieldPath, const DisplayConf
     }
     
     m_displayConfigs[fieldPath] = config;
+    m_kernels.erase(fieldPath);
     
     // Trigger display update for this field
     auto it = m_fieldValues.find(fieldPath);
@@ -77,6 +79,7 @@ void DisplayWidget::resetDisplayConfig(const QString& fieldPath) {
     auto it = m_displayConfigs.find(fieldPath);
     if (it != m_displayConfigs.end()) {
         it->second = DisplayConfig();
+        m_kernels.erase(fieldPath);
         
         // Trigger display update
         auto valueIt = m_fieldValues.find(fieldPath);
@@ -199,6 +202,7 @@ void DisplayWidget::handleFieldAdded(const FieldAssignment& field) {
 void DisplayWidget::handleFieldRemoved(const QString& fieldPath) {
     m_fieldValues.erase(fieldPath);
     m_displayConfigs.erase(fieldPath);
+    m_kernels.erase(fieldPath);
     
     clearFieldDisplay(fieldPath);
     
@@ -209,6 +213,7 @@ void DisplayWidget::handleFieldRemoved(const QString& fieldPath) {
 void DisplayWidget::handleFieldsCleared() {
     m_fieldValues.clear();
     m_displayConfigs.clear();
+    m_kernels.clear();
     
     refreshAllDisplays();
     
@@ -286,6 +291,7 @@ bool DisplayWidget::restoreWidgetSpecificSettings(const QJsonObject& settings) {
         config.customDisplayName = configObj.value("customDisplayName").toString();
         
         m_displayConfigs[fieldPath] = config;
+        m_kernels.erase(fieldPath);
     }
     
     // Restore trigger condition
@@ -353,6 +359,7 @@ void DisplayWidget::onResetFieldFormatting() {
     for (auto& pair : m_displayConfigs) {
         pair.second = DisplayConfig();
     }
+    m_kernels.clear();
     
     // Mark all values for update
     for (auto& pair : m_fieldValues) {
@@ -365,6 +372,31 @@ void DisplayWidget::onResetFieldFormatting() {
         QString("Formatting reset for widget '%1'").arg(getWidgetId()));
 }
 
+namespace {
+
+QVariant toVariant(const Monitor::Packet::FieldExtractor::FieldValue& value) {
+    return std::visit([](const auto& field) -> QVariant {
+        using T = std::decay_t<decltype(field)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+            return QString::fromStdString(field);
+        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
+            return QByteArray(reinterpret_cast<const char*>(field.data()), static_cast<int>(field.size()));
+        } else if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t>) {
+            return static_cast<int>(field);
+        } else if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>) {
+            return static_cast<uint>(field);
+        } else if constexpr (std::is_same_v<T, int64_t>) {
+            return static_cast<qlonglong>(field);
+        } else if constexpr (std::is_same_v<T, uint64_t>) {
+            return static_cast<qulonglong>(field);
+        } else {
+            return field;
+        }
+    }, value);
+}
+
+} // namespace
+
 void DisplayWidget::extractAndUpdateFieldValues() {
     PROFILE_SCOPE("DisplayWidget::extractAndUpdateFieldValues");
     
@@ -380,12 +412,28 @@ void DisplayWidget::extractAndUpdateFieldValues() {
         fieldsByPacket[assignment.packetId].push_back(assignment.fieldPath);
     }
     
-    // Extract fields for each packet type
-    // Note: This is a simplified version - in a real implementation,
-    // we would need to get the latest packets for each type
-    
-    // For now, we'll simulate field updates
-    // This would be replaced with actual packet field extraction
+    // Extract fields for each packet type from its latest packet; only
+    // latest-value widgets have one, and only when it changed this frame
+    for (const auto& pair : fieldsByPacket) {
+        const Monitor::Packet::PacketPtr packet = takeLatestPacket(pair.first);
+        if (!packet) {
+            continue;
+        }
+        
+        std::vector<std::string> fieldNames;
+        fieldNames.reserve(pair.second.size());
+        for (const QString& fieldPath : pair.second) {
+            fieldNames.push_back(fieldPath.toStdString());
+        }
+        
+        const auto results = extractor->extractFields(packet, fieldNames);
+        for (size_t i = 0; i < fieldNames.size(); ++i) {
+            auto result = results.find(fieldNames[i]);
+            if (result != results.end() && result->second.success) {
+                updateFieldValue(pair.second[i], toVariant(result->second.value));
+            }
+        }
+    }
 }
 
 void DisplayWidget::processFieldTransformations() {
@@ -398,7 +446,6 @@ void DisplayWidget::processFieldTransformations() {
         if (fieldValue.hasNewValue) {
             QVariant transformed = transformValue(fieldPath, fieldValue.currentValue);
             fieldValue.transformedValue = transformed;
-            fieldValue.addToHistory(fieldValue.currentValue);
         }
     }
 }
@@ -431,27 +478,94 @@ QVariant DisplayWidget::transformValue(const QString& fieldPath, const QVariant&
     }
     
     const DisplayConfig& config = configIt->second;
+    
     QVariant value = rawValue;
     
-    // Apply type conversion
+    // Numeric values go through the field's compiled kernel, which keeps
+    // the function's window of transformed values
+    bool numeric = false;
+    const double number = rawValue.toDouble(&numeric);
+    if (numeric && (config.mathOp != MathOperation::None || config.function != FunctionType::None)) {
+        auto kernelIt = m_kernels.find(fieldPath);
+        if (kernelIt == m_kernels.end()) {
+            kernelIt = m_kernels.emplace(fieldPath, compileKernel(config)).first;
+        }
+        
+        const double result = kernelIt->second.apply(number);
+        if (std::isnan(result)) {
+            return QVariant();
+        }
+        value = result;
+    }
+    
+    // Apply type conversion to what is displayed
     if (config.conversion != ConversionType::NoConversion) {
         value = convertValue(value, config.conversion);
     }
     
-    // Apply mathematical operation
-    if (config.mathOp != MathOperation::None) {
-        value = applyMathOperation(value, config.mathOp, config.mathOperand);
+    return value;
+}
+
+Monitor::Packet::TransformKernel DisplayWidget::compileKernel(const DisplayConfig& config) {
+    Monitor::Packet::TransformKernel kernel;
+    const double operand = config.mathOperand;
+    switch (config.mathOp) {
+        case MathOperation::None:
+            break;
+        case MathOperation::Multiply:
+            kernel.multiply(operand);
+            break;
+        case MathOperation::Divide:
+            kernel.divide(operand);
+            break;
+        case MathOperation::Add:
+            kernel.add(operand);
+            break;
+        case MathOperation::Subtract:
+            kernel.add(-operand);
+            break;
+        case MathOperation::Modulo:
+            kernel.modulo(operand);
+            break;
+        case MathOperation::Power:
+            kernel.power(operand);
+            break;
+        case MathOperation::Absolute:
+            kernel.absolute();
+            break;
+        case MathOperation::Negate:
+            kernel.negate();
+            break;
     }
     
-    // Apply function (requires history)
-    if (config.function != FunctionType::None) {
-        auto fieldIt = m_fieldValues.find(fieldPath);
-        if (fieldIt != m_fieldValues.end()) {
-            value = applyFunction(fieldIt->second.history, config.function);
-        }
+    const size_t window = static_cast<size_t>(std::max(config.functionWindow, 1));
+    switch (config.function) {
+        case FunctionType::None:
+            break;
+        case FunctionType::Difference:
+            kernel.difference();
+            break;
+        case FunctionType::CumulativeSum:
+            kernel.cumulativeSum();
+            break;
+        case FunctionType::MovingAverage:
+            kernel.movingAverage(window);
+            break;
+        case FunctionType::Minimum:
+            kernel.movingMinimum(window);
+            break;
+        case FunctionType::Maximum:
+            kernel.movingMaximum(window);
+            break;
+        case FunctionType::Range:
+            kernel.movingRange(window);
+            break;
+        case FunctionType::StandardDeviation:
+            kernel.movingStandardDeviation(window);
+            break;
     }
     
-    return value;
+    return kernel;
 }
 
 void DisplayWidget::ensureDisplayConfig(const QString& fieldPath) {
@@ -606,124 +720,12 @@ QVariant DisplayWidget::convertValue(const QVariant& input, ConversionType conve
             
         case ConversionType::ToHexadecimal:
         case ConversionType::ToBinary:
-            // These are handled in formatting
-            return input;
-    }
-    
-    return input;
-}
-
-QVariant DisplayWidget::applyMathOperation(const QVariant& input, MathOperation op, double operand) {
-    double value = input.toDouble();
-    
-    switch (op) {
-        case MathOperation::None:
+            // These are handled in formatting, which needs an integer
+            if (input.typeId() == QMetaType::Double || input.typeId() == QMetaType::Float) {
+                return input.toLongLong();
+            }
             return input;
-            
-        case MathOperation::Multiply:
-            return value * operand;
-            
-        case MathOperation::Divide:
-            return (operand != 0.0) ? (value / operand) : QVariant();
-            
-        case MathOperation::Add:
-            return value + operand;
-            
-        case MathOperation::Subtract:
-            return value - operand;
-            
-        case MathOperation::Modulo:
-            return (operand != 0.0) ? std::fmod(value, operand) : QVariant();
-            
-        case MathOperation::Power:
-            return std::pow(value, operand);
-            
-        case MathOperation::Absolute:
-            return std::abs(value);
-            
-        case MathOperation::Negate:
-            return -value;
     }
     
     return input;
 }
-
-QVariant DisplayWidget::applyFunction(const std::vector<QVariant>& history, FunctionType function) {
-    if (history.empty()) {
-        return QVariant();
-    }
-    
-    switch (function) {
-        case FunctionType::None:
-            return history.back();
-            
-        case FunctionType::Difference:
-            if (history.size() >= 2) {
-                return history.back().toDouble() - history[history.size()-2].toDouble();
-            }
-            return QVariant();
-            
-        case FunctionType::CumulativeSum: {
-            double sum = 0.0;
-            for (const auto& value : history) {
-                sum += value.toDouble();
-            }
-            return sum;
-        }
-        
-        case FunctionType::MovingAverage: {
-            if (history.empty()) return QVariant();
-            double sum = 0.0;
-            for (const auto& value : history) {
-                sum += value.toDouble();
-            }
-            return sum / static_cast<double>(history.size());
-        }
-        
-        case FunctionType::Minimum: {
-            auto it = std::min_element(history.begin(), history.end(),
-                [](const QVariant& a, const QVariant& b) {
-                    return a.toDouble() < b.toDouble();
-                });
-            return (it != history.end()) ? *it : QVariant();
-        }
-        
-        case FunctionType::Maximum: {
-            auto it = std::max_element(history.begin(), history.end(),
-                [](const QVariant& a, const QVariant& b) {
-                    return a.toDouble() < b.toDouble();
-                });
-            return (it != history.end()) ? *it : QVariant();
-        }
-        
-        case FunctionType::Range: {
-            if (history.empty()) return QVariant();
-            auto minMax = std::minmax_element(history.begin(), history.end(),
-                [](const QVariant& a, const QVariant& b) {
-                    return a.toDouble() < b.toDouble();
-                });
-            return minMax.second->toDouble() - minMax.first->toDouble();
-        }
-        
-        case FunctionType::StandardDeviation: {
-            if (history.size() < 2) return QVariant();
-            
-            double mean = 0.0;
-            for (const auto& value : history) {
-                mean += value.toDouble();
-            }
-            mean /= static_cast<double>(history.size());
-            
-            double variance = 0.0;
-            for (const auto& value : history) {
-                double diff = value.toDouble() - mean;
-                variance += diff * diff;
-            }
-            variance /= static_cast<double>(history.size() - 1);
-            
-            return std::sqrt(variance);
-        }
-    }
-    
-    return history.back();
-}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define DISPLAY_WIDGET_H
 
 #include "base_widget.h"
+#include "../../packet/processing/transform_kernel.h"
 #include <QVariant>
 #include <QColor>
 #include <QFont>
@@ -23,7 +24,9 @@ namespace Monitor::Packet {
  * @brief Concrete base class for display widgets that show field values
  * 
  * DisplayWidget provides common functionality for widgets that display packet field values:
- * - Data transformation pipeline (type conversion, mathematical operations, functions)
+ * - Data transformation pipeline (type conversion, mathematical operations, functions),
+ *   compiled per field into a TransformKernel so windowed functions cost the
+ *   same whatever functionWindow is
  * - Trigger condition evaluation
  * - Display formatting (colors, fonts, prefixes/suffixes)
  * - Field value caching for performance
@@ -148,23 +151,14 @@ public:
     };
 
     /**
-     * @brief Field value with transformation history
+     * @brief Latest raw and transformed value of a field
      */
     struct FieldValue {
         QVariant currentValue;
         QVariant transformedValue;
-        std::vector<QVariant> history;  // For functions that need history
         std::chrono::steady_clock::time_point timestamp;
         bool hasNewValue = false;
         
-        // Add value to history with window size limit
-        void addToHistory(const QVariant& value, int maxSize = 100) {
-            history.push_back(value);
-            if (history.size() > static_cast<size_t>(maxSize)) {
-                history.erase(history.begin());
-            }
-        }
-        
         FieldValue() : timestamp(std::chrono::steady_clock::now()) {}
     };
 
@@ -191,8 +185,15 @@ public:
     // Display formatting helpers
     static QString formatValue(const QVariant& value, const DisplayConfig& config);
     static QVariant convertValue(const QVariant& input, ConversionType conversion);
-    static QVariant applyMathOperation(const QVariant& input, MathOperation op, double operand);
-    static QVariant applyFunction(const std::vector<QVariant>& history, FunctionType function);
+    
+    /**
+     * @brief Numeric part of @p config as a kernel
+     *
+     * Covers the math operation and the function over the last
+     * functionWindow values. The conversion is applied to the kernel's
+     * output, by convertValue().
+     */
+    static Monitor::Packet::TransformKernel compileKernel(const DisplayConfig& config);
 
 protected:
     // BaseWidget implementation
@@ -228,6 +229,7 @@ private:
     // Field value storage
     std::unordered_map<QString, FieldValue> m_fieldValues;
     std::unordered_map<QString, DisplayConfig> m_displayConfigs;
+    std::unordered_map<QString, Monitor::Packet::TransformKernel> m_kernels;   // Compiled on first use
 
     // Trigger condition
     TriggerCondition m_triggerCondition;
@@ -55,6 +55,9 @@ GridWidget::GridWidget(const QString& widgetId, QWidget* parent)
     setupConnections();
     setupContextMenu();
     
+    // Each cell shows a current value, so one packet per ID and frame is enough
+    setPacketDelivery(PacketDelivery::LatestValue);
+    
     // Enable drag and drop
     setAcceptDrops(true);
     
@@ -1,5 +1,6 @@
 #include "performance_dashboard.h"
 #include "../../logging/logger.h"
+#include "../../packet/routing/subscription_manager.h"
 
 #include <QApplication>
 #include <QDesktopServices>
@@ -40,6 +41,7 @@ PerformanceDashboard::PerformanceDashboard(QWidget* parent)
     , m_widgetChartView(nullptr)
     , m_pipelineTab(nullptr)
     , m_pipelineChartView(nullptr)
+    , m_subscriberTable(nullptr)
     , m_alertsTab(nullptr)
     , m_alertsTable(nullptr)
     , m_clearAlertsButton(nullptr)
@@ -56,6 +58,7 @@ PerformanceDashboard::PerformanceDashboard(QWidget* parent)
     , m_statusLabel(nullptr)
     , m_updateIntervalLabel(nullptr)
     , m_pipelineSeries(nullptr)
+    , m_subscriptionManager(nullptr)
     , m_updateInterval(DEFAULT_UPDATE_INTERVAL_MS)
     , m_historyMinutes(DEFAULT_HISTORY_MINUTES)
     , m_maxAlerts(100)
@@ -276,6 +279,15 @@ void PerformanceDashboard::setupPipelineTab()
     
     layout->addLayout(indicatorsLayout);
     
+    // Create subscriber table
+    m_subscriberTable = new QTableWidget(0, 8, m_pipelineTab);
+    m_subscriberTable->setHorizontalHeaderLabels({"Subscriber", "Policy", "Critical", "Queued",
+                                                  "Lag ms", "Max lag ms", "Delivered", "Dropped"});
+    m_subscriberTable->horizontalHeader()->setStretchLastSection(true);
+    m_subscriberTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_subscriberTable->setAlternatingRowColors(true);
+    layout->addWidget(m_subscriberTable, 1);
+    
     // Create pipeline chart
     m_pipelineChartView = createPipelineChart();
     layout->addWidget(m_pipelineChartView, 1);
@@ -646,6 +658,74 @@ void PerformanceDashboard::updateWidgetMetrics(const QString& widgetId, const Wi
     qCDebug(performanceDashboard) << "Updating widget metrics - TODO";
 }
 
+void PerformanceDashboard::setSubscriptionManager(Monitor::Packet::SubscriptionManager* manager)
+{
+    m_subscriptionManager = manager;
+    collectSubscriberMetrics();
+}
+
+void PerformanceDashboard::updateSubscriberMetrics(const QList<SubscriberMetrics>& metrics)
+{
+    m_subscriberMetrics = metrics;
+    if (!m_subscriberTable) {
+        return;
+    }
+    
+    m_subscriberTable->setRowCount(metrics.size());
+    for (int row = 0; row < metrics.size(); ++row) {
+        const SubscriberMetrics& subscriber = metrics[row];
+        const QString queued = subscriber.mailboxCapacity > 0
+            ? QString("%1 / %2").arg(subscriber.queueDepth).arg(subscriber.mailboxCapacity)
+            : QString("-");
+        const QString dropped = subscriber.packetsConflated > 0
+            ? QString("%1 (%2 conflated)").arg(subscriber.packetsDropped).arg(subscriber.packetsConflated)
+            : QString::number(subscriber.packetsDropped);
+        
+        const QStringList cells = {
+            subscriber.name,
+            subscriber.policy,
+            subscriber.critical ? "yes" : "no",
+            queued,
+            QString::number(subscriber.lagMs, 'f', 2),
+            QString::number(subscriber.maxLagMs, 'f', 2),
+            QString::number(subscriber.packetsReceived),
+            dropped
+        };
+        for (int column = 0; column < cells.size(); ++column) {
+            QTableWidgetItem* item = m_subscriberTable->item(row, column);
+            if (!item) {
+                item = new QTableWidgetItem();
+                m_subscriberTable->setItem(row, column, item);
+            }
+            item->setText(cells[column]);
+        }
+    }
+}
+
+void PerformanceDashboard::collectSubscriberMetrics()
+{
+    if (!m_subscriptionManager) {
+        return;
+    }
+    
+    QList<SubscriberMetrics> metrics;
+    for (const auto& stats : m_subscriptionManager->getSubscriberStatistics()) {
+        SubscriberMetrics subscriber;
+        subscriber.name = QString::fromStdString(stats.name);
+        subscriber.policy = Monitor::Packet::SubscriptionManager::policyName(stats.policy);
+        subscriber.critical = stats.critical;
+        subscriber.queueDepth = static_cast<int>(stats.queueDepth);
+        subscriber.mailboxCapacity = static_cast<int>(stats.mailboxCapacity);
+        subscriber.lagMs = static_cast<double>(stats.lagNs) / 1e6;
+        subscriber.maxLagMs = static_cast<double>(stats.maxLagNs) / 1e6;
+        subscriber.packetsReceived = stats.packetsReceived;
+        subscriber.packetsDropped = stats.packetsDropped;
+        subscriber.packetsConflated = stats.packetsConflated;
+        metrics.append(subscriber);
+    }
+    updateSubscriberMetrics(metrics);
+}
+
 void PerformanceDashboard::addAlert(const PerformanceAlert& alert)
 {
     Q_UNUSED(alert)
@@ -772,6 +852,7 @@ void PerformanceDashboard::onMetricsTimer()
     if (!m_isMonitoring || m_isPaused) return;
     
     collectSystemMetrics();
+    collectSubscriberMetrics();
 }
 
 void PerformanceDashboard::onAlertTimer()
@@ -31,6 +31,8 @@
 #include <deque>
 #include <chrono>
 
+namespace Monitor { namespace Packet { class SubscriptionManager; } }
+
 /**
  * @brief Real-time performance monitoring dashboard
  * 
@@ -122,6 +124,22 @@ public:
         QDateTime lastUpdate = QDateTime::currentDateTime();
     };
 
+    /**
+     * @brief Per-subscriber delivery metrics
+     */
+    struct SubscriberMetrics {
+        QString name;
+        QString policy;             // Delivery policy name
+        bool critical = false;      // Holds sources back when behind
+        int queueDepth = 0;         // Packets waiting in the mailbox
+        int mailboxCapacity = 0;    // 0 for direct delivery
+        double lagMs = 0.0;         // Mailbox wait of the last delivered packet
+        double maxLagMs = 0.0;
+        quint64 packetsReceived = 0;
+        quint64 packetsDropped = 0; // Including conflated packets
+        quint64 packetsConflated = 0;
+    };
+
     /**
      * @brief Performance alert structure
      */
@@ -164,6 +182,11 @@ public:
     SystemMetrics getCurrentSystemMetrics() const { return m_latestSystemMetrics; }
     WidgetMetrics getWidgetMetrics(const QString& widgetId) const;
     QStringList getMonitoredWidgets() const;
+    
+    // Subscriber metrics, collected from the subscription manager while monitoring
+    void setSubscriptionManager(Monitor::Packet::SubscriptionManager* manager);
+    void updateSubscriberMetrics(const QList<SubscriberMetrics>& metrics);
+    QList<SubscriberMetrics> getSubscriberMetrics() const { return m_subscriberMetrics; }
 
     // Alert management
     void addAlert(const PerformanceAlert& alert);
@@ -257,6 +280,7 @@ private:
     // Data management
     void collectSystemMetrics();
     void collectWidgetMetrics();
+    void collectSubscriberMetrics();
     void checkThresholds();
     void updateCharts();
     void updateGauges();
@@ -298,6 +322,7 @@ private:
     QWidget* m_pipelineTab;
     QChartView* m_pipelineChartView;
     std::unordered_map<QString, QWidget*> m_pipelineIndicators;
+    QTableWidget* m_subscriberTable;
     
     // Alerts tab
     QWidget* m_alertsTab;
@@ -324,6 +349,8 @@ private:
     // Data storage
     SystemMetrics m_latestSystemMetrics;
     std::unordered_map<QString, WidgetMetrics> m_widgetMetrics;
+    QList<SubscriberMetrics> m_subscriberMetrics;
+    Monitor::Packet::SubscriptionManager* m_subscriptionManager;
     std::deque<SystemMetrics> m_systemHistory;
     std::unordered_map<QString, std::deque<WidgetMetrics>> m_widgetHistory;
     std::deque<PerformanceAlert> m_activeAlerts;
@@ -0,0 +1,175 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../../src/packet/processing/field_extractor.h"
+#include "../../src/packet/processing/batch_field_extractor.h"
+#include "../../src/packet/core/packet_factory.h"
+#include "../../src/memory/memory_pool.h"
+
+using namespace Monitor;
+using namespace Monitor::Packet;
+
+/**
+ * @brief Batch field extraction across bursts of same-ID packets
+ *
+ * Decodes 30 fields from bursts of 1000 packets of one ID, packet by packet
+ * through FieldExtractor::extractInto(), then field by field with
+ * BatchFieldExtractor's scalar and AVX2 implementations. Each batch result
+ * is first checked bit for bit against the per-packet decode of the same
+ * burst.
+ */
+class TestBatchFieldExtractionPerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testPerPacket();
+
+    void testBatch_data();
+    void testBatch();
+
+private:
+    Memory::MemoryPoolManager* m_memoryManager = nullptr;
+    FieldExtractor* m_extractor = nullptr;
+    std::vector<PacketPtr> m_burst;
+    FieldFrame m_expected;      ///< Per-packet decode of the burst, row per packet
+    double m_perPacketNs = 0.0;
+
+    static constexpr PacketId PACKET_ID = 2200;
+    static constexpr int FIELD_COUNT = 30;
+    static constexpr int BURST_PACKETS = 1000;
+    static constexpr int BURSTS = 2000;
+};
+
+void TestBatchFieldExtractionPerformance::initTestCase()
+{
+    struct FieldType {
+        const char* typeName;
+        size_t size;
+        uint8_t bitWidth;
+    };
+    const FieldType types[] = {
+        {"int", 4, 0},
+        {"float", 4, 0},
+        {"unsigned short", 2, 0},
+        {"double", 8, 0},
+        {"unsigned int", 4, 7},
+        {"signed char", 1, 0},
+        {"long long", 8, 0},
+        {"short", 2, 0},
+        {"unsigned int", 4, 0},
+        {"unsigned char", 1, 0}
+    };
+
+    std::vector<FieldExtractor::FieldDescriptor> fields;
+    size_t offset = 0;
+    for (int i = 0; i < FIELD_COUNT; ++i) {
+        const FieldType& type = types[i % (sizeof(types) / sizeof(types[0]))];
+        FieldExtractor::FieldDescriptor descriptor("field_" + std::to_string(i), offset, type.size, type.typeName);
+        if (type.bitWidth > 0) {
+            descriptor.isBitfield = true;
+            descriptor.bitOffset = static_cast<uint8_t>(i % 20);
+            descriptor.bitWidth = type.bitWidth;
+        }
+        offset += type.size;
+        fields.push_back(descriptor);
+    }
+
+    m_extractor = new FieldExtractor();
+    QVERIFY(m_extractor->buildFieldMap(PACKET_ID, "Burst", fields, offset));
+
+    m_memoryManager = new Memory::MemoryPoolManager();
+    PacketFactory factory(m_memoryManager);
+
+    uint32_t state = 2024;
+    for (int i = 0; i < BURST_PACKETS; ++i) {
+        auto result = factory.createPacket(PACKET_ID, nullptr, offset);
+        QVERIFY(result.success);
+        uint8_t* payload = const_cast<uint8_t*>(result.packet->payload());
+        for (size_t byte = 0; byte < offset; ++byte) {
+            state = state * 1664525u + 1013904223u;
+            payload[byte] = static_cast<uint8_t>(state >> 24);
+        }
+        m_burst.push_back(result.packet);
+    }
+
+    m_expected.resize(m_extractor->getExtractionPlan(PACKET_ID)->columnCount(), BURST_PACKETS);
+    for (int i = 0; i < BURST_PACKETS; ++i) {
+        QVERIFY(m_extractor->extractInto(m_burst[i], m_expected, i));
+    }
+}
+
+void TestBatchFieldExtractionPerformance::cleanupTestCase()
+{
+    m_burst.clear();
+    delete m_extractor;
+    delete m_memoryManager;
+}
+
+void TestBatchFieldExtractionPerformance::testPerPacket()
+{
+    FieldFrame frame(m_expected.columns(), BURST_PACKETS);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int burst = 0; burst < BURSTS; ++burst) {
+        for (int i = 0; i < BURST_PACKETS; ++i) {
+            m_extractor->extractInto(m_burst[i], frame, i);
+        }
+    }
+    m_perPacketNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+        / (static_cast<double>(BURSTS) * BURST_PACKETS);
+
+    qDebug() << QString("Per packet: %1 ns/packet").arg(m_perPacketNs, 0, 'f', 1);
+}
+
+void TestBatchFieldExtractionPerformance::testBatch_data()
+{
+    QTest::addColumn<int>("implementation");
+
+    QTest::newRow("scalar") << static_cast<int>(BatchFieldExtractor::Implementation::Scalar);
+    QTest::newRow("AVX2") << static_cast<int>(BatchFieldExtractor::Implementation::Avx2);
+}
+
+void TestBatchFieldExtractionPerformance::testBatch()
+{
+    QFETCH(int, implementation);
+    const auto requested = static_cast<BatchFieldExtractor::Implementation>(implementation);
+    if (!BatchFieldExtractor::isSupported(requested)) {
+        QSKIP("Not supported by this CPU");
+    }
+
+    BatchFieldExtractor batch(*m_extractor->getExtractionPlan(PACKET_ID), requested);
+    FieldColumns columns(batch.columnCount(), BURST_PACKETS);
+
+    QCOMPARE(batch.extract(m_burst.data(), m_burst.size(), columns), size_t(BURST_PACKETS));
+    for (size_t column = 0; column < columns.columns(); ++column) {
+        for (size_t row = 0; row < size_t(BURST_PACKETS); ++row) {
+            const double expected = m_expected.real(column, row);
+            const double actual = columns.real(column, row);
+            QVERIFY(std::memcmp(&expected, &actual, sizeof(double)) == 0);
+            QCOMPARE(columns.integer(column, row), m_expected.integer(column, row));
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int burst = 0; burst < BURSTS; ++burst) {
+        batch.extract(m_burst.data(), m_burst.size(), columns);
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+        / (static_cast<double>(BURSTS) * BURST_PACKETS);
+
+    qDebug() << QString("%1 batch: %2 ns/packet, %3x per packet")
+        .arg(QTest::currentDataTag())
+        .arg(ns, 0, 'f', 1)
+        .arg(m_perPacketNs > 0.0 ? m_perPacketNs / ns : 0.0, 0, 'f', 2);
+}
+
+QTEST_MAIN(TestBatchFieldExtractionPerformance)
+#include "test_batch_field_extraction_performance.moc"
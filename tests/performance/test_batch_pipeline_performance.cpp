@@ -0,0 +1,138 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../../src/packet/routing/packet_router.h"
+#include "../../src/packet/routing/subscription_manager.h"
+#include "../../src/packet/core/packet_factory.h"
+#include "../../src/memory/memory_pool.h"
+
+using namespace Monitor;
+using namespace Monitor::Packet;
+
+/**
+ * @brief End-to-end router throughput, per packet against batched
+ *
+ * A producer routes the same packet stream through PacketRouter either one
+ * packet at a time to per-packet subscribers, or in source-sized batches
+ * with routePackets() to batch subscribers. Reports packets per second and
+ * subscriber calls per packet.
+ */
+class TestBatchPipelinePerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testThroughput_data();
+    void testThroughput();
+
+private:
+    Memory::MemoryPoolManager* m_memoryManager = nullptr;
+    std::vector<PacketPtr> m_packets;
+
+    static constexpr int WORKER_THREADS = 4;
+    static constexpr int PACKET_TYPES = 16;
+    static constexpr int STREAM_PACKETS = 4096;
+    static constexpr int TOTAL_PACKETS = 2000000;
+    static constexpr int SOURCE_BATCH = 64;
+};
+
+void TestBatchPipelinePerformance::initTestCase()
+{
+    m_memoryManager = new Memory::MemoryPoolManager();
+    PacketFactory factory(m_memoryManager);
+
+    for (int i = 0; i < STREAM_PACKETS; ++i) {
+        auto result = factory.createPacket(static_cast<PacketId>(800 + i % PACKET_TYPES), nullptr, 64);
+        QVERIFY(result.success);
+        m_packets.push_back(result.packet);
+    }
+}
+
+void TestBatchPipelinePerformance::cleanupTestCase()
+{
+    m_packets.clear();
+    delete m_memoryManager;
+}
+
+void TestBatchPipelinePerformance::testThroughput_data()
+{
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("per packet") << false;
+    QTest::newRow("batched") << true;
+}
+
+void TestBatchPipelinePerformance::testThroughput()
+{
+    QFETCH(bool, batched);
+
+    PacketRouter::Configuration config;
+    config.workerThreads = WORKER_THREADS;
+    config.queueSize = 65536;
+    config.enableProfiling = false;
+
+    PacketRouter router(config);
+    SubscriptionManager manager;
+    router.setSubscriptionManager(&manager);
+
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> calls{0};
+    for (int i = 0; i < PACKET_TYPES; ++i) {
+        const PacketId id = static_cast<PacketId>(800 + i);
+        if (batched) {
+            manager.subscribeBatch("Batch", id, [&](PacketSpan packets) {
+                delivered.fetch_add(packets.size(), std::memory_order_relaxed);
+                calls.fetch_add(1, std::memory_order_relaxed);
+            });
+        } else {
+            manager.subscribe("Single", id, [&](PacketPtr) {
+                delivered.fetch_add(1, std::memory_order_relaxed);
+                calls.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    }
+
+    QVERIFY(router.start());
+
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t routed = 0;
+    std::vector<PacketPtr> batch;
+    batch.reserve(SOURCE_BATCH);
+    for (int i = 0; i < TOTAL_PACKETS;) {
+        if (batched) {
+            for (int n = 0; n < SOURCE_BATCH && i < TOTAL_PACKETS; ++n, ++i) {
+                batch.push_back(m_packets[static_cast<size_t>(i) % m_packets.size()]);
+            }
+            routed += router.routePackets(batch);
+        } else {
+            routed += router.routePacket(m_packets[static_cast<size_t>(i) % m_packets.size()]) ? 1 : 0;
+            ++i;
+        }
+
+        // Keep the queues from overflowing so both modes route every packet
+        while (routed > delivered.load(std::memory_order_relaxed) + config.queueSize / 2) {
+            std::this_thread::yield();
+        }
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(delivered.load(), routed, 10000);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    router.stop();
+
+    QCOMPARE(routed, uint64_t(TOTAL_PACKETS));
+
+    qDebug() << QString("%1: %2 Mpackets/s, %3 subscriber calls per packet")
+        .arg(QTest::currentDataTag())
+        .arg(static_cast<double>(routed) / seconds / 1e6, 0, 'f', 2)
+        .arg(static_cast<double>(calls.load()) / static_cast<double>(routed), 0, 'f', 3);
+}
+
+QTEST_MAIN(TestBatchPipelinePerformance)
+#include "test_batch_pipeline_performance.moc"
@@ -0,0 +1,187 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QStorageInfo>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "../../src/offline/recording/capture_recorder.h"
+#include "../../src/offline/sources/file_indexer.h"
+#include "../../src/packet/core/packet_header.h"
+
+using namespace Monitor;
+
+/**
+ * @brief Sustained recording throughput while packets arrive at full rate
+ *
+ * Producer threads offer 2 GB of packets (MONITOR_RECORD_BENCH_MB to
+ * override) to a CaptureRecorder as fast as they can, standing in for
+ * receive threads that never wait. Reports the rate packets were offered,
+ * the share the recorder had to drop and the rate it wrote them to disk,
+ * with buffered and direct I/O.
+ */
+class TestCaptureRecorderPerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testSustainedRecording_data();
+    void testSustainedRecording();
+
+private:
+    QTemporaryDir* m_tempDir = nullptr;
+    qint64 m_targetBytes = 0;
+    QByteArray m_packets;                   ///< Packets offered round robin
+    std::vector<int> m_packetOffsets;
+
+    static constexpr qint64 DEFAULT_RECORD_MB = 2048;
+    static constexpr int PACKET_POOL_SIZE = 4096;
+};
+
+void TestCaptureRecorderPerformance::initTestCase()
+{
+    bool ok = false;
+    qint64 recordMB = qEnvironmentVariableIntValue("MONITOR_RECORD_BENCH_MB", &ok);
+    if (!ok || recordMB <= 0) {
+        recordMB = DEFAULT_RECORD_MB;
+    }
+    m_targetBytes = recordMB * 1024 * 1024;
+
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+
+    QStorageInfo storage(m_tempDir->path());
+    if (storage.bytesAvailable() < m_targetBytes + m_targetBytes / 10) {
+        QSKIP("Not enough free disk space for the recordings");
+    }
+
+    // Mostly small telemetry packets with some large ones, like the indexing benchmark
+    QRandomGenerator random(20240601);
+    for (int i = 0; i < PACKET_POOL_SIZE; ++i) {
+        const uint32_t payloadSize = random.bounded(8) == 0 ? 1000 + random.bounded(500) : 32 + random.bounded(200);
+
+        Packet::PacketHeader header;
+        header.id = 1 + (i % 16);
+        header.sequence = static_cast<uint32_t>(i);
+        header.timestamp = 1000000000ULL + static_cast<uint64_t>(i) * 1000;
+        header.payloadSize = payloadSize;
+        header.flags = Packet::PacketHeader::Flags::TestData;
+
+        m_packetOffsets.push_back(m_packets.size());
+        m_packets.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (uint32_t j = 0; j < payloadSize; ++j) {
+            m_packets.append(static_cast<char>(random.bounded(256)));
+        }
+    }
+    m_packetOffsets.push_back(m_packets.size());
+}
+
+void TestCaptureRecorderPerformance::cleanupTestCase()
+{
+    delete m_tempDir;
+}
+
+void TestCaptureRecorderPerformance::testSustainedRecording_data()
+{
+    QTest::addColumn<bool>("directIo");
+    QTest::addColumn<int>("producers");
+
+    for (bool directIo : {false, true}) {
+        for (int producers : {1, 4}) {
+            QTest::newRow(qPrintable(QString("%1, %2 producers").arg(directIo ? "direct" : "buffered").arg(producers)))
+                << directIo << producers;
+        }
+    }
+}
+
+void TestCaptureRecorderPerformance::testSustainedRecording()
+{
+    QFETCH(bool, directIo);
+    QFETCH(int, producers);
+
+    Offline::CaptureRecorder::Configuration config;
+    config.directory = m_tempDir->filePath(QString("run_%1_%2").arg(directIo).arg(producers));
+    config.bufferSize = 8 * 1024 * 1024;
+    config.bufferCount = 4;
+    config.maxFileSize = 512LL * 1024 * 1024;
+    config.directIo = directIo;
+
+    Offline::CaptureRecorder recorder(config);
+    QVERIFY(recorder.start());
+    if (directIo && !recorder.isDirectIo()) {
+        recorder.stop();
+        QSKIP("File system does not support O_DIRECT");
+    }
+
+    const uchar* packets = reinterpret_cast<const uchar*>(m_packets.constData());
+    const qint64 bytesPerProducer = m_targetBytes / producers;
+    std::atomic<uint64_t> offeredPackets{0};
+
+    QElapsedTimer timer;
+    timer.start();
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            qint64 offered = 0;
+            uint64_t count = 0;
+            for (size_t i = static_cast<size_t>(p) * 97; offered < bytesPerProducer; ++i) {
+                const size_t packet = i % PACKET_POOL_SIZE;
+                const uint32_t size = static_cast<uint32_t>(m_packetOffsets[packet + 1] - m_packetOffsets[packet]);
+                recorder.record(packets + m_packetOffsets[packet], size);
+                offered += size;
+                ++count;
+            }
+            offeredPackets += count;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const qint64 ingestMs = std::max<qint64>(1, timer.elapsed());
+
+    recorder.stop();
+    const qint64 totalMs = std::max<qint64>(1, timer.elapsed());
+
+    const auto& stats = recorder.getStatistics();
+    QCOMPARE(stats.packetsRecorded.load() + stats.packetsDropped.load(), offeredPackets.load());
+    QCOMPARE(stats.bytesWritten.load(), stats.bytesRecorded.load());
+    QCOMPARE(stats.writeErrors.load(), uint64_t(0));
+
+    qint64 fileBytes = 0;
+    for (const QString& filename : recorder.getCompletedFiles()) {
+        fileBytes += QFileInfo(filename).size();
+        QFile::remove(Offline::FileIndexer::getCacheFilename(filename));
+        QFile::remove(filename);
+    }
+    QCOMPARE(static_cast<uint64_t>(fileBytes), stats.bytesWritten.load());
+
+    const double megabyte = 1024.0 * 1024.0;
+    const double offeredMBps = (static_cast<double>(m_targetBytes) / megabyte) / (ingestMs / 1000.0);
+    const double writtenMBps = (static_cast<double>(stats.bytesWritten.load()) / megabyte) / (totalMs / 1000.0);
+    const double dropPercent = 100.0 * static_cast<double>(stats.packetsDropped.load()) / offeredPackets.load();
+    const double writeMs = static_cast<double>(stats.writeTimeNs.load()) / 1e6;
+
+    qDebug() << QString("%1 I/O, %2 producers: offered %3 MB/s (%4 Mpackets/s), written %5 MB/s, "
+                        "%6% dropped, %7 writes averaging %8 ms")
+        .arg(directIo ? "direct" : "buffered")
+        .arg(producers)
+        .arg(offeredMBps, 0, 'f', 1)
+        .arg(static_cast<double>(offeredPackets.load()) / (ingestMs * 1000.0), 0, 'f', 2)
+        .arg(writtenMBps, 0, 'f', 1)
+        .arg(dropPercent, 0, 'f', 2)
+        .arg(stats.writeCalls.load())
+        .arg(stats.writeCalls.load() > 0 ? writeMs / stats.writeCalls.load() : 0.0, 0, 'f', 2);
+}
+
+QTEST_MAIN(TestCaptureRecorderPerformance)
+#include "test_capture_recorder_performance.moc"
@@ -0,0 +1,183 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QStorageInfo>
+#include <QTemporaryDir>
+#include <QThread>
+#include <algorithm>
+#include <cstring>
+
+#include "../../src/offline/sources/file_indexer.h"
+#include "../../src/packet/core/packet_header.h"
+#include "../../src/threading/thread_pool.h"
+
+using namespace Monitor;
+
+/**
+ * @brief Capture indexing throughput against thread count
+ *
+ * Generates a synthetic capture (2 GB by default, MONITOR_INDEX_BENCH_MB to
+ * override) and indexes it with the chunks scanned on the indexing thread
+ * and on thread pools of increasing size. The file is indexed once up front
+ * so every run reads from the page cache and measures scanning, not disk.
+ */
+class TestFileIndexingPerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testIndexingThroughput_data();
+    void testIndexingThroughput();
+
+private:
+    bool writeCapture(const QString& filename, qint64 targetBytes);
+
+    QTemporaryDir* m_tempDir = nullptr;
+    QString m_captureFile;
+    qint64 m_captureBytes = 0;
+    uint64_t m_expectedPackets = 0;
+    double m_inlineMBps = 0.0;
+
+    static constexpr qint64 DEFAULT_CAPTURE_MB = 2048;
+    static constexpr int WRITE_BLOCK_SIZE = 4 * 1024 * 1024;
+};
+
+void TestFileIndexingPerformance::initTestCase()
+{
+    bool ok = false;
+    qint64 captureMB = qEnvironmentVariableIntValue("MONITOR_INDEX_BENCH_MB", &ok);
+    if (!ok || captureMB <= 0) {
+        captureMB = DEFAULT_CAPTURE_MB;
+    }
+    const qint64 targetBytes = captureMB * 1024 * 1024;
+
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+
+    QStorageInfo storage(m_tempDir->path());
+    if (storage.bytesAvailable() < targetBytes + targetBytes / 10) {
+        QSKIP("Not enough free disk space for the synthetic capture");
+    }
+
+    m_captureFile = m_tempDir->filePath("indexing_benchmark.dat");
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(writeCapture(m_captureFile, targetBytes));
+    m_captureBytes = QFileInfo(m_captureFile).size();
+    qDebug() << "Generated" << m_captureBytes / (1024 * 1024) << "MB capture in" << timer.elapsed() << "ms";
+
+    // Warm the page cache and record the reference packet count
+    Offline::FileIndexer warmup;
+    QVERIFY(warmup.startIndexing(m_captureFile, false));
+    m_expectedPackets = warmup.getPacketCount();
+    QVERIFY(m_expectedPackets > 0);
+}
+
+void TestFileIndexingPerformance::cleanupTestCase()
+{
+    delete m_tempDir;
+}
+
+void TestFileIndexingPerformance::testIndexingThroughput_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QTest::newRow("indexing thread only") << 0;
+
+    const int maxThreads = std::max(1, QThread::idealThreadCount());
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        QTest::newRow(qPrintable(QString("%1 pool threads").arg(threads))) << threads;
+    }
+    QTest::newRow(qPrintable(QString("%1 pool threads").arg(maxThreads))) << maxThreads;
+}
+
+void TestFileIndexingPerformance::testIndexingThroughput()
+{
+    QFETCH(int, threads);
+
+    Threading::ThreadPool pool;
+    Offline::FileIndexer indexer;
+    if (threads > 0) {
+        QVERIFY(pool.initialize(static_cast<size_t>(threads)));
+        pool.start();
+        indexer.setThreadPool(&pool);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(indexer.startIndexing(m_captureFile, false));
+    const qint64 elapsedMs = std::max<qint64>(1, timer.elapsed());
+
+    QCOMPARE(indexer.getPacketCount(), m_expectedPackets);
+
+    const double mbps = (static_cast<double>(m_captureBytes) / (1024.0 * 1024.0)) / (elapsedMs / 1000.0);
+    if (threads == 0) {
+        m_inlineMBps = mbps;
+    }
+
+    qDebug() << QString("%1 threads: %2 MB/s, %3 Mpackets/s (%4x indexing thread only)")
+        .arg(threads)
+        .arg(mbps, 0, 'f', 1)
+        .arg(static_cast<double>(m_expectedPackets) / (elapsedMs * 1000.0), 0, 'f', 2)
+        .arg(m_inlineMBps > 0 ? mbps / m_inlineMBps : 1.0, 0, 'f', 2);
+
+    pool.shutdown();
+}
+
+bool TestFileIndexingPerformance::writeCapture(const QString& filename, qint64 targetBytes)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    // Mixed packet sizes with binary payloads, written in large blocks
+    QRandomGenerator random(20240601);
+    QByteArray block;
+    block.reserve(WRITE_BLOCK_SIZE + 2048);
+
+    qint64 written = 0;
+    uint32_t sequence = 0;
+    uint64_t timestamp = 1000000000ULL;
+
+    while (written < targetBytes) {
+        block.clear();
+        while (block.size() < WRITE_BLOCK_SIZE) {
+            const uint32_t payloadSize = random.bounded(8) == 0 ? 1000 + random.bounded(500) : 32 + random.bounded(200);
+
+            Packet::PacketHeader header;
+            header.id = 1 + (sequence % 16);
+            header.sequence = sequence++;
+            header.timestamp = timestamp;
+            header.payloadSize = payloadSize;
+            header.flags = Packet::PacketHeader::Flags::TestData;
+            timestamp += 1000 + random.bounded(9000);
+
+            const int offset = block.size();
+            block.resize(offset + static_cast<int>(sizeof(header) + payloadSize));
+            std::memcpy(block.data() + offset, &header, sizeof(header));
+
+            char* payload = block.data() + offset + sizeof(header);
+            for (uint32_t i = 0; i < payloadSize; i += sizeof(quint32)) {
+                const quint32 word = random.generate();
+                std::memcpy(payload + i, &word, std::min<size_t>(sizeof(word), payloadSize - i));
+            }
+        }
+
+        if (file.write(block) != block.size()) {
+            return false;
+        }
+        written += block.size();
+    }
+
+    file.close();
+    return true;
+}
+
+QTEST_MAIN(TestFileIndexingPerformance)
+#include "test_file_indexing_performance.moc"
@@ -0,0 +1,216 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "../../src/memory/memory_pool.h"
+#include "../../src/memory/size_class_allocator.h"
+
+using namespace Monitor::Memory;
+using namespace std::chrono;
+
+/**
+ * @brief Packet buffer allocator throughput benchmark
+ *
+ * Compares the string-keyed MemoryPoolManager path that packet buffers used
+ * to take against the index-addressed SizeClassAllocator, with 1, 4 and 16
+ * threads each running bursts of allocate/free pairs.
+ */
+class TestMemoryAllocatorPerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testSingleThreadCorrectness();
+    void testConcurrentNoLeaks();
+    void testThroughputComparison_data();
+    void testThroughputComparison();
+
+private:
+    template<typename Alloc, typename Free>
+    double measureOpsPerSecond(int threadCount, Alloc&& alloc, Free&& release);
+
+    MemoryPoolManager* m_manager = nullptr;
+
+    static constexpr int BURST_SIZE = 16;
+    static constexpr int ITERATIONS_PER_THREAD = 50000;
+    static constexpr size_t PACKET_SIZE = 256;
+};
+
+void TestMemoryAllocatorPerformance::initTestCase()
+{
+    m_manager = new MemoryPoolManager();
+    m_manager->createPool("MediumObjects", 512, 5000);
+}
+
+void TestMemoryAllocatorPerformance::cleanupTestCase()
+{
+    delete m_manager;
+    m_manager = nullptr;
+}
+
+void TestMemoryAllocatorPerformance::testSingleThreadCorrectness()
+{
+    SizeClassAllocator allocator;
+    const SizeClass::Index cls = SizeClass::forSize(PACKET_SIZE);
+    QCOMPARE(cls, SizeClass::Index(1));
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 100; ++i) {
+        void* ptr = allocator.allocate(cls);
+        QVERIFY(ptr != nullptr);
+        QVERIFY(allocator.owns(cls, ptr));
+        blocks.push_back(ptr);
+    }
+
+    // All blocks must be distinct
+    std::sort(blocks.begin(), blocks.end());
+    QVERIFY(std::adjacent_find(blocks.begin(), blocks.end()) == blocks.end());
+
+    for (void* ptr : blocks) {
+        allocator.deallocate(cls, ptr);
+    }
+    allocator.flushThreadCache();
+    QCOMPARE(allocator.getUsedBlocks(cls), size_t(0));
+
+    // Exhaustion of the largest class is reported, not crashed on
+    const auto largest = static_cast<SizeClass::Index>(SizeClass::COUNT - 1);
+    std::vector<void*> all;
+    while (void* ptr = allocator.allocate(largest)) {
+        all.push_back(ptr);
+    }
+    QCOMPARE(all.size(), allocator.getBlockCount(largest));
+    QVERIFY(allocator.getClassStatistics(largest).failedAllocations > 0);
+    for (void* ptr : all) {
+        allocator.deallocate(largest, ptr);
+    }
+    allocator.flushThreadCache();
+    QCOMPARE(allocator.getUsedBlocks(largest), size_t(0));
+}
+
+void TestMemoryAllocatorPerformance::testConcurrentNoLeaks()
+{
+    SizeClassAllocator allocator;
+    const SizeClass::Index cls = SizeClass::forSize(PACKET_SIZE);
+    std::atomic<int> failures{0};
+
+    // Each thread holds bursts of blocks so magazines repeatedly refill from
+    // and drain to the shared free list while other threads do the same
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            std::vector<void*> held;
+            for (int i = 0; i < 10000; ++i) {
+                void* ptr = allocator.allocate(cls);
+                if (!ptr) {
+                    failures++;
+                    continue;
+                }
+                std::memset(ptr, i & 0xFF, PACKET_SIZE);
+                held.push_back(ptr);
+                if (held.size() == static_cast<size_t>(BURST_SIZE)) {
+                    for (void* p : held) {
+                        allocator.deallocate(cls, p);
+                    }
+                    held.clear();
+                }
+            }
+            for (void* p : held) {
+                allocator.deallocate(cls, p);
+            }
+            allocator.flushThreadCache();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(failures.load(), 0);
+    QCOMPARE(allocator.getUsedBlocks(cls), size_t(0));
+}
+
+void TestMemoryAllocatorPerformance::testThroughputComparison_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::newRow("1 thread") << 1;
+    QTest::newRow("4 threads") << 4;
+    QTest::newRow("16 threads") << 16;
+}
+
+void TestMemoryAllocatorPerformance::testThroughputComparison()
+{
+    QFETCH(int, threadCount);
+
+    const QString poolName = "MediumObjects";
+    const double namedOps = measureOpsPerSecond(threadCount,
+        [&]() { return m_manager->allocate(poolName); },
+        [&](void* ptr) { m_manager->deallocate(poolName, ptr); });
+
+    SizeClassAllocator* allocator = m_manager->packetAllocator();
+    QVERIFY(allocator != nullptr);
+    const SizeClass::Index cls = SizeClass::forSize(PACKET_SIZE);
+    const double indexedOps = measureOpsPerSecond(threadCount,
+        [&]() { return allocator->allocate(cls); },
+        [&](void* ptr) { allocator->deallocate(cls, ptr); });
+
+    qDebug() << QString("%1 thread(s): named pool %2 Mops/s, size class %3 Mops/s (%4x)")
+        .arg(threadCount)
+        .arg(namedOps / 1e6, 0, 'f', 2)
+        .arg(indexedOps / 1e6, 0, 'f', 2)
+        .arg(namedOps > 0 ? indexedOps / namedOps : 0.0, 0, 'f', 1);
+
+    QVERIFY(namedOps > 0);
+    QVERIFY(indexedOps > 0);
+}
+
+template<typename Alloc, typename Free>
+double TestMemoryAllocatorPerformance::measureOpsPerSecond(int threadCount, Alloc&& alloc, Free&& release)
+{
+    std::atomic<bool> go{false};
+    std::atomic<uint64_t> completed{0};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&]() {
+            void* burst[BURST_SIZE];
+            uint64_t done = 0;
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < ITERATIONS_PER_THREAD; ++i) {
+                int got = 0;
+                for (; got < BURST_SIZE; ++got) {
+                    burst[got] = alloc();
+                    if (!burst[got]) {
+                        break;
+                    }
+                }
+                for (int j = 0; j < got; ++j) {
+                    release(burst[j]);
+                }
+                done += static_cast<uint64_t>(got);
+            }
+            completed.fetch_add(done, std::memory_order_relaxed);
+        });
+    }
+
+    const auto start = steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double seconds = duration<double>(steady_clock::now() - start).count();
+
+    // One operation = one allocate/free pair
+    return seconds > 0 ? static_cast<double>(completed.load()) / seconds : 0.0;
+}
+
+QTEST_MAIN(TestMemoryAllocatorPerformance)
+#include "test_memory_allocator_performance.moc"
@@ -0,0 +1,204 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../../src/packet/core/packet.h"
+#include "../../src/packet/core/packet_buffer.h"
+#include "../../src/memory/memory_pool.h"
+
+using namespace Monitor::Memory;
+using namespace Monitor::Packet;
+
+namespace {
+// Callbacks sum into a per-thread counter so only the packet handles are shared
+thread_local uint64_t t_delivered = 0;
+}
+
+/**
+ * @brief Packet allocation and reference-count traffic
+ *
+ * Compares creating and dropping packets through std::make_shared, as
+ * PacketFactory did, with Packet::create() placing the packet in a pool
+ * block. Then fans packets out to subscriber callbacks from several
+ * threads at once, passing std::shared_ptr by value, PacketHandle by value
+ * and PacketHandle by const reference, to show what the reference count
+ * traffic on shared packets costs.
+ */
+class TestPacketHandlePerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testAllocation();
+
+    void testFanOut_data();
+    void testFanOut();
+
+private:
+    enum class Passing {
+        SharedPtrByValue,
+        HandleByValue,
+        HandleByReference
+    };
+
+    /**
+     * @brief Run @p deliver on FANOUT_THREADS threads
+     * @return Nanoseconds per callback and the callbacks' summed packet IDs
+     */
+    static std::pair<double, uint64_t> runFanOut(const std::function<void(size_t)>& deliver);
+
+    MemoryPoolManager* m_memoryManager = nullptr;
+    PacketBuffer* m_packetBuffer = nullptr;
+
+    static constexpr int ALLOCATION_PACKETS = 1000000;
+    static constexpr int ALLOCATION_BATCH = 64;
+    static constexpr int FANOUT_THREADS = 4;
+    static constexpr int FANOUT_SUBSCRIBERS = 8;
+    static constexpr int FANOUT_PACKETS = 16;
+    static constexpr int FANOUT_ITERATIONS = 200000;
+};
+
+void TestPacketHandlePerformance::initTestCase()
+{
+    m_memoryManager = new MemoryPoolManager();
+    m_packetBuffer = new PacketBuffer(m_memoryManager);
+}
+
+void TestPacketHandlePerformance::cleanupTestCase()
+{
+    delete m_packetBuffer;
+    delete m_memoryManager;
+}
+
+void TestPacketHandlePerformance::testAllocation()
+{
+    SizeClassAllocator* allocator = m_memoryManager->packetAllocator();
+
+    // Packets live in source-sized batches, so neither path just reuses one block
+    std::vector<std::shared_ptr<Packet>> shared;
+    std::vector<PacketPtr> handles;
+    shared.reserve(ALLOCATION_BATCH);
+    handles.reserve(ALLOCATION_BATCH);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ALLOCATION_PACKETS; i += ALLOCATION_BATCH) {
+        for (int n = 0; n < ALLOCATION_BATCH; ++n) {
+            shared.push_back(std::make_shared<Packet>(m_packetBuffer->createForPacket(1, nullptr, 16)));
+        }
+        shared.clear();
+    }
+    const double sharedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ALLOCATION_PACKETS; i += ALLOCATION_BATCH) {
+        for (int n = 0; n < ALLOCATION_BATCH; ++n) {
+            handles.push_back(Packet::create(m_packetBuffer->createForPacket(1, nullptr, 16), allocator));
+        }
+        handles.clear();
+    }
+    const double handleNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    qDebug() << QString("Create and drop, buffer included: make_shared %1 ns/packet, pooled handle %2 ns/packet (%3x)")
+        .arg(sharedNs / ALLOCATION_PACKETS, 0, 'f', 1)
+        .arg(handleNs / ALLOCATION_PACKETS, 0, 'f', 1)
+        .arg(sharedNs / handleNs, 0, 'f', 2);
+}
+
+void TestPacketHandlePerformance::testFanOut_data()
+{
+    QTest::addColumn<int>("passing");
+
+    QTest::newRow("shared_ptr by value") << static_cast<int>(Passing::SharedPtrByValue);
+    QTest::newRow("handle by value") << static_cast<int>(Passing::HandleByValue);
+    QTest::newRow("handle by const reference") << static_cast<int>(Passing::HandleByReference);
+}
+
+std::pair<double, uint64_t> TestPacketHandlePerformance::runFanOut(const std::function<void(size_t)>& deliver)
+{
+    std::atomic<uint64_t> delivered{0};
+    std::vector<std::thread> threads;
+    const auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < FANOUT_THREADS; ++t) {
+        threads.emplace_back([&]() {
+            t_delivered = 0;
+            for (int i = 0; i < FANOUT_ITERATIONS; ++i) {
+                deliver(static_cast<size_t>(i) % FANOUT_PACKETS);
+            }
+            delivered += t_delivered;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return {ns / (static_cast<double>(FANOUT_THREADS) * FANOUT_ITERATIONS * FANOUT_SUBSCRIBERS), delivered.load()};
+}
+
+void TestPacketHandlePerformance::testFanOut()
+{
+    QFETCH(int, passing);
+
+    // Every thread delivers the same few packets, as router workers do for hot packet types
+    std::vector<std::shared_ptr<Packet>> shared;
+    std::vector<PacketPtr> handles;
+    for (int i = 0; i < FANOUT_PACKETS; ++i) {
+        shared.push_back(std::make_shared<Packet>(m_packetBuffer->createForPacket(1, nullptr, 16)));
+        handles.push_back(Packet::create(m_packetBuffer->createForPacket(1, nullptr, 16),
+                                         m_memoryManager->packetAllocator()));
+    }
+
+    std::pair<double, uint64_t> result;
+
+    switch (static_cast<Passing>(passing)) {
+    case Passing::SharedPtrByValue: {
+        std::vector<std::function<void(std::shared_ptr<Packet>)>> callbacks(FANOUT_SUBSCRIBERS,
+            [](std::shared_ptr<Packet> packet) { t_delivered += packet->id(); });
+        result = runFanOut([&](size_t index) {
+            for (const auto& callback : callbacks) {
+                callback(shared[index]);
+            }
+        });
+        break;
+    }
+    case Passing::HandleByValue: {
+        std::vector<std::function<void(PacketPtr)>> callbacks(FANOUT_SUBSCRIBERS,
+            [](PacketPtr packet) { t_delivered += packet->id(); });
+        result = runFanOut([&](size_t index) {
+            for (const auto& callback : callbacks) {
+                callback(handles[index]);
+            }
+        });
+        break;
+    }
+    case Passing::HandleByReference: {
+        std::vector<std::function<void(const PacketPtr&)>> callbacks(FANOUT_SUBSCRIBERS,
+            [](const PacketPtr& packet) { t_delivered += packet->id(); });
+        result = runFanOut([&](size_t index) {
+            for (const auto& callback : callbacks) {
+                callback(handles[index]);
+            }
+        });
+        break;
+    }
+    }
+
+    QCOMPARE(result.second, uint64_t(FANOUT_THREADS) * FANOUT_ITERATIONS * FANOUT_SUBSCRIBERS);
+
+    qDebug() << QString("%1, %2 threads x %3 subscribers: %4 ns/callback")
+        .arg(QTest::currentDataTag())
+        .arg(FANOUT_THREADS)
+        .arg(FANOUT_SUBSCRIBERS)
+        .arg(result.first, 0, 'f', 2);
+}
+
+QTEST_MAIN(TestPacketHandlePerformance)
+#include "test_packet_handle_performance.moc"
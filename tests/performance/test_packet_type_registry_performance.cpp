@@ -0,0 +1,197 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QRandomGenerator>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../../src/packet/core/packet_type_registry.h"
+
+using namespace Monitor::Packet;
+
+/**
+ * @brief Per-packet type lookups: PacketTypeRegistry slots against hash maps
+ *
+ * Compares the unordered_map<PacketId, ...> lookups the routing and
+ * extraction paths used with a registry slot lookup plus a PacketSlotTable
+ * access, on a random packet stream over dense and sparse IDs. Also
+ * compares the router's ordering check under eight threads, mutex plus
+ * map against a lock-free update of the slot's sequence.
+ */
+class TestPacketTypeRegistryPerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testLookup_data();
+    void testLookup();
+
+    void testOrderingCheck();
+
+private:
+    /**
+     * @brief Random packet ID stream over @p typeCount IDs
+     */
+    static std::vector<PacketId> packetStream(PacketId typeCount, PacketId firstId, PacketId stride, size_t length);
+
+    static constexpr size_t STREAM_LENGTH = 1 << 20;
+    static constexpr int LOOKUP_PASSES = 20;
+    static constexpr int ORDERING_THREADS = 8;
+    static constexpr int ORDERING_PACKETS = 2000000;
+    static constexpr PacketId ORDERING_TYPES = 64;
+};
+
+std::vector<PacketId> TestPacketTypeRegistryPerformance::packetStream(PacketId typeCount, PacketId firstId,
+                                                                      PacketId stride, size_t length)
+{
+    QRandomGenerator random(1234);
+    std::vector<PacketId> stream(length);
+    for (auto& id : stream) {
+        id = firstId + random.bounded(typeCount) * stride;
+    }
+    return stream;
+}
+
+void TestPacketTypeRegistryPerformance::testLookup_data()
+{
+    QTest::addColumn<uint>("typeCount");
+    QTest::addColumn<uint>("firstId");
+    QTest::addColumn<uint>("stride");
+
+    QTest::newRow("16 dense") << 16u << 1u << 1u;
+    QTest::newRow("256 dense") << 256u << 1u << 1u;
+    QTest::newRow("2048 dense") << 2048u << 1000u << 1u;
+    QTest::newRow("256 sparse") << 256u << uint(PacketTypeRegistry::DIRECT_ID_LIMIT) << 7919u;
+}
+
+void TestPacketTypeRegistryPerformance::testLookup()
+{
+    QFETCH(uint, typeCount);
+    QFETCH(uint, firstId);
+    QFETCH(uint, stride);
+
+    // Stands in for the subscriber list, field map or structure per type
+    struct TypeState {
+        uint64_t value = 0;
+    };
+
+    PacketTypeRegistry registry;
+    PacketSlotTable<TypeState> table;
+    std::unordered_map<PacketId, TypeState> map;
+    for (PacketId i = 0; i < typeCount; ++i) {
+        const PacketId id = firstId + i * stride;
+        map[id].value = id;
+        table.obtain(registry.registerPacketId(id))->value = id;
+    }
+
+    const std::vector<PacketId> stream = packetStream(typeCount, firstId, stride, STREAM_LENGTH);
+
+    uint64_t mapSum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < LOOKUP_PASSES; ++pass) {
+        for (PacketId id : stream) {
+            auto it = map.find(id);
+            if (it != map.end()) {
+                mapSum += it->second.value;
+            }
+        }
+    }
+    const double mapNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t slotSum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < LOOKUP_PASSES; ++pass) {
+        for (PacketId id : stream) {
+            const TypeState* state = table.find(registry.findSlot(id));
+            if (state) {
+                slotSum += state->value;
+            }
+        }
+    }
+    const double slotNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    QCOMPARE(slotSum, mapSum);
+
+    const double lookups = static_cast<double>(STREAM_LENGTH) * LOOKUP_PASSES;
+    qDebug() << QString("%1 types: unordered_map %2 ns/lookup, registry slot %3 ns/lookup (%4x)")
+        .arg(QTest::currentDataTag())
+        .arg(mapNs / lookups, 0, 'f', 2)
+        .arg(slotNs / lookups, 0, 'f', 2)
+        .arg(mapNs / slotNs, 0, 'f', 2);
+}
+
+void TestPacketTypeRegistryPerformance::testOrderingCheck()
+{
+    // Each thread routes its own packet types with increasing sequence numbers
+    auto run = [](const std::function<bool(PacketId, SequenceNumber)>& check) {
+        std::atomic<uint64_t> outOfOrder{0};
+        std::vector<std::thread> threads;
+        const auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < ORDERING_THREADS; ++t) {
+            threads.emplace_back([&, t]() {
+                uint64_t rejected = 0;
+                for (int i = 0; i < ORDERING_PACKETS; ++i) {
+                    const PacketId id = static_cast<PacketId>(t) * ORDERING_TYPES + static_cast<PacketId>(i) % ORDERING_TYPES;
+                    if (!check(id, static_cast<SequenceNumber>(i / ORDERING_TYPES + 1))) {
+                        ++rejected;
+                    }
+                }
+                outOfOrder += rejected;
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        return std::make_pair(ns / (static_cast<double>(ORDERING_PACKETS) * ORDERING_THREADS), outOfOrder.load());
+    };
+
+    // The router's previous path
+    std::unordered_map<PacketId, SequenceNumber> lastSequence;
+    std::mutex orderingMutex;
+    const auto mapResult = run([&](PacketId id, SequenceNumber sequence) {
+        std::lock_guard<std::mutex> lock(orderingMutex);
+        auto it = lastSequence.find(id);
+        if (it == lastSequence.end()) {
+            lastSequence[id] = sequence;
+            return true;
+        }
+        const bool inOrder = sequence > it->second;
+        if (inOrder) {
+            it->second = sequence;
+        }
+        return inOrder;
+    });
+
+    // PacketRouter::checkPacketOrdering
+    const uint64_t seen = uint64_t(1) << 32;
+    PacketTypeRegistry registry;
+    PacketSlotTable<std::atomic<uint64_t>> slotSequence;
+    const auto slotResult = run([&](PacketId id, SequenceNumber sequence) {
+        auto* entry = slotSequence.obtain(registry.registerPacketId(id));
+        uint64_t last = entry->load(std::memory_order_relaxed);
+        do {
+            if (last != 0 && sequence <= static_cast<SequenceNumber>(last)) {
+                return false;
+            }
+        } while (!entry->compare_exchange_weak(last, seen | sequence, std::memory_order_relaxed));
+        return true;
+    });
+
+    // Each type's sequence rises by one per pass over the types, so nothing is out of order
+    QCOMPARE(mapResult.second, uint64_t(0));
+    QCOMPARE(slotResult.second, uint64_t(0));
+
+    qDebug() << QString("Ordering check, %1 threads: mutex + unordered_map %2 ns/packet, slot CAS %3 ns/packet (%4x)")
+        .arg(ORDERING_THREADS)
+        .arg(mapResult.first, 0, 'f', 2)
+        .arg(slotResult.first, 0, 'f', 2)
+        .arg(mapResult.first / slotResult.first, 0, 'f', 2);
+}
+
+QTEST_MAIN(TestPacketTypeRegistryPerformance)
+#include "test_packet_type_registry_performance.moc"
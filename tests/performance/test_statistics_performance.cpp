@@ -0,0 +1,154 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../../src/packet/processing/statistics_calculator.h"
+
+using namespace Monitor;
+using namespace Monitor::Packet;
+
+/**
+ * @brief Statistics for every field of every packet
+ *
+ * Feeds 30 fields of 20000 packets through StatisticsCalculator by field
+ * name, as extractAllFields() results, and by field slot, one FieldFrame
+ * row or one FieldColumns batch at a time. Windowed statistics are on
+ * with the default 1000-value window. Also times reading the median and
+ * p99 of a full window.
+ */
+class TestStatisticsPerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testByName();
+    void testByFrame();
+    void testByColumns();
+    void testPercentiles();
+
+private:
+    static double nsPerField(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+            / (static_cast<double>(PACKETS) * FIELD_COUNT);
+    }
+
+    std::vector<std::string> m_names;
+    FieldColumns m_values;      ///< Field by packet
+    double m_byNameNs = 0.0;
+
+    static constexpr PacketId PACKET_ID = 2400;
+    static constexpr int FIELD_COUNT = 30;
+    static constexpr int PACKETS = 20000;
+    static constexpr int BATCH = 256;
+};
+
+void TestStatisticsPerformance::initTestCase()
+{
+    m_values.resize(FIELD_COUNT, PACKETS);
+    uint32_t state = 2024;
+    for (int field = 0; field < FIELD_COUNT; ++field) {
+        m_names.push_back("field_" + std::to_string(field));
+        double* values = m_values.reals(field);
+        for (int packet = 0; packet < PACKETS; ++packet) {
+            state = state * 1664525u + 1013904223u;
+            values[packet] = field * 100.0 + static_cast<double>(state >> 16) / 65536.0;
+        }
+    }
+}
+
+void TestStatisticsPerformance::testByName()
+{
+    StatisticsCalculator calculator;
+    std::unordered_map<std::string, FieldExtractor::ExtractionResult> fields;
+    for (const std::string& name : m_names) {
+        fields[name] = FieldExtractor::ExtractionResult(FieldExtractor::FieldValue(0.0));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int packet = 0; packet < PACKETS; ++packet) {
+        for (int field = 0; field < FIELD_COUNT; ++field) {
+            fields[m_names[field]].value = m_values.real(field, packet);
+        }
+        calculator.updateStatistics(fields);
+    }
+    m_byNameNs = nsPerField(start);
+
+    QCOMPARE(calculator.getTotalSamples(), uint64_t(PACKETS) * FIELD_COUNT);
+    qDebug() << QString("By name: %1 ns/field").arg(m_byNameNs, 0, 'f', 1);
+}
+
+void TestStatisticsPerformance::testByFrame()
+{
+    StatisticsCalculator calculator;
+    FieldFrame frame(FIELD_COUNT);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int packet = 0; packet < PACKETS; ++packet) {
+        for (int field = 0; field < FIELD_COUNT; ++field) {
+            frame.reals()[field] = m_values.real(field, packet);
+        }
+        calculator.updateStatistics(PACKET_ID, frame);
+    }
+    const double ns = nsPerField(start);
+
+    QCOMPARE(calculator.getTotalSamples(), uint64_t(PACKETS) * FIELD_COUNT);
+    qDebug() << QString("By frame: %1 ns/field, %2x by name")
+        .arg(ns, 0, 'f', 1)
+        .arg(m_byNameNs > 0.0 ? m_byNameNs / ns : 0.0, 0, 'f', 2);
+}
+
+void TestStatisticsPerformance::testByColumns()
+{
+    StatisticsCalculator calculator;
+    FieldColumns batch(FIELD_COUNT, BATCH);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int first = 0; first < PACKETS; first += BATCH) {
+        const int rows = std::min(BATCH, PACKETS - first);
+        for (int field = 0; field < FIELD_COUNT; ++field) {
+            std::copy(m_values.reals(field) + first, m_values.reals(field) + first + rows, batch.reals(field));
+        }
+        calculator.updateStatistics(PACKET_ID + 1, batch, rows);
+    }
+    const double ns = nsPerField(start);
+
+    QCOMPARE(calculator.getTotalSamples(), uint64_t(PACKETS) * FIELD_COUNT);
+    qDebug() << QString("By columns: %1 ns/field, %2x by name")
+        .arg(ns, 0, 'f', 1)
+        .arg(m_byNameNs > 0.0 ? m_byNameNs / ns : 0.0, 0, 'f', 2);
+}
+
+void TestStatisticsPerformance::testPercentiles()
+{
+    StatisticsCalculator calculator;
+    FieldColumns batch(FIELD_COUNT, BATCH);
+    for (int first = 0; first < PACKETS; first += BATCH) {
+        const int rows = std::min(BATCH, PACKETS - first);
+        for (int field = 0; field < FIELD_COUNT; ++field) {
+            std::copy(m_values.reals(field) + first, m_values.reals(field) + first + rows, batch.reals(field));
+        }
+        calculator.updateStatistics(PACKET_ID + 2, batch, rows);
+    }
+
+    const int queries = 1000;
+    double checksum = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int query = 0; query < queries; ++query) {
+        const auto percentiles = calculator.calculatePercentiles(PACKET_ID + 2, query % FIELD_COUNT, {50.0, 99.0});
+        checksum += percentiles[0] + percentiles[1];
+    }
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+        / queries;
+
+    QVERIFY(checksum > 0.0);
+    qDebug() << QString("Median and p99 of a %1-value window: %2 us")
+        .arg(calculator.getConfiguration().windowSize)
+        .arg(us, 0, 'f', 2);
+}
+
+QTEST_MAIN(TestStatisticsPerformance)
+#include "test_statistics_performance.moc"
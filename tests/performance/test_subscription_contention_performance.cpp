@@ -0,0 +1,176 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../../src/packet/routing/subscription_manager.h"
+#include "../../src/packet/core/packet_factory.h"
+#include "../../src/memory/memory_pool.h"
+
+using namespace Monitor;
+using namespace Monitor::Packet;
+
+/**
+ * @brief SubscriptionManager delivery under router-thread contention
+ *
+ * Eight threads stand in for the router workers and distribute packets to
+ * 200 subscribers as fast as they can, while another thread keeps
+ * subscribing and unsubscribing as widgets are opened and closed. Reports
+ * the delivery rate and how long subscription changes take, with and
+ * without the churn and with one subscriber whose callback is slow.
+ */
+class TestSubscriptionContentionPerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testContendedDelivery_data();
+    void testContendedDelivery();
+
+private:
+    Memory::MemoryPoolManager* m_memoryManager = nullptr;
+    std::vector<PacketPtr> m_packets;
+
+    static constexpr int ROUTER_THREADS = 8;
+    static constexpr int SUBSCRIBERS = 200;
+    static constexpr int PACKET_TYPES = 20;
+    static constexpr int RUN_MS = 2000;
+};
+
+void TestSubscriptionContentionPerformance::initTestCase()
+{
+    m_memoryManager = new Memory::MemoryPoolManager();
+    PacketFactory factory(m_memoryManager);
+
+    for (int i = 0; i < PACKET_TYPES; ++i) {
+        auto result = factory.createPacket(static_cast<PacketId>(100 + i), nullptr, 64);
+        QVERIFY(result.success);
+        m_packets.push_back(result.packet);
+    }
+}
+
+void TestSubscriptionContentionPerformance::cleanupTestCase()
+{
+    m_packets.clear();
+    delete m_memoryManager;
+}
+
+void TestSubscriptionContentionPerformance::testContendedDelivery_data()
+{
+    QTest::addColumn<bool>("churn");
+    QTest::addColumn<bool>("slowSubscriber");
+
+    QTest::newRow("steady") << false << false;
+    QTest::newRow("churn") << true << false;
+    QTest::newRow("churn, slow subscriber") << true << true;
+}
+
+void TestSubscriptionContentionPerformance::testContendedDelivery()
+{
+    QFETCH(bool, churn);
+    QFETCH(bool, slowSubscriber);
+
+    SubscriptionManager manager;
+
+    // Padded so the subscribers' own counters do not share cache lines
+    struct alignas(64) Counter {
+        std::atomic<uint64_t> value{0};
+    };
+    std::vector<Counter> counters(SUBSCRIBERS);
+
+    std::vector<SubscriptionManager::SubscriberId> ids;
+    for (int i = 0; i < SUBSCRIBERS; ++i) {
+        Counter* counter = &counters[i];
+        ids.push_back(manager.subscribe("Subscriber" + std::to_string(i), static_cast<PacketId>(100 + i % PACKET_TYPES),
+            [counter](PacketPtr) { counter->value.fetch_add(1, std::memory_order_relaxed); }, i % 4));
+    }
+    if (slowSubscriber) {
+        ids.push_back(manager.subscribe("Slow", 100, [](PacketPtr) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }, 0));
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> packets{0};
+    std::atomic<uint64_t> deliveries{0};
+
+    std::vector<std::thread> routers;
+    for (int t = 0; t < ROUTER_THREADS; ++t) {
+        routers.emplace_back([&, t]() {
+            uint64_t sent = 0;
+            uint64_t delivered = 0;
+            for (size_t i = static_cast<size_t>(t); !stop.load(std::memory_order_relaxed); ++i) {
+                delivered += manager.distributePacket(m_packets[i % m_packets.size()]);
+                ++sent;
+            }
+            packets += sent;
+            deliveries += delivered;
+        });
+    }
+
+    // Subscription changes, timed from the caller's side
+    std::vector<double> changeUs;
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < RUN_MS) {
+        if (!churn) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto id = manager.subscribe("Churn", static_cast<PacketId>(100 + changeUs.size() % PACKET_TYPES),
+            [](PacketPtr) {}, 1);
+        const auto subscribed = std::chrono::steady_clock::now();
+        manager.unsubscribe(id);
+        const auto unsubscribed = std::chrono::steady_clock::now();
+
+        changeUs.push_back(std::chrono::duration<double, std::micro>(subscribed - start).count());
+        changeUs.push_back(std::chrono::duration<double, std::micro>(unsubscribed - subscribed).count());
+        std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    stop = true;
+    for (auto& router : routers) {
+        router.join();
+    }
+    const double seconds = timer.elapsed() / 1000.0;
+
+    for (auto id : ids) {
+        QVERIFY(manager.unsubscribe(id));
+    }
+    QCOMPARE(manager.getTotalSubscriberCount(), size_t(0));
+
+    uint64_t counted = 0;
+    for (const auto& counter : counters) {
+        counted += counter.value.load();
+    }
+    QVERIFY(counted > 0);
+
+    QString changes = "no subscription changes";
+    if (!changeUs.empty()) {
+        std::sort(changeUs.begin(), changeUs.end());
+        changes = QString("%1 subscription changes, median %2 us, p99 %3 us, max %4 us")
+            .arg(changeUs.size())
+            .arg(changeUs[changeUs.size() / 2], 0, 'f', 1)
+            .arg(changeUs[changeUs.size() * 99 / 100], 0, 'f', 1)
+            .arg(changeUs.back(), 0, 'f', 1);
+    }
+
+    qDebug() << QString("%1: %2 threads, %3 subscribers: %4 Mpackets/s, %5 Mdeliveries/s, %6")
+        .arg(QTest::currentDataTag())
+        .arg(ROUTER_THREADS)
+        .arg(ids.size())
+        .arg(static_cast<double>(packets.load()) / seconds / 1e6, 0, 'f', 2)
+        .arg(static_cast<double>(deliveries.load()) / seconds / 1e6, 0, 'f', 2)
+        .arg(changes);
+}
+
+QTEST_MAIN(TestSubscriptionContentionPerformance)
+#include "test_subscription_contention_performance.moc"
@@ -0,0 +1,144 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../../src/packet/processing/data_transformer.h"
+
+using namespace Monitor;
+using namespace Monitor::Packet;
+
+/**
+ * @brief Transformation chains on every field of every packet
+ *
+ * Runs a unit conversion followed by a moving average on 16 fields of
+ * 20000 packets, through DataTransformer::transform() one value at a time
+ * and through transformColumns() one 256-packet batch at a time. Also
+ * checks that a moving average costs the same with a window of 1000 as
+ * with a window of 10.
+ */
+class TestTransformKernelPerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testByValue();
+    void testByColumns();
+    void testWindowSize();
+
+private:
+    static double nsPerValue(std::chrono::steady_clock::time_point start, double values) {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / values;
+    }
+
+    void addChains(DataTransformer& transformer, size_t window) const;
+
+    std::vector<std::string> m_names;
+    FieldColumns m_values;      ///< Field by packet
+    double m_byValueNs = 0.0;
+
+    static constexpr PacketId PACKET_ID = 2500;
+    static constexpr int FIELD_COUNT = 16;
+    static constexpr int PACKETS = 20000;
+    static constexpr int BATCH = 256;
+};
+
+void TestTransformKernelPerformance::initTestCase()
+{
+    m_values.resize(FIELD_COUNT, PACKETS);
+    uint32_t state = 2025;
+    for (int field = 0; field < FIELD_COUNT; ++field) {
+        m_names.push_back("field_" + std::to_string(field));
+        double* values = m_values.reals(field);
+        for (int packet = 0; packet < PACKETS; ++packet) {
+            state = state * 1664525u + 1013904223u;
+            values[packet] = static_cast<double>(state >> 16);
+        }
+    }
+}
+
+void TestTransformKernelPerformance::addChains(DataTransformer& transformer, size_t window) const
+{
+    DataTransformer::TransformationParams average;
+    average.windowSize = window;
+    for (const std::string& name : m_names) {
+        transformer.addTransformationChain(name, {
+            DataTransformer::Transformation(DataTransformer::OperationType::Subtract, DataTransformer::TransformationParams(32768.0)),
+            DataTransformer::Transformation(DataTransformer::OperationType::Multiply, DataTransformer::TransformationParams(0.01)),
+            DataTransformer::Transformation(DataTransformer::OperationType::Add, DataTransformer::TransformationParams(20.0)),
+            DataTransformer::Transformation(DataTransformer::OperationType::MovingAverage, average)});
+    }
+}
+
+void TestTransformKernelPerformance::testByValue()
+{
+    DataTransformer transformer;
+    addChains(transformer, 100);
+
+    double checksum = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int packet = 0; packet < PACKETS; ++packet) {
+        for (int field = 0; field < FIELD_COUNT; ++field) {
+            const auto result = transformer.transform(m_names[field], FieldExtractor::FieldValue(m_values.real(field, packet)));
+            checksum += std::get<double>(result.value);
+        }
+    }
+    m_byValueNs = nsPerValue(start, static_cast<double>(PACKETS) * FIELD_COUNT);
+
+    QVERIFY(std::isfinite(checksum));
+    qDebug() << QString("By value: %1 ns/value").arg(m_byValueNs, 0, 'f', 1);
+}
+
+void TestTransformKernelPerformance::testByColumns()
+{
+    DataTransformer transformer;
+    addChains(transformer, 100);
+    QCOMPARE(transformer.bindColumns(PACKET_ID, m_names), size_t(FIELD_COUNT));
+
+    FieldColumns batch(FIELD_COUNT, BATCH);
+    double checksum = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int first = 0; first < PACKETS; first += BATCH) {
+        const int rows = std::min(BATCH, PACKETS - first);
+        for (int field = 0; field < FIELD_COUNT; ++field) {
+            std::copy(m_values.reals(field) + first, m_values.reals(field) + first + rows, batch.reals(field));
+        }
+        transformer.transformColumns(PACKET_ID, batch, rows);
+        checksum += batch.real(0, rows - 1);
+    }
+    const double ns = nsPerValue(start, static_cast<double>(PACKETS) * FIELD_COUNT);
+
+    QVERIFY(std::isfinite(checksum));
+    qDebug() << QString("By columns: %1 ns/value, %2x by value")
+        .arg(ns, 0, 'f', 1)
+        .arg(m_byValueNs > 0.0 ? m_byValueNs / ns : 0.0, 0, 'f', 2);
+}
+
+void TestTransformKernelPerformance::testWindowSize()
+{
+    double ns[2] = {};
+    const size_t windows[2] = {10, 1000};
+    for (int i = 0; i < 2; ++i) {
+        TransformKernel kernel;
+        kernel.movingAverage(windows[i]);
+        std::vector<double> output(PACKETS);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int field = 0; field < FIELD_COUNT; ++field) {
+            kernel.run(m_values.reals(field), output.data(), PACKETS);
+        }
+        ns[i] = nsPerValue(start, static_cast<double>(PACKETS) * FIELD_COUNT);
+    }
+
+    // Generous bound: the cost must not grow with the window
+    QVERIFY(ns[1] < ns[0] * 4.0 + 5.0);
+    qDebug() << QString("Moving average: %1 ns/value with a window of 10, %2 ns/value with 1000")
+        .arg(ns[0], 0, 'f', 1)
+        .arg(ns[1], 0, 'f', 1);
+}
+
+QTEST_MAIN(TestTransformKernelPerformance)
+#include "test_transform_kernel_performance.moc"
@@ -0,0 +1,406 @@
+#include <QtTest/QtTest>
+#include <QObject>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "../../src/threading/thread_pool.h"
+#include "../../src/packet/core/packet_factory.h"
+#include "../../src/packet/processing/field_extractor.h"
+#include "../../src/memory/memory_pool.h"
+
+using namespace Monitor;
+using namespace Monitor::Packet;
+using Monitor::Threading::ThreadPool;
+
+namespace {
+
+/**
+ * @brief The scheduler ThreadPool had before work stealing, for comparison
+ *
+ * One mutex-guarded priority queue of shared_ptr tasks wrapping a
+ * std::function per worker, and a scan of every queue's size under its
+ * lock to find the least loaded worker on each submission.
+ */
+class LockedQueuePool
+{
+public:
+    explicit LockedQueuePool(size_t workerCount)
+        : m_queues(workerCount)
+    {
+        for (size_t i = 0; i < workerCount; ++i) {
+            m_threads.emplace_back([this, i]() { run(m_queues[i]); });
+        }
+    }
+
+    ~LockedQueuePool() {
+        for (auto& queue : m_queues) {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.stop = true;
+            queue.wake.notify_one();
+        }
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    bool submitDetached(std::function<void()> function) {
+        auto task = std::make_shared<LegacyTask>(LegacyTask{std::move(function), 0});
+
+        Queue* leastLoaded = &m_queues[0];
+        size_t minSize = SIZE_MAX;
+        for (auto& queue : m_queues) {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.size() < minSize) {
+                minSize = queue.tasks.size();
+                leastLoaded = &queue;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(leastLoaded->mutex);
+        leastLoaded->tasks.push(std::move(task));
+        leastLoaded->wake.notify_one();
+        return true;
+    }
+
+private:
+    struct LegacyTask {
+        std::function<void()> function;
+        int priority;
+    };
+
+    using LegacyTaskPtr = std::shared_ptr<LegacyTask>;
+
+    struct Compare {
+        bool operator()(const LegacyTaskPtr& a, const LegacyTaskPtr& b) const {
+            return a->priority < b->priority;
+        }
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::priority_queue<LegacyTaskPtr, std::vector<LegacyTaskPtr>, Compare> tasks;
+        bool stop = false;
+    };
+
+    static void run(Queue& queue) {
+        for (;;) {
+            LegacyTaskPtr task;
+            {
+                std::unique_lock<std::mutex> lock(queue.mutex);
+                queue.wake.wait(lock, [&queue]() { return queue.stop || !queue.tasks.empty(); });
+                if (queue.stop) {
+                    return;
+                }
+                task = queue.tasks.top();
+                queue.tasks.pop();
+            }
+            task->function();
+        }
+    }
+
+    std::vector<Queue> m_queues;
+    std::vector<std::thread> m_threads;
+};
+
+/**
+ * @brief Shared state of one fork/join pass
+ */
+struct ForkJoinPass {
+    const std::vector<PacketPtr>* packets = nullptr;
+    const std::vector<FieldExtractor::FieldDescriptor>* fields = nullptr;
+    FieldExtractor* extractor = nullptr;
+    std::atomic<uint64_t> checksum{0};
+    std::atomic<size_t> pendingLeaves{0};
+};
+
+double numericValue(const FieldExtractor::FieldValue& value)
+{
+    return std::visit([](const auto& v) -> double {
+        using V = std::decay_t<decltype(v)>;
+        if constexpr (std::is_arithmetic_v<V>) {
+            return static_cast<double>(v);
+        } else {
+            return 0.0;
+        }
+    }, value);
+}
+
+/**
+ * @brief Extract every field of packets [begin, end) and fold them into a checksum
+ */
+uint64_t extractRange(const ForkJoinPass& pass, size_t begin, size_t end)
+{
+    uint64_t checksum = 0;
+    for (size_t i = begin; i < end; ++i) {
+        for (const auto& field : *pass.fields) {
+            auto result = pass.extractor->extractFieldByDescriptor((*pass.packets)[i], field);
+            checksum += static_cast<uint64_t>(numericValue(result.value));
+        }
+    }
+    return checksum;
+}
+
+/**
+ * @brief Halve [begin, end) until it is @p grain packets long, forking the upper half
+ */
+template<typename Pool>
+void forkExtract(Pool* pool, ForkJoinPass* pass, size_t begin, size_t end, size_t grain)
+{
+    while (end - begin > grain) {
+        const size_t middle = begin + (end - begin) / 2;
+        pool->submitDetached([pool, pass, middle, end, grain]() {
+            forkExtract(pool, pass, middle, end, grain);
+        });
+        end = middle;
+    }
+    pass->checksum.fetch_add(extractRange(*pass, begin, end), std::memory_order_relaxed);
+    pass->pendingLeaves.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+/**
+ * @brief Tree of 2^@p depth empty tasks, each forking one child per level below it
+ */
+template<typename Pool>
+void forkTree(Pool* pool, std::atomic<size_t>* pendingLeaves, int depth)
+{
+    while (depth > 0) {
+        --depth;
+        pool->submitDetached([pool, pendingLeaves, depth]() {
+            forkTree(pool, pendingLeaves, depth);
+        });
+    }
+    pendingLeaves->fetch_sub(1, std::memory_order_acq_rel);
+}
+
+size_t leafCount(size_t count, size_t grain)
+{
+    return count <= grain ? 1 : leafCount(count / 2, grain) + leafCount(count - count / 2, grain);
+}
+
+void waitFor(const std::atomic<size_t>& pending)
+{
+    while (pending.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Fork/join throughput of the work-stealing ThreadPool
+ *
+ * Runs the same recursive fork/join workloads on ThreadPool and on a
+ * reconstruction of the mutex-and-priority-queue scheduler it replaced:
+ * field extraction across 10k packets, split in halves down to a grain
+ * of packets with the upper half forked at every level, and a tree of
+ * empty tasks that measures scheduling overhead alone.
+ */
+class TestWorkStealingPerformance : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testFieldExtraction_data();
+    void testFieldExtraction();
+
+    void testTaskOverhead_data();
+    void testTaskOverhead();
+
+private:
+    template<typename Pool>
+    double runFieldExtraction(Pool* pool, uint64_t& checksum);
+
+    template<typename Pool>
+    double runTaskTree(Pool* pool);
+
+    Memory::MemoryPoolManager* m_memoryManager = nullptr;
+    FieldExtractor* m_extractor = nullptr;
+    std::vector<PacketPtr> m_packets;
+    std::vector<FieldExtractor::FieldDescriptor> m_fields;
+    uint64_t m_expectedChecksum = 0;
+
+    static constexpr size_t WORKER_THREADS = 4;
+    static constexpr size_t PACKET_COUNT = 4096;
+    static constexpr size_t PAYLOAD_SIZE = 64;
+    static constexpr size_t GRAIN = 32;
+    static constexpr int EXTRACTION_PASSES = 50;
+    static constexpr int TREE_DEPTH = 16;
+    static constexpr int TREE_PASSES = 10;
+};
+
+void TestWorkStealingPerformance::initTestCase()
+{
+    m_memoryManager = new Memory::MemoryPoolManager();
+    m_extractor = new FieldExtractor();
+    PacketFactory factory(m_memoryManager);
+
+    m_fields = {
+        {"sequence", 0, 4, "unsigned int"},
+        {"offset", 4, 4, "int"},
+        {"flags", 8, 2, "unsigned short"},
+        {"channel", 10, 2, "unsigned short"},
+        {"value", 16, 8, "double"},
+        {"timestamp", 24, 8, "long long"}
+    };
+
+    uint8_t payload[PAYLOAD_SIZE] = {};
+    for (size_t i = 0; i < PACKET_COUNT; ++i) {
+        const uint32_t sequence = static_cast<uint32_t>(i);
+        const int32_t offset = static_cast<int32_t>(i % 100);
+        const uint16_t flags = static_cast<uint16_t>(i & 0xFF);
+        const uint16_t channel = static_cast<uint16_t>(i % 8);
+        const double value = static_cast<double>(i) * 0.5;
+        const int64_t timestamp = static_cast<int64_t>(i) * 1000;
+        std::memcpy(payload, &sequence, 4);
+        std::memcpy(payload + 4, &offset, 4);
+        std::memcpy(payload + 8, &flags, 2);
+        std::memcpy(payload + 10, &channel, 2);
+        std::memcpy(payload + 16, &value, 8);
+        std::memcpy(payload + 24, &timestamp, 8);
+
+        auto result = factory.createPacket(static_cast<PacketId>(900), payload, PAYLOAD_SIZE);
+        QVERIFY(result.success);
+        m_packets.push_back(result.packet);
+    }
+
+    ForkJoinPass reference;
+    reference.packets = &m_packets;
+    reference.fields = &m_fields;
+    reference.extractor = m_extractor;
+    m_expectedChecksum = extractRange(reference, 0, m_packets.size());
+}
+
+void TestWorkStealingPerformance::cleanupTestCase()
+{
+    m_packets.clear();
+    delete m_extractor;
+    delete m_memoryManager;
+}
+
+template<typename Pool>
+double TestWorkStealingPerformance::runFieldExtraction(Pool* pool, uint64_t& checksum)
+{
+    const size_t leaves = leafCount(m_packets.size(), GRAIN);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < EXTRACTION_PASSES; ++pass) {
+        ForkJoinPass state;
+        state.packets = &m_packets;
+        state.fields = &m_fields;
+        state.extractor = m_extractor;
+        state.pendingLeaves.store(leaves);
+
+        const size_t count = m_packets.size();
+        pool->submitDetached([pool, &state, count]() {
+            forkExtract(pool, &state, 0, count, GRAIN);
+        });
+        waitFor(state.pendingLeaves);
+        checksum = state.checksum.load();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return seconds / EXTRACTION_PASSES;
+}
+
+template<typename Pool>
+double TestWorkStealingPerformance::runTaskTree(Pool* pool)
+{
+    const size_t tasks = size_t(1) << TREE_DEPTH;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < TREE_PASSES; ++pass) {
+        std::atomic<size_t> pendingLeaves{tasks};
+        pool->submitDetached([pool, &pendingLeaves]() {
+            forkTree(pool, &pendingLeaves, TREE_DEPTH);
+        });
+        waitFor(pendingLeaves);
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(tasks) * TREE_PASSES / seconds;
+}
+
+void TestWorkStealingPerformance::testFieldExtraction_data()
+{
+    QTest::addColumn<bool>("workStealing");
+
+    QTest::newRow("locked queues") << false;
+    QTest::newRow("work stealing") << true;
+}
+
+void TestWorkStealingPerformance::testFieldExtraction()
+{
+    QFETCH(bool, workStealing);
+
+    uint64_t checksum = 0;
+    double secondsPerPass = 0.0;
+    size_t steals = 0;
+
+    if (workStealing) {
+        ThreadPool pool;
+        QVERIFY(pool.initialize(WORKER_THREADS));
+        pool.start();
+        secondsPerPass = runFieldExtraction(&pool, checksum);
+        steals = pool.getTotalTasksStolen();
+        pool.shutdown();
+    } else {
+        LockedQueuePool pool(WORKER_THREADS);
+        secondsPerPass = runFieldExtraction(&pool, checksum);
+    }
+
+    QCOMPARE(checksum, m_expectedChecksum);
+
+    const double fieldsPerPass = static_cast<double>(m_packets.size() * m_fields.size());
+    qDebug() << QString("%1: %2 packets x %3 fields in %4 ms per pass (%5 Mfields/s), %6 steals")
+        .arg(QTest::currentDataTag())
+        .arg(m_packets.size())
+        .arg(m_fields.size())
+        .arg(secondsPerPass * 1000.0, 0, 'f', 3)
+        .arg(fieldsPerPass / secondsPerPass / 1e6, 0, 'f', 2)
+        .arg(steals);
+}
+
+void TestWorkStealingPerformance::testTaskOverhead_data()
+{
+    QTest::addColumn<bool>("workStealing");
+
+    QTest::newRow("locked queues") << false;
+    QTest::newRow("work stealing") << true;
+}
+
+void TestWorkStealingPerformance::testTaskOverhead()
+{
+    QFETCH(bool, workStealing);
+
+    double tasksPerSecond = 0.0;
+    if (workStealing) {
+        ThreadPool pool;
+        QVERIFY(pool.initialize(WORKER_THREADS));
+        pool.start();
+        tasksPerSecond = runTaskTree(&pool);
+        pool.shutdown();
+    } else {
+        LockedQueuePool pool(WORKER_THREADS);
+        tasksPerSecond = runTaskTree(&pool);
+    }
+
+    qDebug() << QString("%1: empty fork/join tree of %2 tasks, %3 Mtasks/s")
+        .arg(QTest::currentDataTag())
+        .arg(size_t(1) << TREE_DEPTH)
+        .arg(tasksPerSecond / 1e6, 0, 'f', 2);
+}
+
+QTEST_MAIN(TestWorkStealingPerformance)
+#include "test_work_stealing_performance.moc"
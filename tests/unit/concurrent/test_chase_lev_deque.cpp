@@ -0,0 +1,146 @@
+#include <QtTest/QTest>
+#include <QtCore/QObject>
+#include "../../../src/concurrent/chase_lev_deque.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using Monitor::Concurrent::ChaseLevDeque;
+
+class TestChaseLevDeque : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testOwnerIsLastInFirstOut();
+    void testThievesTakeOldestFirst();
+    void testGrowth();
+    void testConcurrentStealing();
+};
+
+void TestChaseLevDeque::testOwnerIsLastInFirstOut()
+{
+    ChaseLevDeque<intptr_t> deque(4);
+    intptr_t value = 0;
+    QVERIFY(!deque.pop(value));
+    QVERIFY(deque.empty());
+
+    for (intptr_t i = 1; i <= 3; ++i) {
+        deque.push(i);
+    }
+    QCOMPARE(deque.size(), size_t(3));
+
+    QVERIFY(deque.pop(value));
+    QCOMPARE(value, intptr_t(3));
+    QVERIFY(deque.pop(value));
+    QCOMPARE(value, intptr_t(2));
+    QVERIFY(deque.pop(value));
+    QCOMPARE(value, intptr_t(1));
+    QVERIFY(!deque.pop(value));
+    QCOMPARE(deque.size(), size_t(0));
+}
+
+void TestChaseLevDeque::testThievesTakeOldestFirst()
+{
+    ChaseLevDeque<intptr_t> deque(4);
+    for (intptr_t i = 1; i <= 3; ++i) {
+        deque.push(i);
+    }
+
+    intptr_t value = 0;
+    QVERIFY(deque.steal(value));
+    QCOMPARE(value, intptr_t(1));
+
+    // Both ends meet on the last element
+    QVERIFY(deque.pop(value));
+    QCOMPARE(value, intptr_t(3));
+    QVERIFY(deque.steal(value));
+    QCOMPARE(value, intptr_t(2));
+    QVERIFY(!deque.steal(value));
+    QVERIFY(!deque.pop(value));
+}
+
+void TestChaseLevDeque::testGrowth()
+{
+    ChaseLevDeque<intptr_t> deque(2);
+    intptr_t value = 0;
+
+    // Wrap the ring a few times before it has to grow
+    for (intptr_t i = 0; i < 10; ++i) {
+        deque.push(i);
+        QVERIFY(deque.steal(value));
+        QCOMPARE(value, i);
+    }
+    QCOMPARE(deque.capacity(), size_t(2));
+
+    for (intptr_t i = 0; i < 100; ++i) {
+        deque.push(i);
+    }
+    QVERIFY(deque.capacity() >= 100);
+    QCOMPARE(deque.size(), size_t(100));
+
+    QVERIFY(deque.steal(value));
+    QCOMPARE(value, intptr_t(0));
+    for (intptr_t i = 99; i > 0; --i) {
+        QVERIFY(deque.pop(value));
+        QCOMPARE(value, i);
+    }
+    QVERIFY(deque.empty());
+}
+
+void TestChaseLevDeque::testConcurrentStealing()
+{
+    const int thiefCount = 4;
+    const intptr_t itemCount = 200000;
+
+    // Starts small so thieves race with the owner growing the ring
+    ChaseLevDeque<intptr_t> deque(2);
+    std::vector<std::atomic<int>> taken(static_cast<size_t>(itemCount));
+    std::atomic<bool> done{false};
+    std::atomic<intptr_t> stolen{0};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < thiefCount; ++t) {
+        thieves.emplace_back([&]() {
+            intptr_t value = 0;
+            intptr_t count = 0;
+            while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+                if (deque.steal(value)) {
+                    taken[static_cast<size_t>(value)].fetch_add(1, std::memory_order_relaxed);
+                    ++count;
+                }
+            }
+            stolen += count;
+        });
+    }
+
+    // The owner pushes in bursts and pops some back, as a forking worker does
+    intptr_t popped = 0;
+    intptr_t value = 0;
+    for (intptr_t i = 0; i < itemCount; ++i) {
+        deque.push(i);
+        if (i % 3 == 0 && deque.pop(value)) {
+            taken[static_cast<size_t>(value)].fetch_add(1, std::memory_order_relaxed);
+            ++popped;
+        }
+    }
+    while (deque.pop(value)) {
+        taken[static_cast<size_t>(value)].fetch_add(1, std::memory_order_relaxed);
+        ++popped;
+    }
+    done.store(true, std::memory_order_release);
+
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    // Every element is taken exactly once, by either end
+    QCOMPARE(popped + stolen.load(), itemCount);
+    for (intptr_t i = 0; i < itemCount; ++i) {
+        QCOMPARE(taken[static_cast<size_t>(i)].load(), 1);
+    }
+}
+
+QTEST_MAIN(TestChaseLevDeque)
+#include "test_chase_lev_deque.moc"
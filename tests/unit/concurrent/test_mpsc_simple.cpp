@@ -2,6 +2,7 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <vector>
 
 #include "concurrent/mpsc_ring_buffer.h"
 
@@ -18,6 +19,8 @@ private slots:
     void testBasicConstruction();
     void testBasicPushPop();
     void testMultipleProducers();
+    void testBatchPushPop();
+    void testConcurrentBatches();
 
 };
 
@@ -108,5 +111,104 @@ void TestMPSCSimple::testMultipleProducers()
     QVERIFY(buffer.empty());
 }
 
+void TestMPSCSimple::testBatchPushPop()
+{
+    MPSCRingBuffer<int> buffer(8);
+    
+    // A batch larger than the free space is pushed partially
+    int items[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    QCOMPARE(buffer.tryPushBatch(items, 5), static_cast<size_t>(5));
+    QCOMPARE(buffer.tryPushBatch(items + 5, 7), static_cast<size_t>(3));
+    QVERIFY(buffer.full());
+    QCOMPARE(buffer.tryPushBatch(items + 8, 4), static_cast<size_t>(0));
+    
+    int popped[12] = {};
+    QCOMPARE(buffer.tryPopBatch(popped, 3), static_cast<size_t>(3));
+    QCOMPARE(buffer.tryPopBatch(popped + 3, 12), static_cast<size_t>(5));
+    for (int i = 0; i < 8; ++i) {
+        QCOMPARE(popped[i], i);
+    }
+    QVERIFY(buffer.empty());
+    QCOMPARE(buffer.tryPopBatch(popped, 4), static_cast<size_t>(0));
+    
+    // Batches wrap around the end of the buffer
+    QCOMPARE(buffer.tryPushBatch(items + 8, 4), static_cast<size_t>(4));
+    QCOMPARE(buffer.tryPopBatch(popped, 12), static_cast<size_t>(4));
+    QCOMPARE(popped[0], 8);
+    QCOMPARE(popped[3], 11);
+}
+
+void TestMPSCSimple::testConcurrentBatches()
+{
+    const int numProducers = 4;
+    const int numConsumers = 2;
+    const int itemsPerProducer = 20000;
+    const int batchSize = 16;
+    
+    MPSCRingBuffer<int> buffer(256);
+    std::atomic<int> totalConsumed{0};
+    std::vector<std::vector<int>> consumed(numConsumers);
+    
+    // Batch consumers; each value is p * itemsPerProducer + i
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < numConsumers; ++c) {
+        consumers.emplace_back([&, c]() {
+            int values[batchSize];
+            while (totalConsumed.load() < numProducers * itemsPerProducer) {
+                size_t count = buffer.tryPopBatch(values, batchSize);
+                if (count == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                consumed[c].insert(consumed[c].end(), values, values + count);
+                totalConsumed.fetch_add(static_cast<int>(count));
+            }
+        });
+    }
+    
+    // Batch producers with odd batch sizes so batches straddle the wrap
+    std::vector<std::thread> producers;
+    for (int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            std::vector<int> values(itemsPerProducer);
+            for (int i = 0; i < itemsPerProducer; ++i) {
+                values[i] = p * itemsPerProducer + i;
+            }
+            size_t next = 0;
+            while (next < values.size()) {
+                size_t count = std::min(values.size() - next, static_cast<size_t>(1 + (next % 13)));
+                size_t pushed = buffer.tryPushBatch(values.data() + next, count);
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+                next += pushed;
+            }
+        });
+    }
+    
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+    
+    // Every value arrives once, and each consumer sees a producer's values in order
+    std::vector<int> seen(numProducers * itemsPerProducer, 0);
+    for (const auto& values : consumed) {
+        std::vector<int> last(numProducers, -1);
+        for (int value : values) {
+            seen[value]++;
+            int producer = value / itemsPerProducer;
+            QVERIFY(value > last[producer]);
+            last[producer] = value;
+        }
+    }
+    for (int count : seen) {
+        QCOMPARE(count, 1);
+    }
+    QVERIFY(buffer.empty());
+}
+
 QTEST_MAIN(TestMPSCSimple)
 #include "test_mpsc_simple.moc"
\ No newline at end of file
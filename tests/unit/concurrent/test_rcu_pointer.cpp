@@ -0,0 +1,157 @@
+#include <QtTest/QTest>
+#include <QtCore/QObject>
+#include "../../../src/concurrent/rcu_pointer.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using Monitor::Concurrent::EpochDomain;
+using Monitor::Concurrent::RcuPointer;
+
+class TestRcuPointer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testPublishAndLoad();
+    void testReclaimWaitsForReaders();
+    void testNestedGuards();
+    void testConcurrentReaders();
+
+private:
+    /**
+     * @brief Counts live instances and detects reads of freed objects
+     */
+    struct Tracked {
+        static std::atomic<int> s_live;
+
+        int value;
+        int check;
+
+        explicit Tracked(int v = 0) : value(v), check(~v) { s_live++; }
+        ~Tracked() { check = value; s_live--; }
+
+        bool intact() const { return check == ~value; }
+    };
+};
+
+std::atomic<int> TestRcuPointer::Tracked::s_live{0};
+
+void TestRcuPointer::testPublishAndLoad()
+{
+    {
+        RcuPointer<Tracked> pointer(std::make_unique<Tracked>(1));
+        {
+            EpochDomain::ReadGuard guard;
+            QCOMPARE(pointer.load()->value, 1);
+        }
+
+        pointer.publish(std::make_unique<Tracked>(2));
+        {
+            EpochDomain::ReadGuard guard;
+            QCOMPARE(pointer.load()->value, 2);
+        }
+
+        // Without readers the replaced object is freed straight away
+        QCOMPARE(pointer.retiredCount(), size_t(0));
+        QCOMPARE(Tracked::s_live.load(), 1);
+    }
+    QCOMPARE(Tracked::s_live.load(), 0);
+}
+
+void TestRcuPointer::testReclaimWaitsForReaders()
+{
+    RcuPointer<Tracked> pointer(std::make_unique<Tracked>(1));
+
+    std::atomic<bool> loaded{false};
+    std::atomic<bool> release{false};
+    std::atomic<bool> intact{false};
+    std::thread reader([&]() {
+        EpochDomain::ReadGuard guard;
+        const Tracked* object = pointer.load();
+        loaded = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+        intact = object->intact() && object->value == 1;
+    });
+
+    while (!loaded) {
+        std::this_thread::yield();
+    }
+
+    pointer.publish(std::make_unique<Tracked>(2));
+    pointer.publish(std::make_unique<Tracked>(3));
+    QCOMPARE(pointer.retiredCount(), size_t(2));
+    QCOMPARE(Tracked::s_live.load(), 3);
+
+    release = true;
+    reader.join();
+    QVERIFY(intact.load());
+
+    QCOMPARE(pointer.reclaim(), size_t(0));
+    QCOMPARE(Tracked::s_live.load(), 1);
+}
+
+void TestRcuPointer::testNestedGuards()
+{
+    RcuPointer<Tracked> pointer(std::make_unique<Tracked>(1));
+
+    EpochDomain::ReadGuard outer;
+    const Tracked* object = pointer.load();
+    {
+        EpochDomain::ReadGuard inner;
+        QCOMPARE(pointer.load(), object);
+    }
+
+    // The outer section still protects the object after the inner one ends
+    pointer.publish(std::make_unique<Tracked>(2));
+    QCOMPARE(pointer.retiredCount(), size_t(1));
+    QVERIFY(object->intact());
+}
+
+void TestRcuPointer::testConcurrentReaders()
+{
+    const int readerCount = 4;
+    const int publishCount = 20000;
+
+    RcuPointer<Tracked> pointer(std::make_unique<Tracked>(0));
+    std::atomic<bool> stop{false};
+    std::atomic<int> corrupted{0};
+    std::atomic<int> wentBack{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < readerCount; ++r) {
+        readers.emplace_back([&]() {
+            int last = 0;
+            while (!stop) {
+                EpochDomain::ReadGuard guard;
+                const Tracked* object = pointer.load();
+                if (!object->intact()) {
+                    corrupted++;
+                }
+                if (object->value < last) {
+                    wentBack++;
+                }
+                last = object->value;
+            }
+        });
+    }
+
+    for (int i = 1; i <= publishCount; ++i) {
+        pointer.publish(std::make_unique<Tracked>(i));
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    QCOMPARE(corrupted.load(), 0);
+    QCOMPARE(wentBack.load(), 0);
+    QCOMPARE(pointer.reclaim(), size_t(0));
+    QCOMPARE(Tracked::s_live.load(), 1);
+}
+
+QTEST_MAIN(TestRcuPointer)
+#include "test_rcu_pointer.moc"
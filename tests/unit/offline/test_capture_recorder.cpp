@@ -0,0 +1,312 @@
+#include <QCoreApplication>
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QThread>
+
+#include "../../../src/offline/recording/capture_recorder.h"
+#include "../../../src/offline/sources/file_indexer.h"
+#include "../../../src/packet/routing/packet_dispatcher.h"
+#include "../../../src/packet/core/packet_factory.h"
+#include "../../../src/memory/memory_pool.h"
+#include "../../../src/packet/core/packet_header.h"
+
+using namespace Monitor;
+using Offline::CaptureRecorder;
+
+class TestCaptureRecorder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void cleanup();
+
+    void testRecordAndIndex();
+    void testRotation_data();
+    void testRotation();
+    void testDirectIo();
+    void testRejectedPackets();
+    void testDispatcherRecording();
+
+private:
+    QByteArray createTestPacket(uint32_t id, uint32_t sequence, uint32_t payloadSize);
+    QByteArray readFile(const QString& filename);
+    CaptureRecorder::Configuration createConfig(const QString& subdirectory);
+
+    QTemporaryDir* m_tempDir;
+    QStringList m_recordedFiles;
+
+    static const int TEST_TIMEOUT_MS = 5000;
+};
+
+const int TestCaptureRecorder::TEST_TIMEOUT_MS;
+
+void TestCaptureRecorder::initTestCase()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestCaptureRecorder::cleanupTestCase()
+{
+    delete m_tempDir;
+}
+
+void TestCaptureRecorder::cleanup()
+{
+    // Index caches live outside the temporary directory
+    for (const QString& filename : m_recordedFiles) {
+        QFile::remove(Offline::FileIndexer::getCacheFilename(filename));
+    }
+    m_recordedFiles.clear();
+}
+
+void TestCaptureRecorder::testRecordAndIndex()
+{
+    CaptureRecorder recorder(createConfig("record"));
+    QVERIFY(recorder.start());
+    QVERIFY(recorder.isRecording());
+
+    QByteArray expected;
+    for (uint32_t i = 0; i < 5000; ++i) {
+        const QByteArray packet = createTestPacket(1 + (i % 7), i, (i * 37) % 1500);
+        QVERIFY(recorder.record(reinterpret_cast<const uchar*>(packet.constData()), packet.size()));
+        expected.append(packet);
+    }
+
+    recorder.stop();
+    QVERIFY(!recorder.isRecording());
+
+    m_recordedFiles = recorder.getCompletedFiles();
+    QCOMPARE(m_recordedFiles.size(), 1);
+    QCOMPARE(readFile(m_recordedFiles.first()), expected);
+
+    const auto& stats = recorder.getStatistics();
+    QCOMPARE(stats.packetsRecorded.load(), uint64_t(5000));
+    QCOMPARE(stats.packetsDropped.load(), uint64_t(0));
+    QCOMPARE(stats.bytesWritten.load(), static_cast<uint64_t>(expected.size()));
+    QCOMPARE(stats.filesCompleted.load(), uint64_t(1));
+
+    // The index built while writing matches a scan of the file
+    QVERIFY(Offline::FileIndexer::isCacheValid(m_recordedFiles.first()));
+    Offline::FileIndexer cached;
+    QVERIFY(cached.loadIndexFromCache(Offline::FileIndexer::getCacheFilename(m_recordedFiles.first())));
+    QVERIFY(cached.isIndexingComplete());
+
+    Offline::FileIndexer scanned;
+    QVERIFY(scanned.startIndexing(m_recordedFiles.first(), false));
+    QCOMPARE(cached.getPacketCount(), uint64_t(5000));
+    QCOMPARE(scanned.getPacketCount(), uint64_t(5000));
+    for (size_t i = 0; i < 5000; ++i) {
+        const auto& a = cached.getIndex()[i];
+        const auto& b = scanned.getIndex()[i];
+        QCOMPARE(a.filePosition, b.filePosition);
+        QCOMPARE(a.packetSize, b.packetSize);
+        QCOMPARE(a.timestamp, b.timestamp);
+        QCOMPARE(a.packetId, b.packetId);
+        QCOMPARE(a.sequenceNumber, b.sequenceNumber);
+    }
+    QCOMPARE(cached.findPacketsByPacketId(3).size(), scanned.findPacketsByPacketId(3).size());
+}
+
+void TestCaptureRecorder::testRotation_data()
+{
+    QTest::addColumn<qint64>("maxFileSize");
+    QTest::addColumn<int>("maxFileDurationMs");
+
+    QTest::newRow("size") << qint64(256 * 1024) << 0;
+    QTest::newRow("age") << qint64(0) << 20;
+}
+
+void TestCaptureRecorder::testRotation()
+{
+    QFETCH(qint64, maxFileSize);
+    QFETCH(int, maxFileDurationMs);
+
+    CaptureRecorder::Configuration config = createConfig(QString("rotation_%1").arg(QTest::currentDataTag()));
+    config.maxFileSize = maxFileSize;
+    config.maxFileDurationMs = maxFileDurationMs;
+    config.flushIntervalMs = 5;
+
+    QStringList notified;
+    CaptureRecorder recorder(config);
+    recorder.setFileCallback([&](const QString& filename, uint64_t, qint64) {
+        notified.append(filename);
+    });
+    QVERIFY(recorder.start());
+
+    QByteArray expected;
+    for (uint32_t i = 0; i < 4000; ++i) {
+        const QByteArray packet = createTestPacket(1, i, 200);
+        QVERIFY(recorder.record(reinterpret_cast<const uchar*>(packet.constData()), packet.size()));
+        expected.append(packet);
+        if (i % 1000 == 999) {
+            QThread::msleep(50);
+        }
+    }
+    recorder.stop();
+
+    m_recordedFiles = recorder.getCompletedFiles();
+    QVERIFY(m_recordedFiles.size() >= 3);
+    QCOMPARE(notified, m_recordedFiles);
+
+    // Files hold whole packets and concatenate back to the recorded stream
+    QByteArray recorded;
+    for (const QString& filename : m_recordedFiles) {
+        const QByteArray contents = readFile(filename);
+        QVERIFY(!contents.isEmpty());
+        if (maxFileSize > 0) {
+            QVERIFY(contents.size() <= maxFileSize);
+        }
+
+        Offline::FileIndexer indexer;
+        QVERIFY(indexer.loadIndexFromCache(Offline::FileIndexer::getCacheFilename(filename)));
+        QCOMPARE(static_cast<int>(indexer.getPacketCount()), contents.size() / 224);
+        recorded.append(contents);
+    }
+    QCOMPARE(recorded, expected);
+}
+
+void TestCaptureRecorder::testDirectIo()
+{
+    CaptureRecorder::Configuration config = createConfig("direct");
+    config.directIo = true;
+    config.bufferSize = CaptureRecorder::MIN_BUFFER_SIZE;
+    config.maxFileSize = 1024 * 1024;
+    config.flushIntervalMs = 1;
+
+    CaptureRecorder recorder(config);
+    QVERIFY(recorder.start());
+    qDebug() << "Direct I/O in use:" << recorder.isDirectIo();
+
+    // Odd packet sizes leave partial blocks at every buffer boundary
+    QByteArray expected;
+    for (uint32_t i = 0; i < 20000; ++i) {
+        const QByteArray packet = createTestPacket(2, i, 1 + (i * 131) % 3001);
+        QVERIFY(recorder.record(reinterpret_cast<const uchar*>(packet.constData()), packet.size()));
+        expected.append(packet);
+        if (i % 500 == 0) {
+            QThread::msleep(2);
+        }
+    }
+    recorder.stop();
+
+    m_recordedFiles = recorder.getCompletedFiles();
+    QVERIFY(m_recordedFiles.size() > 1);
+
+    QByteArray recorded;
+    uint64_t indexedPackets = 0;
+    for (const QString& filename : m_recordedFiles) {
+        QVERIFY(Offline::FileIndexer::isCacheValid(filename));
+        Offline::FileIndexer indexer;
+        QVERIFY(indexer.startIndexing(filename, false));
+        QCOMPARE(indexer.getStatistics().errorPackets, uint64_t(0));
+        indexedPackets += indexer.getPacketCount();
+        recorded.append(readFile(filename));
+    }
+    QCOMPARE(indexedPackets, uint64_t(20000));
+    QCOMPARE(recorded, expected);
+}
+
+void TestCaptureRecorder::testRejectedPackets()
+{
+    CaptureRecorder recorder(createConfig("rejected"));
+
+    const QByteArray packet = createTestPacket(1, 1, 100);
+    const uchar* data = reinterpret_cast<const uchar*>(packet.constData());
+
+    // Nothing is accepted before start()
+    QVERIFY(!recorder.record(data, packet.size()));
+
+    QVERIFY(recorder.start());
+    QVERIFY(!recorder.record(data, packet.size() - 1));
+    QVERIFY(!recorder.record(data, 10));
+    QVERIFY(!recorder.record(nullptr, 0));
+    QVERIFY(recorder.record(data, packet.size()));
+    recorder.stop();
+
+    QCOMPARE(recorder.getStatistics().packetsDropped.load(), uint64_t(3));
+    QCOMPARE(recorder.getStatistics().packetsRecorded.load(), uint64_t(1));
+
+    m_recordedFiles = recorder.getCompletedFiles();
+    QCOMPARE(m_recordedFiles.size(), 1);
+    QCOMPARE(readFile(m_recordedFiles.first()), packet);
+}
+
+void TestCaptureRecorder::testDispatcherRecording()
+{
+    Memory::MemoryPoolManager memoryManager;
+    Packet::PacketFactory factory(&memoryManager);
+
+    Packet::PacketDispatcher::Configuration dispatcherConfig;
+    dispatcherConfig.enableBackPressure = false;
+    Packet::PacketDispatcher dispatcher(dispatcherConfig);
+    QVERIFY(dispatcher.start());
+
+    CaptureRecorder recorder(createConfig("dispatcher"));
+    QVERIFY(recorder.start());
+    QVERIFY(recorder.attach(&dispatcher));
+
+    std::vector<Packet::PacketPtr> batch;
+    for (uint32_t i = 0; i < 300; ++i) {
+        auto result = factory.createPacket(10 + (i % 3), nullptr, 64);
+        QVERIFY(result.success);
+        batch.push_back(result.packet);
+    }
+    dispatcher.dispatchBatch(batch);
+
+    QTRY_COMPARE_WITH_TIMEOUT(recorder.getStatistics().packetsRecorded.load(), uint64_t(300), TEST_TIMEOUT_MS);
+
+    recorder.detach();
+    recorder.stop();
+    dispatcher.stop();
+
+    m_recordedFiles = recorder.getCompletedFiles();
+    QCOMPARE(m_recordedFiles.size(), 1);
+
+    Offline::FileIndexer indexer;
+    QVERIFY(indexer.startIndexing(m_recordedFiles.first(), false));
+    QCOMPARE(indexer.getPacketCount(), uint64_t(300));
+    QCOMPARE(indexer.findPacketsByPacketId(11).size(), size_t(100));
+}
+
+QByteArray TestCaptureRecorder::createTestPacket(uint32_t id, uint32_t sequence, uint32_t payloadSize)
+{
+    Packet::PacketHeader header;
+    header.id = id;
+    header.sequence = sequence;
+    header.timestamp = 1000 + sequence;
+    header.payloadSize = payloadSize;
+    header.flags = Packet::PacketHeader::Flags::TestData;
+
+    QByteArray packet;
+    packet.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (uint32_t i = 0; i < payloadSize; ++i) {
+        packet.append(static_cast<char>((sequence * 7 + i) & 0xFF));
+    }
+    return packet;
+}
+
+QByteArray TestCaptureRecorder::readFile(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+CaptureRecorder::Configuration TestCaptureRecorder::createConfig(const QString& subdirectory)
+{
+    CaptureRecorder::Configuration config;
+    config.directory = m_tempDir->filePath(subdirectory);
+    config.bufferSize = 1024 * 1024;
+    config.bufferCount = 4;
+    config.flushIntervalMs = 10;
+    return config;
+}
+
+QTEST_MAIN(TestCaptureRecorder)
+#include "test_capture_recorder.moc"
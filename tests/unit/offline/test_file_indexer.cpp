@@ -7,9 +7,11 @@
 #include <QDir>
 #include <QThread>
 #include <QRandomGenerator>
+#include <cstring>
 
 #include "../../../src/offline/sources/file_indexer.h"
 #include "../../../src/packet/core/packet_header.h"
+#include "../../../src/threading/thread_pool.h"
 
 using namespace Monitor;
 
@@ -42,12 +44,18 @@ private slots:
     void testPacketIdSearch();
     void testSequenceNumberSearch();
     void testPacketEntryAccess();
+    void testSelectPacketsByIdAndTime();
+    void testUnorderedTimestampSearch();
     
     // Cache management tests
     void testCacheCreation();
     void testCacheLoading();
     void testCacheValidation();
     void testCacheInvalidation();
+    void testCacheRoundTripExact();
+    void testCacheAppendResume();
+    void testCacheRejectsRewrittenFile();
+    void testForeignHeaderByteOrder();
     
     // Performance and stress tests
     void testLargeFileIndexing();
@@ -59,6 +67,7 @@ private slots:
     void testBackgroundIndexing();
     void testConcurrentIndexing();
     void testIndexingWithInterruption();
+    void testParallelChunkedIndexing();
     
     // Error handling and edge cases
     void testEmptyFileIndexing();
@@ -556,6 +565,88 @@ void TestFileIndexer::testSequenceNumberSearch()
     QCOMPARE(foundIndex, -1);
 }
 
+void TestFileIndexer::testSelectPacketsByIdAndTime()
+{
+    Offline::FileIndexer indexer;
+    QString testFile = createLargeTestFile(LARGE_FILE_PACKET_COUNT);
+    
+    QVERIFY(indexer.startIndexing(testFile, false));
+    QVERIFY(indexer.isIndexingComplete());
+    
+    const auto& index = indexer.getIndex();
+    const std::vector<uint32_t> ids = {2, 7};
+    const uint64_t start = index[1200].timestamp;
+    const uint64_t end = index[3700].timestamp;
+    
+    std::vector<uint32_t> expected;
+    for (size_t i = 0; i < index.size(); ++i) {
+        if ((index[i].packetId == 2 || index[i].packetId == 7) &&
+            index[i].timestamp >= start && index[i].timestamp <= end) {
+            expected.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    QVERIFY(!expected.empty());
+    QCOMPARE(indexer.selectPackets(ids, start, end), expected);
+    
+    // Empty ID set selects by time alone; unknown IDs select nothing
+    QCOMPARE(indexer.selectPackets({}, start, end).size(), static_cast<size_t>(3700 - 1200 + 1));
+    QVERIFY(indexer.selectPackets({999}).empty());
+    QVERIFY(indexer.selectPackets(ids, end, start).empty());
+    
+    // Posting lists and skip index come back from the cache unchanged
+    QString cacheFile = Offline::FileIndexer::getCacheFilename(testFile);
+    QVERIFY(indexer.saveIndexToCache(cacheFile));
+    m_createdFiles.append(cacheFile);
+    
+    Offline::FileIndexer loaded;
+    QVERIFY(loaded.loadIndexFromCache(cacheFile));
+    QCOMPARE(loaded.selectPackets(ids, start, end), expected);
+    QCOMPARE(loaded.findPacketsByPacketId(7), indexer.findPacketsByPacketId(7));
+    QCOMPARE(loaded.getSecondaryIndex().blocks().size(), indexer.getSecondaryIndex().blocks().size());
+}
+
+void TestFileIndexer::testUnorderedTimestampSearch()
+{
+    QString filename = m_testDataDir + "/unordered_timestamps.dat";
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    
+    // Timestamps are a permutation of the packet numbers, so they jump back and forth
+    const int packetCount = 3000;
+    const QByteArray payload(40, 'u');
+    for (int i = 0; i < packetCount; ++i) {
+        const uint64_t timestamp = 1000000ULL + ((i * 7919ULL) % packetCount) * 1000ULL;
+        file.write(createTestPacket(1 + (i % 3), i, timestamp, payload));
+    }
+    file.close();
+    m_createdFiles.append(filename);
+    
+    Offline::FileIndexer indexer;
+    QVERIFY(indexer.startIndexing(filename, false));
+    const auto& index = indexer.getIndex();
+    QCOMPARE(static_cast<int>(index.size()), packetCount);
+    
+    for (uint64_t target : {1000000ULL, 1500500ULL, 2999000ULL, 3999000ULL}) {
+        auto expected = std::find_if(index.begin(), index.end(),
+            [target](const Offline::PacketIndexEntry& entry) { return entry.timestamp >= target; });
+        const int expectedIndex = expected != index.end() ? static_cast<int>(expected - index.begin()) : -1;
+        QCOMPARE(indexer.findPacketByTimestamp(target), expectedIndex);
+    }
+    
+    const uint64_t start = 1400000ULL;
+    const uint64_t end = 1600000ULL;
+    std::vector<uint32_t> expected;
+    for (size_t i = 0; i < index.size(); ++i) {
+        if (index[i].packetId == 3 && index[i].timestamp >= start && index[i].timestamp <= end) {
+            expected.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    QVERIFY(!expected.empty());
+    QCOMPARE(indexer.selectPackets({3}, start, end), expected);
+    
+    QCOMPARE(indexer.findPacketBySequence(2500), 2500);
+}
+
 void TestFileIndexer::testPacketEntryAccess()
 {
     Offline::FileIndexer indexer;
@@ -670,6 +761,172 @@ void TestFileIndexer::testCacheInvalidation()
     QVERIFY(!Offline::FileIndexer::isCacheValid(testFile));
 }
 
+void TestFileIndexer::testCacheRoundTripExact()
+{
+    QString testFile = createTestFile("cache_exact", MEDIUM_FILE_PACKET_COUNT);
+    
+    Offline::FileIndexer indexer1;
+    QVERIFY(indexer1.startIndexing(testFile, false));
+    
+    QString cacheFile = Offline::FileIndexer::getCacheFilename(testFile);
+    QVERIFY(indexer1.saveIndexToCache(cacheFile));
+    m_createdFiles.append(cacheFile);
+    
+    // Every entry survives the round trip, not a sample
+    Offline::FileIndexer indexer2;
+    QVERIFY(indexer2.loadIndexFromCache(cacheFile));
+    QCOMPARE(indexer2.getPacketCount(), indexer1.getPacketCount());
+    QCOMPARE(indexer2.getIndexedBytes(), QFileInfo(testFile).size());
+    
+    const int count = static_cast<int>(indexer1.getPacketCount());
+    for (int i = 0; i < count; ++i) {
+        const auto* original = indexer1.getPacketEntry(i);
+        const auto* loaded = indexer2.getPacketEntry(i);
+        QVERIFY(original && loaded);
+        QCOMPARE(loaded->filePosition, original->filePosition);
+        QCOMPARE(loaded->packetSize, original->packetSize);
+        QCOMPARE(loaded->timestamp, original->timestamp);
+        QCOMPARE(loaded->packetId, original->packetId);
+        QCOMPARE(loaded->sequenceNumber, original->sequenceNumber);
+    }
+    
+    // Seeking on the loaded index is exact
+    const auto* last = indexer1.getPacketEntry(count - 1);
+    QCOMPARE(indexer2.findPacketByTimestamp(last->timestamp), count - 1);
+}
+
+void TestFileIndexer::testCacheAppendResume()
+{
+    QString testFile = createTestFile("cache_append", SMALL_FILE_PACKET_COUNT);
+    
+    Offline::FileIndexer indexer1;
+    QVERIFY(indexer1.startIndexing(testFile, false));
+    
+    QString cacheFile = Offline::FileIndexer::getCacheFilename(testFile);
+    QVERIFY(indexer1.saveIndexToCache(cacheFile));
+    m_createdFiles.append(cacheFile);
+    const qint64 originalBytes = indexer1.getIndexedBytes();
+    
+    // Grow the capture
+    QFile file(testFile);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+    for (int i = SMALL_FILE_PACKET_COUNT; i < 2 * SMALL_FILE_PACKET_COUNT; ++i) {
+        QByteArray payload = QString("Appended packet %1").arg(i).toUtf8();
+        file.write(createTestPacket(7, i, 1000000ULL + (i * 10000ULL), payload));
+    }
+    file.close();
+    
+    QVERIFY(!Offline::FileIndexer::isCacheValid(testFile));
+    
+    // The stale cache still loads, but is not complete for the grown file
+    Offline::FileIndexer indexer2;
+    QVERIFY(indexer2.loadIndexFromCache(cacheFile));
+    QCOMPARE(static_cast<int>(indexer2.getPacketCount()), SMALL_FILE_PACKET_COUNT);
+    QVERIFY(indexer2.getStatus() != Offline::FileIndexer::IndexStatus::Completed);
+    QCOMPARE(indexer2.getIndexedBytes(), originalBytes);
+    
+    // Re-indexing only covers the appended packets
+    QVERIFY(indexer2.startIndexing(testFile, false));
+    QVERIFY(indexer2.isIndexingComplete());
+    QCOMPARE(static_cast<int>(indexer2.getPacketCount()), 2 * SMALL_FILE_PACKET_COUNT);
+    QCOMPARE(indexer2.getIndexedBytes(), QFileInfo(testFile).size());
+    
+    const auto* first = indexer2.getPacketEntry(SMALL_FILE_PACKET_COUNT);
+    QVERIFY(first);
+    QCOMPARE(first->filePosition, originalBytes);
+    QCOMPARE(first->packetId, static_cast<uint32_t>(7));
+    QCOMPARE(first->sequenceNumber, static_cast<uint32_t>(SMALL_FILE_PACKET_COUNT));
+    QVERIFY(verifyIndexConsistency(indexer2));
+    
+    // A fresh full index agrees with the resumed one
+    Offline::FileIndexer reference;
+    QVERIFY(reference.startIndexing(testFile, false));
+    QCOMPARE(reference.getPacketCount(), indexer2.getPacketCount());
+    const auto* expected = reference.getPacketEntry(2 * SMALL_FILE_PACKET_COUNT - 1);
+    const auto* resumed = indexer2.getPacketEntry(2 * SMALL_FILE_PACKET_COUNT - 1);
+    QVERIFY(expected && resumed);
+    QCOMPARE(resumed->filePosition, expected->filePosition);
+    QCOMPARE(resumed->timestamp, expected->timestamp);
+    
+    // Saving again makes the cache current
+    QVERIFY(indexer2.saveIndexToCache(cacheFile));
+    QVERIFY(Offline::FileIndexer::isCacheValid(testFile));
+}
+
+void TestFileIndexer::testCacheRejectsRewrittenFile()
+{
+    QString testFile = createTestFile("cache_rewrite", SMALL_FILE_PACKET_COUNT);
+    
+    Offline::FileIndexer indexer1;
+    QVERIFY(indexer1.startIndexing(testFile, false));
+    
+    QString cacheFile = Offline::FileIndexer::getCacheFilename(testFile);
+    QVERIFY(indexer1.saveIndexToCache(cacheFile));
+    m_createdFiles.append(cacheFile);
+    
+    // Same size, different leading packet
+    QFile file(testFile);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray header = file.read(static_cast<qint64>(sizeof(Packet::PacketHeader)));
+    header[0] = static_cast<char>(header[0] ^ 0x01);
+    QVERIFY(file.seek(0));
+    file.write(header);
+    file.close();
+    
+    QVERIFY(!Offline::FileIndexer::isCacheValid(testFile));
+    
+    Offline::FileIndexer indexer2;
+    QVERIFY(!indexer2.loadIndexFromCache(cacheFile));
+    QCOMPARE(indexer2.getPacketCount(), static_cast<uint64_t>(0));
+}
+
+void TestFileIndexer::testForeignHeaderByteOrder()
+{
+    using Parser::Layout::ByteOrder;
+    const ByteOrder foreign = Parser::Layout::hostByteOrder() == ByteOrder::Little ? ByteOrder::Big : ByteOrder::Little;
+    
+    // Headers written by a sender of the other endianness
+    QString testFile = m_testDataDir + "/indexer_test_foreign.dat";
+    QFile file(testFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    for (int i = 0; i < SMALL_FILE_PACKET_COUNT; ++i) {
+        QByteArray packet = createTestPacket(1 + (i % 5), i, 1000000ULL + i * 10000ULL, QByteArray(24, 'x'));
+        Packet::PacketHeader header;
+        std::memcpy(&header, packet.constData(), sizeof(header));
+        header.convertToHostOrder(foreign);    // Swapping is its own inverse
+        std::memcpy(packet.data(), &header, sizeof(header));
+        file.write(packet);
+    }
+    file.close();
+    m_createdFiles.append(testFile);
+    
+    Offline::FileIndexer indexer;
+    indexer.setHeaderByteOrder(foreign);
+    QVERIFY(indexer.startIndexing(testFile, false));
+    QCOMPARE(indexer.getPacketCount(), static_cast<uint64_t>(SMALL_FILE_PACKET_COUNT));
+    for (int i = 0; i < SMALL_FILE_PACKET_COUNT; ++i) {
+        const auto* entry = indexer.getPacketEntry(i);
+        QVERIFY(entry);
+        QCOMPARE(entry->packetId, static_cast<uint32_t>(1 + (i % 5)));
+        QCOMPARE(entry->sequenceNumber, static_cast<uint32_t>(i));
+        QCOMPARE(entry->timestamp, 1000000ULL + i * 10000ULL);
+    }
+    
+    // The cache only serves indexers reading headers in the same order
+    QString cacheFile = Offline::FileIndexer::getCacheFilename(testFile);
+    QVERIFY(indexer.saveIndexToCache(cacheFile));
+    m_createdFiles.append(cacheFile);
+    QVERIFY(Offline::FileIndexer::isCacheValid(testFile, foreign));
+    QVERIFY(!Offline::FileIndexer::isCacheValid(testFile));
+    
+    Offline::FileIndexer nativeIndexer;
+    QVERIFY(!nativeIndexer.loadIndexFromCache(cacheFile));
+    
+    // Changing the order drops the index read in the old one
+    indexer.setHeaderByteOrder(ByteOrder::Native);
+    QCOMPARE(indexer.getPacketCount(), static_cast<uint64_t>(0));
+}
+
 // Performance Tests
 void TestFileIndexer::testLargeFileIndexing()
 {
@@ -826,6 +1083,72 @@ void TestFileIndexer::testConcurrentIndexing()
     QVERIFY(indexer.isIndexingComplete());
 }
 
+void TestFileIndexer::testParallelChunkedIndexing()
+{
+    // Binary payloads, stray bytes between packets and header-like bytes
+    // inside payloads make chunks resynchronise on false headers
+    QString testFile = m_testDataDir + "/indexer_test_parallel.dat";
+    QFile file(testFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    
+    QRandomGenerator random(1234);
+    for (int i = 0; i < MEDIUM_FILE_PACKET_COUNT; ++i) {
+        if (i % 7 == 3) {
+            QByteArray garbage(1 + random.bounded(40), '\0');
+            for (char& byte : garbage) {
+                byte = static_cast<char>(random.bounded(256));
+            }
+            file.write(garbage);
+        }
+        
+        QByteArray payload(32 + random.bounded(400), '\0');
+        for (char& byte : payload) {
+            byte = static_cast<char>(random.bounded(4) == 0 ? 0 : random.bounded(256));
+        }
+        if (i % 5 == 0) {
+            QByteArray fake = createTestPacket(99, 0, 5, QByteArray(random.bounded(64), 'x'));
+            payload.replace(8, static_cast<int>(sizeof(Packet::PacketHeader)), fake.left(sizeof(Packet::PacketHeader)));
+        }
+        file.write(createTestPacket(1 + (i % 5), i, 1000000ULL + (i * 10000ULL), payload));
+    }
+    file.close();
+    m_createdFiles.append(testFile);
+    
+    // One chunk scanned on the indexing thread is the sequential reference
+    Offline::FileIndexer reference;
+    reference.setChunkSize(QFileInfo(testFile).size());
+    QVERIFY(reference.startIndexing(testFile, false));
+    
+    Threading::ThreadPool pool;
+    QVERIFY(pool.initialize(4));
+    pool.start();
+    
+    Offline::FileIndexer indexer;
+    indexer.setThreadPool(&pool);
+    indexer.setChunkSize(1024);
+    QSignalSpy progressSpy(&indexer, &Offline::FileIndexer::progressChanged);
+    QVERIFY(indexer.startIndexing(testFile, false));
+    
+    QCOMPARE(indexer.getPacketCount(), reference.getPacketCount());
+    QCOMPARE(indexer.getStatistics().errorPackets, reference.getStatistics().errorPackets);
+    QVERIFY(indexer.getPacketCount() >= static_cast<uint64_t>(MEDIUM_FILE_PACKET_COUNT));
+    
+    const int count = static_cast<int>(reference.getPacketCount());
+    for (int i = 0; i < count; ++i) {
+        const auto* expected = reference.getPacketEntry(i);
+        const auto* actual = indexer.getPacketEntry(i);
+        QVERIFY(expected && actual);
+        QCOMPARE(actual->filePosition, expected->filePosition);
+        QCOMPARE(actual->packetSize, expected->packetSize);
+        QCOMPARE(actual->sequenceNumber, expected->sequenceNumber);
+    }
+    
+    QVERIFY(progressSpy.count() > 0);
+    QCOMPARE(progressSpy.last().at(0).toInt(), 100);
+    
+    pool.shutdown();
+}
+
 void TestFileIndexer::testIndexingWithInterruption()
 {
     Offline::FileIndexer indexer;
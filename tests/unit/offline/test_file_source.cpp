@@ -7,6 +7,8 @@
 #include <QDir>
 #include <QStandardPaths>
 #include <QThread>
+#include <atomic>
+#include <mutex>
 
 #include "../../../src/offline/sources/file_source.h"
 #include "../../../src/packet/core/packet_factory.h"
@@ -44,6 +46,9 @@ private slots:
     void testLoopPlayback();
     void testRealTimePlayback();
     void testNonRealTimePlayback();
+    void testBatchPlayback();
+    void testTimestampPacedPlayback();
+    void testFilteredPlayback();
     
     // Speed control tests
     void testPlaybackSpeed();
@@ -625,6 +630,204 @@ void TestFileSource::testNonRealTimePlayback()
     source.stopPlayback();
 }
 
+void TestFileSource::testBatchPlayback()
+{
+    Memory::MemoryPoolManager memoryManager;
+    Packet::PacketFactory factory(&memoryManager);
+    
+    Offline::FileSource source;
+    source.setPacketFactory(&factory);
+    
+    Offline::FileSourceConfig config;
+    config.realTimePlayback = false;
+    config.playbackBatchSize = 64;
+    source.setFileConfig(config);
+    
+    const int packetCount = 2000;
+    QList<QByteArray> testPackets;
+    for (int i = 0; i < packetCount; ++i) {
+        testPackets.append(createTestPacket(static_cast<uint32_t>(i), (i + 1) * 1000, QByteArray(100, 'B')));
+    }
+    
+    QString testFile = createTestFile("batch_playback", testPackets);
+    QVERIFY(source.loadFile(testFile));
+    QVERIFY(source.isMemoryMapped());
+    
+    // Batches arrive on the reader thread
+    std::mutex receivedMutex;
+    std::vector<uint32_t> receivedIds;
+    std::atomic<int> batches{0};
+    source.setPacketBatchCallback([&](std::vector<Packet::PacketPtr>& packets) {
+        std::lock_guard<std::mutex> lock(receivedMutex);
+        batches++;
+        for (const auto& packet : packets) {
+            receivedIds.push_back(packet->id());
+        }
+    });
+    QSignalSpy endOfFileSpy(&source, &Offline::FileSource::endOfFileReached);
+    
+    source.play();
+    QVERIFY(source.isBatchPlaybackActive());
+    
+    QVERIFY(endOfFileSpy.wait(TEST_TIMEOUT_MS));
+    QTRY_COMPARE(source.getPlaybackState(), Offline::PlaybackState::Stopped);
+    
+    std::lock_guard<std::mutex> lock(receivedMutex);
+    QCOMPARE(static_cast<int>(receivedIds.size()), packetCount);
+    for (int i = 0; i < packetCount; ++i) {
+        QCOMPARE(receivedIds[i], static_cast<uint32_t>(i));
+    }
+    QVERIFY(batches.load() >= packetCount / config.playbackBatchSize);
+    QVERIFY(batches.load() < packetCount);
+    
+    const auto* engineStats = source.getBatchPlaybackStatistics();
+    QVERIFY(engineStats != nullptr);
+    QCOMPARE(engineStats->packetsDelivered.load(), static_cast<uint64_t>(packetCount));
+    QCOMPARE(engineStats->pacingSleeps.load(), static_cast<uint64_t>(0));
+    
+    source.closeFile();
+}
+
+void TestFileSource::testFilteredPlayback()
+{
+    Memory::MemoryPoolManager memoryManager;
+    Packet::PacketFactory factory(&memoryManager);
+    
+    const int packetCount = 3000;
+    QList<QByteArray> testPackets;
+    for (int i = 0; i < packetCount; ++i) {
+        testPackets.append(createTestPacket(static_cast<uint32_t>(i % 6), (i + 1) * 1000, QByteArray(64, 'F')));
+    }
+    QString testFile = createTestFile("filtered_playback", testPackets);
+    
+    Offline::PlaybackFilter filter;
+    filter.packetIds = {1, 4};
+    filter.startTimestamp = 500000;
+    filter.endTimestamp = 2000000;
+    
+    std::vector<uint64_t> expected;
+    for (int i = 0; i < packetCount; ++i) {
+        const uint64_t timestamp = (i + 1) * 1000;
+        if ((i % 6 == 1 || i % 6 == 4) && timestamp >= filter.startTimestamp && timestamp <= filter.endTimestamp) {
+            expected.push_back(timestamp);
+        }
+    }
+    
+    // Batch playback from the mapping
+    {
+        Offline::FileSource source;
+        source.setPacketFactory(&factory);
+        
+        Offline::FileSourceConfig config;
+        config.realTimePlayback = false;
+        config.playbackBatchSize = 32;
+        source.setFileConfig(config);
+        source.setPlaybackFilter(filter);
+        
+        QVERIFY(source.loadFile(testFile));
+        QCOMPARE(source.getPlaybackPacketCount(), static_cast<uint64_t>(expected.size()));
+        QCOMPARE(source.getFileStatistics().totalPackets, static_cast<uint64_t>(expected.size()));
+        
+        std::mutex receivedMutex;
+        std::vector<uint64_t> received;
+        source.setPacketBatchCallback([&](std::vector<Packet::PacketPtr>& packets) {
+            std::lock_guard<std::mutex> lock(receivedMutex);
+            for (const auto& packet : packets) {
+                received.push_back(packet->timestamp());
+            }
+        });
+        QSignalSpy endOfFileSpy(&source, &Offline::FileSource::endOfFileReached);
+        
+        source.play();
+        QVERIFY(source.isBatchPlaybackActive());
+        QVERIFY(endOfFileSpy.wait(TEST_TIMEOUT_MS));
+        QTRY_COMPARE(source.getPlaybackState(), Offline::PlaybackState::Stopped);
+        
+        std::lock_guard<std::mutex> lock(receivedMutex);
+        QCOMPARE(received, expected);
+        QCOMPARE(source.getBatchPlaybackStatistics()->packetsDelivered.load(), static_cast<uint64_t>(expected.size()));
+    }
+    
+    // Packet-at-a-time playback from the file, filter set after loading
+    {
+        Offline::FileSource source;
+        source.setPacketFactory(&factory);
+        
+        Offline::FileSourceConfig config;
+        config.memoryMapped = false;
+        source.setFileConfig(config);
+        QVERIFY(source.loadFile(testFile));
+        QCOMPARE(source.getPlaybackPacketCount(), static_cast<uint64_t>(packetCount));
+        
+        std::vector<uint64_t> received;
+        source.setPacketCallback([&](Packet::PacketPtr packet) {
+            received.push_back(packet->timestamp());
+        });
+        
+        source.setPlaybackFilter(filter);
+        while (!source.isAtEndOfFile()) {
+            source.stepForward();
+        }
+        QCOMPARE(received, expected);
+        
+        // Clearing the filter resumes with every packet after the last one played
+        source.seekToPacket(0);
+        source.stepForward();
+        source.clearPlaybackFilter();
+        QCOMPARE(source.getPlaybackPacketCount(), static_cast<uint64_t>(packetCount));
+        received.clear();
+        source.stepForward();
+        QCOMPARE(received.size(), static_cast<size_t>(1));
+        QCOMPARE(received[0], expected[0] + 1000);
+    }
+}
+
+void TestFileSource::testTimestampPacedPlayback()
+{
+    Memory::MemoryPoolManager memoryManager;
+    Packet::PacketFactory factory(&memoryManager);
+    
+    Offline::FileSource source;
+    source.setPacketFactory(&factory);
+    
+    Offline::FileSourceConfig config;
+    config.realTimePlayback = true;
+    config.playbackSpeed = 2.0;
+    source.setFileConfig(config);
+    
+    // 20 packets 10 ms apart in capture time: ~95 ms of playback at 2x
+    const int packetCount = 20;
+    const uint64_t gapNs = 10000000ULL;
+    QList<QByteArray> testPackets;
+    for (int i = 0; i < packetCount; ++i) {
+        testPackets.append(createTestPacket(static_cast<uint32_t>(i), (i + 1) * gapNs, "Paced"));
+    }
+    
+    QString testFile = createTestFile("paced_playback", testPackets);
+    QVERIFY(source.loadFile(testFile));
+    
+    std::atomic<int> received{0};
+    source.setPacketBatchCallback([&](std::vector<Packet::PacketPtr>& packets) {
+        received += static_cast<int>(packets.size());
+    });
+    QSignalSpy endOfFileSpy(&source, &Offline::FileSource::endOfFileReached);
+    
+    QElapsedTimer timer;
+    timer.start();
+    source.play();
+    QVERIFY(source.isBatchPlaybackActive());
+    
+    QVERIFY(endOfFileSpy.wait(TEST_TIMEOUT_MS));
+    const qint64 elapsed = timer.elapsed();
+    
+    QCOMPARE(received.load(), packetCount);
+    QVERIFY2(elapsed >= 85, qPrintable(QString("Paced playback took only %1 ms").arg(elapsed)));
+    
+    const auto* engineStats = source.getBatchPlaybackStatistics();
+    QVERIFY(engineStats != nullptr);
+    QVERIFY(engineStats->pacingSleeps.load() > 0);
+}
+
 // Speed Control Tests
 void TestFileSource::testPlaybackSpeed()
 {
@@ -0,0 +1,626 @@
+#include <QCoreApplication>
+#include <QTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QtEndian>
+#include <atomic>
+#include <mutex>
+
+#include "../../../src/offline/sources/pcap_reader.h"
+#include "../../../src/offline/sources/pcap_writer.h"
+#include "../../../src/offline/sources/file_indexer.h"
+#include "../../../src/offline/sources/file_source.h"
+#include "../../../src/packet/core/packet_factory.h"
+#include "../../../src/memory/memory_pool.h"
+#include "../../../src/packet/core/packet_header.h"
+
+using namespace Monitor;
+using Offline::PcapReader;
+using Offline::PcapWriter;
+using Offline::CapturedPacket;
+
+class TestPcapReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    // Format detection
+    void testDetectFormat();
+    void testInvalidCapture();
+
+    // Writer round trips
+    void testUdpRoundTrip();
+    void testTcpRoundTrip();
+    void testOversizedUdpPacket();
+
+    // Hand-built captures
+    void testPcapNgEnhancedPackets();
+    void testVlanTaggedFrames();
+    void testPortFilter();
+    void testForeignHeaderByteOrder();
+
+    // TCP reassembly
+    void testTcpOutOfOrderAndRetransmission();
+    void testTcpMidStreamResync();
+
+    // Offline integration
+    void testFileIndexerCapture();
+    void testFileSourceCapturePlayback();
+
+private:
+    struct Record {
+        uint64_t timestampNs;
+        QByteArray frame;
+    };
+
+    QByteArray createTestPacket(uint32_t id, uint32_t sequence, uint32_t payloadSize);
+    QString writeCapture(const QString& name, PcapWriter::Transport transport, const QList<QByteArray>& packets,
+                         int splitPacket = -1);
+    QByteArray readFile(const QString& filename);
+    QList<Record> splitRecords(const QByteArray& capture);
+    QByteArray joinRecords(const QByteArray& capture, const QList<Record>& records);
+    QByteArray udpFrame(const QByteArray& payload, uint16_t port, bool vlan);
+    QList<QByteArray> readAll(const QByteArray& capture, PcapReader::Statistics* stats = nullptr);
+
+    QTemporaryDir* m_tempDir;
+
+    static const int TEST_TIMEOUT_MS = 5000;
+};
+
+const int TestPcapReader::TEST_TIMEOUT_MS;
+
+void TestPcapReader::initTestCase()
+{
+    m_tempDir = new QTemporaryDir();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestPcapReader::cleanupTestCase()
+{
+    delete m_tempDir;
+}
+
+void TestPcapReader::testDetectFormat()
+{
+    uchar pcap[24] = {};
+    qToLittleEndian<quint32>(0xA1B2C3D4, pcap);
+    QCOMPARE(PcapReader::detectFormat(pcap, sizeof(pcap)), PcapReader::Format::Pcap);
+
+    qToBigEndian<quint32>(0xA1B23C4D, pcap);
+    QCOMPARE(PcapReader::detectFormat(pcap, sizeof(pcap)), PcapReader::Format::Pcap);
+
+    uchar pcapng[28] = {};
+    qToLittleEndian<quint32>(0x0A0D0D0A, pcapng);
+    qToLittleEndian<quint32>(28, pcapng + 4);
+    qToLittleEndian<quint32>(0x1A2B3C4D, pcapng + 8);
+    QCOMPARE(PcapReader::detectFormat(pcapng, sizeof(pcapng)), PcapReader::Format::PcapNg);
+
+    // A recording starting with a packet header is not a capture
+    const QByteArray packet = createTestPacket(1, 1, 16);
+    QCOMPARE(PcapReader::detectFormat(reinterpret_cast<const uchar*>(packet.constData()), packet.size()),
+             PcapReader::Format::Unknown);
+    QCOMPARE(PcapReader::detectFormat(nullptr, 0), PcapReader::Format::Unknown);
+}
+
+void TestPcapReader::testInvalidCapture()
+{
+    const QByteArray garbage(64, 'x');
+    PcapReader reader(reinterpret_cast<const uchar*>(garbage.constData()), garbage.size());
+    QVERIFY(!reader.isValid());
+    QVERIFY(!reader.errorString().isEmpty());
+
+    CapturedPacket packet;
+    QVERIFY(!reader.readNext(packet));
+}
+
+void TestPcapReader::testUdpRoundTrip()
+{
+    QList<QByteArray> packets;
+    for (int i = 0; i < 200; ++i) {
+        packets.append(createTestPacket(static_cast<uint32_t>(i % 7), static_cast<uint32_t>(i), (i * 37) % 1500));
+    }
+
+    const QString filename = writeCapture("udp.pcap", PcapWriter::Transport::Udp, packets);
+    QVERIFY(PcapReader::isCaptureFile(filename));
+
+    const QByteArray capture = readFile(filename);
+    const uchar* base = reinterpret_cast<const uchar*>(capture.constData());
+    PcapReader reader(base, capture.size());
+    QVERIFY(reader.isValid());
+    QCOMPARE(reader.format(), PcapReader::Format::Pcap);
+
+    CapturedPacket packet;
+    int count = 0;
+    while (reader.readNext(packet)) {
+        QVERIFY(count < packets.size());
+        QCOMPARE(QByteArray(reinterpret_cast<const char*>(packet.data), packet.size), packets[count]);
+
+        // Datagrams hold whole packets, read in place from the capture
+        QVERIFY(packet.position > 0);
+        QCOMPARE(packet.data, base + packet.position);
+        QVERIFY(packet.recordPosition < packet.position);
+        QCOMPARE(packet.timestampNs, 1000000000ULL + static_cast<uint64_t>(count) * 1000);
+        ++count;
+    }
+
+    QCOMPARE(count, packets.size());
+    QCOMPARE(reader.position(), static_cast<qint64>(capture.size()));
+    QCOMPARE(reader.getStatistics().udpDatagrams, static_cast<uint64_t>(packets.size()));
+    QCOMPARE(reader.getStatistics().framingErrors, 0ULL);
+}
+
+void TestPcapReader::testTcpRoundTrip()
+{
+    QList<QByteArray> packets;
+    for (int i = 0; i < 100; ++i) {
+        packets.append(createTestPacket(static_cast<uint32_t>(i % 3), static_cast<uint32_t>(i), (i * 53) % 900));
+    }
+    // Larger than one segment
+    packets.insert(50, createTestPacket(9, 1000, Packet::PacketHeader::MAX_PAYLOAD_SIZE - 24));
+
+    const QString filename = writeCapture("tcp.pcap", PcapWriter::Transport::Tcp, packets);
+    const QByteArray capture = readFile(filename);
+    const uchar* base = reinterpret_cast<const uchar*>(capture.constData());
+    PcapReader reader(base, capture.size());
+    QVERIFY(reader.isValid());
+
+    CapturedPacket packet;
+    int count = 0;
+    while (reader.readNext(packet)) {
+        QVERIFY(count < packets.size());
+        QCOMPARE(QByteArray(reinterpret_cast<const char*>(packet.data), packet.size), packets[count]);
+        if (count == 50) {
+            QCOMPARE(packet.position, qint64(-1));
+        } else {
+            QCOMPARE(packet.data, base + packet.position);
+        }
+        ++count;
+    }
+
+    QCOMPARE(count, packets.size());
+    QCOMPARE(reader.getStatistics().reassembledPackets, 1ULL);
+    QCOMPARE(reader.getStatistics().tcpGaps, 0ULL);
+    QCOMPARE(reader.getStatistics().bytesDiscarded, 0ULL);
+}
+
+void TestPcapReader::testOversizedUdpPacket()
+{
+    PcapWriter writer;
+    QVERIFY(writer.open(m_tempDir->filePath("oversized.pcap")));
+
+    const QByteArray packet = createTestPacket(1, 1, PcapWriter::MAX_UDP_PAYLOAD);
+    QVERIFY(!writer.writePacket(reinterpret_cast<const uchar*>(packet.constData()),
+                                static_cast<uint32_t>(packet.size()), 1));
+    QVERIFY(!writer.errorString().isEmpty());
+    QCOMPARE(writer.getPacketsWritten(), 0ULL);
+    writer.close();
+}
+
+void TestPcapReader::testPcapNgEnhancedPackets()
+{
+    const QByteArray first = createTestPacket(5, 1, 40);
+    const QByteArray second = createTestPacket(6, 2, 0);
+    QByteArray datagram = first + second;   // Two packets in one datagram
+
+    QByteArray capture;
+    auto appendBlock = [&capture](uint32_t type, const QByteArray& body) {
+        QByteArray padded = body;
+        padded.append(QByteArray((4 - padded.size() % 4) % 4, '\0'));
+        uchar word[4];
+        const uint32_t length = static_cast<uint32_t>(padded.size()) + 12;
+        qToLittleEndian<quint32>(type, word);
+        capture.append(reinterpret_cast<const char*>(word), 4);
+        qToLittleEndian<quint32>(length, word);
+        capture.append(reinterpret_cast<const char*>(word), 4);
+        capture.append(padded);
+        capture.append(reinterpret_cast<const char*>(word), 4);
+    };
+
+    // Section header: byte order magic, version 1.0, unknown section length
+    QByteArray section(16, '\0');
+    qToLittleEndian<quint32>(0x1A2B3C4D, section.data());
+    qToLittleEndian<quint16>(1, section.data() + 4);
+    qToLittleEndian<qint64>(-1, section.data() + 8);
+    appendBlock(0x0A0D0D0A, section);
+
+    // Interface: Ethernet with if_tsresol = 10^-9
+    QByteArray interface(8, '\0');
+    qToLittleEndian<quint16>(1, interface.data());
+    QByteArray option(8, '\0');
+    qToLittleEndian<quint16>(9, option.data());
+    qToLittleEndian<quint16>(1, option.data() + 2);
+    option[4] = 9;
+    interface.append(option);
+    interface.append(QByteArray(4, '\0'));  // opt_endofopt
+    appendBlock(0x00000001, interface);
+
+    // Enhanced packet block
+    const QByteArray frame = udpFrame(datagram, 50001, false);
+    const uint64_t timestamp = 1700000000123456789ULL;
+    QByteArray enhanced(20, '\0');
+    qToLittleEndian<quint32>(0, enhanced.data());
+    qToLittleEndian<quint32>(static_cast<quint32>(timestamp >> 32), enhanced.data() + 4);
+    qToLittleEndian<quint32>(static_cast<quint32>(timestamp), enhanced.data() + 8);
+    qToLittleEndian<quint32>(static_cast<quint32>(frame.size()), enhanced.data() + 12);
+    qToLittleEndian<quint32>(static_cast<quint32>(frame.size()), enhanced.data() + 16);
+    enhanced.append(frame);
+    appendBlock(0x00000006, enhanced);
+
+    PcapReader reader(reinterpret_cast<const uchar*>(capture.constData()), capture.size());
+    QCOMPARE(reader.format(), PcapReader::Format::PcapNg);
+
+    CapturedPacket packet;
+    QVERIFY(reader.readNext(packet));
+    QCOMPARE(QByteArray(reinterpret_cast<const char*>(packet.data), packet.size), first);
+    QCOMPARE(packet.timestampNs, timestamp);
+    QVERIFY(reader.readNext(packet));
+    QCOMPARE(QByteArray(reinterpret_cast<const char*>(packet.data), packet.size), second);
+    QCOMPARE(packet.timestampNs, timestamp);
+    QVERIFY(!reader.readNext(packet));
+    QCOMPARE(reader.getStatistics().records, 1ULL);
+}
+
+void TestPcapReader::testVlanTaggedFrames()
+{
+    const QByteArray payload = createTestPacket(3, 7, 100);
+
+    // Classic microsecond pcap, big-endian
+    QByteArray capture(24, '\0');
+    qToBigEndian<quint32>(0xA1B2C3D4, capture.data());
+    qToBigEndian<quint16>(2, capture.data() + 4);
+    qToBigEndian<quint16>(4, capture.data() + 6);
+    qToBigEndian<quint32>(65535, capture.data() + 16);
+    qToBigEndian<quint32>(1, capture.data() + 20);
+
+    const QByteArray frame = udpFrame(payload, 50001, true);
+    QByteArray record(16, '\0');
+    qToBigEndian<quint32>(12, record.data());
+    qToBigEndian<quint32>(345678, record.data() + 4);
+    qToBigEndian<quint32>(static_cast<quint32>(frame.size()), record.data() + 8);
+    qToBigEndian<quint32>(static_cast<quint32>(frame.size()), record.data() + 12);
+    capture.append(record);
+    capture.append(frame);
+
+    PcapReader::Statistics stats;
+    const QList<QByteArray> packets = readAll(capture, &stats);
+    QCOMPARE(packets.size(), 1);
+    QCOMPARE(packets[0], payload);
+    QCOMPARE(stats.udpDatagrams, 1ULL);
+
+    PcapReader reader(reinterpret_cast<const uchar*>(capture.constData()), capture.size());
+    CapturedPacket packet;
+    QVERIFY(reader.readNext(packet));
+    QCOMPARE(packet.timestampNs, 12345678000ULL);
+}
+
+void TestPcapReader::testPortFilter()
+{
+    const QByteArray wanted = createTestPacket(1, 1, 10);
+    const QByteArray other = createTestPacket(2, 2, 10);
+
+    QByteArray capture(24, '\0');
+    qToLittleEndian<quint32>(0xA1B23C4D, capture.data());
+    qToLittleEndian<quint32>(1, capture.data() + 20);
+    for (const auto& frame : {udpFrame(other, 6000, false), udpFrame(wanted, 50001, false)}) {
+        QByteArray record(16, '\0');
+        qToLittleEndian<quint32>(1, record.data());
+        qToLittleEndian<quint32>(static_cast<quint32>(frame.size()), record.data() + 8);
+        qToLittleEndian<quint32>(static_cast<quint32>(frame.size()), record.data() + 12);
+        capture.append(record);
+        capture.append(frame);
+    }
+
+    PcapReader::Configuration config;
+    config.port = 50001;
+    PcapReader reader(reinterpret_cast<const uchar*>(capture.constData()), capture.size(), config);
+
+    CapturedPacket packet;
+    QVERIFY(reader.readNext(packet));
+    QCOMPARE(QByteArray(reinterpret_cast<const char*>(packet.data), packet.size), wanted);
+    QVERIFY(!reader.readNext(packet));
+    QCOMPARE(reader.getStatistics().skippedRecords, 1ULL);
+}
+
+void TestPcapReader::testForeignHeaderByteOrder()
+{
+    using Parser::Layout::ByteOrder;
+    const ByteOrder foreign = Parser::Layout::hostByteOrder() == ByteOrder::Little ? ByteOrder::Big : ByteOrder::Little;
+
+    // Headers written by a sender of the other endianness
+    QList<QByteArray> packets;
+    for (int i = 0; i < 20; ++i) {
+        QByteArray packet = createTestPacket(static_cast<uint32_t>(i % 3), static_cast<uint32_t>(i), 10 + i);
+        Packet::PacketHeader header;
+        std::memcpy(&header, packet.constData(), sizeof(header));
+        header.convertToHostOrder(foreign);    // Swapping is its own inverse
+        std::memcpy(packet.data(), &header, sizeof(header));
+        packets.append(packet);
+    }
+    const QByteArray capture = readFile(writeCapture("foreign.pcap", PcapWriter::Transport::Udp, packets));
+
+    // Read in host order the payload sizes are nonsense
+    PcapReader::Statistics stats;
+    QVERIFY(readAll(capture, &stats).isEmpty());
+    QCOMPARE(stats.framingErrors, static_cast<uint64_t>(packets.size()));
+
+    // Packets come back framed but untouched, still in wire order
+    PcapReader::Configuration config;
+    config.headerByteOrder = foreign;
+    PcapReader reader(reinterpret_cast<const uchar*>(capture.constData()), capture.size(), config);
+    CapturedPacket packet;
+    int count = 0;
+    while (reader.readNext(packet)) {
+        QVERIFY(count < packets.size());
+        QCOMPARE(QByteArray(reinterpret_cast<const char*>(packet.data), packet.size), packets[count]);
+        ++count;
+    }
+    QCOMPARE(count, packets.size());
+    QCOMPARE(reader.getStatistics().framingErrors, 0ULL);
+}
+
+void TestPcapReader::testTcpOutOfOrderAndRetransmission()
+{
+    QList<QByteArray> packets;
+    for (int i = 0; i < 60; ++i) {
+        packets.append(createTestPacket(1, static_cast<uint32_t>(i), 200 + i));
+    }
+
+    const QByteArray capture = readFile(writeCapture("tcp_order.pcap", PcapWriter::Transport::Tcp, packets));
+    QList<Record> records = splitRecords(capture);
+    QCOMPARE(records.size(), packets.size() + 2);   // SYN and FIN
+
+    // Swap neighbouring data segments and retransmit some of them
+    QList<Record> shuffled;
+    shuffled.append(records.first());
+    for (int i = 1; i + 1 < records.size() - 1; i += 2) {
+        shuffled.append(records[i + 1]);
+        shuffled.append(records[i]);
+        if (i % 5 == 0) {
+            shuffled.append(records[i + 1]);
+        }
+    }
+    shuffled.append(records.last());
+
+    PcapReader::Statistics stats;
+    const QList<QByteArray> received = readAll(joinRecords(capture, shuffled), &stats);
+    QCOMPARE(received, packets);
+    QCOMPARE(stats.tcpGaps, 0ULL);
+    QCOMPARE(stats.framingErrors, 0ULL);
+}
+
+void TestPcapReader::testTcpMidStreamResync()
+{
+    QList<QByteArray> packets;
+    for (int i = 0; i < 50; ++i) {
+        packets.append(createTestPacket(2, static_cast<uint32_t>(i), 64 + i));
+    }
+
+    const QByteArray capture = readFile(writeCapture("tcp_midstream.pcap", PcapWriter::Transport::Tcp, packets, 10));
+    QList<Record> records = splitRecords(capture);
+
+    // Start the capture on the second segment of packet 10, after the SYN
+    // and packets 0-9 and the first segment
+    const QList<QByteArray> received = readAll(joinRecords(capture, records.mid(12)));
+
+    // Everything after the partial packet comes back intact
+    QCOMPARE(received, packets.mid(11));
+}
+
+void TestPcapReader::testFileIndexerCapture()
+{
+    QList<QByteArray> packets;
+    for (int i = 0; i < 500; ++i) {
+        packets.append(createTestPacket(static_cast<uint32_t>(i % 4), static_cast<uint32_t>(i), 32));
+    }
+    packets.insert(100, createTestPacket(9, 5000, Packet::PacketHeader::MAX_PAYLOAD_SIZE - 24));
+    const QString filename = writeCapture("indexed.pcap", PcapWriter::Transport::Tcp, packets);
+
+    Offline::FileIndexer indexer;
+    QVERIFY(indexer.startIndexing(filename, false));
+    QCOMPARE(static_cast<int>(indexer.getPacketCount()), packets.size());
+
+    // Capture timestamps, packet fields from the framed header
+    const auto* entry = indexer.getPacketEntry(7);
+    QVERIFY(entry != nullptr);
+    QCOMPARE(entry->timestamp, 1000000000ULL + 7 * 1000);
+    QCOMPARE(entry->packetId, 3U);
+    QCOMPARE(entry->sequenceNumber, 7U);
+
+    const QByteArray capture = readFile(filename);
+    QCOMPARE(capture.mid(entry->filePosition, entry->packetSize), packets[7]);
+
+    QCOMPARE(indexer.findPacketsByPacketId(9).size(), size_t(1));
+    QCOMPARE(indexer.findPacketBySequence(5000), 100);
+}
+
+void TestPcapReader::testFileSourceCapturePlayback()
+{
+    Memory::MemoryPoolManager memoryManager;
+    Packet::PacketFactory factory(&memoryManager);
+
+    QList<QByteArray> packets;
+    for (int i = 0; i < 1000; ++i) {
+        packets.append(createTestPacket(static_cast<uint32_t>(i), static_cast<uint32_t>(i), 100));
+    }
+    // Packet 500 is only whole once reassembled
+    const QString filename = writeCapture("playback.pcap", PcapWriter::Transport::Tcp, packets, 500);
+
+    Offline::FileSource source;
+    source.setPacketFactory(&factory);
+
+    Offline::FileSourceConfig config;
+    config.realTimePlayback = false;
+    config.playbackBatchSize = 64;
+    source.setFileConfig(config);
+
+    QVERIFY(source.loadFile(filename));
+    QCOMPARE(source.getFileFormat(), Offline::FileSource::FileFormat::PCAP);
+    QCOMPARE(static_cast<int>(source.getFileStatistics().totalPackets), packets.size());
+
+    std::mutex receivedMutex;
+    std::vector<uint32_t> receivedIds;
+    std::vector<uint32_t> receivedSizes;
+    source.setPacketBatchCallback([&](std::vector<Packet::PacketPtr>& batch) {
+        std::lock_guard<std::mutex> lock(receivedMutex);
+        for (const auto& packet : batch) {
+            receivedIds.push_back(packet->id());
+            receivedSizes.push_back(static_cast<uint32_t>(packet->totalSize()));
+        }
+    });
+    QSignalSpy endOfFileSpy(&source, &Offline::FileSource::endOfFileReached);
+
+    source.play();
+    QVERIFY(source.isBatchPlaybackActive());
+    QVERIFY(endOfFileSpy.wait(TEST_TIMEOUT_MS));
+
+    std::lock_guard<std::mutex> lock(receivedMutex);
+    QCOMPARE(static_cast<int>(receivedIds.size()), packets.size());
+    for (int i = 0; i < packets.size(); ++i) {
+        Packet::PacketHeader header;
+        std::memcpy(&header, packets[i].constData(), sizeof(header));
+        QCOMPARE(receivedIds[i], header.id);
+        QCOMPARE(receivedSizes[i], static_cast<uint32_t>(packets[i].size()));
+    }
+
+    source.closeFile();
+}
+
+QByteArray TestPcapReader::createTestPacket(uint32_t id, uint32_t sequence, uint32_t payloadSize)
+{
+    Packet::PacketHeader header;
+    header.id = id;
+    header.sequence = sequence;
+    header.timestamp = 1000 + sequence;
+    header.payloadSize = payloadSize;
+    header.flags = Packet::PacketHeader::Flags::TestData;
+
+    QByteArray packet;
+    packet.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (uint32_t i = 0; i < payloadSize; ++i) {
+        packet.append(static_cast<char>((sequence * 7 + i) & 0xFF));
+    }
+    return packet;
+}
+
+QString TestPcapReader::writeCapture(const QString& name, PcapWriter::Transport transport,
+                                     const QList<QByteArray>& packets, int splitPacket)
+{
+    PcapWriter::Configuration config;
+    config.transport = transport;
+
+    const QString filename = m_tempDir->filePath(name);
+    PcapWriter writer(config);
+    if (!writer.open(filename)) {
+        qFatal("Could not create capture: %s", qPrintable(filename));
+    }
+
+    uint64_t timestamp = 1000000000ULL;
+    for (int i = 0; i < packets.size(); ++i) {
+        const uchar* data = reinterpret_cast<const uchar*>(packets[i].constData());
+        const uint32_t size = static_cast<uint32_t>(packets[i].size());
+        if (i == splitPacket) {
+            // TCP carries a byte stream: cut the packet across two segments
+            writer.writePacket(data, size / 2, timestamp);
+            writer.writePacket(data + size / 2, size - size / 2, timestamp);
+        } else {
+            writer.writePacket(data, size, timestamp);
+        }
+        timestamp += 1000;
+    }
+    writer.close();
+    return filename;
+}
+
+QByteArray TestPcapReader::readFile(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+QList<TestPcapReader::Record> TestPcapReader::splitRecords(const QByteArray& capture)
+{
+    // Captures from PcapWriter: nanosecond pcap in host byte order
+    QList<Record> records;
+    qint64 position = 24;
+    while (position + 16 <= capture.size()) {
+        uint32_t seconds, nanoseconds, length;
+        std::memcpy(&seconds, capture.constData() + position, 4);
+        std::memcpy(&nanoseconds, capture.constData() + position + 4, 4);
+        std::memcpy(&length, capture.constData() + position + 8, 4);
+        records.append(Record{static_cast<uint64_t>(seconds) * 1000000000ULL + nanoseconds,
+                              capture.mid(position + 16, length)});
+        position += 16 + length;
+    }
+    return records;
+}
+
+QByteArray TestPcapReader::joinRecords(const QByteArray& capture, const QList<Record>& records)
+{
+    QByteArray joined = capture.left(24);
+    for (const auto& record : records) {
+        const uint32_t seconds = static_cast<uint32_t>(record.timestampNs / 1000000000ULL);
+        const uint32_t nanoseconds = static_cast<uint32_t>(record.timestampNs % 1000000000ULL);
+        const uint32_t length = static_cast<uint32_t>(record.frame.size());
+        joined.append(reinterpret_cast<const char*>(&seconds), 4);
+        joined.append(reinterpret_cast<const char*>(&nanoseconds), 4);
+        joined.append(reinterpret_cast<const char*>(&length), 4);
+        joined.append(reinterpret_cast<const char*>(&length), 4);
+        joined.append(record.frame);
+    }
+    return joined;
+}
+
+QByteArray TestPcapReader::udpFrame(const QByteArray& payload, uint16_t port, bool vlan)
+{
+    QByteArray frame(12, '\x02');
+    uchar word[4];
+    if (vlan) {
+        qToBigEndian<quint16>(0x8100, word);
+        frame.append(reinterpret_cast<const char*>(word), 2);
+        qToBigEndian<quint16>(42, word);
+        frame.append(reinterpret_cast<const char*>(word), 2);
+    }
+    qToBigEndian<quint16>(0x0800, word);
+    frame.append(reinterpret_cast<const char*>(word), 2);
+
+    QByteArray ip(20, '\0');
+    ip[0] = 0x45;
+    qToBigEndian<quint16>(static_cast<quint16>(28 + payload.size()), ip.data() + 2);
+    ip[8] = 64;
+    ip[9] = 17;
+    qToBigEndian<quint32>(0x7F000001, ip.data() + 12);
+    qToBigEndian<quint32>(0x7F000001, ip.data() + 16);
+    frame.append(ip);
+
+    QByteArray udp(8, '\0');
+    qToBigEndian<quint16>(40000, udp.data());
+    qToBigEndian<quint16>(port, udp.data() + 2);
+    qToBigEndian<quint16>(static_cast<quint16>(8 + payload.size()), udp.data() + 4);
+    frame.append(udp);
+    frame.append(payload);
+    return frame;
+}
+
+QList<QByteArray> TestPcapReader::readAll(const QByteArray& capture, PcapReader::Statistics* stats)
+{
+    PcapReader reader(reinterpret_cast<const uchar*>(capture.constData()), capture.size());
+    QList<QByteArray> packets;
+    CapturedPacket packet;
+    while (reader.readNext(packet)) {
+        packets.append(QByteArray(reinterpret_cast<const char*>(packet.data), packet.size));
+    }
+    if (stats) {
+        *stats = reader.getStatistics();
+    }
+    return packets;
+}
+
+QTEST_MAIN(TestPcapReader)
+#include "test_pcap_reader.moc"
@@ -410,7 +410,7 @@ void TestPacket::testStructureAssociation() {
     // Create a mock structure (we can't easily create a real AST structure in tests)
     // For now, just test the setter/getter interface
     std::shared_ptr<Monitor::Parser::AST::StructDeclaration> mockStructure = nullptr;
-    packet->setStructure(mockStructure);
+    packet->setTypeStructure(mockStructure);
     QVERIFY(packet->getStructure() == nullptr);
     
     // Test structure name caching
@@ -439,7 +439,7 @@ void TestPacket::testStructureMetadata() {
     QCOMPARE(name1, name2);
     
     // Setting structure should invalidate metadata cache
-    packet->setStructure(nullptr);
+    packet->setTypeStructure(nullptr);
     std::string name3 = packet->getStructureName();
     QCOMPARE(name3, name1); // Should still be "Unknown"
 }
@@ -518,13 +518,11 @@ void TestPacket::testValidationCaching() {
     auto packet = createTestPacket();
     QVERIFY(packet != nullptr);
     
-    // Validation results should be available through getLastValidation
-    // though the actual caching behavior depends on implementation
-    packet->validate();
-    auto cachedResult = packet->getLastValidation();
-    
-    // Should have a result (even if default constructed)
-    QVERIFY(!cachedResult.isValid || cachedResult.isValid); // Tautology but tests method existence
+    // Packets keep no validation state, so repeated validation agrees
+    auto first = packet->validate();
+    auto second = packet->validate();
+    QCOMPARE(second.isValid, first.isValid);
+    QCOMPARE(second.errors.size(), first.errors.size());
 }
 
 void TestPacket::testPacketCreationPerformance() {
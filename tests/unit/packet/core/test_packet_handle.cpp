@@ -0,0 +1,175 @@
+#include <QtTest/QTest>
+#include <QObject>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+#include "packet/core/packet.h"
+#include "packet/core/packet_buffer.h"
+#include "memory/memory_pool.h"
+
+using namespace Monitor::Packet;
+using namespace Monitor::Memory;
+
+class TestPacketHandle : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testCreateAndShare();
+    void testPoolPlacement();
+    void testHeapFallback();
+    void testConcurrentSharing();
+    void testStructureBySlot();
+
+private:
+    PacketHandle createPacket(PacketId id, SizeClassAllocator* allocator);
+
+    MemoryPoolManager* m_memoryManager = nullptr;
+    PacketBuffer* m_packetBuffer = nullptr;
+};
+
+void TestPacketHandle::initTestCase() {
+    m_memoryManager = new MemoryPoolManager();
+    m_packetBuffer = new PacketBuffer(m_memoryManager);
+}
+
+void TestPacketHandle::cleanupTestCase() {
+    delete m_packetBuffer;
+    delete m_memoryManager;
+}
+
+PacketHandle TestPacketHandle::createPacket(PacketId id, SizeClassAllocator* allocator) {
+    return Packet::create(m_packetBuffer->createForPacket(id, nullptr, 32), allocator);
+}
+
+void TestPacketHandle::testCreateAndShare() {
+    PacketPtr empty;
+    QVERIFY(!empty);
+    QVERIFY(empty == nullptr);
+    QCOMPARE(empty.use_count(), 0L);
+
+    PacketPtr packet = createPacket(42, m_memoryManager->packetAllocator());
+    QVERIFY(packet);
+    QVERIFY(packet->isValid());
+    QCOMPARE(packet->id(), PacketId(42));
+    QCOMPARE(packet.use_count(), 1L);
+
+    // Copies share the packet, moves hand it over without counting
+    PacketPtr copy = packet;
+    QVERIFY(copy == packet);
+    QCOMPARE(packet.use_count(), 2L);
+
+    PacketPtr moved = std::move(copy);
+    QVERIFY(copy == nullptr);
+    QCOMPARE(moved.get(), packet.get());
+    QCOMPARE(packet.use_count(), 2L);
+
+    moved.reset();
+    QCOMPARE(packet.use_count(), 1L);
+
+    PacketPtr other = createPacket(43, m_memoryManager->packetAllocator());
+    QVERIFY(other != packet);
+    other = packet;
+    QCOMPARE(other->id(), PacketId(42));
+    QCOMPARE(packet.use_count(), 2L);
+}
+
+void TestPacketHandle::testPoolPlacement() {
+    // One pool block holds the whole packet, count included
+    QVERIFY(sizeof(Packet) <= SizeClass::blockSize(Packet::BLOCK_CLASS));
+
+    SizeClassAllocator* allocator = m_memoryManager->packetAllocator();
+    PacketPtr packet = createPacket(44, allocator);
+    QVERIFY(allocator->owns(Packet::BLOCK_CLASS, packet.get()));
+
+    // Dropping the last handle returns the packet's block and its buffer's
+    // block, which this thread's next packet gets back
+    const std::set<const void*> blocks{packet.get(), packet->data()};
+    packet.reset();
+    PacketPtr reused = createPacket(45, allocator);
+    QCOMPARE((std::set<const void*>{reused.get(), reused->data()}), blocks);
+}
+
+void TestPacketHandle::testHeapFallback() {
+    PacketPtr packet = createPacket(46, nullptr);
+    QVERIFY(packet);
+    QVERIFY(packet->isValid());
+    QVERIFY(!m_memoryManager->packetAllocator()->owns(Packet::BLOCK_CLASS, packet.get()));
+
+    PacketPtr copy = packet;
+    packet.reset();
+    QCOMPARE(copy.use_count(), 1L);
+    QCOMPARE(copy->id(), PacketId(46));
+}
+
+void TestPacketHandle::testConcurrentSharing() {
+    const int threadCount = 8;
+    const int iterations = 100000;
+
+    PacketPtr packet = createPacket(47, m_memoryManager->packetAllocator());
+    std::atomic<uint64_t> idSum{0};
+
+    // Every thread copies and drops handles to the same packet
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&]() {
+            uint64_t sum = 0;
+            for (int i = 0; i < iterations; ++i) {
+                PacketPtr copy = packet;
+                sum += copy->id();
+            }
+            idSum += sum;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(packet.use_count(), 1L);
+    QCOMPARE(idSum.load(), uint64_t(47) * threadCount * iterations);
+
+    // The last handle may be dropped on any thread
+    std::thread([moved = std::move(packet)]() mutable {
+        moved.reset();
+    }).join();
+    QVERIFY(packet == nullptr);
+}
+
+void TestPacketHandle::testStructureBySlot() {
+    const PacketId id = 48;
+    PacketPtr first = createPacket(id, m_memoryManager->packetAllocator());
+    PacketPtr second = createPacket(id, m_memoryManager->packetAllocator());
+    QVERIFY(first->getStructure() == nullptr);
+    QCOMPARE(first->getStructureName(), std::string("Unknown"));
+
+    // The structure is kept once per packet type, in the registry
+    auto structure = std::make_shared<Monitor::Parser::AST::StructDeclaration>("HandleTestStruct");
+    first->setTypeStructure(structure);
+    QCOMPARE(first->getStructure(), structure);
+    QCOMPARE(first->getStructureName(), std::string("HandleTestStruct"));
+
+    PacketTypeRegistry* registry = PacketTypeRegistry::instance();
+    QCOMPARE(registry->structure(registry->findSlot(id)), structure);
+
+    // Other packets refer to it once they are associated with it
+    QVERIFY(second->getStructure() == nullptr);
+    second->setTypeStructure(registry->structure(registry->findSlot(id)));
+    QCOMPARE(second->getStructure(), structure);
+
+    // Setting it through one packet changes it for every packet of the type
+    auto replacement = std::make_shared<Monitor::Parser::AST::StructDeclaration>("HandleTestStructV2");
+    first->setTypeStructure(replacement);
+    QCOMPARE(second->getStructure(), replacement);
+    QCOMPARE(second->getStructureName(), std::string("HandleTestStructV2"));
+
+    // Detaching one packet leaves the type's structure alone
+    first->setTypeStructure(nullptr);
+    QVERIFY(first->getStructure() == nullptr);
+    QCOMPARE(second->getStructure(), replacement);
+}
+
+QTEST_MAIN(TestPacketHandle)
+#include "test_packet_handle.moc"
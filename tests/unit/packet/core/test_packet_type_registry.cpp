@@ -0,0 +1,149 @@
+#include <QtTest/QTest>
+#include <QObject>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+#include "packet/core/packet_type_registry.h"
+
+using namespace Monitor::Packet;
+
+class TestPacketTypeRegistry : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRegisterAndFind();
+    void testSparseIds();
+    void testSlotExhaustion();
+    void testConcurrentRegistration();
+    void testSlotTable();
+    void testSharedInstance();
+};
+
+void TestPacketTypeRegistry::testRegisterAndFind() {
+    PacketTypeRegistry registry;
+    QCOMPARE(registry.slotCount(), PacketTypeRegistry::Slot(0));
+    QCOMPARE(registry.findSlot(100), PacketTypeRegistry::INVALID_SLOT);
+
+    // Slots are compact and handed out in registration order
+    QCOMPARE(registry.registerPacketId(100), PacketTypeRegistry::Slot(0));
+    QCOMPARE(registry.registerPacketId(7), PacketTypeRegistry::Slot(1));
+    QCOMPARE(registry.registerPacketId(100), PacketTypeRegistry::Slot(0));
+    QCOMPARE(registry.slotCount(), PacketTypeRegistry::Slot(2));
+
+    QCOMPARE(registry.findSlot(100), PacketTypeRegistry::Slot(0));
+    QCOMPARE(registry.findSlot(7), PacketTypeRegistry::Slot(1));
+    QCOMPARE(registry.packetId(1), PacketId(7));
+}
+
+void TestPacketTypeRegistry::testSparseIds() {
+    PacketTypeRegistry registry;
+
+    const PacketId largeId = PacketTypeRegistry::DIRECT_ID_LIMIT + 12345;
+    QCOMPARE(registry.findSlot(largeId), PacketTypeRegistry::INVALID_SLOT);
+    QCOMPARE(registry.registerPacketId(largeId), PacketTypeRegistry::Slot(0));
+    QCOMPARE(registry.registerPacketId(PacketTypeRegistry::DIRECT_ID_LIMIT - 1), PacketTypeRegistry::Slot(1));
+    QCOMPARE(registry.registerPacketId(0xFFFFFFF0u), PacketTypeRegistry::Slot(2));
+
+    QCOMPARE(registry.findSlot(largeId), PacketTypeRegistry::Slot(0));
+    QCOMPARE(registry.findSlot(PacketTypeRegistry::DIRECT_ID_LIMIT - 1), PacketTypeRegistry::Slot(1));
+    QCOMPARE(registry.findSlot(0xFFFFFFF0u), PacketTypeRegistry::Slot(2));
+    QCOMPARE(registry.packetId(2), PacketId(0xFFFFFFF0u));
+}
+
+void TestPacketTypeRegistry::testSlotExhaustion() {
+    PacketTypeRegistry registry;
+
+    for (PacketId id = 0; id < PacketTypeRegistry::MAX_SLOTS; ++id) {
+        QCOMPARE(registry.registerPacketId(id * 3), PacketTypeRegistry::Slot(id));
+    }
+
+    // Registered IDs keep their slots once the registry is full
+    QCOMPARE(registry.registerPacketId(1), PacketTypeRegistry::INVALID_SLOT);
+    QCOMPARE(registry.findSlot(1), PacketTypeRegistry::INVALID_SLOT);
+    QCOMPARE(registry.registerPacketId(3), PacketTypeRegistry::Slot(1));
+    QCOMPARE(registry.slotCount(), PacketTypeRegistry::MAX_SLOTS);
+}
+
+void TestPacketTypeRegistry::testConcurrentRegistration() {
+    PacketTypeRegistry registry;
+    const int threadCount = 8;
+    const PacketId idCount = 1000;
+
+    // Every thread registers the same dense and sparse IDs in a different order
+    std::vector<std::vector<PacketTypeRegistry::Slot>> seen(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            seen[t].resize(idCount * 2);
+            for (PacketId i = 0; i < idCount; ++i) {
+                const PacketId index = (i * 7 + static_cast<PacketId>(t) * 131) % idCount;
+                seen[t][index] = registry.registerPacketId(index);
+                seen[t][idCount + index] = registry.registerPacketId(PacketTypeRegistry::DIRECT_ID_LIMIT + index * 1000);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QCOMPARE(registry.slotCount(), PacketTypeRegistry::Slot(idCount * 2));
+
+    std::set<PacketTypeRegistry::Slot> assignedSlots;
+    for (PacketId i = 0; i < idCount * 2; ++i) {
+        for (int t = 1; t < threadCount; ++t) {
+            QCOMPARE(seen[t][i], seen[0][i]);
+        }
+        assignedSlots.insert(seen[0][i]);
+    }
+    QCOMPARE(assignedSlots.size(), size_t(idCount * 2));
+    QCOMPARE(*assignedSlots.rbegin(), PacketTypeRegistry::Slot(idCount * 2 - 1));
+}
+
+void TestPacketTypeRegistry::testSlotTable() {
+    PacketSlotTable<int> table;
+
+    QVERIFY(table.find(0) == nullptr);
+    QVERIFY(table.find(PacketTypeRegistry::INVALID_SLOT) == nullptr);
+    QVERIFY(table.obtain(PacketTypeRegistry::MAX_SLOTS) == nullptr);
+
+    int* first = table.obtain(5);
+    QVERIFY(first != nullptr);
+    QCOMPARE(*first, 0);
+    *first = 42;
+
+    // Entries of an allocated chunk exist and keep their address
+    QVERIFY(table.find(6) != nullptr);
+    QVERIFY(table.find(PacketTypeRegistry::MAX_SLOTS - 1) == nullptr);
+    *table.obtain(PacketTypeRegistry::MAX_SLOTS - 1) = 7;
+    QCOMPARE(table.find(5), first);
+    QCOMPARE(*table.find(5), 42);
+
+    // Entries sit on separate cache lines
+    QVERIFY(reinterpret_cast<uintptr_t>(table.find(6)) - reinterpret_cast<uintptr_t>(first) >= 64);
+
+    int sum = 0;
+    size_t visited = 0;
+    table.forEach([&](PacketTypeRegistry::Slot slot, int& value) {
+        sum += value;
+        ++visited;
+        if (value != 0) {
+            QVERIFY(slot == 5 || slot == PacketTypeRegistry::MAX_SLOTS - 1);
+        }
+    });
+    QCOMPARE(sum, 49);
+    QCOMPARE(visited, size_t(128));
+}
+
+void TestPacketTypeRegistry::testSharedInstance() {
+    PacketTypeRegistry* registry = PacketTypeRegistry::instance();
+    QVERIFY(registry != nullptr);
+    QCOMPARE(PacketTypeRegistry::instance(), registry);
+
+    const auto slot = registry->registerPacketId(4242);
+    QVERIFY(slot != PacketTypeRegistry::INVALID_SLOT);
+    QCOMPARE(registry->findSlot(4242), slot);
+}
+
+QTEST_MAIN(TestPacketTypeRegistry)
+#include "test_packet_type_registry.moc"
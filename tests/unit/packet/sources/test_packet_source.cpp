@@ -265,7 +265,7 @@ void TestPacketSource::testStatisticsCopyConstructor() {
     QCOMPARE(copy.bytesGenerated.load(), uint64_t(10000));
     QCOMPARE(copy.errorCount.load(), uint64_t(2));
     QCOMPARE(copy.startTime, original.startTime);
-    QCOMPARE(copy.lastPacketTime, original.lastPacketTime);
+    QCOMPARE(copy.lastPacketTime.load(), original.lastPacketTime.load());
 }
 
 void TestPacketSource::testStatisticsAssignmentOperator() {
@@ -613,7 +613,7 @@ void TestPacketSource::testPacketDelivery() {
     // Last packet time should be recent
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now - stats.lastPacketTime).count();
+        now - stats.lastPacketTime.load()).count();
     QVERIFY(elapsed < 100); // Less than 100ms ago
 }
 
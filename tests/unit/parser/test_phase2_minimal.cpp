@@ -2,8 +2,11 @@
 #include <memory>
 
 #include "../../../src/parser/ast/ast_nodes.h"
+#include "../../../src/parser/parser/struct_parser.h"
 
 using namespace Monitor::Parser::AST;
+using Monitor::Parser::StructParser;
+using Monitor::Parser::Layout::ByteOrder;
 
 class TestPhase2Minimal : public QObject
 {
@@ -19,6 +22,7 @@ private slots:
     void testSourceLocation();
     void testPrimitiveTypeBasic();
     void testStructDeclarationBasic();
+    void testScalarStorageOrderPragma();
 
 private:
     // Helper methods
@@ -78,6 +82,46 @@ void TestPhase2Minimal::testStructDeclarationBasic()
     QCOMPARE(structDecl->getNodeType(), ASTNode::NodeType::STRUCT_DECLARATION);
     QVERIFY(structDecl->getFields().empty());
     QVERIFY(!structDecl->isPacked());
+    QCOMPARE(structDecl->getByteOrder(), ByteOrder::Native);
+}
+
+void TestPhase2Minimal::testScalarStorageOrderPragma()
+{
+    const std::string source = R"(
+        struct Local {
+            int a;
+        };
+        #pragma scalar_storage_order big-endian
+        struct Telemetry {
+            unsigned short port;
+            int counter;
+        };
+        #pragma pack(push, 1)
+        struct Status {
+            char flag;
+        };
+        #pragma pack(pop)
+        #pragma scalar_storage_order default
+        struct Host {
+            double value;
+        };
+    )";
+    
+    StructParser parser;
+    auto result = parser.parse(source);
+    QVERIFY(result.success);
+    QCOMPARE(result.structures.size(), static_cast<size_t>(4));
+    
+    // Each structure takes the order in effect where it starts
+    QCOMPARE(result.structures[0]->getName(), std::string("Local"));
+    QCOMPARE(result.structures[0]->getByteOrder(), ByteOrder::Native);
+    QCOMPARE(result.structures[1]->getByteOrder(), ByteOrder::Big);
+    QCOMPARE(result.structures[1]->getFieldCount(), static_cast<size_t>(2));
+    QCOMPARE(result.structures[2]->getByteOrder(), ByteOrder::Big);
+    QCOMPARE(result.structures[3]->getByteOrder(), ByteOrder::Native);
+    
+    auto invalid = parser.parse("#pragma scalar_storage_order sideways\nstruct S { int a; };");
+    QVERIFY(!invalid.success);
 }
 
 QTEST_MAIN(TestPhase2Minimal)
@@ -1,6 +1,7 @@
 #include <QtTest/QtTest>
 #include <QObject>
 #include <chrono>
+#include <cstring>
 #include <thread>
 
 #include "../../src/packet/core/packet_header.h"
@@ -140,6 +141,51 @@ private slots:
         }
     }
 
+    void testZeroCopyIngestion() {
+        auto app = Application::instance();
+        QVERIFY(app != nullptr);
+        auto memoryManager = app->memoryManager();
+        QVERIFY(memoryManager != nullptr);
+        
+        PacketFactory factory(memoryManager);
+        
+        // Source writes header and payload straight into the pooled buffer
+        {
+            const size_t payloadSize = 100;
+            auto buffer = factory.acquireBuffer(PACKET_HEADER_SIZE + payloadSize);
+            QVERIFY(buffer != nullptr);
+            QVERIFY(buffer->capacity() >= PACKET_HEADER_SIZE + payloadSize);
+            
+            auto* header = reinterpret_cast<PacketHeader*>(buffer->bytes());
+            *header = PacketHeader(3001, 7, static_cast<uint32_t>(payloadSize));
+            std::memset(buffer->bytes() + PACKET_HEADER_SIZE, 0xAB, payloadSize);
+            const uint8_t* written = buffer->bytes();
+            
+            auto result = factory.commitBuffer(std::move(buffer), PACKET_HEADER_SIZE + payloadSize);
+            QVERIFY(result.success);
+            QCOMPARE(result.packet->id(), 3001u);
+            QCOMPARE(result.packet->payloadSize(), payloadSize);
+            QCOMPARE(result.packet->data(), written);
+            QCOMPARE(result.packet->payload()[payloadSize - 1], uint8_t(0xAB));
+        }
+        
+        // Requests are clamped to the largest buffer class
+        {
+            auto buffer = factory.acquireBuffer(PacketHeader::MAX_PAYLOAD_SIZE);
+            QVERIFY(buffer != nullptr);
+            QCOMPARE(buffer->capacity(), PacketBuffer::maxBufferSize());
+        }
+        
+        // Too small to hold a header
+        QVERIFY(factory.acquireBuffer(0) == nullptr);
+        {
+            auto buffer = factory.acquireBuffer(PACKET_HEADER_SIZE);
+            QVERIFY(buffer != nullptr);
+            auto result = factory.commitBuffer(std::move(buffer), PACKET_HEADER_SIZE - 1);
+            QVERIFY(!result.success);
+        }
+    }
+
     void testPacket() {
         auto app = Application::instance();
         QVERIFY(app != nullptr);
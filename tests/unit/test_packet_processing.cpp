@@ -1,9 +1,18 @@
 #include <QtTest/QtTest>
 #include <QObject>
+#include <algorithm>
 #include <memory>
 #include <chrono>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <type_traits>
+#include <variant>
 
 #include "../../src/packet/processing/field_extractor.h"
+#include "../../src/packet/processing/batch_field_extractor.h"
 #include "../../src/packet/processing/data_transformer.h"
 #include "../../src/packet/processing/statistics_calculator.h"
 #include "../../src/packet/processing/packet_processor.h"
@@ -103,26 +112,734 @@ private slots:
         }
     }
     
+    void testExtractionPlan() {
+        using Descriptor = FieldExtractor::FieldDescriptor;
+        FieldExtractor extractor;
+        const PacketId testPacketId = 43;
+        
+        std::vector<Descriptor> fields;
+        fields.emplace_back("counter", 0, 4, "int");
+        fields.emplace_back("voltage", 4, 4, "float");
+        fields.emplace_back("samples", 8, 20, "int");
+        fields.back().isArray = true;
+        fields.back().arraySize = 5;
+        fields.emplace_back("port", 28, 2, "unsigned short");
+        fields.emplace_back("mode", 30, 4, "unsigned int");
+        fields.back().isBitfield = true;
+        fields.back().bitOffset = 3;
+        fields.back().bitWidth = 5;
+        fields.emplace_back("position", 34, 8, "double");
+        fields.emplace_back("timestamp", 42, 8, "unsigned long long");
+        fields.emplace_back("delta", 50, 1, "char");
+        fields.emplace_back("enabled", 51, 1, "bool");
+        fields.emplace_back("opaque", 52, 4, "struct blob");
+        QVERIFY(extractor.buildFieldMap(testPacketId, "Telemetry", fields, 56));
+        
+        const ExtractionPlan* plan = extractor.getExtractionPlan(testPacketId);
+        QVERIFY(plan != nullptr);
+        QCOMPARE(plan->columnCount(), fields.size());
+        QCOMPARE(plan->ops().size(), size_t(8));    // not the array or the unknown type
+        QCOMPARE(plan->extent(), size_t(52));
+        
+        auto app = Monitor::Core::Application::instance();
+        PacketFactory factory(app->memoryManager());
+        auto result = factory.createPacket(testPacketId, nullptr, 56);
+        QVERIFY(result.success);
+        uint8_t* payload = const_cast<uint8_t*>(result.packet->payload());
+        
+        const int32_t counter = -123456;
+        const float voltage = 3.3f;
+        const uint16_t port = 50000;
+        const uint32_t modeWord = (uint32_t(22) << 3) | 0x7 | 0xFFFFFF00u;
+        const double position = -42.125;
+        const uint64_t timestamp = 0xF000000000000001ull;
+        memcpy(payload + 0, &counter, 4);
+        memcpy(payload + 4, &voltage, 4);
+        memcpy(payload + 28, &port, 2);
+        memcpy(payload + 30, &modeWord, 4);
+        memcpy(payload + 34, &position, 8);
+        memcpy(payload + 42, &timestamp, 8);
+        payload[50] = 0xFE;
+        payload[51] = 1;
+        
+        FieldFrame frame(plan->columnCount());
+        QVERIFY(extractor.extractInto(result.packet, frame));
+        
+        // Names resolve once; the frame is read by column
+        const std::vector<int> columns = extractor.resolveColumns(testPacketId,
+            {"counter", "voltage", "port", "mode", "position", "timestamp", "delta", "enabled", "missing"});
+        QCOMPARE(columns, (std::vector<int>{0, 1, 3, 4, 5, 6, 7, 8, -1}));
+        
+        QCOMPARE(frame.integer(0), int64_t(counter));
+        QCOMPARE(frame.real(1), double(voltage));
+        QCOMPARE(frame.integer(1), int64_t(0));
+        QCOMPARE(frame.integer(3), int64_t(port));
+        QCOMPARE(frame.integer(4), int64_t(22));
+        QCOMPARE(frame.real(5), position);
+        QCOMPARE(uint64_t(frame.integer(6)), timestamp);
+        QCOMPARE(frame.integer(7), int64_t(-2));
+        QCOMPARE(frame.integer(8), int64_t(1));
+        QVERIFY(std::isnan(frame.real(2)));
+        QVERIFY(std::isnan(frame.real(9)));
+        
+        // Every compiled column agrees with the named path
+        for (const auto& op : plan->ops()) {
+            auto named = extractor.extractField(result.packet, fields[op.column].name);
+            QVERIFY(named.success);
+            const double expected = std::visit([](const auto& value) -> double {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_arithmetic_v<T>) {
+                    return static_cast<double>(value);
+                } else {
+                    return std::nan("");
+                }
+            }, named.value);
+            QCOMPARE(frame.real(op.column), expected);
+        }
+        
+        // A short payload decodes what fits and blanks the rest
+        auto shortResult = factory.createPacket(testPacketId, nullptr, 32);
+        QVERIFY(shortResult.success);
+        memcpy(const_cast<uint8_t*>(shortResult.packet->payload()), &counter, 4);
+        QVERIFY(extractor.extractInto(shortResult.packet, frame));
+        QCOMPARE(frame.integer(0), int64_t(counter));
+        QVERIFY(std::isnan(frame.real(4)));
+        QCOMPARE(frame.integer(6), int64_t(0));
+        
+        FieldFrame narrow(3);
+        QVERIFY(!extractor.extractInto(result.packet, narrow));
+        QVERIFY(extractor.getExtractionPlan(9999) == nullptr);
+    }
+    
+    void testBatchFieldExtractor() {
+        using Descriptor = FieldExtractor::FieldDescriptor;
+        FieldExtractor extractor;
+        const PacketId testPacketId = 44;
+        
+        // Every kind, wide and signed bitfields, and fields too close to the
+        // end of the payload for an 8-byte gather
+        std::vector<Descriptor> fields;
+        fields.emplace_back("b", 0, 1, "bool");
+        fields.emplace_back("i8", 1, 1, "signed char");
+        fields.emplace_back("u8", 2, 1, "unsigned char");
+        fields.emplace_back("i16", 3, 2, "short");
+        fields.emplace_back("u16", 5, 2, "unsigned short");
+        fields.emplace_back("i32", 7, 4, "int");
+        fields.emplace_back("u32", 11, 4, "unsigned int");
+        fields.emplace_back("i64", 15, 8, "long long");
+        fields.emplace_back("u64", 23, 8, "unsigned long long");
+        fields.emplace_back("f32", 31, 4, "float");
+        fields.emplace_back("f64", 35, 8, "double");
+        fields.emplace_back("bits", 43, 2, "unsigned short");
+        fields.back().isBitfield = true;
+        fields.back().bitOffset = 5;
+        fields.back().bitWidth = 9;
+        fields.emplace_back("wide", 45, 8, "unsigned long long");
+        fields.back().isBitfield = true;
+        fields.back().bitOffset = 1;
+        fields.back().bitWidth = 63;
+        fields.emplace_back("tail16", 53, 2, "short");
+        fields.emplace_back("tail8", 55, 1, "unsigned char");
+        QVERIFY(extractor.buildFieldMap(testPacketId, "Mixed", fields, 56));
+        const ExtractionPlan* plan = extractor.getExtractionPlan(testPacketId);
+        QVERIFY(plan != nullptr);
+        
+        auto app = Monitor::Core::Application::instance();
+        PacketFactory factory(app->memoryManager());
+        
+        // An odd count, with a short packet and a missing one in the middle
+        const size_t packetCount = 37;
+        std::vector<PacketPtr> packets;
+        uint32_t state = 99;
+        for (size_t i = 0; i < packetCount; ++i) {
+            if (i == 9) {
+                packets.push_back(PacketPtr());
+                continue;
+            }
+            const size_t payloadSize = i == 21 ? 30 : 56;
+            auto result = factory.createPacket(testPacketId, nullptr, payloadSize);
+            QVERIFY(result.success);
+            uint8_t* payload = const_cast<uint8_t*>(result.packet->payload());
+            for (size_t byte = 0; byte < payloadSize; ++byte) {
+                state = state * 1103515245u + 12345u;
+                payload[byte] = static_cast<uint8_t>(state >> 16);
+            }
+            const float f32 = -1.5f * static_cast<float>(i);
+            const double f64 = 1e300 / static_cast<double>(i + 1);
+            if (payloadSize >= 43) {
+                memcpy(payload + 31, &f32, sizeof(f32));
+                memcpy(payload + 35, &f64, sizeof(f64));
+            }
+            packets.push_back(result.packet);
+        }
+        
+        FieldFrame expected(plan->columnCount(), packetCount);
+        for (size_t i = 0; i < packetCount; ++i) {
+            if (packets[i]) {
+                QVERIFY(extractor.extractInto(packets[i], expected, i));
+            }
+        }
+        
+        for (auto implementation : {BatchFieldExtractor::Implementation::Scalar,
+                                    BatchFieldExtractor::Implementation::Avx2}) {
+            if (!BatchFieldExtractor::isSupported(implementation)) {
+                continue;
+            }
+            BatchFieldExtractor batch(*plan, implementation);
+            QCOMPARE(batch.implementation(), implementation);
+            
+            FieldColumns columns;
+            QCOMPARE(batch.extract(packets.data(), packets.size(), columns), packetCount - 2);
+            QCOMPARE(columns.rows(), packetCount);
+            
+            // Bit for bit, so NaN cells compare too
+            for (size_t column = 0; column < plan->columnCount(); ++column) {
+                for (size_t row = 0; row < packetCount; ++row) {
+                    const double want = expected.real(column, row);
+                    const double got = columns.real(column, row);
+                    QVERIFY2(memcmp(&want, &got, sizeof(double)) == 0,
+                             qPrintable(QString("%1 column %2 row %3")
+                                 .arg(BatchFieldExtractor::implementationName(implementation))
+                                 .arg(column).arg(row)));
+                    QCOMPARE(columns.integer(column, row), expected.integer(column, row));
+                }
+            }
+        }
+    }
+    
+    void testByteOrder() {
+        using Descriptor = FieldExtractor::FieldDescriptor;
+        using Parser::Layout::ByteOrder;
+        const ByteOrder foreign = Parser::Layout::hostByteOrder() == ByteOrder::Little
+            ? ByteOrder::Big : ByteOrder::Little;
+        
+        std::vector<Descriptor> fields;
+        fields.emplace_back("u8", 0, 1, "unsigned char");
+        fields.emplace_back("i16", 1, 2, "short");
+        fields.emplace_back("u16", 3, 2, "unsigned short");
+        fields.emplace_back("i32", 5, 4, "int");
+        fields.emplace_back("u32", 9, 4, "unsigned int");
+        fields.emplace_back("i64", 13, 8, "long long");
+        fields.emplace_back("u64", 21, 8, "unsigned long long");
+        fields.emplace_back("f32", 29, 4, "float");
+        fields.emplace_back("f64", 33, 8, "double");
+        fields.emplace_back("bits", 41, 2, "unsigned short");
+        fields.back().isBitfield = true;
+        fields.back().bitOffset = 3;
+        fields.back().bitWidth = 11;
+        fields.emplace_back("odd", 43, 3, "unsigned int");
+        fields.back().isBitfield = true;
+        fields.back().bitOffset = 6;
+        fields.back().bitWidth = 17;
+        fields.emplace_back("tail32", 46, 4, "int");
+        
+        // The same values stored natively and in the other byte order
+        FieldExtractor extractor;
+        const PacketId nativeId = 45;
+        const PacketId foreignId = 46;
+        QVERIFY(extractor.buildFieldMap(nativeId, "Native", fields, 50));
+        std::vector<Descriptor> foreignFields = fields;
+        for (auto& field : foreignFields) {
+            field.byteOrder = foreign;
+        }
+        QVERIFY(extractor.buildFieldMap(foreignId, "Foreign", foreignFields, 50));
+        QVERIFY(extractor.getExtractionPlan(foreignId)->ops()[1].swapped);
+        QVERIFY(!extractor.getExtractionPlan(foreignId)->ops()[0].swapped);
+        QVERIFY(!extractor.getExtractionPlan(nativeId)->ops()[1].swapped);
+        
+        auto app = Monitor::Core::Application::instance();
+        PacketFactory factory(app->memoryManager());
+        
+        const size_t packetCount = 23;
+        std::vector<PacketPtr> nativePackets;
+        std::vector<PacketPtr> foreignPackets;
+        uint32_t state = 7;
+        for (size_t i = 0; i < packetCount; ++i) {
+            const size_t payloadSize = i == 5 ? 31 : 50;
+            auto native = factory.createPacket(nativeId, nullptr, payloadSize);
+            auto swapped = factory.createPacket(foreignId, nullptr, payloadSize);
+            QVERIFY(native.success && swapped.success);
+        
+            uint8_t* payload = const_cast<uint8_t*>(native.packet->payload());
+            for (size_t byte = 0; byte < payloadSize; ++byte) {
+                state = state * 1103515245u + 12345u;
+                payload[byte] = static_cast<uint8_t>(state >> 16);
+            }
+            const float f32 = 0.75f * static_cast<float>(i) - 3.0f;
+            const double f64 = -2.5e10 * static_cast<double>(i + 1);
+            if (payloadSize >= 41) {
+                memcpy(payload + 29, &f32, sizeof(f32));
+                memcpy(payload + 33, &f64, sizeof(f64));
+            }
+        
+            uint8_t* reversed = const_cast<uint8_t*>(swapped.packet->payload());
+            memcpy(reversed, payload, payloadSize);
+            for (const auto& field : fields) {
+                if (field.offset + field.size <= payloadSize) {
+                    std::reverse(reversed + field.offset, reversed + field.offset + field.size);
+                }
+            }
+            nativePackets.push_back(native.packet);
+            foreignPackets.push_back(swapped.packet);
+        }
+        
+        // Named extraction
+        for (size_t i = 0; i < packetCount; ++i) {
+            for (const auto& field : fields) {
+                auto want = extractor.extractField(nativePackets[i], field.name);
+                auto got = extractor.extractField(foreignPackets[i], field.name);
+                QCOMPARE(got.success, want.success);
+                QVERIFY2(!want.success || got.value == want.value,
+                         qPrintable(QString("%1 in packet %2").arg(QString::fromStdString(field.name)).arg(i)));
+            }
+        }
+        
+        // Compiled plans, then batches of the foreign packets
+        const size_t columnCount = fields.size();
+        FieldFrame expected(columnCount, packetCount);
+        FieldFrame actual(columnCount, packetCount);
+        for (size_t i = 0; i < packetCount; ++i) {
+            QVERIFY(extractor.extractInto(nativePackets[i], expected, i));
+            QVERIFY(extractor.extractInto(foreignPackets[i], actual, i));
+        }
+        
+        auto compare = [&](auto cellReal, auto cellInteger, const QString& what) {
+            for (size_t column = 0; column < columnCount; ++column) {
+                for (size_t row = 0; row < packetCount; ++row) {
+                    const double want = expected.real(column, row);
+                    const double got = cellReal(column, row);
+                    QVERIFY2(memcmp(&want, &got, sizeof(double)) == 0,
+                             qPrintable(QString("%1 column %2 row %3").arg(what).arg(column).arg(row)));
+                    QCOMPARE(cellInteger(column, row), expected.integer(column, row));
+                }
+            }
+        };
+        compare([&](size_t c, size_t r) { return actual.real(c, r); },
+                [&](size_t c, size_t r) { return actual.integer(c, r); }, "plan");
+        
+        for (auto implementation : {BatchFieldExtractor::Implementation::Scalar,
+                                    BatchFieldExtractor::Implementation::Avx2}) {
+            if (!BatchFieldExtractor::isSupported(implementation)) {
+                continue;
+            }
+            BatchFieldExtractor batch(*extractor.getExtractionPlan(foreignId), implementation);
+            FieldColumns columns;
+            QCOMPARE(batch.extract(foreignPackets.data(), foreignPackets.size(), columns), packetCount - 1);
+            compare([&](size_t c, size_t r) { return columns.real(c, r); },
+                    [&](size_t c, size_t r) { return columns.integer(c, r); },
+                    BatchFieldExtractor::implementationName(implementation));
+        }
+    }
+    
+    void testTransformKernel() {
+        // Add, multiply and divide steps fold into one affine step
+        TransformKernel kernel;
+        kernel.add(-32.0).multiply(5.0).divide(9.0);
+        QCOMPARE(kernel.stepCount(), size_t(1));
+        QVERIFY(std::fabs(kernel.apply(212.0) - 100.0) < 1e-12);
+        kernel.negate().absolute().clamp(0.0, 50.0);
+        QCOMPARE(kernel.stepCount(), size_t(3));
+        QCOMPARE(kernel.apply(-40.0), 40.0);
+        QCOMPARE(kernel.apply(1000.0), 50.0);
+        QVERIFY(std::isnan(TransformKernel().divide(0.0).apply(3.0)));
+        QVERIFY(std::isnan(TransformKernel().modulo(0.0).apply(3.0)));
+        QCOMPARE(TransformKernel().truncate().apply(-2.7), -2.0);
+        QCOMPARE(TransformKernel().toBoolean().apply(-0.5), 1.0);
+        
+        // Non-finite factors are not folded, so they behave as applied one by one
+        const double inf = std::numeric_limits<double>::infinity();
+        QCOMPARE(TransformKernel().multiply(2.0).multiply(inf).apply(3.0), inf);
+        QCOMPARE(TransformKernel().add(1.0).multiply(inf).apply(-3.0), -inf);
+        QCOMPARE(TransformKernel().divide(inf).add(1.0).apply(3.0), 1.0);
+        QCOMPARE(TransformKernel().add(inf).multiply(2.0).apply(3.0), inf);
+        
+        // Moving windows match a brute-force window; a NaN input is skipped
+        const size_t window = 5;
+        TransformKernel average;
+        TransformKernel minimum;
+        TransformKernel range;
+        TransformKernel deviation;
+        average.movingAverage(window);
+        minimum.movingMinimum(window);
+        range.movingRange(window);
+        deviation.movingStandardDeviation(window);
+        std::deque<double> reference;
+        uint32_t state = 25;
+        for (int i = 0; i < 500; ++i) {
+            state = state * 1664525u + 1013904223u;
+            const double value = 1e5 + static_cast<double>(state >> 20) / 8.0;
+            reference.push_back(value);
+            if (reference.size() > window) {
+                reference.pop_front();
+            }
+            
+            const double n = static_cast<double>(reference.size());
+            const double mean = std::accumulate(reference.begin(), reference.end(), 0.0) / n;
+            double squares = 0.0;
+            for (double v : reference) {
+                squares += (v - mean) * (v - mean);
+            }
+            const auto extremes = std::minmax_element(reference.begin(), reference.end());
+            
+            QVERIFY(std::fabs(average.apply(value) - mean) < 1e-6);
+            QCOMPARE(minimum.apply(value), *extremes.first);
+            QCOMPARE(range.apply(value), *extremes.second - *extremes.first);
+            const double stddev = deviation.apply(value);
+            if (reference.size() < 2) {
+                QVERIFY(std::isnan(stddev));
+            } else {
+                QVERIFY(std::fabs(stddev - std::sqrt(squares / (n - 1.0))) < 1e-6);
+            }
+            
+            if (i == 250) {
+                QVERIFY(std::isnan(average.apply(std::numeric_limits<double>::quiet_NaN())));
+            }
+        }
+        
+        // A column run gives what applying value by value gives
+        TransformKernel perValue;
+        perValue.multiply(0.5).add(1.0).difference().cumulativeSum().movingAverage(7).function(TransformKernel::Function::Sqrt);
+        TransformKernel perColumn = perValue;
+        std::vector<double> input(300);
+        for (size_t i = 0; i < input.size(); ++i) {
+            input[i] = static_cast<double>((i * 37) % 101);
+        }
+        std::vector<double> output(input.size());
+        perColumn.run(input.data(), output.data(), 100);
+        perColumn.run(input.data() + 100, output.data() + 100, 200);
+        for (size_t i = 0; i < input.size(); ++i) {
+            const double expected = perValue.apply(input[i]);
+            QVERIFY(expected == output[i] || (std::isnan(expected) && std::isnan(output[i])));
+        }
+        
+        perColumn.reset();
+        QCOMPARE(perColumn.apply(4.0), 0.0);
+        perColumn.clear();
+        QVERIFY(perColumn.isEmpty());
+        QCOMPARE(perColumn.apply(4.0), 4.0);
+    }
+    
     void testDataTransformer() {
         DataTransformer transformer;
+        using Op = DataTransformer::OperationType;
+        using Step = DataTransformer::Transformation;
+        using Params = DataTransformer::TransformationParams;
         
-        // TODO: Implement DataTransformer API tests once the API is complete
-        // For now, just verify the transformer can be constructed
-        QVERIFY(true); // Basic test passes
+        // Numeric chains compile and keep the interpreter's result types
+        transformer.addTransformationChain("temperature", {
+            Step(Op::ToDouble), Step(Op::Subtract, Params(32.0)), Step(Op::Multiply, Params(5.0)),
+            Step(Op::Divide, Params(9.0))});
+        auto result = transformer.transform("temperature", FieldExtractor::FieldValue(int32_t(212)));
+        QVERIFY(result.success);
+        QVERIFY(std::fabs(std::get<double>(result.value) - 100.0) < 1e-12);
+        
+        transformer.addTransformationChain("counter", {Step(Op::Multiply, Params(2.5)), Step(Op::ToInteger)});
+        QCOMPARE(std::get<int64_t>(transformer.transform("counter", FieldExtractor::FieldValue(uint16_t(3))).value),
+                 int64_t(7));
+        
+        // Custom and string steps run after the compiled prefix, on its result
+        transformer.addTransformationChain("complex", {
+            Step(Op::ToDouble), Step(Op::Abs), Step(Op::Sqrt), Step(Op::Multiply, Params(10.0)), Step(Op::ToFloat),
+            Step([](const FieldExtractor::FieldValue& value, const Params&) -> FieldExtractor::FieldValue {
+                return std::holds_alternative<float>(value) ? std::get<float>(value) + 2.0 : -1.0;
+            })});
+        result = transformer.transform("complex", FieldExtractor::FieldValue(-16.0));
+        QVERIFY(result.success);
+        QCOMPARE(std::get<double>(result.value), 42.0);
+        
+        // Division by zero is left to the interpreter, which reports it
+        transformer.addTransformationChain("broken", {Step(Op::Add, Params(1.0)), Step(Op::Divide, Params(0.0))});
+        result = transformer.transform("broken", FieldExtractor::FieldValue(1.0));
+        QVERIFY(!result.success);
+        QCOMPARE(QString::fromStdString(result.error), QString("Division by zero"));
+        
+        TransformKernel kernel;
+        QVERIFY(transformer.compileKernel("temperature", kernel));
+        QVERIFY(!transformer.compileKernel("complex", kernel));
+        QVERIFY(!transformer.compileKernel("broken", kernel));
+        QVERIFY(!transformer.compileKernel("missing", kernel));
+        
+        // Bound columns transform in place; unbound ones and integers keep their values
+        const PacketId packetId = 2500;
+        QCOMPARE(transformer.bindColumns(packetId, {"temperature", "complex", "counter"}), size_t(2));
+        FieldColumns columns(3, 4);
+        for (size_t row = 0; row < 4; ++row) {
+            columns.reals(0)[row] = 32.0 + 9.0 * row;
+            columns.integers(0)[row] = 7;
+            columns.reals(1)[row] = 16.0;
+            columns.reals(2)[row] = 1.0 + row;
+        }
+        transformer.transformColumns(packetId, columns, 3);
+        QVERIFY(std::fabs(columns.reals(0)[2] - 10.0) < 1e-12);
+        QCOMPARE(columns.reals(0)[3], 59.0);
+        QCOMPARE(columns.integers(0)[1], int64_t(7));
+        QCOMPARE(columns.reals(1)[0], 16.0);
+        QCOMPARE(columns.reals(2)[2], 7.0);
+        
+        FieldFrame frame(3);
+        frame.reals()[0] = 212.0;
+        frame.reals()[2] = 3.0;
+        transformer.transformFrame(packetId, frame);
+        QVERIFY(std::fabs(frame.reals()[0] - 100.0) < 1e-12);
+        QCOMPARE(frame.reals()[2], 7.0);
+        transformer.transformFrame(packetId + 1, frame);
+        QCOMPARE(frame.reals()[2], 7.0);
+        
+        // A row into results by field name, typed as transform() types them; NaN cells are skipped
+        QVERIFY(transformer.isBound(packetId));
+        FieldFrame row(3);
+        row.reals()[0] = 212.0;
+        row.reals()[1] = 16.0;
+        row.reals()[2] = std::numeric_limits<double>::quiet_NaN();
+        std::unordered_map<std::string, DataTransformer::TransformationResult> results;
+        transformer.transformFrame(packetId, row, 0, results);
+        QCOMPARE(results.size(), size_t(1));
+        QVERIFY(std::fabs(std::get<double>(results["temperature"].value) - 100.0) < 1e-12);
+        row.reals()[2] = 3.0;
+        transformer.transformFrame(packetId, row, 0, results);
+        QCOMPARE(std::get<int64_t>(results["counter"].value), int64_t(7));
+        
+        // Changing any chain calls for binding again
+        transformer.addTransformationChain("complex", {Step(Op::Abs)});
+        QVERIFY(!transformer.isBound(packetId));
+        QCOMPARE(transformer.bindColumns(packetId, {"temperature", "complex", ""}), size_t(2));
+        QVERIFY(transformer.isBound(packetId));
+        transformer.invalidateColumns(packetId);
+        QVERIFY(!transformer.isBound(packetId));
     }
     
     void testDataTransformerStatefulFunctions() {
         DataTransformer transformer;
+        using Op = DataTransformer::OperationType;
+        using Step = DataTransformer::Transformation;
         
-        // TODO: Implement stateful function tests once the API is complete
-        QVERIFY(true); // Basic test passes
+        DataTransformer::TransformationParams window;
+        window.windowSize = 3;
+        transformer.addTransformationChain("average", {Step(Op::MovingAverage, window)});
+        transformer.addTransformationChain("diff", {Step(Op::Diff)});
+        transformer.addTransformationChain("sum", {Step(Op::CumulativeSum)});
+        
+        const std::vector<double> averages = {10.0, 15.0, 20.0, 30.0};
+        const std::vector<double> inputs = {10.0, 20.0, 30.0, 40.0};
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            QCOMPARE(std::get<double>(transformer.transform("average", FieldExtractor::FieldValue(inputs[i])).value),
+                     averages[i]);
+        }
+        
+        const std::vector<double> differences = {0.0, 5.0, -3.0};
+        const std::vector<double> readings = {5.0, 10.0, 7.0};
+        for (size_t i = 0; i < readings.size(); ++i) {
+            QCOMPARE(std::get<double>(transformer.transform("diff", FieldExtractor::FieldValue(readings[i])).value),
+                     differences[i]);
+        }
+        
+        double total = 0.0;
+        for (int32_t value : {5, 3, 2}) {
+            total += value;
+            QCOMPARE(std::get<double>(transformer.transform("sum", FieldExtractor::FieldValue(value)).value), total);
+        }
+        
+        // Chains bound to columns keep state of their own, across batches
+        const PacketId packetId = 2501;
+        QCOMPARE(transformer.bindColumns(packetId, {"average", "diff"}), size_t(2));
+        FieldColumns columns(2, 2);
+        std::vector<double> averaged;
+        for (int batch = 0; batch < 2; ++batch) {
+            for (size_t row = 0; row < 2; ++row) {
+                columns.reals(0)[row] = 10.0 * (2 * batch + row + 1);
+                columns.reals(1)[row] = 10.0 * (2 * batch + row + 1);
+            }
+            transformer.transformColumns(packetId, columns, 2);
+            averaged.insert(averaged.end(), columns.reals(0), columns.reals(0) + 2);
+            QCOMPARE(columns.reals(1)[1], 10.0);
+        }
+        QCOMPARE(averaged, averages);
+        
+        // Binding again after another chain changes keeps the unchanged columns' state
+        transformer.addTransformationChain("sum", {Step(Op::CumulativeSum)});
+        QVERIFY(!transformer.isBound(packetId));
+        QCOMPARE(transformer.bindColumns(packetId, {"average", "diff"}), size_t(2));
+        columns.reals(0)[0] = 50.0;
+        columns.reals(1)[0] = 50.0;
+        transformer.transformColumns(packetId, columns, 1);
+        QCOMPARE(columns.reals(0)[0], 40.0);
+        QCOMPARE(columns.reals(1)[0], 10.0);
+        
+        // resetState clears named chains and bound columns alike
+        transformer.resetState();
+        QCOMPARE(std::get<double>(transformer.transform("sum", FieldExtractor::FieldValue(4.0)).value), 4.0);
+        columns.reals(0)[0] = 90.0;
+        transformer.transformColumns(packetId, columns, 1);
+        QCOMPARE(columns.reals(0)[0], 90.0);
+    }
+    
+    void testStreamingStatistics() {
+        // Welford stays exact where sum-of-squares would cancel
+        RunningMoments moments;
+        for (double value : {1e9 + 4, 1e9 + 7, 1e9 + 13, 1e9 + 16}) {
+            moments.add(value);
+        }
+        QCOMPARE(moments.mean, 1e9 + 10);
+        QCOMPARE(moments.variance(), 30.0);
+        
+        // A window of 8 has one value per sketch block, so even its quantiles are exact
+        const auto windowSpan = std::chrono::milliseconds(5);
+        SlidingWindowStatistics window(8, windowSpan);
+        std::deque<std::pair<double, std::chrono::steady_clock::time_point>> reference;
+        auto timestamp = std::chrono::steady_clock::now();
+        uint32_t state = 24;
+        for (int i = 0; i < 3000; ++i) {
+            state = state * 1664525u + 1013904223u;
+            timestamp += std::chrono::microseconds(i % 200 == 0 ? 9000 : (state >> 24) * 4);
+            const double value = 1e6 + static_cast<double>(state >> 20) / 16.0;
+            
+            window.add(value, timestamp);
+            reference.emplace_back(value, timestamp);
+            while (reference.size() > 8 || reference.front().second < timestamp - windowSpan) {
+                reference.pop_front();
+            }
+            
+            std::vector<double> values;
+            for (const auto& entry : reference) {
+                values.push_back(entry.first);
+            }
+            std::sort(values.begin(), values.end());
+            const double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+            double variance = 0.0;
+            for (double v : values) {
+                variance += (v - mean) * (v - mean);
+            }
+            variance /= values.size();
+            const double middle = (values.size() - 1) / 2.0;
+            const double median = (values[static_cast<size_t>(std::floor(middle))] +
+                                   values[static_cast<size_t>(std::ceil(middle))]) / 2.0;
+            
+            QCOMPARE(window.size(), reference.size());
+            QVERIFY(std::fabs(window.mean() - mean) < 1e-6);
+            QVERIFY(std::fabs(window.variance() - variance) < 1e-6 * (1.0 + variance));
+            QCOMPARE(window.min(), values.front());
+            QCOMPARE(window.max(), values.back());
+            QCOMPARE(window.quantile(0.5), median);
+        }
+        
+        window.add(std::numeric_limits<double>::quiet_NaN(), timestamp);
+        QCOMPARE(window.size(), reference.size());
+        
+        // An outlier first value, once evicted, leaves no error behind
+        SlidingWindowStatistics outlierWindow(1000, std::chrono::milliseconds(0), 0);
+        std::deque<double> outlierReference;
+        for (int i = 0; i < 2500; ++i) {
+            state = state * 1664525u + 1013904223u;
+            const double value = i == 0 ? 1e9 : 100.0 + static_cast<double>(state >> 20) / 128.0;
+            outlierWindow.add(value);
+            outlierReference.push_back(value);
+            if (outlierReference.size() > 1000) {
+                outlierReference.pop_front();
+            }
+            
+            const double mean = std::accumulate(outlierReference.begin(), outlierReference.end(), 0.0) /
+                                outlierReference.size();
+            double variance = 0.0;
+            for (double v : outlierReference) {
+                variance += (v - mean) * (v - mean);
+            }
+            variance /= outlierReference.size();
+            QVERIFY(std::fabs(outlierWindow.variance() - variance) <= 1e-9 * variance);
+        }
+        
+        // Sketches stay within their rank error and merge into one of the combined stream
+        QuantileSketch first;
+        QuantileSketch second;
+        std::vector<double> all;
+        for (int i = 0; i < 200000; ++i) {
+            state = state * 1664525u + 1013904223u;
+            const double value = static_cast<double>(state >> 8);
+            (i % 3 == 0 ? first : second).add(value);
+            all.push_back(value);
+        }
+        QVERIFY(first.retained() < 1000);
+        first.merge(second);
+        QCOMPARE(first.count(), uint64_t(all.size()));
+        
+        std::sort(all.begin(), all.end());
+        for (double fraction : {0.01, 0.25, 0.5, 0.75, 0.99}) {
+            const double estimate = first.quantile(fraction);
+            const double rank = double(std::lower_bound(all.begin(), all.end(), estimate) - all.begin()) / all.size();
+            QVERIFY2(std::fabs(rank - fraction) < 0.01,
+                     qPrintable(QString("Quantile %1 landed at rank %2").arg(fraction).arg(rank)));
+        }
+        QVERIFY(std::isnan(QuantileSketch().quantile(0.5)));
     }
     
     void testStatisticsCalculator() {
-        StatisticsCalculator calculator;
+        StatisticsCalculator::Configuration config;
+        config.windowSize = 4;
+        StatisticsCalculator calculator(config);
         
-        // TODO: Implement StatisticsCalculator tests once the API is stabilized
-        QVERIFY(true); // Basic test passes
+        // Field slots: column 1 stands for an array, which frames leave NaN
+        const PacketId packetId = 47;
+        FieldFrame frame(3);
+        for (int i = 0; i < 10; ++i) {
+            frame.reals()[0] = i;
+            frame.reals()[2] = -0.5 * i;
+            calculator.updateStatistics(packetId, frame);
+        }
+        QCOMPARE(calculator.getTotalSamples(), uint64_t(20));
+        
+        auto snapshot = calculator.getFieldSnapshot(packetId, 0);
+        QCOMPARE(snapshot.sampleCount, uint64_t(10));
+        QCOMPARE(snapshot.current, 9.0);
+        QCOMPARE(snapshot.previous, 8.0);
+        QCOMPARE(snapshot.mean, 4.5);
+        QVERIFY(std::fabs(snapshot.variance - 55.0 / 6.0) < 1e-12);
+        QCOMPARE(snapshot.min, 0.0);
+        QCOMPARE(snapshot.max, 9.0);
+        QCOMPARE(snapshot.windowCount, size_t(4));
+        QCOMPARE(snapshot.windowMean, 7.5);
+        QCOMPARE(snapshot.windowMin, 6.0);
+        QCOMPARE(snapshot.windowMax, 9.0);
+        QCOMPARE(snapshot.windowMedian, 7.5);
+        
+        QCOMPARE(calculator.getFieldSnapshot(packetId, 1).sampleCount, uint64_t(0));
+        QCOMPARE(calculator.getFieldSnapshot(packetId, 2).windowMin, -4.5);
+        QCOMPARE(calculator.calculatePercentiles(packetId, 0, {0.0, 50.0, 100.0}),
+                 std::vector<double>({6.0, 7.5, 9.0}));
+        QCOMPARE(calculator.getWindowSketch(packetId, 0).count(), uint64_t(4));
+        
+        // Batches update the same slots column by column
+        FieldColumns columns(3, 8);
+        for (size_t row = 0; row < 8; ++row) {
+            columns.reals(0)[row] = 100.0 + row;
+        }
+        calculator.updateStatistics(packetId, columns, 2);
+        snapshot = calculator.getFieldSnapshot(packetId, 0);
+        QCOMPARE(snapshot.sampleCount, uint64_t(12));
+        QCOMPARE(snapshot.current, 101.0);
+        QCOMPARE(snapshot.windowMin, 8.0);
+        QCOMPARE(calculator.calculatePercentile(packetId, 0, 50.0), 54.5);
+        
+        QCOMPARE(calculator.getFieldSnapshot(4799, 0).sampleCount, uint64_t(0));
+        QCOMPARE(calculator.calculatePercentile(4799, 0, 50.0), 0.0);
+        
+        // Fields by name
+        for (int i = 1; i <= 5; ++i) {
+            calculator.updateStatistics("speed", FieldExtractor::FieldValue(static_cast<double>(i)));
+        }
+        auto fieldStats = calculator.getFieldStatistics("speed");
+        QCOMPARE(fieldStats.sampleCount.load(), uint64_t(5));
+        QCOMPARE(fieldStats.mean.load(), 3.0);
+        QCOMPARE(fieldStats.variance.load(), 2.5);
+        QCOMPARE(fieldStats.range.load(), 4.0);
+        
+        auto windowed = calculator.getWindowedStatistics("speed");
+        QCOMPARE(windowed.windowMean, 3.5);
+        QCOMPARE(windowed.windowMin, 2.0);
+        QCOMPARE(windowed.windowMedian, 3.5);
+        QCOMPARE(calculator.calculatePercentile("speed", 100.0), 5.0);
+        
+        calculator.resetAllStatistics();
+        QCOMPARE(calculator.getFieldSnapshot(packetId, 0).sampleCount, uint64_t(0));
+        QCOMPARE(calculator.getTotalSamples(), uint64_t(0));
     }
     
     void testStatisticsCalculatorPerformance() {
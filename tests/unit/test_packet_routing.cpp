@@ -201,6 +201,539 @@ private slots:
         manager.unsubscribe(sub200);
     }
     
+    void testWildcardSubscription() {
+        SubscriptionManager manager;
+        
+        std::vector<std::string> deliveryOrder;
+        
+        auto sub100 = manager.subscribe("Type100", 100, [&](PacketPtr) { deliveryOrder.push_back("Type100"); }, 2);
+        auto firstAll = manager.subscribe("AllFirst", SubscriptionManager::ALL_PACKETS,
+            [&](PacketPtr) { deliveryOrder.push_back("AllFirst"); }, 1);
+        auto lastAll = manager.subscribe("AllLast", SubscriptionManager::ALL_PACKETS,
+            [&](PacketPtr) { deliveryOrder.push_back("AllLast"); }, 3);
+        
+        auto app = Monitor::Core::Application::instance();
+        QVERIFY(app);
+        auto memMgr = app->memoryManager();
+        QVERIFY(memMgr);
+        PacketFactory factory(memMgr);
+        
+        // Wildcards interleave with the packet's own subscribers by priority
+        auto result100 = factory.createPacket(100, nullptr, 64);
+        QVERIFY(result100.success);
+        QCOMPARE(manager.distributePacket(result100.packet), 3u);
+        QCOMPARE(deliveryOrder, (std::vector<std::string>{"AllFirst", "Type100", "AllLast"}));
+        
+        // Packet types nobody subscribed to still reach the wildcards
+        deliveryOrder.clear();
+        auto result200 = factory.createPacket(200, nullptr, 64);
+        QVERIFY(result200.success);
+        QCOMPARE(manager.distributePacket(result200.packet), 2u);
+        QCOMPARE(deliveryOrder, (std::vector<std::string>{"AllFirst", "AllLast"}));
+        
+        QVERIFY(manager.unsubscribe(firstAll));
+        QVERIFY(manager.unsubscribe(lastAll));
+        QCOMPARE(manager.distributePacket(result200.packet), 0u);
+        
+        manager.unsubscribe(sub100);
+    }
+    
+    void testSubscriptionChangesDuringDelivery() {
+        SubscriptionManager manager;
+        
+        auto app = Monitor::Core::Application::instance();
+        QVERIFY(app);
+        auto memMgr = app->memoryManager();
+        QVERIFY(memMgr);
+        PacketFactory factory(memMgr);
+        auto result = factory.createPacket(100, nullptr, 64);
+        QVERIFY(result.success);
+        
+        // A callback may unsubscribe itself and subscribe others
+        std::atomic<int> onceCalls{0};
+        std::atomic<int> laterCalls{0};
+        SubscriptionManager::SubscriberId laterId = 0;
+        SubscriptionManager::SubscriberId onceId = 0;
+        onceId = manager.subscribe("Once", 100, [&](PacketPtr) {
+            onceCalls++;
+            QVERIFY(manager.unsubscribe(onceId));
+            laterId = manager.subscribe("Later", 100, [&](PacketPtr) { laterCalls++; });
+        });
+        
+        QCOMPARE(manager.distributePacket(result.packet), 1u);
+        QCOMPARE(manager.distributePacket(result.packet), 1u);
+        QCOMPARE(onceCalls.load(), 1);
+        QCOMPARE(laterCalls.load(), 1);
+        QVERIFY(manager.unsubscribe(laterId));
+        
+        // A blocked callback neither delays subscribe() nor survives unsubscribe()
+        std::atomic<bool> inCallback{false};
+        std::atomic<bool> release{false};
+        std::atomic<bool> returned{false};
+        auto slowId = manager.subscribe("Slow", 100, [&](PacketPtr) {
+            inCallback = true;
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            returned = true;
+        });
+        
+        std::thread deliverer([&]() { manager.distributePacket(result.packet); });
+        QTRY_VERIFY_WITH_TIMEOUT(inCallback.load(), 5000);
+        
+        auto otherId = manager.subscribe("Other", 100, [](PacketPtr) {});
+        QVERIFY(otherId != 0);
+        QCOMPARE(manager.getSubscriberCount(100), size_t(2));
+        
+        std::thread releaser([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            release = true;
+        });
+        QVERIFY(manager.unsubscribe(slowId));
+        QVERIFY(returned.load());
+        
+        releaser.join();
+        deliverer.join();
+        manager.unsubscribe(otherId);
+    }
+    
+    void testBatchDistribution() {
+        SubscriptionManager manager;
+        
+        auto app = Monitor::Core::Application::instance();
+        QVERIFY(app);
+        PacketFactory factory(app->memoryManager());
+        
+        // Interleaved IDs 601 and 602, plus a null entry that is dropped
+        std::vector<PacketPtr> batch;
+        for (int i = 0; i < 6; ++i) {
+            auto result = factory.createPacket(static_cast<PacketId>(601 + i % 2), nullptr, 16);
+            QVERIFY(result.success);
+            batch.push_back(result.packet);
+        }
+        batch.insert(batch.begin() + 3, PacketPtr());
+        std::vector<SequenceNumber> sent;
+        std::vector<SequenceNumber> sent601;
+        for (const auto& packet : batch) {
+            if (packet) {
+                sent.push_back(packet->sequence());
+            }
+            if (packet && packet->id() == 601) {
+                sent601.push_back(packet->sequence());
+            }
+        }
+        
+        int batchCalls = 0;
+        std::vector<SequenceNumber> received601;
+        manager.subscribeBatch("Batch601", 601, [&](PacketSpan packets) {
+            batchCalls++;
+            for (const auto& packet : packets) {
+                QCOMPARE(packet->id(), PacketId(601));
+                received601.push_back(packet->sequence());
+            }
+        });
+        
+        int singleCalls = 0;
+        manager.subscribe("Single602", 602, [&](PacketPtr packet) {
+            QCOMPARE(packet->id(), PacketId(602));
+            singleCalls++;
+        });
+        
+        int wildcardCalls = 0;
+        std::vector<SequenceNumber> recorded;
+        manager.subscribeBatch("Recorder", SubscriptionManager::ALL_PACKETS, [&](PacketSpan packets) {
+            wildcardCalls++;
+            for (const auto& packet : packets) {
+                recorded.push_back(packet->sequence());
+            }
+        });
+        
+        // One call per batch subscriber, one per packet otherwise, order kept per ID
+        QCOMPARE(manager.distributeBatch(batch), size_t(3 + 3 + 6));
+        QCOMPARE(batch.size(), size_t(6));
+        QCOMPARE(batchCalls, 1);
+        QVERIFY(received601 == sent601);
+        QCOMPARE(singleCalls, 3);
+        QCOMPARE(wildcardCalls, 1);
+        
+        // Wildcard batch subscribers see arrival order, not ID order
+        QVERIFY(recorded == sent);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            QCOMPARE(batch[i]->sequence(), sent[i]);
+        }
+        QCOMPARE(manager.getStatistics().packetsDistributed.load(), uint64_t(6));
+        
+        // Batch subscribers take single packets as one-packet spans
+        QCOMPARE(manager.distributePacket(batch.front()), size_t(2));
+        QCOMPARE(wildcardCalls, 2);
+    }
+    
+    void testBatchRouting() {
+        PacketRouter::Configuration config;
+        config.queueSize = 1024;
+        config.workerThreads = 2;
+        config.batchSize = 64;
+        
+        PacketRouter router(config);
+        SubscriptionManager subscriptionManager;
+        router.setSubscriptionManager(&subscriptionManager);
+        
+        std::atomic<int> calls{0};
+        std::atomic<int> received{0};
+        subscriptionManager.subscribeBatch("Batch", 700, [&](PacketSpan packets) {
+            calls++;
+            received += static_cast<int>(packets.size());
+        });
+        
+        QVERIFY(router.start());
+        
+        auto app = Monitor::Core::Application::instance();
+        QVERIFY(app);
+        PacketFactory factory(app->memoryManager());
+        
+        const int batches = 20;
+        const int batchSize = 50;
+        for (int b = 0; b < batches; ++b) {
+            std::vector<PacketPtr> packets;
+            for (int i = 0; i < batchSize; ++i) {
+                auto result = factory.createPacket(700, nullptr, 32);
+                QVERIFY(result.success);
+                packets.push_back(result.packet);
+            }
+            QCOMPARE(router.routePackets(packets, PacketRouter::Priority::High), size_t(batchSize));
+            QVERIFY(packets.empty());
+        }
+        
+        QTRY_COMPARE_WITH_TIMEOUT(received.load(), batches * batchSize, 5000);
+        QVERIFY(calls.load() <= batches * batchSize);
+        
+        const auto& stats = router.getStatistics();
+        QCOMPARE(stats.packetsReceived.load(), uint64_t(batches * batchSize));
+        QCOMPARE(stats.packetsRouted.load(), uint64_t(batches * batchSize));
+        QCOMPARE(stats.packetsPerPriority[static_cast<size_t>(PacketRouter::Priority::High)].load(), uint64_t(batches * batchSize));
+        
+        router.stop();
+        
+        // A stopped router drops the whole batch
+        std::vector<PacketPtr> late{factory.createPacket(700, nullptr, 32).packet};
+        QCOMPARE(router.routePackets(late), size_t(0));
+        QCOMPARE(stats.packetsDropped.load(), uint64_t(1));
+    }
+    
+    void testMailboxDropPolicies() {
+        SubscriptionManager manager;
+        
+        auto app = Monitor::Core::Application::instance();
+        QVERIFY(app);
+        PacketFactory factory(app->memoryManager());
+        
+        // Drains are held back until runDrains(), as if the subscriber were slow
+        std::vector<std::function<void()>> pending;
+        auto runDrains = [&]() {
+            while (!pending.empty()) {
+                auto drains = std::move(pending);
+                pending.clear();
+                for (auto& drain : drains) {
+                    drain();
+                }
+            }
+        };
+        
+        SubscriptionManager::SubscriptionOptions options;
+        options.mailboxCapacity = 4;
+        options.drainBatchSize = 3;
+        options.executor = [&](std::function<void()> drain) { pending.push_back(std::move(drain)); };
+        
+        std::vector<SequenceNumber> oldest, newest, latest;
+        options.policy = SubscriptionManager::DeliveryPolicy::DropOldest;
+        auto dropOldest = manager.subscribe("DropOldest", 701, [&](PacketPtr packet) {
+            oldest.push_back(packet->sequence());
+        }, options);
+        options.policy = SubscriptionManager::DeliveryPolicy::DropNewest;
+        auto dropNewest = manager.subscribe("DropNewest", 701, [&](PacketPtr packet) {
+            newest.push_back(packet->sequence());
+        }, options);
+        options.policy = SubscriptionManager::DeliveryPolicy::ConflateLatest;
+        auto conflate = manager.subscribeBatch("Conflate", SubscriptionManager::ALL_PACKETS, [&](PacketSpan packets) {
+            for (const auto& packet : packets) {
+                latest.push_back(packet->sequence());
+            }
+        }, options);
+        QVERIFY(dropOldest != 0 && dropNewest != 0 && conflate != 0);
+        
+        std::vector<PacketPtr> sent;
+        for (int i = 0; i < 10; ++i) {
+            auto result = factory.createPacket(static_cast<PacketId>(701 + i % 2), nullptr, 16);
+            QVERIFY(result.success);
+            sent.push_back(result.packet);
+            manager.distributePacket(result.packet);
+        }
+        
+        // Nothing is delivered on the distributing thread
+        QVERIFY(oldest.empty() && newest.empty() && latest.empty());
+        QCOMPARE(pending.size(), size_t(3));
+        runDrains();
+        
+        // Five 701 packets into four slots: the first or the last one is lost
+        std::vector<SequenceNumber> sent701;
+        for (const auto& packet : sent) {
+            if (packet->id() == 701) {
+                sent701.push_back(packet->sequence());
+            }
+        }
+        QVERIFY(oldest == std::vector<SequenceNumber>(sent701.begin() + 1, sent701.end()));
+        QVERIFY(newest == std::vector<SequenceNumber>(sent701.begin(), sent701.end() - 1));
+        
+        // One slot per ID, holding its latest packet, in the order the IDs were first queued
+        QVERIFY(latest == std::vector<SequenceNumber>({sent[8]->sequence(), sent[9]->sequence()}));
+        
+        auto stats = manager.getSubscriberStatistics();
+        QCOMPARE(stats.size(), size_t(3));
+        QCOMPARE(stats[0].name, std::string("DropOldest"));
+        QVERIFY(stats[0].policy == SubscriptionManager::DeliveryPolicy::DropOldest);
+        QCOMPARE(stats[0].packetsDropped, uint64_t(1));
+        QCOMPARE(stats[0].packetsReceived, uint64_t(4));
+        QCOMPARE(stats[1].packetsDropped, uint64_t(1));
+        QCOMPARE(stats[2].packetsConflated, uint64_t(8));
+        QCOMPARE(stats[2].packetsDropped, uint64_t(8));
+        QCOMPARE(stats[2].packetsReceived, uint64_t(2));
+        QCOMPARE(stats[2].queueDepth, size_t(0));
+        QCOMPARE(stats[2].mailboxCapacity, size_t(4));
+        QCOMPARE(manager.getStatistics().mailboxDrops.load(), uint64_t(10));
+        
+        // Non-critical subscribers never hold sources back
+        QVERIFY(manager.hasCredit(1000));
+    }
+    
+    void testMailboxBlockAndCredit() {
+        SubscriptionManager manager;
+        
+        auto app = Monitor::Core::Application::instance();
+        QVERIFY(app);
+        PacketFactory factory(app->memoryManager());
+        
+        std::vector<PacketPtr> batch;
+        for (int i = 0; i < 100; ++i) {
+            auto result = factory.createPacket(702, nullptr, 16);
+            QVERIFY(result.success);
+            batch.push_back(result.packet);
+        }
+        
+        // Without an executor or pool, Block drains inline and loses nothing
+        size_t inlineReceived = 0;
+        SubscriptionManager::SubscriptionOptions options;
+        options.policy = SubscriptionManager::DeliveryPolicy::Block;
+        options.mailboxCapacity = 8;
+        auto inlineSub = manager.subscribeBatch("Inline", 702, [&](PacketSpan packets) {
+            inlineReceived += packets.size();
+        }, options);
+        manager.distributeBatch(batch);
+        QCOMPARE(inlineReceived, size_t(100));
+        QVERIFY(manager.unsubscribe(inlineSub));
+        
+        // A critical subscriber with a full mailbox withholds credit until it drains
+        std::mutex pendingMutex;
+        std::vector<std::function<void()>> pending;
+        std::atomic<size_t> received{0};
+        options.mailboxCapacity = 4;
+        options.critical = true;
+        options.executor = [&](std::function<void()> drain) {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            pending.push_back(std::move(drain));
+        };
+        auto critical = manager.subscribe("Recorder", 702, [&](PacketPtr) { received++; }, options);
+        QVERIFY(critical != 0);
+        
+        std::vector<PacketPtr> fill(batch.begin(), batch.begin() + 4);
+        QCOMPARE(manager.distributeBatch(fill), size_t(4));
+        QVERIFY(manager.hasCredit(0));
+        QVERIFY(!manager.hasCredit(1));
+        QVERIFY(!manager.waitForCredit(1));
+        QVERIFY(!manager.waitForCredit(1, std::chrono::milliseconds(5)));
+        
+        std::thread subscriberThread([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::vector<std::function<void()>> drains;
+            {
+                std::lock_guard<std::mutex> lock(pendingMutex);
+                drains.swap(pending);
+            }
+            for (auto& drain : drains) {
+                drain();
+            }
+        });
+        const bool credited = manager.waitForCredit(4, std::chrono::seconds(5));
+        subscriberThread.join();
+        QVERIFY(credited);
+        QCOMPARE(received.load(), size_t(4));
+        
+        auto stats = manager.getSubscriberStatistics();
+        QCOMPARE(stats.size(), size_t(1));
+        QVERIFY(stats[0].critical);
+        QVERIFY(stats[0].policy == SubscriptionManager::DeliveryPolicy::Block);
+        QCOMPARE(stats[0].packetsDropped, uint64_t(0));
+        QVERIFY(stats[0].maxLagNs >= 20000000u);
+        QCOMPARE(QString(SubscriptionManager::policyName(stats[0].policy)), QString("block"));
+        
+        // Unsubscribing a critical subscriber returns its credit
+        QCOMPARE(manager.distributeBatch(fill), size_t(4));
+        QVERIFY(!manager.hasCredit(1));
+        QVERIFY(manager.unsubscribe(critical));
+        QVERIFY(manager.hasCredit(1));
+        for (auto& drain : pending) {
+            drain();
+        }
+        QCOMPARE(received.load(), size_t(4));
+    }
+    
+    void testDispatcherCreditStall() {
+        PacketDispatcher::Configuration config;
+        config.creditWaitMs = 5;
+        PacketDispatcher dispatcher(config);
+        
+        auto app = Monitor::Core::Application::instance();
+        QVERIFY(app);
+        PacketFactory factory(app->memoryManager());
+        
+        std::vector<std::function<void()>> pending;
+        SubscriptionManager::SubscriptionOptions options;
+        options.policy = SubscriptionManager::DeliveryPolicy::Block;
+        options.mailboxCapacity = 2;
+        options.critical = true;
+        options.executor = [&](std::function<void()> drain) { pending.push_back(std::move(drain)); };
+        QVERIFY(dispatcher.subscribe("Recorder", 703, [](PacketPtr) {}, options) != 0);
+        
+        std::vector<PacketPtr> packets;
+        for (int i = 0; i < 2; ++i) {
+            auto result = factory.createPacket(703, nullptr, 16);
+            QVERIFY(result.success);
+            packets.push_back(result.packet);
+        }
+        dispatcher.getSubscriptionManager()->distributeBatch(packets);
+        
+        // The mailbox is full, so the batch waits creditWaitMs and is dropped
+        QSignalSpy spy(&dispatcher, &PacketDispatcher::backPressureDetected);
+        dispatcher.dispatchBatch(packets);
+        const auto& stats = dispatcher.getStatistics();
+        QCOMPARE(stats.creditStalls.load(), uint64_t(1));
+        QCOMPARE(stats.totalPacketsDropped.load(), uint64_t(2));
+        QCOMPARE(spy.count(), 1);
+        
+        for (auto& drain : pending) {
+            drain();
+        }
+        QVERIFY(dispatcher.getSubscriptionManager()->hasCredit(2));
+    }
+    
+    void testLatestPacketConflation() {
+        SubscriptionManager manager;
+        
+        auto app = Monitor::Core::Application::instance();
+        QVERIFY(app);
+        PacketFactory factory(app->memoryManager());
+        
+        std::vector<PacketPtr> packets;
+        for (int i = 0; i < 8; ++i) {
+            auto result = factory.createPacket(static_cast<PacketId>(901 + i % 2), nullptr, 16);
+            QVERIFY(result.success);
+            packets.push_back(result.packet);
+        }
+        
+        // Nothing is kept before a watch
+        manager.distributePacket(packets[0]);
+        QVERIFY(!manager.latestPacket(901));
+        QVERIFY(manager.watchLatest(901));
+        QVERIFY(!manager.watchLatest(SubscriptionManager::ALL_PACKETS));
+        
+        uint64_t version = 0;
+        QVERIFY(!manager.latestPacket(901, &version));
+        QCOMPARE(version, uint64_t(0));
+        
+        // Each packet overwrites the slot; unwatched IDs are not kept
+        for (int i = 0; i < 4; ++i) {
+            manager.distributePacket(packets[i]);
+        }
+        QVERIFY(manager.latestPacket(901, &version) == packets[2]);
+        QCOMPARE(version, uint64_t(2));
+        QCOMPARE(manager.latestVersion(901), uint64_t(2));
+        QVERIFY(!manager.latestPacket(902));
+        
+        // A batch publishes the last packet of each watched ID once
+        std::vector<PacketPtr> batch(packets.begin() + 4, packets.end());
+        manager.distributeBatch(batch);
+        QVERIFY(manager.latestPacket(901) == packets[6]);
+        QCOMPARE(manager.latestVersion(901), uint64_t(3));
+        batch.clear();
+        
+        // Reading far more often than packets arrive keeps the counts balanced
+        for (int i = 0; i < 20000; ++i) {
+            QVERIFY(manager.latestPacket(901) == packets[6]);
+        }
+        
+        // Handles read from the slot outlive it; the last unwatch releases the slot's hold
+        PacketPtr held = manager.latestPacket(901);
+        QVERIFY(manager.watchLatest(901));
+        manager.unwatchLatest(901);
+        QVERIFY(manager.latestPacket(901) == packets[6]);
+        manager.unwatchLatest(901);
+        QVERIFY(!manager.latestPacket(901));
+        QVERIFY(held == packets[6]);
+        held.reset();
+        QCOMPARE(packets[6].use_count(), 1L);
+    }
+    
+    void testLatestPacketConcurrency() {
+        SubscriptionManager manager;
+        
+        auto app = Monitor::Core::Application::instance();
+        QVERIFY(app);
+        PacketFactory factory(app->memoryManager());
+        
+        std::vector<PacketPtr> packets;
+        for (int i = 0; i < 64; ++i) {
+            auto result = factory.createPacket(903, nullptr, 16);
+            QVERIFY(result.success);
+            packets.push_back(result.packet);
+        }
+        QVERIFY(manager.watchLatest(903));
+        
+        // Writers overwrite while readers take handles; every count must balance
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> writes{0};
+        std::vector<std::thread> threads;
+        for (int w = 0; w < 2; ++w) {
+            threads.emplace_back([&, w]() {
+                for (size_t round = 0; round < 2000 || reads.load() < 1000; ++round) {
+                    manager.distributePacket(packets[(round * 2 + w) % packets.size()]);
+                    writes++;
+                }
+            });
+        }
+        for (int r = 0; r < 2; ++r) {
+            threads.emplace_back([&]() {
+                while (running.load()) {
+                    PacketPtr packet = manager.latestPacket(903);
+                    if (packet) {
+                        QCOMPARE(packet->id(), PacketId(903));
+                        reads++;
+                    }
+                }
+            });
+        }
+        threads[0].join();
+        threads[1].join();
+        running = false;
+        threads[2].join();
+        threads[3].join();
+        
+        QCOMPARE(manager.latestVersion(903), writes.load());
+        manager.unwatchLatest(903);
+        for (const auto& packet : packets) {
+            QCOMPARE(packet.use_count(), 1L);
+        }
+    }
+    
     void testPacketRouter() {
         PacketRouter::Configuration config;
         config.queueSize = 1000;
@@ -249,6 +782,56 @@ private slots:
         router.stop();
     }
     
+    void testShardedRouterOrdering() {
+        PacketRouter::Configuration config;
+        config.queueSize = 8192;
+        config.workerThreads = 4;
+        config.shardByPacketId = true;
+        
+        PacketRouter router(config);
+        SubscriptionManager subscriptionManager;
+        router.setSubscriptionManager(&subscriptionManager);
+        
+        // Each packet ID is handled by one worker, so its packets arrive in sequence order
+        const int packetTypes = 8;
+        const int packetsPerType = 500;
+        std::vector<std::atomic<SequenceNumber>> lastSequence(packetTypes);
+        std::atomic<int> received{0};
+        std::atomic<int> outOfOrder{0};
+        for (int i = 0; i < packetTypes; ++i) {
+            subscriptionManager.subscribe("Ordered", static_cast<PacketId>(500 + i), [&, i](PacketPtr packet) {
+                if (packet->sequence() < lastSequence[i].exchange(packet->sequence())) {
+                    ++outOfOrder;
+                }
+                ++received;
+            });
+        }
+        
+        QVERIFY(router.start());
+        
+        auto app = Monitor::Core::Application::instance();
+        QVERIFY(app);
+        PacketFactory factory(app->memoryManager());
+        for (int n = 0; n < packetsPerType; ++n) {
+            for (int i = 0; i < packetTypes; ++i) {
+                auto result = factory.createPacket(static_cast<PacketId>(500 + i), nullptr, 32);
+                QVERIFY(result.success);
+                QVERIFY(router.routePacket(result.packet));
+            }
+        }
+        QTRY_COMPARE_WITH_TIMEOUT(received.load(), packetTypes * packetsPerType, 5000);
+        QCOMPARE(outOfOrder.load(), 0);
+        
+        // A worker that parked while idle wakes for a single packet
+        QThread::msleep(50);
+        auto result = factory.createPacket(500, nullptr, 32);
+        QVERIFY(result.success);
+        QVERIFY(router.routePacket(result.packet));
+        QTRY_COMPARE_WITH_TIMEOUT(received.load(), packetTypes * packetsPerType + 1, 1000);
+        
+        router.stop();
+    }
+    
     void testPacketRouterPerformance() {
         PacketRouter::Configuration config;
         config.queueSize = 10000;
@@ -48,7 +48,7 @@ protected:
                         PacketBuffer bufferManager(memMgr);
                         auto buffer = bufferManager.createForPacket(1001, nullptr, 76); // Test packet ID with 76 byte payload
                         if (buffer) {
-                            auto packet = std::make_shared<Monitor::Packet::Packet>(std::move(buffer));
+                            auto packet = Monitor::Packet::Packet::create(std::move(buffer), memMgr->packetAllocator());
                             deliverPacket(packet);
                             m_packetsGenerated++;
                         }
@@ -0,0 +1,296 @@
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QTemporaryDir>
+
+#include "threading/cpu_topology.h"
+#include "threading/pipeline_topology.h"
+
+using namespace Monitor::Threading;
+
+class TestPipelineTopology : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testParseCpuList();
+    void testFormatCpuList();
+    void testFromSysfs();
+    void testSpreadOrder();
+    void testCpuSetsPerThread();
+    void testMemoryNode();
+    void testJsonRoundTrip();
+    void testMalformedJson();
+    void testValidate();
+    void testReport();
+    void testPinCurrentThread();
+
+private:
+    /**
+     * @brief Two nodes of two cores, each core with two SMT siblings:
+     *        node 0 has CPUs 0-1 and 4-5, node 1 has CPUs 2-3 and 6-7
+     */
+    static CpuTopology dualNode();
+
+    static bool writeFile(const QString& path, const QByteArray& contents);
+};
+
+CpuTopology TestPipelineTopology::dualNode()
+{
+    std::vector<CpuTopology::Cpu> cpus;
+    for (int id = 0; id < 8; ++id) {
+        CpuTopology::Cpu cpu;
+        cpu.id = id;
+        cpu.core = id % 4;
+        cpu.node = (id % 4) / 2;
+        cpu.package = cpu.node;
+        cpu.cache = cpu.node;
+        cpus.push_back(cpu);
+    }
+    return CpuTopology(cpus);
+}
+
+bool TestPipelineTopology::writeFile(const QString& path, const QByteArray& contents)
+{
+    if (!QDir().mkpath(QFileInfo(path).path())) {
+        return false;
+    }
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+}
+
+void TestPipelineTopology::testParseCpuList()
+{
+    bool ok = false;
+    QCOMPARE(CpuTopology::parseCpuList("0-3,8,10-11", &ok), CpuSet({0, 1, 2, 3, 8, 10, 11}));
+    QVERIFY(ok);
+
+    // Sorted and deduplicated
+    QCOMPARE(CpuTopology::parseCpuList("5,1-2,2", &ok), CpuSet({1, 2, 5}));
+    QVERIFY(ok);
+
+    for (const char* malformed : {"", "a", "1-", "-1", "3-1", "1,,2", "1-2x", "1 2"}) {
+        QVERIFY2(CpuTopology::parseCpuList(malformed, &ok).empty(), malformed);
+        QVERIFY2(!ok, malformed);
+    }
+}
+
+void TestPipelineTopology::testFormatCpuList()
+{
+    QCOMPARE(CpuTopology::formatCpuList({0, 1, 2, 3, 8, 10, 11}), QString("0-3,8,10-11"));
+    QCOMPARE(CpuTopology::formatCpuList({7, 5, 6, 5}), QString("5-7"));
+    QCOMPARE(CpuTopology::formatCpuList({}), QString());
+}
+
+void TestPipelineTopology::testFromSysfs()
+{
+    QTemporaryDir root;
+    QVERIFY(root.isValid());
+    const QString base = root.path();
+
+    // Four CPUs, two cores of two siblings each, one core per node
+    QVERIFY(writeFile(base + "/cpu/online", "0-3\n"));
+    for (int id = 0; id < 4; ++id) {
+        const QString cpu = QString("%1/cpu/cpu%2").arg(base).arg(id);
+        QVERIFY(writeFile(cpu + "/topology/physical_package_id", "0\n"));
+        QVERIFY(writeFile(cpu + "/topology/core_id", QByteArray::number(id / 2) + "\n"));
+        QVERIFY(writeFile(cpu + "/cache/index3/shared_cpu_list", id < 2 ? "0-1\n" : "2-3\n"));
+    }
+    QVERIFY(writeFile(base + "/node/online", "0-1\n"));
+    QVERIFY(writeFile(base + "/node/node0/cpulist", "0-1\n"));
+    QVERIFY(writeFile(base + "/node/node1/cpulist", "2-3\n"));
+
+    const CpuTopology topology = CpuTopology::fromSysfs(base.toStdString());
+    QCOMPARE(topology.cpuCount(), 4);
+    QCOMPARE(topology.nodeCount(), 2);
+    QCOMPARE(topology.nodeOfCpu(1), 0);
+    QCOMPARE(topology.nodeOfCpu(2), 1);
+    QCOMPARE(topology.nodeOfCpu(4), -1);
+    QCOMPARE(topology.cpusOfNode(1), CpuSet({2, 3}));
+    QCOMPARE(topology.cpus()[3].cache, 2);
+    QCOMPARE(topology.describe(), QString("2 nodes, 1 packages, 2 last-level caches, 2 cores, 4 CPUs"));
+
+    // No CPU list, no topology
+    QVERIFY(CpuTopology::fromSysfs((base + "/missing").toStdString()).isEmpty());
+}
+
+void TestPipelineTopology::testSpreadOrder()
+{
+    // One CPU per core first, node by node, then the SMT siblings
+    QCOMPARE(dualNode().spreadOrder(), CpuSet({0, 1, 2, 3, 4, 5, 6, 7}));
+
+    const CpuTopology uniform = CpuTopology::uniform(3);
+    QCOMPARE(uniform.spreadOrder(), CpuSet({0, 1, 2}));
+    QCOMPARE(uniform.nodeCount(), 1);
+}
+
+void TestPipelineTopology::testCpuSetsPerThread()
+{
+    const CpuTopology machine = dualNode();
+    PipelineTopology topology;
+    QVERIFY(topology.isEmpty());
+
+    PipelineTopology::Placement router;
+    router.cpus = {6, 2};
+    topology.setPlacement(PipelineTopology::Stage::Router, router);
+
+    PipelineTopology::Placement processor;
+    processor.node = 0;
+    topology.setPlacement(PipelineTopology::Stage::Processor, processor);
+    QVERIFY(!topology.isEmpty());
+
+    // Listed CPUs are handed out in order, wrapping around
+    const std::vector<CpuSet> routerSets = topology.cpuSetsFor(PipelineTopology::Stage::Router, 3, machine);
+    QCOMPARE(routerSets.size(), size_t(3));
+    QCOMPARE(routerSets[0], CpuSet({6}));
+    QCOMPARE(routerSets[1], CpuSet({2}));
+    QCOMPARE(routerSets[2], CpuSet({6}));
+
+    // A node alone gives every thread all of its CPUs
+    QCOMPARE(topology.cpuSetFor(PipelineTopology::Stage::Processor, 5, machine), CpuSet({0, 1, 4, 5}));
+
+    // Unplaced stages float
+    QVERIFY(topology.cpuSetFor(PipelineTopology::Stage::Receive, 0, machine).empty());
+    QVERIFY(topology.cpuSetsFor(PipelineTopology::Stage::Receive, 4, machine).empty());
+}
+
+void TestPipelineTopology::testMemoryNode()
+{
+    const CpuTopology machine = dualNode();
+    PipelineTopology topology;
+
+    PipelineTopology::Placement receive;
+    receive.cpus = {2, 7};
+    topology.setPlacement(PipelineTopology::Stage::Receive, receive);
+    QCOMPARE(topology.memoryNodeFor(PipelineTopology::Stage::Receive, machine), 1);
+
+    // CPUs on both nodes leave the memory where the kernel puts it
+    PipelineTopology::Placement router;
+    router.cpus = {0, 2};
+    topology.setPlacement(PipelineTopology::Stage::Router, router);
+    QCOMPARE(topology.memoryNodeFor(PipelineTopology::Stage::Router, machine), -1);
+
+    router.memoryNode = 0;
+    topology.setPlacement(PipelineTopology::Stage::Router, router);
+    QCOMPARE(topology.memoryNodeFor(PipelineTopology::Stage::Router, machine), 0);
+
+    PipelineTopology::Placement processor;
+    processor.node = 1;
+    topology.setPlacement(PipelineTopology::Stage::Processor, processor);
+    QCOMPARE(topology.memoryNodeFor(PipelineTopology::Stage::Processor, machine), 1);
+
+    QCOMPARE(topology.memoryNodeFor(PipelineTopology::Stage::Gui, machine), -1);
+}
+
+void TestPipelineTopology::testJsonRoundTrip()
+{
+    QJsonObject json;
+    json["receive"] = QJsonObject{{"cpus", "2-3"}};
+    json["router"] = QJsonObject{{"cpus", QJsonArray{7, 6, 5}}};
+    json["processor"] = QJsonObject{{"node", 1}};
+    json["recorder"] = QJsonObject{{"cpus", 1}, {"memoryNode", 0}};
+
+    PipelineTopology topology;
+    QStringList errors;
+    QVERIFY2(topology.fromJson(json, &errors), qPrintable(errors.join("; ")));
+
+    QCOMPARE(topology.placement(PipelineTopology::Stage::Receive).cpus, CpuSet({2, 3}));
+    QCOMPARE(topology.placement(PipelineTopology::Stage::Router).cpus, CpuSet({7, 6, 5}));
+    QCOMPARE(topology.placement(PipelineTopology::Stage::Processor).node, 1);
+    QCOMPARE(topology.placement(PipelineTopology::Stage::Recorder).cpus, CpuSet({1}));
+    QCOMPARE(topology.placement(PipelineTopology::Stage::Recorder).memoryNode, 0);
+    QVERIFY(topology.placement(PipelineTopology::Stage::Gui).isEmpty());
+
+    const QJsonObject saved = topology.toJson();
+    QCOMPARE(saved["receive"].toObject()["cpus"].toString(), QString("2-3"));
+    QVERIFY(!saved.contains("gui"));
+
+    PipelineTopology reloaded;
+    QVERIFY(reloaded.fromJson(saved));
+    QCOMPARE(reloaded.placement(PipelineTopology::Stage::Processor).node, 1);
+    QCOMPARE(reloaded.placement(PipelineTopology::Stage::Recorder).memoryNode, 0);
+}
+
+void TestPipelineTopology::testMalformedJson()
+{
+    QJsonObject json;
+    json["receive"] = QJsonObject{{"cpus", "2-"}};
+    json["router"] = QJsonObject{{"cpus", "4-5"}};
+    json["processor"] = QJsonObject{{"node", -2}};
+    json["render"] = QJsonObject{{"node", 0}};
+
+    PipelineTopology topology;
+    QStringList errors;
+    QVERIFY(!topology.fromJson(json, &errors));
+    QCOMPARE(errors.size(), 3);
+
+    // The stages that parsed are kept
+    QVERIFY(topology.placement(PipelineTopology::Stage::Receive).isEmpty());
+    QCOMPARE(topology.placement(PipelineTopology::Stage::Router).cpus, CpuSet({4, 5}));
+    QVERIFY(topology.placement(PipelineTopology::Stage::Processor).isEmpty());
+}
+
+void TestPipelineTopology::testValidate()
+{
+    const CpuTopology machine = dualNode();
+    PipelineTopology topology;
+
+    PipelineTopology::Placement receive;
+    receive.cpus = {1, 9};
+    topology.setPlacement(PipelineTopology::Stage::Receive, receive);
+
+    PipelineTopology::Placement router;
+    router.cpus = {1, 2};
+    topology.setPlacement(PipelineTopology::Stage::Router, router);
+
+    PipelineTopology::Placement processor;
+    processor.node = 3;
+    topology.setPlacement(PipelineTopology::Stage::Processor, processor);
+
+    const QStringList problems = topology.validate(machine);
+    QCOMPARE(problems.size(), 3);
+    QVERIFY(problems[0].contains("receive") && problems[0].contains("9"));
+    QVERIFY(problems[1].contains("router") && problems[1].contains("another stage"));
+    QVERIFY(problems[2].contains("processor") && problems[2].contains("node 3"));
+
+    PipelineTopology valid;
+    valid.setPlacement(PipelineTopology::Stage::Router, PipelineTopology::Placement{{4, 5}, -1, -1});
+    QVERIFY(valid.validate(machine).isEmpty());
+}
+
+void TestPipelineTopology::testReport()
+{
+    const CpuTopology machine = dualNode();
+    PipelineTopology topology;
+    topology.setPlacement(PipelineTopology::Stage::Router, PipelineTopology::Placement{{2, 3}, -1, -1});
+    topology.setPlacement(PipelineTopology::Stage::Processor, PipelineTopology::Placement{{}, 0, -1});
+
+    const QStringList report = topology.report(machine, {{PipelineTopology::Stage::Router, 3}});
+    QCOMPARE(report.size(), int(PipelineTopology::STAGE_COUNT) + 1);
+    QVERIFY(report[0].contains(machine.describe()));
+    QVERIFY(report[1].startsWith("receive") && report[1].contains("floating"));
+    QVERIFY(report[2].contains("#0 -> 2") && report[2].contains("#2 -> 2"));
+    QVERIFY(report[2].contains("memory on node 1"));
+    QVERIFY(report[3].contains("node 0 (CPUs 0-1,4-5)"));
+}
+
+void TestPipelineTopology::testPinCurrentThread()
+{
+    QVERIFY(!pinCurrentThread({}));
+
+#ifdef Q_OS_LINUX
+    // Pinning this thread to every CPU it may use cannot fail
+    const CpuTopology& machine = CpuTopology::system();
+    QVERIFY(!machine.isEmpty());
+    CpuSet all;
+    for (const CpuTopology::Cpu& cpu : machine.cpus()) {
+        all.push_back(cpu.id);
+    }
+    QVERIFY(pinCurrentThread(all));
+#endif
+}
+
+QTEST_MAIN(TestPipelineTopology)
+#include "test_pipeline_topology.moc"
@@ -0,0 +1,261 @@
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "threading/task_group.h"
+
+using namespace Monitor::Threading;
+
+class TestTaskGroup : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testWaitRunsAllTasks();
+    void testNestedWaitHelps();
+    void testCancel();
+    void testExceptionPropagates();
+    void testRunsInlineWithoutWorkers();
+    void testParallelFor();
+    void testParallelForNested();
+    void testParallelReduceKeepsOrder();
+
+private:
+    /**
+     * @brief Naive Fibonacci with one nested group per call
+     */
+    static uint64_t fibonacci(ThreadPool& pool, int n);
+};
+
+void TestTaskGroup::testWaitRunsAllTasks()
+{
+    ThreadPool pool;
+    QVERIFY(pool.initialize(4));
+    pool.start();
+
+    std::atomic<int> runs{0};
+    TaskGroup group(pool);
+    for (int i = 0; i < 1000; ++i) {
+        group.run([&runs]() { runs.fetch_add(1, std::memory_order_relaxed); });
+    }
+    QVERIFY(group.wait());
+    QCOMPARE(runs.load(), 1000);
+
+    // A finished group can be reused
+    group.run([&runs]() { ++runs; });
+    QVERIFY(group.wait());
+    QCOMPARE(runs.load(), 1001);
+
+    pool.shutdown();
+}
+
+uint64_t TestTaskGroup::fibonacci(ThreadPool& pool, int n)
+{
+    if (n < 2) {
+        return static_cast<uint64_t>(n);
+    }
+
+    uint64_t left = 0;
+    TaskGroup group(pool);
+    group.run([&pool, &left, n]() { left = fibonacci(pool, n - 1); });
+    const uint64_t right = fibonacci(pool, n - 2);
+    group.wait();
+    return left + right;
+}
+
+void TestTaskGroup::testNestedWaitHelps()
+{
+    // With one worker, a task waiting on its children can only finish if
+    // the wait runs them
+    ThreadPool pool;
+    QVERIFY(pool.initialize(1));
+    pool.start();
+
+    std::atomic<uint64_t> result{0};
+    TaskGroup group(pool);
+    group.run([&pool, &result]() { result = fibonacci(pool, 18); });
+    QVERIFY(group.wait());
+    QCOMPARE(result.load(), uint64_t(2584));
+
+    pool.shutdown();
+}
+
+void TestTaskGroup::testCancel()
+{
+    ThreadPool pool;
+    QVERIFY(pool.initialize(1));
+    pool.start();
+
+    std::atomic<bool> release{false};
+    std::atomic<int> runs{0};
+    TaskGroup group(pool);
+
+    // Keep the only worker busy while the rest are queued behind it
+    group.run([&release]() {
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    for (int i = 0; i < 100; ++i) {
+        group.run([&runs]() { ++runs; });
+    }
+
+    group.cancel();
+    QVERIFY(group.isCancelling());
+    release = true;
+    QVERIFY(!group.wait());
+    QCOMPARE(runs.load(), 0);
+
+    QVERIFY(!group.isCancelling());
+    group.run([&runs]() { ++runs; });
+    QVERIFY(group.wait());
+    QCOMPARE(runs.load(), 1);
+
+    pool.shutdown();
+}
+
+void TestTaskGroup::testExceptionPropagates()
+{
+    ThreadPool pool;
+    QVERIFY(pool.initialize(2));
+    pool.start();
+
+    TaskGroup group(pool);
+    for (int i = 0; i < 10; ++i) {
+        group.run([i]() {
+            if (i == 3) {
+                throw std::runtime_error("task failed");
+            }
+        });
+    }
+
+    bool thrown = false;
+    try {
+        group.wait();
+    } catch (const std::runtime_error& e) {
+        thrown = QString(e.what()) == "task failed";
+    }
+    QVERIFY(thrown);
+
+    // The error is reported once
+    QVERIFY(group.wait());
+
+    pool.shutdown();
+}
+
+void TestTaskGroup::testRunsInlineWithoutWorkers()
+{
+    ThreadPool pool;
+    QVERIFY(pool.initialize(2));
+
+    // Not started, so the pool refuses tasks and run() executes them itself
+    std::thread::id ranOn;
+    TaskGroup group(pool);
+    group.run([&ranOn]() { ranOn = std::this_thread::get_id(); });
+    QVERIFY(ranOn == std::this_thread::get_id());
+    QVERIFY(group.wait());
+
+    int sum = 0;
+    QVERIFY(parallelFor(pool, 0, 100, [&sum](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            sum += i;
+        }
+    }));
+    QCOMPARE(sum, 4950);
+}
+
+void TestTaskGroup::testParallelFor()
+{
+    ThreadPool pool;
+    QVERIFY(pool.initialize(4));
+    pool.start();
+
+    const size_t count = 100000;
+    for (size_t grain : {size_t(0), size_t(1), size_t(7), count * 2}) {
+        std::vector<int> visits(count, 0);
+        QVERIFY(parallelFor(pool, size_t(0), count, [&visits](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                ++visits[i];
+            }
+        }, grain));
+
+        for (size_t i = 0; i < count; ++i) {
+            QCOMPARE(visits[i], 1);
+        }
+    }
+
+    // An empty range returns straight away
+    QVERIFY(parallelFor(pool, 5, 5, [](int, int) { QFAIL("empty range visited"); }));
+
+    pool.shutdown();
+}
+
+void TestTaskGroup::testParallelForNested()
+{
+    ThreadPool pool;
+    QVERIFY(pool.initialize(2));
+    pool.start();
+
+    const int rows = 64;
+    const int columns = 1000;
+    std::vector<std::atomic<int>> rowSums(rows);
+
+    QVERIFY(parallelFor(pool, 0, rows, [&](int firstRow, int lastRow) {
+        for (int row = firstRow; row < lastRow; ++row) {
+            parallelFor(pool, 0, columns, [&rowSums, row](int first, int last) {
+                rowSums[row].fetch_add(last - first, std::memory_order_relaxed);
+            }, 16);
+        }
+    }, 1));
+
+    for (int row = 0; row < rows; ++row) {
+        QCOMPARE(rowSums[row].load(), columns);
+    }
+
+    pool.shutdown();
+}
+
+void TestTaskGroup::testParallelReduceKeepsOrder()
+{
+    ThreadPool pool;
+    QVERIFY(pool.initialize(4));
+    pool.start();
+
+    // Concatenation is associative but not commutative
+    const int count = 20000;
+    std::vector<int> sequence = parallelReduce(pool, 0, count, std::vector<int>(),
+        [](int first, int last, std::vector<int> accumulated) {
+            for (int i = first; i < last; ++i) {
+                accumulated.push_back(i);
+            }
+            return accumulated;
+        },
+        [](std::vector<int> left, std::vector<int> right) {
+            left.insert(left.end(), right.begin(), right.end());
+            return left;
+        }, 3);
+
+    QCOMPARE(sequence.size(), size_t(count));
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(sequence[static_cast<size_t>(i)], i);
+    }
+
+    const uint64_t sum = parallelReduce(pool, uint64_t(1), uint64_t(1000001), uint64_t(0),
+        [](uint64_t first, uint64_t last, uint64_t accumulated) {
+            for (uint64_t i = first; i < last; ++i) {
+                accumulated += i;
+            }
+            return accumulated;
+        },
+        [](uint64_t left, uint64_t right) { return left + right; });
+    QCOMPARE(sum, uint64_t(500000500000));
+
+    pool.shutdown();
+}
+
+QTEST_MAIN(TestTaskGroup)
+#include "test_task_group.moc"
@@ -0,0 +1,197 @@
+#include <QtTest/QtTest>
+#include <QtCore/QObject>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "threading/thread_pool.h"
+
+using namespace Monitor::Threading;
+
+class TestWorkStealing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testInlineFunction();
+    void testTaskPlacement();
+    void testInboxPriorityOrder();
+    void testStealTask();
+    void testForkedTasksStayLocal();
+    void testRecursiveFork();
+
+private:
+    /**
+     * @brief Count down @p depth levels, forking two tasks per level
+     */
+    static void forkTree(ThreadPool* pool, int depth, std::atomic<int>& leaves);
+};
+
+void TestWorkStealing::testInlineFunction()
+{
+    int calls = 0;
+    TaskCallable small([&calls]() { ++calls; });
+    QVERIFY(small);
+    QVERIFY(small.isInline());
+    small();
+    QCOMPARE(calls, 1);
+
+    // A std::function and a move-only capture both fit in place
+    TaskCallable wrapped(TaskFunction([&calls]() { ++calls; }));
+    QVERIFY(wrapped.isInline());
+    auto owned = std::make_unique<int>(5);
+    TaskCallable moveOnly([&calls, owned = std::move(owned)]() { calls += *owned; });
+    QVERIFY(moveOnly.isInline());
+
+    TaskCallable moved = std::move(moveOnly);
+    QVERIFY(!moveOnly);
+    moved();
+    wrapped();
+    QCOMPARE(calls, 7);
+
+    // Larger captures go to the heap
+    std::array<char, 64> payload{};
+    payload[63] = 1;
+    TaskCallable large([&calls, payload]() { calls += payload[63]; });
+    QVERIFY(large);
+    QVERIFY(!large.isInline());
+    large();
+    QCOMPARE(calls, 8);
+
+    QVERIFY(!TaskCallable(TaskFunction()));
+}
+
+void TestWorkStealing::testTaskPlacement()
+{
+    Monitor::Memory::SizeClassAllocator allocator;
+    std::atomic<int> runs{0};
+
+    Task* pooled = Task::create(&allocator, [&runs]() { ++runs; }, 3, 7);
+    QVERIFY(allocator.owns(Task::BLOCK_CLASS, pooled));
+    QCOMPARE(pooled->priority, 3);
+    QCOMPARE(pooled->id, size_t(7));
+    pooled->function();
+    Task::release(pooled, &allocator);
+
+    Task* heap = Task::create(nullptr, [&runs]() { ++runs; }, 0, 8);
+    QVERIFY(!allocator.owns(Task::BLOCK_CLASS, heap));
+    heap->function();
+    Task::release(heap, nullptr);
+
+    QCOMPARE(runs.load(), 2);
+}
+
+void TestWorkStealing::testInboxPriorityOrder()
+{
+    ThreadWorker worker(0, nullptr);
+    std::vector<int> order;
+    std::mutex orderMutex;
+
+    auto record = [&](int value) {
+        return std::make_shared<Task>([&, value]() {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(value);
+        }, value, static_cast<size_t>(value + 100));
+    };
+
+    // Queued before the worker runs, so it drains them as one batch
+    QVERIFY(worker.addTask(record(0)));
+    QVERIFY(worker.addTask(record(-10)));
+    QVERIFY(worker.addTask(record(10)));
+    QVERIFY(worker.addTask(record(0)));
+    QCOMPARE(worker.getQueueSize(), size_t(4));
+
+    worker.start();
+    QTRY_COMPARE_WITH_TIMEOUT(worker.getTasksProcessed(), size_t(4), 5000);
+    worker.stop();
+    worker.wait();
+
+    QCOMPARE(order, (std::vector<int>{10, 0, 0, -10}));
+    QCOMPARE(worker.getQueueSize(), size_t(0));
+}
+
+void TestWorkStealing::testStealTask()
+{
+    ThreadWorker worker(0, nullptr);
+    std::atomic<int> runs{0};
+
+    QVERIFY(!worker.addTask(nullptr));
+    QVERIFY(!worker.addTask(std::make_shared<Task>()));
+    QVERIFY(worker.addTask(std::make_shared<Task>([&runs]() { ++runs; }, 0, 1)));
+
+    TaskPtr stolen = worker.stealTask();
+    QVERIFY(stolen);
+    QVERIFY(worker.stealTask() == nullptr);
+    QCOMPARE(worker.getTasksStolen(), size_t(1));
+    QCOMPARE(worker.getQueueSize(), size_t(0));
+
+    stolen->function();
+    QCOMPARE(runs.load(), 1);
+}
+
+void TestWorkStealing::testForkedTasksStayLocal()
+{
+    ThreadPool pool;
+    QVERIFY(pool.initialize(2));
+    pool.start();
+
+    std::atomic<ThreadWorker*> parent{nullptr};
+    std::atomic<ThreadWorker*> child{nullptr};
+    std::atomic<bool> queuedLocally{false};
+
+    // With stealing off the idle sibling cannot take the fork, so it runs
+    // on the worker whose deque it was pushed onto
+    pool.setWorkStealingEnabled(false);
+    QVERIFY(pool.submitTask([&]() {
+        ThreadWorker* worker = ThreadWorker::current();
+        parent = worker;
+        pool.submitTask([&]() { child = ThreadWorker::current(); }, 0);
+        queuedLocally = worker->getQueueSize() == 1;
+    }, 0));
+
+    QTRY_VERIFY_WITH_TIMEOUT(child.load() != nullptr, 5000);
+    QVERIFY(parent.load() != nullptr);
+    QVERIFY(parent.load()->getThreadPool() == &pool);
+    QVERIFY(queuedLocally.load());
+    QCOMPARE(child.load(), parent.load());
+    QVERIFY(ThreadWorker::current() == nullptr);
+
+    pool.shutdown();
+}
+
+void TestWorkStealing::forkTree(ThreadPool* pool, int depth, std::atomic<int>& leaves)
+{
+    if (depth == 0) {
+        leaves.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    for (int i = 0; i < 2; ++i) {
+        while (!pool->submitDetached([pool, depth, &leaves]() { forkTree(pool, depth - 1, leaves); })) {
+            QThread::yieldCurrentThread();
+        }
+    }
+}
+
+void TestWorkStealing::testRecursiveFork()
+{
+    const int depth = 14;
+
+    ThreadPool pool;
+    QVERIFY(pool.initialize(4));
+    pool.start();
+
+    std::atomic<int> leaves{0};
+    QVERIFY(pool.submitTask([&pool, &leaves]() { forkTree(&pool, depth, leaves); }, 0));
+
+    // Every forked task runs once, whichever worker ends up with it
+    QTRY_COMPARE_WITH_TIMEOUT(leaves.load(), 1 << depth, 10000);
+    QTRY_COMPARE_WITH_TIMEOUT(pool.getTotalTasksProcessed(), size_t((2 << depth) - 1), 5000);
+    QCOMPARE(pool.getTotalQueueSize(), size_t(0));
+
+    pool.shutdown();
+}
+
+QTEST_MAIN(TestWorkStealing)
+#include "test_work_stealing.moc"
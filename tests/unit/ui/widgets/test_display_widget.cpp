@@ -5,6 +5,9 @@
 #include <QVariant>
 #include <QColor>
 #include <QFont>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
 #include <memory>
 
 // Include the widget under test
@@ -94,8 +97,8 @@ private slots:
     // Static helper method tests
     void testFormatValue();
     void testConvertValue();
-    void testApplyMathOperation();
-    void testApplyFunction();
+    void testCompileKernelMath();
+    void testCompileKernelFunction();
 
     // Performance tests
     void testTransformationPerformance();
@@ -106,11 +109,37 @@ private slots:
     void testLargeNumbers();
 
 private:
+    // Numeric transformations go through DisplayWidget::compileKernel()
+    static double applyMath(double input, DisplayWidget::MathOperation op, double operand);
+    static double applyFunction(std::initializer_list<double> values, DisplayWidget::FunctionType function);
+
     QApplication* m_app;
     MockDisplayWidget* m_widget;
     QString m_testWidgetId;
 };
 
+double TestDisplayWidget::applyMath(double input, DisplayWidget::MathOperation op, double operand)
+{
+    DisplayWidget::DisplayConfig config;
+    config.mathOp = op;
+    config.mathOperand = operand;
+    return DisplayWidget::compileKernel(config).apply(input);
+}
+
+double TestDisplayWidget::applyFunction(std::initializer_list<double> values, DisplayWidget::FunctionType function)
+{
+    DisplayWidget::DisplayConfig config;
+    config.function = function;
+    config.functionWindow = static_cast<int>(values.size());
+    Monitor::Packet::TransformKernel kernel = DisplayWidget::compileKernel(config);
+    
+    double result = std::numeric_limits<double>::quiet_NaN();
+    for (double value : values) {
+        result = kernel.apply(value);
+    }
+    return result;
+}
+
 void TestDisplayWidget::initTestCase()
 {
     if (!QApplication::instance()) {
@@ -294,82 +323,61 @@ void TestDisplayWidget::testTransformations()
 
 void TestDisplayWidget::testMathematicalOperations()
 {
-    QVariant input(10.0);
+    const double input = 10.0;
     
     // Test multiplication
-    QVariant result = DisplayWidget::applyMathOperation(input, DisplayWidget::MathOperation::Multiply, 3.0);
-    QCOMPARE(result.toDouble(), 30.0);
+    QCOMPARE(applyMath(input, DisplayWidget::MathOperation::Multiply, 3.0), 30.0);
     
     // Test division
-    result = DisplayWidget::applyMathOperation(input, DisplayWidget::MathOperation::Divide, 2.0);
-    QCOMPARE(result.toDouble(), 5.0);
+    QCOMPARE(applyMath(input, DisplayWidget::MathOperation::Divide, 2.0), 5.0);
     
     // Test division by zero
-    result = DisplayWidget::applyMathOperation(input, DisplayWidget::MathOperation::Divide, 0.0);
-    QVERIFY(!result.isValid()); // Should return invalid QVariant
+    QVERIFY(std::isnan(applyMath(input, DisplayWidget::MathOperation::Divide, 0.0))); // Shown as no value
     
     // Test addition
-    result = DisplayWidget::applyMathOperation(input, DisplayWidget::MathOperation::Add, 5.0);
-    QCOMPARE(result.toDouble(), 15.0);
+    QCOMPARE(applyMath(input, DisplayWidget::MathOperation::Add, 5.0), 15.0);
     
     // Test subtraction
-    result = DisplayWidget::applyMathOperation(input, DisplayWidget::MathOperation::Subtract, 3.0);
-    QCOMPARE(result.toDouble(), 7.0);
+    QCOMPARE(applyMath(input, DisplayWidget::MathOperation::Subtract, 3.0), 7.0);
     
     // Test modulo
-    result = DisplayWidget::applyMathOperation(input, DisplayWidget::MathOperation::Modulo, 3.0);
-    QCOMPARE(result.toDouble(), 1.0);
+    QCOMPARE(applyMath(input, DisplayWidget::MathOperation::Modulo, 3.0), 1.0);
     
     // Test power
-    result = DisplayWidget::applyMathOperation(QVariant(2.0), DisplayWidget::MathOperation::Power, 3.0);
-    QCOMPARE(result.toDouble(), 8.0);
+    QCOMPARE(applyMath(2.0, DisplayWidget::MathOperation::Power, 3.0), 8.0);
     
     // Test absolute value
-    result = DisplayWidget::applyMathOperation(QVariant(-5.0), DisplayWidget::MathOperation::Absolute, 0.0);
-    QCOMPARE(result.toDouble(), 5.0);
+    QCOMPARE(applyMath(-5.0, DisplayWidget::MathOperation::Absolute, 0.0), 5.0);
     
     // Test negation
-    result = DisplayWidget::applyMathOperation(QVariant(5.0), DisplayWidget::MathOperation::Negate, 0.0);
-    QCOMPARE(result.toDouble(), -5.0);
+    QCOMPARE(applyMath(5.0, DisplayWidget::MathOperation::Negate, 0.0), -5.0);
 }
 
 void TestDisplayWidget::testFunctionalTransformations()
 {
-    std::vector<QVariant> history;
-    history.push_back(QVariant(1.0));
-    history.push_back(QVariant(2.0));
-    history.push_back(QVariant(3.0));
-    history.push_back(QVariant(4.0));
-    history.push_back(QVariant(5.0));
+    const std::initializer_list<double> history = {1.0, 2.0, 3.0, 4.0, 5.0};
     
     // Test moving average
-    QVariant result = DisplayWidget::applyFunction(history, DisplayWidget::FunctionType::MovingAverage);
-    QCOMPARE(result.toDouble(), 3.0); // (1+2+3+4+5)/5 = 3
+    QCOMPARE(applyFunction(history, DisplayWidget::FunctionType::MovingAverage), 3.0); // (1+2+3+4+5)/5 = 3
     
     // Test cumulative sum
-    result = DisplayWidget::applyFunction(history, DisplayWidget::FunctionType::CumulativeSum);
-    QCOMPARE(result.toDouble(), 15.0); // 1+2+3+4+5 = 15
+    QCOMPARE(applyFunction(history, DisplayWidget::FunctionType::CumulativeSum), 15.0); // 1+2+3+4+5 = 15
     
     // Test minimum
-    result = DisplayWidget::applyFunction(history, DisplayWidget::FunctionType::Minimum);
-    QCOMPARE(result.toDouble(), 1.0);
+    QCOMPARE(applyFunction(history, DisplayWidget::FunctionType::Minimum), 1.0);
     
     // Test maximum
-    result = DisplayWidget::applyFunction(history, DisplayWidget::FunctionType::Maximum);
-    QCOMPARE(result.toDouble(), 5.0);
+    QCOMPARE(applyFunction(history, DisplayWidget::FunctionType::Maximum), 5.0);
     
     // Test range
-    result = DisplayWidget::applyFunction(history, DisplayWidget::FunctionType::Range);
-    QCOMPARE(result.toDouble(), 4.0); // 5 - 1 = 4
+    QCOMPARE(applyFunction(history, DisplayWidget::FunctionType::Range), 4.0); // 5 - 1 = 4
     
-    // Test difference (requires at least 2 values)
-    result = DisplayWidget::applyFunction(history, DisplayWidget::FunctionType::Difference);
-    QCOMPARE(result.toDouble(), 1.0); // 5 - 4 = 1
+    // Test difference
+    QCOMPARE(applyFunction(history, DisplayWidget::FunctionType::Difference), 1.0); // 5 - 4 = 1
     
     // Test standard deviation
-    result = DisplayWidget::applyFunction(history, DisplayWidget::FunctionType::StandardDeviation);
-    QVERIFY(result.toDouble() > 0); // Should be approximately sqrt(2.5) ≈ 1.58
-    QVERIFY(qAbs(result.toDouble() - 1.58) < 0.1);
+    const double stddev = applyFunction(history, DisplayWidget::FunctionType::StandardDeviation);
+    QVERIFY(qAbs(stddev - 1.58) < 0.1); // sqrt(2.5)
 }
 
 void TestDisplayWidget::testSettingsPersistence()
@@ -494,50 +502,63 @@ void TestDisplayWidget::testConvertValue()
     
     result = DisplayWidget::convertValue(QVariant(0), DisplayWidget::ConversionType::ToBoolean);
     QVERIFY(!result.toBool());
+    
+    // Test hexadecimal of a computed value, which needs an integer to format
+    DisplayWidget::DisplayConfig config;
+    config.conversion = DisplayWidget::ConversionType::ToHexadecimal;
+    result = DisplayWidget::convertValue(QVariant(255.0), config.conversion);
+    QCOMPARE(result.typeId(), QMetaType::LongLong);
+    QCOMPARE(DisplayWidget::formatValue(result, config), QString("0XFF"));
+    
+    // The conversion applies to the kernel's output, not its input
+    config.conversion = DisplayWidget::ConversionType::ToInteger;
+    config.mathOp = DisplayWidget::MathOperation::Multiply;
+    config.mathOperand = 0.5;
+    const double computed = DisplayWidget::compileKernel(config).apply(7.0);
+    QCOMPARE(computed, 3.5);
+    result = DisplayWidget::convertValue(QVariant(computed), config.conversion);
+    QCOMPARE(result.typeId(), QMetaType::LongLong);
+    QCOMPARE(result.toLongLong(), 3LL);
 }
 
-void TestDisplayWidget::testApplyMathOperation()
+void TestDisplayWidget::testCompileKernelMath()
 {
     // Test no operation
-    QVariant input(10.0);
-    QVariant result = DisplayWidget::applyMathOperation(input, DisplayWidget::MathOperation::None, 0.0);
-    QCOMPARE(result, input);
+    DisplayWidget::DisplayConfig config;
+    QVERIFY(DisplayWidget::compileKernel(config).isEmpty());
+    QCOMPARE(applyMath(10.0, DisplayWidget::MathOperation::None, 0.0), 10.0);
     
-    // Test all operations (covered in testMathematicalOperations)
-    // Additional edge cases here
+    // Operations fold into one step with the function after them
+    config.mathOp = DisplayWidget::MathOperation::Subtract;
+    config.mathOperand = 2.0;
+    config.function = DisplayWidget::FunctionType::MovingAverage;
+    QCOMPARE(DisplayWidget::compileKernel(config).stepCount(), size_t(2));
     
-    // Test with non-numeric input
-    result = DisplayWidget::applyMathOperation(QVariant("abc"), DisplayWidget::MathOperation::Multiply, 2.0);
-    QCOMPARE(result.toDouble(), 0.0); // String converts to 0.0
+    // Test with non-finite input
+    QVERIFY(std::isnan(applyMath(std::numeric_limits<double>::quiet_NaN(), DisplayWidget::MathOperation::Multiply, 2.0)));
 }
 
-void TestDisplayWidget::testApplyFunction()
+void TestDisplayWidget::testCompileKernelFunction()
 {
-    // Test empty history
-    std::vector<QVariant> emptyHistory;
-    QVariant result = DisplayWidget::applyFunction(emptyHistory, DisplayWidget::FunctionType::MovingAverage);
-    QVERIFY(!result.isValid());
-    
     // Test single value
-    std::vector<QVariant> singleValue;
-    singleValue.push_back(QVariant(5.0));
+    QCOMPARE(applyFunction({5.0}, DisplayWidget::FunctionType::MovingAverage), 5.0);
+    QCOMPARE(applyFunction({5.0}, DisplayWidget::FunctionType::Minimum), 5.0);
+    QCOMPARE(applyFunction({5.0}, DisplayWidget::FunctionType::Maximum), 5.0);
     
-    result = DisplayWidget::applyFunction(singleValue, DisplayWidget::FunctionType::MovingAverage);
-    QCOMPARE(result.toDouble(), 5.0);
-    
-    result = DisplayWidget::applyFunction(singleValue, DisplayWidget::FunctionType::Minimum);
-    QCOMPARE(result.toDouble(), 5.0);
-    
-    result = DisplayWidget::applyFunction(singleValue, DisplayWidget::FunctionType::Maximum);
-    QCOMPARE(result.toDouble(), 5.0);
-    
-    // Test difference with insufficient data
-    result = DisplayWidget::applyFunction(singleValue, DisplayWidget::FunctionType::Difference);
-    QVERIFY(!result.isValid()); // Needs at least 2 values
+    // Test difference with no previous value
+    QCOMPARE(applyFunction({5.0}, DisplayWidget::FunctionType::Difference), 0.0);
     
     // Test standard deviation with insufficient data
-    result = DisplayWidget::applyFunction(singleValue, DisplayWidget::FunctionType::StandardDeviation);
-    QVERIFY(!result.isValid()); // Needs at least 2 values
+    QVERIFY(std::isnan(applyFunction({5.0}, DisplayWidget::FunctionType::StandardDeviation))); // Needs at least 2 values
+    
+    // Each kernel keeps its own window
+    DisplayWidget::DisplayConfig config;
+    config.function = DisplayWidget::FunctionType::CumulativeSum;
+    Monitor::Packet::TransformKernel first = DisplayWidget::compileKernel(config);
+    Monitor::Packet::TransformKernel second = DisplayWidget::compileKernel(config);
+    first.apply(1.0);
+    QCOMPARE(first.apply(2.0), 3.0);
+    QCOMPARE(second.apply(2.0), 2.0);
 }
 
 void TestDisplayWidget::testTransformationPerformance()
@@ -553,7 +574,7 @@ void TestDisplayWidget::testTransformationPerformance()
         
         DisplayWidget::convertValue(input, DisplayWidget::ConversionType::ToInteger);
         DisplayWidget::convertValue(input, DisplayWidget::ConversionType::ToString);
-        DisplayWidget::applyMathOperation(input, DisplayWidget::MathOperation::Multiply, 2.0);
+        applyMath(input.toDouble(), DisplayWidget::MathOperation::Multiply, 2.0);
         
         DisplayWidget::DisplayConfig config;
         config.decimalPlaces = 3;
@@ -577,16 +598,10 @@ void TestDisplayWidget::testInvalidTransformations()
     QCOMPARE(result, input); // Should return input unchanged
     
     // Test invalid math operations
-    result = DisplayWidget::applyMathOperation(input, static_cast<DisplayWidget::MathOperation>(999), 1.0);
-    QCOMPARE(result, input); // Should return input unchanged
+    QCOMPARE(applyMath(42.0, static_cast<DisplayWidget::MathOperation>(999), 1.0), 42.0); // Should return input unchanged
     
     // Test invalid function types
-    std::vector<QVariant> history;
-    history.push_back(QVariant(1.0));
-    history.push_back(QVariant(2.0));
-    
-    result = DisplayWidget::applyFunction(history, static_cast<DisplayWidget::FunctionType>(999));
-    QCOMPARE(result, history.back()); // Should return last value
+    QCOMPARE(applyFunction({1.0, 2.0}, static_cast<DisplayWidget::FunctionType>(999)), 2.0); // Should return last value
 }
 
 void TestDisplayWidget::testEmptyValues()
@@ -632,9 +647,9 @@ void TestDisplayWidget::testLargeNumbers()
     QVERIFY(result.contains('e') || result.contains('E'));
     
     // Test mathematical operations on large numbers
-    QVariant mathResult = DisplayWidget::applyMathOperation(largeDouble, DisplayWidget::MathOperation::Multiply, 0.5);
-    QVERIFY(mathResult.isValid());
-    QVERIFY(mathResult.toDouble() > 0);
+    const double mathResult = applyMath(largeDouble.toDouble(), DisplayWidget::MathOperation::Multiply, 0.5);
+    QVERIFY(std::isfinite(mathResult));
+    QVERIFY(mathResult > 0);
 }
 
 // Include the moc file for the test class